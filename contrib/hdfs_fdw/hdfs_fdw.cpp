@@ -74,7 +74,8 @@ static const HdfsValidOption ValidDFSOptionArray[] = {{OPTION_NAME_LOCATION, T_F
 
 /* Array of options that are valid for server type. */
 static const HdfsValidOption ValidServerTypeOptionArray[] = {
-    {OBS_SERVER, T_SERVER_TYPE_OPTION}, {HDFS_SERVER, T_SERVER_TYPE_OPTION}, {DUMMY_SERVER, T_SERVER_TYPE_OPTION}};
+    {OBS_SERVER, T_SERVER_TYPE_OPTION}, {HDFS_SERVER, T_SERVER_TYPE_OPTION}, {DUMMY_SERVER, T_SERVER_TYPE_OPTION},
+    {LOCAL_SERVER, T_SERVER_TYPE_OPTION}};
 
 #define HDFS_FORMAT_ORC "orc"
 #define HDFS_FORMAT_TEXT "text"
@@ -153,6 +154,7 @@ static StringInfo HdfsGetOptionNames(uint32 checkOptionBit);
 static DFSFileType CheckFormat(DefElem* defel, uint32 whichOption);
 static void CheckCheckEncoding(DefElem* defel);
 static void CheckFilenamesForPartitionFt(List* OptList);
+static void CheckLocalPathPrivilege(uint32 whichOption, const char* optionName);
 extern bool CodeGenThreadObjectReady();
 extern void checkOBSServerValidity(char* hostName, char* ak, char* sk, bool encrypt);
 dfs::reader::Reader* getReader(
@@ -204,7 +206,7 @@ Datum hdfs_fdw_handler(PG_FUNCTION_ARGS)
 /**
  * @Description:
  * @in ServerOptionList: Find the server type from ServerOptionList, and then check the validity of
- * the server type. Currently, the "OBS" and the "HDFS" server type are supported for DFS server.
+ * the server type. Currently, the "OBS", the "HDFS" and the "local" server type are supported for DFS server.
  * @in ServerOptionList: The server option list given by user.
  * @return Return T_OBS_SERVER if the server type is "OBS", otherwise return T_HDFS_SERVER.
  */
@@ -229,6 +231,9 @@ ServerTypeOption foundAndGetServerType(List* ServerOptionList)
             } else if (0 == pg_strcasecmp(typeValue, DUMMY_SERVER)) {
                 serverType = T_DUMMY_SERVER;
                 break;
+            } else if (0 == pg_strcasecmp(typeValue, LOCAL_SERVER)) {
+                serverType = T_LOCAL_SERVER;
+                break;
             } else {
                 ereport(ERROR,
                     (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
@@ -350,6 +355,18 @@ void serverOptionValidator(List* ServerOptionList)
             checkOptionNameValidity(ServerOptionList, DUMMY_SERVER_OPTION);
             break;
         }
+        case T_LOCAL_SERVER: {
+            /* the foreign tables of the server can read any file the database user can read */
+            if (!superuser()) {
+                ereport(ERROR,
+                    (errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+                        errmodule(MOD_HDFS),
+                        errmsg("must be system admin to create a local server")));
+            }
+
+            checkOptionNameValidity(ServerOptionList, LOCAL_SERVER_OPTION);
+            break;
+        }
         default: {
             /*
              * Do not occur here.
@@ -470,8 +487,8 @@ void serverOptionValidator(List* ServerOptionList)
  * @Description: get the final optionBitmap according to judge the data format
  * and foreign table type.
  * @in fileFormat, the file format.
- * @in optBitmap, the foreign table type, OBS_FOREIGN_TABLE_OPTION or
- * HDFS_FOREIGN_TABLE_OPTION.
+ * @in optBitmap, the foreign table type, OBS_FOREIGN_TABLE_OPTION,
+ * HDFS_FOREIGN_TABLE_OPTION or LOCAL_FOREIGN_TABLE_OPTION.
  * @return return the final foreign option bitmap.
  */
 static uint32 getOptionBitmapForFt(DFSFileType fileFormat, uint32 ftTypeBitmap)
@@ -575,6 +592,13 @@ void foreignTableOptionValidator(List* tabelOptionList, uint32 whichOption)
                 errmsg("Need format option for the foreign table.")));
     }
 
+    if (whichOption == LOCAL_FOREIGN_TABLE_OPTION && formatType != DFS_ORC && formatType != DFS_PARQUET) {
+        ereport(ERROR,
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                errmodule(MOD_DFS),
+                errmsg("Supported formats for the foreign table of a local server are: orc, parquet.")));
+    }
+
     name_validity_option = getOptionBitmapForFt(formatType, whichOption);
 
     /*
@@ -592,10 +616,12 @@ void foreignTableOptionValidator(List* tabelOptionList, uint32 whichOption)
 
         if (0 == pg_strcasecmp(optionName, OPTION_NAME_FILENAMES)) {
             filenameFound = true;
+            CheckLocalPathPrivilege(whichOption, OPTION_NAME_FILENAMES);
             CheckFoldernameOrFilenamesOrCfgPtah(defGetString(optionDef), OPTION_NAME_FILENAMES);
         } else if (0 == pg_strcasecmp(optionName, OPTION_NAME_FOLDERNAME)) {
             foldernameFound = true;
-            if (whichOption == HDFS_FOREIGN_TABLE_OPTION) {
+            CheckLocalPathPrivilege(whichOption, OPTION_NAME_FOLDERNAME);
+            if (whichOption != OBS_FOREIGN_TABLE_OPTION) {
                 CheckFoldernameOrFilenamesOrCfgPtah(defGetString(optionDef), OPTION_NAME_FOLDERNAME);
             } else {
                 checkObsPath(defGetString(optionDef), OPTION_NAME_FOLDERNAME, ",");
@@ -620,7 +646,7 @@ void foreignTableOptionValidator(List* tabelOptionList, uint32 whichOption)
         CheckTextCsvOptions(&textOptionsFoundDetail, checkEncodingLevel, formatType);
     }
 
-    if (whichOption == HDFS_FOREIGN_TABLE_OPTION) {
+    if (whichOption != OBS_FOREIGN_TABLE_OPTION) {
         if ((filenameFound && foldernameFound) || (!filenameFound && !foldernameFound)) {
             ereport(ERROR,
                 (errcode(ERRCODE_FDW_DYNAMIC_PARAMETER_VALUE_NEEDED),
@@ -665,7 +691,7 @@ Datum hdfs_fdw_validator(PG_FUNCTION_ARGS)
     List* optionList = untransformRelOptions(optionArray);
 
     /*
-     * currently, Only the OBS/HDFS foreign, OBS/HDFS server will entrance
+     * currently, Only the OBS/HDFS/local foreign, OBS/HDFS/local server will entrance
      * this function.
      */
     if (ForeignServerRelationId == optionContextId) {
@@ -681,6 +707,8 @@ Datum hdfs_fdw_validator(PG_FUNCTION_ARGS)
             foreignTableOptionValidator(checkedList, HDFS_FOREIGN_TABLE_OPTION);
         } else if (0 == pg_strcasecmp(typeValue, OBS)) {
             foreignTableOptionValidator(checkedList, OBS_FOREIGN_TABLE_OPTION);
+        } else if (0 == pg_strcasecmp(typeValue, LOCAL_SERVER)) {
+            foreignTableOptionValidator(checkedList, LOCAL_FOREIGN_TABLE_OPTION);
         }
         list_free(checkedList);
         checkedList = NIL;
@@ -1013,6 +1041,8 @@ static void HdfsExplainForeignScan(ForeignScanState* scanState, ExplainState* ex
     if (t_thrd.explain_cxt.explain_perf_mode == EXPLAIN_NORMAL) {
         if (T_OBS_SERVER == srvType) {
             ExplainPropertyText("Server Type", OBS, explainState);
+        } else if (T_LOCAL_SERVER == srvType) {
+            ExplainPropertyText("Server Type", LOCAL_SERVER, explainState);
         } else {
             ExplainPropertyText("Server Type", HDFS, explainState);
         }
@@ -1044,6 +1074,9 @@ static void HdfsExplainForeignScan(ForeignScanState* scanState, ExplainState* ex
         if (T_OBS_SERVER == srvType) {
             explainState->planinfo->m_detailInfo->set_plan_name<true, true>();
             appendStringInfo(explainState->planinfo->m_detailInfo->info_str, "%s: %s\n", "Server Type", OBS);
+        } else if (T_LOCAL_SERVER == srvType) {
+            explainState->planinfo->m_detailInfo->set_plan_name<true, true>();
+            appendStringInfo(explainState->planinfo->m_detailInfo->info_str, "%s: %s\n", "Server Type", LOCAL_SERVER);
         } else {
             explainState->planinfo->m_detailInfo->set_plan_name<true, true>();
             appendStringInfo(explainState->planinfo->m_detailInfo->info_str, "%s: %s\n", "Server Type", HDFS);
@@ -2316,6 +2349,22 @@ static void CheckCheckEncoding(DefElem* defel)
             errmsg("Only high/low is supported for the checkencoding option.")));
 }
 
+/* @hdfs
+ * brief: The files of a local server are read with the rights of the database, so only a system admin
+ *        may choose which of them a foreign table reads, as for file_fdw.
+ * input param @whichOption: The foreign table type.
+ * input param @optionName: The filenames or foldername option.
+ */
+static void CheckLocalPathPrivilege(uint32 whichOption, const char* optionName)
+{
+    if (whichOption == LOCAL_FOREIGN_TABLE_OPTION && !superuser()) {
+        ereport(ERROR,
+            (errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+                errmodule(MOD_HDFS),
+                errmsg("must be system admin to set the %s option of a foreign table on a local server", optionName)));
+    }
+}
+
 /* @hdfs
  * brief: Check whether or not exist filenames option for the HDFS partition foreign table.
  *        The HDFS partition foreign table dose not support filenames option.
@@ -26,6 +26,7 @@ typedef enum OptionType {
 #define OBS_SERVER_OPTION (T_SERVER_COMMON_OPTION | T_OBS_SERVER_OPTION)
 #define HDFS_SERVER_OPTION (T_SERVER_COMMON_OPTION | T_HDFS_SERVER_OPTION)
 #define DUMMY_SERVER_OPTION (T_SERVER_COMMON_OPTION | T_DUMMY_SERVER_OPTION)
+#define LOCAL_SERVER_OPTION (T_SERVER_COMMON_OPTION)
 #define OBS_FOREIGN_TABLE_OPTION                                                               \
     (T_FOREIGN_TABLE_COMMON_OPTION | T_FOREIGN_TABLE_OBS_OPTION | T_FOREIGN_TABLE_CSV_OPTION | \
         T_FOREIGN_TABLE_TEXT_OPTION)
@@ -34,6 +35,11 @@ typedef enum OptionType {
     (T_FOREIGN_TABLE_COMMON_OPTION | T_FOREIGN_TABLE_HDFS_OPTION | T_FOREIGN_TABLE_CSV_OPTION | \
         T_FOREIGN_TABLE_TEXT_OPTION | T_FOREIGN_TABLE_HDFS_ORC_OPTION | T_FOREIGN_TABLE_HDFS_PARQUET_OPTION)
 
+/* The local server only reads orc and parquet files, given by filenames or foldername like hdfs. */
+#define LOCAL_FOREIGN_TABLE_OPTION                                                                   \
+    (T_FOREIGN_TABLE_COMMON_OPTION | T_FOREIGN_TABLE_HDFS_OPTION | T_FOREIGN_TABLE_HDFS_ORC_OPTION | \
+        T_FOREIGN_TABLE_HDFS_PARQUET_OPTION)
+
 #define SERVER_TYPE_OPTION (T_SERVER_TYPE_OPTION)
 
 #define DFS_OPTION_ARRAY                                                                           \
@@ -152,7 +152,8 @@ List* CNScheduling(Oid foreignTableId, Index relId, List* columnList, List* scan
         *fileNum = list_length(FileList);
     }
     switch (srvType) {
-        case T_OBS_SERVER: {
+        case T_OBS_SERVER:
+        case T_LOCAL_SERVER: {
             /* Check if the file list is empty again after the partition prunning. */
             if (0 == list_length(FileList)) {
                 delete (conn);
@@ -219,7 +220,8 @@ List* CNScheduling(Oid foreignTableId, Index relId, List* columnList, List* scan
     Assert(allTask != NIL);
 
     /* check the allTask, If the size of splits */
-    if ((!t_thrd.postgres_cxt.mark_explain_only && !isAnalyze) &&
+    /* The local file system is not shared between the nodes, there is nowhere to spill the splits. */
+    if ((!t_thrd.postgres_cxt.mark_explain_only && !isAnalyze) && T_LOCAL_SERVER != srvType &&
         list_length(FileList) >= u_sess->attr.attr_sql.schedule_splits_threshold) {
         SpillToDisk(relId, allTask, conn);
     }
@@ -1622,6 +1624,42 @@ static List* GetAllFiles(
             }
             break;
         }
+        case T_LOCAL_SERVER: {
+            /*
+             * The files are listed with their sizes like the objects of OBS, so the partition directories
+             * are parsed from the paths and no drilling down is needed.
+             */
+            HdfsFdwOptions* options = HdfsGetOptions(foreignTableId);
+            if (options->foldername) {
+                if (conn->isDfsFile(options->foldername)) {
+                    delete (conn);
+                    conn = NULL;
+                    ereport(ERROR,
+                        (errcode(ERRCODE_FDW_INVALID_OPTOIN_DATA),
+                            errmodule(MOD_HDFS),
+                            errmsg("The foldername option cannot be a file path.")));
+                }
+
+                fileList = conn->listObjectsStat(options->foldername, options->foldername);
+            } else {
+                while (NULL != options->filename) {
+                    currentFile = parseMultiFileNames(&options->filename, true, ',');
+
+                    /* If the option use filenames, then all the entries defined must be file. */
+                    if (!conn->isDfsFile(currentFile)) {
+                        delete (conn);
+                        conn = NULL;
+                        ereport(ERROR,
+                            (errcode(ERRCODE_FDW_INVALID_OPTOIN_DATA),
+                                errmodule(MOD_HDFS),
+                                errmsg("The entries in the options fileNames must be file!")));
+                    }
+
+                    fileList = list_concat(fileList, conn->listObjectsStat(currentFile, currentFile));
+                }
+            }
+            break;
+        }
         default: {
             Assert(0);
             break;
@@ -1863,7 +1901,7 @@ static List* PartitionPruneProcess(dfs::DFSConnector* conn, List* partitionRelat
                 /* next cell */
                 next = lnext(fileCell);
 
-                if (T_OBS_SERVER == srvType) {
+                if (T_HDFS_SERVER != srvType) {
                     fillPartitionValueInSplitInfo(conn, split, i + split->prefixSlashNum);
                 }
 
@@ -1887,7 +1925,7 @@ static List* PartitionPruneProcess(dfs::DFSConnector* conn, List* partitionRelat
                     /* prev cell */
                     prev = fileCell;
                 } else {
-                    if (T_OBS_SERVER == srvType) {
+                    if (T_HDFS_SERVER != srvType) {
                         pfree_ext(split->fileName);
                         pfree_ext(split->filePath);
                         pfree_ext(split);
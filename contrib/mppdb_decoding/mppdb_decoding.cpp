@@ -62,6 +62,7 @@ typedef struct {
     bool skip_empty_xacts;
     bool xact_wrote_changes;
     bool only_local;
+    bool stream_changes;
 } TestDecodingData;
 
 static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions* opt, bool is_init);
@@ -73,6 +74,14 @@ static void pg_decode_commit_txn(LogicalDecodingContext* ctx, ReorderBufferTXN*
 static void pg_decode_change(
     LogicalDecodingContext* ctx, ReorderBufferTXN* txn, Relation rel, ReorderBufferChange* change);
 static bool pg_decode_filter(LogicalDecodingContext* ctx, RepOriginId origin_id);
+static void pg_output_change(
+    LogicalDecodingContext* ctx, TestDecodingData* data, Relation relation, ReorderBufferChange* change);
+static void pg_decode_stream_start(LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+static void pg_decode_stream_stop(LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+static void pg_decode_stream_change(
+    LogicalDecodingContext* ctx, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change);
+static void pg_decode_stream_abort(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+static void pg_decode_stream_commit(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 
 void _PG_init(void)
 {
@@ -90,6 +99,11 @@ void _PG_output_plugin_init(OutputPluginCallbacks* cb)
     cb->commit_cb = pg_decode_commit_txn;
     cb->filter_by_origin_cb = pg_decode_filter;
     cb->shutdown_cb = pg_decode_shutdown;
+    cb->stream_start_cb = pg_decode_stream_start;
+    cb->stream_stop_cb = pg_decode_stream_stop;
+    cb->stream_change_cb = pg_decode_stream_change;
+    cb->stream_abort_cb = pg_decode_stream_abort;
+    cb->stream_commit_cb = pg_decode_stream_commit;
 }
 
 /* initialize this plugin */
@@ -108,6 +122,7 @@ static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions*
     data->include_timestamp = false;
     data->skip_empty_xacts = false;
     data->only_local = true;
+    data->stream_changes = false;
 
     ctx->output_plugin_private = data;
 
@@ -161,6 +176,14 @@ static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions*
                 ereport(ERROR,
                     (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
                         errmsg("could not parse value \"%s\" for parameter \"%s\"", strVal(elem->arg), elem->defname)));
+        } else if (strcmp(elem->defname, "stream-changes") == 0) {
+
+            if (elem->arg == NULL)
+                data->stream_changes = true;
+            else if (!parse_bool(strVal(elem->arg), &data->stream_changes))
+                ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                        errmsg("could not parse value \"%s\" for parameter \"%s\"", strVal(elem->arg), elem->defname)));
         } else {
             ereport(ERROR,
                 (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
@@ -168,6 +191,9 @@ static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions*
                         "option \"%s\" = \"%s\" is unknown", elem->defname, elem->arg ? strVal(elem->arg) : "(null)")));
         }
     }
+
+    /* large transactions are only streamed before their commit on request */
+    ctx->streaming = ctx->streaming && data->stream_changes;
 }
 
 /* cleanup this plugin's resources */
@@ -363,10 +389,6 @@ static void pg_decode_change(
     LogicalDecodingContext* ctx, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change)
 {
     TestDecodingData* data = NULL;
-    Form_pg_class class_form;
-    TupleDesc tupdesc;
-    MemoryContext old;
-    char* res = NULL;
     data = (TestDecodingData*)ctx->output_plugin_private;
 
     /* output BEGIN if we haven't yet */
@@ -375,6 +397,18 @@ static void pg_decode_change(
     }
     data->xact_wrote_changes = true;
 
+    pg_output_change(ctx, data, relation, change);
+}
+
+/* print one changed tuple as json, for both the regular and the streamed changes */
+static void pg_output_change(
+    LogicalDecodingContext* ctx, TestDecodingData* data, Relation relation, ReorderBufferChange* change)
+{
+    Form_pg_class class_form;
+    TupleDesc tupdesc;
+    MemoryContext old;
+    char* res = NULL;
+
     class_form = RelationGetForm(relation);
     tupdesc = RelationGetDescr(relation);
 
@@ -442,3 +476,49 @@ static void pg_decode_change(
     MemoryContextReset(data->context);
     OutputPluginWrite(ctx, true);
 }
+
+/* start of a block of streamed changes of an in-progress transaction */
+static void pg_decode_stream_start(LogicalDecodingContext* ctx, ReorderBufferTXN* txn)
+{
+    OutputPluginPrepareWrite(ctx, true);
+    appendStringInfo(ctx->out, "STREAM START %lu", txn->xid);
+    OutputPluginWrite(ctx, true);
+}
+
+/* end of a block of streamed changes */
+static void pg_decode_stream_stop(LogicalDecodingContext* ctx, ReorderBufferTXN* txn)
+{
+    OutputPluginPrepareWrite(ctx, true);
+    appendStringInfo(ctx->out, "STREAM STOP %lu", txn->xid);
+    OutputPluginWrite(ctx, true);
+}
+
+/* streamed changes are printed like the regular ones */
+static void pg_decode_stream_change(
+    LogicalDecodingContext* ctx, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    pg_output_change(ctx, data, relation, change);
+}
+
+/* the streamed (sub)transaction aborted, its changes have to be discarded */
+static void pg_decode_stream_abort(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr abort_lsn)
+{
+    OutputPluginPrepareWrite(ctx, true);
+    appendStringInfo(ctx->out, "STREAM ABORT %lu", txn->xid);
+    OutputPluginWrite(ctx, true);
+}
+
+/* the streamed transaction committed */
+static void pg_decode_stream_commit(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    OutputPluginPrepareWrite(ctx, true);
+    appendStringInfo(ctx->out, "STREAM COMMIT %lu", txn->xid);
+    if (data->include_timestamp)
+        appendStringInfo(ctx->out, " (at %s)", timestamptz_to_str(txn->commit_time));
+    appendStringInfo(ctx->out, " CSN %lu", txn->csn);
+    OutputPluginWrite(ctx, true);
+}
@@ -0,0 +1,45 @@
+--
+-- Streaming of large in-progress transactions to the output plugin
+--
+SET synchronous_commit = on;
+SELECT 'init' FROM pg_create_logical_replication_slot('regression_slot', 'test_decoding');
+CREATE TABLE stream_test(id int, data text);
+SELECT count(*) FROM pg_logical_slot_get_changes('regression_slot', NULL, NULL, 'skip-empty-xacts', '1');
+-- stream as soon as the changes decoded exceed 64kB
+SET logical_decoding_work_mem = '64kB';
+-- a large transaction with subtransactions, one of them rolled back after it was streamed
+BEGIN;
+INSERT INTO stream_test SELECT i, repeat('a', 100) FROM generate_series(1, 500) i;
+SAVEPOINT s1;
+INSERT INTO stream_test SELECT i, repeat('b', 100) FROM generate_series(501, 1000) i;
+SAVEPOINT s2;
+INSERT INTO stream_test SELECT i, repeat('c', 100) FROM generate_series(1001, 1500) i;
+ROLLBACK TO s2;
+INSERT INTO stream_test SELECT i, repeat('d', 100) FROM generate_series(1501, 2000) i;
+COMMIT;
+-- Each change says which subtransaction made it. How many blocks are streamed,
+-- and how many changes of the rolled back subtransaction are sent before its
+-- abort, depends on the memory accounting: only the other counts are exact.
+SELECT kind, CASE WHEN kind ~ '(: [abd]|^aborting.*|^committing.*)$' THEN count(*) END AS exact
+    FROM (SELECT regexp_replace(regexp_replace(data, 'id\[integer\]:[0-9]+ data\[text\]:''(.).*$', '\1'), '[0-9]+', 'N', 'g') AS kind
+              FROM pg_logical_slot_get_changes('regression_slot', NULL, NULL, 'include-xids', '1', 'skip-empty-xacts', '1', 'stream-changes', '1')) s
+    GROUP BY kind ORDER BY kind;
+-- a large transaction that aborts after some of its changes were streamed
+BEGIN;
+INSERT INTO stream_test SELECT i, repeat('e', 100) FROM generate_series(1, 1000) i;
+ROLLBACK;
+SELECT kind, CASE WHEN kind ~ '(: [abd]|^aborting.*|^committing.*)$' THEN count(*) END AS exact
+    FROM (SELECT regexp_replace(regexp_replace(data, 'id\[integer\]:[0-9]+ data\[text\]:''(.).*$', '\1'), '[0-9]+', 'N', 'g') AS kind
+              FROM pg_logical_slot_get_changes('regression_slot', NULL, NULL, 'include-xids', '0', 'skip-empty-xacts', '1', 'stream-changes', '1')) s
+    GROUP BY kind ORDER BY kind;
+-- without stream-changes the same transaction is only decoded on commit
+BEGIN;
+INSERT INTO stream_test SELECT i, repeat('f', 100) FROM generate_series(1, 1000) i;
+COMMIT;
+SELECT kind, count(*)
+    FROM (SELECT regexp_replace(regexp_replace(data, 'id\[integer\]:[0-9]+ data\[text\]:''(.).*$', '\1'), '[0-9]+', 'N', 'g') AS kind
+              FROM pg_logical_slot_get_changes('regression_slot', NULL, NULL, 'include-xids', '0', 'skip-empty-xacts', '1')) s
+    GROUP BY kind ORDER BY kind;
+RESET logical_decoding_work_mem;
+DROP TABLE stream_test;
+SELECT pg_drop_replication_slot('regression_slot');
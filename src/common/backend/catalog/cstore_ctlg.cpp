@@ -487,6 +487,7 @@ bool CreateCUDescTable(Relation rel, Datum reloptions, bool isPartition)
 
     IndexInfo* indexInfo = makeNode(IndexInfo);
     indexInfo->ii_NumIndexAttrs = 2;
+    indexInfo->ii_NumIndexKeyAttrs = 2;
     indexInfo->ii_KeyAttrNumbers[0] = 1;
     indexInfo->ii_KeyAttrNumbers[1] = 2;
     indexInfo->ii_Expressions = NIL;
@@ -182,6 +182,7 @@ void createDfsDescTable(Relation rel, Datum relOptions)
      */
     IndexInfo* indexInfo = makeNode(IndexInfo);
     indexInfo->ii_NumIndexAttrs = DfsDescIndexMaxAttrNum;
+    indexInfo->ii_NumIndexKeyAttrs = DfsDescIndexMaxAttrNum;
     indexInfo->ii_KeyAttrNumbers[0] = Anum_pg_dfsdesc_duid;
     indexInfo->ii_Expressions = NIL;
     indexInfo->ii_ExpressionsState = NIL;
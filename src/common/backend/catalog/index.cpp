@@ -94,6 +94,9 @@ static void UpdateIndexRelation(Oid indexoid, Oid heapoid, IndexInfo* indexInfo,
 static void IndexCheckExclusion(Relation heapRelation, Relation indexRelation, IndexInfo* indexInfo);
 static void IndexCheckExclusionForBucket(Relation heapRelation, Partition heapPartition, Relation indexRelation,
     Partition indexPartition, IndexInfo* indexInfo);
+static double IndexBuildHeapScanInternal(Relation heapRelation, Relation indexRelation, IndexInfo* indexInfo,
+    bool allow_sync, IndexBuildCallback callback, void* callback_state, Snapshot snapshot, TransactionId OldestXmin,
+    int dop);
 static bool validate_index_callback(ItemPointer itemptr, void* opaque);
 static void validate_index_heapscan(
     Relation heapRelation, Relation indexRelation, IndexInfo* indexInfo, Snapshot snapshot, v_i_state* state);
@@ -203,7 +206,7 @@ void index_check_primary_key(Relation heapRel, IndexInfo* indexInfo, bool is_alt
      * null, otherwise attempt to ALTER TABLE .. SET NOT NULL
      */
     cmds = NIL;
-    for (i = 0; i < indexInfo->ii_NumIndexAttrs; i++) {
+    for (i = 0; i < indexInfo->ii_NumIndexKeyAttrs; i++) {
         AttrNumber attnum = indexInfo->ii_KeyAttrNumbers[i];
         HeapTuple atttuple;
         Form_pg_attribute attform;
@@ -403,6 +406,10 @@ static TupleDesc ConstructTupleDescriptor(Relation heapRelation, IndexInfo* inde
         (void)namestrcpy(&to->attname, (const char*)lfirst(colnames_item));
         colnames_item = lnext(colnames_item);
 
+        /* included columns have no opclass, they keep the type of the table column */
+        if (i >= indexInfo->ii_NumIndexKeyAttrs)
+            continue;
+
         /*
          * Check the opclass and index AM to see if either provides a keytype
          * (overriding the attribute type).  Opclass takes precedence.
@@ -525,9 +532,10 @@ static void UpdateIndexRelation(Oid indexoid, Oid heapoid, IndexInfo* indexInfo,
     indkey = buildint2vector(NULL, indexInfo->ii_NumIndexAttrs);
     for (i = 0; i < indexInfo->ii_NumIndexAttrs; i++)
         indkey->values[i] = indexInfo->ii_KeyAttrNumbers[i];
-    indcollation = buildoidvector(collationOids, indexInfo->ii_NumIndexAttrs);
-    indclass = buildoidvector(classOids, indexInfo->ii_NumIndexAttrs);
-    indoption = buildint2vector(coloptions, indexInfo->ii_NumIndexAttrs);
+    /* the included columns have no collation, opclass nor options */
+    indcollation = buildoidvector(collationOids, indexInfo->ii_NumIndexKeyAttrs);
+    indclass = buildoidvector(classOids, indexInfo->ii_NumIndexKeyAttrs);
+    indoption = buildint2vector(coloptions, indexInfo->ii_NumIndexKeyAttrs);
 
     /*
      * Convert the index expressions (if any) to a text datum
@@ -590,6 +598,11 @@ static void UpdateIndexRelation(Oid indexoid, Oid heapoid, IndexInfo* indexInfo,
         nulls[Anum_pg_index_indpred - 1] = true;
 
     values[Anum_pg_index_indisreplident - 1] = BoolGetDatum(false);
+    /* an index without included columns gets the row an older binary writes */
+    if (indexInfo->ii_NumIndexKeyAttrs < indexInfo->ii_NumIndexAttrs)
+        values[Anum_pg_index_indnkeyatts - 1] = Int16GetDatum(indexInfo->ii_NumIndexKeyAttrs);
+    else
+        nulls[Anum_pg_index_indnkeyatts - 1] = true;
     tuple = heap_form_tuple(RelationGetDescr(pg_index), values, nulls);
 
     /*
@@ -999,7 +1012,7 @@ Oid index_create(Relation heapRelation, const char* indexRelationName, Oid index
 
             /* Store dependency on collations */
             /* The default collation is pinned, so don't bother recording it */
-            for (i = 0; i < indexInfo->ii_NumIndexAttrs; i++) {
+            for (i = 0; i < indexInfo->ii_NumIndexKeyAttrs; i++) {
                 if (OidIsValid(collationObjectId[i]) && collationObjectId[i] != DEFAULT_COLLATION_OID) {
                     referenced.classId = CollationRelationId;
                     referenced.objectId = collationObjectId[i];
@@ -1010,7 +1023,7 @@ Oid index_create(Relation heapRelation, const char* indexRelationName, Oid index
             }
 
             /* Store dependency on operator classes */
-            for (i = 0; i < indexInfo->ii_NumIndexAttrs; i++) {
+            for (i = 0; i < indexInfo->ii_NumIndexKeyAttrs; i++) {
                 referenced.classId = OperatorClassRelationId;
                 referenced.objectId = classObjectId[i];
                 referenced.objectSubId = 0;
@@ -1273,7 +1286,7 @@ void index_constraint_create(Relation heapRelation, Oid indexRelationId, IndexIn
         true,
         RelationGetRelid(heapRelation),
         indexInfo->ii_KeyAttrNumbers,
-        indexInfo->ii_NumIndexAttrs,
+        indexInfo->ii_NumIndexKeyAttrs,
         InvalidOid,      /* no domain */
         indexRelationId, /* index OID */
         InvalidOid,      /* no foreign key */
@@ -1310,6 +1323,19 @@ void index_constraint_create(Relation heapRelation, Oid indexRelationId, IndexIn
 
     recordDependencyOn(&myself, &referenced, DEPENDENCY_INTERNAL);
 
+    /*
+     * The constraint depends on its key columns only, so the index has to
+     * depend on its included columns itself; dropping one of them drops the
+     * constraint through the index.
+     */
+    for (int i = indexInfo->ii_NumIndexKeyAttrs; i < indexInfo->ii_NumIndexAttrs; i++) {
+        referenced.classId = RelationRelationId;
+        referenced.objectId = RelationGetRelid(heapRelation);
+        referenced.objectSubId = indexInfo->ii_KeyAttrNumbers[i];
+
+        recordDependencyOn(&myself, &referenced, DEPENDENCY_AUTO);
+    }
+
     /*
      * If the constraint is deferrable, create the deferred uniqueness
      * checking trigger.  (The trigger will be given an internal dependency on
@@ -1761,6 +1787,9 @@ IndexInfo* BuildIndexInfo(Relation index)
             (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
                 errmsg("invalid indnatts %d for index %u", numKeys, RelationGetRelid(index))));
     ii->ii_NumIndexAttrs = numKeys;
+    ii->ii_NumIndexKeyAttrs = IndexRelationGetNumberOfKeyAttributes(index);
+    Assert(ii->ii_NumIndexKeyAttrs != 0);
+    Assert(ii->ii_NumIndexKeyAttrs <= ii->ii_NumIndexAttrs);
     for (i = 0; i < numKeys; i++)
         ii->ii_KeyAttrNumbers[i] = indexStruct->indkey.values[i];
 
@@ -2465,6 +2494,34 @@ void index_build(Relation heapRelation, Partition heapPartition, Relation indexR
  */
 double IndexBuildHeapScan(Relation heapRelation, Relation indexRelation, IndexInfo* indexInfo, bool allow_sync,
     IndexBuildCallback callback, void* callback_state)
+{
+    return IndexBuildHeapScanInternal(heapRelation, indexRelation, indexInfo, allow_sync, callback, callback_state,
+        InvalidSnapshot, InvalidTransactionId, 0);
+}
+
+/*
+ * IndexBuildHeapScanParallel - scan one participant's share of the heap
+ *
+ * Same as IndexBuildHeapScan, but only the stripes of PARALLEL_SCAN_GAP blocks
+ * belonging to participant u_sess->stream_cxt.smp_id out of dop participants
+ * are scanned, the way an SMP sequential scan divides a heap.  All participants
+ * must pass the same snapshot (for a concurrent build) or OldestXmin (for a
+ * normal one), computed once by the leader, so that they agree on which tuples
+ * are indexed.  The snapshot stays owned by the caller.
+ */
+double IndexBuildHeapScanParallel(Relation heapRelation, Relation indexRelation, IndexInfo* indexInfo,
+    IndexBuildCallback callback, void* callback_state, Snapshot snapshot, TransactionId OldestXmin, int dop)
+{
+    Assert(dop >= 1);
+    Assert(indexInfo->ii_Concurrent ? snapshot != InvalidSnapshot : TransactionIdIsValid(OldestXmin));
+
+    return IndexBuildHeapScanInternal(
+        heapRelation, indexRelation, indexInfo, false, callback, callback_state, snapshot, OldestXmin, dop);
+}
+
+static double IndexBuildHeapScanInternal(Relation heapRelation, Relation indexRelation, IndexInfo* indexInfo,
+    bool allow_sync, IndexBuildCallback callback, void* callback_state, Snapshot snapshot, TransactionId OldestXmin,
+    int dop)
 {
     bool is_system_catalog = false;
     bool checking_uniqueness = false;
@@ -2477,8 +2534,7 @@ double IndexBuildHeapScan(Relation heapRelation, Relation indexRelation, IndexIn
     TupleTableSlot* slot = NULL;
     EState* estate = NULL;
     ExprContext* econtext = NULL;
-    Snapshot snapshot;
-    TransactionId OldestXmin;
+    bool own_snapshot = false;
     BlockNumber root_blkno = InvalidBlockNumber;
     OffsetNumber root_offsets[MaxHeapTuplesPerPage];
 
@@ -2513,13 +2569,18 @@ double IndexBuildHeapScan(Relation heapRelation, Relation indexRelation, IndexIn
      * qual checks (because we have to index RECENTLY_DEAD tuples). In a
      * concurrent build, we take a regular MVCC snapshot and index whatever's
      * live according to that.	During bootstrap we just use SnapshotNow.
+     * The participants of a parallel build get them from the leader.
      */
-    if (IsBootstrapProcessingMode()) {
+    if (dop > 0) {
+        if (!indexInfo->ii_Concurrent)
+            snapshot = SnapshotAny;
+    } else if (IsBootstrapProcessingMode()) {
         snapshot = SnapshotNow;
         OldestXmin = InvalidTransactionId; /* not used */
     } else if (indexInfo->ii_Concurrent) {
         snapshot = RegisterSnapshot(GetTransactionSnapshot());
         OldestXmin = InvalidTransactionId; /* not used */
+        own_snapshot = true;
     } else {
         snapshot = SnapshotAny;
         /* okay to ignore lazy VACUUMs here */
@@ -2533,6 +2594,10 @@ double IndexBuildHeapScan(Relation heapRelation, Relation indexRelation, IndexIn
         true,                                 /* buffer access strategy OK */
         allow_sync);                          /* syncscan OK? */
 
+    /* scan only our own stripes of the heap */
+    if (dop > 1)
+        heap_init_parallel_seqscan(scan, dop, ForwardScanDirection);
+
     reltuples = 0;
 
     /*
@@ -2812,7 +2877,7 @@ double IndexBuildHeapScan(Relation heapRelation, Relation indexRelation, IndexIn
     heap_endscan(scan);
 
     /* we can now forget our snapshot, if set */
-    if (indexInfo->ii_Concurrent)
+    if (own_snapshot)
         UnregisterSnapshot(snapshot);
 
     ExecDropSingleTupleTableSlot(slot);
@@ -961,7 +961,8 @@ int pgxc_find_primarykey(Oid relid, int16** indexed_col, bool check_is_immediate
 
             Assert(idxVec->dim1 == indexStruct->indnatts);
 
-            for (counter = 0; counter < indexStruct->indnatts; counter++) {
+            /* the included columns are not unique, only the key columns count */
+            for (counter = 0; counter < GetIndexKeyAttsByTuple(NULL, indexTuple); counter++) {
                 AttrNumber idxKey = idxVec->values[counter];
 
                 Assert(idxKey <= rel->rd_att->natts);
@@ -990,18 +991,19 @@ int pgxc_find_primarykey(Oid relid, int16** indexed_col, bool check_is_immediate
         return 0;
 
     indexStruct = (Form_pg_index)GETSTRUCT(primarykeyTuple);
-    *indexed_col = (int16*)palloc(indexStruct->indnatts * sizeof(AttrNumber));
+    int nkeyatts = GetIndexKeyAttsByTuple(NULL, primarykeyTuple);
+    *indexed_col = (int16*)palloc(nkeyatts * sizeof(AttrNumber));
 
     /*
      * Now get the list of PK attributes from the indkey definition (we
      * assume a primary key cannot have expressional elements)
      */
-    for (counter = 0; counter < indexStruct->indnatts; counter++) {
+    for (counter = 0; counter < nkeyatts; counter++) {
         (*indexed_col)[counter] = indexStruct->indkey.values[counter];
     }
 
     ReleaseSysCache(primarykeyTuple);
 
-    return indexStruct->indnatts;
+    return nkeyatts;
 }
 #endif
@@ -1393,7 +1393,14 @@ CREATE VIEW pg_stat_replication AS
             W.receiver_flush_location,
             W.receiver_replay_location,
             W.sync_priority,
-            W.sync_state
+            W.sync_state,
+            W.compression,
+            W.raw_bytes,
+            W.compressed_bytes,
+            CASE WHEN W.compressed_bytes > 0
+                 THEN round(W.raw_bytes::numeric / W.compressed_bytes, 2)
+            END AS compression_ratio,
+            W.compress_time
     FROM pg_stat_get_activity(NULL) AS S, pg_authid U,
             pg_stat_get_wal_senders() AS W
     WHERE S.usesysid = U.oid AND
@@ -1414,6 +1421,19 @@ CREATE VIEW pg_replication_slots AS
     FROM pg_get_replication_slots() AS L
             LEFT JOIN pg_database D ON (L.datoid = D.oid);
 
+CREATE VIEW pg_stat_parallel_decoding AS
+    SELECT
+            P.pid,
+            P.slot_name,
+            P.stage,
+            P.worker_id,
+            P.queue_depth,
+            P.processed,
+            P.processed_bytes,
+            P.location,
+            P.lag_bytes
+    FROM pg_stat_get_parallel_decode() AS P;
+
 
 CREATE VIEW pg_stat_database AS
     SELECT
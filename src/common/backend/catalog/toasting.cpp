@@ -271,6 +271,7 @@ static bool create_toast_table(Relation rel, Oid toastOid, Oid toastIndexOid, Da
      */
     indexInfo = makeNode(IndexInfo);
     indexInfo->ii_NumIndexAttrs = 2;
+    indexInfo->ii_NumIndexKeyAttrs = 2;
     indexInfo->ii_KeyAttrNumbers[0] = 1;
     indexInfo->ii_KeyAttrNumbers[1] = 2;
     indexInfo->ii_Expressions = NIL;
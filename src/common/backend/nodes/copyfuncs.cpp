@@ -351,6 +351,7 @@ static PartIterator* _copyPartIterator(const PartIterator* from)
     COPY_SCALAR_FIELD(itrs);
     COPY_SCALAR_FIELD(direction);
     COPY_NODE_FIELD(param);
+    COPY_NODE_FIELD(pruningQuals);
 
     return newnode;
 }
@@ -565,6 +566,7 @@ static IndexScan* _copyIndexScan(const IndexScan* from)
     COPY_NODE_FIELD(indexorderby);
     COPY_NODE_FIELD(indexorderbyorig);
     COPY_SCALAR_FIELD(indexorderdir);
+    COPY_SCALAR_FIELD(indexskipscan);
 
     return newnode;
 }
@@ -651,6 +653,7 @@ static IndexOnlyScan* _copyIndexOnlyScan(const IndexOnlyScan* from)
     COPY_NODE_FIELD(indexorderby);
     COPY_NODE_FIELD(indextlist);
     COPY_SCALAR_FIELD(indexorderdir);
+    COPY_SCALAR_FIELD(indexskipscan);
 
     return newnode;
 }
@@ -673,6 +676,7 @@ static BitmapIndexScan* _copyBitmapIndexScan(const BitmapIndexScan* from)
     COPY_SCALAR_FIELD(indexid);
     COPY_NODE_FIELD(indexqual);
     COPY_NODE_FIELD(indexqualorig);
+    COPY_SCALAR_FIELD(indexskipscan);
 
     return newnode;
 }
@@ -1327,6 +1331,7 @@ static WindowAgg* _copyWindowAgg(const WindowAgg* from)
     COPY_NODE_FIELD(startOffset);
     COPY_NODE_FIELD(endOffset);
     CopyMemInfoFields(&from->mem_info, &newnode->mem_info);
+    COPY_SCALAR_FIELD(is_sonicwindow);
 
     return newnode;
 }
@@ -1681,6 +1686,7 @@ static VecPartIterator* _copyVecPartIterator(const VecPartIterator* from)
     COPY_SCALAR_FIELD(itrs);
     COPY_SCALAR_FIELD(direction);
     COPY_NODE_FIELD(param);
+    COPY_NODE_FIELD(pruningQuals);
 
     return newnode;
 }
@@ -1929,6 +1935,7 @@ static VecWindowAgg* _copyVecWindowAgg(const VecWindowAgg* from)
     COPY_NODE_FIELD(startOffset);
     COPY_NODE_FIELD(endOffset);
     CopyMemInfoFields(&from->mem_info, &newnode->mem_info);
+    COPY_SCALAR_FIELD(is_sonicwindow);
 
     return newnode;
 }
@@ -3646,6 +3653,7 @@ static Constraint* _copyConstraint(const Constraint* from)
     COPY_NODE_FIELD(raw_expr);
     COPY_STRING_FIELD(cooked_expr);
     COPY_NODE_FIELD(keys);
+    COPY_NODE_FIELD(including);
     COPY_NODE_FIELD(exclusions);
     COPY_NODE_FIELD(options);
     COPY_STRING_FIELD(indexname);
@@ -4400,6 +4408,7 @@ static IndexStmt* _copyIndexStmt(const IndexStmt* from)
     COPY_STRING_FIELD(accessMethod);
     COPY_STRING_FIELD(tableSpace);
     COPY_NODE_FIELD(indexParams);
+    COPY_NODE_FIELD(indexIncludingParams);
     COPY_NODE_FIELD(options);
     COPY_NODE_FIELD(whereClause);
     COPY_NODE_FIELD(excludeOpNames);
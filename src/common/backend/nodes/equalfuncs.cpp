@@ -1247,6 +1247,7 @@ static bool _equalIndexStmt(const IndexStmt* a, const IndexStmt* b)
     COMPARE_STRING_FIELD(accessMethod);
     COMPARE_STRING_FIELD(tableSpace);
     COMPARE_NODE_FIELD(indexParams);
+    COMPARE_NODE_FIELD(indexIncludingParams);
     COMPARE_NODE_FIELD(options);
     COMPARE_NODE_FIELD(whereClause);
     COMPARE_NODE_FIELD(excludeOpNames);
@@ -2210,6 +2211,7 @@ static bool _equalConstraint(const Constraint* a, const Constraint* b)
     COMPARE_NODE_FIELD(raw_expr);
     COMPARE_STRING_FIELD(cooked_expr);
     COMPARE_NODE_FIELD(keys);
+    COMPARE_NODE_FIELD(including);
     COMPARE_NODE_FIELD(exclusions);
     COMPARE_NODE_FIELD(options);
     COMPARE_STRING_FIELD(indexname);
@@ -33,6 +33,7 @@
 #include "utils/lsyscache.h"
 #include "utils/syscache.h"
 #include "catalog/pg_proc.h"
+#include "catalog/pg_index.h"
 #include "catalog/pg_synonym.h"
 #include "catalog/pg_type.h"
 #include "optimizer/streamplan.h"
@@ -913,6 +914,7 @@ static void _outIndexScan(StringInfo str, IndexScan* node)
 {
     WRITE_NODE_TYPE("INDEXSCAN");
     _outCommonIndexScanPart<IndexScan>(str, node);
+    WRITE_BOOL_FIELD(indexskipscan);
 }
 
 static void _outCStoreIndexScan(StringInfo str, CStoreIndexScan* node)
@@ -1130,6 +1132,7 @@ static void _outIndexOnlyScan(StringInfo str, IndexOnlyScan* node)
     WRITE_NODE_FIELD(indexorderby);
     WRITE_NODE_FIELD(indextlist);
     WRITE_ENUM_FIELD(indexorderdir, ScanDirection);
+    WRITE_BOOL_FIELD(indexskipscan);
 }
 
 static void _outBitmapIndexScan(StringInfo str, BitmapIndexScan* node)
@@ -1149,6 +1152,7 @@ static void _outBitmapIndexScan(StringInfo str, BitmapIndexScan* node)
         _outToken(str, get_namespace_name(get_rel_namespace(node->indexid)));
     }
 #endif  // STREAMPLAN
+    WRITE_BOOL_FIELD(indexskipscan);
 }
 
 static void _outBitmapHeapScan(StringInfo str, BitmapHeapScan* node)
@@ -1216,6 +1220,7 @@ static void _outPartIterator(StringInfo str, PartIterator* node)
     WRITE_INT_FIELD(itrs);
     WRITE_ENUM_FIELD(direction, ScanDirection);
     WRITE_NODE_FIELD(param);
+    WRITE_NODE_FIELD(pruningQuals);
 }
 
 static void _outSubqueryScan(StringInfo str, SubqueryScan* node)
@@ -1521,6 +1526,7 @@ static void _outWindowAgg(StringInfo str, WindowAgg* node)
     WRITE_NODE_FIELD(startOffset);
     WRITE_NODE_FIELD(endOffset);
     out_mem_info(str, &node->mem_info);
+    WRITE_BOOL_FIELD(is_sonicwindow);
 }
 
 static void _outGroup(StringInfo str, Group* node)
@@ -2659,6 +2665,7 @@ static void _outIndexPath(StringInfo str, IndexPath* node)
     WRITE_ENUM_FIELD(indexscandir, ScanDirection);
     WRITE_FLOAT_FIELD(indextotalcost, "%.2f");
     WRITE_FLOAT_FIELD(indexselectivity, "%.4f");
+    WRITE_BOOL_FIELD(indexskipscan);
 }
 
 static void _outBitmapHeapPath(StringInfo str, BitmapHeapPath* node)
@@ -2965,6 +2972,7 @@ static void _outIndexOptInfo(StringInfo str, IndexOptInfo* node)
     WRITE_FLOAT_FIELD(pages, "%.0f");
     WRITE_FLOAT_FIELD(tuples, "%.0f");
     WRITE_INT_FIELD(ncolumns);
+    WRITE_INT_FIELD(nkeycolumns);
     WRITE_OID_FIELD(relam);
     WRITE_NODE_FIELD(indexprs);
     WRITE_NODE_FIELD(indpred);
@@ -3253,6 +3261,9 @@ static void _outIndexStmt(StringInfo str, IndexStmt* node)
     WRITE_STRING_FIELD(accessMethod);
     WRITE_STRING_FIELD(tableSpace);
     WRITE_NODE_FIELD(indexParams);
+    if (t_thrd.proc->workingVersionNum >= INCLUDE_INDEX_VERSION_NUM) {
+        WRITE_NODE_FIELD(indexIncludingParams);
+    }
     WRITE_NODE_FIELD(options);
     WRITE_NODE_FIELD(whereClause);
     WRITE_NODE_FIELD(excludeOpNames);
@@ -4246,6 +4257,9 @@ static void _outConstraint(StringInfo str, Constraint* node)
         case CONSTR_PRIMARY:
             appendStringInfo(str, "PRIMARY_KEY");
             WRITE_NODE_FIELD(keys);
+            if (t_thrd.proc->workingVersionNum >= INCLUDE_INDEX_VERSION_NUM) {
+                WRITE_NODE_FIELD(including);
+            }
             WRITE_NODE_FIELD(options);
             WRITE_STRING_FIELD(indexname);
             WRITE_STRING_FIELD(indexspace);
@@ -4255,6 +4269,9 @@ static void _outConstraint(StringInfo str, Constraint* node)
         case CONSTR_UNIQUE:
             appendStringInfo(str, "UNIQUE");
             WRITE_NODE_FIELD(keys);
+            if (t_thrd.proc->workingVersionNum >= INCLUDE_INDEX_VERSION_NUM) {
+                WRITE_NODE_FIELD(including);
+            }
             WRITE_NODE_FIELD(options);
             WRITE_STRING_FIELD(indexname);
             WRITE_STRING_FIELD(indexspace);
@@ -4493,6 +4510,7 @@ static void _outVecPartIterator(StringInfo str, VecPartIterator* node)
     WRITE_INT_FIELD(itrs);
     WRITE_ENUM_FIELD(direction, ScanDirection);
     WRITE_NODE_FIELD(param);
+    WRITE_NODE_FIELD(pruningQuals);
 }
 
 static void _outVecLimit(StringInfo str, VecLimit* node)
@@ -4605,6 +4623,7 @@ static void _outVecWindowAgg(StringInfo str, VecWindowAgg* node)
     WRITE_NODE_FIELD(startOffset);
     WRITE_NODE_FIELD(endOffset);
     out_mem_info(str, &node->mem_info);
+    WRITE_BOOL_FIELD(is_sonicwindow);
 }
 
 static void _outInformationalConstraint(StringInfo str, InformationalConstraint* node)
@@ -2798,6 +2798,7 @@ static WindowAgg* _readWindowAgg(WindowAgg* local_node)
     READ_NODE_FIELD(startOffset);
     READ_NODE_FIELD(endOffset);
     read_mem_info(&local_node->mem_info);
+    READ_BOOL_FIELD(is_sonicwindow);
 
     READ_DONE();
 }
@@ -2919,6 +2920,9 @@ static PartIterator* _readPartIterator(PartIterator* local_node)
     READ_INT_FIELD(itrs);
     READ_ENUM_FIELD(direction, ScanDirection);
     READ_NODE_FIELD(param);
+    IF_EXIST(pruningQuals) {
+        READ_NODE_FIELD(pruningQuals);
+    }
 
     READ_DONE();
 }
@@ -3023,6 +3027,9 @@ static IndexOnlyScan* _readIndexOnlyScan(IndexOnlyScan* local_node)
     READ_NODE_FIELD(indexorderby);
     READ_NODE_FIELD(indextlist);
     READ_ENUM_FIELD(indexorderdir, ScanDirection);
+    IF_EXIST(indexskipscan) {
+        READ_BOOL_FIELD(indexskipscan);
+    }
 
     READ_DONE();
 }
@@ -3059,6 +3066,9 @@ static BitmapIndexScan* _readBitmapIndexScan(BitmapIndexScan* local_node)
         }
     }
 #endif  // STREAMPLAN
+    IF_EXIST(indexskipscan) {
+        READ_BOOL_FIELD(indexskipscan);
+    }
     READ_DONE();
 }
 
@@ -3148,6 +3158,9 @@ static IndexScan* _readIndexScan(IndexScan* local_node)
     READ_NODE_FIELD(indexorderby);
     READ_NODE_FIELD(indexorderbyorig);
     READ_ENUM_FIELD(indexorderdir, ScanDirection);
+    IF_EXIST(indexskipscan) {
+        READ_BOOL_FIELD(indexskipscan);
+    }
     READ_DONE();
 }
 
@@ -4207,6 +4220,9 @@ static VecPartIterator* _readVecPartIterator(VecPartIterator* local_node)
     READ_INT_FIELD(itrs);
     READ_ENUM_FIELD(direction, ScanDirection);
     READ_NODE_FIELD(param);
+    IF_EXIST(pruningQuals) {
+        READ_NODE_FIELD(pruningQuals);
+    }
 
     READ_DONE();
 }
@@ -4280,6 +4296,7 @@ static VecWindowAgg* _readVecWindowAgg(VecWindowAgg* local_node)
     READ_NODE_FIELD(startOffset);
     READ_NODE_FIELD(endOffset);
     read_mem_info(&local_node->mem_info);
+    READ_BOOL_FIELD(is_sonicwindow);
 
     READ_DONE();
 }
@@ -4561,6 +4578,9 @@ static IndexStmt* _readIndexStmt()
     READ_STRING_FIELD(accessMethod);
     READ_STRING_FIELD(tableSpace);
     READ_NODE_FIELD(indexParams);
+    IF_EXIST(indexIncludingParams) {
+        READ_NODE_FIELD(indexIncludingParams);
+    }
     READ_NODE_FIELD(options);
     READ_NODE_FIELD(whereClause);
     READ_NODE_FIELD(excludeOpNames);
@@ -4615,12 +4635,18 @@ static Constraint* _readConstraint()
     } else if (MATCH_TYPE("PRIMARY_KEY")) {
         local_node->contype = CONSTR_PRIMARY;
         READ_NODE_FIELD(keys);
+        IF_EXIST(including) {
+            READ_NODE_FIELD(including);
+        }
         READ_NODE_FIELD(options);
         READ_STRING_FIELD(indexname);
         READ_STRING_FIELD(indexspace);
     } else if (MATCH_TYPE("UNIQUE")) {
         local_node->contype = CONSTR_UNIQUE;
         READ_NODE_FIELD(keys);
+        IF_EXIST(including) {
+            READ_NODE_FIELD(including);
+        }
         READ_NODE_FIELD(options);
         READ_STRING_FIELD(indexname);
         READ_STRING_FIELD(indexspace);
@@ -2115,7 +2115,7 @@ static IndexStmt* generateClonedIndexStmt(
     index->indexParams = NIL;
 
     indexprItem = list_head(indexprs);
-    for (keyno = 0; keyno < idxrec->indnatts; keyno++) {
+    for (keyno = 0; keyno < IndexRelationGetNumberOfKeyAttributes(source_idx); keyno++) {
         IndexElem* iparam = NULL;
         AttrNumber attnum = idxrec->indkey.values[keyno];
         uint16 opt = (uint16)source_idx->rd_indoption[keyno];
@@ -2195,6 +2195,24 @@ static IndexStmt* generateClonedIndexStmt(
         index->indexParams = lappend(index->indexParams, iparam);
     }
 
+    /* Build the list of the included columns, they are always simple columns */
+    index->indexIncludingParams = NIL;
+    for (keyno = IndexRelationGetNumberOfKeyAttributes(source_idx); keyno < idxrec->indnatts; keyno++) {
+        IndexElem* iparam = makeNode(IndexElem);
+        AttrNumber attnum = idxrec->indkey.values[keyno];
+
+        Assert(AttributeNumberIsValid(attnum));
+        iparam->name = get_relid_attribute_name(indrelid, attnum);
+        iparam->expr = NULL;
+        iparam->indexcolname = pstrdup(NameStr(attrs[keyno]->attname));
+        iparam->collation = NIL;
+        iparam->opclass = NIL;
+        iparam->ordering = SORTBY_DEFAULT;
+        iparam->nulls_ordering = SORTBY_NULLS_DEFAULT;
+
+        index->indexIncludingParams = lappend(index->indexIncludingParams, iparam);
+    }
+
     if (u_sess->attr.attr_sql.enable_cluster_resize && 
             isResize && RELATION_OWN_BUCKET(rel)) {
         if (!index->isPartitioned) {
@@ -2437,6 +2455,7 @@ static void transformIndexConstraints(CreateStmtContext* cxt)
             IndexStmt* priorindex = (IndexStmt*)lfirst(k);
 
             if (equal(index->indexParams, priorindex->indexParams) &&
+                equal(index->indexIncludingParams, priorindex->indexIncludingParams) &&
                 equal(index->whereClause, priorindex->whereClause) &&
                 equal(index->excludeOpNames, priorindex->excludeOpNames) &&
                 strcmp(index->accessMethod, priorindex->accessMethod) == 0 &&
@@ -2688,6 +2707,17 @@ static IndexStmt* transformIndexConstraint(Constraint* constraint, CreateStmtCon
                                   RELATION_HAS_BUCKET(heapRel));
             attname = pstrdup(NameStr(attform->attname));
 
+            /* the included columns are not part of the constraint */
+            if (i >= IndexRelationGetNumberOfKeyAttributes(indexRel)) {
+                IndexElem* iparam = makeNode(IndexElem);
+
+                iparam->name = attname;
+                iparam->ordering = SORTBY_DEFAULT;
+                iparam->nulls_ordering = SORTBY_NULLS_DEFAULT;
+                index->indexIncludingParams = lappend(index->indexIncludingParams, iparam);
+                continue;
+            }
+
             /*
              * Insist on default opclass and sort options.	While the index
              * would still work as a constraint with non-default settings, it
@@ -2865,6 +2895,20 @@ static IndexStmt* transformIndexConstraint(Constraint* constraint, CreateStmtCon
         index->indexParams = lappend(index->indexParams, iparam);
     }
 
+    /* The included columns are not part of the key, DefineIndex looks them up */
+    foreach (lc, constraint->including) {
+        IndexElem* iparam = makeNode(IndexElem);
+
+        iparam->name = pstrdup(strVal(lfirst(lc)));
+        iparam->expr = NULL;
+        iparam->indexcolname = NULL;
+        iparam->collation = NIL;
+        iparam->opclass = NIL;
+        iparam->ordering = SORTBY_DEFAULT;
+        iparam->nulls_ordering = SORTBY_NULLS_DEFAULT;
+        index->indexIncludingParams = lappend(index->indexIncludingParams, iparam);
+    }
+
     return index;
 }
 
@@ -0,0 +1,500 @@
+/* -------------------------------------------------------------------------
+ *
+ * jsonb.cpp
+ *		I/O routines for jsonb type
+ *
+ * The input is validated by the json validator first, so the parser here
+ * only has to build the value. A json value is valid already, so the cast
+ * from json parses it once, without validation.
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ * Portions Copyright (c) 1996-2014, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/common/backend/utils/adt/jsonb.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "libpq/pqformat.h"
+#include "mb/pg_wchar.h"
+#include "miscadmin.h"
+#include "storage/proc.h"
+#include "utils/builtins.h"
+#include "utils/json.h"
+#include "utils/jsonb.h"
+
+static Jsonb* jsonb_from_cstring(char* json, bool validate);
+static void jsonb_parse_value(char** s, JsonbValue* result);
+static void jsonb_parse_array(char** s, JsonbValue* result);
+static void jsonb_parse_object(char** s, JsonbValue* result);
+static void jsonb_parse_string(char** s, JsonbValue* result);
+static void jsonb_parse_number(char** s, JsonbValue* result);
+static void jsonb_put_value(StringInfo out, JsonbValue* val);
+static void jsonb_put_container(StringInfo out, JsonbContainer* container);
+
+#define JSONB_SKIP_WHITESPACE(s)                                          \
+    do {                                                                  \
+        while (*(s) == ' ' || *(s) == '\t' || *(s) == '\n' || *(s) == '\r') \
+            (s)++;                                                        \
+    } while (0)
+
+/*
+ * jsonb type input function
+ */
+Datum jsonb_in(PG_FUNCTION_ARGS)
+{
+    char* json = PG_GETARG_CSTRING(0);
+
+    PG_RETURN_JSONB(jsonb_from_cstring(json, true));
+}
+
+/*
+ * jsonb type recv function
+ *
+ * The type is sent as text in binary mode, so this is very simple: the
+ * version number is checked and the text is parsed as in jsonb_in.
+ */
+Datum jsonb_recv(PG_FUNCTION_ARGS)
+{
+    StringInfo buf = (StringInfo)PG_GETARG_POINTER(0);
+    int version = pq_getmsgint(buf, 1);
+    char* str = NULL;
+    int nbytes = 0;
+
+    if (version != 1)
+        ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+            errmsg("unsupported jsonb version number %d", version)));
+
+    str = pq_getmsgtext(buf, buf->len - buf->cursor, &nbytes);
+    PG_RETURN_JSONB(jsonb_from_cstring(str, true));
+}
+
+/*
+ * jsonb type output function
+ */
+Datum jsonb_out(PG_FUNCTION_ARGS)
+{
+    Jsonb* jb = PG_GETARG_JSONB(0);
+
+    PG_RETURN_CSTRING(JsonbToCString(NULL, &jb->root, VARSIZE(jb)));
+}
+
+/*
+ * jsonb type send function
+ *
+ * Just send jsonb as a version number, then a string of text
+ */
+Datum jsonb_send(PG_FUNCTION_ARGS)
+{
+    Jsonb* jb = PG_GETARG_JSONB(0);
+    StringInfoData buf;
+    StringInfoData jtext;
+
+    initStringInfo(&jtext);
+    (void)JsonbToCString(&jtext, &jb->root, VARSIZE(jb));
+
+    pq_begintypsend(&buf);
+    pq_sendint(&buf, 1, 1);
+    pq_sendtext(&buf, jtext.data, jtext.len);
+    pfree_ext(jtext.data);
+
+    PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+/*
+ * Cast json to jsonb, the json text is valid already.
+ */
+Datum json_to_jsonb(PG_FUNCTION_ARGS)
+{
+    char* json = text_to_cstring(PG_GETARG_TEXT_PP(0));
+
+    PG_RETURN_JSONB(jsonb_from_cstring(json, false));
+}
+
+/*
+ * Cast jsonb to json.
+ */
+Datum jsonb_to_json(PG_FUNCTION_ARGS)
+{
+    Jsonb* jb = PG_GETARG_JSONB(0);
+
+    PG_RETURN_TEXT_P(cstring_to_text(JsonbToCString(NULL, &jb->root, VARSIZE(jb))));
+}
+
+static Jsonb* jsonb_from_cstring(char* json, bool validate)
+{
+    JsonbValue value;
+    char* s = json;
+
+    /* no jsonb value may be stored before the upgrade has committed the catalog rows */
+    if (t_thrd.proc->workingVersionNum < JSONB_VERSION_NUM)
+        ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED), errmsg("jsonb is not supported in current version!")));
+
+    if (validate)
+        json_validate_cstring(json);
+
+    jsonb_parse_value(&s, &value);
+
+    /* a scalar document is kept as an array of this single scalar */
+    if (IsAJsonbScalar(&value)) {
+        JsonbValue scalar = value;
+
+        value.type = jbvArray;
+        value.val.array.nElems = 1;
+        value.val.array.elems = (JsonbValue*)palloc(sizeof(JsonbValue));
+        value.val.array.elems[0] = scalar;
+        value.val.array.rawScalar = true;
+    }
+
+    return JsonbValueToJsonb(&value);
+}
+
+/*
+ * Parse one json value at *s, which is valid json, and advance *s past it.
+ */
+static void jsonb_parse_value(char** s, JsonbValue* result)
+{
+    char* p = NULL;
+
+    JSONB_SKIP_WHITESPACE(*s);
+    p = *s;
+
+    switch (*p) {
+        case '{':
+            jsonb_parse_object(s, result);
+            break;
+        case '[':
+            jsonb_parse_array(s, result);
+            break;
+        case '"':
+            jsonb_parse_string(s, result);
+            break;
+        case 't':
+            result->type = jbvBool;
+            result->val.boolean = true;
+            *s = p + strlen("true");
+            break;
+        case 'f':
+            result->type = jbvBool;
+            result->val.boolean = false;
+            *s = p + strlen("false");
+            break;
+        case 'n':
+            result->type = jbvNull;
+            *s = p + strlen("null");
+            break;
+        default:
+            jsonb_parse_number(s, result);
+            break;
+    }
+}
+
+static void jsonb_parse_array(char** s, JsonbValue* result)
+{
+    int size = 4;
+
+    check_stack_depth();
+
+    result->type = jbvArray;
+    result->val.array.nElems = 0;
+    result->val.array.elems = (JsonbValue*)palloc(sizeof(JsonbValue) * size);
+    result->val.array.rawScalar = false;
+
+    (*s)++; /* skip '[' */
+    JSONB_SKIP_WHITESPACE(*s);
+    if (**s == ']') {
+        (*s)++;
+        return;
+    }
+
+    for (;;) {
+        if (result->val.array.nElems >= size) {
+            size *= 2;
+            result->val.array.elems = (JsonbValue*)repalloc(result->val.array.elems, sizeof(JsonbValue) * size);
+        }
+        jsonb_parse_value(s, &result->val.array.elems[result->val.array.nElems++]);
+
+        JSONB_SKIP_WHITESPACE(*s);
+        if (**s != ',')
+            break;
+        (*s)++;
+    }
+    (*s)++; /* skip ']' */
+}
+
+static void jsonb_parse_object(char** s, JsonbValue* result)
+{
+    int size = 4;
+
+    check_stack_depth();
+
+    result->type = jbvObject;
+    result->val.object.nPairs = 0;
+    result->val.object.pairs = (JsonbPair*)palloc(sizeof(JsonbPair) * size);
+
+    (*s)++; /* skip '{' */
+    JSONB_SKIP_WHITESPACE(*s);
+    if (**s == '}') {
+        (*s)++;
+        return;
+    }
+
+    for (;;) {
+        JsonbPair* pair = NULL;
+
+        if (result->val.object.nPairs >= size) {
+            size *= 2;
+            result->val.object.pairs = (JsonbPair*)repalloc(result->val.object.pairs, sizeof(JsonbPair) * size);
+        }
+        pair = &result->val.object.pairs[result->val.object.nPairs];
+        pair->order = result->val.object.nPairs++;
+
+        JSONB_SKIP_WHITESPACE(*s);
+        jsonb_parse_string(s, &pair->key);
+        JSONB_SKIP_WHITESPACE(*s);
+        (*s)++; /* skip ':' */
+        jsonb_parse_value(s, &pair->value);
+
+        JSONB_SKIP_WHITESPACE(*s);
+        if (**s != ',')
+            break;
+        (*s)++;
+    }
+    (*s)++; /* skip '}' */
+}
+
+static int jsonb_hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return c - 'A' + 10;
+}
+
+/*
+ * Parse a json string into its unescaped text.
+ */
+static void jsonb_parse_string(char** s, JsonbValue* result)
+{
+    StringInfoData buf;
+    char* p = *s + 1;
+    int hi_surrogate = -1;
+
+    initStringInfo(&buf);
+    while (*p != '"') {
+        if (*p != '\\') {
+            int len = pg_mblen(p);
+
+            if (hi_surrogate != -1)
+                ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
+                    errmsg("invalid input syntax for type json"),
+                    errdetail("Unicode low surrogate must follow a high surrogate.")));
+
+            appendBinaryStringInfo(&buf, p, len);
+            p += len;
+            continue;
+        }
+
+        p++;
+        if (*p == 'u') {
+            int ch = 0;
+            int i;
+
+            for (i = 1; i <= 4; i++)
+                ch = (ch * 16) + jsonb_hex_value(p[i]);
+            p += 5;
+
+            if (ch >= 0xd800 && ch <= 0xdbff) {
+                if (hi_surrogate != -1)
+                    ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
+                        errmsg("invalid input syntax for type json"),
+                        errdetail("Unicode high surrogate must not follow a high surrogate.")));
+                hi_surrogate = (ch & 0x3ff) << 10;
+                continue;
+            } else if (ch >= 0xdc00 && ch <= 0xdfff) {
+                if (hi_surrogate == -1)
+                    ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
+                        errmsg("invalid input syntax for type json"),
+                        errdetail("Unicode low surrogate must follow a high surrogate.")));
+                ch = 0x10000 + hi_surrogate + (ch & 0x3ff);
+                hi_surrogate = -1;
+            }
+
+            if (hi_surrogate != -1)
+                ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
+                    errmsg("invalid input syntax for type json"),
+                    errdetail("Unicode low surrogate must follow a high surrogate.")));
+
+            if (ch == 0) {
+                /* text cannot hold a zero byte */
+                ereport(ERROR, (errcode(ERRCODE_UNTRANSLATABLE_CHARACTER),
+                    errmsg("unsupported Unicode escape sequence"),
+                    errdetail("\\u0000 cannot be converted to text.")));
+            } else if (GetDatabaseEncoding() == PG_UTF8) {
+                unsigned char utf8str[5];
+
+                (void)unicode_to_utf8((pg_wchar)ch, utf8str);
+                appendBinaryStringInfo(&buf, (char*)utf8str, pg_utf_mblen(utf8str));
+            } else if (ch <= 0x007f) {
+                appendStringInfoChar(&buf, (char)ch);
+            } else {
+                ereport(ERROR, (errcode(ERRCODE_UNTRANSLATABLE_CHARACTER),
+                    errmsg("unsupported Unicode escape sequence"),
+                    errdetail("Unicode escape values cannot be used for code point values above 007F when the "
+                              "server encoding is not UTF8.")));
+            }
+            continue;
+        }
+
+        if (hi_surrogate != -1)
+            ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
+                errmsg("invalid input syntax for type json"),
+                errdetail("Unicode low surrogate must follow a high surrogate.")));
+
+        switch (*p) {
+            case 'b':
+                appendStringInfoChar(&buf, '\b');
+                break;
+            case 'f':
+                appendStringInfoChar(&buf, '\f');
+                break;
+            case 'n':
+                appendStringInfoChar(&buf, '\n');
+                break;
+            case 'r':
+                appendStringInfoChar(&buf, '\r');
+                break;
+            case 't':
+                appendStringInfoChar(&buf, '\t');
+                break;
+            default:
+                /* '"', '\\' and '/' stand for themselves */
+                appendStringInfoChar(&buf, *p);
+                break;
+        }
+        p++;
+    }
+
+    if (hi_surrogate != -1)
+        ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
+            errmsg("invalid input syntax for type json"),
+            errdetail("Unicode low surrogate must follow a high surrogate.")));
+
+    *s = p + 1;
+    result->type = jbvString;
+    result->val.string.val = buf.data;
+    result->val.string.len = buf.len;
+}
+
+static void jsonb_parse_number(char** s, JsonbValue* result)
+{
+    char* start = *s;
+    char* p = start;
+    char* numstr = NULL;
+
+    if (*p == '-')
+        p++;
+    while ((*p >= '0' && *p <= '9') || *p == '.' || *p == 'e' || *p == 'E' || *p == '+' || *p == '-')
+        p++;
+
+    numstr = pnstrdup(start, p - start);
+    result->type = jbvNumeric;
+    result->val.numeric = DatumGetNumeric(
+        DirectFunctionCall3(numeric_in, CStringGetDatum(numstr), ObjectIdGetDatum(InvalidOid), Int32GetDatum(-1)));
+    pfree_ext(numstr);
+
+    *s = p;
+}
+
+/*
+ * JsonbToCString
+ *	   Convert a jsonb container to its text form.
+ *
+ * If out is NULL a new StringInfo is used; estimated_len is a hint of the
+ * size of the text.
+ */
+char* JsonbToCString(StringInfo out, JsonbContainer* in, int estimated_len)
+{
+    if (out == NULL)
+        out = makeStringInfo();
+
+    enlargeStringInfo(out, (estimated_len >= 0) ? estimated_len : 64);
+
+    if (JsonContainerIsScalar(in)) {
+        JsonbValue scalar;
+
+        getJsonbChildValue(in, 0, &scalar);
+        jsonb_put_value(out, &scalar);
+    } else {
+        jsonb_put_container(out, in);
+    }
+
+    return out->data;
+}
+
+static void jsonb_put_value(StringInfo out, JsonbValue* val)
+{
+    switch (val->type) {
+        case jbvNull:
+            appendBinaryStringInfo(out, "null", strlen("null"));
+            break;
+        case jbvString: {
+            char* str = pnstrdup(val->val.string.val, val->val.string.len);
+
+            escape_json(out, str);
+            pfree_ext(str);
+            break;
+        }
+        case jbvNumeric:
+            appendStringInfoString(
+                out, DatumGetCString(DirectFunctionCall1(numeric_out, NumericGetDatum(val->val.numeric))));
+            break;
+        case jbvBool:
+            if (val->val.boolean)
+                appendBinaryStringInfo(out, "true", strlen("true"));
+            else
+                appendBinaryStringInfo(out, "false", strlen("false"));
+            break;
+        case jbvBinary:
+            jsonb_put_container(out, val->val.binary.data);
+            break;
+        default:
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION), errmsg("unknown type of jsonb container")));
+    }
+}
+
+static void jsonb_put_container(StringInfo out, JsonbContainer* container)
+{
+    int count = JsonContainerSize(container);
+    JsonbValue val;
+    int i;
+
+    check_stack_depth();
+
+    if (JsonContainerIsObject(container)) {
+        appendStringInfoChar(out, '{');
+        for (i = 0; i < count; i++) {
+            if (i > 0)
+                appendBinaryStringInfo(out, ", ", 2);
+            getJsonbChildValue(container, i, &val);
+            jsonb_put_value(out, &val);
+            appendBinaryStringInfo(out, ": ", 2);
+            getJsonbChildValue(container, i + count, &val);
+            jsonb_put_value(out, &val);
+        }
+        appendStringInfoChar(out, '}');
+    } else {
+        appendStringInfoChar(out, '[');
+        for (i = 0; i < count; i++) {
+            if (i > 0)
+                appendBinaryStringInfo(out, ", ", 2);
+            getJsonbChildValue(container, i, &val);
+            jsonb_put_value(out, &val);
+        }
+        appendStringInfoChar(out, ']');
+    }
+}
@@ -0,0 +1,309 @@
+/* -------------------------------------------------------------------------
+ *
+ * jsonb_gin.cpp
+ *	  GIN support functions for jsonb
+ *
+ * The index entries are text: a flag byte and the key or value. Every key
+ * of every object is an entry, and every scalar value at any depth is one;
+ * strings in arrays are flagged as keys, so that the exists operators find
+ * them as keys. Strings too long for an index tuple are stored as a hash,
+ * numerics always are, so that equal numerics with different scales give
+ * the same entry. The structure is lost, hence the operators always recheck.
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ * Portions Copyright (c) 1996-2014, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/common/backend/utils/adt/jsonb_gin.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "access/gin.h"
+#include "access/hash.h"
+#include "access/skey.h"
+#include "catalog/pg_type.h"
+#include "utils/array.h"
+#include "utils/builtins.h"
+#include "utils/jsonb.h"
+
+typedef struct JsonbGinEntries {
+    Datum* entries;
+    int32 count;
+    int32 allocated;
+} JsonbGinEntries;
+
+static text* make_text_key(char flag, const char* str, int len);
+static text* make_scalar_key(const JsonbValue* scalarVal, bool isKey);
+static void add_gin_entry(JsonbGinEntries* entries, text* entry);
+static void extract_container_entries(JsonbContainer* container, JsonbGinEntries* entries);
+
+Datum gin_compare_jsonb(PG_FUNCTION_ARGS)
+{
+    text* arg1 = PG_GETARG_TEXT_PP(0);
+    text* arg2 = PG_GETARG_TEXT_PP(1);
+    int32 len1 = VARSIZE_ANY_EXHDR(arg1);
+    int32 len2 = VARSIZE_ANY_EXHDR(arg2);
+    int32 result;
+
+    /* the order only has to be consistent, not meaningful */
+    result = memcmp(VARDATA_ANY(arg1), VARDATA_ANY(arg2), Min(len1, len2));
+    if (result == 0)
+        result = (len1 > len2) ? 1 : ((len1 == len2) ? 0 : -1);
+
+    PG_FREE_IF_COPY(arg1, 0);
+    PG_FREE_IF_COPY(arg2, 1);
+    PG_RETURN_INT32(result);
+}
+
+Datum gin_extract_jsonb(PG_FUNCTION_ARGS)
+{
+    Jsonb* jb = PG_GETARG_JSONB(0);
+    int32* nentries = (int32*)PG_GETARG_POINTER(1);
+    JsonbGinEntries entries = {NULL, 0, 0};
+
+    extract_container_entries(&jb->root, &entries);
+
+    *nentries = entries.count;
+    PG_RETURN_POINTER(entries.entries);
+}
+
+Datum gin_extract_jsonb_query(PG_FUNCTION_ARGS)
+{
+    int32* nentries = (int32*)PG_GETARG_POINTER(1);
+    StrategyNumber strategy = PG_GETARG_UINT16(2);
+    int32* searchMode = (int32*)PG_GETARG_POINTER(6);
+    Datum* entries = NULL;
+
+    if (strategy == JsonbContainsStrategyNumber) {
+        /* the entries of the query must all be in the indexed value */
+        JsonbGinEntries queryEntries = {NULL, 0, 0};
+        Jsonb* query = PG_GETARG_JSONB(0);
+
+        extract_container_entries(&query->root, &queryEntries);
+        entries = queryEntries.entries;
+        *nentries = queryEntries.count;
+
+        /* an empty object or array is contained in every value of its kind */
+        if (*nentries == 0)
+            *searchMode = GIN_SEARCH_MODE_ALL;
+    } else if (strategy == JsonbExistsStrategyNumber) {
+        text* query = PG_GETARG_TEXT_PP(0);
+
+        *nentries = 1;
+        entries = (Datum*)palloc(sizeof(Datum));
+        entries[0] = PointerGetDatum(make_text_key(JGINFLAG_KEY, VARDATA_ANY(query), VARSIZE_ANY_EXHDR(query)));
+    } else if (strategy == JsonbExistsAnyStrategyNumber || strategy == JsonbExistsAllStrategyNumber) {
+        ArrayType* query = PG_GETARG_ARRAYTYPE_P(0);
+        Datum* key_datums = NULL;
+        bool* key_nulls = NULL;
+        int key_count;
+        int i;
+        int j = 0;
+
+        deconstruct_array(query, TEXTOID, -1, false, 'i', &key_datums, &key_nulls, &key_count);
+
+        entries = (Datum*)palloc(sizeof(Datum) * (key_count > 0 ? key_count : 1));
+        for (i = 0; i < key_count; i++) {
+            /* nulls in the array are ignored by the operators */
+            if (key_nulls[i])
+                continue;
+            text* key = DatumGetTextPP(key_datums[i]);
+            entries[j++] = PointerGetDatum(make_text_key(JGINFLAG_KEY, VARDATA_ANY(key), VARSIZE_ANY_EXHDR(key)));
+        }
+        *nentries = j;
+
+        /* ?& with no keys is true for every value, ?| with none for none */
+        if (j == 0 && strategy == JsonbExistsAllStrategyNumber)
+            *searchMode = GIN_SEARCH_MODE_ALL;
+    } else {
+        ereport(ERROR, (errcode(ERRCODE_UNRECOGNIZED_NODE_TYPE), errmsg("unrecognized strategy number: %d", strategy)));
+    }
+
+    PG_RETURN_POINTER(entries);
+}
+
+Datum gin_consistent_jsonb(PG_FUNCTION_ARGS)
+{
+    bool* check = (bool*)PG_GETARG_POINTER(0);
+    StrategyNumber strategy = PG_GETARG_UINT16(1);
+    int32 nkeys = PG_GETARG_INT32(3);
+    bool* recheck = (bool*)PG_GETARG_POINTER(5);
+    bool res = true;
+    int32 i;
+
+    /* the entries do not keep the structure of the value, always recheck */
+    *recheck = true;
+
+    switch (strategy) {
+        case JsonbContainsStrategyNumber:
+        case JsonbExistsAllStrategyNumber:
+            for (i = 0; i < nkeys; i++) {
+                if (!check[i]) {
+                    res = false;
+                    break;
+                }
+            }
+            break;
+        case JsonbExistsStrategyNumber:
+            res = check[0];
+            break;
+        case JsonbExistsAnyStrategyNumber:
+            res = false;
+            for (i = 0; i < nkeys; i++) {
+                if (check[i]) {
+                    res = true;
+                    break;
+                }
+            }
+            break;
+        default:
+            ereport(ERROR, (errcode(ERRCODE_UNRECOGNIZED_NODE_TYPE), errmsg("unrecognized strategy number: %d", strategy)));
+    }
+
+    PG_RETURN_BOOL(res);
+}
+
+Datum gin_triconsistent_jsonb(PG_FUNCTION_ARGS)
+{
+    GinTernaryValue* check = (GinTernaryValue*)PG_GETARG_POINTER(0);
+    StrategyNumber strategy = PG_GETARG_UINT16(1);
+    int32 nkeys = PG_GETARG_INT32(3);
+    GinTernaryValue res = GIN_MAYBE;
+    int32 i;
+
+    /* never GIN_TRUE, the operators recheck */
+    switch (strategy) {
+        case JsonbContainsStrategyNumber:
+        case JsonbExistsAllStrategyNumber:
+            for (i = 0; i < nkeys; i++) {
+                if (check[i] == GIN_FALSE) {
+                    res = GIN_FALSE;
+                    break;
+                }
+            }
+            break;
+        case JsonbExistsStrategyNumber:
+            res = (check[0] == GIN_FALSE) ? GIN_FALSE : GIN_MAYBE;
+            break;
+        case JsonbExistsAnyStrategyNumber:
+            res = GIN_FALSE;
+            for (i = 0; i < nkeys; i++) {
+                if (check[i] != GIN_FALSE) {
+                    res = GIN_MAYBE;
+                    break;
+                }
+            }
+            break;
+        default:
+            ereport(ERROR, (errcode(ERRCODE_UNRECOGNIZED_NODE_TYPE), errmsg("unrecognized strategy number: %d", strategy)));
+    }
+
+    PG_RETURN_GIN_TERNARY_VALUE(res);
+}
+
+/*
+ * An entry of the flag and the string; a string too long for an index tuple
+ * is replaced with its hash.
+ */
+static text* make_text_key(char flag, const char* str, int len)
+{
+    char hashbuf[10];
+    text* item = NULL;
+    errno_t rc;
+
+    if (len > JGIN_MAXLENGTH) {
+        uint32 hashval = DatumGetUInt32(hash_any((const unsigned char*)str, len));
+        rc = snprintf_s(hashbuf, sizeof(hashbuf), sizeof(hashbuf) - 1, "%08x", hashval);
+        securec_check_ss(rc, "\0", "\0");
+        str = hashbuf;
+        len = 8;
+        flag |= JGINFLAG_HASHED;
+    }
+
+    item = (text*)palloc(VARHDRSZ + len + 1);
+    SET_VARSIZE(item, VARHDRSZ + len + 1);
+    *VARDATA(item) = flag;
+    if (len > 0) {
+        rc = memcpy_s(VARDATA(item) + 1, len, str, len);
+        securec_check(rc, "\0", "\0");
+    }
+
+    return item;
+}
+
+static text* make_scalar_key(const JsonbValue* scalarVal, bool isKey)
+{
+    text* item = NULL;
+    char hashbuf[10];
+    uint32 hashval;
+    errno_t rc;
+
+    switch (scalarVal->type) {
+        case jbvNull:
+            item = make_text_key(JGINFLAG_NULL, "", 0);
+            break;
+        case jbvBool:
+            item = make_text_key(JGINFLAG_BOOL, scalarVal->val.boolean ? "t" : "f", 1);
+            break;
+        case jbvNumeric:
+            /* equal numerics hash alike whatever their scale */
+            hashval = DatumGetUInt32(DirectFunctionCall1(hash_numeric, NumericGetDatum(scalarVal->val.numeric)));
+            rc = snprintf_s(hashbuf, sizeof(hashbuf), sizeof(hashbuf) - 1, "%08x", hashval);
+            securec_check_ss(rc, "\0", "\0");
+            item = make_text_key(JGINFLAG_NUM, hashbuf, 8);
+            break;
+        case jbvString:
+            item = make_text_key(isKey ? JGINFLAG_KEY : JGINFLAG_STR,
+                scalarVal->val.string.val, scalarVal->val.string.len);
+            break;
+        default:
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION), errmsg("unrecognized jsonb scalar type: %d",
+                (int)scalarVal->type)));
+    }
+
+    return item;
+}
+
+static void add_gin_entry(JsonbGinEntries* entries, text* entry)
+{
+    if (entries->count >= entries->allocated) {
+        if (entries->allocated == 0) {
+            entries->allocated = 16;
+            entries->entries = (Datum*)palloc(sizeof(Datum) * entries->allocated);
+        } else {
+            entries->allocated *= 2;
+            entries->entries = (Datum*)repalloc(entries->entries, sizeof(Datum) * entries->allocated);
+        }
+    }
+
+    entries->entries[entries->count++] = PointerGetDatum(entry);
+}
+
+/* entries of the keys and scalars of a container, and of the ones it contains */
+static void extract_container_entries(JsonbContainer* container, JsonbGinEntries* entries)
+{
+    int count = (int)JsonContainerSize(container);
+    bool isObject = JsonContainerIsObject(container);
+    JsonbValue v;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        if (isObject) {
+            getJsonbChildValue(container, i, &v);
+            add_gin_entry(entries, make_scalar_key(&v, true));
+            getJsonbChildValue(container, i + count, &v);
+        } else {
+            getJsonbChildValue(container, i, &v);
+        }
+
+        if (v.type == jbvBinary) {
+            extract_container_entries(v.val.binary.data, entries);
+        } else {
+            /* strings in arrays are keys for the exists operators */
+            add_gin_entry(entries, make_scalar_key(&v, !isObject));
+        }
+    }
+}
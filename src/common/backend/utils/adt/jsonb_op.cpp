@@ -0,0 +1,203 @@
+/* -------------------------------------------------------------------------
+ *
+ * jsonb_op.cpp
+ *	  Special operators for jsonb only, used by various index access methods
+ *
+ * The field and element accessors look up their value in the binary form
+ * directly: a key by binary search over the sorted keys of the object, an
+ * element through the offset table of the array.
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ * Portions Copyright (c) 1996-2014, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/common/backend/utils/adt/jsonb_op.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "catalog/pg_type.h"
+#include "utils/array.h"
+#include "utils/builtins.h"
+#include "utils/jsonb.h"
+
+static text* JsonbValueAsText(JsonbValue* v);
+static bool jsonb_get_array_element(Jsonb* jb, int32 element, JsonbValue* result);
+static bool jsonb_key_exists(Jsonb* jb, text* key);
+
+/* text of a value for the ->> operators, NULL for a json null */
+static text* JsonbValueAsText(JsonbValue* v)
+{
+    switch (v->type) {
+        case jbvNull:
+            return NULL;
+        case jbvString:
+            return cstring_to_text_with_len(v->val.string.val, v->val.string.len);
+        case jbvBool:
+            return cstring_to_text(v->val.boolean ? "true" : "false");
+        case jbvNumeric:
+            return cstring_to_text(DatumGetCString(DirectFunctionCall1(numeric_out, NumericGetDatum(v->val.numeric))));
+        case jbvBinary:
+            return cstring_to_text(JsonbToCString(NULL, v->val.binary.data, v->val.binary.len));
+        default:
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION), errmsg("unrecognized jsonb type: %d", (int)v->type)));
+    }
+
+    return NULL;
+}
+
+/* a negative element counts from the end of the array */
+static bool jsonb_get_array_element(Jsonb* jb, int32 element, JsonbValue* result)
+{
+    int32 count = (int32)JB_ROOT_COUNT(jb);
+
+    if (!JB_ROOT_IS_ARRAY(jb) || JB_ROOT_IS_SCALAR(jb))
+        return false;
+
+    if (element < 0)
+        element += count;
+    if (element < 0 || element >= count)
+        return false;
+
+    getJsonbChildValue(&jb->root, element, result);
+    return true;
+}
+
+Datum jsonb_object_field(PG_FUNCTION_ARGS)
+{
+    Jsonb* jb = PG_GETARG_JSONB(0);
+    text* key = PG_GETARG_TEXT_PP(1);
+    JsonbValue v;
+
+    if (!findJsonbObjectKey(&jb->root, VARDATA_ANY(key), VARSIZE_ANY_EXHDR(key), &v))
+        PG_RETURN_NULL();
+
+    PG_RETURN_JSONB(JsonbValueToJsonb(&v));
+}
+
+Datum jsonb_object_field_text(PG_FUNCTION_ARGS)
+{
+    Jsonb* jb = PG_GETARG_JSONB(0);
+    text* key = PG_GETARG_TEXT_PP(1);
+    JsonbValue v;
+    text* result = NULL;
+
+    if (!findJsonbObjectKey(&jb->root, VARDATA_ANY(key), VARSIZE_ANY_EXHDR(key), &v))
+        PG_RETURN_NULL();
+
+    result = JsonbValueAsText(&v);
+    if (result == NULL)
+        PG_RETURN_NULL();
+
+    PG_RETURN_TEXT_P(result);
+}
+
+Datum jsonb_array_element(PG_FUNCTION_ARGS)
+{
+    Jsonb* jb = PG_GETARG_JSONB(0);
+    int32 element = PG_GETARG_INT32(1);
+    JsonbValue v;
+
+    if (!jsonb_get_array_element(jb, element, &v))
+        PG_RETURN_NULL();
+
+    PG_RETURN_JSONB(JsonbValueToJsonb(&v));
+}
+
+Datum jsonb_array_element_text(PG_FUNCTION_ARGS)
+{
+    Jsonb* jb = PG_GETARG_JSONB(0);
+    int32 element = PG_GETARG_INT32(1);
+    JsonbValue v;
+    text* result = NULL;
+
+    if (!jsonb_get_array_element(jb, element, &v))
+        PG_RETURN_NULL();
+
+    result = JsonbValueAsText(&v);
+    if (result == NULL)
+        PG_RETURN_NULL();
+
+    PG_RETURN_TEXT_P(result);
+}
+
+Datum jsonb_contains(PG_FUNCTION_ARGS)
+{
+    Jsonb* val = PG_GETARG_JSONB(0);
+    Jsonb* tmpl = PG_GETARG_JSONB(1);
+
+    PG_RETURN_BOOL(JsonbDeepContains(&val->root, &tmpl->root));
+}
+
+Datum jsonb_contained(PG_FUNCTION_ARGS)
+{
+    /* Commutator of "contains" */
+    Jsonb* tmpl = PG_GETARG_JSONB(0);
+    Jsonb* val = PG_GETARG_JSONB(1);
+
+    PG_RETURN_BOOL(JsonbDeepContains(&val->root, &tmpl->root));
+}
+
+/*
+ * A key exists as a key of the top-level object, or as a string element of
+ * the top-level array.
+ */
+static bool jsonb_key_exists(Jsonb* jb, text* key)
+{
+    if (JB_ROOT_IS_OBJECT(jb))
+        return findJsonbObjectKey(&jb->root, VARDATA_ANY(key), VARSIZE_ANY_EXHDR(key), NULL);
+
+    return findJsonbArrayString(&jb->root, VARDATA_ANY(key), VARSIZE_ANY_EXHDR(key));
+}
+
+Datum jsonb_exists(PG_FUNCTION_ARGS)
+{
+    Jsonb* jb = PG_GETARG_JSONB(0);
+    text* key = PG_GETARG_TEXT_PP(1);
+
+    PG_RETURN_BOOL(jsonb_key_exists(jb, key));
+}
+
+Datum jsonb_exists_any(PG_FUNCTION_ARGS)
+{
+    Jsonb* jb = PG_GETARG_JSONB(0);
+    ArrayType* keys = PG_GETARG_ARRAYTYPE_P(1);
+    Datum* key_datums = NULL;
+    bool* key_nulls = NULL;
+    int elem_count;
+    int i;
+
+    deconstruct_array(keys, TEXTOID, -1, false, 'i', &key_datums, &key_nulls, &elem_count);
+
+    for (i = 0; i < elem_count; i++) {
+        if (key_nulls[i])
+            continue;
+        if (jsonb_key_exists(jb, DatumGetTextPP(key_datums[i])))
+            PG_RETURN_BOOL(true);
+    }
+
+    PG_RETURN_BOOL(false);
+}
+
+Datum jsonb_exists_all(PG_FUNCTION_ARGS)
+{
+    Jsonb* jb = PG_GETARG_JSONB(0);
+    ArrayType* keys = PG_GETARG_ARRAYTYPE_P(1);
+    Datum* key_datums = NULL;
+    bool* key_nulls = NULL;
+    int elem_count;
+    int i;
+
+    deconstruct_array(keys, TEXTOID, -1, false, 'i', &key_datums, &key_nulls, &elem_count);
+
+    for (i = 0; i < elem_count; i++) {
+        if (key_nulls[i])
+            continue;
+        if (!jsonb_key_exists(jb, DatumGetTextPP(key_datums[i])))
+            PG_RETURN_BOOL(false);
+    }
+
+    PG_RETURN_BOOL(true);
+}
@@ -0,0 +1,493 @@
+/* -------------------------------------------------------------------------
+ *
+ * jsonb_util.cpp
+ *	  converting between jsonb values in memory and their on-disk form,
+ *	  and looking into the on-disk form
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ * Portions Copyright (c) 1996-2014, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/common/backend/utils/adt/jsonb_util.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "miscadmin.h"
+#include "utils/builtins.h"
+#include "utils/jsonb.h"
+
+static void convertJsonbValue(StringInfo buffer, JEntry* header, JsonbValue* val);
+static void convertJsonbArray(StringInfo buffer, JEntry* header, JsonbValue* val);
+static void convertJsonbObject(StringInfo buffer, JEntry* header, JsonbValue* val);
+static void convertJsonbScalar(StringInfo buffer, JEntry* header, JsonbValue* scalarVal);
+static void uniqueifyJsonbObject(JsonbValue* object);
+static int lengthCompareJsonbString(const char* val1, int len1, const char* val2, int len2);
+static int lengthCompareJsonbPair(const void* a, const void* b);
+static bool containsJsonbValue(JsonbValue* val, JsonbValue* query);
+
+static int reserveFromBuffer(StringInfo buffer, int len)
+{
+    int offset;
+
+    enlargeStringInfo(buffer, len);
+    offset = buffer->len;
+    buffer->len += len;
+    buffer->data[buffer->len] = '\0';
+
+    return offset;
+}
+
+static void copyToBuffer(StringInfo buffer, int offset, const void* data, int len)
+{
+    if (len > 0) {
+        errno_t rc = memcpy_s(buffer->data + offset, len, data, len);
+        securec_check(rc, "\0", "\0");
+    }
+}
+
+static void appendToBuffer(StringInfo buffer, const void* data, int len)
+{
+    copyToBuffer(buffer, reserveFromBuffer(buffer, len), data, len);
+}
+
+/* numerics and containers are int-aligned, the padding counts in their length */
+static void padBufferToInt(StringInfo buffer)
+{
+    int padlen = INTALIGN(buffer->len) - buffer->len;
+    int offset = reserveFromBuffer(buffer, padlen);
+    int i;
+
+    for (i = 0; i < padlen; i++)
+        buffer->data[offset + i] = '\0';
+}
+
+/*
+ * Turn an in-memory JsonbValue into a Jsonb for on-disk storage.
+ *
+ * A scalar becomes a document of that single scalar. Object keys are sorted
+ * and deduplicated here.
+ */
+Jsonb* JsonbValueToJsonb(JsonbValue* val)
+{
+    StringInfoData buffer;
+    JsonbValue scalarArray;
+    JEntry jentry;
+    Jsonb* res = NULL;
+
+    if (val->type == jbvBinary) {
+        /* a container of another jsonb, copy it as it is */
+        res = (Jsonb*)palloc(VARHDRSZ + val->val.binary.len);
+        SET_VARSIZE(res, VARHDRSZ + val->val.binary.len);
+        errno_t rc = memcpy_s(&res->root, val->val.binary.len, val->val.binary.data, val->val.binary.len);
+        securec_check(rc, "\0", "\0");
+        return res;
+    }
+
+    if (IsAJsonbScalar(val)) {
+        scalarArray.type = jbvArray;
+        scalarArray.val.array.nElems = 1;
+        scalarArray.val.array.elems = val;
+        scalarArray.val.array.rawScalar = true;
+        val = &scalarArray;
+    }
+
+    initStringInfo(&buffer);
+
+    /* make room for the varlena header */
+    (void)reserveFromBuffer(&buffer, VARHDRSZ);
+
+    convertJsonbValue(&buffer, &jentry, val);
+
+    res = (Jsonb*)buffer.data;
+    SET_VARSIZE(res, buffer.len);
+
+    return res;
+}
+
+/*
+ * Serialize val at the end of buffer, and set the type bits of its JEntry in
+ * *header. The caller adds the end offset.
+ */
+static void convertJsonbValue(StringInfo buffer, JEntry* header, JsonbValue* val)
+{
+    check_stack_depth();
+
+    if (IsAJsonbScalar(val)) {
+        convertJsonbScalar(buffer, header, val);
+    } else if (val->type == jbvArray) {
+        convertJsonbArray(buffer, header, val);
+    } else if (val->type == jbvObject) {
+        convertJsonbObject(buffer, header, val);
+    } else if (val->type == jbvBinary) {
+        padBufferToInt(buffer);
+        appendToBuffer(buffer, val->val.binary.data, val->val.binary.len);
+        *header = JENTRY_ISCONTAINER;
+    } else {
+        ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION), errmsg("unknown type of jsonb container to convert")));
+    }
+}
+
+/* set the end offset of a child written since dataStart, and store its JEntry */
+static void setJsonbChildEntry(StringInfo buffer, int jentryOffset, int dataStart, JEntry meta)
+{
+    uint32 end = buffer->len - dataStart;
+
+    if (end > JENTRY_ENDMASK)
+        ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+            errmsg("total size of jsonb container elements exceeds the maximum of %u bytes", JENTRY_ENDMASK)));
+
+    meta |= end;
+    copyToBuffer(buffer, jentryOffset, &meta, sizeof(JEntry));
+}
+
+static void convertJsonbArray(StringInfo buffer, JEntry* pheader, JsonbValue* val)
+{
+    int nElems = val->val.array.nElems;
+    uint32 header;
+    int jentryOffset;
+    int dataStart;
+    int i;
+
+    if (nElems > JB_CMASK)
+        ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+            errmsg("number of jsonb array elements exceeds the maximum allowed (%d)", JB_CMASK)));
+
+    padBufferToInt(buffer);
+
+    header = nElems | JB_FARRAY;
+    if (val->val.array.rawScalar) {
+        Assert(nElems == 1);
+        header |= JB_FSCALAR;
+    }
+    appendToBuffer(buffer, &header, sizeof(uint32));
+
+    jentryOffset = reserveFromBuffer(buffer, sizeof(JEntry) * nElems);
+    dataStart = buffer->len;
+
+    for (i = 0; i < nElems; i++) {
+        JEntry meta;
+
+        convertJsonbValue(buffer, &meta, &val->val.array.elems[i]);
+        setJsonbChildEntry(buffer, jentryOffset, dataStart, meta);
+        jentryOffset += sizeof(JEntry);
+    }
+
+    *pheader = JENTRY_ISCONTAINER;
+}
+
+static void convertJsonbObject(StringInfo buffer, JEntry* pheader, JsonbValue* val)
+{
+    int nPairs;
+    uint32 header;
+    int jentryOffset;
+    int dataStart;
+    int i;
+
+    uniqueifyJsonbObject(val);
+    nPairs = val->val.object.nPairs;
+
+    if (nPairs > JB_CMASK)
+        ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+            errmsg("number of jsonb object pairs exceeds the maximum allowed (%d)", JB_CMASK)));
+
+    padBufferToInt(buffer);
+
+    header = nPairs | JB_FOBJECT;
+    appendToBuffer(buffer, &header, sizeof(uint32));
+
+    jentryOffset = reserveFromBuffer(buffer, sizeof(JEntry) * nPairs * 2);
+    dataStart = buffer->len;
+
+    /* all the keys first, then all the values */
+    for (i = 0; i < nPairs; i++) {
+        JEntry meta;
+
+        convertJsonbScalar(buffer, &meta, &val->val.object.pairs[i].key);
+        setJsonbChildEntry(buffer, jentryOffset, dataStart, meta);
+        jentryOffset += sizeof(JEntry);
+    }
+    for (i = 0; i < nPairs; i++) {
+        JEntry meta;
+
+        convertJsonbValue(buffer, &meta, &val->val.object.pairs[i].value);
+        setJsonbChildEntry(buffer, jentryOffset, dataStart, meta);
+        jentryOffset += sizeof(JEntry);
+    }
+
+    *pheader = JENTRY_ISCONTAINER;
+}
+
+static void convertJsonbScalar(StringInfo buffer, JEntry* header, JsonbValue* scalarVal)
+{
+    switch (scalarVal->type) {
+        case jbvNull:
+            *header = JENTRY_ISNULL;
+            break;
+        case jbvString:
+            appendToBuffer(buffer, scalarVal->val.string.val, scalarVal->val.string.len);
+            *header = JENTRY_ISSTRING;
+            break;
+        case jbvNumeric:
+            padBufferToInt(buffer);
+            appendToBuffer(buffer, scalarVal->val.numeric, VARSIZE_ANY(scalarVal->val.numeric));
+            *header = JENTRY_ISNUMERIC;
+            break;
+        case jbvBool:
+            *header = scalarVal->val.boolean ? JENTRY_ISTRUE : JENTRY_ISFALSE;
+            break;
+        default:
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION), errmsg("invalid jsonb scalar type")));
+    }
+}
+
+/*
+ * Sort the pairs of an object by key, and keep only the last of the pairs
+ * with the same key.
+ */
+static void uniqueifyJsonbObject(JsonbValue* object)
+{
+    JsonbPair* pairs = object->val.object.pairs;
+    int nPairs = object->val.object.nPairs;
+    int res = 0;
+    int i;
+
+    if (nPairs <= 1)
+        return;
+
+    qsort(pairs, nPairs, sizeof(JsonbPair), lengthCompareJsonbPair);
+
+    for (i = 1; i < nPairs; i++) {
+        if (lengthCompareJsonbString(pairs[i].key.val.string.val, pairs[i].key.val.string.len,
+                pairs[res].key.val.string.val, pairs[res].key.val.string.len) != 0)
+            res++;
+        /* of equal keys the later one sorts last and replaces the kept one */
+        if (res != i)
+            pairs[res] = pairs[i];
+    }
+    object->val.object.nPairs = res + 1;
+}
+
+/*
+ * Keys are ordered by length first, it is cheaper than by collation and a
+ * lookup only needs some total order.
+ */
+static int lengthCompareJsonbString(const char* val1, int len1, const char* val2, int len2)
+{
+    if (len1 == len2)
+        return memcmp(val1, val2, len1);
+    return (len1 > len2) ? 1 : -1;
+}
+
+static int lengthCompareJsonbPair(const void* a, const void* b)
+{
+    const JsonbPair* pa = (const JsonbPair*)a;
+    const JsonbPair* pb = (const JsonbPair*)b;
+    int res;
+
+    res = lengthCompareJsonbString(
+        pa->key.val.string.val, pa->key.val.string.len, pb->key.val.string.val, pb->key.val.string.len);
+    if (res != 0)
+        return res;
+
+    return (pa->order > pb->order) ? 1 : -1;
+}
+
+/*
+ * Get the index-th child of a container, the keys of an object come before
+ * its values. Strings, numerics and containers point into the container.
+ */
+void getJsonbChildValue(JsonbContainer* container, int index, JsonbValue* result)
+{
+    JEntry entry = container->children[index];
+    char* base = JsonContainerData(container);
+    uint32 start = JBE_START(container->children, index);
+    uint32 end = JBE_END(entry);
+
+    switch (JBE_TYPE(entry)) {
+        case JENTRY_ISSTRING:
+            result->type = jbvString;
+            result->val.string.val = base + start;
+            result->val.string.len = end - start;
+            break;
+        case JENTRY_ISNUMERIC:
+            result->type = jbvNumeric;
+            result->val.numeric = (Numeric)(base + INTALIGN(start));
+            break;
+        case JENTRY_ISTRUE:
+            result->type = jbvBool;
+            result->val.boolean = true;
+            break;
+        case JENTRY_ISFALSE:
+            result->type = jbvBool;
+            result->val.boolean = false;
+            break;
+        case JENTRY_ISNULL:
+            result->type = jbvNull;
+            break;
+        case JENTRY_ISCONTAINER:
+            result->type = jbvBinary;
+            result->val.binary.data = (JsonbContainer*)(base + INTALIGN(start));
+            result->val.binary.len = end - INTALIGN(start);
+            break;
+        default:
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION), errmsg("invalid jsonb entry type")));
+    }
+}
+
+/*
+ * Look up a key of an object by binary search. Returns false if the key is
+ * missing; otherwise the value goes to *result, if that is not NULL.
+ */
+bool findJsonbObjectKey(JsonbContainer* container, const char* key, int keylen, JsonbValue* result)
+{
+    char* base = JsonContainerData(container);
+    uint32 count = JsonContainerSize(container);
+    uint32 low = 0;
+    uint32 high = count;
+
+    if (!JsonContainerIsObject(container))
+        return false;
+
+    while (low < high) {
+        uint32 mid = low + (high - low) / 2;
+        uint32 start = JBE_START(container->children, mid);
+        int difference = lengthCompareJsonbString(
+            base + start, JBE_END(container->children[mid]) - start, key, keylen);
+
+        if (difference == 0) {
+            if (result != NULL)
+                getJsonbChildValue(container, mid + count, result);
+            return true;
+        } else if (difference < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Is there a string element equal to str in an array?
+ */
+bool findJsonbArrayString(JsonbContainer* container, const char* str, int len)
+{
+    char* base = JsonContainerData(container);
+    uint32 count = JsonContainerSize(container);
+    uint32 i;
+
+    if (!JsonContainerIsArray(container))
+        return false;
+
+    for (i = 0; i < count; i++) {
+        JEntry entry = container->children[i];
+        uint32 start = JBE_START(container->children, i);
+
+        if (JBE_TYPE(entry) == JENTRY_ISSTRING && (int)(JBE_END(entry) - start) == len &&
+            memcmp(base + start, str, len) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+bool equalsJsonbScalarValue(const JsonbValue* a, const JsonbValue* b)
+{
+    if (a->type != b->type)
+        return false;
+
+    switch (a->type) {
+        case jbvNull:
+            return true;
+        case jbvString:
+            return a->val.string.len == b->val.string.len &&
+                   memcmp(a->val.string.val, b->val.string.val, a->val.string.len) == 0;
+        case jbvNumeric:
+            return DatumGetInt32(DirectFunctionCall2(
+                       numeric_cmp, NumericGetDatum(a->val.numeric), NumericGetDatum(b->val.numeric))) == 0;
+        case jbvBool:
+            return a->val.boolean == b->val.boolean;
+        default:
+            ereport(ERROR, (errcode(ERRCODE_DATA_EXCEPTION), errmsg("invalid jsonb scalar type")));
+    }
+
+    return false;
+}
+
+/*
+ * Does the val container contain the query container, in the sense of the @>
+ * operator?
+ *
+ * Each pair of a query object must be in the val object, with a value that
+ * contains the query's. Each element of a query array must be contained in
+ * some element of the val array. A scalar is only contained in an equal
+ * scalar, and a document of a single scalar only contains such a document,
+ * but is contained in an array.
+ */
+bool JsonbDeepContains(JsonbContainer* val, JsonbContainer* query)
+{
+    uint32 nquery = JsonContainerSize(query);
+    uint32 nval = JsonContainerSize(val);
+    uint32 i;
+    uint32 j;
+
+    check_stack_depth();
+
+    if (JsonContainerIsObject(val) != JsonContainerIsObject(query))
+        return false;
+
+    if (JsonContainerIsObject(query)) {
+        /* the keys of an object are unique, a larger query cannot be contained */
+        if (nquery > nval)
+            return false;
+
+        for (i = 0; i < nquery; i++) {
+            JsonbValue qkey;
+            JsonbValue qval;
+            JsonbValue vval;
+
+            getJsonbChildValue(query, i, &qkey);
+            if (!findJsonbObjectKey(val, qkey.val.string.val, qkey.val.string.len, &vval))
+                return false;
+
+            getJsonbChildValue(query, i + nquery, &qval);
+            if (!containsJsonbValue(&vval, &qval))
+                return false;
+        }
+
+        return true;
+    }
+
+    if (JsonContainerIsScalar(val) && !JsonContainerIsScalar(query))
+        return false;
+
+    for (i = 0; i < nquery; i++) {
+        JsonbValue qelem;
+        bool found = false;
+
+        getJsonbChildValue(query, i, &qelem);
+        for (j = 0; j < nval && !found; j++) {
+            JsonbValue velem;
+
+            getJsonbChildValue(val, j, &velem);
+            found = containsJsonbValue(&velem, &qelem);
+        }
+
+        if (!found)
+            return false;
+    }
+
+    return true;
+}
+
+static bool containsJsonbValue(JsonbValue* val, JsonbValue* query)
+{
+    if (query->type == jbvBinary)
+        return val->type == jbvBinary && JsonbDeepContains(val->val.binary.data, query->val.binary.data);
+
+    return equalsJsonbScalarValue(val, query);
+}
@@ -11101,7 +11101,7 @@ Datum pg_total_autovac_tuples(PG_FUNCTION_ARGS)
         MemoryContextSwitchTo(old_context);
         pfree_ext(buf.data);
     } else {
-        PgStat_StatDBEntry* db_entry = NULL;
+        HTAB* tables = NULL;
         NameData data_name;
 
         /*
@@ -11109,12 +11109,12 @@ Datum pg_total_autovac_tuples(PG_FUNCTION_ARGS)
          * This avoids any issue of the hashtable possibly changing between calls.
          */
         (void)namestrcpy(&data_name, g_instance.attr.attr_common.PGXCNodeName);
-        db_entry = pgstat_fetch_stat_dbentry(u_sess->proc_cxt.MyDatabaseId);
-        if ((db_entry != NULL) && (db_entry->tables != NULL)) {
+        tables = pgstat_fetch_stat_tabhash(u_sess->proc_cxt.MyDatabaseId);
+        if (tables != NULL) {
             HASH_SEQ_STATUS hash_seq;
             PgStat_StatTabEntry* tabentry = NULL;
 
-            hash_seq_init(&hash_seq, db_entry->tables);
+            hash_seq_init(&hash_seq, tables);
             while ((tabentry = (PgStat_StatTabEntry*)hash_seq_search(&hash_seq)) != NULL) {
                 Oid rel_id = tabentry->tablekey.tableid;
                 Oid part_id = InvalidOid;
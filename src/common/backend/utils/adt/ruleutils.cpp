@@ -2212,6 +2212,7 @@ static char* pg_get_indexdef_worker(
     List* context = NIL;
     Oid indrelid;
     int keyno;
+    int nkeyatts;
     Datum indcoll_datum;
     Datum indclass_datum;
     Datum indoption_datum;
@@ -2314,12 +2315,24 @@ static char* pg_get_indexdef_worker(
      * Report the indexed attributes
      */
     sep = "";
+    nkeyatts = GetIndexKeyAttsByTuple(NULL, ht_idx);
     for (keyno = 0; keyno < idxrec->indnatts; keyno++) {
         AttrNumber attnum = idxrec->indkey.values[keyno];
-        int16 opt = indoption->values[keyno];
+        int16 opt = (keyno < nkeyatts) ? indoption->values[keyno] : 0;
         Oid keycoltype;
         Oid keycolcollation;
 
+        /* the columns are the key of the index when only the attributes are asked for */
+        if (attrs_only && keyno >= nkeyatts) {
+            break;
+        }
+
+        /* the included columns follow the key columns */
+        if (!colno && keyno == nkeyatts) {
+            appendStringInfoString(&buf, ") INCLUDE (");
+            sep = "";
+        }
+
         if (!colno) {
             appendStringInfoString(&buf, sep);
         }
@@ -2358,6 +2371,11 @@ static char* pg_get_indexdef_worker(
             keycolcollation = exprCollation(indexkey);
         }
 
+        /* the included columns have no collation, opclass nor options */
+        if (keyno >= nkeyatts) {
+            continue;
+        }
+
         if (!attrs_only && (!colno || colno == keyno + 1)) {
             Oid indcoll;
 
@@ -4733,7 +4733,7 @@ void examine_variable(PlannerInfo* root, Node* node, int var_relid, VariableStat
                          * Found a match ... is it a unique index? Tests here
                          * should match has_unique_index().
                          */
-                        if (index->unique && index->ncolumns == 1 && (index->indpred == NIL || index->predOK))
+                        if (index->unique && index->nkeycolumns == 1 && (index->indpred == NIL || index->predOK))
                             var_data->isunique = true;
 
                         /*
@@ -6449,9 +6449,14 @@ static List* add_predicate_to_quals(IndexOptInfo* index, List* index_quals)
  * in generic_cost_estimate is the estimate of the number of index tuples
  * visited.  If numIndexTuples is not 0 then it is used as the estimate,
  * otherwise we compute a generic estimate.
+ *
+ * num_skips is the number of distinct leading-column values a btree skip
+ * scan repositions to; each of them costs an index scan of its own, just
+ * like an element of a ScalarArrayOpExpr qual.
  */
 static void generic_cost_estimate(PlannerInfo* root, IndexPath* path, double loop_count, double num_index_tuples,
-    Cost* index_startup_cost, Cost* index_total_cost, Selectivity* index_selectivity, double* index_correlation)
+    Cost* index_startup_cost, Cost* index_total_cost, Selectivity* index_selectivity, double* index_correlation,
+    double num_skips = 1.0)
 {
     IndexOptInfo* index = path->indexinfo;
     List* index_quals = path->indexquals;
@@ -6494,6 +6499,7 @@ static void generic_cost_estimate(PlannerInfo* root, IndexPath* path, double loo
             }
         }
     }
+    num_sa_scans *= num_skips;
 
     saved_varratios = index->rel->varratio;
     index->rel->varratio = NULL;
@@ -6661,6 +6667,51 @@ static void generic_cost_estimate(PlannerInfo* root, IndexPath* path, double loo
     *index_correlation = 0.0;
 }
 
+/*
+ * Estimate the number of index tuples a btree scan visits, given the quals
+ * that bound it.
+ */
+static double btree_bound_tuples(PlannerInfo* root, IndexOptInfo* index, List* index_bound_quals)
+{
+    List* selectivity_quals = NIL;
+    Selectivity btree_selectivity;
+    List* saved_varratios = NIL;
+
+    /*
+     * If the index is partial, AND the index predicate with the
+     * index-bound quals to produce a more accurate idea of the number of
+     * rows covered by the bound conditions.
+     */
+    selectivity_quals = add_predicate_to_quals(index, index_bound_quals);
+
+    saved_varratios = index->rel->varratio;
+    index->rel->varratio = NULL;
+    btree_selectivity = clauselist_selectivity(root, selectivity_quals, index->rel->relid, JOIN_INNER, NULL, false);
+    list_free_deep(index->rel->varratio);
+    index->rel->varratio = saved_varratios;
+
+    return btree_selectivity * RELOPTINFO_LOCAL_FIELD(root, index->rel, tuples);
+}
+
+/*
+ * Estimate the number of distinct values of the leading column of a btree
+ * index, which is the number of times a skip scan repositions.  Returns 0 if
+ * pg_statistic has nothing to go by.
+ */
+static double btree_leading_numdistinct(PlannerInfo* root, IndexOptInfo* index)
+{
+    TargetEntry* tle = (TargetEntry*)linitial(index->indextlist);
+    VariableStatData var_data;
+    bool is_default = false;
+    double num_distinct;
+
+    examine_variable(root, (Node*)tle->expr, 0, &var_data);
+    num_distinct = get_variable_numdistinct(&var_data, &is_default, false);
+    ReleaseVariableStats(var_data);
+
+    return is_default ? 0.0 : num_distinct;
+}
+
 Datum btcostestimate(PG_FUNCTION_ARGS)
 {
     PlannerInfo* root = (PlannerInfo*)PG_GETARG_POINTER(0);
@@ -6680,6 +6731,7 @@ Datum btcostestimate(PG_FUNCTION_ARGS)
     bool eq_qual_here = false;
     bool found_saop = false;
     bool found_is_null_op = false;
+    bool skip_scan = false;
     double num_sa_scans;
     ListCell* lcc = NULL;
     ListCell* lci = NULL;
@@ -6700,10 +6752,17 @@ Datum btcostestimate(PG_FUNCTION_ARGS)
      * If there's a ScalarArrayOpExpr in the quals, we'll actually perform N
      * index scans not one, but the ScalarArrayOpExpr's operator can be
      * considered to act the same as it normally does.
+     *
+     * If there are no quals for the leading column but some for the second
+     * one, a skip scan can use them as boundary quals too: it treats the
+     * leading column as having an '=' qual on each of its distinct values in
+     * turn.  Whether that beats a full index scan is decided below.
      */
     index_bound_quals = NIL;
-    index_col = 0;
     eq_qual_here = false;
+    skip_scan = u_sess->attr.attr_sql.enable_indexskipscan && index->nkeycolumns > 1 &&
+        path->indexqualcols != NIL && linitial_int(path->indexqualcols) == 1;
+    index_col = skip_scan ? 1 : 0;
     found_saop = false;
     found_is_null_op = false;
     num_sa_scans = 1;
@@ -6805,26 +6864,11 @@ Datum btcostestimate(PG_FUNCTION_ARGS)
      * clauselist_selectivity calculations.  However, a ScalarArrayOp or
      * NullTest invalidates that theory, even though it sets eq_qual_here.
      */
-    if (index->unique && index_col == index->ncolumns - 1 && eq_qual_here && !found_saop && !found_is_null_op)
+    if (index->unique && index_col == index->nkeycolumns - 1 && eq_qual_here && !found_saop && !found_is_null_op &&
+        !skip_scan)
         num_index_tuples = 1.0;
     else {
-        List* selectivity_quals = NIL;
-        Selectivity btree_selectivity;
-        List* saved_varratios = NIL;
-
-        /*
-         * If the index is partial, AND the index predicate with the
-         * index-bound quals to produce a more accurate idea of the number of
-         * rows covered by the bound conditions.
-         */
-        selectivity_quals = add_predicate_to_quals(index, index_bound_quals);
-
-        saved_varratios = index->rel->varratio;
-        index->rel->varratio = NULL;
-        btree_selectivity = clauselist_selectivity(root, selectivity_quals, index->rel->relid, JOIN_INNER, NULL, false);
-        list_free_deep(index->rel->varratio);
-        index->rel->varratio = saved_varratios;
-        num_index_tuples = btree_selectivity * RELOPTINFO_LOCAL_FIELD(root, index->rel, tuples);
+        num_index_tuples = btree_bound_tuples(root, index, index_bound_quals);
 
         /*
          * As in generic_cost_estimate(), we have to adjust for any
@@ -6834,8 +6878,35 @@ Datum btcostestimate(PG_FUNCTION_ARGS)
         num_index_tuples = rint(num_index_tuples / num_sa_scans);
     }
 
-    generic_cost_estimate(root, path, loop_count, num_index_tuples, index_startup_cost,
-        index_total_cost, index_selectivity, index_correlation);
+    if (skip_scan) {
+        double num_skips = btree_leading_numdistinct(root, index);
+        Cost skip_startup_cost;
+        Cost skip_total_cost;
+        Selectivity skip_selectivity;
+        double skip_correlation;
+
+        /* A plain scan has no boundary quals, so it reads the whole index */
+        generic_cost_estimate(root, path, loop_count, rint(btree_bound_tuples(root, index, NIL)), index_startup_cost,
+            index_total_cost, index_selectivity, index_correlation);
+
+        /*
+         * The skip scan does one scan per distinct leading value, and the
+         * boundary quals spread over all of them.  Without statistics we
+         * can't tell how many there are, so stay with the plain scan.
+         */
+        if (num_skips > 0) {
+            generic_cost_estimate(root, path, loop_count, Max(rint(num_index_tuples / num_skips), 1.0),
+                &skip_startup_cost, &skip_total_cost, &skip_selectivity, &skip_correlation, num_skips);
+            if (skip_total_cost < *index_total_cost) {
+                *index_startup_cost = skip_startup_cost;
+                *index_total_cost = skip_total_cost;
+                path->indexskipscan = true;
+            }
+        }
+    } else {
+        generic_cost_estimate(root, path, loop_count, num_index_tuples, index_startup_cost,
+            index_total_cost, index_selectivity, index_correlation);
+    }
 
     /*
      * If we can get an estimate of the first column's ordering correlation C
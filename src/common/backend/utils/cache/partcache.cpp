@@ -1193,6 +1193,7 @@ Relation partitionGetRelation(Relation rel, Partition part)
 
     relation->rd_amcache = rel->rd_amcache;
     relation->rd_indcollation = rel->rd_indcollation;
+    relation->rd_indnkeyatts = rel->rd_indnkeyatts;
     relation->rd_id = part->pd_id;
     relation->rd_indexlist = part->pd_indexlist;
     relation->rd_oidindex = part->pd_oidindex;
@@ -1992,6 +1992,7 @@ void RelationInitIndexAccessInfo(Relation relation)
     MemoryContext indexcxt;
     MemoryContext oldcontext;
     int natts;
+    int nkeyatts;
     uint16 amsupport;
     errno_t rc;
 
@@ -2030,6 +2031,12 @@ void RelationInitIndexAccessInfo(Relation relation)
         ereport(ERROR,
             (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
                 errmsg("relnatts disagrees with indnatts for index %u", RelationGetRelid(relation))));
+    nkeyatts = GetIndexKeyAttsByTuple(NULL, relation->rd_indextuple);
+    if (nkeyatts < 1 || nkeyatts > natts)
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("invalid indnkeyatts %d for index %u", nkeyatts, RelationGetRelid(relation))));
+    relation->rd_indnkeyatts = nkeyatts;
     amsupport = aform->amsupport;
 
     /*
@@ -2048,7 +2055,9 @@ void RelationInitIndexAccessInfo(Relation relation)
     relation->rd_indexcxt = indexcxt;
 
     /*
-     * Allocate arrays to hold data
+     * Allocate arrays to hold data. The arrays cover all the columns, but
+     * only the key columns have an opclass, a collation and options; the
+     * entries of the included columns stay zero.
      */
     relation->rd_aminfo = (RelationAmInfo*)MemoryContextAllocZero(indexcxt, sizeof(RelationAmInfo));
 
@@ -2077,7 +2086,7 @@ void RelationInitIndexAccessInfo(Relation relation)
     indcoll_datum = fastgetattr(relation->rd_indextuple, Anum_pg_index_indcollation, get_pg_index_descriptor(), &isnull);
     Assert(!isnull);
     indcoll = (oidvector*)DatumGetPointer(indcoll_datum);
-    rc = memcpy_s(relation->rd_indcollation, natts * sizeof(Oid), indcoll->values, natts * sizeof(Oid));
+    rc = memcpy_s(relation->rd_indcollation, natts * sizeof(Oid), indcoll->values, nkeyatts * sizeof(Oid));
     securec_check(rc, "\0", "\0");
 
     /*
@@ -2095,7 +2104,7 @@ void RelationInitIndexAccessInfo(Relation relation)
      * as zeroes, and are filled on-the-fly when used)
      */
     index_support_initialize(
-        indclass, relation->rd_support, relation->rd_opfamily, relation->rd_opcintype, amsupport, natts);
+        indclass, relation->rd_support, relation->rd_opfamily, relation->rd_opcintype, amsupport, nkeyatts);
 
     /*
      * Similarly extract indoption and copy it to the cache entry
@@ -2103,7 +2112,7 @@ void RelationInitIndexAccessInfo(Relation relation)
     indoption_datum = fastgetattr(relation->rd_indextuple, Anum_pg_index_indoption, get_pg_index_descriptor(), &isnull);
     Assert(!isnull);
     indoption = (int2vector*)DatumGetPointer(indoption_datum);
-    rc = memcpy_s(relation->rd_indoption, natts * sizeof(int16), indoption->values, natts * sizeof(int16));
+    rc = memcpy_s(relation->rd_indoption, natts * sizeof(int16), indoption->values, nkeyatts * sizeof(int16));
     securec_check(rc, "\0", "\0");
 
     /*
@@ -2117,6 +2126,27 @@ void RelationInitIndexAccessInfo(Relation relation)
     relation->rd_amcache = NULL;
 }
 
+/*
+ * GetIndexKeyAttsByTuple
+ *		Get the number of key columns of an index from its pg_index tuple.
+ *
+ * indnkeyatts is NULL for the indexes created before it was added to pg_index
+ * and for the ones without included columns; all their columns are keys then.
+ * pgindex is the open pg_index relation if the caller has it, else NULL.
+ */
+int GetIndexKeyAttsByTuple(Relation pgindex, HeapTuple indexTuple)
+{
+    TupleDesc tupleDesc = (pgindex != NULL) ? RelationGetDescr(pgindex) : get_pg_index_descriptor();
+    bool isnull = false;
+    Datum datum;
+
+    datum = heap_getattr(indexTuple, Anum_pg_index_indnkeyatts, tupleDesc, &isnull);
+    if (isnull)
+        return ((Form_pg_index)GETSTRUCT(indexTuple))->indnatts;
+
+    return DatumGetInt16(datum);
+}
+
 /*
  * index_support_initialize
  *		Initializes an index's cached opclass information,
@@ -5288,7 +5318,8 @@ Bitmapset* RelationGetIndexAttrBitmap(Relation relation, IndexAttrBitmapKind att
 
             if (attrnum != 0) {
                 indexattrs = bms_add_member(indexattrs, attrnum - FirstLowInvalidHeapAttributeNumber);
-                if (isIDKey)
+                /* only the key columns identify a row */
+                if (isIDKey && i < indexInfo->ii_NumIndexKeyAttrs)
                     idindexattrs = bms_add_member(idindexattrs, attrnum - FirstLowInvalidHeapAttributeNumber);
             }
         }
@@ -1081,7 +1081,8 @@ long hash_get_num_entries(HTAB* hashp)
  * there's no possibility of further insertions after readout has begun.
  *
  * NOTE: to use this with a partitioned hashtable, caller had better hold
- * at least shared lock on all partitions of the table throughout the scan!
+ * at least shared lock on all partitions of the table throughout the scan,
+ * or scan one partition at a time with hash_seq_init_partition!
  * We can cope with insertions or deletions by our own backend, but *not*
  * with concurrent insertions or deletions by another.
  */
@@ -1090,11 +1091,33 @@ void hash_seq_init(HASH_SEQ_STATUS* status, HTAB* hashp)
     status->hashp = hashp;
     status->curBucket = 0;
     status->curEntry = NULL;
+    status->bucketStep = 1;
     if (!hashp->frozen) {
         register_seq_scan(hashp);
     }
 }
 
+/*
+ * hash_seq_init_partition
+ *			Like hash_seq_init, but the scan returns only the entries of one
+ *			partition of a partitioned hashtable.
+ *
+ * A partitioned table never splits buckets, and its bucket count is a
+ * multiple of num_partitions, so a key's bucket number and its hash value
+ * give the same partition number.  The scan visits only the buckets of the
+ * given partition, and it is enough for the caller to hold the lock of that
+ * partition throughout the scan.
+ */
+void hash_seq_init_partition(HASH_SEQ_STATUS* status, HTAB* hashp, uint32 partition)
+{
+    Assert(IS_PARTITIONED(hashp->hctl));
+    Assert(partition < (uint32)hashp->hctl->num_partitions);
+
+    hash_seq_init(status, hashp);
+    status->curBucket = partition;
+    status->bucketStep = (uint32)hashp->hctl->num_partitions;
+}
+
 void* hash_seq_search(HASH_SEQ_STATUS* status)
 {
     HTAB* hashp = NULL;
@@ -1111,7 +1134,7 @@ void* hash_seq_search(HASH_SEQ_STATUS* status)
         /* Continuing scan of curBucket... */
         status->curEntry = curElem->link;
         if (status->curEntry == NULL) { /* end of this bucket */
-            ++status->curBucket;
+            status->curBucket += status->bucketStep;
         }
         return (void*)ELEMENTKEY(curElem);
     }
@@ -1146,14 +1169,16 @@ void* hash_seq_search(HASH_SEQ_STATUS* status)
      */
     while ((curElem = segp[segment_ndx]) == NULL) {
         /* empty bucket, advance to next */
-        if (++curBucket > max_bucket) {
+        curBucket += status->bucketStep;
+        if (curBucket > max_bucket) {
             status->curBucket = curBucket;
             hash_seq_term(status);
             return NULL; /* search is done */
         }
-        if (++segment_ndx >= ssize) {
-            segment_num++;
-            segment_ndx = 0;
+        segment_ndx += status->bucketStep;
+        if (segment_ndx >= ssize) {
+            segment_num = curBucket >> hashp->sshift;
+            segment_ndx = MOD(curBucket, ssize);
             segp = hashp->dir[segment_num];
         }
     }
@@ -1161,7 +1186,7 @@ void* hash_seq_search(HASH_SEQ_STATUS* status)
     /* Begin scan of curBucket... */
     status->curEntry = curElem->link;
     if (status->curEntry == NULL) { /* end of this bucket */
-        ++curBucket;
+        curBucket += status->bucketStep;
     }
     status->curBucket = curBucket;
     return (void*)ELEMENTKEY(curElem);
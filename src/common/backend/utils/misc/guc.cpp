@@ -29,6 +29,7 @@
 
 #include "access/cbmparsexlog.h"
 #include "access/gin.h"
+#include "access/nbtree.h"
 #ifdef PGXC
 #include "access/gtm.h"
 #include "pgxc/pgxc.h"
@@ -102,6 +103,7 @@
 #include "postmaster/walwriter.h"
 #include "replication/dataqueue.h"
 #include "replication/datareceiver.h"
+#include "replication/parallel_decode.h"
 #include "replication/reorderbuffer.h"
 #include "replication/replicainternal.h"
 #include "replication/slot.h"
@@ -316,6 +318,7 @@ const char* sync_guc_variable_namelist[] = {"work_mem",
     "enable_constraint_optimization",
 #endif
     "enable_bloom_filter",
+    "enable_runtime_join_filter",
 #ifdef ENABLE_MULTIPLE_NODES
     "cstore_insert_mode",
 #endif
@@ -375,6 +378,7 @@ const char* sync_guc_variable_namelist[] = {"work_mem",
     "enable_sonic_optspill",
     "enable_sonic_hashjoin",
     "enable_sonic_hashagg",
+    "enable_sonic_windowagg",
 #ifdef ENABLE_MULTIPLE_NODES
     "enable_stream_recursive",
 #endif
@@ -459,6 +463,9 @@ static void assign_history_memory(int newval, void* extra);
 static bool check_history_memory_limit(int* newval, void** extra, GucSource source);
 static bool check_autovacuum_max_workers(int* newval, void** extra, GucSource source);
 static bool check_job_max_workers(int* newval, void** extra, GucSource source);
+#ifdef ENABLE_MULTIPLE_NODES
+static bool check_max_cached_tuplebufs(int* newval, void** extra, GucSource source);
+#endif
 static bool check_effective_io_concurrency(int* newval, void** extra, GucSource source);
 static void assign_effective_io_concurrency(int newval, void* extra);
 static void assign_pgstat_temp_directory(const char* newval, void* extra);
@@ -1285,6 +1292,34 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "enable_auto_parameterization",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Enable replacing the literals of simple queries by parameters to reuse cached plans."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.enable_auto_parameterization,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "enable_runtime_join_filter",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Enable runtime join filters pushed from hash joins into row scans."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.enable_runtime_join_filter,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "enable_codegen",
@@ -1382,6 +1417,20 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "enable_sonic_windowagg",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Enable Sonic windowagg."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.enable_sonic_windowagg,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
 #ifdef ENABLE_MULTIPLE_NODES
         {
             {
@@ -1454,6 +1503,20 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "enable_indexskipscan",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Enables the planner's use of btree skip scans over the leading index column."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.enable_indexskipscan,
+            true,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "enable_bitmapscan",
@@ -3163,6 +3226,20 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "enable_stream_compression",
+                PGC_SIGHUP,
+                REPLICATION_STANDBY,
+                gettext_noop("Asks the primary to compress the WAL and data streams sent to this standby."),
+                NULL
+            },
+            &u_sess->attr.attr_storage.enable_stream_compression,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "allow_system_table_mods",
@@ -4799,6 +4876,22 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "auto_param_max_statements",
+                PGC_USERSET,
+                QUERY_TUNING_OTHER,
+                gettext_noop("Sets the maximum number of statements kept for auto-parameterized queries."),
+                gettext_noop("The least recently used statement is deallocated beyond this number.")
+            },
+            &u_sess->attr.attr_sql.auto_param_max_statements,
+            256,
+            1,
+            65536,
+            NULL,
+            NULL,
+            NULL
+        },
 #ifdef ENABLE_MULTIPLE_NODES
         {
             {
@@ -5731,6 +5824,41 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "vacuum_dead_tuples_mem",
+                PGC_USERSET,
+                DEVELOPER_OPTIONS,
+                gettext_noop("Limits the memory for the dead tuples of a lazy vacuum below maintenance_work_mem."),
+                gettext_noop("Zero means maintenance_work_mem. A small value makes a vacuum "
+                             "pass over the indexes many times, for testing."),
+                GUC_UNIT_KB | GUC_NOT_IN_SAMPLE
+            },
+            &u_sess->attr.attr_memory.vacuum_dead_tuples_mem,
+            0,
+            0,
+            MAX_KILOBYTES,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "max_parallel_maintenance_workers",
+                PGC_USERSET,
+                RESOURCES_ASYNCHRONOUS,
+                gettext_noop("Sets the maximum number of parallel workers of a single btree index build "
+                             "or index vacuum."),
+                gettext_noop("Zero means indexes are always built and vacuumed by the backend alone.")
+            },
+            &u_sess->attr.attr_storage.max_parallel_maintenance_workers,
+            0,
+            0,
+            MAX_PARALLEL_BTBUILD_WORKERS,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "bulk_write_ring_size",
@@ -6487,6 +6615,40 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "logical_decoding_work_mem",
+                PGC_USERSET,
+                REPLICATION_SENDING,
+                gettext_noop("Sets the maximum memory to be used for logical decoding."),
+                gettext_noop("This much memory can be used by each internal reorder buffer before "
+                             "streaming the largest transaction to the output plugin or spilling it to disk."),
+                GUC_UNIT_KB
+            },
+            &u_sess->attr.attr_storage.logical_decoding_work_mem,
+            64 * 1024,
+            64,
+            INT_MAX,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "logical_decoding_parallel_workers",
+                PGC_USERSET,
+                REPLICATION_SENDING,
+                gettext_noop("Sets the number of parallel decoding workers of each logical walsender."),
+                gettext_noop("Zero means the walsender decodes all transactions by itself.")
+            },
+            &u_sess->attr.attr_storage.logical_decoding_parallel_workers,
+            0,
+            0,
+            MAX_PARALLEL_DECODE_WORKERS,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "replication_type",
@@ -7259,6 +7421,41 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "track_stat_tables",
+                PGC_POSTMASTER,
+                STATS_COLLECTOR,
+                gettext_noop("Sets the expected number of tables and partitions with statistics."),
+                gettext_noop("The shared table statistics are sized for this many entries, more "
+                             "entries are kept but take longer to find.")
+            },
+            &g_instance.attr.attr_common.pgstat_track_tables,
+            4096,
+            128,
+            16777216,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "thread_pool_steal_threshold",
+                PGC_POSTMASTER,
+                CLIENT_CONN,
+                gettext_noop("Sets the number of waiting sessions above which idle thread pool "
+                             "groups run sessions of the nearest NUMA node."),
+                gettext_noop("The threshold grows with the NUMA distance to the busy group. "
+                             "Zero disables running sessions of other groups.")
+            },
+            &g_instance.attr.attr_common.thread_pool_steal_threshold,
+            2,
+            0,
+            10000,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "password_reuse_max",
@@ -8821,21 +9018,19 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
-#endif
-#ifdef ENABLE_MULTIPLE_NODES
         {
             {
                 "max_cached_tuplebufs",
                 PGC_POSTMASTER,
                 UNGROUPED,
-                gettext_noop("how many memory reorderbuffer can use."),
+                gettext_noop("Deprecated, has no effect: the tuples of the reorder buffer are no longer cached."),
                 NULL
             },
             &g_instance.attr.attr_common.max_cached_tuplebufs,
             8192,
             1,
             INT_MAX,
-            NULL,
+            check_max_cached_tuplebufs,
             NULL,
             NULL
         },
@@ -12200,8 +12395,8 @@ static void init_single_node_unsupport_guc()
         g_instance.attr.attr_common.lastval_supported = false;
         g_instance.attr.attr_storage.max_replication_slots = 8;
         g_instance.attr.attr_sql.max_resource_package = 0;
-        g_instance.attr.attr_common.max_cached_tuplebufs = 8192;
         g_instance.attr.attr_common.max_changes_in_memory = 4096;
+        g_instance.attr.attr_common.max_cached_tuplebufs = 8192;
     }
 
     return;
@@ -18403,6 +18598,22 @@ static bool check_autovacuum_max_workers(int* newval, void** extra, GucSource so
     return true;
 }
 
+#ifdef ENABLE_MULTIPLE_NODES
+/*
+ * max_cached_tuplebufs is only kept so that configuration files setting it
+ * still load; warn whoever sets it that it does nothing.
+ */
+static bool check_max_cached_tuplebufs(int* newval, void** extra, GucSource source)
+{
+    if (source != PGC_S_DEFAULT) {
+        ereport(WARNING,
+            (errcode(ERRCODE_WARNING_DEPRECATED_FEATURE),
+                errmsg("parameter \"max_cached_tuplebufs\" is deprecated and has no effect")));
+    }
+    return true;
+}
+#endif
+
 /*
  * Description: Check wheth out of max backends after max job worker threads.
  *
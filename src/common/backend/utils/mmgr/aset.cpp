@@ -315,6 +315,195 @@ static void randomize_mem(char* ptr, size_t size)
 }
 #endif /* RANDOMIZE_ALLOCATED_MEMORY */
 
+/* --------------------
+ * Thread caches of shared contexts
+ *
+ * A shared context takes its lock in every palloc and pfree.  To keep busy
+ * threads off that lock, a thread keeps the free chunks of the shared sets it
+ * used last in a slot of t_thrd.mem_cxt.shared_chunk_cache, one list per
+ * freelist: pfree pushes the chunk on the list, palloc pops it.  The lock is
+ * only taken to refill an empty list from the set's freelist, in a batch, or
+ * to give back half of a full one.
+ *
+ * A cached chunk is still allocated as far as the set is concerned, so its
+ * freeSpace is exact once the caches are flushed.  Blocks are only malloc'd
+ * and freed under the lock, so totalSpace and the shared memory accounting of
+ * memprot are always exact.
+ *
+ * A slot is only valid while its set has the cacheId it had when the slot was
+ * filled; a reset or delete gives the set a new one, and a stale slot is just
+ * forgotten since its chunks went with the blocks.  A slot is only given back
+ * to another set than the one in hand (on eviction or at thread exit) after
+ * finding the set alive in the registry of shared sets.
+ *
+ * The magic data and sentinels of MEMORY_CONTEXT_CHECKING builds are set up
+ * under the lock, so the caches are left out of those builds.
+ * --------------------
+ */
+#if !defined(ENABLE_MEMORY_CHECK) && !defined(MEMORY_CONTEXT_CHECKING)
+#define USE_SHARED_CHUNK_CACHE
+
+#define SHARED_CHUNK_CACHE_BYTES 4096 /* bytes a thread caches of one size class */
+#define SHARED_CHUNK_CACHE_MAX 32     /* and chunks at most */
+#define SHARED_SET_REGISTRY_SIZE 1024
+
+#define SharedChunkCacheSlotOf(set) \
+    (&t_thrd.mem_cxt.shared_chunk_cache[((uintptr_t)(set) >> 6) % SHARED_CHUNK_CACHE_SLOTS])
+#define SharedSetRegistryBucket(set) (((uintptr_t)(set) >> 6) % SHARED_SET_REGISTRY_SIZE)
+
+static pthread_mutex_t SharedSetRegistryLock = PTHREAD_MUTEX_INITIALIZER;
+static AllocSet SharedSetRegistry[SHARED_SET_REGISTRY_SIZE];
+static uint64 SharedSetNextId = 1;
+
+/* chunks a thread may cache of the given freelist */
+static inline int SharedChunkCacheLimit(int fidx)
+{
+    int limit = SHARED_CHUNK_CACHE_BYTES >> (fidx + ALLOC_MINBITS);
+
+    return Max(Min(limit, SHARED_CHUNK_CACHE_MAX), 2);
+}
+
+static void SharedSetRegister(AllocSet set)
+{
+    int bucket = SharedSetRegistryBucket(set);
+
+    /* knl_thread.h cannot see the freelists, it sizes the slots by hand */
+    StaticAssertStmt(SHARED_CHUNK_CACHE_CLASSES == ALLOCSET_NUM_FREELISTS,
+        "a thread cache slot needs one list per freelist of the set");
+
+    (void)pthread_mutex_lock(&SharedSetRegistryLock);
+    set->cacheId = SharedSetNextId++;
+    set->cacheNext = SharedSetRegistry[bucket];
+    SharedSetRegistry[bucket] = set;
+    (void)pthread_mutex_unlock(&SharedSetRegistryLock);
+}
+
+static void SharedSetUnregister(AllocSet set)
+{
+    AllocSet* link = &SharedSetRegistry[SharedSetRegistryBucket(set)];
+
+    (void)pthread_mutex_lock(&SharedSetRegistryLock);
+    while (*link != NULL && *link != set)
+        link = &(*link)->cacheNext;
+    if (*link != NULL)
+        *link = set->cacheNext;
+    set->cacheId = 0;
+    set->cacheNext = NULL;
+    (void)pthread_mutex_unlock(&SharedSetRegistryLock);
+}
+
+/* invalidate the cached chunks of a set being reset */
+static void SharedSetRenew(AllocSet set)
+{
+    (void)pthread_mutex_lock(&SharedSetRegistryLock);
+    if (set->cacheId != 0)
+        set->cacheId = SharedSetNextId++;
+    (void)pthread_mutex_unlock(&SharedSetRegistryLock);
+}
+
+/* move up to n chunks of a list of the slot to the set's freelist, under the set's lock */
+static void SharedChunkCacheRelease(SharedChunkCacheSlot* slot, AllocSet set, int fidx, int n)
+{
+    AllocChunk chunk;
+
+    while (n-- > 0 && (chunk = (AllocChunk)slot->chunks[fidx]) != NULL) {
+        slot->chunks[fidx] = chunk->aset;
+        slot->nchunks[fidx]--;
+
+        chunk->aset = (void*)set->freelist[fidx];
+        set->freelist[fidx] = chunk;
+        set->freeSpace += chunk->size + ALLOC_CHUNKHDRSZ;
+    }
+}
+
+/* take chunks of the set's freelist for a list of the slot, under the set's lock */
+static void SharedChunkCacheFill(SharedChunkCacheSlot* slot, AllocSet set, int fidx)
+{
+    int n = SharedChunkCacheLimit(fidx) / 2 - slot->nchunks[fidx];
+    AllocChunk chunk;
+
+    while (n-- > 0 && (chunk = set->freelist[fidx]) != NULL) {
+        set->freelist[fidx] = (AllocChunk)chunk->aset;
+        set->freeSpace -= chunk->size + ALLOC_CHUNKHDRSZ;
+
+        chunk->aset = slot->chunks[fidx];
+        slot->chunks[fidx] = chunk;
+        slot->nchunks[fidx]++;
+    }
+}
+
+/* give the chunks of the slot back to its set if the set is still alive, and free the slot */
+static void SharedChunkCacheEvict(SharedChunkCacheSlot* slot)
+{
+    int fidx;
+    int nchunks = 0;
+
+    for (fidx = 0; fidx < ALLOCSET_NUM_FREELISTS; fidx++)
+        nchunks += slot->nchunks[fidx];
+
+    if (nchunks > 0) {
+        AllocSet set = NULL;
+
+        (void)pthread_mutex_lock(&SharedSetRegistryLock);
+        set = SharedSetRegistry[SharedSetRegistryBucket(slot->set)];
+        while (set != NULL && set != slot->set)
+            set = set->cacheNext;
+        if (set != NULL && set->cacheId == slot->setId) {
+            MemoryContextLock(set);
+            for (fidx = 0; fidx < ALLOCSET_NUM_FREELISTS; fidx++)
+                SharedChunkCacheRelease(slot, set, fidx, slot->nchunks[fidx]);
+            MemoryContextUnlock(set);
+        }
+        (void)pthread_mutex_unlock(&SharedSetRegistryLock);
+    }
+
+    errno_t rc = memset_s(slot, sizeof(SharedChunkCacheSlot), 0, sizeof(SharedChunkCacheSlot));
+    securec_check(rc, "\0", "\0");
+}
+
+/* the slot of the calling thread for the set, NULL if the set is not to be cached */
+static inline SharedChunkCacheSlot* SharedChunkCacheGetSlot(AllocSet set)
+{
+    SharedChunkCacheSlot* slot = NULL;
+
+    if (set->cacheId == 0 || t_thrd.mem_cxt.shared_chunk_cache_closed)
+        return NULL;
+
+    slot = SharedChunkCacheSlotOf(set);
+    if (slot->set != set || slot->setId != set->cacheId) {
+        if (slot->set != set) {
+            SharedChunkCacheEvict(slot);
+        } else {
+            /* the set was reset or is a new one at the same address */
+            errno_t rc = memset_s(slot, sizeof(SharedChunkCacheSlot), 0, sizeof(SharedChunkCacheSlot));
+            securec_check(rc, "\0", "\0");
+        }
+        slot->set = set;
+        slot->setId = set->cacheId;
+    }
+
+    return slot;
+}
+#endif /* !ENABLE_MEMORY_CHECK && !MEMORY_CONTEXT_CHECKING */
+
+/*
+ * AllocSetCloseThreadCache
+ *		Give the chunks the calling thread caches back to their shared sets,
+ *		and stop caching them, at thread exit.
+ */
+void AllocSetCloseThreadCache(void)
+{
+#ifdef USE_SHARED_CHUNK_CACHE
+    int i;
+
+    t_thrd.mem_cxt.shared_chunk_cache_closed = true;
+    for (i = 0; i < SHARED_CHUNK_CACHE_SLOTS; i++) {
+        if (t_thrd.mem_cxt.shared_chunk_cache[i].set != NULL)
+            SharedChunkCacheEvict(&t_thrd.mem_cxt.shared_chunk_cache[i]);
+    }
+#endif
+}
+
 /* built-in white list of memory context. see more @ GenericMemoryAllocator::AllocSetContextCreate() */
 const char* built_in_white_list[] = {"ThreadTopMemoryContext",
     "Postmaster",
@@ -646,8 +835,12 @@ MemoryContext GenericMemoryAllocator::AllocSetContextCreate(MemoryContext parent
     }
 
     context->header.is_shared = isShared;
-    if (isShared)
+    if (isShared) {
         (void)pthread_rwlock_init(&(context->header.lock), NULL);
+#ifdef USE_SHARED_CHUNK_CACHE
+        SharedSetRegister(context);
+#endif
+    }
 
     return (MemoryContext)context;
 }
@@ -693,6 +886,10 @@ void GenericMemoryAllocator::AllocSetReset(MemoryContext context)
     AssertArg(AllocSetIsValid(set));
 
     if (is_shared) {
+#ifdef USE_SHARED_CHUNK_CACHE
+        /* the chunks the threads cache are freed with the blocks */
+        SharedSetRenew(set);
+#endif
         MemoryContextLock(context);
         func = &SharedFunctions;
     } else {
@@ -774,6 +971,11 @@ void GenericMemoryAllocator::AllocSetDelete(MemoryContext context)
     AllocBlock block = set->blocks;
     MemoryProtectFuncDef* func = NULL;
 
+#ifdef USE_SHARED_CHUNK_CACHE
+    if (is_shared)
+        SharedSetUnregister(set);
+#endif
+
     if (set->blocks == NULL) {
         return;
     }
@@ -839,6 +1041,9 @@ void* GenericMemoryAllocator::AllocSetAlloc(MemoryContext context, Size align, S
     Size chunk_size;
     Size blksize;
     MemoryProtectFuncDef* func = NULL;
+#ifdef USE_SHARED_CHUNK_CACHE
+    SharedChunkCacheSlot* slot = NULL;
+#endif
 
     AssertArg(AllocSetIsValid(set));
     AssertArg(align == 0);
@@ -854,6 +1059,24 @@ void* GenericMemoryAllocator::AllocSetAlloc(MemoryContext context, Size align, S
      * appropriate lock
      */
     if (is_shared) {
+#ifdef USE_SHARED_CHUNK_CACHE
+        /* a chunk of the thread's cache needs no lock */
+        if (size <= set->allocChunkLimit && (slot = SharedChunkCacheGetSlot(set)) != NULL) {
+            fidx = AllocSetFreeIndex(size);
+            chunk = (AllocChunk)slot->chunks[fidx];
+            if (chunk != NULL) {
+                slot->chunks[fidx] = chunk->aset;
+                slot->nchunks[fidx]--;
+                chunk->aset = (void*)set;
+#ifdef RANDOMIZE_ALLOCATED_MEMORY
+                /* fill the allocated space with junk */
+                randomize_mem((char*)AllocChunkGetPointer(chunk), size);
+#endif
+                AllocAllocInfo(set, chunk);
+                return AllocChunkGetPointer(chunk);
+            }
+        }
+#endif
         MemoryContextLock(context);
         func = &SharedFunctions;
     } else {
@@ -967,6 +1190,12 @@ void* GenericMemoryAllocator::AllocSetAlloc(MemoryContext context, Size align, S
 
         set->freeSpace -= (chunk->size + ALLOC_CHUNKHDRSZ);
 
+#ifdef USE_SHARED_CHUNK_CACHE
+        /* take a batch for the thread's cache while we hold the lock */
+        if (slot != NULL)
+            SharedChunkCacheFill(slot, set, fidx);
+#endif
+
 #ifdef MEMORY_CONTEXT_CHECKING
         chunk->requested_size = size;
         chunk->file = file;
@@ -1181,6 +1410,9 @@ void GenericMemoryAllocator::AllocSetFree(MemoryContext context, void* pointer)
     AllocChunk chunk = AllocPointerGetChunk(pointer);
     Size tempSize = 0;
     MemoryProtectFuncDef* func = NULL;
+#ifdef USE_SHARED_CHUNK_CACHE
+    SharedChunkCacheSlot* slot = NULL;
+#endif
 
     AssertArg(AllocSetIsValid(set));
 
@@ -1189,6 +1421,23 @@ void GenericMemoryAllocator::AllocSetFree(MemoryContext context, void* pointer)
      * appropriate lock
      */
     if (is_shared) {
+#ifdef USE_SHARED_CHUNK_CACHE
+        /* keep the chunk in the thread's cache, give half of a full list back */
+        if (chunk->size <= set->allocChunkLimit && (slot = SharedChunkCacheGetSlot(set)) != NULL) {
+            int fidx = AllocSetFreeIndex(chunk->size);
+
+            AllocFreeInfo(set, chunk);
+            if (slot->nchunks[fidx] >= SharedChunkCacheLimit(fidx)) {
+                MemoryContextLock(context);
+                SharedChunkCacheRelease(slot, set, fidx, slot->nchunks[fidx] / 2);
+                MemoryContextUnlock(context);
+            }
+            chunk->aset = slot->chunks[fidx];
+            slot->chunks[fidx] = chunk;
+            slot->nchunks[fidx]++;
+            return;
+        }
+#endif
         MemoryContextLock(context);
         func = &SharedFunctions;
     } else {
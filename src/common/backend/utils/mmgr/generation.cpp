@@ -0,0 +1,654 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * generation.cpp
+ *    Memory allocator for chunks freed in about the order of allocation.
+ *
+ * Chunks are carved out of the current block one after the other, with no
+ * rounding beyond MAXALIGN, and a freed chunk is never reused. Each block
+ * counts its chunks and the freed ones instead, and is given back once all
+ * of them are freed; one emptied block is kept to become the next current
+ * block. When the chunks live about as long as each other, as the tuples
+ * queued in a reorder buffer or the tuples of a sort, the blocks empty out
+ * in order and the memory held follows the data actually in use, which an
+ * AllocSet's freelists do not.
+ *
+ * Chunks larger than a fraction of the maximum block size get a block of
+ * their own, which is freed with the chunk.
+ *
+ * IDENTIFICATION
+ *    src/common/backend/utils/mmgr/generation.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <sys/mman.h>
+
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "utils/memutils.h"
+#include "utils/aset.h"
+#include "gs_register/gs_malloc.h"
+#include "utils/memprot.h"
+#include "utils/memtrack.h"
+
+/* chunks over 1/GENERATION_CHUNK_FRACTION of maxBlockSize get their own block */
+#define GENERATION_CHUNK_FRACTION 8
+
+typedef GenerationContext* GenerationSet;
+
+extern void MemoryContextControlSet(AllocSet context, const char* name);
+
+typedef struct GenerationBlockData {
+    GenerationSet set;    /* set that owns this block */
+    GenerationBlock prev; /* prev block in set's blocks list, if any */
+    GenerationBlock next; /* next block in set's blocks list */
+    Size blksize;         /* allocated size of this block */
+    int nchunks;          /* number of chunks in the block */
+    int nfree;            /* number of freed chunks */
+    char* freeptr;        /* start of free space in this block */
+    char* endptr;         /* end of space in this block */
+} GenerationBlockData;
+
+/*
+ * The standard header must be right in front of the chunk data, so that
+ * pfree() finds the context. The block is NULL once the chunk is freed.
+ */
+typedef struct GenerationChunkData {
+    GenerationBlock block; /* block owning this chunk */
+    StandardChunkHeader header;
+} GenerationChunkData;
+
+typedef GenerationChunkData* GenerationChunk;
+
+#define GENERATION_BLOCKHDRSZ MAXALIGN(sizeof(GenerationBlockData))
+#define GENERATION_CHUNKHDRSZ sizeof(GenerationChunkData)
+
+#define GenerationIsValid(set) PointerIsValid(set)
+#define GenerationPointerGetChunk(ptr) ((GenerationChunk)(((char*)(ptr)) - GENERATION_CHUNKHDRSZ))
+#define GenerationChunkGetPointer(chk) ((void*)(((char*)(chk)) + GENERATION_CHUNKHDRSZ))
+
+#ifdef MEMORY_CONTEXT_CHECKING
+#define CHECK_CONTEXT_OWNER(context) \
+    Assert((context->session_id == u_sess->session_id) || (context->thread_id == gs_thread_self()))
+#else
+#define CHECK_CONTEXT_OWNER(context) ((void)0)
+#endif
+
+static inline void GenerationBlockPush(GenerationSet set, GenerationBlock block)
+{
+    block->prev = NULL;
+    block->next = set->blocks;
+    if (set->blocks != NULL)
+        set->blocks->prev = block;
+    set->blocks = block;
+}
+
+static inline void GenerationBlockUnlink(GenerationSet set, GenerationBlock block)
+{
+    if (block->prev != NULL)
+        block->prev->next = block->next;
+    else
+        set->blocks = block->next;
+
+    if (block->next != NULL)
+        block->next->prev = block->prev;
+}
+
+static inline void GenerationBlockInit(GenerationSet set, GenerationBlock block)
+{
+    block->set = set;
+    block->nchunks = 0;
+    block->nfree = 0;
+    block->freeptr = ((char*)block) + GENERATION_BLOCKHDRSZ;
+    block->endptr = ((char*)block) + block->blksize;
+}
+
+/*
+ * GenerationContextCreate
+ *		Create a new generation context.
+ *
+ * parent: parent context, or NULL if top-level context
+ * name: name of context (for debugging --- string will be copied)
+ * initBlockSize: initial allocation block size
+ * maxBlockSize: maximum allocation block size
+ */
+MemoryContext GenerationContextCreate(MemoryContext parent, const char* name, Size initBlockSize, Size maxBlockSize)
+{
+#ifndef ENABLE_MEMORY_CHECK
+    return GenerationMemoryAllocator::GenerationContextCreate(parent, name, initBlockSize, maxBlockSize, false);
+#else
+    /* pfree() of this build only knows the chunks of AsanMemoryAllocator */
+    return AllocSetContextCreate(parent, name, ALLOCSET_DEFAULT_MINSIZE, initBlockSize, maxBlockSize);
+#endif
+}
+
+/*
+ * GenerationMethodDefinition
+ *      Define the method functions based on the templated value
+ */
+template <bool enable_memoryprotect, bool is_tracked>
+void GenerationMemoryAllocator::GenerationMethodDefinition(MemoryContextMethods* method)
+{
+    method->alloc = &GenerationMemoryAllocator::GenerationAlloc<enable_memoryprotect, is_tracked>;
+    method->free_p = &GenerationMemoryAllocator::GenerationFree<enable_memoryprotect, is_tracked>;
+    method->realloc = &GenerationMemoryAllocator::GenerationRealloc<enable_memoryprotect, is_tracked>;
+    method->init = &GenerationMemoryAllocator::GenerationInit;
+    method->reset = &GenerationMemoryAllocator::GenerationReset<enable_memoryprotect, is_tracked>;
+    method->delete_context = &GenerationMemoryAllocator::GenerationDelete<enable_memoryprotect, is_tracked>;
+    method->get_chunk_space = &GenerationMemoryAllocator::GenerationGetChunkSpace;
+    method->is_empty = &GenerationMemoryAllocator::GenerationIsEmpty;
+    method->stats = &GenerationMemoryAllocator::GenerationStats;
+#ifdef MEMORY_CONTEXT_CHECKING
+    method->check = &GenerationMemoryAllocator::GenerationCheck;
+#endif
+}
+
+/*
+ * GenerationContextSetMethods
+ *		set the method functions
+ */
+void GenerationMemoryAllocator::GenerationContextSetMethods(unsigned long value, MemoryContextMethods* method)
+{
+    bool isProt = (value & IS_PROTECT) ? true : false;
+    bool isTracked = (value & IS_TRACKED) ? true : false;
+
+    if (isProt) {
+        if (isTracked)
+            GenerationMethodDefinition<true, true>(method);
+        else
+            GenerationMethodDefinition<true, false>(method);
+    } else {
+        if (isTracked)
+            GenerationMethodDefinition<false, true>(method);
+        else
+            GenerationMethodDefinition<false, false>(method);
+    }
+}
+
+MemoryContext GenerationMemoryAllocator::GenerationContextCreate(
+    MemoryContext parent, const char* name, Size initBlockSize, Size maxBlockSize, bool isSession)
+{
+    GenerationSet set = NULL;
+    bool isTracked = false;
+    unsigned long value = t_thrd.utils_cxt.gs_mp_inited ? IS_PROTECT : 0;
+    MemoryProtectFuncDef* func = NULL;
+
+    if (!isSession && (parent == NULL || parent->session_id == 0))
+        func = &GenericFunctions;
+    else
+        func = &SessionFunctions;
+
+    /* only track the memory context after t_thrd.mem_cxt.mem_track_mem_cxt is created */
+    if (func == &GenericFunctions && parent && u_sess->attr.attr_memory.memory_tracking_mode &&
+        t_thrd.mem_cxt.mem_track_mem_cxt &&
+        (t_thrd.utils_cxt.ExecutorMemoryTrack == NULL || ((AllocSet)parent)->track)) {
+        isTracked = true;
+        value |= IS_TRACKED;
+    }
+
+    // Do the type-independent part of context creation
+    //
+    set = (GenerationSet)MemoryContextCreate(
+        T_GenerationContext, sizeof(GenerationContext), parent, name, __FILE__, __LINE__);
+
+    /* it holds data of its parent, check it against the same limit */
+    if (parent != NULL)
+        set->maxSpaceSize = ((AllocSet)parent)->maxSpaceSize;
+    else
+        set->maxSpaceSize = DEFAULT_MEMORY_CONTEXT_MAX_SIZE + SELF_GENRIC_MEMCTX_LIMITATION;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+    MemoryContextControlSet((AllocSet)set, name);
+#endif
+
+    /* assign the method function with specified templated to the context */
+    GenerationContextSetMethods(value, ((MemoryContext)set)->methods);
+
+    // Make sure alloc parameters are reasonable, and save them.
+    // We somewhat arbitrarily enforce a minimum 1K block size.
+    //
+    initBlockSize = MAXALIGN(initBlockSize);
+    if (initBlockSize < 1024)
+        initBlockSize = 1024;
+    maxBlockSize = MAXALIGN(maxBlockSize);
+    if (maxBlockSize < initBlockSize)
+        maxBlockSize = initBlockSize;
+
+    set->initBlockSize = initBlockSize;
+    set->maxBlockSize = maxBlockSize;
+    set->nextBlockSize = initBlockSize;
+    set->allocChunkLimit = MAXALIGN_DOWN(maxBlockSize / GENERATION_CHUNK_FRACTION);
+    set->block = NULL;
+    set->freeblock = NULL;
+
+    // create the memory tracking structure
+    if (isTracked)
+        MemoryTrackingCreate((MemoryContext)set, parent);
+
+    return (MemoryContext)set;
+}
+
+/*
+ * GenerationAlloc
+ *		Returns pointer to allocated memory of given size, carved out of
+ *		the current block.
+ */
+template <bool enable_memoryprotect, bool is_tracked>
+void* GenerationMemoryAllocator::GenerationAlloc(
+    MemoryContext context, Size align, Size size, const char* file, int line)
+{
+    GenerationSet set = (GenerationSet)context;
+    GenerationBlock block;
+    GenerationChunk chunk;
+    Size chunkSize = MAXALIGN(size);
+    Size requiredSize = chunkSize + GENERATION_CHUNKHDRSZ;
+    MemoryProtectFuncDef* func = NULL;
+
+    AssertArg(GenerationIsValid(set));
+    AssertArg(align == 0);
+    CHECK_CONTEXT_OWNER(context);
+
+    if (context->session_id > 0)
+        func = &SessionFunctions;
+    else
+        func = &GenericFunctions;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+    /* memory enjection */
+    if (gs_memory_enjection())
+        return NULL;
+#endif
+
+    if (chunkSize > set->allocChunkLimit) {
+        Size blksize = GENERATION_BLOCKHDRSZ + requiredSize;
+
+        if (enable_memoryprotect)
+            block = (GenerationBlock)(*func->malloc)(blksize);
+        else
+            gs_malloc(blksize, block, GenerationBlock);
+
+        if (block == NULL)
+            return NULL;
+
+        block->blksize = blksize;
+        GenerationBlockInit(set, block);
+        block->freeptr = block->endptr;
+        block->nchunks = 1;
+        GenerationBlockPush(set, block);
+
+        /* enlarge total space only. */
+        set->totalSpace += blksize;
+
+        /* update the memory tracking information when allocating memory */
+        if (is_tracked)
+            MemoryTrackingAllocInfo(context, blksize);
+
+        chunk = (GenerationChunk)(((char*)block) + GENERATION_BLOCKHDRSZ);
+    } else {
+        block = set->block;
+
+        if (block == NULL || (Size)(block->endptr - block->freeptr) < requiredSize) {
+            /* move on to the kept block if it is large enough, else to a new one */
+            block = set->freeblock;
+            if (block != NULL && block->blksize - GENERATION_BLOCKHDRSZ >= requiredSize) {
+                set->freeblock = NULL;
+            } else {
+                Size blksize = set->nextBlockSize;
+
+                set->nextBlockSize <<= 1;
+                if (set->nextBlockSize > set->maxBlockSize)
+                    set->nextBlockSize = set->maxBlockSize;
+
+                /* keep it a power of 2 if initBlockSize is too small for the chunk */
+                while (blksize < GENERATION_BLOCKHDRSZ + requiredSize)
+                    blksize <<= 1;
+
+                if (enable_memoryprotect)
+                    block = (GenerationBlock)(*func->malloc)(blksize);
+                else
+                    gs_malloc(blksize, block, GenerationBlock);
+
+                if (block == NULL)
+                    return NULL;
+
+                block->blksize = blksize;
+                set->totalSpace += blksize;
+                set->freeSpace += blksize - GENERATION_BLOCKHDRSZ;
+
+                /* update the memory tracking information when allocating memory */
+                if (is_tracked)
+                    MemoryTrackingAllocInfo(context, blksize);
+            }
+
+            GenerationBlockInit(set, block);
+            GenerationBlockPush(set, block);
+            set->block = block;
+        }
+
+        chunk = (GenerationChunk)block->freeptr;
+        block->freeptr += requiredSize;
+        block->nchunks++;
+        set->freeSpace -= requiredSize;
+    }
+
+    chunk->block = block;
+    chunk->header.context = context;
+    chunk->header.size = chunkSize;
+#ifdef MEMORY_CONTEXT_CHECKING
+    chunk->header.requested_size = size;
+    chunk->header.file = file;
+    chunk->header.line = line;
+    /* track the detail allocation information */
+    MemoryTrackingDetailInfo(context, size, chunkSize, file, line);
+#endif
+
+    return GenerationChunkGetPointer(chunk);
+}
+
+/*
+ * GenerationFree
+ *		Counts the chunk as freed in its block, and frees the block, or keeps
+ *		it for reuse, when all of its chunks are freed.
+ */
+template <bool enable_memoryprotect, bool is_tracked>
+void GenerationMemoryAllocator::GenerationFree(MemoryContext context, void* pointer)
+{
+    GenerationSet set = (GenerationSet)context;
+    GenerationChunk chunk = GenerationPointerGetChunk(pointer);
+    GenerationBlock block = chunk->block;
+    bool dedicated = false;
+    MemoryProtectFuncDef* func = NULL;
+
+    AssertArg(GenerationIsValid(set));
+    CHECK_CONTEXT_OWNER(context);
+
+    if (context->session_id > 0)
+        func = &SessionFunctions;
+    else
+        func = &GenericFunctions;
+
+    if (block == NULL || block->set != set || block->nfree >= block->nchunks) {
+        ereport(ERROR,
+            (errcode(ERRCODE_OPERATE_RESULT_NOT_EXPECTED),
+                errmsg("%s Memory Context could not find block containing chunk", context->name)));
+    }
+
+    chunk->block = NULL;
+#ifdef MEMORY_CONTEXT_CHECKING
+    chunk->header.requested_size = 0;
+#endif
+
+    dedicated = (chunk->header.size > set->allocChunkLimit);
+    if (!dedicated)
+        set->freeSpace += chunk->header.size + GENERATION_CHUNKHDRSZ;
+
+    block->nfree++;
+    if (block->nfree < block->nchunks)
+        return;
+
+    /* the current block is simply started over */
+    if (block == set->block) {
+        GenerationBlockInit(set, block);
+        return;
+    }
+
+    GenerationBlockUnlink(set, block);
+
+    if (!dedicated && set->freeblock == NULL) {
+        set->freeblock = block;
+        return;
+    }
+
+    set->totalSpace -= block->blksize;
+    if (!dedicated)
+        set->freeSpace -= block->blksize - GENERATION_BLOCKHDRSZ;
+
+    if (is_tracked)
+        MemoryTrackingFreeInfo(context, block->blksize);
+
+    block->set = NULL;
+    if (enable_memoryprotect)
+        (*func->free)(block, block->blksize);
+    else
+        gs_free(block, block->blksize);
+}
+
+/*
+ * GenerationRealloc
+ *		A chunk is never grown in place; a larger one is allocated and the
+ *		old one freed.
+ */
+template <bool enable_memoryprotect, bool is_tracked>
+void* GenerationMemoryAllocator::GenerationRealloc(
+    MemoryContext context, void* pointer, Size align, Size size, const char* file, int line)
+{
+    GenerationChunk chunk = GenerationPointerGetChunk(pointer);
+    Size oldsize = chunk->header.size;
+    void* newPointer = NULL;
+    errno_t rc;
+
+    AssertArg(align == 0);
+
+    if (size <= oldsize) {
+#ifdef MEMORY_CONTEXT_CHECKING
+        chunk->header.requested_size = size;
+#endif
+        return pointer;
+    }
+
+    newPointer = GenerationAlloc<enable_memoryprotect, is_tracked>(context, 0, size, file, line);
+    if (newPointer == NULL)
+        return NULL;
+
+    rc = memcpy_s(newPointer, size, pointer, oldsize);
+    securec_check(rc, "\0", "\0");
+
+    GenerationFree<enable_memoryprotect, is_tracked>(context, pointer);
+
+    return newPointer;
+}
+
+void GenerationMemoryAllocator::GenerationInit(MemoryContext context)
+{
+    /*
+     * we don't
+     * have to do anything here: it's already OK.
+     */
+}
+
+/*
+ * GenerationReset
+ *		Frees all memory which is allocated in the given set.
+ */
+template <bool enable_memoryprotect, bool is_tracked>
+void GenerationMemoryAllocator::GenerationReset(MemoryContext context)
+{
+    GenerationSet set = (GenerationSet)context;
+    GenerationBlock block = set->blocks;
+    MemoryProtectFuncDef* func = NULL;
+
+    AssertArg(GenerationIsValid(set));
+
+    if (context->session_id > 0)
+        func = &SessionFunctions;
+    else
+        func = &GenericFunctions;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+    /* Check for corruption and leaks before freeing */
+    GenerationCheck(context);
+#endif
+
+    if (set->freeblock != NULL) {
+        set->freeblock->next = block;
+        block = set->freeblock;
+    }
+
+    while (block != NULL) {
+        GenerationBlock next = block->next;
+        Size tempSize = block->blksize;
+
+        if (is_tracked)
+            MemoryTrackingFreeInfo(context, tempSize);
+
+        if (enable_memoryprotect)
+            (*func->free)(block, tempSize);
+        else
+            gs_free(block, tempSize);
+        block = next;
+    }
+
+    set->blocks = NULL;
+    set->block = NULL;
+    set->freeblock = NULL;
+    set->nextBlockSize = set->initBlockSize;
+    set->totalSpace = 0;
+    set->freeSpace = 0;
+}
+
+/*
+ * GenerationDelete
+ *		Frees all memory which is allocated in the given set,
+ *		in preparation for deletion of the set.
+ */
+template <bool enable_memoryprotect, bool is_tracked>
+void GenerationMemoryAllocator::GenerationDelete(MemoryContext context)
+{
+    GenerationReset<enable_memoryprotect, is_tracked>(context);
+}
+
+Size GenerationMemoryAllocator::GenerationGetChunkSpace(MemoryContext context, void* pointer)
+{
+    GenerationChunk chunk = GenerationPointerGetChunk(pointer);
+
+    return chunk->header.size + GENERATION_CHUNKHDRSZ;
+}
+
+bool GenerationMemoryAllocator::GenerationIsEmpty(MemoryContext context)
+{
+    GenerationSet set = (GenerationSet)context;
+
+    for (GenerationBlock block = set->blocks; block != NULL; block = block->next) {
+        if (block->nfree < block->nchunks)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * GenerationStats
+ *		Displays stats about memory consumption of a generation context.
+ */
+void GenerationMemoryAllocator::GenerationStats(MemoryContext context, int level)
+{
+    GenerationSet set = (GenerationSet)context;
+    long nblocks = 0;
+    long nchunks = 0;
+    long totalspace = 0;
+    long freespace = 0;
+    GenerationBlock block;
+    int i;
+
+    for (block = set->blocks; block != NULL; block = block->next) {
+        char* ptr = ((char*)block) + GENERATION_BLOCKHDRSZ;
+
+        nblocks++;
+        totalspace += block->blksize;
+        freespace += block->endptr - block->freeptr;
+        while (ptr < block->freeptr) {
+            GenerationChunk chunk = (GenerationChunk)ptr;
+
+            if (chunk->block == NULL) {
+                nchunks++;
+                freespace += chunk->header.size + GENERATION_CHUNKHDRSZ;
+            }
+            ptr += chunk->header.size + GENERATION_CHUNKHDRSZ;
+        }
+    }
+
+    if (set->freeblock != NULL) {
+        nblocks++;
+        totalspace += set->freeblock->blksize;
+        freespace += set->freeblock->blksize - GENERATION_BLOCKHDRSZ;
+    }
+
+    for (i = 0; i < level; i++)
+        fprintf(stderr, "  ");
+
+    fprintf(stderr,
+        "%s: %ld total in %ld blocks; %ld free (%ld chunks); %ld used\n",
+        set->header.name,
+        totalspace,
+        nblocks,
+        freespace,
+        nchunks,
+        totalspace - freespace);
+}
+
+#ifdef MEMORY_CONTEXT_CHECKING
+
+/*
+ * GenerationCheck
+ *		Walk through the chunks of each block and check that they add up to
+ *		the counts of the block.
+ */
+void GenerationMemoryAllocator::GenerationCheck(MemoryContext context)
+{
+    GenerationSet set = (GenerationSet)context;
+    const char* name = set->header.name;
+
+    for (GenerationBlock block = set->blocks; block != NULL; block = block->next) {
+        char* ptr = ((char*)block) + GENERATION_BLOCKHDRSZ;
+        int nchunks = 0;
+        int nfree = 0;
+
+        if (block->set != set)
+            elog(WARNING, "problem in generation %s: bogus set link in block %p", name, block);
+
+        while (ptr < block->freeptr) {
+            GenerationChunk chunk = (GenerationChunk)ptr;
+
+            nchunks++;
+            if (chunk->block == NULL) {
+                nfree++;
+            } else if (chunk->block != block || chunk->header.context != context) {
+                elog(WARNING, "problem in generation %s: bogus chunk %p in block %p", name, chunk, block);
+                break;
+            } else if (chunk->header.requested_size > chunk->header.size) {
+                elog(WARNING,
+                    "problem in generation %s: req size > alloc size for chunk %p in block %p",
+                    name,
+                    chunk,
+                    block);
+            }
+            ptr += chunk->header.size + GENERATION_CHUNKHDRSZ;
+        }
+
+        if (nchunks != block->nchunks || nfree != block->nfree)
+            elog(WARNING,
+                "problem in generation %s: block %p counts %d chunks, %d free, but holds %d, %d free",
+                name,
+                block,
+                block->nchunks,
+                block->nfree,
+                nchunks,
+                nfree);
+    }
+}
+
+#endif /* MEMORY_CONTEXT_CHECKING */
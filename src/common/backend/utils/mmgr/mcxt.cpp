@@ -1403,6 +1403,10 @@ void MemoryContextDestroyAtThreadExit(MemoryContext context)
     MemoryContext pContext = context;
 
     if (pContext != NULL) {
+        /* hand the chunks cached of the shared contexts back before the thread goes */
+        if (pContext == t_thrd.top_mem_cxt)
+            AllocSetCloseThreadCache();
+
         // To avoid delete current context
         //
         MemoryContextSwitchTo(pContext);
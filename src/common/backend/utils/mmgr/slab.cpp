@@ -0,0 +1,617 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * slab.cpp
+ *    Memory allocator for chunks of one fixed size.
+ *
+ * An AllocSet rounds every request up to a power of 2 and keeps freed chunks
+ * on its freelists until the context is reset, so a long-lived context that
+ * allocates and frees many objects of one type holds on to its peak usage
+ * and wastes up to half of it. The slab context sizes its chunks exactly,
+ * and gives a block back to malloc() once all of its chunks are free.
+ *
+ * The blocks are kept on lists by their number of free chunks, and a chunk
+ * is always taken from a block with the fewest free chunks, so that the
+ * emptiest blocks get a chance to become completely free.
+ *
+ * IDENTIFICATION
+ *    src/common/backend/utils/mmgr/slab.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <sys/mman.h>
+
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "utils/memutils.h"
+#include "utils/aset.h"
+#include "gs_register/gs_malloc.h"
+#include "utils/memprot.h"
+#include "utils/memtrack.h"
+
+typedef SlabContext* SlabSet;
+
+extern void MemoryContextControlSet(AllocSet context, const char* name);
+
+typedef struct SlabBlockData {
+    SlabSet slab;       /* slab that owns this block */
+    SlabBlock prev;     /* prev block in the list of its free count */
+    SlabBlock next;     /* next block in the list of its free count */
+    int nfree;          /* number of free chunks */
+    int firstFreeChunk; /* index of the first free chunk */
+} SlabBlockData;
+
+/*
+ * The standard header must be right in front of the chunk data, so that
+ * pfree() finds the context.
+ */
+typedef struct SlabChunkData {
+    SlabBlock block; /* block owning this chunk */
+    StandardChunkHeader header;
+} SlabChunkData;
+
+typedef SlabChunkData* SlabChunk;
+
+#define SLAB_BLOCKHDRSZ MAXALIGN(sizeof(SlabBlockData))
+#define SLAB_CHUNKHDRSZ sizeof(SlabChunkData)
+
+#define SlabIsValid(set) PointerIsValid(set)
+#define SlabPointerGetChunk(ptr) ((SlabChunk)(((char*)(ptr)) - SLAB_CHUNKHDRSZ))
+#define SlabChunkGetPointer(chk) ((void*)(((char*)(chk)) + SLAB_CHUNKHDRSZ))
+#define SlabBlockGetChunk(slab, block, idx) \
+    ((SlabChunk)((char*)(block) + SLAB_BLOCKHDRSZ + (idx) * (slab)->fullChunkSize))
+#define SlabChunkIndex(slab, block, chunk) \
+    ((int)(((char*)(chunk) - ((char*)(block) + SLAB_BLOCKHDRSZ)) / (slab)->fullChunkSize))
+
+/* the free chunks of a block are linked by the index stored in their data */
+#define SlabChunkNextFree(chunk) (*(int32*)SlabChunkGetPointer(chunk))
+
+#ifdef MEMORY_CONTEXT_CHECKING
+#define CHECK_CONTEXT_OWNER(context) \
+    Assert((context->session_id == u_sess->session_id) || (context->thread_id == gs_thread_self()))
+#else
+#define CHECK_CONTEXT_OWNER(context) ((void)0)
+#endif
+
+/* put the block on the list of its number of free chunks */
+static inline void SlabBlockPush(SlabSet slab, SlabBlock block)
+{
+    SlabBlock head = slab->freelist[block->nfree];
+
+    block->prev = NULL;
+    block->next = head;
+    if (head != NULL)
+        head->prev = block;
+    slab->freelist[block->nfree] = block;
+}
+
+static inline void SlabBlockUnlink(SlabSet slab, SlabBlock block)
+{
+    if (block->prev != NULL)
+        block->prev->next = block->next;
+    else
+        slab->freelist[block->nfree] = block->next;
+
+    if (block->next != NULL)
+        block->next->prev = block->prev;
+}
+
+/* the fewest free chunks, from "from" upwards, of any block; 0 if none has */
+static int SlabMinFreeChunks(SlabSet slab, int from)
+{
+    for (int idx = from; idx <= slab->chunksPerBlock; idx++) {
+        if (slab->freelist[idx] != NULL)
+            return idx;
+    }
+
+    return 0;
+}
+
+/*
+ * SlabContextCreate
+ *		Create a new slab context.
+ *
+ * parent: parent context, or NULL if top-level context
+ * name: name of context (for debugging --- string will be copied)
+ * blockSize: allocation block size
+ * chunkSize: size of the chunks allocated in the context
+ */
+MemoryContext SlabContextCreate(MemoryContext parent, const char* name, Size blockSize, Size chunkSize)
+{
+#ifndef ENABLE_MEMORY_CHECK
+    return SlabMemoryAllocator::SlabContextCreate(parent, name, blockSize, chunkSize, false);
+#else
+    /* pfree() of this build only knows the chunks of AsanMemoryAllocator */
+    return AllocSetContextCreate(parent, name, ALLOCSET_DEFAULT_MINSIZE, blockSize, blockSize);
+#endif
+}
+
+/*
+ * SlabMethodDefinition
+ *      Define the method functions based on the templated value
+ */
+template <bool enable_memoryprotect, bool is_tracked>
+void SlabMemoryAllocator::SlabMethodDefinition(MemoryContextMethods* method)
+{
+    method->alloc = &SlabMemoryAllocator::SlabAlloc<enable_memoryprotect, is_tracked>;
+    method->free_p = &SlabMemoryAllocator::SlabFree<enable_memoryprotect, is_tracked>;
+    method->realloc = &SlabMemoryAllocator::SlabRealloc;
+    method->init = &SlabMemoryAllocator::SlabInit;
+    method->reset = &SlabMemoryAllocator::SlabReset<enable_memoryprotect, is_tracked>;
+    method->delete_context = &SlabMemoryAllocator::SlabDelete<enable_memoryprotect, is_tracked>;
+    method->get_chunk_space = &SlabMemoryAllocator::SlabGetChunkSpace;
+    method->is_empty = &SlabMemoryAllocator::SlabIsEmpty;
+    method->stats = &SlabMemoryAllocator::SlabStats;
+#ifdef MEMORY_CONTEXT_CHECKING
+    method->check = &SlabMemoryAllocator::SlabCheck;
+#endif
+}
+
+/*
+ * SlabContextSetMethods
+ *		set the method functions
+ */
+void SlabMemoryAllocator::SlabContextSetMethods(unsigned long value, MemoryContextMethods* method)
+{
+    bool isProt = (value & IS_PROTECT) ? true : false;
+    bool isTracked = (value & IS_TRACKED) ? true : false;
+
+    if (isProt) {
+        if (isTracked)
+            SlabMethodDefinition<true, true>(method);
+        else
+            SlabMethodDefinition<true, false>(method);
+    } else {
+        if (isTracked)
+            SlabMethodDefinition<false, true>(method);
+        else
+            SlabMethodDefinition<false, false>(method);
+    }
+}
+
+MemoryContext SlabMemoryAllocator::SlabContextCreate(
+    MemoryContext parent, const char* name, Size blockSize, Size chunkSize, bool isSession)
+{
+    SlabSet slab = NULL;
+    bool isTracked = false;
+    unsigned long value = t_thrd.utils_cxt.gs_mp_inited ? IS_PROTECT : 0;
+    MemoryProtectFuncDef* func = NULL;
+    Size fullChunkSize;
+    Size headerSize;
+    int chunksPerBlock;
+
+    if (!isSession && (parent == NULL || parent->session_id == 0))
+        func = &GenericFunctions;
+    else
+        func = &SessionFunctions;
+
+    /* only track the memory context after t_thrd.mem_cxt.mem_track_mem_cxt is created */
+    if (func == &GenericFunctions && parent && u_sess->attr.attr_memory.memory_tracking_mode &&
+        t_thrd.mem_cxt.mem_track_mem_cxt &&
+        (t_thrd.utils_cxt.ExecutorMemoryTrack == NULL || ((AllocSet)parent)->track)) {
+        isTracked = true;
+        value |= IS_TRACKED;
+    }
+
+    /* a free chunk has to hold the index of the next one */
+    chunkSize = MAXALIGN(Max(chunkSize, sizeof(int32)));
+    fullChunkSize = SLAB_CHUNKHDRSZ + chunkSize;
+    blockSize = MAXALIGN(blockSize);
+    if (blockSize < SLAB_BLOCKHDRSZ + fullChunkSize) {
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("block size %lu of slab context \"%s\" is too small for chunks of %lu bytes",
+                    (unsigned long)blockSize,
+                    name,
+                    (unsigned long)chunkSize)));
+    }
+    chunksPerBlock = (int)((blockSize - SLAB_BLOCKHDRSZ) / fullChunkSize);
+
+    /* the lists of blocks by free count follow the context */
+    headerSize = MAXALIGN(sizeof(SlabContext)) + (chunksPerBlock + 1) * sizeof(SlabBlock);
+
+    // Do the type-independent part of context creation
+    //
+    slab = (SlabSet)MemoryContextCreate(T_SlabContext, headerSize, parent, name, __FILE__, __LINE__);
+
+    /* it holds data of its parent, check it against the same limit */
+    if (parent != NULL)
+        slab->maxSpaceSize = ((AllocSet)parent)->maxSpaceSize;
+    else
+        slab->maxSpaceSize = DEFAULT_MEMORY_CONTEXT_MAX_SIZE + SELF_GENRIC_MEMCTX_LIMITATION;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+    MemoryContextControlSet((AllocSet)slab, name);
+#endif
+
+    /* assign the method function with specified templated to the context */
+    SlabContextSetMethods(value, ((MemoryContext)slab)->methods);
+
+    slab->initBlockSize = blockSize;
+    slab->maxBlockSize = blockSize;
+    slab->nextBlockSize = blockSize;
+    slab->allocChunkLimit = chunkSize;
+    slab->chunkSize = chunkSize;
+    slab->fullChunkSize = fullChunkSize;
+    slab->chunksPerBlock = chunksPerBlock;
+    slab->minFreeChunks = 0;
+    slab->nblocks = 0;
+    slab->freelist = (SlabBlock*)((char*)slab + MAXALIGN(sizeof(SlabContext)));
+
+    // create the memory tracking structure
+    if (isTracked)
+        MemoryTrackingCreate((MemoryContext)slab, parent);
+
+    return (MemoryContext)slab;
+}
+
+/*
+ * SlabAlloc
+ *		Returns a chunk of the fixed size, from the block with the fewest
+ *		free chunks, or from a new block if none has any.
+ */
+template <bool enable_memoryprotect, bool is_tracked>
+void* SlabMemoryAllocator::SlabAlloc(MemoryContext context, Size align, Size size, const char* file, int line)
+{
+    SlabSet slab = (SlabSet)context;
+    SlabBlock block;
+    SlabChunk chunk;
+    int idx;
+    MemoryProtectFuncDef* func = NULL;
+
+    AssertArg(SlabIsValid(slab));
+    AssertArg(align == 0);
+    CHECK_CONTEXT_OWNER(context);
+
+    if (context->session_id > 0)
+        func = &SessionFunctions;
+    else
+        func = &GenericFunctions;
+
+    if (size > slab->chunkSize) {
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("unexpected alloc chunk size %lu (expected at most %lu) in slab context \"%s\"",
+                    (unsigned long)size,
+                    (unsigned long)slab->chunkSize,
+                    context->name)));
+    }
+
+#ifdef MEMORY_CONTEXT_CHECKING
+    /* memory enjection */
+    if (gs_memory_enjection())
+        return NULL;
+#endif
+
+    if (slab->minFreeChunks == 0) {
+        Size blksize = slab->initBlockSize;
+
+        if (enable_memoryprotect)
+            block = (SlabBlock)(*func->malloc)(blksize);
+        else
+            gs_malloc(blksize, block, SlabBlock);
+
+        if (block == NULL)
+            return NULL;
+
+        block->slab = slab;
+        block->nfree = slab->chunksPerBlock;
+        block->firstFreeChunk = 0;
+        for (idx = 0; idx < slab->chunksPerBlock; idx++)
+            SlabChunkNextFree(SlabBlockGetChunk(slab, block, idx)) = idx + 1;
+
+        SlabBlockPush(slab, block);
+        slab->minFreeChunks = slab->chunksPerBlock;
+        slab->nblocks++;
+
+        slab->totalSpace += blksize;
+        slab->freeSpace += blksize - SLAB_BLOCKHDRSZ;
+
+        /* update the memory tracking information when allocating memory */
+        if (is_tracked)
+            MemoryTrackingAllocInfo(context, blksize);
+    }
+
+    block = slab->freelist[slab->minFreeChunks];
+    Assert(block != NULL && block->nfree == slab->minFreeChunks);
+
+    idx = block->firstFreeChunk;
+    Assert(idx >= 0 && idx < slab->chunksPerBlock);
+    chunk = SlabBlockGetChunk(slab, block, idx);
+    block->firstFreeChunk = SlabChunkNextFree(chunk);
+
+    /* the block moves to the list of one free chunk less */
+    SlabBlockUnlink(slab, block);
+    block->nfree--;
+    SlabBlockPush(slab, block);
+
+    /* it had the fewest free chunks, and still has unless it is full now */
+    if (block->nfree > 0)
+        slab->minFreeChunks = block->nfree;
+    else
+        slab->minFreeChunks = SlabMinFreeChunks(slab, slab->minFreeChunks);
+
+    chunk->block = block;
+    chunk->header.context = context;
+    chunk->header.size = slab->chunkSize;
+#ifdef MEMORY_CONTEXT_CHECKING
+    chunk->header.requested_size = size;
+    chunk->header.file = file;
+    chunk->header.line = line;
+    /* track the detail allocation information */
+    MemoryTrackingDetailInfo(context, size, slab->chunkSize, file, line);
+#endif
+
+    slab->freeSpace -= slab->fullChunkSize;
+
+    return SlabChunkGetPointer(chunk);
+}
+
+/*
+ * SlabFree
+ *		Puts the chunk back on the free list of its block, and frees the
+ *		block when it has no chunk in use anymore.
+ */
+template <bool enable_memoryprotect, bool is_tracked>
+void SlabMemoryAllocator::SlabFree(MemoryContext context, void* pointer)
+{
+    SlabSet slab = (SlabSet)context;
+    SlabChunk chunk = SlabPointerGetChunk(pointer);
+    SlabBlock block = chunk->block;
+    int oldnfree;
+    MemoryProtectFuncDef* func = NULL;
+
+    AssertArg(SlabIsValid(slab));
+    CHECK_CONTEXT_OWNER(context);
+
+    if (context->session_id > 0)
+        func = &SessionFunctions;
+    else
+        func = &GenericFunctions;
+
+    if (block == NULL || block->slab != slab) {
+        ereport(ERROR,
+            (errcode(ERRCODE_OPERATE_RESULT_NOT_EXPECTED),
+                errmsg("%s Memory Context could not find block containing chunk", context->name)));
+    }
+
+#ifdef MEMORY_CONTEXT_CHECKING
+    chunk->header.requested_size = 0;
+#endif
+
+    SlabChunkNextFree(chunk) = block->firstFreeChunk;
+    block->firstFreeChunk = SlabChunkIndex(slab, block, chunk);
+    slab->freeSpace += slab->fullChunkSize;
+
+    oldnfree = block->nfree;
+    SlabBlockUnlink(slab, block);
+    block->nfree++;
+
+    if (block->nfree == slab->chunksPerBlock) {
+        Size blksize = slab->initBlockSize;
+
+        /* no chunk of the block is in use, give it back */
+        slab->nblocks--;
+        slab->totalSpace -= blksize;
+        slab->freeSpace -= blksize - SLAB_BLOCKHDRSZ;
+        block->slab = NULL;
+
+        if (is_tracked)
+            MemoryTrackingFreeInfo(context, blksize);
+
+        if (enable_memoryprotect)
+            (*func->free)(block, blksize);
+        else
+            gs_free(block, blksize);
+
+        if (oldnfree == slab->minFreeChunks && slab->freelist[oldnfree] == NULL)
+            slab->minFreeChunks = SlabMinFreeChunks(slab, oldnfree + 1);
+        return;
+    }
+
+    SlabBlockPush(slab, block);
+
+    if (slab->minFreeChunks == 0 || block->nfree < slab->minFreeChunks)
+        slab->minFreeChunks = block->nfree;
+    else if (oldnfree == slab->minFreeChunks && slab->freelist[oldnfree] == NULL)
+        slab->minFreeChunks = block->nfree;
+}
+
+/*
+ * SlabRealloc
+ *		The chunks are all of the same size, so a chunk can be given any
+ *		size up to that one, but never grow beyond it.
+ */
+void* SlabMemoryAllocator::SlabRealloc(
+    MemoryContext context, void* pointer, Size align, Size size, const char* file, int line)
+{
+    SlabSet slab = (SlabSet)context;
+
+    AssertArg(align == 0);
+
+    if (size > slab->chunkSize) {
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_OPERATION),
+                errmsg("unsupport to grow a chunk beyond %lu bytes under slab memory allocator",
+                    (unsigned long)slab->chunkSize)));
+    }
+
+#ifdef MEMORY_CONTEXT_CHECKING
+    SlabPointerGetChunk(pointer)->header.requested_size = size;
+#endif
+
+    return pointer;
+}
+
+void SlabMemoryAllocator::SlabInit(MemoryContext context)
+{
+    /*
+     * we don't
+     * have to do anything here: it's already OK.
+     */
+}
+
+/*
+ * SlabReset
+ *		Frees all memory which is allocated in the given set.
+ */
+template <bool enable_memoryprotect, bool is_tracked>
+void SlabMemoryAllocator::SlabReset(MemoryContext context)
+{
+    SlabSet slab = (SlabSet)context;
+    MemoryProtectFuncDef* func = NULL;
+
+    AssertArg(SlabIsValid(slab));
+
+    if (context->session_id > 0)
+        func = &SessionFunctions;
+    else
+        func = &GenericFunctions;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+    /* Check for corruption and leaks before freeing */
+    SlabCheck(context);
+#endif
+
+    for (int idx = 0; idx <= slab->chunksPerBlock; idx++) {
+        SlabBlock block = slab->freelist[idx];
+
+        while (block != NULL) {
+            SlabBlock next = block->next;
+
+            if (is_tracked)
+                MemoryTrackingFreeInfo(context, slab->initBlockSize);
+
+            if (enable_memoryprotect)
+                (*func->free)(block, slab->initBlockSize);
+            else
+                gs_free(block, slab->initBlockSize);
+            block = next;
+        }
+        slab->freelist[idx] = NULL;
+    }
+
+    slab->minFreeChunks = 0;
+    slab->nblocks = 0;
+    slab->totalSpace = 0;
+    slab->freeSpace = 0;
+}
+
+/*
+ * SlabDelete
+ *		Frees all memory which is allocated in the given set,
+ *		in preparation for deletion of the set.
+ */
+template <bool enable_memoryprotect, bool is_tracked>
+void SlabMemoryAllocator::SlabDelete(MemoryContext context)
+{
+    SlabReset<enable_memoryprotect, is_tracked>(context);
+}
+
+Size SlabMemoryAllocator::SlabGetChunkSpace(MemoryContext context, void* pointer)
+{
+    SlabSet slab = (SlabSet)context;
+
+    return slab->fullChunkSize;
+}
+
+bool SlabMemoryAllocator::SlabIsEmpty(MemoryContext context)
+{
+    /* the blocks are freed along with their last chunk */
+    return ((SlabSet)context)->nblocks == 0;
+}
+
+/*
+ * SlabStats
+ *		Displays stats about memory consumption of a slab context.
+ */
+void SlabMemoryAllocator::SlabStats(MemoryContext context, int level)
+{
+    SlabSet slab = (SlabSet)context;
+    long nblocks = 0;
+    long nchunks = 0;
+    long totalspace = 0;
+    long freespace = 0;
+    int i;
+
+    for (int idx = 0; idx <= slab->chunksPerBlock; idx++) {
+        for (SlabBlock block = slab->freelist[idx]; block != NULL; block = block->next) {
+            nblocks++;
+            nchunks += block->nfree;
+            totalspace += slab->initBlockSize;
+            freespace += slab->initBlockSize - SLAB_BLOCKHDRSZ -
+                         (slab->chunksPerBlock - block->nfree) * slab->fullChunkSize;
+        }
+    }
+
+    for (i = 0; i < level; i++)
+        fprintf(stderr, "  ");
+
+    fprintf(stderr,
+        "%s: %ld total in %ld blocks; %ld free (%ld chunks); %ld used\n",
+        slab->header.name,
+        totalspace,
+        nblocks,
+        freespace,
+        nchunks,
+        totalspace - freespace);
+}
+
+#ifdef MEMORY_CONTEXT_CHECKING
+
+/*
+ * SlabCheck
+ *		Walk through the blocks and check that each is on the list of its
+ *		free count, and that its free list holds as many chunks.
+ */
+void SlabMemoryAllocator::SlabCheck(MemoryContext context)
+{
+    SlabSet slab = (SlabSet)context;
+    const char* name = slab->header.name;
+    int nblocks = 0;
+
+    for (int idx = 0; idx <= slab->chunksPerBlock; idx++) {
+        for (SlabBlock block = slab->freelist[idx]; block != NULL; block = block->next) {
+            int nfree = 0;
+
+            nblocks++;
+            if (block->slab != slab || block->nfree != idx)
+                elog(WARNING, "problem in slab %s: bad block %p on free list %d", name, block, idx);
+
+            for (int chk = block->firstFreeChunk; chk < slab->chunksPerBlock;
+                 chk = SlabChunkNextFree(SlabBlockGetChunk(slab, block, chk))) {
+                if (chk < 0 || ++nfree > block->nfree) {
+                    elog(WARNING, "problem in slab %s: corrupt free list in block %p", name, block);
+                    break;
+                }
+            }
+
+            if (nfree != block->nfree)
+                elog(WARNING,
+                    "problem in slab %s: block %p has %d free chunks but %d on its list",
+                    name,
+                    block,
+                    block->nfree,
+                    nfree);
+        }
+    }
+
+    if (nblocks != slab->nblocks)
+        elog(WARNING, "problem in slab %s: %d blocks found, %d expected", name, nblocks, slab->nblocks);
+}
+
+#endif /* MEMORY_CONTEXT_CHECKING */
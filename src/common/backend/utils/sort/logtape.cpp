@@ -145,6 +145,10 @@ struct LogicalTapeSet {
     BufFile* pfile;   /* underlying file for whole tape set */
     long nFileBlocks; /* # of blocks used in underlying file */
 
+    /* bytes written out before and after compression, if pfile compresses */
+    int64 spillRawSize;
+    int64 spillCompressSize;
+
     /*
      * We store the numbers of recycled-and-available blocks in freeBlocks[].
      * When there are no such blocks, we extend the underlying file.
@@ -482,7 +486,13 @@ LogicalTapeSet* LogicalTapeSetCreate(int ntapes)
      */
     Assert(ntapes > 0);
     lts = (LogicalTapeSet*)palloc(sizeof(LogicalTapeSet) + ((size_t)ntapes - 1) * sizeof(LogicalTape));
-    lts->pfile = BufFileCreateTemp(false);
+    lts->spillRawSize = 0;
+    lts->spillCompressSize = 0;
+    if (u_sess->attr.attr_sql.enable_compress_spill) {
+        lts->pfile = BufFileCreateTempCompress(false, &lts->spillRawSize, &lts->spillCompressSize);
+    } else {
+        lts->pfile = BufFileCreateTemp(false);
+    }
     lts->nFileBlocks = 0L;
     lts->forgetFreeSpace = false;
     lts->blocksSorted = true; /* a zero-length array is sorted ... */
@@ -928,3 +938,13 @@ long LogicalTapeSetBlocks(LogicalTapeSet* lts)
 {
     return lts->nFileBlocks;
 }
+
+/*
+ * Obtain the bytes written out by a LogicalTapeSet before and after
+ * compression, both are zero if the tape set is not compressed.
+ */
+void LogicalTapeSetSpillStats(LogicalTapeSet* lts, int64* rawSize, int64* compressSize)
+{
+    *rawSize = lts->spillRawSize;
+    *compressSize = lts->spillCompressSize;
+}
@@ -223,6 +223,7 @@ struct Tuplesortstate {
     int maxTapes;              /* number of tapes (Knuth's T) */
     int tapeRange;             /* maxTapes-1 (Knuth's P) */
     MemoryContext sortcontext; /* memory context holding all sort data */
+    MemoryContext tuplecontext; /* sub-context of sortcontext for tuple data */
     LogicalTapeSet* tapeset;   /* logtape.c object for tapes in a temp file */
 #ifdef PGXC
     Oid current_xcnode; /* node from where we are got last tuple */
@@ -681,6 +682,14 @@ static Tuplesortstate* tuplesort_begin_common(int64 workMem, bool randomAccess)
     state->sortcontext = sortcontext;
     state->tapeset = NULL;
 
+    /*
+     * The tuples of an in-memory sort all live until the sort ends. A
+     * generation context stores them without rounding them up to a power
+     * of 2, and frees them with their blocks.
+     */
+    state->tuplecontext = GenerationContextCreate(
+        sortcontext, "Caller tuples", ALLOCSET_DEFAULT_INITSIZE, ALLOCSET_DEFAULT_MAXSIZE);
+
     state->memtupcount = 0;
     state->memtupsize = 1024; /* initial guess */
     state->growmemtuples = true;
@@ -812,14 +821,14 @@ Tuplesortstate* tuplesort_begin_cluster(
     if (u_sess->attr.attr_common.trace_sort) {
         elog(LOG,
             "begin tuple sort: nkeys = %d, workMem = %d, randomAccess = %c, maxMem = %d",
-            RelationGetNumberOfAttributes(indexRel),
+            IndexRelationGetNumberOfKeyAttributes(indexRel),
             workMem,
             randomAccess ? 't' : 'f',
             maxMem);
     }
 #endif
 
-    state->nKeys = RelationGetNumberOfAttributes(indexRel);
+    state->nKeys = IndexRelationGetNumberOfKeyAttributes(indexRel);
 
     TRACE_POSTGRESQL_SORT_START(CLUSTER_SORT,
         false, /* no unique check */
@@ -881,7 +890,7 @@ Tuplesortstate* tuplesort_begin_index_btree(
     }
 #endif
 
-    state->nKeys = RelationGetNumberOfAttributes(indexRel);
+    state->nKeys = IndexRelationGetNumberOfKeyAttributes(indexRel);
 
     TRACE_POSTGRESQL_SORT_START(INDEX_SORT, enforceUnique, state->nKeys, workMem, randomAccess);
 
@@ -1029,6 +1038,10 @@ void tuplesort_set_bound(Tuplesortstate* state, int64 bound)
 
     state->bounded = true;
     state->bound = (int)bound;
+
+    /* the bounded heap frees the tuples it discards in any order */
+    state->tuplecontext = state->sortcontext;
+
     /*
      * Bounded sorts are not an effective target for abbreviated key
      * optimization.  Disable by setting state to be consistent with no
@@ -1294,7 +1307,7 @@ void tuplesort_puttupleslotontape(Tuplesortstate* state, TupleTableSlot* slot)
  */
 void tuplesort_puttupleslot(Tuplesortstate* state, TupleTableSlot* slot)
 {
-    MemoryContext oldcontext = MemoryContextSwitchTo(state->sortcontext);
+    MemoryContext oldcontext = MemoryContextSwitchTo(state->tuplecontext);
     SortTuple stup;
 
     /*
@@ -1303,6 +1316,7 @@ void tuplesort_puttupleslot(Tuplesortstate* state, TupleTableSlot* slot)
      */
     COPYTUP(state, &stup, (void*)slot);
 
+    (void)MemoryContextSwitchTo(state->sortcontext);
     puttuple_common(state, &stup);
 
     (void)MemoryContextSwitchTo(oldcontext);
@@ -1315,7 +1329,7 @@ void tuplesort_puttupleslot(Tuplesortstate* state, TupleTableSlot* slot)
  */
 void tuplesort_putheaptuple(Tuplesortstate* state, HeapTuple tup)
 {
-    MemoryContext oldcontext = MemoryContextSwitchTo(state->sortcontext);
+    MemoryContext oldcontext = MemoryContextSwitchTo(state->tuplecontext);
     SortTuple stup;
 
     /*
@@ -1325,6 +1339,7 @@ void tuplesort_putheaptuple(Tuplesortstate* state, HeapTuple tup)
     Assert(!HEAP_TUPLE_IS_COMPRESSED(tup->t_data));
     COPYTUP(state, &stup, (void*)tup);
 
+    (void)MemoryContextSwitchTo(state->sortcontext);
     puttuple_common(state, &stup);
 
     (void)MemoryContextSwitchTo(oldcontext);
@@ -1337,7 +1352,7 @@ void tuplesort_putheaptuple(Tuplesortstate* state, HeapTuple tup)
 void tuplesort_putindextuplevalues(
     Tuplesortstate* state, Relation rel, ItemPointer self, Datum* values, const bool* isnull)
 {
-    MemoryContext oldcontext = MemoryContextSwitchTo(state->sortcontext);
+    MemoryContext oldcontext = MemoryContextSwitchTo(state->tuplecontext);
     SortTuple stup;
     stup.tupindex = 0;
 
@@ -1346,6 +1361,8 @@ void tuplesort_putindextuplevalues(
     USEMEM(state, GetMemoryChunkSpace(stup.tuple));
     /* set up first-column key value */
     stup.datum1 = index_getattr((IndexTuple)stup.tuple, 1, RelationGetDescr(state->indexRel), &stup.isnull1);
+
+    (void)MemoryContextSwitchTo(state->sortcontext);
     puttuple_common(state, &stup);
 
     (void)MemoryContextSwitchTo(oldcontext);
@@ -1358,7 +1375,7 @@ void tuplesort_putindextuplevalues(
  */
 void tuplesort_putdatum(Tuplesortstate* state, Datum val, bool isNull)
 {
-    MemoryContext oldcontext = MemoryContextSwitchTo(state->sortcontext);
+    MemoryContext oldcontext = MemoryContextSwitchTo(state->tuplecontext);
     SortTuple stup;
     stup.tupindex = 0;
 
@@ -1377,6 +1394,7 @@ void tuplesort_putdatum(Tuplesortstate* state, Datum val, bool isNull)
         USEMEM(state, GetMemoryChunkSpace(stup.tuple));
     }
 
+    (void)MemoryContextSwitchTo(state->sortcontext);
     puttuple_common(state, &stup);
 
     (void)MemoryContextSwitchTo(oldcontext);
@@ -2118,6 +2136,12 @@ static void inittapes(Tuplesortstate* state)
     int maxTapes, ntuples, j;
     long tapeSpace;
 
+    /*
+     * Tuples are freed in heap order as the runs are written, which leaves
+     * the blocks of a generation context fragmented; use sortcontext.
+     */
+    state->tuplecontext = state->sortcontext;
+
     /* Compute number of tapes to use: merge order plus 1 */
     maxTapes = tuplesort_merge_order(state->allowedMem) + 1;
 
@@ -2893,6 +2917,20 @@ void tuplesort_get_stats(Tuplesortstate* state, int* sortMethodId, int* spaceTyp
     }
 }
 
+/*
+ * tuplesort_get_spill_stats - bytes spilled to the compressed tape set
+ *
+ * Both are zero if the sort did not spill or spill compression is off.
+ */
+void tuplesort_get_spill_stats(Tuplesortstate* state, int64* rawSize, int64* compressSize)
+{
+    *rawSize = 0;
+    *compressSize = 0;
+    if (state->tapeset != NULL) {
+        LogicalTapeSetSpillStats(state->tapeset, rawSize, compressSize);
+    }
+}
+
 /*
  * Heap manipulation routines, per Knuth's Algorithm 5.2.3H.
  *
@@ -176,6 +176,10 @@ struct Tuplestorestate {
     bool causedBySysRes;   /* the batch increase caused by system resources limit? */
     int64 maxMem;          /* auto spread max mem */
     int spreadNum;         /* auto spread times of memory */
+
+    /* bytes of the compressed temp file before and after compression */
+    int64 spillRawSize;
+    int64 spillCompressSize;
     int planId;            /* id of plan that used this state */
     int dop;               /* parallel num of the plan */
     bool isMemCtl;         /* whether context is under memory control */
@@ -875,7 +879,12 @@ static void tuplestore_puttuple_common(Tuplestorestate* state, void* tuple)
             oldowner = t_thrd.utils_cxt.CurrentResourceOwner;
             t_thrd.utils_cxt.CurrentResourceOwner = state->resowner;
 
-            state->myfile = BufFileCreateTemp(state->interXact);
+            if (u_sess->attr.attr_sql.enable_compress_spill) {
+                state->myfile =
+                    BufFileCreateTempCompress(state->interXact, &state->spillRawSize, &state->spillCompressSize);
+            } else {
+                state->myfile = BufFileCreateTemp(state->interXact);
+            }
 
             t_thrd.utils_cxt.CurrentResourceOwner = oldowner;
 
@@ -1485,3 +1494,9 @@ int tuplestore_get_spread_num(Tuplestorestate* state)
 {
     return state->spreadNum;
 }
+
+void tuplestore_get_spill_stats(Tuplestorestate* state, int64* rawSize, int64* compressSize)
+{
+    *rawSize = state->spillRawSize;
+    *compressSize = state->spillCompressSize;
+}
@@ -966,9 +966,8 @@ ObsOptions* getObsOptions(Oid foreignTableId)
  * @Description: get the foreign server type of the special foreign talbe..
  * @in foreignTableId, the given foreign table oid.
  * @return
- * notes: currently, only the hdfs foreign table and obs foreign table have
- * server type. so when the given foreign table is not either of obs foreign
- * foreign table and obs foreign table, return T_INVALID.
+ * notes: currently, only the hdfs, obs and local foreign tables have server
+ * type. so when the given foreign table is none of them, return T_INVALID.
  */
 ServerTypeOption getServerType(Oid foreignTableId)
 {
@@ -982,6 +981,8 @@ ServerTypeOption getServerType(Oid foreignTableId)
             srvType = T_HDFS_SERVER;
         } else if (0 == pg_strcasecmp(optionValue, DUMMY_SERVER)) {
             srvType = T_DUMMY_SERVER;
+        } else if (0 == pg_strcasecmp(optionValue, LOCAL_SERVER)) {
+            srvType = T_LOCAL_SERVER;
         }
     } else if (IsSpecifiedFDWFromRelid(foreignTableId, DIST_FDW) &&
                (is_obs_protocol(HdfsGetOptionValue(foreignTableId, optLocation)))) {
@@ -42,13 +42,19 @@
 #include <unistd.h>
 
 #include "access/hash.h"
+#include "catalog/pg_type.h"
+#include "lib/stringinfo.h"
 #include "parser/scanner.h"
 #include "mb/pg_wchar.h"
 #include "instruments/unique_query.h"
 #include "pgstat.h"
+#include "utils/builtins.h"
+/* the grammar tokens clash with symbols of other headers, keep this last */
+#include "parser/gramparse.h"
 
 const int JUMBLE_SIZE = 1024; /* query serialization buffer size */
 const int CLOCATIONS_BUF_SIZE = 32;
+const int ICONST_STR_LEN = 12; /* "-2147483648" and the terminator */
 
 /*
  * Struct for tracking locations/lengths of constants during normalization
@@ -56,6 +62,7 @@ const int CLOCATIONS_BUF_SIZE = 32;
 typedef struct pgssLocationLen {
     int location; /* start offset in query text */
     int length;   /* length in bytes, or -1 to ignore */
+    Oid type;     /* type of the constant */
 } pgssLocationLen;
 
 /*
@@ -85,7 +92,7 @@ void AppendJumble(pgssJumbleState* jstate, const unsigned char* item, Size size)
 void JumbleQuery(pgssJumbleState* jstate, Query* query);
 void JumbleRangeTable(pgssJumbleState* jstate, List* rtable);
 void JumbleExpr(pgssJumbleState* jstate, Node* node);
-void RecordConstLocation(pgssJumbleState* jstate, int location);
+void RecordConstLocation(pgssJumbleState* jstate, int location, Oid type);
 uint32 pgss_hash_string(const char* str);
 char* generate_normalized_query(pgssJumbleState* jstate, const char* query, int* query_len_p, int encoding);
 void fill_in_constant_lengths(pgssJumbleState* jstate, const char* query);
@@ -370,7 +377,7 @@ void UniqueSql::JumbleExpr(pgssJumbleState* jstate, Node* node)
             /* We jumble only the constant's type, not its value */
             APP_JUMB(c->consttype);
             /* Also, record its parse location for query normalization */
-            UniqueSql::RecordConstLocation(jstate, c->location);
+            UniqueSql::RecordConstLocation(jstate, c->location, c->consttype);
             break;
         }
         case T_Param: {
@@ -684,7 +691,7 @@ void UniqueSql::JumbleExpr(pgssJumbleState* jstate, Node* node)
  * Record location of constant within query string of query tree
  * that is currently being walked.
  */
-void UniqueSql::RecordConstLocation(pgssJumbleState* jstate, int location)
+void UniqueSql::RecordConstLocation(pgssJumbleState* jstate, int location, Oid type)
 {
     const int DOUBLE_SIZE = 2;
     /* -1 indicates unknown or undefined location */
@@ -698,6 +705,7 @@ void UniqueSql::RecordConstLocation(pgssJumbleState* jstate, int location)
         jstate->clocations[jstate->clocations_count].location = location;
         /* initialize lengths to -1 to simplify fill_in_constant_lengths */
         jstate->clocations[jstate->clocations_count].length = -1;
+        jstate->clocations[jstate->clocations_count].type = type;
         jstate->clocations_count++;
     }
 }
@@ -930,3 +938,179 @@ int UniqueSql::comp_location(const void* a, const void* b)
         return 0;
     }
 }
+
+/*
+ * Whether the parser makes an int8 constant of a float literal: it does for
+ * the digit strings too long for int4 that still fit in int8, see make_const.
+ */
+static bool fconst_is_int8(const char* str)
+{
+    const char* max_int8 = "9223372036854775807";
+    const char* digits = NULL;
+    size_t len;
+
+    for (const char* p = str; *p != '\0'; p++) {
+        if (!isdigit((unsigned char)*p)) {
+            return false;
+        }
+    }
+
+    digits = str;
+    while (*digits == '0' && digits[1] != '\0') {
+        digits++;
+    }
+    len = strlen(digits);
+    return (len < strlen(max_int8) || (len == strlen(max_int8) && strcmp(digits, max_int8) <= 0));
+}
+
+/*
+ * Replace the literal tokens of a query text by parameter symbols, used for
+ * the auto-parameterization of simple queries.
+ *
+ * Integer literals become $n, other numeric literals are cast to the type
+ * the parser would give them, so queries with the same text but literals of
+ * different numeric types do not share a statement. String literals become
+ * plain $n, their type is decided by auto_parameterize_check_query().
+ *
+ * Returns NULL if the text has no literals, already has parameters, or holds
+ * more than one statement.
+ */
+char* auto_parameterize_query_string(const char* query_string, AutoParamLiteral** literals_p, int* nliterals_p)
+{
+    core_yyscan_t yyscanner;
+    core_yy_extra_type yyextra;
+    core_YYSTYPE yylval;
+    YYLTYPE yylloc;
+    StringInfoData buf;
+    AutoParamLiteral* literals = NULL;
+    int nliterals = 0;
+    int maxliterals = CLOCATIONS_BUF_SIZE;
+    int last_end = 0;
+    int prev_tok = 0;
+    int prev_loc = -1;
+    bool valid = true;
+    int tok;
+
+    initStringInfo(&buf);
+    literals = (AutoParamLiteral*)palloc(maxliterals * sizeof(AutoParamLiteral));
+
+    yyscanner = scanner_init(query_string, &yyextra, ScanKeywords, NumScanKeywords);
+    for (;;) {
+        tok = core_yylex(&yylval, &yylloc, yyscanner);
+        if (tok == 0) {
+            break;
+        }
+
+        /* parameters already, or a second statement */
+        if (tok == PARAM || (prev_tok == ';' && tok != ';')) {
+            valid = false;
+            break;
+        }
+
+        if (tok == ICONST || tok == FCONST || tok == SCONST) {
+            AutoParamLiteral* lit = NULL;
+
+            if (nliterals >= maxliterals) {
+                maxliterals *= 2;
+                literals = (AutoParamLiteral*)repalloc(literals, maxliterals * sizeof(AutoParamLiteral));
+            }
+            lit = &literals[nliterals++];
+            lit->location = yylloc;
+            lit->sign_location = (prev_tok == '-') ? prev_loc : -1;
+            lit->valtype = (tok == ICONST) ? T_Integer : ((tok == FCONST) ? T_Float : T_String);
+            lit->type = InvalidOid;
+            if (tok == ICONST) {
+                lit->value = (char*)palloc(ICONST_STR_LEN);
+                pg_ltoa(yylval.ival, lit->value);
+            } else {
+                lit->value = pstrdup(yylval.str);
+            }
+
+            /* flex has put a zero byte after the text of the current token */
+            appendBinaryStringInfo(&buf, query_string + last_end, yylloc - last_end);
+            appendStringInfo(&buf, "$%d", nliterals);
+            if (tok == FCONST) {
+                appendStringInfoString(&buf, fconst_is_int8(lit->value) ? "::int8" : "::numeric");
+            }
+            last_end = yylloc + strlen(yyextra.scanbuf + yylloc);
+        }
+
+        prev_tok = tok;
+        prev_loc = yylloc;
+    }
+    scanner_finish(yyscanner);
+
+    if (!valid || nliterals == 0) {
+        pfree(buf.data);
+        pfree(literals);
+        return NULL;
+    }
+    appendStringInfoString(&buf, query_string + last_end);
+
+    *literals_p = literals;
+    *nliterals_p = nliterals;
+    return buf.data;
+}
+
+/*
+ * Check that the literals found by auto_parameterize_query_string() are
+ * exactly the constants of the analyzed query, and take the parameter types
+ * from those constants. A literal that is not a constant of its own (ORDER
+ * BY 1, a typmod, the string of a typed literal) or a constant that is not a
+ * literal of the text (an implicit one) makes the query unsuitable.
+ */
+bool auto_parameterize_check_query(Query* query, AutoParamLiteral* literals, int nliterals)
+{
+    pgssJumbleState jstate;
+    int j = 0;
+    errno_t rc;
+
+    if (query->utilityStmt != NULL) {
+        return false;
+    }
+
+    rc = memset_s(&jstate, sizeof(jstate), 0, sizeof(jstate));
+    securec_check(rc, "\0", "\0");
+    UniqueSql::generate_jstate(&jstate, query);
+    if (jstate.clocations_count > 1) {
+        qsort(jstate.clocations, jstate.clocations_count, sizeof(pgssLocationLen), UniqueSql::comp_location);
+    }
+
+    for (int i = 0; i < nliterals; i++) {
+        AutoParamLiteral* lit = &literals[i];
+        int loc;
+        Oid type;
+
+        if (j >= jstate.clocations_count) {
+            return false;
+        }
+
+        /* a negative number is one constant located at its sign */
+        loc = jstate.clocations[j].location;
+        if (loc != lit->location && loc != lit->sign_location) {
+            return false;
+        }
+        type = jstate.clocations[j].type;
+
+        /* duplicated constants share the location of their literal */
+        while (j < jstate.clocations_count && jstate.clocations[j].location == loc) {
+            if (jstate.clocations[j].type != type) {
+                return false;
+            }
+            j++;
+        }
+
+        if (type == InvalidOid || type == UNKNOWNOID) {
+            return false;
+        }
+        if (lit->valtype == T_Integer && type != INT4OID) {
+            return false;
+        }
+        if (lit->valtype == T_Float && type != INT8OID && type != NUMERICOID) {
+            return false;
+        }
+        lit->type = type;
+    }
+
+    return (j == jstate.clocations_count);
+}
@@ -163,6 +163,7 @@ static void show_merge_sort_keys(PlanState* state, List* ancestors, ExplainState
 static void show_sort_info(SortState* sortstate, ExplainState* es);
 static void show_hash_info(HashState* hashstate, ExplainState* es);
 static void show_vechash_info(VecHashJoinState* hashstate, ExplainState* es);
+static void show_partition_pruning(PartIteratorState* pistate, ExplainState* es, bool is_pretty);
 static void show_instrumentation_count(const char* qlabel, int which, const PlanState* planstate, ExplainState* es);
 static void show_removed_rows(int which, const PlanState* planstate, int idx, int smpIdx, int* removeRows);
 static void show_foreignscan_info(ForeignScanState* fsstate, ExplainState* es);
@@ -171,6 +172,7 @@ static void show_detail_storage_info_text(Instrumentation* instr, StringInfo ins
 static void show_detail_storage_info_json(Instrumentation* instr, StringInfo instr_info, ExplainState* es);
 static void show_storage_filter_info(PlanState* planstate, ExplainState* es);
 static void show_llvm_info(const PlanState* planstate, ExplainState* es);
+static void show_spill_compress_info(const PlanState* planstate, ExplainState* es);
 static void show_modifytable_merge_info(const PlanState* planstate, ExplainState* es);
 static void show_recursive_info(RecursiveUnionState* rustate, ExplainState* es);
 static const char* explain_get_index_name(Oid indexId);
@@ -1444,6 +1446,47 @@ static void show_bucket_info(PlanState* planstate, ExplainState* es, bool is_pre
     }
 }
 
+/*
+ * Show the partitions a PartIterator pruned at run time: those pruned at
+ * executor start with bound parameters, and with ANALYZE the average of
+ * those pruned on rescans with outer values.
+ */
+static void show_partition_pruning(PartIteratorState* pistate, ExplainState* es, bool is_pretty)
+{
+    double pruned_per_loop = 0;
+    bool show_start = pistate->prunedAtStart >= 0;
+    bool show_loops = es->analyze && pistate->numPrunings > 0;
+
+    if (show_loops)
+        pruned_per_loop = pistate->numPruned / pistate->numPrunings;
+
+    if (es->format == EXPLAIN_FORMAT_TEXT) {
+        StringInfo str = es->str;
+
+        if (is_pretty) {
+            es->planinfo->m_detailInfo->set_plan_name<true, true>();
+            str = es->planinfo->m_detailInfo->info_str;
+        } else if (es->wlm_statistics_plan_max_digit) {
+            appendStringInfoSpaces(es->str, *es->wlm_statistics_plan_max_digit);
+            appendStringInfoString(es->str, " | ");
+            appendStringInfoSpaces(es->str, es->indent);
+        } else {
+            appendStringInfoSpaces(es->str, es->indent * 2);
+        }
+
+        if (show_start)
+            appendStringInfo(str, "Partitions Pruned at Start: %d", pistate->prunedAtStart);
+        if (show_loops)
+            appendStringInfo(str, "%sPartitions Pruned per Loop: %.0f", show_start ? ", " : "", pruned_per_loop);
+        appendStringInfoChar(str, '\n');
+    } else {
+        if (show_start)
+            ExplainPropertyInteger("Partitions Pruned at Start", pistate->prunedAtStart, es);
+        if (show_loops)
+            ExplainPropertyFloat("Partitions Pruned per Loop", pruned_per_loop, 0, es);
+    }
+}
+
 static void show_pruning_info(PlanState* planstate, ExplainState* es, bool is_pretty)
 {
     Scan* scanplan = (Scan*)planstate->plan;
@@ -2221,6 +2264,11 @@ static void ExplainNode(
             show_scan_qual(plan->qual, "Filter", planstate, ancestors, es);
             if (plan->qual)
                 show_instrumentation_count("Rows Removed by Filter", 1, planstate, es);
+            show_bloomfilter<false>(plan, planstate, ancestors, es);
+            if (plan->var_list)
+                show_instrumentation_count("Rows Removed by Runtime Filter", 4, planstate, es);
+            if (es->analyze && ((IndexScan*)plan)->indexskipscan)
+                ExplainPropertyLong("Index Skips", ((IndexScanState*)planstate)->iss_NumSkips, es);
             break;
         case T_IndexOnlyScan:
             show_scan_qual(((IndexOnlyScan*)plan)->indexqual, "Index Cond", planstate, ancestors, es);
@@ -2232,9 +2280,13 @@ static void ExplainNode(
                 show_instrumentation_count("Rows Removed by Filter", 1, planstate, es);
             if (es->analyze)
                 ExplainPropertyLong("Heap Fetches", ((IndexOnlyScanState*)planstate)->ioss_HeapFetches, es);
+            if (es->analyze && ((IndexOnlyScan*)plan)->indexskipscan)
+                ExplainPropertyLong("Index Skips", ((IndexOnlyScanState*)planstate)->ioss_NumSkips, es);
             break;
         case T_BitmapIndexScan:
             show_scan_qual(((BitmapIndexScan*)plan)->indexqualorig, "Index Cond", planstate, ancestors, es);
+            if (es->analyze && ((BitmapIndexScan*)plan)->indexskipscan)
+                ExplainPropertyLong("Index Skips", ((BitmapIndexScanState*)planstate)->biss_NumSkips, es);
             break;
         case T_CStoreIndexCtidScan:
             show_scan_qual(((CStoreIndexCtidScan*)plan)->indexqualorig, "Index Cond", planstate, ancestors, es);
@@ -2357,6 +2409,11 @@ static void ExplainNode(
             show_scan_qual(plan->qual, "Filter", planstate, ancestors, es);
             if (plan->qual)
                 show_instrumentation_count("Rows Removed by Filter", 1, planstate, es);
+            if (IsA(plan, SeqScan)) {
+                show_bloomfilter<false>(plan, planstate, ancestors, es);
+                if (plan->var_list)
+                    show_instrumentation_count("Rows Removed by Runtime Filter", 4, planstate, es);
+            }
             show_llvm_info(planstate, es);
             break;
         case T_DfsScan: {
@@ -2491,6 +2548,7 @@ static void ExplainNode(
             show_upper_qual(plan->qual, "Filter", planstate, ancestors, es);
             if (plan->qual)
                 show_instrumentation_count("Rows Removed by Filter", 2, planstate, es);
+            show_bloomfilter<true>(plan, planstate, ancestors, es);
             show_skew_optimization(planstate, es);
         } break;
         case T_VecHashJoin: {
@@ -2535,6 +2593,10 @@ static void ExplainNode(
             show_sort_keys((SortState*)planstate, ancestors, es);
             show_sort_info((SortState*)planstate, es);
             show_llvm_info(planstate, es);
+            show_spill_compress_info(planstate, es);
+            break;
+        case T_Material:
+            show_spill_compress_info(planstate, es);
             break;
         case T_MergeAppend:
             show_merge_append_keys((MergeAppendState*)planstate, ancestors, es);
@@ -2548,6 +2610,7 @@ static void ExplainNode(
             break;
         case T_Hash:
             show_hash_info((HashState*)planstate, es);
+            show_spill_compress_info(planstate, es);
             break;
         case T_SetOp:
         case T_VecSetOp:
@@ -2732,6 +2795,12 @@ static void ExplainNode(
             } else {
                 ExplainPropertyInteger("Iterations", ((PartIterator*)plan)->itrs, es);
             }
+            if (IsA(planstate, PartIteratorState)) {
+                PartIteratorState* pistate = (PartIteratorState*)planstate;
+
+                if (pistate->prunedAtStart >= 0 || (es->analyze && pistate->numPrunings > 0))
+                    show_partition_pruning(pistate, es, is_pretty);
+            }
             break;
 
         default:
@@ -4016,6 +4085,55 @@ static void show_llvm_info(const PlanState* planstate, ExplainState* es)
     }
 }
 
+/*
+ * Brief        : Display the bytes spilled to compressed temp files.
+ * Description  : Sum the raw and compressed spill bytes of Sort, Hash and Material
+ *                over all datanodes, shown only when enable_compress_spill was used.
+ * Input        : planstate, a PlanState struct.
+ *			      es, a ExplainState struct.
+ * Output       : none.
+ * Return Value : none.
+ * Notes        : none.
+ */
+static void show_spill_compress_info(const PlanState* planstate, ExplainState* es)
+{
+    int64 rawSize = 0;
+    int64 compressSize = 0;
+
+    if (!es->analyze)
+        return;
+
+    if (planstate->plan->plan_node_id > 0 && u_sess->instr_cxt.global_instr &&
+        u_sess->instr_cxt.global_instr->isFromDataNode(planstate->plan->plan_node_id)) {
+        for (int i = 0; i < u_sess->instr_cxt.global_instr->getInstruNodeNum(); i++) {
+            Instrumentation* instr = u_sess->instr_cxt.global_instr->getInstrSlot(i, planstate->plan->plan_node_id);
+            if (instr != NULL) {
+                rawSize += instr->sorthashinfo.spill_rawSize;
+                compressSize += instr->sorthashinfo.spill_compressSize;
+            }
+        }
+    } else if (planstate->instrument != NULL) {
+        rawSize = planstate->instrument->sorthashinfo.spill_rawSize;
+        compressSize = planstate->instrument->sorthashinfo.spill_compressSize;
+    }
+
+    if (rawSize == 0)
+        return;
+
+    rawSize = (rawSize + BYTE_PER_KB - 1) / BYTE_PER_KB;
+    compressSize = (compressSize + BYTE_PER_KB - 1) / BYTE_PER_KB;
+    if (es->format == EXPLAIN_FORMAT_TEXT) {
+        appendStringInfoSpaces(es->str, es->indent * 2);
+        appendStringInfo(es->str,
+            "Spill Compression: raw " INT64_FORMAT "kB, compressed " INT64_FORMAT "kB\n",
+            rawSize,
+            compressSize);
+    } else {
+        ExplainPropertyLong("Spill Raw Size", (long)rawSize, es);
+        ExplainPropertyLong("Spill Compressed Size", (long)compressSize, es);
+    }
+}
+
 /*
  * @Description: show datanode filenum and respill info
  * @in es: current explainstate
@@ -6877,7 +6995,8 @@ static void show_datanode_time(ExplainState* es, PlanState* planstate)
 /*
  * If it's EXPLAIN ANALYZE, show instrumentation information for a plan node
  *
- * "which" identifies which instrumentation counter to print
+ * "which" identifies which instrumentation counter to print, 4 is the rows
+ * removed by runtime join filters
  */
 static void show_instrumentation_count(const char* qlabel, int which, const PlanState* planstate, ExplainState* es)
 {
@@ -6904,6 +7023,8 @@ static void show_instrumentation_count(const char* qlabel, int which, const Plan
                         nfiltered += instr->nfiltered1;
                     else if (which == 2)
                         nfiltered += instr->nfiltered2;
+                    else if (which == 4)
+                        nfiltered += instr->bloomFilterRows + instr->minmaxFilterRows;
                 }
             }
         }
@@ -6912,6 +7033,8 @@ static void show_instrumentation_count(const char* qlabel, int which, const Plan
             nfiltered = planstate->instrument->nfiltered1;
         else if (which == 2)
             nfiltered = planstate->instrument->nfiltered2;
+        else if (which == 4)
+            nfiltered = planstate->instrument->bloomFilterRows + planstate->instrument->minmaxFilterRows;
     }
 
     if (t_thrd.explain_cxt.explain_perf_mode == EXPLAIN_NORMAL &&
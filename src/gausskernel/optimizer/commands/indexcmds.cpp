@@ -183,6 +183,8 @@ bool CheckIndexCompatible(Oid oldId, char* accessMethodName, List* attributeList
      * later on, and it would have failed then anyway.
      */
     indexInfo = makeNode(IndexInfo);
+    indexInfo->ii_NumIndexAttrs = numberOfAttributes;
+    indexInfo->ii_NumIndexKeyAttrs = numberOfAttributes;
     indexInfo->ii_Expressions = NIL;
     indexInfo->ii_ExpressionsState = NIL;
     indexInfo->ii_PredicateState = NIL;
@@ -221,6 +223,15 @@ bool CheckIndexCompatible(Oid oldId, char* accessMethodName, List* attributeList
         return false;
     }
 
+    /*
+     * The included columns keep the type of the table column in the index
+     * tuples, so assume incompatibility for an index having some.
+     */
+    if (GetIndexKeyAttsByTuple(NULL, tuple) != indexForm->indnatts) {
+        ReleaseSysCache(tuple);
+        return false;
+    }
+
     /* Any change in operator class or collation breaks compatibility. */
     old_natts = indexForm->indnatts;
     Assert(old_natts == numberOfAttributes);
@@ -321,6 +332,8 @@ Oid DefineIndex(Oid relationId, IndexStmt* stmt, Oid indexRelationId, bool is_al
     int16* coloptions = NULL;
     IndexInfo* indexInfo = NULL;
     int numberOfAttributes = 0;
+    int numberOfKeyAttributes = 0;
+    List* allIndexParams = NIL;
     VirtualTransactionId* old_lockholders = NULL;
     VirtualTransactionId* old_snapshots = NULL;
     int n_old_snapshots = 0;
@@ -334,11 +347,13 @@ Oid DefineIndex(Oid relationId, IndexStmt* stmt, Oid indexRelationId, bool is_al
     List* partitiontspList = NIL;
 
     /*
-     * count attributes in index
+     * count attributes in index, the included columns follow the key columns
      */
-    numberOfAttributes = list_length(stmt->indexParams);
-    if (numberOfAttributes <= 0)
+    numberOfKeyAttributes = list_length(stmt->indexParams);
+    if (numberOfKeyAttributes <= 0)
         ereport(ERROR, (errcode(ERRCODE_INVALID_OBJECT_DEFINITION), errmsg("must specify at least one column")));
+    allIndexParams = list_concat(list_copy(stmt->indexParams), list_copy(stmt->indexIncludingParams));
+    numberOfAttributes = list_length(allIndexParams);
     if (numberOfAttributes > INDEX_MAX_KEYS)
         ereport(ERROR,
             (errcode(ERRCODE_TOO_MANY_COLUMNS), errmsg("cannot use more than %d columns in an index", INDEX_MAX_KEYS)));
@@ -534,7 +549,7 @@ Oid DefineIndex(Oid relationId, IndexStmt* stmt, Oid indexRelationId, bool is_al
             int2vector* partKey = ((RangePartitionMap*)rel->partMap)->partitionKey;
             int j = 0;
 
-            if (partKey->dim1 > numberOfAttributes) {
+            if (partKey->dim1 > numberOfKeyAttributes) {
                 ereport(ERROR,
                     (errcode(ERRCODE_INVALID_OBJECT_DEFINITION),
                         errmsg("unique index columns must contain the partition key")));
@@ -569,7 +584,7 @@ Oid DefineIndex(Oid relationId, IndexStmt* stmt, Oid indexRelationId, bool is_al
     /*
      * Choose the index column names.
      */
-    indexColNames = ChooseIndexColumnNames(stmt->indexParams);
+    indexColNames = ChooseIndexColumnNames(allIndexParams);
 
     /*
      * Select name for index if caller didn't specify
@@ -613,6 +628,13 @@ Oid DefineIndex(Oid relationId, IndexStmt* stmt, Oid indexRelationId, bool is_al
         ereport(ERROR,
             (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
                 errmsg("access method \"%s\" does not support unique indexes", accessMethodName)));
+    if (stmt->indexIncludingParams != NIL && t_thrd.proc->workingVersionNum < INCLUDE_INDEX_VERSION_NUM)
+        ereport(ERROR,
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED), errmsg("INCLUDE is not supported in current version!")));
+    if (stmt->indexIncludingParams != NIL && accessMethodId != BTREE_AM_OID)
+        ereport(ERROR,
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                errmsg("access method \"%s\" does not support included columns", accessMethodName)));
     if (numberOfAttributes > 1 && !accessMethodForm->amcanmulticol)
         ereport(ERROR,
             (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
@@ -646,6 +668,7 @@ Oid DefineIndex(Oid relationId, IndexStmt* stmt, Oid indexRelationId, bool is_al
      */
     indexInfo = makeNode(IndexInfo);
     indexInfo->ii_NumIndexAttrs = numberOfAttributes;
+    indexInfo->ii_NumIndexKeyAttrs = numberOfKeyAttributes;
     indexInfo->ii_Expressions = NIL; /* for now */
     indexInfo->ii_ExpressionsState = NIL;
     indexInfo->ii_Predicate = make_ands_implicit((Expr*)stmt->whereClause);
@@ -669,7 +692,7 @@ Oid DefineIndex(Oid relationId, IndexStmt* stmt, Oid indexRelationId, bool is_al
         collationObjectId,
         classObjectId,
         coloptions,
-        stmt->indexParams,
+        allIndexParams,
         stmt->excludeOpNames,
         relationId,
         accessMethodName,
@@ -689,8 +712,8 @@ Oid DefineIndex(Oid relationId, IndexStmt* stmt, Oid indexRelationId, bool is_al
     if (IS_PGXC_COORDINATOR) {
         List* indexAttrs = NIL;
 
-        /* Prepare call for shippability evaluation */
-        for (i = 0; i < indexInfo->ii_NumIndexAttrs; i++) {
+        /* Prepare call for shippability evaluation, the included columns are not unique */
+        for (i = 0; i < indexInfo->ii_NumIndexKeyAttrs; i++) {
             /*
              * Expression attributes are set at 0, and do not make sense
              * when comparing them to distribution columns, so bypass.
@@ -1373,10 +1396,11 @@ static void ComputeIndexAttrs(IndexInfo* indexInfo, Oid* typeOidP, Oid* collatio
     ListCell* nextExclOp = NULL;
     ListCell* lc = NULL;
     int attn;
+    int nkeycols = indexInfo->ii_NumIndexKeyAttrs;
 
     /* Allocate space for exclusion operator info, if needed */
     if (exclusionOpNames != NULL) {
-        int ncols = list_length(attList);
+        int ncols = nkeycols;
 
         Assert(list_length(exclusionOpNames) == ncols);
         indexInfo->ii_ExclusionOps = (Oid*)palloc(sizeof(Oid) * ncols);
@@ -1425,6 +1449,12 @@ static void ComputeIndexAttrs(IndexInfo* indexInfo, Oid* typeOidP, Oid* collatio
             Node* expr = attribute->expr;
 
             Assert(expr != NULL);
+
+            /* the included columns are not transformed, they are plain columns */
+            if (attn >= nkeycols)
+                ereport(ERROR,
+                    (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                        errmsg("expressions are not supported in included columns")));
             atttype = exprType(expr);
             attcollation = exprCollation(expr);
 
@@ -1472,6 +1502,35 @@ static void ComputeIndexAttrs(IndexInfo* indexInfo, Oid* typeOidP, Oid* collatio
 
         typeOidP[attn] = atttype;
 
+        /*
+         * Included columns are only stored in the index, they have no
+         * collation, opclass nor ordering.
+         */
+        if (attn >= nkeycols) {
+            if (attribute->collation)
+                ereport(ERROR,
+                    (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                        errmsg("included column does not support a collation")));
+            if (attribute->opclass)
+                ereport(ERROR,
+                    (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                        errmsg("included column does not support an operator class")));
+            if (attribute->ordering != SORTBY_DEFAULT)
+                ereport(ERROR,
+                    (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                        errmsg("included column does not support ASC/DESC options")));
+            if (attribute->nulls_ordering != SORTBY_NULLS_DEFAULT)
+                ereport(ERROR,
+                    (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                        errmsg("included column does not support NULLS FIRST/LAST options")));
+
+            collationOidP[attn] = InvalidOid;
+            classOidP[attn] = InvalidOid;
+            colOptionP[attn] = 0;
+            attn++;
+            continue;
+        }
+
         /*
          * Apply collation override if any
          */
@@ -17,10 +17,12 @@
 #include "postgres.h"
 #include "knl/knl_variable.h"
 
+#include "access/hash.h"
 #include "access/xact.h"
 #include "catalog/pg_type.h"
 #include "commands/createas.h"
 #include "commands/prepare.h"
+#include "instruments/unique_query.h"
 #include "miscadmin.h"
 #include "nodes/nodeFuncs.h"
 #include "opfusion/opfusion.h"
@@ -29,12 +31,15 @@
 #include "parser/parse_collate.h"
 #include "parser/parse_expr.h"
 #include "parser/parse_type.h"
+#include "parser/parser.h"
 #include "rewrite/rewriteHandler.h"
 #include "tcop/pquery.h"
+#include "tcop/tcopprot.h"
 #include "tcop/utility.h"
 #include "utils/builtins.h"
 #include "utils/dynahash.h"
 #include "utils/globalplancache.h"
+#include "utils/memutils.h"
 #include "utils/snapmgr.h"
 #include "utils/timestamp.h"
 #ifdef PGXC
@@ -70,6 +75,7 @@ void PrepareQuery(PrepareStmt* stmt, const char* queryString)
     if (!stmt->name || stmt->name[0] == '\0')
         ereport(ERROR,
             (errcode(ERRCODE_INVALID_PSTATEMENT_DEFINITION), errmsg("invalid statement name: must not be empty")));
+    CheckPreparedStatementName(stmt->name);
 
     /*
      * Create the CachedPlanSource before we do parse analysis, since it needs
@@ -166,6 +172,296 @@ void PrepareQuery(PrepareStmt* stmt, const char* queryString)
     StorePreparedStatement(stmt->name, plansource, true);
 }
 
+/* upper limit of the shapes remembered as unsuitable for auto-parameterization */
+#define AUTO_PARAM_MAX_REJECTS 1024
+
+/* a statement made by auto-parameterization, by the hash of its text */
+typedef struct AutoParamStatement {
+    uint32 shape;
+    Dlelem lru_elem;
+} AutoParamStatement;
+
+static void AutoParamStatementName(uint32 shape, char* stmt_name)
+{
+    errno_t rc = snprintf_s(stmt_name, NAMEDATALEN, NAMEDATALEN - 1, AUTO_PARAM_STMT_PREFIX "%08x", shape);
+    securec_check_ss(rc, "\0", "\0");
+}
+
+/*
+ * Mark the statement of the shape as the most recently used one, and
+ * deallocate the least recently used statements beyond
+ * auto_param_max_statements.
+ *
+ * A statement deallocated by the user is still listed, it is prepared again
+ * the next time its shape is seen, or dropped as a no-op when evicted.
+ */
+static void AutoParamTouch(uint32 shape)
+{
+    knl_u_plancache_context* pcache = &u_sess->pcache_cxt;
+    AutoParamStatement* stmt = NULL;
+    bool found = false;
+
+    if (pcache->auto_param_stmts == NULL) {
+        HASHCTL hash_ctl;
+        errno_t rc = memset_s(&hash_ctl, sizeof(hash_ctl), 0, sizeof(hash_ctl));
+        securec_check(rc, "\0", "\0");
+
+        hash_ctl.keysize = sizeof(uint32);
+        hash_ctl.entrysize = sizeof(AutoParamStatement);
+        hash_ctl.hash = uint32_hash;
+        hash_ctl.hcxt = u_sess->cache_mem_cxt;
+
+        pcache->auto_param_stmts = hash_create("Auto Parameterization Statements",
+            64, &hash_ctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+    }
+
+    stmt = (AutoParamStatement*)hash_search(pcache->auto_param_stmts, &shape, HASH_ENTER, &found);
+    if (found) {
+        DLMoveToFront(&stmt->lru_elem);
+        return;
+    }
+    DLInitElem(&stmt->lru_elem, stmt);
+    DLAddHead(&pcache->auto_param_lru, &stmt->lru_elem);
+
+    while (DLListLength(&pcache->auto_param_lru) > (uint64)u_sess->attr.attr_sql.auto_param_max_statements) {
+        uint32 victim = ((AutoParamStatement*)DLE_VAL(DLRemTail(&pcache->auto_param_lru)))->shape;
+        char stmt_name[NAMEDATALEN];
+
+        (void)hash_search(pcache->auto_param_stmts, &victim, HASH_REMOVE, NULL);
+        AutoParamStatementName(victim, stmt_name);
+        DropPreparedStatement(stmt_name, false);
+    }
+}
+
+static bool AutoParamRejected(uint32 shape)
+{
+    if (u_sess->pcache_cxt.auto_param_rejects == NULL)
+        return false;
+
+    return (hash_search(u_sess->pcache_cxt.auto_param_rejects, &shape, HASH_FIND, NULL) != NULL);
+}
+
+static void AutoParamReject(uint32 shape)
+{
+    if (u_sess->pcache_cxt.auto_param_rejects == NULL) {
+        HASHCTL hash_ctl;
+        errno_t rc = memset_s(&hash_ctl, sizeof(hash_ctl), 0, sizeof(hash_ctl));
+        securec_check(rc, "\0", "\0");
+
+        hash_ctl.keysize = sizeof(uint32);
+        hash_ctl.entrysize = sizeof(uint32);
+        hash_ctl.hash = uint32_hash;
+        hash_ctl.hcxt = u_sess->cache_mem_cxt;
+
+        u_sess->pcache_cxt.auto_param_rejects = hash_create("Auto Parameterization Rejects",
+            64, &hash_ctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+    }
+
+    if (hash_get_num_entries(u_sess->pcache_cxt.auto_param_rejects) < AUTO_PARAM_MAX_REJECTS)
+        (void)hash_search(u_sess->pcache_cxt.auto_param_rejects, &shape, HASH_ENTER, NULL);
+}
+
+/*
+ * Whether some part of the query matches expressions with each other, which
+ * does not work once the literals are replaced by distinct parameters.
+ */
+static bool AutoParamUnsafeWalker(Node* node, void* context)
+{
+    if (node == NULL)
+        return false;
+
+    if (IsA(node, Query)) {
+        Query* query = (Query*)node;
+
+        if (query->groupClause != NIL || query->groupingSets != NIL || query->distinctClause != NIL ||
+            query->windowClause != NIL || query->havingQual != NULL)
+            return true;
+
+        return query_tree_walker(query, (bool (*)())AutoParamUnsafeWalker, context, 0);
+    }
+
+    return expression_tree_walker(node, (bool (*)())AutoParamUnsafeWalker, context);
+}
+
+/*
+ * Prepare the parameterized text of a simple query as the statement
+ * stmt_name. The original query is analyzed first to check that the
+ * literals of the text map to its constants one to one.
+ *
+ * Returns false if the query is not suitable.
+ */
+static bool AutoParamPrepare(Node* parsetree, const char* query_string, const char* param_string,
+    const char* stmt_name, AutoParamLiteral* literals, int nliterals)
+{
+    MemoryContext oldcontext = CurrentMemoryContext;
+    ResourceOwner oldowner = t_thrd.utils_cxt.CurrentResourceOwner;
+    Query* query = NULL;
+    Oid* argtypes = NULL;
+    bool suitable = false;
+
+    switch (nodeTag(parsetree)) {
+        case T_SelectStmt:
+            if (((SelectStmt*)parsetree)->intoClause != NULL)
+                return false;
+            break;
+        case T_InsertStmt:
+        case T_UpdateStmt:
+        case T_DeleteStmt:
+            break;
+        default:
+            return false;
+    }
+
+    PushActiveSnapshot(GetTransactionSnapshot());
+    query = parse_analyze((Node*)copyObject(parsetree), query_string, NULL, 0);
+    suitable = auto_parameterize_check_query(query, literals, nliterals) &&
+        !AutoParamUnsafeWalker((Node*)query, NULL);
+    if (!suitable) {
+        PopActiveSnapshot();
+        return false;
+    }
+
+    argtypes = (Oid*)palloc(nliterals * sizeof(Oid));
+    for (int i = 0; i < nliterals; i++)
+        argtypes[i] = literals[i].type;
+
+    /*
+     * The parameterized text may still be rejected by the analysis where the
+     * original is not, so prepare it in a subtransaction.
+     */
+    BeginInternalSubTransaction(NULL);
+    MemoryContextSwitchTo(oldcontext);
+    PG_TRY();
+    {
+        List* raw_list = raw_parser(param_string);
+        Node* raw = NULL;
+        CachedPlanSource* plansource = NULL;
+        List* query_list = NIL;
+
+        if (list_length(raw_list) != 1)
+            ereport(ERROR,
+                (errcode(ERRCODE_INVALID_PSTATEMENT_DEFINITION), errmsg("unexpected parameterized query")));
+        raw = (Node*)linitial(raw_list);
+
+        plansource = CreateCachedPlan(raw,
+            param_string,
+#ifdef PGXC
+            stmt_name,
+#endif
+            CreateCommandTag(raw));
+        query = parse_analyze((Node*)copyObject(raw), param_string, argtypes, nliterals);
+        query_list = QueryRewrite(query);
+        CompleteCachedPlan(plansource, query_list, NULL, argtypes, nliterals, NULL, NULL, 0, true, stmt_name);
+        StorePreparedStatement(stmt_name, plansource, false);
+
+        ReleaseCurrentSubTransaction();
+        MemoryContextSwitchTo(oldcontext);
+        t_thrd.utils_cxt.CurrentResourceOwner = oldowner;
+    }
+    PG_CATCH();
+    {
+        MemoryContextSwitchTo(oldcontext);
+        ErrorData* edata = CopyErrorData();
+        ereport(DEBUG1, (errmsg("could not auto-parameterize query: %s", edata->message)));
+        FreeErrorData(edata);
+        FlushErrorState();
+
+        RollbackAndReleaseCurrentSubTransaction();
+        MemoryContextSwitchTo(oldcontext);
+        t_thrd.utils_cxt.CurrentResourceOwner = oldowner;
+        suitable = false;
+    }
+    PG_END_TRY();
+
+    PopActiveSnapshot();
+    return suitable;
+}
+
+/*
+ * Parse a simple query, replacing its literals by parameters when enabled.
+ *
+ * The literals of a single SELECT/INSERT/UPDATE/DELETE are replaced by $n and
+ * the resulting text is kept as a prepared statement named after its hash,
+ * so the next query differing only in the literals skips the parse analysis
+ * and the planning: it is returned as an EXECUTE of that statement, with the
+ * literals as parameters. The cached plan still chooses between custom and
+ * generic plans as for any prepared statement. With the global plan cache,
+ * the statement is shared with the other sessions. A session keeps at most
+ * auto_param_max_statements of them, they are not shown by
+ * pg_prepared_statements.
+ *
+ * Anything else is parsed as usual.
+ */
+List* AutoParameterizeQuery(const char* query_string, List** query_string_locationlist)
+{
+    AutoParamLiteral* literals = NULL;
+    int nliterals = 0;
+    char* param_string = NULL;
+    char stmt_name[NAMEDATALEN];
+    uint32 shape;
+    PreparedStatement* entry = NULL;
+    List* parsetree_list = NIL;
+    ExecuteStmt* execstmt = NULL;
+
+    if (!u_sess->attr.attr_sql.enable_auto_parameterization || IS_PGXC_COORDINATOR ||
+        IsAbortedTransactionBlockState())
+        return pg_parse_query(query_string, query_string_locationlist);
+
+    param_string = auto_parameterize_query_string(query_string, &literals, &nliterals);
+    if (param_string == NULL)
+        return pg_parse_query(query_string, query_string_locationlist);
+
+    shape = DatumGetUInt32(hash_any((const unsigned char*)param_string, strlen(param_string)));
+    if (AutoParamRejected(shape))
+        return pg_parse_query(query_string, query_string_locationlist);
+
+    AutoParamStatementName(shape, stmt_name);
+
+    entry = FetchPreparedStatement(stmt_name, false);
+    if (entry == NULL && ENABLE_DN_GPC) {
+        GPCEnv* env = GPC->PlanFetch(param_string, strlen(param_string), nliterals);
+
+        if (env != NULL) {
+            GPC->PrepareStore(stmt_name, env->plansource, false);
+            GPC->RefcountAdd(env->plansource);
+            entry = FetchPreparedStatement(stmt_name, false);
+        }
+    }
+
+    if (entry == NULL) {
+        parsetree_list = pg_parse_query(query_string, query_string_locationlist);
+        if (list_length(parsetree_list) != 1)
+            return parsetree_list;
+
+        if (!AutoParamPrepare((Node*)linitial(parsetree_list), query_string, param_string, stmt_name, literals,
+            nliterals)) {
+            AutoParamReject(shape);
+            return parsetree_list;
+        }
+    } else if (entry->plansource->num_params != nliterals ||
+               strcmp(entry->plansource->query_string, param_string) != 0) {
+        /* hash collision with another statement */
+        return pg_parse_query(query_string, query_string_locationlist);
+    }
+    AutoParamTouch(shape);
+
+    execstmt = makeNode(ExecuteStmt);
+    execstmt->name = pstrdup(stmt_name);
+    for (int i = 0; i < nliterals; i++) {
+        A_Const* con = makeNode(A_Const);
+
+        con->val.type = literals[i].valtype;
+        if (literals[i].valtype == T_Integer)
+            con->val.val.ival = pg_atoi(literals[i].value, sizeof(int32), '\0');
+        else
+            con->val.val.str = literals[i].value;
+        con->location = -1;
+        execstmt->params = lappend(execstmt->params, con);
+    }
+
+    return list_make1(execstmt);
+}
+
 /*
  * ExecuteQuery --- implement the 'EXECUTE' utility statement.
  *
@@ -564,6 +860,19 @@ DatanodeStatement* light_set_datanode_queries(const char* stmt_name)
 }
 #endif
 
+/*
+ * Reject the names reserved for the statements made by auto-parameterization,
+ * so PREPARE and the Parse message can not take or replace one of them.
+ */
+void CheckPreparedStatementName(const char* stmt_name)
+{
+    if (IsAutoParamStatementName(stmt_name))
+        ereport(ERROR,
+            (errcode(ERRCODE_RESERVED_NAME),
+                errmsg("invalid statement name \"%s\"", stmt_name),
+                errdetail("The prefix \"%s\" is reserved for auto-parameterized queries.", AUTO_PARAM_STMT_PREFIX)));
+}
+
 /*
  * Store all the data pertaining to a query in the hash table using
  * the specified key.  The passed CachedPlanSource should be "unsaved"
@@ -619,10 +928,10 @@ PreparedStatement* FetchPreparedStatement(const char* stmt_name, bool throwError
                      errmsg("prepared statement \"%s\" does not exist",
                             stmt_name)));
 
-        if (u_sess->pcache_cxt.gpc_in_ddl == true ||
+        if (entry != NULL && (u_sess->pcache_cxt.gpc_in_ddl == true ||
             (entry->plansource->gpc.entry != NULL && entry->plansource->gpc.entry->is_valid == false) ||
             entry->plansource->dependsOnRole == true ||
-            (entry->plansource->gplan != NULL && TransactionIdIsValid(entry->plansource->gplan->saved_xmin))) {
+            (entry->plansource->gplan != NULL && TransactionIdIsValid(entry->plansource->gplan->saved_xmin)))) {
             GPC->RecreateCachePlan(entry);
         }
 
@@ -1026,6 +1335,10 @@ Datum pg_prepared_statement(PG_FUNCTION_ARGS)
             Datum values[5];
             bool nulls[5];
 
+            /* the statements of auto-parameterized queries are not the user's */
+            if (IsAutoParamStatementName(prep_stmt->stmt_name))
+                continue;
+
             errno_t rc = memset_s(nulls, sizeof(nulls), 0, sizeof(nulls));
             securec_check(rc, "\0", "\0");
 
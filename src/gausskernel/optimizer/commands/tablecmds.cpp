@@ -8003,10 +8003,11 @@ static void ATExecDropNotNull(Relation rel, const char* colName, LOCKMODE lockmo
         /* If the index is not a primary key, skip the check */
         if (indexStruct->indisprimary) {
             /*
-             * Loop over each attribute in the primary key and see if it
+             * Loop over each key attribute in the primary key and see if it
              * matches the to-be-altered attribute
              */
-            for (i = 0; i < indexStruct->indnatts; i++) {
+            int nkeyatts = GetIndexKeyAttsByTuple(NULL, indexTuple);
+            for (i = 0; i < nkeyatts; i++) {
                 if (indexStruct->indkey.values[i] == attnum)
                     ereport(ERROR,
                         (errcode(ERRCODE_INVALID_TABLE_DEFINITION),
@@ -9723,7 +9724,8 @@ static int transformFkeyGetPrimaryKey(
      * assume a primary key cannot have expressional elements)
      */
     *attnamelist = NIL;
-    for (i = 0; i < indexStruct->indnatts; i++) {
+    int nkeyatts = GetIndexKeyAttsByTuple(NULL, indexTuple);
+    for (i = 0; i < nkeyatts; i++) {
         int pkattno = indexStruct->indkey.values[i];
 
         attnums[i] = pkattno;
@@ -9774,11 +9776,12 @@ static Oid transformFkeyCheckAttrs(Relation pkrel, int numattrs, int16* attnums,
         indexStruct = (Form_pg_index)GETSTRUCT(indexTuple);
 
         /*
-         * Must have the right number of columns; must be unique and not a
+         * Must have the right number of key columns; must be unique and not a
          * partial index; forget it if there are any expressions, too. Invalid
          * indexes are out as well.
          */
-        if (indexStruct->indnatts == numattrs && indexStruct->indisunique && IndexIsValid(indexStruct) &&
+        if (GetIndexKeyAttsByTuple(NULL, indexTuple) == numattrs && indexStruct->indisunique &&
+            IndexIsValid(indexStruct) &&
             heap_attisnull(indexTuple, Anum_pg_index_indpred, NULL) &&
             heap_attisnull(indexTuple, Anum_pg_index_indexprs, NULL)) {
             /* Must get indclass the hard way */
@@ -14207,8 +14210,8 @@ static void ATExecReplicaIdentity(Relation rel, ReplicaIdentityStmt* stmt, LOCKM
             (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
                 errmsg("cannot use invalid index \"%s\" as replica identity", RelationGetRelationName(indexRel))));
 
-    /* Check index for nullable columns. */
-    for (key = 0; key < indexRel->rd_index->indnatts; key++) {
+    /* Check index for nullable columns, the included columns do not identify the row. */
+    for (key = 0; key < IndexRelationGetNumberOfKeyAttributes(indexRel); key++) {
         int16 attno = indexRel->rd_index->indkey.values[key];
         Form_pg_attribute attr;
 
@@ -18302,6 +18305,8 @@ static void checkIndexForExchange(
             ReleaseSysCache(partTableIndexClassTuple);
             ReleaseSysCache(ordTableIndexClassTuple);
             if ((ordTalbeIndexForm->indnatts == partTalbeIndexForm->indnatts) &&
+                (GetIndexKeyAttsByTuple(NULL, ordTableIndexTuple) ==
+                    GetIndexKeyAttsByTuple(NULL, partTalbeIndexTuple)) &&
                 (ordTalbeIndexForm->indisunique == partTalbeIndexForm->indisunique) &&
                 (ordTalbeIndexForm->indisprimary == partTalbeIndexForm->indisprimary)) {
                 int i = 0;
@@ -4,24 +4,23 @@
  *	  Concurrent ("lazy") vacuuming.
  *
  *
- * The major space usage for LAZY VACUUM is storage for the array of dead
- * tuple TIDs, with the next biggest need being storage for per-disk-page
- * free space info.  We want to ensure we can vacuum even the very largest
- * relations with finite memory space usage.  To do that, we set upper bounds
- * on the number of tuples and pages we will keep track of at once.
+ * The major space usage for LAZY VACUUM is storage for the dead tuple TIDs,
+ * with the next biggest need being storage for per-disk-page free space info.
+ * We want to ensure we can vacuum even the very largest relations with finite
+ * memory space usage.  To do that, we set upper bounds on the number of
+ * tuples and pages we will keep track of at once.
  *
  * We are willing to use at most maintenance_work_mem memory space to keep
- * track of dead tuples.  We initially allocate an array of TIDs of that size,
- * with an upper limit that depends on table size (this limit ensures we don't
- * allocate a huge area uselessly for vacuuming small tables).	If the array
+ * track of dead tuples.  The TIDs are kept in a dead tuple store of offset
+ * bitmaps per block, which grows as dead tuples are found.  If the store
  * threatens to overflow, we suspend the heap scan phase and perform a pass of
  * index cleanup and page compaction, then resume the heap scan with an empty
- * TID array.
+ * store.
  *
  * If we're processing a table with no indexes, we can just vacuum each page
  * as we go; there's no need to save up multiple tuples to minimize the number
  * of index scans performed.  So we don't use maintenance_work_mem memory for
- * the TID array, just enough to hold as many heap tuples as fit on one page.
+ * the store, just enough to hold as many heap tuples as fit on one page.
  *
  *
  * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
@@ -45,23 +44,36 @@
 #include "access/heapam.h"
 #include "access/transam.h"
 #include "access/visibilitymap.h"
+#include "access/xact.h"
 #include "access/xlog.h"
 #include "catalog/catalog.h"
 #include "catalog/storage.h"
 #include "catalog/pg_hashbucket_fn.h"
 #include "commands/dbcommands.h"
 #include "commands/vacuum.h"
+#include "gssignal/gs_signal.h"
+#include "libpq/pqsignal.h"
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "portability/instr_time.h"
 #include "postmaster/autovacuum.h"
 #include "postmaster/bgwriter.h"
+#include "postmaster/postmaster.h"
+#include "storage/barrier.h"
 #include "storage/bufmgr.h"
 #include "storage/freespace.h"
+#include "storage/ipc.h"
 #include "storage/lmgr.h"
+#include "storage/proc.h"
+#include "storage/procarray.h"
+#include "storage/procsignal.h"
+#include "tcop/tcopprot.h"
+#include "utils/combocid.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/pg_rusage.h"
+#include "utils/postinit.h"
+#include "utils/ps_status.h"
 #include "utils/snapmgr.h"
 #include "utils/timestamp.h"
 #include "utils/tqual.h"
@@ -73,13 +85,6 @@
 #include "pgxc/pgxc.h"
 #endif
 
-/*
- * Guesstimation of number of dead tuples per page.  This is used to
- * provide an upper limit to memory allocated when vacuuming small
- * tables.
- */
-#define LAZY_ALLOC_TUPLES MaxHeapTuplesPerPage
-
 /*
  * Before we consider skipping a page that's marked as clean in
  * visibility map, we must've seen at least this many clean pages.
@@ -87,6 +92,57 @@
 #define SKIP_PAGES_THRESHOLD ((BlockNumber)32)
 
 #define CHANGE_XID_BASE (MaxShortTransactionId * 0.1)
+
+/*
+ * Dead tuple store
+ *
+ * The TIDs of the dead tuples are kept as an offset bitmap per heap block
+ * rather than as an array of ItemPointerData, so a dead tuple takes about a
+ * bit instead of six bytes on a page with many of them.  The heap scan adds
+ * the blocks in increasing order, so the blocks form a sorted array and their
+ * bitmaps are packed one after another.  The heap is divided into chunks of
+ * LV_DEAD_CHUNK_BLOCKS blocks, and a chunk with dead tuples gets a directory
+ * entry holding the position of its first block in the store and a bitmap of
+ * its blocks that are in the store.  The entries are sorted by chunk number
+ * as well, and a lookup binary searches them; the position of a block is then
+ * its chunk's first position plus the number of blocks present before it.
+ */
+#define LV_DEAD_CHUNK_BLOCKS 256
+#define LV_DEAD_CHUNK_WORDS (LV_DEAD_CHUNK_BLOCKS / 64)
+
+typedef struct LVDeadChunk {
+    uint32 chunkno;                      /* heap block number / LV_DEAD_CHUNK_BLOCKS */
+    uint32 first;                        /* position of the first block of the chunk */
+    uint64 present[LV_DEAD_CHUNK_WORDS]; /* blocks of the chunk in the store */
+} LVDeadChunk;
+
+typedef struct LVDeadBlock {
+    BlockNumber blkno;
+    uint32 offset; /* start of the offset bitmap of the block in bitmaps */
+} LVDeadBlock;
+
+typedef struct LVDeadTuples {
+    MemoryContext context;
+    Size maxBytes; /* memory allowed for the store */
+    uint32 nchunks;
+    uint32 maxchunks;
+    LVDeadChunk* chunks;
+    uint32 nblocks;
+    uint32 maxblocks;
+    LVDeadBlock* blocks;
+    uint32 nbytes;
+    uint32 maxbytes;
+    uint8* bitmaps; /* bit n - 1 of a block's bitmap is offset number n */
+} LVDeadTuples;
+
+/* the most memory the dead tuples of one heap page may add to the store */
+#define LV_DEAD_BITMAP_BYTES (MaxHeapTuplesPerPage / BITS_PER_BYTE + 1)
+#define LV_DEAD_PAGE_BYTES (sizeof(LVDeadChunk) + sizeof(LVDeadBlock) + LV_DEAD_BITMAP_BYTES)
+
+/* memory the arrays of the store hold */
+#define LV_DEAD_ALLOCATED(dt) \
+    ((dt)->maxchunks * sizeof(LVDeadChunk) + (dt)->maxblocks * sizeof(LVDeadBlock) + (dt)->maxbytes)
+
 typedef struct LVRelStats {
     /* hasindex = true means two-pass strategy; false means one-pass */
     bool hasindex;
@@ -100,17 +156,16 @@ typedef struct LVRelStats {
     BlockNumber pages_removed;
     double tuples_deleted;
     BlockNumber nonempty_pages; /* actually, last nonempty page + 1 */
-    /* List of TIDs of tuples we intend to delete */
-    /* NB: this list is ordered by TID address */
-    int num_dead_tuples;     /* current # of entries */
-    int max_dead_tuples;     /* # slots allocated in array */
-    ItemPointer dead_tuples; /* array of ItemPointerData */
+    /* TIDs of tuples we intend to delete */
+    int num_dead_tuples;       /* current # of entries */
+    LVDeadTuples* dead_tuples; /* see dead tuple store */
     int num_index_scans;
     TransactionId latestRemovedXid;
     bool lock_waiter_detected;
     BlockNumber* new_idx_pages;
     double* new_idx_tuples;
     bool* idx_estimated;
+    struct LVParallelState* lps; /* parallel index vacuum, NULL if the indexes are vacuumed serially */
 } LVRelStats;
 
 typedef struct ValPrefetchList {
@@ -126,11 +181,78 @@ typedef struct ValPrefetch {
     bool init; /* whether the prefetch list inited done or not */
 } ValPrefetch;
 
+/*
+ * Parallel index vacuum
+ *
+ * With parallel_vacuum_workers and max_parallel_maintenance_workers allowing
+ * it, every pass of index bulk deletion and the final index cleanup are spread
+ * over worker threads.  The workers are started along with the heap scan and
+ * stay until the heap is done.  In each pass the leader and the workers take
+ * the indexes one at a time from a shared counter, so a pass takes about as
+ * long as the largest index.  The dead tuple TIDs are kept in a shared memory
+ * context from the beginning, and so are the statistics of every index, which
+ * lets any participant carry on the statistics of an earlier pass.
+ *
+ * As in a parallel btree build, a worker borrows the leader's transaction and
+ * takes no relation locks, those of the leader cover it.
+ */
+#define LV_PARALLEL_WAIT_INTERVAL 1000 /* ms */
+
+typedef enum { LV_PARALLEL_BULKDELETE = 0, LV_PARALLEL_CLEANUP } LVParallelPhase;
+
+typedef enum { LV_WORKER_STARTING = 0, LV_WORKER_EXITED } LVWorkerState;
+
+/* an index of the heap and its statistics so far */
+typedef struct LVParallelIndex {
+    Oid indexid;
+    bool hasStats;
+    IndexBulkDeleteResult stats;
+    int participant; /* who processed it in the last pass, the leader is 0 */
+} LVParallelIndex;
+
+struct LVParallelState;
+
+typedef struct LVParallelWorker {
+    int id; /* participant number, the leader is 0 */
+    ThreadId tid;
+    PGPROC* volatile proc;
+    volatile LVWorkerState state;
+    struct LVParallelState* shared;
+    bool xactBorrowed;        /* the leader's transaction is in use, worker only */
+    volatile uint32 donePass; /* the last pass the worker is done with */
+    ErrorData* volatile error; /* the error that stopped the worker */
+} LVParallelWorker;
+
+typedef struct LVParallelState {
+    MemoryContext context; /* shared context holding all of this and the dead tuples */
+    Oid dbid;
+    Snapshot snapshot;
+    StreamTxnContext txnCxt; /* the leader's transaction */
+    Latch* leaderLatch;
+    int costDelay; /* cost-based delay of each participant, 0 if inactive */
+    int costLimit;
+    volatile bool shutdown;
+
+    /* the current pass, phase and relstats are set before pass is advanced */
+    pg_atomic_uint32 pass;
+    LVParallelPhase phase;
+    LVRelStats relstats; /* the dead tuples and heap statistics the indexes need */
+    pg_atomic_uint32 nextIndex;
+
+    int nindexes;
+    LVParallelIndex* indexes;
+    int nworkers;
+    LVParallelWorker* workers[MAX_PARALLEL_VACUUM_WORKERS];
+} LVParallelState;
+
 /* A few variables that don't seem worth passing around as parameters */
 static THR_LOCAL int elevel = -1;
 
 static THR_LOCAL BufferAccessStrategy vac_strategy;
 
+static THR_LOCAL LVParallelState* MyLVParallelState = NULL;
+static THR_LOCAL LVParallelWorker* MyLVParallelWorker = NULL;
+
 /* non-export function prototypes */
 static IndexBulkDeleteResult** lazy_scan_heap(
     Relation onerel, LVRelStats* vacrelstats, Relation* Irel, int nindexes, bool scan_all, double* ptrDeleteTupleNum);
@@ -143,11 +265,32 @@ static bool lazy_check_needs_freeze(Buffer buf);
 static void lazy_vacuum_index(Relation indrel, IndexBulkDeleteResult** stats, LVRelStats* vacrelstats);
 static IndexBulkDeleteResult* lazy_cleanup_index(
     Relation indrel, IndexBulkDeleteResult* stats, LVRelStats* vacrelstats);
-static int lazy_vacuum_page(Relation onerel, BlockNumber blkno, Buffer buffer, int tupindex, LVRelStats* vacrelstats);
-static void lazy_space_alloc(LVRelStats* vacrelstats, BlockNumber relblocks);
+static int lazy_vacuum_page(
+    Relation onerel, BlockNumber blkno, Buffer buffer, uint32 blockIndex, LVRelStats* vacrelstats);
+static void lazy_space_alloc(LVRelStats* vacrelstats);
+static void lazy_forget_dead_tuples(LVRelStats* vacrelstats);
 static void lazy_record_dead_tuple(LVRelStats* vacrelstats, ItemPointer itemptr);
 static bool lazy_tid_reaped(ItemPointer itemptr, void* state);
-static int vac_cmp_itemptr(const void* left, const void* right);
+static bool lazy_dead_tuples_full(const LVDeadTuples* dt);
+static void lazy_dead_tuples_add(LVDeadTuples* dt, BlockNumber blkno, OffsetNumber offnum);
+static bool lazy_dead_tuples_lookup(const LVDeadTuples* dt, BlockNumber blkno, OffsetNumber offnum);
+static void* lazy_dead_tuples_enlarge(LVDeadTuples* dt, void* array, uint32* maxitems, uint32 needed, Size itemsize);
+static int lazy_dead_chunk_cmp(const void* key, const void* elem);
+static void lazy_vacuum_indexes(Relation* Irel, int nindexes, IndexBulkDeleteResult** indstats, LVRelStats* vacrelstats);
+static void lazy_cleanup_indexes(
+    Relation* Irel, int nindexes, IndexBulkDeleteResult** indstats, LVRelStats* vacrelstats);
+static int lazy_parallel_workers(Relation onerel, int nindexes);
+static LVParallelState* lazy_parallel_begin(Relation* Irel, int nindexes, int nworkers);
+static void lazy_parallel_end(LVParallelState* lps);
+static void lazy_parallel_stop(LVParallelState* lps);
+static void lazy_parallel_leader_exit(int code, Datum arg);
+static void lazy_parallel_check_workers(LVParallelState* lps);
+static void lazy_parallel_pass(LVParallelState* lps, LVParallelPhase phase, Relation* Irel,
+    IndexBulkDeleteResult** indstats, LVRelStats* vacrelstats);
+static void lazy_parallel_process_indexes(LVParallelState* lps, Relation* Irel, int participant);
+static void lazy_parallel_vacuum_work(LVParallelWorker* worker);
+static void lazy_parallel_worker_detach(int code, Datum arg);
+static void lazy_parallel_worker_exit(int code, Datum arg);
 
 /*
  *	lazy_vacuum_rel() -- perform LAZY VACUUM for one heap relation
@@ -653,6 +796,7 @@ static void lazy_scan_rel(Relation onerel, LVRelStats* vacrelstats, VacuumStmt*
     bool scan_all, double* deleteTupleNum)
 {
     IndexBulkDeleteResult** indstats = NULL;
+    int nworkers;
     int idx;
 
     if (nindexes > 0) {
@@ -660,7 +804,31 @@ static void lazy_scan_rel(Relation onerel, LVRelStats* vacrelstats, VacuumStmt*
         vacrelstats->new_idx_tuples = (double*)palloc0(nindexes * sizeof(double));
         vacrelstats->idx_estimated = (bool*)palloc0(nindexes * sizeof(bool));
     }
-    indstats = lazy_scan_heap(onerel, vacrelstats, Irel, nindexes, scan_all, deleteTupleNum);
+
+    nworkers = lazy_parallel_workers(onerel, nindexes);
+    if (nworkers > 0) {
+        vacrelstats->lps = lazy_parallel_begin(Irel, nindexes, nworkers);
+
+        PG_TRY();
+        {
+            indstats = lazy_scan_heap(onerel, vacrelstats, Irel, nindexes, scan_all, deleteTupleNum);
+        }
+        PG_CATCH();
+        {
+            lazy_parallel_end(vacrelstats->lps);
+            vacrelstats->lps = NULL;
+            PG_RE_THROW();
+        }
+        PG_END_TRY();
+
+        /* the dead tuples go away with the shared context */
+        lazy_parallel_end(vacrelstats->lps);
+        vacrelstats->lps = NULL;
+        vacrelstats->dead_tuples = NULL;
+        vacrelstats->num_dead_tuples = 0;
+    } else {
+        indstats = lazy_scan_heap(onerel, vacrelstats, Irel, nindexes, scan_all, deleteTupleNum);
+    }
 
     /* Vacuum the Free Space Map */
     FreeSpaceMapVacuum(onerel);
@@ -771,7 +939,6 @@ static IndexBulkDeleteResult** lazy_scan_heap(
     BlockNumber empty_pages, vacuumed_pages;
     double num_tuples, tups_vacuumed, nkeep, nunused;
     IndexBulkDeleteResult** indstats;
-    int i;
     PGRUsage ru0;
     Buffer vmbuffer = InvalidBuffer;
     BlockNumber next_not_all_visible_block;
@@ -796,7 +963,7 @@ static IndexBulkDeleteResult** lazy_scan_heap(
     vacrelstats->nonempty_pages = 0;
     vacrelstats->latestRemovedXid = InvalidTransactionId;
 
-    lazy_space_alloc(vacrelstats, nblocks);
+    lazy_space_alloc(vacrelstats);
 
     /*
      * We want to skip pages that don't require vacuuming according to the
@@ -914,8 +1081,7 @@ static IndexBulkDeleteResult** lazy_scan_heap(
          * If we are close to overrunning the available space for dead-tuple
          * TIDs, pause and do a cycle of vacuuming before we tackle this page.
          */
-        if ((vacrelstats->max_dead_tuples - vacrelstats->num_dead_tuples) < MaxHeapTuplesPerPage &&
-            vacrelstats->num_dead_tuples > 0) {
+        if (lazy_dead_tuples_full(vacrelstats->dead_tuples) && vacrelstats->num_dead_tuples > 0) {
             /*
              * Before beginning index vacuuming, we release any pin we may
              * hold on the visibility map page.  This isn't necessary for
@@ -931,8 +1097,7 @@ static IndexBulkDeleteResult** lazy_scan_heap(
             vacuum_log_cleanup_info(onerel, vacrelstats);
 
             /* Remove index entries */
-            for (i = 0; i < nindexes; i++)
-                lazy_vacuum_index(Irel[i], &indstats[i], vacrelstats);
+            lazy_vacuum_indexes(Irel, nindexes, indstats, vacrelstats);
             /* Remove tuples from heap */
             lazy_vacuum_heap(onerel, vacrelstats);
 
@@ -941,7 +1106,7 @@ static IndexBulkDeleteResult** lazy_scan_heap(
              * not to reset latestRemovedXid since we want that value to be
              * valid.
              */
-            vacrelstats->num_dead_tuples = 0;
+            lazy_forget_dead_tuples(vacrelstats);
             vacrelstats->num_index_scans++;
         }
 
@@ -1281,7 +1446,7 @@ static IndexBulkDeleteResult** lazy_scan_heap(
              * not to reset latestRemovedXid since we want that value to be
              * valid.
              */
-            vacrelstats->num_dead_tuples = 0;
+            lazy_forget_dead_tuples(vacrelstats);
             vacuumed_pages++;
         }
 
@@ -1383,21 +1548,14 @@ static IndexBulkDeleteResult** lazy_scan_heap(
         vacuum_log_cleanup_info(onerel, vacrelstats);
 
         /* Remove index entries */
-        for (i = 0; i < nindexes; i++)
-            lazy_vacuum_index(Irel[i], &indstats[i], vacrelstats);
+        lazy_vacuum_indexes(Irel, nindexes, indstats, vacrelstats);
         /* Remove tuples from heap */
         lazy_vacuum_heap(onerel, vacrelstats);
         vacrelstats->num_index_scans++;
     }
 
     /* Do post-vacuum cleanup and statistics update for each index */
-    for (i = 0; i < nindexes; i++) {
-        /* IO collector and IO scheduler for vacuum */
-        if (ENABLE_WORKLOAD_CONTROL)
-            IOSchedulerAndUpdate(IO_TYPE_WRITE, 1, IO_TYPE_ROW);
-
-        indstats[i] = lazy_cleanup_index(Irel[i], indstats[i], vacrelstats);
-    }
+    lazy_cleanup_indexes(Irel, nindexes, indstats, vacrelstats);
 
     /* record vacuumed tuple for reporting to PgStatCollector */
     *ptrDeleteTupleNum = tups_vacuumed;
@@ -1442,17 +1600,19 @@ static IndexBulkDeleteResult** lazy_scan_heap(
  */
 static void lazy_vacuum_heap(Relation onerel, LVRelStats* vacrelstats)
 {
-    int tupindex;
+    LVDeadTuples* dt = vacrelstats->dead_tuples;
+    uint32 blockIndex;
+    int ntuples;
     int npages;
     PGRUsage ru0;
 
     gstrace_entry(GS_TRC_ID_lazy_vacuum_heap);
 
     pg_rusage_init(&ru0);
+    ntuples = 0;
     npages = 0;
 
-    tupindex = 0;
-    while (tupindex < vacrelstats->num_dead_tuples) {
+    for (blockIndex = 0; blockIndex < dt->nblocks; blockIndex++) {
         BlockNumber tblk;
         Buffer buf;
         Page page;
@@ -1460,14 +1620,13 @@ static void lazy_vacuum_heap(Relation onerel, LVRelStats* vacrelstats)
 
         vacuum_delay_point();
 
-        tblk = ItemPointerGetBlockNumber(&vacrelstats->dead_tuples[tupindex]);
+        tblk = dt->blocks[blockIndex].blkno;
         buf = ReadBufferExtended(onerel, MAIN_FORKNUM, tblk, RBM_NORMAL, vac_strategy);
         if (!ConditionalLockBufferForCleanup(buf)) {
             ReleaseBuffer(buf);
-            ++tupindex;
             continue;
         }
-        tupindex = lazy_vacuum_page(onerel, tblk, buf, tupindex, vacrelstats);
+        ntuples += lazy_vacuum_page(onerel, tblk, buf, blockIndex, vacrelstats);
 
         /* Now that we've compacted the page, record its available space */
         page = BufferGetPage(buf);
@@ -1479,7 +1638,7 @@ static void lazy_vacuum_heap(Relation onerel, LVRelStats* vacrelstats)
     }
 
     ereport(elevel,
-        (errmsg("\"%s\": removed %d row versions in %d pages", RelationGetRelationName(onerel), tupindex, npages),
+        (errmsg("\"%s\": removed %d row versions in %d pages", RelationGetRelationName(onerel), ntuples, npages),
             errdetail("%s.", pg_rusage_show(&ru0))));
     gstrace_exit(GS_TRC_ID_lazy_vacuum_heap);
 }
@@ -1490,30 +1649,39 @@ static void lazy_vacuum_heap(Relation onerel, LVRelStats* vacrelstats)
  *
  * Caller must hold pin and buffer cleanup lock on the buffer.
  *
- * tupindex is the index in vacrelstats->dead_tuples of the first dead
- * tuple for this page.  We assume the rest follow sequentially.
- * The return value is the first tupindex after the tuples of this page.
+ * blockIndex is the position of the page in the dead tuple store.  The
+ * return value is the number of dead tuples freed.
  */
-static int lazy_vacuum_page(Relation onerel, BlockNumber blkno, Buffer buffer, int tupindex, LVRelStats* vacrelstats)
+static int lazy_vacuum_page(
+    Relation onerel, BlockNumber blkno, Buffer buffer, uint32 blockIndex, LVRelStats* vacrelstats)
 {
     Page page = BufferGetPage(buffer);
+    LVDeadTuples* dt = vacrelstats->dead_tuples;
+    LVDeadBlock* block = &dt->blocks[blockIndex];
+    uint32 end = (blockIndex + 1 < dt->nblocks) ? dt->blocks[blockIndex + 1].offset : dt->nbytes;
     OffsetNumber unused[MaxOffsetNumber];
     int uncnt = 0;
+    uint32 i;
+
+    Assert(block->blkno == blkno);
 
     START_CRIT_SECTION();
 
-    for (; tupindex < vacrelstats->num_dead_tuples; tupindex++) {
-        BlockNumber tblk;
-        OffsetNumber toff;
-        ItemId itemid;
+    for (i = block->offset; i < end; i++) {
+        uint8 bits = dt->bitmaps[i];
+        int bit;
 
-        tblk = ItemPointerGetBlockNumber(&vacrelstats->dead_tuples[tupindex]);
-        if (tblk != blkno)
-            break; /* past end of tuples for this block */
-        toff = ItemPointerGetOffsetNumber(&vacrelstats->dead_tuples[tupindex]);
-        itemid = PageGetItemId(page, toff);
-        ItemIdSetUnused(itemid);
-        unused[uncnt++] = toff;
+        for (bit = 0; bits != 0; bit++, bits >>= 1) {
+            OffsetNumber toff;
+            ItemId itemid;
+
+            if ((bits & 1) == 0)
+                continue;
+            toff = (OffsetNumber)((i - block->offset) * BITS_PER_BYTE + bit + 1);
+            itemid = PageGetItemId(page, toff);
+            ItemIdSetUnused(itemid);
+            unused[uncnt++] = toff;
+        }
     }
 
     PageRepairFragmentation(page);
@@ -1530,7 +1698,7 @@ static int lazy_vacuum_page(Relation onerel, BlockNumber blkno, Buffer buffer, i
 
     END_CRIT_SECTION();
 
-    return tupindex;
+    return uncnt;
 }
 
 /*
@@ -1568,6 +1736,44 @@ static bool lazy_check_needs_freeze(Buffer buf)
     return false;
 }
 
+/*
+ *	lazy_vacuum_indexes() -- vacuum all index relations of the heap.
+ */
+static void lazy_vacuum_indexes(Relation* Irel, int nindexes, IndexBulkDeleteResult** indstats, LVRelStats* vacrelstats)
+{
+    int i;
+
+    if (vacrelstats->lps != NULL) {
+        lazy_parallel_pass(vacrelstats->lps, LV_PARALLEL_BULKDELETE, Irel, indstats, vacrelstats);
+        return;
+    }
+
+    for (i = 0; i < nindexes; i++)
+        lazy_vacuum_index(Irel[i], &indstats[i], vacrelstats);
+}
+
+/*
+ *	lazy_cleanup_indexes() -- do post-vacuum cleanup for all index relations.
+ */
+static void lazy_cleanup_indexes(
+    Relation* Irel, int nindexes, IndexBulkDeleteResult** indstats, LVRelStats* vacrelstats)
+{
+    int i;
+
+    if (vacrelstats->lps != NULL) {
+        lazy_parallel_pass(vacrelstats->lps, LV_PARALLEL_CLEANUP, Irel, indstats, vacrelstats);
+        return;
+    }
+
+    for (i = 0; i < nindexes; i++) {
+        /* IO collector and IO scheduler for vacuum */
+        if (ENABLE_WORKLOAD_CONTROL)
+            IOSchedulerAndUpdate(IO_TYPE_WRITE, 1, IO_TYPE_ROW);
+
+        indstats[i] = lazy_cleanup_index(Irel[i], indstats[i], vacrelstats);
+    }
+}
+
 /*
  *	lazy_vacuum_index() -- vacuum one index relation.
  *
@@ -1640,28 +1846,47 @@ static IndexBulkDeleteResult* lazy_cleanup_index(Relation indrel, IndexBulkDelet
 /*
  * lazy_space_alloc - space allocation decisions for lazy vacuum
  *
- * See the comments at the head of this file for rationale.
+ * See the comments at the head of this file for rationale.  The store only
+ * takes memory as dead tuples are found, maintenance_work_mem is its limit,
+ * or vacuum_dead_tuples_mem when that is set and smaller.
  */
-static void lazy_space_alloc(LVRelStats* vacrelstats, BlockNumber relblocks)
+static void lazy_space_alloc(LVRelStats* vacrelstats)
 {
-    unsigned long maxtuples;
+    /* the workers of a parallel index vacuum read the dead tuples too */
+    MemoryContext context = (vacrelstats->lps != NULL) ? vacrelstats->lps->context : CurrentMemoryContext;
+    LVDeadTuples* dt = (LVDeadTuples*)MemoryContextAllocZero(context, sizeof(LVDeadTuples));
+    Size maxbytes;
 
     if (vacrelstats->hasindex) {
-        maxtuples = (u_sess->attr.attr_memory.maintenance_work_mem * 1024L) / sizeof(ItemPointerData);
-        maxtuples = Min(maxtuples, INT_MAX);
-        maxtuples = Min(maxtuples, (int)(MaxAllocSize / sizeof(ItemPointerData)));
-        /* curious coding here to ensure the multiplication can't overflow */
-        if ((BlockNumber)(maxtuples / LAZY_ALLOC_TUPLES) > relblocks)
-            maxtuples = relblocks * LAZY_ALLOC_TUPLES;
+        maxbytes = (Size)u_sess->attr.attr_memory.maintenance_work_mem * 1024L;
+        if (u_sess->attr.attr_memory.vacuum_dead_tuples_mem > 0)
+            maxbytes = Min(maxbytes, (Size)u_sess->attr.attr_memory.vacuum_dead_tuples_mem * 1024L);
+        maxbytes = Min(maxbytes, MaxAllocSize);
         /* stay sane if small maintenance_work_mem */
-        maxtuples = Max(maxtuples, MaxHeapTuplesPerPage);
+        maxbytes = Max(maxbytes, LV_DEAD_PAGE_BYTES);
     } else {
-        maxtuples = MaxHeapTuplesPerPage;
+        maxbytes = LV_DEAD_PAGE_BYTES;
     }
 
+    dt->context = context;
+    dt->maxBytes = maxbytes;
+
+    vacrelstats->num_dead_tuples = 0;
+    vacrelstats->dead_tuples = dt;
+}
+
+/*
+ * lazy_forget_dead_tuples - empty the store once its tuples are vacuumed
+ */
+static void lazy_forget_dead_tuples(LVRelStats* vacrelstats)
+{
+    LVDeadTuples* dt = vacrelstats->dead_tuples;
+
+    /* keep the memory, the directory is cleared again as it is reused */
+    dt->nchunks = 0;
+    dt->nblocks = 0;
+    dt->nbytes = 0;
     vacrelstats->num_dead_tuples = 0;
-    vacrelstats->max_dead_tuples = (int)maxtuples;
-    vacrelstats->dead_tuples = (ItemPointer)palloc(maxtuples * sizeof(ItemPointerData));
 }
 
 /*
@@ -1669,56 +1894,190 @@ static void lazy_space_alloc(LVRelStats* vacrelstats, BlockNumber relblocks)
  */
 static void lazy_record_dead_tuple(LVRelStats* vacrelstats, ItemPointer itemptr)
 {
-    /*
-     * The array shouldn't overflow under normal behavior, but perhaps it
-     * could if we are given a really small maintenance_work_mem. In that
-     * case, just forget the last few tuples (we'll get 'em next time).
-     */
-    if (vacrelstats->num_dead_tuples < vacrelstats->max_dead_tuples) {
-        vacrelstats->dead_tuples[vacrelstats->num_dead_tuples] = *itemptr;
-        vacrelstats->num_dead_tuples++;
-    }
+    lazy_dead_tuples_add(
+        vacrelstats->dead_tuples, ItemPointerGetBlockNumber(itemptr), ItemPointerGetOffsetNumber(itemptr));
+    vacrelstats->num_dead_tuples++;
 }
 
 /*
  *	lazy_tid_reaped() -- is a particular tid deletable?
  *
  *		This has the right signature to be an IndexBulkDeleteCallback.
- *
- *		Assumes dead_tuples array is in sorted order.
  */
 static bool lazy_tid_reaped(ItemPointer itemptr, void* state)
 {
     LVRelStats* vacrelstats = (LVRelStats*)state;
-    ItemPointer res;
 
-    res = (ItemPointer)bsearch((void*)itemptr,
-        (void*)vacrelstats->dead_tuples,
-        vacrelstats->num_dead_tuples,
-        sizeof(ItemPointerData),
-        vac_cmp_itemptr);
+    /* let a parallel vacuum worker stop in the middle of an index */
+    if (MyLVParallelWorker != NULL && MyLVParallelWorker->shared->shutdown)
+        ereport(ERROR, (errcode(ERRCODE_QUERY_CANCELED), errmsg("parallel index vacuum is canceled")));
 
-    return (res != NULL);
+    return lazy_dead_tuples_lookup(
+        vacrelstats->dead_tuples, ItemPointerGetBlockNumber(itemptr), ItemPointerGetOffsetNumber(itemptr));
 }
 
 /*
- * Comparator routines for use with qsort() and bsearch().
+ * lazy_dead_tuples_full - is there no room left for the dead tuples of
+ * another page?
+ *
+ * Only what the page may add beyond the arrays as they are allocated counts,
+ * a store emptied by lazy_forget_dead_tuples() reuses its memory.
  */
-static int vac_cmp_itemptr(const void* left, const void* right)
+static bool lazy_dead_tuples_full(const LVDeadTuples* dt)
 {
-    BlockNumber lblk, rblk;
-    OffsetNumber loff, roff;
-    lblk = ItemPointerGetBlockNumber((ItemPointer)left);
-    rblk = ItemPointerGetBlockNumber((ItemPointer)right);
-    if (lblk < rblk)
-        return -1;
-    if (lblk > rblk)
-        return 1;
-    loff = ItemPointerGetOffsetNumber((ItemPointer)left);
-    roff = ItemPointerGetOffsetNumber((ItemPointer)right);
-    if (loff < roff)
+    Size growth = 0;
+
+    if (dt->nchunks == dt->maxchunks)
+        growth += sizeof(LVDeadChunk);
+    if (dt->nblocks == dt->maxblocks)
+        growth += sizeof(LVDeadBlock);
+    if (dt->maxbytes - dt->nbytes < LV_DEAD_BITMAP_BYTES)
+        growth += LV_DEAD_BITMAP_BYTES - (dt->maxbytes - dt->nbytes);
+
+    return LV_DEAD_ALLOCATED(dt) + growth > dt->maxBytes;
+}
+
+/*
+ * lazy_dead_tuples_add - add a TID to the store
+ *
+ * The TIDs come in increasing order: the heap scan goes block by block, and
+ * the offsets of a page one by one.
+ */
+static void lazy_dead_tuples_add(LVDeadTuples* dt, BlockNumber blkno, OffsetNumber offnum)
+{
+    uint32 chunkno = blkno / LV_DEAD_CHUNK_BLOCKS;
+    uint32 bit = blkno % LV_DEAD_CHUNK_BLOCKS;
+    LVDeadChunk* chunk = NULL;
+    LVDeadBlock* block = NULL;
+    uint32 byte;
+
+    Assert(OffsetNumberIsValid(offnum));
+
+    if (dt->nblocks == 0 || dt->blocks[dt->nblocks - 1].blkno != blkno) {
+        Assert(dt->nblocks == 0 || dt->blocks[dt->nblocks - 1].blkno < blkno);
+
+        /* the first dead block of a chunk adds its directory entry */
+        if (dt->nchunks == 0 || dt->chunks[dt->nchunks - 1].chunkno != chunkno) {
+            Assert(dt->nchunks == 0 || dt->chunks[dt->nchunks - 1].chunkno < chunkno);
+
+            dt->chunks = (LVDeadChunk*)lazy_dead_tuples_enlarge(
+                dt, dt->chunks, &dt->maxchunks, dt->nchunks + 1, sizeof(LVDeadChunk));
+            chunk = &dt->chunks[dt->nchunks++];
+            errno_t rc = memset_s(chunk, sizeof(LVDeadChunk), 0, sizeof(LVDeadChunk));
+            securec_check(rc, "\0", "\0");
+            chunk->chunkno = chunkno;
+            chunk->first = dt->nblocks;
+        } else {
+            chunk = &dt->chunks[dt->nchunks - 1];
+        }
+        chunk->present[bit / 64] |= UINT64CONST(1) << (bit % 64);
+
+        dt->blocks = (LVDeadBlock*)lazy_dead_tuples_enlarge(
+            dt, dt->blocks, &dt->maxblocks, dt->nblocks + 1, sizeof(LVDeadBlock));
+        block = &dt->blocks[dt->nblocks++];
+        block->blkno = blkno;
+        block->offset = dt->nbytes;
+    } else {
+        block = &dt->blocks[dt->nblocks - 1];
+    }
+
+    /* the bitmap of the last block grows up to the highest offset */
+    byte = block->offset + (offnum - 1) / BITS_PER_BYTE;
+    if (byte >= dt->nbytes) {
+        dt->bitmaps = (uint8*)lazy_dead_tuples_enlarge(dt, dt->bitmaps, &dt->maxbytes, byte + 1, sizeof(uint8));
+        errno_t rc = memset_s(dt->bitmaps + dt->nbytes, byte + 1 - dt->nbytes, 0, byte + 1 - dt->nbytes);
+        securec_check(rc, "\0", "\0");
+        dt->nbytes = byte + 1;
+    }
+    dt->bitmaps[byte] |= (uint8)(1 << ((offnum - 1) % BITS_PER_BYTE));
+}
+
+/*
+ * lazy_dead_tuples_lookup - is the TID in the store?
+ */
+static bool lazy_dead_tuples_lookup(const LVDeadTuples* dt, BlockNumber blkno, OffsetNumber offnum)
+{
+    uint32 chunkno = blkno / LV_DEAD_CHUNK_BLOCKS;
+    uint32 bit = blkno % LV_DEAD_CHUNK_BLOCKS;
+    uint64 mask = UINT64CONST(1) << (bit % 64);
+    const LVDeadChunk* chunk = NULL;
+    uint32 pos;
+    uint32 end;
+    uint32 byte;
+    uint32 i;
+
+    if (dt->nchunks == 0 || !OffsetNumberIsValid(offnum))
+        return false;
+
+    /* most index entries point outside the dead range, skip the search */
+    if (chunkno < dt->chunks[0].chunkno || chunkno > dt->chunks[dt->nchunks - 1].chunkno)
+        return false;
+
+    chunk = (const LVDeadChunk*)bsearch(&chunkno, dt->chunks, dt->nchunks, sizeof(LVDeadChunk), lazy_dead_chunk_cmp);
+    if (chunk == NULL || (chunk->present[bit / 64] & mask) == 0)
+        return false;
+
+    /* the position of the block is the number of blocks before it */
+    pos = chunk->first;
+    for (i = 0; i < bit / 64; i++)
+        pos += (uint32)__builtin_popcountll(chunk->present[i]);
+    pos += (uint32)__builtin_popcountll(chunk->present[bit / 64] & (mask - 1));
+    Assert(pos < dt->nblocks && dt->blocks[pos].blkno == blkno);
+
+    end = (pos + 1 < dt->nblocks) ? dt->blocks[pos + 1].offset : dt->nbytes;
+    byte = dt->blocks[pos].offset + (offnum - 1) / BITS_PER_BYTE;
+    if (byte >= end)
+        return false;
+
+    return (dt->bitmaps[byte] & (1 << ((offnum - 1) % BITS_PER_BYTE))) != 0;
+}
+
+/*
+ * lazy_dead_tuples_enlarge - make room for needed items in an array of the
+ * store
+ *
+ * The array doubles as long as that leaves room for the dead tuples of a page
+ * within maxBytes.  Closer to the limit it grows by just the needed items,
+ * which lazy_dead_tuples_full() made sure still fit, so the store never takes
+ * more than maxBytes.
+ */
+static void* lazy_dead_tuples_enlarge(LVDeadTuples* dt, void* array, uint32* maxitems, uint32 needed, Size itemsize)
+{
+    Size allocated = LV_DEAD_ALLOCATED(dt);
+    Size spare = 0;
+    Size newmax;
+
+    if (needed <= *maxitems)
+        return array;
+
+    if (dt->maxBytes > allocated + LV_DEAD_PAGE_BYTES)
+        spare = (dt->maxBytes - allocated - LV_DEAD_PAGE_BYTES) / itemsize;
+
+    newmax = Max((Size)*maxitems * 2, 1024);
+    newmax = Min(newmax, *maxitems + spare);
+    newmax = Max(newmax, needed);
+    Assert(allocated + (newmax - *maxitems) * itemsize <= dt->maxBytes);
+
+    if (array == NULL)
+        array = MemoryContextAlloc(dt->context, newmax * itemsize);
+    else
+        array = repalloc(array, newmax * itemsize);
+    *maxitems = (uint32)newmax;
+
+    return array;
+}
+
+/*
+ * Comparator for the binary search of a chunk number in the chunk directory
+ */
+static int lazy_dead_chunk_cmp(const void* key, const void* elem)
+{
+    uint32 chunkno = *(const uint32*)key;
+    uint32 other = ((const LVDeadChunk*)elem)->chunkno;
+
+    if (chunkno < other)
         return -1;
-    if (loff > roff)
+    if (chunkno > other)
         return 1;
     return 0;
 }
@@ -1773,3 +2132,506 @@ void elogVacuumInfo(Relation rel, HeapTuple tuple, char* funcName, TransactionId
                     RelationGetRelid(rel))));
     }
 }
+
+/*
+ * Number of workers to vacuum the indexes of the heap with, 0 to vacuum them
+ * serially.  Unless parallel_vacuum_workers says otherwise, every index but
+ * the one the leader takes gets a worker.
+ */
+static int lazy_parallel_workers(Relation onerel, int nindexes)
+{
+    int nworkers = RelationGetParallelVacuumWorkers(onerel);
+
+    if (nworkers < 0)
+        nworkers = nindexes - 1;
+    nworkers = Min(nworkers, nindexes - 1);
+    nworkers = Min(nworkers, u_sess->attr.attr_storage.max_parallel_maintenance_workers);
+    if (nworkers <= 0)
+        return 0;
+
+    /*
+     * Workers are separate threads with their own relcache and no local
+     * buffers.  Leave out temp tables, catalogs, and partitions whose indexes
+     * are only open as fake relations.
+     */
+    if (IsBootstrapProcessingMode() || !IsUnderPostmaster || StreamThreadAmI() || IsSystemRelation(onerel) ||
+        RelationUsesLocalBuffers(onerel) || RelationIsPartition(onerel) || RelationIsBucket(onerel))
+        return 0;
+
+    return nworkers;
+}
+
+/*
+ * Set up the state shared with the workers and start them.  A worker that can
+ * not be started just leaves its indexes to the others.
+ */
+static LVParallelState* lazy_parallel_begin(Relation* Irel, int nindexes, int nworkers)
+{
+    MemoryContext context = NULL;
+    LVParallelState* lps = NULL;
+    Snapshot snapshot = NULL;
+    int i;
+
+    Assert(nworkers > 0 && nworkers <= MAX_PARALLEL_VACUUM_WORKERS);
+    Assert(MyLVParallelState == NULL);
+
+    context = AllocSetContextCreate(g_instance.instance_context,
+        "LazyVacuumParallelContext",
+        ALLOCSET_DEFAULT_MINSIZE,
+        ALLOCSET_DEFAULT_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE,
+        SHARED_CONTEXT);
+
+    lps = (LVParallelState*)MemoryContextAllocZero(context, sizeof(LVParallelState));
+    lps->context = context;
+    lps->dbid = u_sess->proc_cxt.MyDatabaseId;
+    lps->leaderLatch = &t_thrd.proc->procLatch;
+
+    /* every participant gets its share of the cost limit */
+    if (t_thrd.vacuum_cxt.VacuumCostActive) {
+        lps->costDelay = u_sess->attr.attr_storage.VacuumCostDelay;
+        lps->costLimit = Max(u_sess->attr.attr_storage.VacuumCostLimit / (nworkers + 1), 1);
+    }
+
+    lps->nindexes = nindexes;
+    lps->indexes = (LVParallelIndex*)MemoryContextAllocZero(context, nindexes * sizeof(LVParallelIndex));
+    for (i = 0; i < nindexes; i++)
+        lps->indexes[i].indexid = RelationGetRelid(Irel[i]);
+
+    /* what a worker needs to take part in our transaction */
+    snapshot = ActiveSnapshotSet() ? GetActiveSnapshot() : GetTransactionSnapshot();
+    lps->snapshot = RegisterSnapshot(snapshot);
+    lps->txnCxt.txnId = GetCurrentTransactionIdIfAny();
+    lps->txnCxt.snapshot = lps->snapshot;
+    StreamTxnContextSaveXact(&lps->txnCxt);
+    StreamTxnContextSaveSnapmgr(&lps->txnCxt);
+    StreamTxnContextSaveComboCid(&lps->txnCxt);
+
+    for (i = 0; i < nworkers; i++) {
+        LVParallelWorker* worker = (LVParallelWorker*)MemoryContextAllocZero(context, sizeof(LVParallelWorker));
+
+        worker->id = i + 1;
+        worker->state = LV_WORKER_STARTING;
+        worker->shared = lps;
+        lps->workers[i] = worker;
+    }
+
+    MyLVParallelState = lps;
+    on_shmem_exit(lazy_parallel_leader_exit, 0);
+
+    for (i = 0; i < nworkers; i++) {
+        LVParallelWorker* worker = lps->workers[i];
+
+        worker->tid = initialize_util_thread(PARALLEL_VACUUM, worker);
+        if (worker->tid == 0) {
+            ereport(LOG, (errmsg("could not start parallel index vacuum worker %d", worker->id)));
+            break;
+        }
+        lps->nworkers++;
+    }
+
+    ereport(elevel, (errmsg("vacuuming %d indexes with %d parallel workers", nindexes, lps->nworkers)));
+
+    return lps;
+}
+
+/*
+ * Stop the workers and wait until they are gone, they may still use our
+ * transaction and the shared context.
+ */
+static void lazy_parallel_end(LVParallelState* lps)
+{
+    lazy_parallel_stop(lps);
+
+    MyLVParallelState = NULL;
+    cancel_shmem_exit(lazy_parallel_leader_exit, 0);
+    UnregisterSnapshot(lps->snapshot);
+    MemoryContextDelete(lps->context);
+}
+
+static void lazy_parallel_stop(LVParallelState* lps)
+{
+    bool exited = false;
+    int i;
+
+    lps->shutdown = true;
+    pg_memory_barrier();
+
+    while (!exited) {
+        exited = true;
+        for (i = 0; i < lps->nworkers; i++) {
+            LVParallelWorker* worker = lps->workers[i];
+            PGPROC* proc = worker->proc;
+
+            if (worker->state != LV_WORKER_EXITED) {
+                exited = false;
+                if (proc != NULL)
+                    SetLatch(&proc->procLatch);
+            }
+        }
+        if (exited)
+            break;
+
+        (void)WaitLatch(lps->leaderLatch, WL_LATCH_SET | WL_TIMEOUT, LV_PARALLEL_WAIT_INTERVAL);
+        ResetLatch(lps->leaderLatch);
+    }
+}
+
+/* stop the workers when the leader exits while they are running */
+static void lazy_parallel_leader_exit(int code, Datum arg)
+{
+    LVParallelState* lps = MyLVParallelState;
+
+    if (lps != NULL) {
+        lazy_parallel_stop(lps);
+        MyLVParallelState = NULL;
+        MemoryContextDelete(lps->context);
+    }
+}
+
+/* raise the error of a failed worker in the leader */
+static void lazy_parallel_check_workers(LVParallelState* lps)
+{
+    int i;
+
+    for (i = 0; i < lps->nworkers; i++) {
+        LVParallelWorker* worker = lps->workers[i];
+        ErrorData* edata = worker->error;
+
+        if (edata != NULL) {
+            pg_read_barrier();
+            ereport(ERROR,
+                (errcode(edata->sqlerrcode),
+                    errmsg_internal("%s", edata->message),
+                    edata->detail ? errdetail_internal("%s", edata->detail) : 0,
+                    edata->hint ? errhint("%s", edata->hint) : 0));
+        }
+        if (worker->state == LV_WORKER_EXITED)
+            ereport(ERROR,
+                (errcode(ERRCODE_INTERNAL_ERROR),
+                    errmsg("parallel index vacuum worker %d exited unexpectedly", worker->id),
+                    errhint("See the server log of the worker for details.")));
+    }
+}
+
+/*
+ * One pass of bulk deletion or cleanup over all indexes.  The leader takes
+ * indexes like any worker, then waits for the indexes taken by the workers,
+ * reports them and, after cleanup, hands the final statistics to the caller.
+ */
+static void lazy_parallel_pass(LVParallelState* lps, LVParallelPhase phase, Relation* Irel,
+    IndexBulkDeleteResult** indstats, LVRelStats* vacrelstats)
+{
+    uint32 pass;
+    int i;
+
+    lps->phase = phase;
+    lps->relstats = *vacrelstats;
+    pg_atomic_write_u32(&lps->nextIndex, 0);
+    pg_write_barrier();
+    pass = pg_atomic_add_fetch_u32(&lps->pass, 1);
+
+    for (i = 0; i < lps->nworkers; i++) {
+        PGPROC* proc = lps->workers[i]->proc;
+
+        if (proc != NULL)
+            SetLatch(&proc->procLatch);
+    }
+
+    lazy_parallel_process_indexes(lps, Irel, 0);
+
+    /* a worker is done with the pass once it finds no index left */
+    for (;;) {
+        bool done = true;
+
+        for (i = 0; i < lps->nworkers; i++) {
+            if (lps->workers[i]->donePass != pass) {
+                done = false;
+                break;
+            }
+        }
+        if (done)
+            break;
+
+        CHECK_FOR_INTERRUPTS();
+        lazy_parallel_check_workers(lps);
+
+        (void)WaitLatch(lps->leaderLatch, WL_LATCH_SET | WL_TIMEOUT, LV_PARALLEL_WAIT_INTERVAL);
+        ResetLatch(lps->leaderLatch);
+    }
+    pg_read_barrier();
+
+    for (i = 0; i < lps->nindexes; i++) {
+        LVParallelIndex* pindex = &lps->indexes[i];
+        IndexBulkDeleteResult* stats = pindex->hasStats ? &pindex->stats : NULL;
+
+        /* the leader has reported its own indexes already */
+        if (pindex->participant != 0) {
+            if (phase == LV_PARALLEL_BULKDELETE) {
+                ereport(elevel,
+                    (errmsg("scanned index \"%s\" to remove %d row versions",
+                        RelationGetRelationName(Irel[i]),
+                        vacrelstats->num_dead_tuples),
+                        errdetail("Vacuumed by parallel worker %d.", pindex->participant)));
+            } else if (stats != NULL) {
+                ereport(elevel,
+                    (errmsg("index \"%s\" now contains %.0f row versions in %u pages",
+                        RelationGetRelationName(Irel[i]),
+                        stats->num_index_tuples,
+                        stats->num_pages),
+                        errdetail("%.0f index row versions were removed.\n"
+                                  "%u index pages have been deleted, %u are currently reusable.\n"
+                                  "Vacuumed by parallel worker %d.",
+                            stats->tuples_removed,
+                            stats->pages_deleted,
+                            stats->pages_free,
+                            pindex->participant)));
+            }
+        }
+
+        if (phase == LV_PARALLEL_CLEANUP) {
+            indstats[i] = NULL;
+            if (stats != NULL) {
+                indstats[i] = (IndexBulkDeleteResult*)palloc(sizeof(IndexBulkDeleteResult));
+                *indstats[i] = *stats;
+            }
+        }
+    }
+}
+
+/*
+ * Take indexes from the shared counter until there are none left, and run the
+ * phase of the current pass on them.  The statistics of an index stay in the
+ * shared state between passes.
+ */
+static void lazy_parallel_process_indexes(LVParallelState* lps, Relation* Irel, int participant)
+{
+    for (;;) {
+        uint32 idx = pg_atomic_fetch_add_u32(&lps->nextIndex, 1);
+        LVParallelIndex* pindex = NULL;
+        IndexBulkDeleteResult* stats = NULL;
+
+        if (idx >= (uint32)lps->nindexes)
+            break;
+
+        pindex = &lps->indexes[idx];
+        if (pindex->hasStats)
+            stats = &pindex->stats;
+
+        if (lps->phase == LV_PARALLEL_BULKDELETE) {
+            lazy_vacuum_index(Irel[idx], &stats, &lps->relstats);
+        } else {
+            /* IO collector and IO scheduler for vacuum */
+            if (participant == 0 && ENABLE_WORKLOAD_CONTROL)
+                IOSchedulerAndUpdate(IO_TYPE_WRITE, 1, IO_TYPE_ROW);
+
+            stats = lazy_cleanup_index(Irel[idx], stats, &lps->relstats);
+        }
+
+        if (stats == NULL) {
+            pindex->hasStats = false;
+        } else if (stats != &pindex->stats) {
+            pindex->stats = *stats;
+            pindex->hasStats = true;
+            pfree(stats);
+        }
+        pindex->participant = participant;
+    }
+}
+
+/*
+ * Main entry point of a parallel index vacuum worker, arg is its
+ * LVParallelWorker.
+ */
+void LazyVacuumWorkerMain(void* arg)
+{
+    LVParallelWorker* worker = (LVParallelWorker*)arg;
+    LVParallelState* lps = worker->shared;
+    sigjmp_buf local_sigjmp_buf;
+
+    /* we are a postmaster subprocess now */
+    IsUnderPostmaster = true;
+    t_thrd.role = PARALLEL_VACUUM;
+
+    /* reset t_thrd.proc_cxt.MyProcPid */
+    t_thrd.proc_cxt.MyProcPid = gs_thread_self();
+
+    /* record Start Time for logging */
+    t_thrd.proc_cxt.MyStartTime = time(NULL);
+
+    t_thrd.proc_cxt.MyProgName = "IndexVacuumWorker";
+
+    /* Identify myself via ps */
+    init_ps_display("parallel index vacuum worker process", "", "", "");
+
+    SetProcessingMode(InitProcessing);
+
+    (void)gspqsignal(SIGINT, StatementCancelHandler);
+    (void)gspqsignal(SIGTERM, die);
+    (void)gspqsignal(SIGQUIT, quickdie);
+    (void)gspqsignal(SIGALRM, handle_sig_alarm);
+
+    (void)gspqsignal(SIGPIPE, SIG_IGN);
+    (void)gspqsignal(SIGUSR1, procsignal_sigusr1_handler);
+    (void)gspqsignal(SIGUSR2, SIG_IGN);
+    (void)gspqsignal(SIGFPE, FloatExceptionHandler);
+    (void)gspqsignal(SIGCHLD, SIG_DFL);
+    (void)gspqsignal(SIGHUP, SIG_IGN);
+
+    /* Early initialization */
+    BaseInit();
+
+#ifndef EXEC_BACKEND
+    InitProcess();
+#endif
+
+    /* tell the leader when we are gone, whatever the reason */
+    on_shmem_exit(lazy_parallel_worker_exit, PointerGetDatum(worker));
+
+    /*
+     * If an exception is encountered, processing resumes here.  The error is
+     * handed to the leader, which raises it again in its own session.
+     */
+    int curTryCounter;
+    int* oldTryCounter = NULL;
+    if (sigsetjmp(local_sigjmp_buf, 1) != 0) {
+        gstrace_tryblock_exit(true, oldTryCounter);
+        /* Prevents interrupts while cleaning up */
+        HOLD_INTERRUPTS();
+
+        if (worker->error == NULL) {
+            MemoryContext oldcontext = MemoryContextSwitchTo(lps->context);
+            ErrorData* edata = CopyErrorData();
+
+            (void)MemoryContextSwitchTo(oldcontext);
+            pg_write_barrier();
+            worker->error = edata;
+        }
+
+        /* Report the error to the server log */
+        EmitErrorReport();
+
+        proc_exit(1);
+    }
+    oldTryCounter = gstrace_tryblock_entry(&curTryCounter);
+
+    /* We can now handle ereport(ERROR) */
+    t_thrd.log_cxt.PG_exception_stack = &local_sigjmp_buf;
+
+    gs_signal_setmask(&t_thrd.libpq_cxt.UnBlockSig, NULL);
+    (void)gs_signal_unblock_sigusr2();
+
+    t_thrd.proc_cxt.PostInit->SetDatabaseAndUser(NULL, lps->dbid, NULL);
+    t_thrd.proc_cxt.PostInit->InitIndexVacuumWorker();
+
+    SetProcessingMode(NormalProcessing);
+
+    worker->proc = t_thrd.proc;
+    pg_memory_barrier();
+
+    MyLVParallelWorker = worker;
+    lazy_parallel_vacuum_work(worker);
+}
+
+/*
+ * The work of a worker: take part in every pass of the leader until it shuts
+ * us down, inside the leader's transaction.
+ */
+static void lazy_parallel_vacuum_work(LVParallelWorker* worker)
+{
+    LVParallelState* lps = worker->shared;
+    Relation* Irel = NULL;
+    int i;
+
+    StartTransactionCommand();
+    (void)GetTransactionSnapshot();
+
+    /* take part in the leader's transaction, see StreamTxnContext */
+    StreamTxnContextSetTransactionState(&lps->txnCxt);
+    StreamTxnContextRestoreXact(&lps->txnCxt);
+    StreamTxnContextRestoreComboCid(&lps->txnCxt);
+    StreamTxnContextRestoreSnapmgr(&lps->txnCxt);
+    StreamTxnContextSetSnapShot(lps->txnCxt.snapshot);
+    StreamTxnContextSetMyPgXactXmin(lps->txnCxt.TransactionXmin);
+    worker->xactBorrowed = true;
+    on_shmem_exit(lazy_parallel_worker_detach, PointerGetDatum(worker));
+
+    /* other vacuums may ignore our xmin as they ignore the leader's */
+    (void)LWLockAcquire(ProcArrayLock, LW_EXCLUSIVE);
+    t_thrd.pgxact->vacuumFlags |= PROC_IN_VACUUM;
+    LWLockRelease(ProcArrayLock);
+
+    /* the leader reports the indexes we vacuum */
+    elevel = DEBUG2;
+    vac_strategy = GetAccessStrategy(BAS_VACUUM);
+    if (lps->costDelay > 0) {
+        u_sess->attr.attr_storage.VacuumCostDelay = lps->costDelay;
+        u_sess->attr.attr_storage.VacuumCostLimit = lps->costLimit;
+        t_thrd.vacuum_cxt.VacuumCostActive = true;
+        t_thrd.vacuum_cxt.VacuumCostBalance = 0;
+    }
+
+    /* the leader's locks cover us */
+    Irel = (Relation*)palloc(lps->nindexes * sizeof(Relation));
+    for (i = 0; i < lps->nindexes; i++)
+        Irel[i] = index_open(lps->indexes[i].indexid, NoLock);
+
+    for (;;) {
+        uint32 pass;
+
+        if (lps->shutdown)
+            break;
+
+        pass = pg_atomic_read_u32(&lps->pass);
+        if (pass == worker->donePass) {
+            (void)WaitLatch(&t_thrd.proc->procLatch, WL_LATCH_SET | WL_TIMEOUT, LV_PARALLEL_WAIT_INTERVAL);
+            ResetLatch(&t_thrd.proc->procLatch);
+            CHECK_FOR_INTERRUPTS();
+            continue;
+        }
+        pg_read_barrier();
+
+        lazy_parallel_process_indexes(lps, Irel, worker->id);
+
+        pg_write_barrier();
+        worker->donePass = pass;
+        SetLatch(lps->leaderLatch);
+    }
+
+    for (i = 0; i < lps->nindexes; i++)
+        index_close(Irel[i], NoLock);
+    pfree(Irel);
+    FreeAccessStrategy(vac_strategy);
+    vac_strategy = NULL;
+
+    /* end our own transaction only, the leader commits the vacuum */
+    StreamTxnContextResetTransactionState();
+    worker->xactBorrowed = false;
+    CommitTransactionCommand();
+}
+
+/*
+ * Give back the leader's transaction before ShutdownPostgres aborts ours,
+ * registered after it so that it runs first.
+ */
+static void lazy_parallel_worker_detach(int code, Datum arg)
+{
+    LVParallelWorker* worker = (LVParallelWorker*)DatumGetPointer(arg);
+
+    if (worker->xactBorrowed) {
+        StreamTxnContextResetTransactionState();
+        worker->xactBorrowed = false;
+    }
+}
+
+static void lazy_parallel_worker_exit(int code, Datum arg)
+{
+    LVParallelWorker* worker = (LVParallelWorker*)DatumGetPointer(arg);
+    Latch* latch = worker->shared->leaderLatch;
+
+    MyLVParallelWorker = NULL;
+    worker->proc = NULL;
+    pg_write_barrier();
+    worker->state = LV_WORKER_EXITED;
+    SetLatch(latch);
+}
@@ -88,6 +88,7 @@
 #include "optimizer/restrictinfo.h"
 #include "optimizer/tlist.h"
 #include "parser/parsetree.h"
+#include "utils/bloom_filter.h"
 #include "utils/dynahash.h"
 #include "utils/guc.h"
 #include "utils/lsyscache.h"
@@ -1010,6 +1011,8 @@ void cost_index(IndexPath* path, PlannerInfo* root, double loop_count)
     if (!u_sess->attr.attr_sql.enable_indexscan)
         startup_cost += g_instance.cost_cxt.disable_cost;
     /* we don't need to check enable_indexonlyscan; indxpath.c does that */
+    /* btcostestimate sets this again if it costs the path as a skip scan */
+    path->indexskipscan = false;
     /*
      * Call index-access-method-specific code to estimate the processing cost
      * for scanning the index, as well as the selectivity of the index (ie,
@@ -2575,6 +2578,40 @@ void cost_limit(Plan* plan, Plan* lefttree, int64 offset_est, int64 count_est)
     }
 }
 
+/*
+ * cost_runtime_join_filter
+ *	  Decide whether a runtime join filter built by a hash join is worth
+ *	  pushing into the row scan 'scan', and charge its probe cost if so.
+ *
+ * 'build_rows' is the estimated size of the hash join inner side the filter
+ * is built from, 'ratio' is the estimated fraction of the scan rows that
+ * survive the join.  Every scanned row pays one filter probe, every removed
+ * row saves its projection and the hash table probe of the join.
+ */
+bool cost_runtime_join_filter(Plan* scan, double build_rows, double ratio)
+{
+    Cost build_cost;
+    Cost probe_cost;
+    Cost saved_cost;
+
+    /* The executor gives up the filter if the inner side is too large. */
+    if (build_rows > RUNTIME_JOIN_FILTER_MAX_ROWS) {
+        return false;
+    }
+
+    build_cost = u_sess->attr.attr_sql.cpu_operator_cost * build_rows;
+    probe_cost = u_sess->attr.attr_sql.cpu_operator_cost * scan->plan_rows;
+    saved_cost = (1.0 - ratio) * scan->plan_rows *
+                 (u_sess->attr.attr_sql.cpu_tuple_cost + u_sess->attr.attr_sql.cpu_operator_cost);
+
+    if (saved_cost <= build_cost + probe_cost) {
+        return false;
+    }
+
+    scan->total_cost += probe_cost;
+    return true;
+}
+
 /*
  * initial_cost_nestloop
  *	  Preliminary estimate of the cost of a nestloop join path.
@@ -1750,7 +1750,7 @@ static void match_eclass_clauses_to_index(PlannerInfo* root, IndexOptInfo* index
     if (!index->rel->has_eclass_joins)
         return;
 
-    for (indexcol = 0; indexcol < index->ncolumns; indexcol++) {
+    for (indexcol = 0; indexcol < index->nkeycolumns; indexcol++) {
         List* clauses = NIL;
 
         clauses = generate_implied_equalities_for_indexcol(root, index, indexcol);
@@ -1817,8 +1817,8 @@ static void match_clause_to_index(IndexOptInfo* index, RestrictInfo* rinfo, Inde
     if (!restriction_is_securely_promotable(rinfo, index->rel))
         return;
 
-    /* OK, check each index column for a match */
-    for (indexcol = 0; indexcol < index->ncolumns; indexcol++) {
+    /* OK, check each key column of the index for a match */
+    for (indexcol = 0; indexcol < index->nkeycolumns; indexcol++) {
         if (match_clause_to_indexcol(index, indexcol, rinfo)) {
             clauseset->indexclauses[indexcol] = list_append_unique_ptr(clauseset->indexclauses[indexcol], rinfo);
             clauseset->nonempty = true;
@@ -2152,7 +2152,7 @@ static void match_pathkeys_to_index(
              * amcanorderbyop.	We might need different logic in future for
              * other implementations.
              */
-            for (indexcol = 0; indexcol < index->ncolumns; indexcol++) {
+            for (indexcol = 0; indexcol < index->nkeycolumns; indexcol++) {
                 Expr* expr = NULL;
 
                 expr = match_clause_to_ordering_op(index, indexcol, member->em_expr, pathkey->pk_opfamily);
@@ -2485,7 +2485,7 @@ bool relation_has_unique_index_for(
          * Try to find each index column in the lists of conditions.  This is
          * O(N^2) or worse, but we expect all the lists to be short.
          */
-        for (c = 0; c < ind->ncolumns; c++) {
+        for (c = 0; c < ind->nkeycolumns; c++) {
             bool matched = false;
             ListCell* lc = NULL;
             ListCell* lc2 = NULL;
@@ -2556,7 +2556,7 @@ bool relation_has_unique_index_for(
         }
 
         /* Matched all columns of this index? */
-        if (c == ind->ncolumns)
+        if (c == ind->nkeycolumns)
             return true;
     }
 
@@ -3248,13 +3248,13 @@ Expr* adjust_rowcompare_for_index(
         /*
          * The Var side can match any column of the index.
          */
-        for (i = 0; i < index->ncolumns; i++) {
+        for (i = 0; i < index->nkeycolumns; i++) {
             if (match_index_to_operand(varop, i, index) &&
                 get_op_opfamily_strategy(expr_op, index->opfamily[i]) == op_strategy &&
                 IndexCollMatchesExprColl(index->indexcollations[i], lfirst_oid(collids_cell)))
                 break;
         }
-        if (i >= index->ncolumns)
+        if (i >= index->nkeycolumns)
             break; /* no match found */
 
         /* Add column number to returned list */
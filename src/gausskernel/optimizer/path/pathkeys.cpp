@@ -417,6 +417,10 @@ List* build_index_pathkeys(PlannerInfo* root, IndexOptInfo* index, ScanDirection
         bool nulls_first = false;
         PathKey* cpathkey = NULL;
 
+        /* the included columns are not ordered */
+        if (i >= index->nkeycolumns)
+            break;
+
         /* We assume we don't need to make a copy of the tlist item */
         indexkey = indextle->expr;
 
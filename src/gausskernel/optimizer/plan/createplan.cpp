@@ -126,21 +126,23 @@ static DfsScan* make_dfsscan(List* qptlist, List* qpqual, Index scanrelid, List*
 
 static PartIterator* create_partIterator_plan(
     PlannerInfo* root, PartIteratorPath* pIterpath, GlobalPartIterator* gpIter);
+static List* get_partIterator_pruning_quals(PlannerInfo* root, Path* subpath, Plan* subplan);
 static Plan* setPartitionParam(PlannerInfo* root, Plan* plan, RelOptInfo* rel);
 static Plan* setBucketInfoParam(PlannerInfo* root, Plan* plan, RelOptInfo* rel);
 Plan* create_globalpartInterator_plan(PlannerInfo* root, PartIteratorPath* pIterpath);
 
 static IndexScan* make_indexscan(List* qptlist, List* qpqual, Index scanrelid, Oid indexid, List* indexqual,
-    List* indexqualorig, List* indexorderby, List* indexorderbyorig, ScanDirection indexscandir);
+    List* indexqualorig, List* indexorderby, List* indexorderbyorig, ScanDirection indexscandir, bool indexskipscan);
 static IndexOnlyScan* make_indexonlyscan(List* qptlist, List* qpqual, Index scanrelid, Oid indexid, List* indexqual,
-    List* indexorderby, List* indextlist, ScanDirection indexscandir);
+    List* indexorderby, List* indextlist, ScanDirection indexscandir, bool indexskipscan);
 static CStoreIndexScan* make_cstoreindexscan(PlannerInfo* root, Path* best_path, List* qptlist, List* qpqual,
     Index scanrelid, Oid indexid, List* indexqual, List* indexqualorig, List* indexorderby, List* indexorderbyorig,
     List* indextlist, ScanDirection indexscandir, bool indexonly);
 static DfsIndexScan* make_dfsindexscan(PlannerInfo* root, Path* best_path, List* qptlist, List* qpqual, Index scanrelid,
     Oid indexid, List* indexqual, List* indexqualorig, List* indexorderby, List* indexorderbyorig,
     IndexOptInfo* indexinfo, ScanDirection indexscandir, bool indexonly);
-static BitmapIndexScan* make_bitmap_indexscan(Index scanrelid, Oid indexid, List* indexqual, List* indexqualorig);
+static BitmapIndexScan* make_bitmap_indexscan(
+    Index scanrelid, Oid indexid, List* indexqual, List* indexqualorig, bool indexskipscan);
 static BitmapHeapScan* make_bitmap_heapscan(
     List* qptlist, List* qpqual, Plan* lefttree, List* bitmapqualorig, Index scanrelid);
 static CStoreIndexCtidScan* make_cstoreindex_ctidscan(
@@ -2514,7 +2516,8 @@ static Scan* create_indexscan_plan(
                 fixed_indexquals,
                 fixed_indexorderbys,
                 best_path->indexinfo->indextlist,
-                best_path->indexscandir);
+                best_path->indexscandir,
+                best_path->indexskipscan);
         else
             scan_plan = (Scan*)make_indexscan(tlist,
                 qpqual,
@@ -2524,7 +2527,8 @@ static Scan* create_indexscan_plan(
                 stripped_indexquals,
                 fixed_indexorderbys,
                 indexorderbys,
-                best_path->indexscandir);
+                best_path->indexscandir,
+                best_path->indexskipscan);
     }
 
 #ifdef STREAMPLAN
@@ -2815,7 +2819,7 @@ static Plan* create_bitmap_subplan(PlannerInfo* root, Path* bitmapqual, List** q
             Assert(IsA(iscan, IndexScan));
             /* then convert to a bitmap indexscan */
             plan = (Plan*)make_bitmap_indexscan(
-                iscan->scan.scanrelid, iscan->indexid, iscan->indexqual, iscan->indexqualorig);
+                iscan->scan.scanrelid, iscan->indexid, iscan->indexqual, iscan->indexqualorig, iscan->indexskipscan);
             indexscan = (Plan*)iscan;
         }
 #ifdef STREAMPLAN
@@ -4243,6 +4247,10 @@ static void search_var_and_mark_bloomfilter(PlannerInfo* root, Expr* expr, Plan*
     switch (nodeTag(plan)) {
         case T_ForeignScan:
         case T_DfsScan: {
+            if (!u_sess->attr.attr_sql.enable_bloom_filter) {
+                return;
+            }
+
             if (IsA(plan, ForeignScan)) {
                 ForeignScan* splan = (VecForeignScan*)plan;
 
@@ -4267,6 +4275,34 @@ static void search_var_and_mark_bloomfilter(PlannerInfo* root, Expr* expr, Plan*
 
             break;
         }
+        case T_SeqScan:
+        case T_IndexScan: {
+            Oid type = exprType((Node*)expr);
+
+            /*
+             * Row scans evaluate the runtime join filter on the scan tuple. Skip
+             * them below nodes which buffer or reshape their input, a filter
+             * rebuilt on rescan could not reach the rows they keep. String keys
+             * are left out as each probe would convert the datum to a C string.
+             */
+            if (!context->row_filter || context->materialized ||
+                (type != INT2OID && type != INT4OID && type != INT8OID && type != FLOAT4OID && type != FLOAT8OID)) {
+                return;
+            }
+
+            if (find_var_from_targetlist(expr, plan->targetlist) &&
+                cost_runtime_join_filter(plan, context->build_rows, context->ratio)) {
+                if (context->add_index) {
+                    context->bloomfilter_index++;
+                    context->add_index = false;
+                }
+
+                plan->var_list = lappend(plan->var_list, copyObject(expr));
+                plan->filterIndexList = lappend_int(plan->filterIndexList, context->bloomfilter_index);
+            }
+
+            break;
+        }
         case T_NestLoop:
         case T_MergeJoin:
         case T_HashJoin: {
@@ -4311,13 +4347,23 @@ static void search_var_and_mark_bloomfilter(PlannerInfo* root, Expr* expr, Plan*
         case T_Group:
         case T_WindowAgg:
         case T_BaseResult: {
+            bool materialized = context->materialized;
+
+            if (!IsA(plan, BaseResult)) {
+                context->materialized = true;
+            }
             search_var_and_mark_bloomfilter(root, expr, outerPlan(plan), context);
+            context->materialized = materialized;
             break;
         }
         case T_Agg: {
             /* Return false if ap function is meet. */
             if (!((Agg*)plan)->groupingSets) {
+                bool materialized = context->materialized;
+
+                context->materialized = true;
                 search_var_and_mark_bloomfilter(root, expr, outerPlan(plan), context);
+                context->materialized = materialized;
             }
             break;
         }
@@ -4447,6 +4493,8 @@ static void set_bloomfilter(PlannerInfo* root, Relids lefttree_relids, HashJoin*
 
         ListCell* lc = NULL;
 
+        context->build_rows = innerPlan(hash_join)->plan_rows;
+
         foreach (lc, hash_join->hashclauses) {
             Node* node = (Node*)lfirst(lc);
 
@@ -4465,7 +4513,8 @@ static void set_bloomfilter(PlannerInfo* root, Relids lefttree_relids, HashJoin*
             }
 
             /* If this hash query can filter 1/3 data, we will add bloom filter. */
-            if (join_var_ratio(root, (Var*)rexpr, (Var*)lexpr) <= EQUALJOINVARRATIO) {
+            context->ratio = join_var_ratio(root, (Var*)rexpr, (Var*)lexpr);
+            if (context->ratio <= EQUALJOINVARRATIO) {
                 search_var_and_mark_bloomfilter(root, lexpr, outer_plan, context);
             }
 
@@ -4484,7 +4533,8 @@ static void set_bloomfilter(PlannerInfo* root, Relids lefttree_relids, HashJoin*
                         /* This eq_var need be left_rel's subset. We only can add bloom filter on left plan. */
                         if (!equal(eq_var, lexpr) && !equal(eq_var, rexpr) && valid_bloom_filter_type((Var*)eq_var) &&
                             bms_is_member(eq_var->varno, lefttree_relids)) {
-                            if (join_var_ratio(root, (Var*)rexpr, eq_var) <= EQUALJOINVARRATIO) {
+                            context->ratio = join_var_ratio(root, (Var*)rexpr, eq_var);
+                            if (context->ratio <= EQUALJOINVARRATIO) {
                                 search_var_and_mark_bloomfilter(root, (Expr*)eq_var, outer_plan, context);
                             }
                         }
@@ -4629,7 +4679,12 @@ static HashJoin* create_hashjoin_plan(PlannerInfo* root, HashPath* best_path, Pl
 
     join_plan->isSonicHash = u_sess->attr.attr_sql.enable_sonic_hashjoin && isSonicHashJoinEnable(join_plan);
 
-    if (IS_STREAM_PLAN && u_sess->attr.attr_sql.enable_bloom_filter) {
+    /*
+     * Bloom filters are pushed into hdfs scans of stream plans, and into row
+     * scans as runtime join filters when enable_runtime_join_filter is on.
+     */
+    root->glob->bloomfilter.row_filter = u_sess->attr.attr_sql.enable_runtime_join_filter;
+    if ((IS_STREAM_PLAN && u_sess->attr.attr_sql.enable_bloom_filter) || root->glob->bloomfilter.row_filter) {
         left_relids = best_path->jpath.outerjoinpath->parent->relids;
         set_bloomfilter(root, left_relids, join_plan);
     }
@@ -5298,7 +5353,7 @@ static TsStoreScan* make_tsstorescan(List* qptlist, List* qpqual, Index scanreli
 }
 
 static IndexScan* make_indexscan(List* qptlist, List* qpqual, Index scanrelid, Oid indexid, List* indexqual,
-    List* indexqualorig, List* indexorderby, List* indexorderbyorig, ScanDirection indexscandir)
+    List* indexqualorig, List* indexorderby, List* indexorderbyorig, ScanDirection indexscandir, bool indexskipscan)
 {
     IndexScan* node = makeNode(IndexScan);
     Plan* plan = &node->scan.plan;
@@ -5315,12 +5370,13 @@ static IndexScan* make_indexscan(List* qptlist, List* qpqual, Index scanrelid, O
     node->indexorderby = indexorderby;
     node->indexorderbyorig = indexorderbyorig;
     node->indexorderdir = indexscandir;
+    node->indexskipscan = indexskipscan;
 
     return node;
 }
 
 static IndexOnlyScan* make_indexonlyscan(List* qptlist, List* qpqual, Index scanrelid, Oid indexid, List* indexqual,
-    List* indexorderby, List* indextlist, ScanDirection indexscandir)
+    List* indexorderby, List* indextlist, ScanDirection indexscandir, bool indexskipscan)
 {
     IndexOnlyScan* node = makeNode(IndexOnlyScan);
     Plan* plan = &node->scan.plan;
@@ -5336,6 +5392,7 @@ static IndexOnlyScan* make_indexonlyscan(List* qptlist, List* qpqual, Index scan
     node->indexorderby = indexorderby;
     node->indextlist = indextlist;
     node->indexorderdir = indexscandir;
+    node->indexskipscan = indexskipscan;
 
     return node;
 }
@@ -5464,7 +5521,8 @@ static DfsIndexScan* make_dfsindexscan(PlannerInfo* root, Path* best_path, List*
     return node;
 }
 
-static BitmapIndexScan* make_bitmap_indexscan(Index scanrelid, Oid indexid, List* indexqual, List* indexqualorig)
+static BitmapIndexScan* make_bitmap_indexscan(
+    Index scanrelid, Oid indexid, List* indexqual, List* indexqualorig, bool indexskipscan)
 {
     BitmapIndexScan* node = makeNode(BitmapIndexScan);
     Plan* plan = &node->scan.plan;
@@ -5478,6 +5536,7 @@ static BitmapIndexScan* make_bitmap_indexscan(Index scanrelid, Oid indexid, List
     node->indexid = indexid;
     node->indexqual = indexqual;
     node->indexqualorig = indexqualorig;
+    node->indexskipscan = indexskipscan;
 
     return node;
 }
@@ -5740,6 +5799,7 @@ static PartIterator* create_partIterator_plan(
 
     /* constrcut PartIterator attributes */
     partItr->plan.targetlist = partItr->plan.lefttree->targetlist;
+    partItr->pruningQuals = get_partIterator_pruning_quals(root, pIterpath->subPath, partItr->plan.lefttree);
 
     Bitmapset* extparams = (Bitmapset*)copyObject(partItr->plan.extParam);
     partItr->plan.extParam = bms_add_member(extparams, piParam->paramno);
@@ -5775,6 +5835,65 @@ static PartIterator* create_partIterator_plan(
     return partItr;
 }
 
+/*
+ * get_partIterator_pruning_quals
+ *	  Get the restriction clauses of the iterated scan that compare it with
+ *	  Params. Pruning at plan time only uses constants, so the executor prunes
+ *	  again with these once the values are known: bound parameters of a
+ *	  generic plan at executor start, outer values of a nestloop on rescan.
+ */
+static List* get_partIterator_pruning_quals(PlannerInfo* root, Path* subpath, Plan* subplan)
+{
+    List* clauses = NIL;
+    List* result = NIL;
+    ListCell* lc = NULL;
+    Scan* scan = NULL;
+    Relids scanrelids = NULL;
+
+    switch (nodeTag(subplan)) {
+        case T_SeqScan:
+        case T_IndexScan:
+        case T_IndexOnlyScan:
+        case T_BitmapHeapScan:
+        case T_TidScan:
+            scan = (Scan*)subplan;
+            break;
+        default:
+            return NIL;
+    }
+
+    if (!scan->isPartTbl || scan->itrs <= 1 || scan->pruningInfo == NULL)
+        return NIL;
+
+    clauses = list_copy(subpath->parent->baserestrictinfo);
+    if (subpath->param_info != NULL)
+        clauses = list_concat(clauses, list_copy(subpath->param_info->ppi_clauses));
+
+    scanrelids = bms_make_singleton(scan->scanrelid);
+    foreach (lc, clauses) {
+        RestrictInfo* rinfo = (RestrictInfo*)lfirst(lc);
+        Node* clause = NULL;
+
+        if (rinfo->pseudoconstant)
+            continue;
+
+        /* the outer vars of a parameterized scan become nestloop params, as in the scan quals */
+        clause = replace_nestloop_params(root, (Node*)rinfo->clause);
+        if (!check_param_expr(clause) || contain_subplans(clause) || contain_volatile_functions(clause))
+            continue;
+
+        if (!bms_equal(pull_varnos(clause), scanrelids))
+            continue;
+
+        result = lappend(result, clause);
+    }
+
+    list_free_ext(clauses);
+    bms_free_ext(scanrelids);
+
+    return result;
+}
+
 static FunctionScan* make_functionscan(List* qptlist, List* qpqual, Index scanrelid, Node* funcexpr, List* funccolnames,
     List* funccoltypes, List* funccoltypmods, List* funccolcollations)
 {
@@ -106,6 +106,8 @@ const char* ESTIMATION_ITEM = "EstimationItem";
 extern RangeTblEntry* make_dummy_remote_rte(char* relname, Alias* alias);
 extern List* reassign_nodelist(RangeTblEntry* rte, List* ori_node_list);
 extern Node* preprocess_expression(PlannerInfo* root, Node* expr, int kind);
+extern bool isSonicWindowFrameSupported(int frameOptions, Node* startOffset);
+extern bool isSonicWindowAggEnable(WindowAgg* node);
 
 void preprocess_qual_conditions(PlannerInfo* root, Node* jtnode);
 static Plan* inheritance_planner(PlannerInfo* root);
@@ -437,6 +439,8 @@ PlannedStmt* standard_planner(Query* parse, int cursorOptions, ParamListInfo bou
     glob->insideRecursion = false;
     glob->bloomfilter.bloomfilter_index = -1;
     glob->bloomfilter.add_index = true;
+    glob->bloomfilter.row_filter = false;
+    glob->bloomfilter.materialized = false;
     glob->estiopmem = esti_op_mem;
     if (IS_STREAM_PLAN)
         glob->vectorized = !vector_engine_preprocess_walker((Node*)parse, parse->rtable);
@@ -8221,9 +8225,11 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
         } break;
 
         case T_WindowAgg: {
+            /* Sonic window agg supports ROWS frames ending at the current row as well */
+            bool sonic_window = isSonicWindowAggEnable((WindowAgg*)result_plan);
 
             /* Only default window clause is supported now */
-            if (((WindowAgg*)result_plan)->frameOptions !=
+            if (!sonic_window && ((WindowAgg*)result_plan)->frameOptions !=
                 (FRAMEOPTION_RANGE | FRAMEOPTION_START_UNBOUNDED_PRECEDING | FRAMEOPTION_END_CURRENT_ROW))
                 return true;
 
@@ -8235,7 +8241,7 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
                 return true;
 
             /* Only single denserank is supported now */
-            if (context.has_agg && context.has_denserank)
+            if (context.has_agg && context.has_denserank && !sonic_window)
                 return true;
 
             /*
@@ -8689,6 +8695,7 @@ static Plan* build_vector_plan(Plan* plan)
             break;
         case T_WindowAgg:
             plan->type = T_VecWindowAgg;
+            ((WindowAgg*)plan)->is_sonicwindow = isSonicWindowAggEnable((WindowAgg*)plan);
             break;
         case T_Limit:
             plan->type = T_VecLimit;
@@ -11213,7 +11220,9 @@ static bool vector_engine_preprocess_walker(Node* node, void* rtables)
             foreach (lc, subquery->windowClause) {
                 WindowClause* wc = (WindowClause*)lfirst(lc);
                 if (wc->frameOptions !=
-                    (FRAMEOPTION_RANGE | FRAMEOPTION_START_UNBOUNDED_PRECEDING | FRAMEOPTION_END_CURRENT_ROW)) {
+                    (FRAMEOPTION_RANGE | FRAMEOPTION_START_UNBOUNDED_PRECEDING | FRAMEOPTION_END_CURRENT_ROW) &&
+                    !(u_sess->attr.attr_sql.enable_sonic_windowagg &&
+                    isSonicWindowFrameSupported(wc->frameOptions, wc->startOffset))) {
                     return true;
                 }
             }
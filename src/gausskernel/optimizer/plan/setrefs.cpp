@@ -566,6 +566,7 @@ static Plan* set_plan_refs(PlannerInfo* root, Plan* plan, int rtoffset)
                     if (splan->plan.distributed_keys != NIL) {
                         splan->plan.distributed_keys = fix_scan_list(root, splan->plan.distributed_keys, rtoffset);
                     }
+                    splan->pruningQuals = fix_scan_list(root, splan->pruningQuals, rtoffset);
                     break;
                 default:
                     set_dummy_tlist_references(plan, rtoffset);
@@ -2705,7 +2705,10 @@ static Bitmapset* finalize_plan(PlannerInfo* root, Plan* plan, Bitmapset* valid_
         case T_SetOp:
         case T_Group:
         case T_Stream:
+            break;
+
         case T_PartIterator:
+            (void)finalize_primnode((Node*)((PartIterator*)plan)->pruningQuals, &context);
             break;
 
         default:
@@ -381,7 +381,10 @@ void GetPlanNodePlainText(
             *pname = *sname = *pt_operation = "WindowAgg";
             break;
         case T_VecWindowAgg:
-            *pname = *sname = *pt_operation = "Vector WindowAgg";
+            if (((WindowAgg*)plan)->is_sonicwindow)
+                *pname = *sname = *pt_operation = "Vector Sonic WindowAgg";
+            else
+                *pname = *sname = *pt_operation = "Vector WindowAgg";
             break;
         case T_Unique:
             *pname = *sname = *pt_operation = "Unique";
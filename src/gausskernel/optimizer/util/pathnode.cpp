@@ -2957,9 +2957,10 @@ ForeignPath* create_foreignscan_path(PlannerInfo* root, RelOptInfo* rel, Cost st
          *				   foreign scan: obs table
          *			  It is comfortable to add smp foreign scan for this scenario.
          * HDFS Server: we don't add smp feature for this kind of server. No reason.
+         * Local Server: the same as OBS, the files are divided among the smp workers.
          * Others:	  Keep constant with the original logic.
          */
-        if (T_OBS_SERVER == serverType) {
+        if (T_OBS_SERVER == serverType || T_LOCAL_SERVER == serverType) {
             if ((CMD_SELECT == root->parse->commandType || CMD_INSERT == root->parse->commandType) &&
                 LOCATOR_TYPE_RROBIN == source->locator_type)
                 pathnode->path.dop = u_sess->opt_cxt.query_dop;
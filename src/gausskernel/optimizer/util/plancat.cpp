@@ -269,6 +269,7 @@ void get_relation_info(PlannerInfo* root, Oid relationObjectId, bool inhparent,
             info->reltablespace = RelationGetForm(indexRelation)->reltablespace;
             info->rel = rel;
             info->ncolumns = ncolumns = index->indnatts;
+            info->nkeycolumns = IndexRelationGetNumberOfKeyAttributes(indexRelation);
             info->indexkeys = (int*)palloc(sizeof(int) * ncolumns);
             info->indexcollations = (Oid*)palloc(sizeof(Oid) * ncolumns);
             info->opfamily = (Oid*)palloc(sizeof(Oid) * ncolumns);
@@ -1311,7 +1312,7 @@ bool has_unique_index(RelOptInfo* rel, AttrNumber attno)
          * Also, a multicolumn unique index doesn't allow us to conclude that
          * just the specified attr is unique.
          */
-        if (index->unique && index->ncolumns == 1 && index->indexkeys[0] == attno &&
+        if (index->unique && index->nkeycolumns == 1 && index->indexkeys[0] == attno &&
             (index->indpred == NIL || index->predOK))
             return true;
     }
@@ -1010,11 +1010,12 @@ static PruningResult* recordBoundaryFromOpExpr(const OpExpr* expr, PruningContex
                 errcode(ERRCODE_INVALID_PARAMETER_VALUE),
                 (errmsg("Could not find enough valid args for Boundary From OpExpr"))));
 
-    if (IsA(leftArg, Var)) {
+    /* the executor prunes without a planner, it has evaluated the args already */
+    if (context->root != NULL && IsA(leftArg, Var)) {
         node = estimate_expression_value(context->root, (Node*)rightArg);
         if (node != NULL)
             rightArg = (Expr*)node;
-    } else if (IsA(rightArg, Var)) {
+    } else if (context->root != NULL && IsA(rightArg, Var)) {
         node = estimate_expression_value(context->root, (Node*)leftArg);
         if (node != NULL)
             leftArg = (Expr*)node;
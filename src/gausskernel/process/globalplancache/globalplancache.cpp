@@ -201,6 +201,7 @@ static void GPCFillEnvSignatures(GPCEnv *env)
     env->env_signature2 |= u_sess->attr.attr_sql.enable_sonic_hashagg << 9;
     env->env_signature2 |= u_sess->attr.attr_sql.enable_sonic_hashjoin << 10;
     env->env_signature2 |= u_sess->attr.attr_sql.enable_sonic_optspill << 11;
+    env->env_signature2 |= u_sess->attr.attr_sql.enable_sonic_windowagg << 12;
 #ifdef ENABLE_MULTIPLE_NODES
     env->env_signature2 |= u_sess->attr.attr_sql.enable_csqual_pushdown << 13;
 #endif
@@ -208,6 +209,8 @@ static void GPCFillEnvSignatures(GPCEnv *env)
     env->env_signature2 |= u_sess->attr.attr_sql.enable_light_proxy << 15;
     env->env_signature2 |= u_sess->attr.attr_sql.enable_early_free << 16;
     env->env_signature2 |= u_sess->attr.attr_sql.enable_opfusion << 17;
+    env->env_signature2 |= u_sess->attr.attr_sql.enable_runtime_join_filter << 18;
+    env->env_signature2 |= u_sess->attr.attr_sql.enable_indexskipscan << 19;
 }
 
 void GlobalPlanCache::GetSchemaName(GPCEnv *env)
@@ -2840,7 +2840,7 @@ static PgStat_StatTabEntry* get_pgstat_tabentry_relid(
 
         tabkey.statFlag = statFlag;
         tabkey.tableid = relid;
-        tabentry = (PgStat_StatTabEntry*)hash_search(dnentry->tables, (void*)(&tabkey), HASH_FIND, NULL);
+        tabentry = pgstat_fetch_stat_tabentry_db(dnentry->databaseid, &tabkey);
     }
 
     return tabentry;
@@ -342,15 +342,18 @@ static void pgstat_beshutdown_hook(int code, Datum arg);
 static void pgstat_sighup_handler(SIGNAL_ARGS);
 
 static PgStat_StatDBEntry* pgstat_get_db_entry(Oid databaseid, bool create);
-static PgStat_StatTabEntry* pgstat_get_tab_entry(
-    PgStat_StatDBEntry* dbentry, Oid tableoid, bool create, uint32 statFlag);
 static void pgstat_write_statsfile(bool permanent);
-static HTAB* pgstat_read_statsfile(Oid onlydb, bool permanent);
+static HTAB* pgstat_read_statsfile(bool permanent);
 static void backend_read_statsfile(void);
 static void pgstat_read_current_status(void);
 
 static void pgstat_send_tabstat(PgStat_MsgTabstat* tsmsg);
 static void pgstat_send_funcstats(void);
+static void CreateSharedTableStats(void);
+static PgStat_StatTabEntry* pgstat_lock_shared_tabentry(Oid databaseid, Oid tableoid, uint32 statFlag, LWLock** lock);
+static void pgstat_flush_tabcounts(Oid databaseid, const PgStat_TableStatus* entry);
+static void pgstat_flush_funccounts(Oid databaseid, const PgStat_BackendFunctionEntry* entry);
+static void pgstat_remove_shared_entries(Oid databaseid, bool alldbs);
 static HTAB* pgstat_collect_oids(Oid catalogid);
 static HTAB* pgstat_collect_tabkeys(void);
 static PgStat_TableStatus* get_tabstat_entry(Oid rel_id, bool isshared, uint32 statFlag);
@@ -365,24 +368,16 @@ static void pgstat_send(void* msg, int len);
 
 static void pgstat_recv_inquiry(PgStat_MsgInquiry* msg);
 static void pgstat_recv_tabstat(PgStat_MsgTabstat* msg);
-static void pgstat_recv_tabpurge(PgStat_MsgTabpurge* msg);
 static void pgstat_recv_dropdb(PgStat_MsgDropdb* msg);
 static void pgstat_recv_resetcounter(PgStat_MsgResetcounter* msg);
 static void pgstat_recv_resetsharedcounter(PgStat_MsgResetsharedcounter* msg);
 static void pgstat_recv_resetsinglecounter(PgStat_MsgResetsinglecounter* msg);
 static void pgstat_recv_autovac(PgStat_MsgAutovacStart* msg);
-static void pgstat_recv_vacuum(PgStat_MsgVacuum* msg);
-static void pgstat_recv_data_changed(PgStat_MsgDataChanged* msg);
-static void pgstat_recv_truncate(PgStat_MsgTruncate* msg);
-static void pgstat_recv_analyze(PgStat_MsgAnalyze* msg);
 static void pgstat_recv_bgwriter(PgStat_MsgBgWriter* msg);
-static void pgstat_recv_funcstat(PgStat_MsgFuncstat* msg);
-static void pgstat_recv_funcpurge(PgStat_MsgFuncpurge* msg);
 static void pgstat_recv_recoveryconflict(PgStat_MsgRecoveryConflict* msg);
 static void pgstat_recv_deadlock(PgStat_MsgDeadlock* msg);
 static void pgstat_recv_tempfile(PgStat_MsgTempFile* msg);
 static void pgstat_recv_memReserved(PgStat_MsgMemReserved* msg);
-static void pgstat_recv_autovac_stat(PgStat_MsgAutovacStat* msg);
 
 static void pgstat_send_badblock_stat(void);
 static void pgstat_recv_badblock_stat(PgStat_MsgBadBlock* msg);
@@ -437,6 +432,9 @@ void pgstat_init(void)
 
 #define TESTBYTEVAL ((char)199)
 
+    /* The table and function statistics live in shared memory */
+    CreateSharedTableStats();
+
     /*
      * Create the UDP socket for sending and receiving statistic messages
      */
@@ -682,8 +680,8 @@ startup_failed:
 /*
  * pgstat_reset_all() -
  *
- * Remove the stats file.  This is currently used only if WAL
- * recovery is needed after a crash.
+ * Remove the stats file and the shared table and function statistics.
+ * This is currently used only if WAL recovery is needed after a crash.
  */
 void pgstat_reset_all(void)
 {
@@ -693,6 +691,7 @@ void pgstat_reset_all(void)
         PGSTAT_STAT_PERMANENT_FILENAME);
     unlink(u_sess->stat_cxt.pgstat_stat_filename);
     unlink(PGSTAT_STAT_PERMANENT_FILENAME);
+    pgstat_remove_shared_entries(InvalidOid, true);
 }
 
 /*
@@ -735,6 +734,224 @@ void allow_immediate_pgstat_restart(void)
     g_instance.stat_cxt.last_pgstat_start_time = 0;
 }
 
+/* ------------------------------------------------------------
+ * Shared table and function statistics
+ *
+ * The per-table and per-function counters are kept in two partitioned
+ * hash tables in shared memory.  Backends add the counts they collected
+ * to them when flushing in pgstat_report_stat(), and the SQL-callable
+ * functions and autovacuum read them directly, so neither the counters
+ * nor the readers go through the collector and its stats file.  The
+ * collector still keeps the database-wide and global counters, and saves
+ * the shared entries into the permanent stats file at shutdown.
+ * ------------------------------------------------------------
+ */
+#define PgStatPartitionLockByIndex(i) GetMainLWLockByIndex(FirstPgStatMappingLock + (i))
+#define PgStatPartitionLock(hashcode) PgStatPartitionLockByIndex((hashcode) % NUM_PGSTAT_PARTITIONS)
+
+/*
+ * Create the shared table and function statistics hash tables
+ * during postmaster startup.
+ */
+static void CreateSharedTableStats(void)
+{
+    HASHCTL hash_ctl;
+    errno_t rc;
+
+    if (g_instance.stat_cxt.PgStatTabHash != NULL)
+        return;
+
+    g_instance.stat_cxt.PgStatSharedContext = AllocSetContextCreate(g_instance.instance_context,
+        "PgStatSharedContext",
+        ALLOCSET_DEFAULT_MINSIZE,
+        ALLOCSET_DEFAULT_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE,
+        SHARED_CONTEXT);
+
+    rc = memset_s(&hash_ctl, sizeof(hash_ctl), 0, sizeof(hash_ctl));
+    securec_check(rc, "\0", "\0");
+    hash_ctl.keysize = sizeof(PgStat_SharedTabKey);
+    hash_ctl.entrysize = sizeof(PgStat_SharedTabEntry);
+    hash_ctl.hash = tag_hash;
+    hash_ctl.hcxt = g_instance.stat_cxt.PgStatSharedContext;
+    hash_ctl.num_partitions = NUM_PGSTAT_PARTITIONS;
+    /* a partitioned hash table can't grow its directory, size it for track_stat_tables */
+    g_instance.stat_cxt.PgStatTabHash = hash_create("Shared table stat hash",
+        g_instance.attr.attr_common.pgstat_track_tables,
+        &hash_ctl,
+        HASH_ELEM | HASH_FUNCTION | HASH_SHRCTX | HASH_PARTITION);
+
+    hash_ctl.keysize = sizeof(PgStat_SharedFuncKey);
+    hash_ctl.entrysize = sizeof(PgStat_SharedFuncEntry);
+    g_instance.stat_cxt.PgStatFuncHash = hash_create("Shared function stat hash",
+        PGSTAT_FUNCTION_HASH_SIZE,
+        &hash_ctl,
+        HASH_ELEM | HASH_FUNCTION | HASH_SHRCTX | HASH_PARTITION);
+}
+
+/*
+ * Find or create the shared entry of a table, and return it with its
+ * partition locked exclusively.  Returns NULL if there is no shared memory
+ * left for a new entry; *lock is held in either case and the caller must
+ * release it.
+ */
+static PgStat_StatTabEntry* pgstat_lock_shared_tabentry(Oid databaseid, Oid tableoid, uint32 statFlag, LWLock** lock)
+{
+    PgStat_SharedTabKey key;
+    PgStat_SharedTabEntry* entry = NULL;
+    uint32 hashcode;
+    bool found = false;
+
+    key.databaseid = databaseid;
+    key.tabkey.tableid = tableoid;
+    key.tabkey.statFlag = statFlag;
+    hashcode = get_hash_value(g_instance.stat_cxt.PgStatTabHash, (void*)&key);
+
+    *lock = PgStatPartitionLock(hashcode);
+    LWLockAcquire(*lock, LW_EXCLUSIVE);
+
+    entry = (PgStat_SharedTabEntry*)hash_search_with_hash_value(
+        g_instance.stat_cxt.PgStatTabHash, (void*)&key, hashcode, HASH_ENTER_NULL, &found);
+    if (entry == NULL)
+        return NULL;
+
+    if (!found) {
+        errno_t rc = memset_s(&entry->tabentry, sizeof(PgStat_StatTabEntry), 0, sizeof(PgStat_StatTabEntry));
+        securec_check(rc, "\0", "\0");
+        entry->tabentry.tablekey = key.tabkey;
+    }
+
+    return &entry->tabentry;
+}
+
+static void pgstat_add_tabcounts(PgStat_StatTabEntry* tabentry, const PgStat_TableCounts* counts)
+{
+    tabentry->numscans += counts->t_numscans;
+    tabentry->tuples_returned += counts->t_tuples_returned;
+    tabentry->tuples_fetched += counts->t_tuples_fetched;
+    tabentry->tuples_inserted += counts->t_tuples_inserted;
+    tabentry->tuples_updated += counts->t_tuples_updated;
+    tabentry->tuples_deleted += counts->t_tuples_deleted;
+    tabentry->tuples_hot_updated += counts->t_tuples_hot_updated;
+    tabentry->n_live_tuples += counts->t_delta_live_tuples;
+    tabentry->n_dead_tuples += counts->t_delta_dead_tuples;
+    tabentry->changes_since_analyze += counts->t_changed_tuples;
+    tabentry->blocks_fetched += counts->t_blocks_fetched;
+    tabentry->blocks_hit += counts->t_blocks_hit;
+    tabentry->cu_mem_hit += counts->t_cu_mem_hit;
+    tabentry->cu_hdd_sync += counts->t_cu_hdd_sync;
+    tabentry->cu_hdd_asyn += counts->t_cu_hdd_asyn;
+}
+
+/*
+ * Add the counts a backend collected for one table to its shared entry,
+ * and to the entry of the partitioned table if it is a partition.
+ */
+static void pgstat_flush_tabcounts(Oid databaseid, const PgStat_TableStatus* entry)
+{
+    PgStat_StatTabEntry* tabentry = NULL;
+    LWLock* lock = NULL;
+
+    /* no shared statistics without the collector, e.g. in single-user mode */
+    if (g_instance.stat_cxt.PgStatTabHash == NULL)
+        return;
+
+    tabentry = pgstat_lock_shared_tabentry(databaseid, entry->t_id, entry->t_statFlag, &lock);
+    if (tabentry != NULL) {
+        pgstat_add_tabcounts(tabentry, &entry->t_counts);
+
+        /* Clamp n_live_tuples in case of negative delta_live_tuples */
+        tabentry->n_live_tuples = Max(tabentry->n_live_tuples, 0);
+        /* Likewise for n_dead_tuples */
+        tabentry->n_dead_tuples = Max(tabentry->n_dead_tuples, 0);
+    }
+    LWLockRelease(lock);
+
+    /* partitioned table alse should record UDI info */
+    if (pg_stat_relation(entry->t_statFlag))
+        return;
+
+    tabentry = pgstat_lock_shared_tabentry(databaseid, entry->t_statFlag, InvalidOid, &lock);
+    if (tabentry != NULL)
+        pgstat_add_tabcounts(tabentry, &entry->t_counts);
+    LWLockRelease(lock);
+}
+
+/*
+ * Add the counts a backend collected for one function to its shared entry.
+ */
+static void pgstat_flush_funccounts(Oid databaseid, const PgStat_BackendFunctionEntry* entry)
+{
+    PgStat_SharedFuncKey key;
+    PgStat_SharedFuncEntry* funcentry = NULL;
+    uint32 hashcode;
+    LWLock* lock = NULL;
+    bool found = false;
+
+    if (g_instance.stat_cxt.PgStatFuncHash == NULL)
+        return;
+
+    key.databaseid = databaseid;
+    key.functionid = entry->f_id;
+    hashcode = get_hash_value(g_instance.stat_cxt.PgStatFuncHash, (void*)&key);
+
+    lock = PgStatPartitionLock(hashcode);
+    LWLockAcquire(lock, LW_EXCLUSIVE);
+
+    funcentry = (PgStat_SharedFuncEntry*)hash_search_with_hash_value(
+        g_instance.stat_cxt.PgStatFuncHash, (void*)&key, hashcode, HASH_ENTER_NULL, &found);
+    if (funcentry != NULL) {
+        /* need to convert format of time accumulators */
+        if (!found) {
+            funcentry->funcentry.functionid = entry->f_id;
+            funcentry->funcentry.f_numcalls = entry->f_counts.f_numcalls;
+            funcentry->funcentry.f_total_time = INSTR_TIME_GET_MICROSEC(entry->f_counts.f_total_time);
+            funcentry->funcentry.f_self_time = INSTR_TIME_GET_MICROSEC(entry->f_counts.f_self_time);
+        } else {
+            funcentry->funcentry.f_numcalls += entry->f_counts.f_numcalls;
+            funcentry->funcentry.f_total_time += INSTR_TIME_GET_MICROSEC(entry->f_counts.f_total_time);
+            funcentry->funcentry.f_self_time += INSTR_TIME_GET_MICROSEC(entry->f_counts.f_self_time);
+        }
+    }
+
+    LWLockRelease(lock);
+}
+
+/*
+ * Remove the shared table and function entries of a database, or of all
+ * databases if alldbs is true.  The partitions are cleaned one at a time,
+ * so backends flushing to the other partitions are not held up.
+ */
+static void pgstat_remove_shared_entries(Oid databaseid, bool alldbs)
+{
+    HASH_SEQ_STATUS hstat;
+    PgStat_SharedTabEntry* tabentry = NULL;
+    PgStat_SharedFuncEntry* funcentry = NULL;
+
+    if (g_instance.stat_cxt.PgStatTabHash == NULL)
+        return;
+
+    for (uint32 i = 0; i < NUM_PGSTAT_PARTITIONS; i++) {
+        LWLock* lock = PgStatPartitionLockByIndex(i);
+
+        LWLockAcquire(lock, LW_EXCLUSIVE);
+
+        hash_seq_init_partition(&hstat, g_instance.stat_cxt.PgStatTabHash, i);
+        while ((tabentry = (PgStat_SharedTabEntry*)hash_seq_search(&hstat)) != NULL) {
+            if (alldbs || tabentry->key.databaseid == databaseid)
+                (void)hash_search(g_instance.stat_cxt.PgStatTabHash, (void*)&tabentry->key, HASH_REMOVE, NULL);
+        }
+
+        hash_seq_init_partition(&hstat, g_instance.stat_cxt.PgStatFuncHash, i);
+        while ((funcentry = (PgStat_SharedFuncEntry*)hash_seq_search(&hstat)) != NULL) {
+            if (alldbs || funcentry->key.databaseid == databaseid)
+                (void)hash_search(g_instance.stat_cxt.PgStatFuncHash, (void*)&funcentry->key, HASH_REMOVE, NULL);
+        }
+
+        LWLockRelease(lock);
+    }
+}
+
 /* ------------------------------------------------------------
  * Public functions used by backends follow
  * ------------------------------------------------------------
@@ -769,10 +986,11 @@ static void pgstat_free_tablist(void)
 /* ----------
  * pgstat_report_stat() -
  *
- *	Called from tcop/postgres.c to send the so far collected per-table
- *	and function usage statistics to the collector.  Note that this is
- *	called only when not within a transaction, so it is fair to use
- *	transaction stop time as an approximation of current time.
+ *	Called from tcop/postgres.c to flush the so far collected per-table
+ *	and function usage statistics to shared memory, and to send their
+ *	database-wide sums to the collector.  Note that this is called only
+ *	when not within a transaction, so it is fair to use transaction stop
+ *	time as an approximation of current time.
  * ----------
  */
 void pgstat_report_stat(bool force)
@@ -808,14 +1026,16 @@ void pgstat_report_stat(bool force)
 
     /*
      * Scan through the TabStatusArray struct(s) to find tables that actually
-     * have counts, and build messages to send.  We have to separate shared
-     * relations from regular ones because the databaseid field in the message
-     * header has to depend on that.
+     * have counts, and flush them.  We have to separate shared relations from
+     * regular ones because the databaseid of both the shared entry and the
+     * message to send has to depend on that.
      */
+    rc = memset_s(&regular_msg, sizeof(PgStat_MsgTabstat), 0, sizeof(PgStat_MsgTabstat));
+    securec_check(rc, "\0", "\0");
+    rc = memset_s(&shared_msg, sizeof(PgStat_MsgTabstat), 0, sizeof(PgStat_MsgTabstat));
+    securec_check(rc, "\0", "\0");
     regular_msg.m_databaseid = u_sess->proc_cxt.MyDatabaseId;
     shared_msg.m_databaseid = InvalidOid;
-    regular_msg.m_nentries = 0;
-    shared_msg.m_nentries = 0;
 
     DEBUG_MOD_START_TIMER(MOD_AUTOVAC);
 
@@ -825,7 +1045,6 @@ void pgstat_report_stat(bool force)
         for (i = 0; i < tsa->tsa_used; i++) {
             PgStat_TableStatus* entry = &tsa->tsa_entries[i];
             PgStat_MsgTabstat* this_msg = NULL;
-            PgStat_TableEntry* this_ent = NULL;
 
             /* Shouldn't have any pending transaction-dependent counts */
             Assert(entry->trans == NULL);
@@ -838,19 +1057,23 @@ void pgstat_report_stat(bool force)
                 continue;
 
             /*
-             * OK, insert data into the appropriate message, and send if full.
+             * OK, add the counts to the shared entry of the table, and to the
+             * database-wide sums of the appropriate message.
              */
             this_msg = entry->t_shared ? &shared_msg : &regular_msg;
-            this_ent = &this_msg->m_entry[this_msg->m_nentries];
-            this_ent->t_id = entry->t_id;
-            this_ent->t_statFlag = entry->t_statFlag;
-            rc =
-                memcpy_s(&this_ent->t_counts, sizeof(PgStat_TableCounts), &entry->t_counts, sizeof(PgStat_TableCounts));
-            securec_check(rc, "", "");
-            if ((unsigned int)++this_msg->m_nentries >= PGSTAT_NUM_TABENTRIES) {
-                pgstat_send_tabstat(this_msg);
-                this_msg->m_nentries = 0;
-            }
+            pgstat_flush_tabcounts(this_msg->m_databaseid, entry);
+
+            this_msg->m_counts.t_tuples_returned += entry->t_counts.t_tuples_returned;
+            this_msg->m_counts.t_tuples_fetched += entry->t_counts.t_tuples_fetched;
+            this_msg->m_counts.t_tuples_inserted += entry->t_counts.t_tuples_inserted;
+            this_msg->m_counts.t_tuples_updated += entry->t_counts.t_tuples_updated;
+            this_msg->m_counts.t_tuples_deleted += entry->t_counts.t_tuples_deleted;
+            this_msg->m_counts.t_blocks_fetched += entry->t_counts.t_blocks_fetched;
+            this_msg->m_counts.t_blocks_hit += entry->t_counts.t_blocks_hit;
+            this_msg->m_counts.t_cu_mem_hit += entry->t_counts.t_cu_mem_hit;
+            this_msg->m_counts.t_cu_hdd_sync += entry->t_counts.t_cu_hdd_sync;
+            this_msg->m_counts.t_cu_hdd_asyn += entry->t_counts.t_cu_hdd_asyn;
+            this_msg->m_ntables++;
         }
         /* zero out TableStatus structs after use */
         rc = memset_s(tsa->tsa_entries,
@@ -880,22 +1103,22 @@ void pgstat_report_stat(bool force)
     u_sess->stat_cxt.pgStatTabHash = NULL;
 
     /*
-     * Send partial messages.  If force is true, make sure that any pending
-     * xact commit/abort gets counted, even if no table stats to send.
+     * Send the database-wide sums.  If force is true, make sure that any
+     * pending xact commit/abort gets counted, even if no table stats to send.
      */
-    if (regular_msg.m_nentries > 0 ||
+    if (regular_msg.m_ntables > 0 ||
         (force && (u_sess->stat_cxt.pgStatXactCommit > 0 || u_sess->stat_cxt.pgStatXactRollback > 0)))
         pgstat_send_tabstat(&regular_msg);
-    if (shared_msg.m_nentries > 0)
+    if (shared_msg.m_ntables > 0)
         pgstat_send_tabstat(&shared_msg);
 
-    /* Now, send function statistics */
+    /* Now, flush function statistics */
     pgstat_send_funcstats();
 
     /* send badblock statistics */
     pgstat_send_badblock_stat();
 
-    DEBUG_MOD_STOP_TIMER(MOD_AUTOVAC, "send collected usage statistics to collector");
+    DEBUG_MOD_STOP_TIMER(MOD_AUTOVAC, "flush collected usage statistics");
 
     /* check the list' length and destroy it if needed */
     if (force_to_destory) {
@@ -908,9 +1131,6 @@ void pgstat_report_stat(bool force)
  */
 static void pgstat_send_tabstat(PgStat_MsgTabstat* tsmsg)
 {
-    int n;
-    int len;
-
     /* It's unlikely we'd get here with no socket, but maybe not impossible */
     if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET)
         return;
@@ -935,226 +1155,185 @@ static void pgstat_send_tabstat(PgStat_MsgTabstat* tsmsg)
         tsmsg->m_block_write_time = 0;
     }
 
-    n = tsmsg->m_nentries;
-    len = offsetof(PgStat_MsgTabstat, m_entry[0]) + n * sizeof(PgStat_TableEntry);
-
     pgstat_setheader(&tsmsg->m_hdr, PGSTAT_MTYPE_TABSTAT);
-    pgstat_send(tsmsg, len);
+    pgstat_send(tsmsg, sizeof(PgStat_MsgTabstat));
 }
 
 /*
- * Subroutine for pgstat_report_stat: populate and send a function stat message
+ * Subroutine for pgstat_report_stat: flush function statistics to shared memory
  */
 static void pgstat_send_funcstats(void)
 {
     /* we assume this inits to all zeroes: */
     static const PgStat_FunctionCounts all_zeroes = {0};
 
-    PgStat_MsgFuncstat msg;
     PgStat_BackendFunctionEntry* entry = NULL;
     HASH_SEQ_STATUS fstat;
 
     if (u_sess->stat_cxt.pgStatFunctions == NULL)
         return;
 
-    pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_FUNCSTAT);
-    msg.m_databaseid = u_sess->proc_cxt.MyDatabaseId;
-    msg.m_nentries = 0;
-
     hash_seq_init(&fstat, u_sess->stat_cxt.pgStatFunctions);
     while ((entry = (PgStat_BackendFunctionEntry*)hash_seq_search(&fstat)) != NULL) {
-        PgStat_FunctionEntry* m_ent = NULL;
         errno_t rc;
 
         /* Skip it if no counts accumulated since last time */
         if (memcmp(&entry->f_counts, &all_zeroes, sizeof(PgStat_FunctionCounts)) == 0)
             continue;
 
-        /* need to convert format of time accumulators */
-        m_ent = &msg.m_entry[msg.m_nentries];
-        m_ent->f_id = entry->f_id;
-        m_ent->f_numcalls = entry->f_counts.f_numcalls;
-        m_ent->f_total_time = INSTR_TIME_GET_MICROSEC(entry->f_counts.f_total_time);
-        m_ent->f_self_time = INSTR_TIME_GET_MICROSEC(entry->f_counts.f_self_time);
-
-        if ((unsigned int)++msg.m_nentries >= PGSTAT_NUM_FUNCENTRIES) {
-            pgstat_send(&msg, offsetof(PgStat_MsgFuncstat, m_entry[0]) + msg.m_nentries * sizeof(PgStat_FunctionEntry));
-            msg.m_nentries = 0;
-        }
+        pgstat_flush_funccounts(u_sess->proc_cxt.MyDatabaseId, entry);
 
         /* reset the entry's counts */
         rc = memset_s(&entry->f_counts, sizeof(PgStat_FunctionCounts), 0, sizeof(PgStat_FunctionCounts));
         securec_check(rc, "\0", "\0");
     }
 
-    if (msg.m_nentries > 0)
-        pgstat_send(&msg, offsetof(PgStat_MsgFuncstat, m_entry[0]) + msg.m_nentries * sizeof(PgStat_FunctionEntry));
-
     u_sess->stat_cxt.have_function_stats = false;
 }
 
 /* ----------
  * pgstat_vacuum_stat() -
  *
- *	Will tell the collector about objects he can get rid of.
+ *	Will tell the collector about databases he can get rid of, and remove
+ *	the shared statistics of dead tables and functions.
  * ----------
  */
 void pgstat_vacuum_stat(void)
 {
     HTAB* htab = NULL;
-    PgStat_MsgTabpurge msg;
-    PgStat_MsgFuncpurge f_msg;
+    HTAB* funchtab = NULL;
     HASH_SEQ_STATUS hstat;
     PgStat_StatDBEntry* dbentry = NULL;
-    PgStat_StatTabEntry* tabentry = NULL;
-    PgStat_StatFuncEntry* funcentry = NULL;
-    int len;
-
-    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET)
-        return;
+    PgStat_SharedTabEntry* tabentry = NULL;
+    PgStat_SharedFuncEntry* funcentry = NULL;
+    List* deadparts = NIL;
+    ListCell* lc = NULL;
+    Oid mydbid = u_sess->proc_cxt.MyDatabaseId;
 
     /*
-     * If not done for this transaction, read the statistics collector stats
-     * file into some hash tables.
+     * The database-wide counters are still kept by the collector, so dead
+     * databases are only found through its stats file.
      */
-    backend_read_statsfile();
+    if (g_instance.stat_cxt.pgStatSock != PGINVALID_SOCKET) {
+        /*
+         * If not done for this transaction, read the statistics collector
+         * stats file into some hash tables.
+         */
+        backend_read_statsfile();
 
-    /*
-     * Read pg_database and make a list of OIDs of all existing databases
-     */
-    htab = pgstat_collect_oids(DatabaseRelationId);
+        /*
+         * Read pg_database and make a list of OIDs of all existing databases
+         */
+        htab = pgstat_collect_oids(DatabaseRelationId);
 
-    /*
-     * Search the database hash table for dead databases and tell the
-     * collector to drop them.
-     */
-    hash_seq_init(&hstat, u_sess->stat_cxt.pgStatDBHash);
-    while ((dbentry = (PgStat_StatDBEntry*)hash_seq_search(&hstat)) != NULL) {
-        Oid dbid = dbentry->databaseid;
+        /*
+         * Search the database hash table for dead databases and tell the
+         * collector to drop them.
+         */
+        hash_seq_init(&hstat, u_sess->stat_cxt.pgStatDBHash);
+        while ((dbentry = (PgStat_StatDBEntry*)hash_seq_search(&hstat)) != NULL) {
+            Oid dbid = dbentry->databaseid;
 
-        CHECK_FOR_INTERRUPTS();
+            CHECK_FOR_INTERRUPTS();
 
-        /* the DB entry for shared tables (with InvalidOid) is never dropped */
-        if (OidIsValid(dbid) && hash_search(htab, (void*)&dbid, HASH_FIND, NULL) == NULL)
-            pgstat_drop_database(dbid);
-    }
+            /* the DB entry for shared tables (with InvalidOid) is never dropped */
+            if (OidIsValid(dbid) && hash_search(htab, (void*)&dbid, HASH_FIND, NULL) == NULL)
+                pgstat_drop_database(dbid);
+        }
 
-    /* Clean up */
-    hash_destroy(htab);
+        /* Clean up */
+        hash_destroy(htab);
+    }
 
-    /*
-     * Lookup our own database entry; if not found, nothing more to do.
-     */
-    dbentry = (PgStat_StatDBEntry*)hash_search(
-        u_sess->stat_cxt.pgStatDBHash, (void*)&u_sess->proc_cxt.MyDatabaseId, HASH_FIND, NULL);
-    if (dbentry == NULL || dbentry->tables == NULL)
+    if (g_instance.stat_cxt.PgStatTabHash == NULL)
         return;
 
     /*
-     * Similarly to above, make a list of all known relations in this DB.
+     * Similarly to above, make a list of all known relations in this DB,
+     * and of all known functions if any function stats are being collected.
      */
     htab = pgstat_collect_tabkeys();
+    if (hash_get_num_entries(g_instance.stat_cxt.PgStatFuncHash) > 0)
+        funchtab = pgstat_collect_oids(ProcedureRelationId);
 
     /*
-     * Initialize our messages table counter to zero
-     */
-    msg.m_nentries = 0;
-
-    /*
-     * Check for all tables listed in stats hashtable if they still exist.
+     * Check for all tables and functions of this DB in the shared hashtables
+     * if they still exist, and remove them if not.  Only one partition is
+     * locked at a time; the counts of dead partitions are remembered and
+     * taken off their partitioned tables afterwards, because the parent's
+     * entry may live in another partition.
      */
-    hash_seq_init(&hstat, dbentry->tables);
-    while ((tabentry = (PgStat_StatTabEntry*)hash_seq_search(&hstat)) != NULL) {
-        PgStat_StatTabKey tabkey = tabentry->tablekey;
+    for (uint32 i = 0; i < NUM_PGSTAT_PARTITIONS; i++) {
+        LWLock* lock = PgStatPartitionLockByIndex(i);
 
         CHECK_FOR_INTERRUPTS();
 
-        if (hash_search(htab, (void*)(&tabkey), HASH_FIND, NULL) != NULL)
-            continue;
+        LWLockAcquire(lock, LW_EXCLUSIVE);
 
-        /*
-         * Not there, so add this table's Oid to the message
-         */
-        msg.m_entry[msg.m_nentries].m_tableid = tabkey.tableid;
-        msg.m_entry[msg.m_nentries].m_statFlag = tabkey.statFlag;
-        msg.m_nentries++;
+        hash_seq_init_partition(&hstat, g_instance.stat_cxt.PgStatTabHash, i);
+        while ((tabentry = (PgStat_SharedTabEntry*)hash_seq_search(&hstat)) != NULL) {
+            if (tabentry->key.databaseid != mydbid ||
+                hash_search(htab, (void*)&tabentry->key.tabkey, HASH_FIND, NULL) != NULL)
+                continue;
 
-        /*
-         * If the message is full, send it out and reinitialize to empty
-         */
-        if ((unsigned int)msg.m_nentries >= PGSTAT_NUM_TABPURGE) {
-            len = offsetof(PgStat_MsgTabpurge, m_entry[0]) + msg.m_nentries * sizeof(PgStat_MsgTabEntry);
+            if (tabentry->key.tabkey.statFlag) {
+                PgStat_SharedTabEntry* dead = (PgStat_SharedTabEntry*)palloc(sizeof(PgStat_SharedTabEntry));
 
-            pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_TABPURGE);
-            msg.m_databaseid = u_sess->proc_cxt.MyDatabaseId;
-            pgstat_send(&msg, len);
+                *dead = *tabentry;
+                deadparts = lappend(deadparts, dead);
+            }
 
-            msg.m_nentries = 0;
+            (void)hash_search(g_instance.stat_cxt.PgStatTabHash, (void*)&tabentry->key, HASH_REMOVE, NULL);
         }
-    }
-
-    /*
-     * Send the rest
-     */
-    if (msg.m_nentries > 0) {
-        len = offsetof(PgStat_MsgTabpurge, m_entry[0]) + msg.m_nentries * sizeof(PgStat_MsgTabEntry);
-
-        pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_TABPURGE);
-        msg.m_databaseid = u_sess->proc_cxt.MyDatabaseId;
-        pgstat_send(&msg, len);
-    }
-
-    /* Clean up */
-    hash_destroy(htab);
-
-    /*
-     * Now repeat the above steps for functions.  However, we needn't bother
-     * in the common case where no function stats are being collected.
-     */
-    if (dbentry->functions != NULL && hash_get_num_entries(dbentry->functions) > 0) {
-        htab = pgstat_collect_oids(ProcedureRelationId);
-
-        pgstat_setheader(&f_msg.m_hdr, PGSTAT_MTYPE_FUNCPURGE);
-        f_msg.m_databaseid = u_sess->proc_cxt.MyDatabaseId;
-        f_msg.m_nentries = 0;
 
-        hash_seq_init(&hstat, dbentry->functions);
-        while ((funcentry = (PgStat_StatFuncEntry*)hash_seq_search(&hstat)) != NULL) {
-            Oid funcid = funcentry->functionid;
-
-            CHECK_FOR_INTERRUPTS();
+        if (funchtab != NULL) {
+            hash_seq_init_partition(&hstat, g_instance.stat_cxt.PgStatFuncHash, i);
+            while ((funcentry = (PgStat_SharedFuncEntry*)hash_seq_search(&hstat)) != NULL) {
+                Oid funcid = funcentry->key.functionid;
 
-            if (hash_search(htab, (void*)&funcid, HASH_FIND, NULL) != NULL)
-                continue;
+                if (funcentry->key.databaseid != mydbid ||
+                    hash_search(funchtab, (void*)&funcid, HASH_FIND, NULL) != NULL)
+                    continue;
 
-            /*
-             * Not there, so add this function's Oid to the message
-             */
-            f_msg.m_functionid[f_msg.m_nentries++] = funcid;
+                (void)hash_search(g_instance.stat_cxt.PgStatFuncHash, (void*)&funcentry->key, HASH_REMOVE, NULL);
+            }
+        }
 
-            /*
-             * If the message is full, send it out and reinitialize to empty
-             */
-            if ((unsigned int)f_msg.m_nentries >= PGSTAT_NUM_FUNCPURGE) {
-                len = offsetof(PgStat_MsgFuncpurge, m_functionid[0]) + f_msg.m_nentries * sizeof(Oid);
+        LWLockRelease(lock);
+    }
 
-                pgstat_send(&f_msg, len);
+    /* modify parent table's stat info if a dead entry was a patition */
+    foreach (lc, deadparts) {
+        PgStat_SharedTabEntry* dead = (PgStat_SharedTabEntry*)lfirst(lc);
+        PgStat_SharedTabKey parentkey;
+        PgStat_SharedTabEntry* parententry = NULL;
+        uint32 hashcode;
+        LWLock* lock = NULL;
 
-                f_msg.m_nentries = 0;
-            }
-        }
+        parentkey.databaseid = mydbid;
+        parentkey.tabkey.tableid = dead->key.tabkey.statFlag;
+        parentkey.tabkey.statFlag = InvalidOid;
+        hashcode = get_hash_value(g_instance.stat_cxt.PgStatTabHash, (void*)&parentkey);
 
-        /*
-         * Send the rest
-         */
-        if (f_msg.m_nentries > 0) {
-            len = offsetof(PgStat_MsgFuncpurge, m_functionid[0]) + f_msg.m_nentries * sizeof(Oid);
+        lock = PgStatPartitionLock(hashcode);
+        LWLockAcquire(lock, LW_EXCLUSIVE);
+        parententry = (PgStat_SharedTabEntry*)hash_search_with_hash_value(
+            g_instance.stat_cxt.PgStatTabHash, (void*)&parentkey, hashcode, HASH_FIND, NULL);
+        if (parententry != NULL) {
+            PgStat_StatTabEntry* parent = &parententry->tabentry;
 
-            pgstat_send(&f_msg, len);
+            parent->n_dead_tuples = Max(0, parent->n_dead_tuples - dead->tabentry.n_dead_tuples);
+            parent->n_live_tuples = Max(0, parent->n_live_tuples - dead->tabentry.n_live_tuples);
+            parent->changes_since_analyze += dead->tabentry.changes_since_analyze;
         }
-
-        hash_destroy(htab);
+        LWLockRelease(lock);
     }
+
+    /* Clean up */
+    list_free_deep(deadparts);
+    hash_destroy(htab);
+    if (funchtab != NULL)
+        hash_destroy(funchtab);
 }
 
 /* ----------
@@ -1274,6 +1453,8 @@ void pgstat_drop_database(Oid databaseid)
 {
     PgStat_MsgDropdb msg;
 
+    pgstat_remove_shared_entries(databaseid, false);
+
     if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET)
         return;
 
@@ -1285,9 +1466,7 @@ void pgstat_drop_database(Oid databaseid)
 /* ----------
  * pgstat_drop_relation() -
  *
- *	Tell the collector that we just dropped a relation.
- *	(If the message gets lost, we will still clean the dead entry eventually
- *	via future invocations of pgstat_vacuum_stat().)
+ *	Remove the shared statistics of a relation we just dropped.
  *
  *	Currently not used for lack of any good place to call it; we rely
  *	entirely on pgstat_vacuum_stat() to clean out stats for dead rels.
@@ -1296,40 +1475,42 @@ void pgstat_drop_database(Oid databaseid)
 #ifdef NOT_USED
 void pgstat_drop_relation(Oid relid)
 {
-    PgStat_MsgTabpurge msg;
-    int len;
+    PgStat_SharedTabKey key;
+    uint32 hashcode;
+    LWLock* lock = NULL;
 
-    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET)
-        return;
-    msg.m_entry[0].m_tableid = relid;
-    msg.m_entry[0].m_statFlag = STATFLG_RELATION;
-    msg.m_nentries = 1;
+    key.databaseid = u_sess->proc_cxt.MyDatabaseId;
+    key.tabkey.tableid = relid;
+    key.tabkey.statFlag = STATFLG_RELATION;
+    hashcode = get_hash_value(g_instance.stat_cxt.PgStatTabHash, (void*)&key);
 
-    len = offsetof(PgStat_MsgTabpurge, m_entry[0]) + sizeof(PgStat_MsgTabEntry);
-
-    pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_TABPURGE);
-    msg.m_databaseid = u_sess->proc_cxt.MyDatabaseId;
-    pgstat_send(&msg, len);
+    lock = PgStatPartitionLock(hashcode);
+    LWLockAcquire(lock, LW_EXCLUSIVE);
+    (void)hash_search_with_hash_value(g_instance.stat_cxt.PgStatTabHash, (void*)&key, hashcode, HASH_REMOVE, NULL);
+    LWLockRelease(lock);
 }
 #endif /* NOT_USED */
 
 /* ----------
  * pgstat_reset_counters() -
  *
- *	Tell the statistics collector to reset counters for our database.
+ *	Remove the table and function statistics of our database, and tell the
+ *	statistics collector to reset its database-wide counters.
  * ----------
  */
 void pgstat_reset_counters(void)
 {
     PgStat_MsgResetcounter msg;
 
-    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET)
-        return;
-
     if (!superuser())
         ereport(ERROR,
             (errcode(ERRCODE_INSUFFICIENT_PRIVILEGE), errmsg("must be system admin to reset statistics counters")));
 
+    pgstat_remove_shared_entries(u_sess->proc_cxt.MyDatabaseId, false);
+
+    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET)
+        return;
+
     pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_RESETCOUNTER);
     msg.m_databaseid = u_sess->proc_cxt.MyDatabaseId;
     pgstat_send(&msg, sizeof(msg));
@@ -1367,20 +1548,50 @@ void pgstat_reset_shared_counters(const char* target)
 /* ----------
  * pgstat_reset_single_counter() -
  *
- *	Tell the statistics collector to reset a single counter.
+ *	Remove the shared statistics of a single object, and tell the statistics
+ *	collector to update the reset timestamp of our database.
  * ----------
  */
 void pgstat_reset_single_counter(Oid p_objoid, Oid objoid, PgStat_Single_Reset_Type type)
 {
     PgStat_MsgResetsinglecounter msg;
-
-    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET)
-        return;
+    uint32 hashcode;
+    LWLock* lock = NULL;
 
     if (!superuser())
         ereport(ERROR,
             (errcode(ERRCODE_INSUFFICIENT_PRIVILEGE), errmsg("must be system admin to reset statistics counters")));
 
+    /* Remove object if it exists, ignore it if not */
+    if (type == RESET_TABLE && g_instance.stat_cxt.PgStatTabHash != NULL) {
+        PgStat_SharedTabKey key;
+
+        key.databaseid = u_sess->proc_cxt.MyDatabaseId;
+        key.tabkey.tableid = objoid;
+        key.tabkey.statFlag = p_objoid;
+        hashcode = get_hash_value(g_instance.stat_cxt.PgStatTabHash, (void*)&key);
+
+        lock = PgStatPartitionLock(hashcode);
+        LWLockAcquire(lock, LW_EXCLUSIVE);
+        (void)hash_search_with_hash_value(g_instance.stat_cxt.PgStatTabHash, (void*)&key, hashcode, HASH_REMOVE, NULL);
+        LWLockRelease(lock);
+    } else if (type == RESET_FUNCTION && g_instance.stat_cxt.PgStatFuncHash != NULL) {
+        PgStat_SharedFuncKey key;
+
+        key.databaseid = u_sess->proc_cxt.MyDatabaseId;
+        key.functionid = objoid;
+        hashcode = get_hash_value(g_instance.stat_cxt.PgStatFuncHash, (void*)&key);
+
+        lock = PgStatPartitionLock(hashcode);
+        LWLockAcquire(lock, LW_EXCLUSIVE);
+        (void)hash_search_with_hash_value(
+            g_instance.stat_cxt.PgStatFuncHash, (void*)&key, hashcode, HASH_REMOVE, NULL);
+        LWLockRelease(lock);
+    }
+
+    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET)
+        return;
+
     pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_RESETSINGLECOUNTER);
     msg.m_databaseid = u_sess->proc_cxt.MyDatabaseId;
     msg.m_resettype = type;
@@ -1413,70 +1624,85 @@ void pgstat_report_autovac(Oid dboid)
 }
 
 /* ---------
- * pgstat_report_vacuum() -
+ * pgstat_report_autovac_timeout() -
  *
- *	Tell the collector about the table we just vacuumed.
+ *	Count an autovacuum of the table canceled due to timeout.
  * ---------
  */
 void pgstat_report_autovac_timeout(Oid tableoid, uint32 statFlag, bool shared)
 {
-    PgStat_MsgAutovacStat msg;
+    PgStat_StatTabEntry* tabentry = NULL;
+    LWLock* lock = NULL;
 
-    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET || !u_sess->attr.attr_common.pgstat_track_counts)
+    if (g_instance.stat_cxt.PgStatTabHash == NULL || !u_sess->attr.attr_common.pgstat_track_counts)
         return;
 
-    pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_AUTOVAC_STAT);
-    msg.m_databaseid = shared ? InvalidOid : u_sess->proc_cxt.MyDatabaseId;
-    msg.m_tableoid = tableoid;
-    msg.m_statFlag = statFlag;
-    msg.m_autovacStat = AV_TIMEOUT;
-
-    pgstat_send(&msg, sizeof(msg));
+    tabentry =
+        pgstat_lock_shared_tabentry(shared ? InvalidOid : u_sess->proc_cxt.MyDatabaseId, tableoid, statFlag, &lock);
+    if (tabentry != NULL) {
+        increase_continued_timeout(tabentry->autovac_status);
+        increase_toatl_timeout(tabentry->autovac_status);
+    }
+    LWLockRelease(lock);
 }
 
 /* ---------
  * pgstat_report_vacuum() -
  *
- *	Tell the collector about the table we just vacuumed.
+ *	Store the stats of the table we just vacuumed.
  * ---------
  */
 void pgstat_report_vacuum(Oid tableoid, uint32 statFlag, bool shared, PgStat_Counter tuples)
 {
-    PgStat_MsgVacuum msg;
+    PgStat_StatTabEntry* tabentry = NULL;
+    LWLock* lock = NULL;
+    TimestampTz vacuumtime;
 
-    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET || !u_sess->attr.attr_common.pgstat_track_counts)
+    if (g_instance.stat_cxt.PgStatTabHash == NULL || !u_sess->attr.attr_common.pgstat_track_counts)
         return;
 
-    pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_VACUUM);
-    msg.m_databaseid = shared ? InvalidOid : u_sess->proc_cxt.MyDatabaseId;
-    msg.m_tableoid = tableoid;
-    msg.m_statFlag = statFlag;
-    msg.m_autovacuum = IsAutoVacuumWorkerProcess();
-    msg.m_vacuumtime = GetCurrentTimestamp();
-    msg.m_tuples = tuples;
-    pgstat_send(&msg, sizeof(msg));
+    vacuumtime = GetCurrentTimestamp();
+    tabentry =
+        pgstat_lock_shared_tabentry(shared ? InvalidOid : u_sess->proc_cxt.MyDatabaseId, tableoid, statFlag, &lock);
+    if (tabentry != NULL) {
+        /* Resetting dead_tuples ... use negtive number to verify Cstore */
+        if (tuples < 0)
+            tabentry->n_dead_tuples = 0;
+        else
+            tabentry->n_dead_tuples = Max(0, tabentry->n_dead_tuples - tuples);
+
+        if (IsAutoVacuumWorkerProcess()) {
+            tabentry->autovac_vacuum_timestamp = vacuumtime;
+            tabentry->autovac_vacuum_count++;
+        }
+        tabentry->vacuum_timestamp = vacuumtime;
+        tabentry->vacuum_count++;
+    }
+    LWLockRelease(lock);
 }
 
 /* ---------
  * pgstat_report_data_changed() -
  *
- * Tell the collector about the table we just insert/delete/update/
- * copy/[exchange/truncate/drop] partition.
+ * Store the start time of the insert/delete/update/copy/[exchange/truncate/drop]
+ * partition we just did on the table.
  * ---------
  */
 void pgstat_report_data_changed(Oid tableoid, uint32 statFlag, bool shared)
 {
-    PgStat_MsgDataChanged msg;
+    PgStat_StatTabEntry* tabentry = NULL;
+    LWLock* lock = NULL;
+    TimestampTz changedtime;
 
-    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET || !u_sess->attr.attr_common.pgstat_track_counts)
+    if (g_instance.stat_cxt.PgStatTabHash == NULL || !u_sess->attr.attr_common.pgstat_track_counts)
         return;
 
-    pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_DATA_CHANGED);
-    msg.m_databaseid = shared ? InvalidOid : u_sess->proc_cxt.MyDatabaseId;
-    msg.m_tableoid = tableoid;
-    msg.m_statFlag = statFlag;
-    msg.m_changed_time = GetCurrentTimestamp();
-    pgstat_send(&msg, sizeof(msg));
+    changedtime = GetCurrentTimestamp();
+    tabentry =
+        pgstat_lock_shared_tabentry(shared ? InvalidOid : u_sess->proc_cxt.MyDatabaseId, tableoid, statFlag, &lock);
+    if (tabentry != NULL)
+        tabentry->data_changed_timestamp = changedtime;
+    LWLockRelease(lock);
 }
 
 /* ---------
@@ -1514,34 +1740,58 @@ void pgstat_report_process_percentile()
 /* ---------
  * pgstat_report_truncate() -
  *
- *	Tell the collector about the table we just truncated.
+ *	Reset the tuple counts of the table we just truncated.
  * ---------
  */
 void pgstat_report_truncate(Oid tableoid, uint32 statFlag, bool shared)
 {
-    PgStat_MsgTruncate msg;
+    PgStat_StatTabEntry* tabentry = NULL;
+    LWLock* lock = NULL;
+    Oid dbid = shared ? InvalidOid : u_sess->proc_cxt.MyDatabaseId;
+    PgStat_Counter dead_tuples = 0;
+    PgStat_Counter live_tuples = 0;
+    PgStat_Counter changes_since_analyze = 0;
 
-    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET || !u_sess->attr.attr_common.pgstat_track_counts)
+    if (g_instance.stat_cxt.PgStatTabHash == NULL || !u_sess->attr.attr_common.pgstat_track_counts)
         return;
 
-    pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_TRUNCATE);
-    msg.m_databaseid = shared ? InvalidOid : u_sess->proc_cxt.MyDatabaseId;
-    msg.m_tableoid = tableoid;
-    msg.m_statFlag = statFlag;
-    pgstat_send(&msg, sizeof(msg));
+    tabentry = pgstat_lock_shared_tabentry(dbid, tableoid, statFlag, &lock);
+    if (tabentry != NULL) {
+        dead_tuples = tabentry->n_dead_tuples;
+        live_tuples = tabentry->n_live_tuples;
+        changes_since_analyze = tabentry->changes_since_analyze;
+
+        /* After truncate reset dead_tuple and live_tuple */
+        tabentry->n_dead_tuples = 0;
+        tabentry->n_live_tuples = 0;
+    }
+    LWLockRelease(lock);
+
+    /* modify parent table's stat info(dead_tuple, live_tuple, changes_since_analyze) if it is a patition */
+    if (statFlag) {
+        tabentry = pgstat_lock_shared_tabentry(dbid, statFlag, InvalidOid, &lock);
+        if (tabentry != NULL) {
+            tabentry->n_dead_tuples = Max(0, tabentry->n_dead_tuples - dead_tuples);
+            tabentry->n_live_tuples = Max(0, tabentry->n_live_tuples - live_tuples);
+            tabentry->changes_since_analyze += changes_since_analyze;
+        }
+        LWLockRelease(lock);
+    }
 }
 
 /* --------
  * pgstat_report_analyze() -
  *
- *	Tell the collector about the table we just analyzed.
+ *	Store the stats of the table we just analyzed.
  * --------
  */
 void pgstat_report_analyze(Relation rel, PgStat_Counter livetuples, PgStat_Counter deadtuples)
 {
-    PgStat_MsgAnalyze msg;
+    PgStat_StatTabEntry* tabentry = NULL;
+    LWLock* lock = NULL;
+    TimestampTz analyzetime;
 
-    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET || !u_sess->attr.attr_common.pgstat_track_counts)
+    if (g_instance.stat_cxt.PgStatTabHash == NULL || !u_sess->attr.attr_common.pgstat_track_counts)
         return;
 
     /*
@@ -1549,10 +1799,9 @@ void pgstat_report_analyze(Relation rel, PgStat_Counter livetuples, PgStat_Count
      * already inserted and/or deleted rows in the target table. ANALYZE will
      * have counted such rows as live or dead respectively. Because we will
      * report our counts of such rows at transaction end, we should subtract
-     * off these counts from what we send to the collector now, else they'll
-     * be double-counted after commit.	(This approach also ensures that the
-     * collector ends up with the right numbers if we abort instead of
-     * committing.)
+     * off these counts from what we store now, else they'll be double-counted
+     * after commit.	(This approach also ensures that the shared entry ends
+     * up with the right numbers if we abort instead of committing.)
      */
     if (rel->pgstat_info != NULL) {
         PgStat_TableXactStatus* trans = NULL;
@@ -1568,15 +1817,30 @@ void pgstat_report_analyze(Relation rel, PgStat_Counter livetuples, PgStat_Count
         deadtuples = Max(deadtuples, 0);
     }
 
-    pgstat_setheader(&msg.m_hdr, PGSTAT_MTYPE_ANALYZE);
-    msg.m_databaseid = rel->rd_rel->relisshared ? InvalidOid : u_sess->proc_cxt.MyDatabaseId;
-    msg.m_tableoid = RelationGetRelid(rel);
-    msg.m_statFlag = rel->parentId;
-    msg.m_autovacuum = IsAutoVacuumWorkerProcess();
-    msg.m_analyzetime = GetCurrentTimestamp();
-    msg.m_live_tuples = livetuples;
-    msg.m_dead_tuples = deadtuples;
-    pgstat_send(&msg, sizeof(msg));
+    analyzetime = GetCurrentTimestamp();
+    tabentry = pgstat_lock_shared_tabentry(rel->rd_rel->relisshared ? InvalidOid : u_sess->proc_cxt.MyDatabaseId,
+        RelationGetRelid(rel),
+        rel->parentId,
+        &lock);
+    if (tabentry != NULL) {
+        tabentry->n_live_tuples = livetuples;
+        tabentry->n_dead_tuples = deadtuples;
+
+        /*
+         * We reset changes_since_analyze to zero, forgetting any changes that
+         * occurred while the ANALYZE was in progress.
+         */
+        tabentry->changes_since_analyze = 0;
+
+        if (IsAutoVacuumWorkerProcess()) {
+            tabentry->autovac_analyze_timestamp = analyzetime;
+            tabentry->autovac_analyze_count++;
+            reset_continued_timeout(tabentry->autovac_status);
+        }
+        tabentry->analyze_timestamp = analyzetime;
+        tabentry->analyze_count++;
+    }
+    LWLockRelease(lock);
 }
 
 /* --------
@@ -1830,7 +2094,7 @@ void pgstat_initstats(Relation rel)
         return;
     }
 
-    if (g_instance.stat_cxt.pgStatSock == PGINVALID_SOCKET || !u_sess->attr.attr_common.pgstat_track_counts) {
+    if (!u_sess->attr.attr_common.pgstat_track_counts) {
         /* We're not counting at all */
         rel->pgstat_info = NULL;
         return;
@@ -2391,39 +2655,125 @@ PgStat_StatDBEntry* pgstat_fetch_stat_dbentry(Oid dbid)
  */
 PgStat_StatTabEntry* pgstat_fetch_stat_tabentry(PgStat_StatTabKey* tabkey)
 {
-    Oid dbid;
-    PgStat_StatDBEntry* dbentry = NULL;
     PgStat_StatTabEntry* tabentry = NULL;
 
     /*
-     * If not done for this transaction, read the statistics collector stats
-     * file into some hash tables.
+     * Lookup our database, then if we didn't find it, maybe it's a shared
+     * table.
      */
-    backend_read_statsfile();
+    tabentry = pgstat_fetch_stat_tabentry_db(u_sess->proc_cxt.MyDatabaseId, tabkey);
+    if (tabentry == NULL)
+        tabentry = pgstat_fetch_stat_tabentry_db(InvalidOid, tabkey);
 
-    /*
-     * Lookup our database, then look in its table hash table.
-     */
-    dbid = u_sess->proc_cxt.MyDatabaseId;
-    dbentry = (PgStat_StatDBEntry*)hash_search(u_sess->stat_cxt.pgStatDBHash, (void*)&dbid, HASH_FIND, NULL);
-    if (dbentry != NULL && dbentry->tables != NULL) {
-        tabentry = (PgStat_StatTabEntry*)hash_search(dbentry->tables, (void*)tabkey, HASH_FIND, NULL);
-        if (tabentry != NULL)
-            return tabentry;
-    }
+    return tabentry;
+}
 
-    /*
-     * If we didn't find it, maybe it's a shared table.
-     */
-    dbid = InvalidOid;
-    dbentry = (PgStat_StatDBEntry*)hash_search(u_sess->stat_cxt.pgStatDBHash, (void*)&dbid, HASH_FIND, NULL);
-    if (dbentry != NULL && dbentry->tables != NULL) {
-        tabentry = (PgStat_StatTabEntry*)hash_search(dbentry->tables, (void*)tabkey, HASH_FIND, NULL);
-        if (tabentry != NULL)
-            return tabentry;
+/* ----------
+ * pgstat_fetch_stat_tabentry_db() -
+ *
+ *	Returns the statistics of one table of the given database (InvalidOid
+ *	for a shared table) or NULL.  The shared entry is copied into a local
+ *	snapshot the first time, so that later lookups in the same transaction
+ *	see the same values.
+ * ----------
+ */
+PgStat_StatTabEntry* pgstat_fetch_stat_tabentry_db(Oid dbid, PgStat_StatTabKey* tabkey)
+{
+    PgStat_SharedTabKey key;
+    PgStat_SharedTabEntry* entry = NULL;
+    PgStat_StatTabEntry tabbuf;
+    uint32 hashcode;
+    LWLock* lock = NULL;
+    errno_t rc;
+
+    if (g_instance.stat_cxt.PgStatTabHash == NULL)
+        return NULL;
+
+    if (u_sess->stat_cxt.pgStatTabSnapshot == NULL) {
+        HASHCTL hash_ctl;
+
+        pgstat_setup_memcxt();
+        rc = memset_s(&hash_ctl, sizeof(hash_ctl), 0, sizeof(hash_ctl));
+        securec_check(rc, "\0", "\0");
+        hash_ctl.keysize = sizeof(PgStat_SharedTabKey);
+        hash_ctl.entrysize = sizeof(PgStat_SharedTabEntry);
+        hash_ctl.hash = tag_hash;
+        hash_ctl.hcxt = u_sess->stat_cxt.pgStatLocalContext;
+        u_sess->stat_cxt.pgStatTabSnapshot = hash_create(
+            "Table stat snapshot", PGSTAT_TAB_HASH_SIZE, &hash_ctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
     }
 
-    return NULL;
+    key.databaseid = dbid;
+    key.tabkey = *tabkey;
+
+    entry = (PgStat_SharedTabEntry*)hash_search(u_sess->stat_cxt.pgStatTabSnapshot, (void*)&key, HASH_FIND, NULL);
+    if (entry != NULL)
+        return &entry->tabentry;
+
+    hashcode = get_hash_value(g_instance.stat_cxt.PgStatTabHash, (void*)&key);
+    lock = PgStatPartitionLock(hashcode);
+    LWLockAcquire(lock, LW_SHARED);
+    entry = (PgStat_SharedTabEntry*)hash_search_with_hash_value(
+        g_instance.stat_cxt.PgStatTabHash, (void*)&key, hashcode, HASH_FIND, NULL);
+    if (entry != NULL)
+        tabbuf = entry->tabentry;
+    LWLockRelease(lock);
+
+    if (entry == NULL)
+        return NULL;
+
+    entry = (PgStat_SharedTabEntry*)hash_search(u_sess->stat_cxt.pgStatTabSnapshot, (void*)&key, HASH_ENTER, NULL);
+    entry->tabentry = tabbuf;
+
+    return &entry->tabentry;
+}
+
+/* ----------
+ * pgstat_fetch_stat_tabhash() -
+ *
+ *	Returns a local hash table, keyed by PgStat_StatTabKey, of the
+ *	statistics of all tables of the given database.  It lives until
+ *	pgstat_clear_snapshot() is called.
+ * ----------
+ */
+HTAB* pgstat_fetch_stat_tabhash(Oid dbid)
+{
+    HASHCTL hash_ctl;
+    HASH_SEQ_STATUS hstat;
+    HTAB* tables = NULL;
+    PgStat_SharedTabEntry* entry = NULL;
+    PgStat_StatTabEntry* tabentry = NULL;
+    errno_t rc;
+
+    if (g_instance.stat_cxt.PgStatTabHash == NULL)
+        return NULL;
+
+    pgstat_setup_memcxt();
+    rc = memset_s(&hash_ctl, sizeof(hash_ctl), 0, sizeof(hash_ctl));
+    securec_check(rc, "\0", "\0");
+    hash_ctl.keysize = sizeof(PgStat_StatTabKey);
+    hash_ctl.entrysize = sizeof(PgStat_StatTabEntry);
+    hash_ctl.hash = tag_hash;
+    hash_ctl.hcxt = u_sess->stat_cxt.pgStatLocalContext;
+    tables =
+        hash_create("Per-database table", PGSTAT_TAB_HASH_SIZE, &hash_ctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+
+    for (uint32 i = 0; i < NUM_PGSTAT_PARTITIONS; i++) {
+        LWLock* lock = PgStatPartitionLockByIndex(i);
+
+        LWLockAcquire(lock, LW_SHARED);
+        hash_seq_init_partition(&hstat, g_instance.stat_cxt.PgStatTabHash, i);
+        while ((entry = (PgStat_SharedTabEntry*)hash_seq_search(&hstat)) != NULL) {
+            if (entry->key.databaseid != dbid)
+                continue;
+
+            tabentry = (PgStat_StatTabEntry*)hash_search(tables, (void*)&entry->key.tabkey, HASH_ENTER, NULL);
+            *tabentry = entry->tabentry;
+        }
+        LWLockRelease(lock);
+    }
+
+    return tables;
 }
 
 /* ----------
@@ -2435,19 +2785,54 @@ PgStat_StatTabEntry* pgstat_fetch_stat_tabentry(PgStat_StatTabKey* tabkey)
  */
 PgStat_StatFuncEntry* pgstat_fetch_stat_funcentry(Oid func_id)
 {
-    PgStat_StatDBEntry* dbentry = NULL;
-    PgStat_StatFuncEntry* funcentry = NULL;
+    PgStat_SharedFuncKey key;
+    PgStat_SharedFuncEntry* entry = NULL;
+    PgStat_StatFuncEntry funcbuf;
+    uint32 hashcode;
+    LWLock* lock = NULL;
+    errno_t rc;
 
-    /* load the stats file if needed */
-    backend_read_statsfile();
+    if (g_instance.stat_cxt.PgStatFuncHash == NULL)
+        return NULL;
 
-    /* Lookup our database, then find the requested function.  */
-    dbentry = pgstat_fetch_stat_dbentry(u_sess->proc_cxt.MyDatabaseId);
-    if (dbentry != NULL && dbentry->functions != NULL) {
-        funcentry = (PgStat_StatFuncEntry*)hash_search(dbentry->functions, (void*)&func_id, HASH_FIND, NULL);
+    if (u_sess->stat_cxt.pgStatFuncSnapshot == NULL) {
+        HASHCTL hash_ctl;
+
+        pgstat_setup_memcxt();
+        rc = memset_s(&hash_ctl, sizeof(hash_ctl), 0, sizeof(hash_ctl));
+        securec_check(rc, "\0", "\0");
+        hash_ctl.keysize = sizeof(PgStat_SharedFuncKey);
+        hash_ctl.entrysize = sizeof(PgStat_SharedFuncEntry);
+        hash_ctl.hash = tag_hash;
+        hash_ctl.hcxt = u_sess->stat_cxt.pgStatLocalContext;
+        u_sess->stat_cxt.pgStatFuncSnapshot = hash_create(
+            "Function stat snapshot", PGSTAT_FUNCTION_HASH_SIZE, &hash_ctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
     }
 
-    return funcentry;
+    /* Lookup our database, then find the requested function.  */
+    key.databaseid = u_sess->proc_cxt.MyDatabaseId;
+    key.functionid = func_id;
+
+    entry = (PgStat_SharedFuncEntry*)hash_search(u_sess->stat_cxt.pgStatFuncSnapshot, (void*)&key, HASH_FIND, NULL);
+    if (entry != NULL)
+        return &entry->funcentry;
+
+    hashcode = get_hash_value(g_instance.stat_cxt.PgStatFuncHash, (void*)&key);
+    lock = PgStatPartitionLock(hashcode);
+    LWLockAcquire(lock, LW_SHARED);
+    entry = (PgStat_SharedFuncEntry*)hash_search_with_hash_value(
+        g_instance.stat_cxt.PgStatFuncHash, (void*)&key, hashcode, HASH_FIND, NULL);
+    if (entry != NULL)
+        funcbuf = entry->funcentry;
+    LWLockRelease(lock);
+
+    if (entry == NULL)
+        return NULL;
+
+    entry = (PgStat_SharedFuncEntry*)hash_search(u_sess->stat_cxt.pgStatFuncSnapshot, (void*)&key, HASH_ENTER, NULL);
+    entry->funcentry = funcbuf;
+
+    return &entry->funcentry;
 }
 
 /* ----------
@@ -4973,7 +5358,7 @@ void PgstatCollectorMain()
      * zero.
      */
     u_sess->stat_cxt.pgStatRunningInCollector = true;
-    u_sess->stat_cxt.pgStatDBHash = pgstat_read_statsfile(InvalidOid, true);
+    u_sess->stat_cxt.pgStatDBHash = pgstat_read_statsfile(true);
 
     t_thrd.mem_cxt.mask_password_mem_cxt = AllocSetContextCreate(t_thrd.top_mem_cxt,
         "MaskPasswordCtx",
@@ -5085,10 +5470,6 @@ void PgstatCollectorMain()
                     pgstat_recv_tabstat((PgStat_MsgTabstat*)&msg);
                     break;
 
-                case PGSTAT_MTYPE_TABPURGE:
-                    pgstat_recv_tabpurge((PgStat_MsgTabpurge*)&msg);
-                    break;
-
                 case PGSTAT_MTYPE_DROPDB:
                     pgstat_recv_dropdb((PgStat_MsgDropdb*)&msg);
                     break;
@@ -5109,38 +5490,10 @@ void PgstatCollectorMain()
                     pgstat_recv_autovac((PgStat_MsgAutovacStart*)&msg);
                     break;
 
-                case PGSTAT_MTYPE_VACUUM:
-                    pgstat_recv_vacuum((PgStat_MsgVacuum*)&msg);
-                    break;
-
-                case PGSTAT_MTYPE_AUTOVAC_STAT:
-                    pgstat_recv_autovac_stat((PgStat_MsgAutovacStat*)&msg);
-                    break;
-
-                case PGSTAT_MTYPE_DATA_CHANGED:
-                    pgstat_recv_data_changed((PgStat_MsgDataChanged*)&msg);
-                    break;
-
-                case PGSTAT_MTYPE_TRUNCATE:
-                    pgstat_recv_truncate((PgStat_MsgTruncate*)&msg);
-                    break;
-
-                case PGSTAT_MTYPE_ANALYZE:
-                    pgstat_recv_analyze((PgStat_MsgAnalyze*)&msg);
-                    break;
-
                 case PGSTAT_MTYPE_BGWRITER:
                     pgstat_recv_bgwriter((PgStat_MsgBgWriter*)&msg);
                     break;
 
-                case PGSTAT_MTYPE_FUNCSTAT:
-                    pgstat_recv_funcstat((PgStat_MsgFuncstat*)&msg);
-                    break;
-
-                case PGSTAT_MTYPE_FUNCPURGE:
-                    pgstat_recv_funcpurge((PgStat_MsgFuncpurge*)&msg);
-                    break;
-
                 case PGSTAT_MTYPE_RECOVERYCONFLICT:
                     pgstat_recv_recoveryconflict((PgStat_MsgRecoveryConflict*)&msg);
                     break;
@@ -5247,7 +5600,6 @@ static PgStat_StatDBEntry* pgstat_get_db_entry(Oid databaseid, bool create)
     PgStat_StatDBEntry* result = NULL;
     bool found = false;
     HASHACTION action = (create ? HASH_ENTER : HASH_FIND);
-    errno_t rc = EOK;
 
     /* Lookup or create the hash table entry for this database */
     result = (PgStat_StatDBEntry*)hash_search(u_sess->stat_cxt.pgStatDBHash, &databaseid, action, &found);
@@ -5257,10 +5609,6 @@ static PgStat_StatDBEntry* pgstat_get_db_entry(Oid databaseid, bool create)
 
     /* If not found, initialize the new one. */
     if (!found) {
-        HASHCTL hash_ctl;
-
-        result->tables = NULL;
-        result->functions = NULL;
         result->n_xact_commit = 0;
         result->n_xact_rollback = 0;
         result->n_blocks_fetched = 0;
@@ -5287,73 +5635,6 @@ static PgStat_StatDBEntry* pgstat_get_db_entry(Oid databaseid, bool create)
         result->n_mem_mbytes_reserved = 0;
 
         result->stat_reset_timestamp = GetCurrentTimestamp();
-
-        rc = memset_s(&hash_ctl, sizeof(hash_ctl), 0, sizeof(hash_ctl));
-        securec_check(rc, "\0", "\0");
-        hash_ctl.keysize = sizeof(PgStat_StatTabKey);
-        hash_ctl.entrysize = sizeof(PgStat_StatTabEntry);
-        hash_ctl.hash = tag_hash;
-        result->tables = hash_create("Per-database table", PGSTAT_TAB_HASH_SIZE, &hash_ctl, HASH_ELEM | HASH_FUNCTION);
-
-        hash_ctl.keysize = sizeof(Oid);
-        hash_ctl.entrysize = sizeof(PgStat_StatFuncEntry);
-        hash_ctl.hash = oid_hash;
-        result->functions =
-            hash_create("Per-database function", PGSTAT_FUNCTION_HASH_SIZE, &hash_ctl, HASH_ELEM | HASH_FUNCTION);
-    }
-
-    return result;
-}
-
-/*
- * Lookup the hash table entry for the specified table. If no hash
- * table entry exists, initialize it, if the create parameter is true.
- * Else, return NULL.
- */
-static PgStat_StatTabEntry* pgstat_get_tab_entry(
-    PgStat_StatDBEntry* dbentry, Oid tableoid, bool create, uint32 statFlag)
-{
-    PgStat_StatTabEntry* result = NULL;
-    bool found = false;
-    HASHACTION action = (create ? HASH_ENTER : HASH_FIND);
-    PgStat_StatTabKey tabkey;
-
-    tabkey.statFlag = statFlag;
-    tabkey.tableid = tableoid;
-
-    /* Lookup or create the hash table entry for this table */
-    result = (PgStat_StatTabEntry*)hash_search(dbentry->tables, (void*)(&tabkey), action, &found);
-
-    if (!create && !found)
-        return NULL;
-
-    /* If not found, initialize the new one. */
-    if (!found) {
-        result->numscans = 0;
-        result->tuples_returned = 0;
-        result->tuples_fetched = 0;
-        result->tuples_inserted = 0;
-        result->tuples_updated = 0;
-        result->tuples_deleted = 0;
-        result->tuples_hot_updated = 0;
-        result->n_live_tuples = 0;
-        result->n_dead_tuples = 0;
-        result->changes_since_analyze = 0;
-        result->blocks_fetched = 0;
-        result->blocks_hit = 0;
-        result->cu_mem_hit = 0;
-        result->cu_hdd_sync = 0;
-        result->cu_hdd_asyn = 0;
-        result->vacuum_timestamp = 0;
-        result->vacuum_count = 0;
-        result->autovac_vacuum_timestamp = 0;
-        result->autovac_vacuum_count = 0;
-        result->analyze_timestamp = 0;
-        result->analyze_count = 0;
-        result->autovac_analyze_timestamp = 0;
-        result->autovac_analyze_count = 0;
-        result->autovac_status = 0;
-        result->data_changed_timestamp = 0;
     }
 
     return result;
@@ -5366,17 +5647,17 @@ static PgStat_StatTabEntry* pgstat_get_tab_entry(
  *	If writing to the permanent file (happens when the collector is
  *	shutting down only), remove the temporary file so that backends
  *	starting up under a new postmaster can't read the old data before
- *	the new collector is ready.
+ *	the new collector is ready.  The shared table and function entries
+ *	are saved into the permanent file only, backends look them up in
+ *	shared memory.
  * ----------
  */
 static void pgstat_write_statsfile(bool permanent)
 {
     HASH_SEQ_STATUS hstat;
-    HASH_SEQ_STATUS tstat;
-    HASH_SEQ_STATUS fstat;
     PgStat_StatDBEntry* dbentry = NULL;
-    PgStat_StatTabEntry* tabentry = NULL;
-    PgStat_StatFuncEntry* funcentry = NULL;
+    PgStat_SharedTabEntry* tabentry = NULL;
+    PgStat_SharedFuncEntry* funcentry = NULL;
     FILE* fpout = NULL;
     int32 format_id;
     const char* tmpfile = permanent ? PGSTAT_STAT_PERMANENT_TMPFILE : u_sess->stat_cxt.pgstat_stat_tmpname;
@@ -5417,38 +5698,41 @@ static void pgstat_write_statsfile(bool permanent)
     hash_seq_init(&hstat, u_sess->stat_cxt.pgStatDBHash);
     while ((dbentry = (PgStat_StatDBEntry*)hash_seq_search(&hstat)) != NULL) {
         /*
-         * Write out the DB entry including the number of live backends. We
-         * don't write the tables or functions pointers, since they're of no
-         * use to any other process.
+         * Write out the DB entry including the number of live backends.
          */
         fputc('D', fpout);
-        rc = fwrite(dbentry, offsetof(PgStat_StatDBEntry, tables), 1, fpout);
+        rc = fwrite(dbentry, sizeof(PgStat_StatDBEntry), 1, fpout);
         (void)rc; /* we'll check for error with ferror */
+    }
 
-        /*
-         * Walk through the database's access stats per table.
-         */
-        hash_seq_init(&tstat, dbentry->tables);
-        while ((tabentry = (PgStat_StatTabEntry*)hash_seq_search(&tstat)) != NULL) {
-            fputc('T', fpout);
-            rc = fwrite(tabentry, sizeof(PgStat_StatTabEntry), 1, fpout);
-            (void)rc; /* we'll check for error with ferror */
-        }
+    if (permanent) {
+        for (uint32 i = 0; i < NUM_PGSTAT_PARTITIONS; i++) {
+            LWLock* lock = PgStatPartitionLockByIndex(i);
 
-        /*
-         * Walk through the database's function stats table.
-         */
-        hash_seq_init(&fstat, dbentry->functions);
-        while ((funcentry = (PgStat_StatFuncEntry*)hash_seq_search(&fstat)) != NULL) {
-            fputc('F', fpout);
-            rc = fwrite(funcentry, sizeof(PgStat_StatFuncEntry), 1, fpout);
-            (void)rc; /* we'll check for error with ferror */
-        }
+            LWLockAcquire(lock, LW_SHARED);
 
-        /*
-         * Mark the end of this DB
-         */
-        fputc('d', fpout);
+            /*
+             * Walk through the shared access stats per table.
+             */
+            hash_seq_init_partition(&hstat, g_instance.stat_cxt.PgStatTabHash, i);
+            while ((tabentry = (PgStat_SharedTabEntry*)hash_seq_search(&hstat)) != NULL) {
+                fputc('T', fpout);
+                rc = fwrite(tabentry, sizeof(PgStat_SharedTabEntry), 1, fpout);
+                (void)rc; /* we'll check for error with ferror */
+            }
+
+            /*
+             * Walk through the shared function stats table.
+             */
+            hash_seq_init_partition(&hstat, g_instance.stat_cxt.PgStatFuncHash, i);
+            while ((funcentry = (PgStat_SharedFuncEntry*)hash_seq_search(&hstat)) != NULL) {
+                fputc('F', fpout);
+                rc = fwrite(funcentry, sizeof(PgStat_SharedFuncEntry), 1, fpout);
+                (void)rc; /* we'll check for error with ferror */
+            }
+
+            LWLockRelease(lock);
+        }
     }
 
     /*
@@ -5507,24 +5791,25 @@ static void pgstat_write_statsfile(bool permanent)
  * pgstat_read_statsfile() -
  *
  *	Reads in an existing statistics collector file and initializes the
- *	databases' hash table (whose entries point to the tables' hash tables).
+ *	databases' hash table.  The table and function entries of the
+ *	permanent file are loaded back into the shared hash tables.
  * ----------
  */
-static HTAB* pgstat_read_statsfile(Oid onlydb, bool permanent)
+static HTAB* pgstat_read_statsfile(bool permanent)
 {
     PgStat_StatDBEntry* dbentry = NULL;
     PgStat_StatDBEntry dbbuf;
-    PgStat_StatTabEntry* tabentry = NULL;
-    PgStat_StatTabEntry tabbuf;
-    PgStat_StatFuncEntry funcbuf;
-    PgStat_StatFuncEntry* funcentry = NULL;
+    PgStat_SharedTabEntry* tabentry = NULL;
+    PgStat_SharedTabEntry tabbuf;
+    PgStat_SharedFuncEntry funcbuf;
+    PgStat_SharedFuncEntry* funcentry = NULL;
     HASHCTL hash_ctl;
     HTAB* dbhash = NULL;
-    HTAB* tabhash = NULL;
-    HTAB* funchash = NULL;
     FILE* fpin = NULL;
     int32 format_id;
     bool found = false;
+    uint32 hashcode;
+    LWLock* lock = NULL;
     const char* statfile = permanent ? PGSTAT_STAT_PERMANENT_FILENAME : u_sess->stat_cxt.pgstat_stat_filename;
     errno_t rc = EOK;
 
@@ -5600,12 +5885,10 @@ static HTAB* pgstat_read_statsfile(Oid onlydb, bool permanent)
         switch (fgetc(fpin)) {
                 /*
                  * 'D'	A PgStat_StatDBEntry struct describing a database
-                 * follows. Subsequently, zero to many 'T' and 'F' entries
-                 * will follow until a 'd' is encountered.
+                 * follows.
                  */
             case 'D':
-                if (fread(&dbbuf, 1, offsetof(PgStat_StatDBEntry, tables), fpin) !=
-                    offsetof(PgStat_StatDBEntry, tables)) {
+                if (fread(&dbbuf, 1, sizeof(PgStat_StatDBEntry), fpin) != sizeof(PgStat_StatDBEntry)) {
                     ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
                         (errmsg("corrupted statistics file \"%s\"", statfile)));
                     goto done;
@@ -5623,107 +5906,54 @@ static HTAB* pgstat_read_statsfile(Oid onlydb, bool permanent)
 
                 rc = memcpy_s(dbentry, sizeof(PgStat_StatDBEntry), &dbbuf, sizeof(PgStat_StatDBEntry));
                 securec_check(rc, "", "");
-                dbentry->tables = NULL;
-                dbentry->functions = NULL;
-
-                /*
-                 * Don't collect tables if not the requested DB (or the
-                 * shared-table info)
-                 */
-                if (onlydb != InvalidOid) {
-                    if (dbbuf.databaseid != onlydb && dbbuf.databaseid != InvalidOid)
-                        break;
-                }
-
-                rc = memset_s(&hash_ctl, sizeof(hash_ctl), 0, sizeof(hash_ctl));
-                securec_check(rc, "\0", "\0");
-                hash_ctl.keysize = sizeof(PgStat_StatTabKey);
-                hash_ctl.entrysize = sizeof(PgStat_StatTabEntry);
-                hash_ctl.hash = tag_hash;
-                hash_ctl.hcxt = u_sess->stat_cxt.pgStatLocalContext;
-                dbentry->tables = hash_create(
-                    "Per-database table", PGSTAT_TAB_HASH_SIZE, &hash_ctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
-
-                hash_ctl.keysize = sizeof(Oid);
-                hash_ctl.entrysize = sizeof(PgStat_StatFuncEntry);
-                hash_ctl.hash = oid_hash;
-                hash_ctl.hcxt = u_sess->stat_cxt.pgStatLocalContext;
-                dbentry->functions = hash_create("Per-database function",
-                    PGSTAT_FUNCTION_HASH_SIZE,
-                    &hash_ctl,
-                    HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
-
-                /*
-                 * Arrange that following records add entries to this
-                 * database's hash tables.
-                 */
-                tabhash = dbentry->tables;
-                funchash = dbentry->functions;
-                break;
-
-                /*
-                 * 'd'	End of this database.
-                 */
-            case 'd':
-                tabhash = NULL;
-                funchash = NULL;
                 break;
 
                 /*
-                 * 'T'	A PgStat_StatTabEntry follows.
+                 * 'T'	A PgStat_SharedTabEntry follows, put it back into
+                 * shared memory.
                  */
             case 'T':
-                if (fread(&tabbuf, 1, sizeof(PgStat_StatTabEntry), fpin) != sizeof(PgStat_StatTabEntry)) {
+                if (fread(&tabbuf, 1, sizeof(PgStat_SharedTabEntry), fpin) != sizeof(PgStat_SharedTabEntry)) {
                     ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
                         (errmsg("corrupted statistics file \"%s\"", statfile)));
                     goto done;
                 }
 
-                /*
-                 * Skip if table belongs to a not requested database.
-                 */
-                if (tabhash == NULL)
+                if (!permanent)
                     break;
 
-                tabentry = (PgStat_StatTabEntry*)hash_search(tabhash, (void*)&(tabbuf.tablekey), HASH_ENTER, &found);
-
-                if (found) {
-                    ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
-                        (errmsg("corrupted statistics file \"%s\"", statfile)));
-                    goto done;
-                }
-
-                rc = memcpy_s(tabentry, sizeof(PgStat_StatTabEntry), &tabbuf, sizeof(tabbuf));
-                securec_check(rc, "", "");
+                hashcode = get_hash_value(g_instance.stat_cxt.PgStatTabHash, (void*)&tabbuf.key);
+                lock = PgStatPartitionLock(hashcode);
+                LWLockAcquire(lock, LW_EXCLUSIVE);
+                tabentry = (PgStat_SharedTabEntry*)hash_search_with_hash_value(
+                    g_instance.stat_cxt.PgStatTabHash, (void*)&tabbuf.key, hashcode, HASH_ENTER_NULL, NULL);
+                if (tabentry != NULL)
+                    tabentry->tabentry = tabbuf.tabentry;
+                LWLockRelease(lock);
                 break;
 
                 /*
-                 * 'F'	A PgStat_StatFuncEntry follows.
+                 * 'F'	A PgStat_SharedFuncEntry follows, put it back into
+                 * shared memory.
                  */
             case 'F':
-                if (fread(&funcbuf, 1, sizeof(PgStat_StatFuncEntry), fpin) != sizeof(PgStat_StatFuncEntry)) {
+                if (fread(&funcbuf, 1, sizeof(PgStat_SharedFuncEntry), fpin) != sizeof(PgStat_SharedFuncEntry)) {
                     ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
                         (errmsg("corrupted statistics file \"%s\"", statfile)));
                     goto done;
                 }
 
-                /*
-                 * Skip if function belongs to a not requested database.
-                 */
-                if (funchash == NULL)
+                if (!permanent)
                     break;
 
-                funcentry =
-                    (PgStat_StatFuncEntry*)hash_search(funchash, (void*)&funcbuf.functionid, HASH_ENTER, &found);
-
-                if (found) {
-                    ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
-                        (errmsg("corrupted statistics file \"%s\"", statfile)));
-                    goto done;
-                }
-
-                rc = memcpy_s(funcentry, sizeof(PgStat_StatFuncEntry), &funcbuf, sizeof(funcbuf));
-                securec_check(rc, "", "");
+                hashcode = get_hash_value(g_instance.stat_cxt.PgStatFuncHash, (void*)&funcbuf.key);
+                lock = PgStatPartitionLock(hashcode);
+                LWLockAcquire(lock, LW_EXCLUSIVE);
+                funcentry = (PgStat_SharedFuncEntry*)hash_search_with_hash_value(
+                    g_instance.stat_cxt.PgStatFuncHash, (void*)&funcbuf.key, hashcode, HASH_ENTER_NULL, NULL);
+                if (funcentry != NULL)
+                    funcentry->funcentry = funcbuf.funcentry;
+                LWLockRelease(lock);
                 break;
 
                 /*
@@ -5863,60 +6093,20 @@ static void backend_read_statsfile(void)
             (errmsg("using stale statistics instead of current ones "
                     "because stats collector is not responding")));
 
-    /* Autovacuum launcher wants stats about all databases */
-    if (IsAutoVacuumLauncherProcess())
-        u_sess->stat_cxt.pgStatDBHash = pgstat_read_statsfile(InvalidOid, false);
-    else
-        u_sess->stat_cxt.pgStatDBHash = pgstat_read_statsfile(u_sess->proc_cxt.MyDatabaseId, false);
+    u_sess->stat_cxt.pgStatDBHash = pgstat_read_statsfile(false);
 }
 
 void pgstat_read_analyzed()
 {
-    /* Similar to pgstat_read_statsfile. */
-    FILE* fpin = NULL;
-    int32 format_id;
-    PgStat_StatDBEntry dbbuf;
-    PgStat_StatTabEntry tabbuf;
-    PgStat_StatFuncEntry funcbuf;
     HASHCTL hash_ctl;
+    HASH_SEQ_STATUS hstat;
     errno_t errorno = EOK;
+    PgStat_SharedTabEntry* entry = NULL;
     PgStat_AnaCheckEntry* tabentry = NULL;
-    const char* statfile = u_sess->stat_cxt.pgstat_stat_filename;
-    bool need_collected = false;
-    bool found = false;
-
-    /* Similar to backend_read_statsfile */
-    TimestampTz cur_ts;
-    TimestampTz min_ts;
-    int count;
 
     Assert(!u_sess->stat_cxt.pgStatRunningInCollector);
 
-    /* Loop until fresh enough stats file is available or we ran out of time. */
-    cur_ts = GetCurrentTimestamp();
-    min_ts = TimestampTzPlusMilliseconds(cur_ts, -PGSTAT_STAT_INTERVAL);
-    for (count = 0; count < PGSTAT_POLL_LOOP_COUNT; count++) {
-        TimestampTz file_ts = 0;
-
-        CHECK_FOR_INTERRUPTS();
-
-        if (pgstat_read_statsfile_timestamp(false, &file_ts) && file_ts >= min_ts)
-            break;
-
-        /* Not there or too old, so kick the collector and wait a bit */
-        if ((count % PGSTAT_INQ_LOOP_COUNT) == 0)
-            pgstat_send_inquiry(min_ts);
-
-        pg_usleep(PGSTAT_RETRY_DELAY * 1000L);
-    }
-
-    if (count >= PGSTAT_POLL_LOOP_COUNT)
-        ereport(LOG,
-            (errmsg("using stale statistics instead of current ones "
-                    "because stats collector is not responding")));
-
     /*
-     * Similar to pgstat_read_statsfile.
      * The hash table will live in u_sess->stat_cxt.pgStatLocalContext
      */
     pgstat_setup_memcxt();
@@ -5930,111 +6120,26 @@ void pgstat_read_analyzed()
     u_sess->stat_cxt.analyzeCheckHash =
         hash_create("AnalyzeCheck hash", PGSTAT_TAB_HASH_SIZE, &hash_ctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
 
-    errorno = memset_s(u_sess->stat_cxt.globalStats, sizeof(PgStat_GlobalStats), 0, sizeof(PgStat_GlobalStats));
-    securec_check(errorno, "\0", "\0");
-    u_sess->stat_cxt.globalStats->stat_reset_timestamp = GetCurrentTimestamp();
-
-    /* 1.Try to open the status file */
-    if ((fpin = AllocateFile(statfile, PG_BINARY_R)) == NULL) {
-        if (errno != ENOENT)
-            ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
-                (errcode_for_file_access(), errmsg("could not open statistics file \"%s\": %m", statfile)));
-        elog(LOG, "[Pgstat] statfile %s is missing, using empty dbhash.", statfile);
+    if (g_instance.stat_cxt.PgStatTabHash == NULL)
         return;
-    }
-
-    /* 2.Verify it's of the expected format */
-    if (fread(&format_id, 1, sizeof(format_id), fpin) != sizeof(format_id) || format_id != PGSTAT_FILE_FORMAT_ID) {
-        ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
-            (errmsg("corrupted statistics file \"%s\"", statfile)));
-        goto done;
-    }
-
-    /* 3.Read global stats struct */
-    if (fread(u_sess->stat_cxt.globalStats, 1, sizeof(PgStat_GlobalStats), fpin) != sizeof(PgStat_GlobalStats)) {
-        ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
-            (errmsg("corrupted statistics file \"%s\"", statfile)));
-        goto done;
-    }
-
-    /* 4.Fill analyzeCheckHash */
-    for (;;) {
-        switch (fgetc(fpin)) {
-            /*
-             * Database begins. Subsequently, zero to many 'T' and 'F' entries
-             * will follow until a 'd' is encountered.
-             */
-            case 'D':
-                if (fread(&dbbuf, 1, offsetof(PgStat_StatDBEntry, tables), fpin) !=
-                    offsetof(PgStat_StatDBEntry, tables)) {
-                    ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
-                        (errmsg("corrupted statistics file \"%s\"", statfile)));
-                    goto done;
-                }
-
-                /* Don't collect tables if not the requested DB */
-                if (dbbuf.databaseid != u_sess->proc_cxt.MyDatabaseId)
-                    need_collected = false;
-                else
-                    need_collected = true;
-
-                break;
-
-            /* Database ends */
-            case 'd':
-                need_collected = false;
-                break;
-
-            /* Table begins */
-            case 'T':
-                if (fread(&tabbuf, 1, sizeof(PgStat_StatTabEntry), fpin) != sizeof(PgStat_StatTabEntry)) {
-                    ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
-                        (errmsg("corrupted statistics file \"%s\"", statfile)));
-                    goto done;
-                }
-
-                /* Skip if table is not required */
-                if (!need_collected || tabbuf.tablekey.statFlag != STATFLG_RELATION)
-                    break;
-
-                tabentry = (PgStat_AnaCheckEntry*)hash_search(
-                    u_sess->stat_cxt.analyzeCheckHash, (void*)&(tabbuf.tablekey.tableid), HASH_ENTER, &found);
-                if (found) {
-                    ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
-                        (errmsg("corrupted statistics file \"%s\"", statfile)));
-                    goto done;
-                }
-
-                if (tabbuf.analyze_timestamp != 0)
-                    tabentry->is_analyzed = true;
-                else
-                    tabentry->is_analyzed = false;
 
-                break;
+    /* Fill analyzeCheckHash with the relations of our database */
+    for (uint32 i = 0; i < NUM_PGSTAT_PARTITIONS; i++) {
+        LWLock* lock = PgStatPartitionLockByIndex(i);
 
-            /* Function begins */
-            case 'F':
-                if (fread(&funcbuf, 1, sizeof(PgStat_StatFuncEntry), fpin) != sizeof(PgStat_StatFuncEntry)) {
-                    ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
-                        (errmsg("corrupted statistics file \"%s\"", statfile)));
-                    goto done;
-                }
-
-                break;
-
-            /* The EOF marker of a complete stats file */
-            case 'E':
-                goto done;
+        LWLockAcquire(lock, LW_SHARED);
+        hash_seq_init_partition(&hstat, g_instance.stat_cxt.PgStatTabHash, i);
+        while ((entry = (PgStat_SharedTabEntry*)hash_seq_search(&hstat)) != NULL) {
+            if (entry->key.databaseid != u_sess->proc_cxt.MyDatabaseId ||
+                entry->key.tabkey.statFlag != STATFLG_RELATION)
+                continue;
 
-            default:
-                ereport(u_sess->stat_cxt.pgStatRunningInCollector ? LOG : WARNING,
-                    (errmsg("corrupted statistics file \"%s\"", statfile)));
-                goto done;
+            tabentry = (PgStat_AnaCheckEntry*)hash_search(
+                u_sess->stat_cxt.analyzeCheckHash, (void*)&(entry->key.tabkey.tableid), HASH_ENTER, NULL);
+            tabentry->is_analyzed = (entry->tabentry.analyze_timestamp != 0);
         }
+        LWLockRelease(lock);
     }
-
-done:
-    (void)FreeFile(fpin);
 }
 
 /* ----------
@@ -6094,6 +6199,8 @@ void pgstat_clear_snapshot(void)
     /* Reset variables */
     u_sess->stat_cxt.pgStatLocalContext = NULL;
     u_sess->stat_cxt.pgStatDBHash = NULL;
+    u_sess->stat_cxt.pgStatTabSnapshot = NULL;
+    u_sess->stat_cxt.pgStatFuncSnapshot = NULL;
     u_sess->stat_cxt.localBackendStatusTable = NULL;
     u_sess->stat_cxt.localNumBackends = 0;
     u_sess->stat_cxt.analyzeCheckHash = NULL;
@@ -6114,15 +6221,12 @@ static void pgstat_recv_inquiry(PgStat_MsgInquiry* msg)
 /* ----------
  * pgstat_recv_tabstat() -
  *
- *	Count what the backend has done.
+ *	Count what the backend has done in its database.
  * ----------
  */
 static void pgstat_recv_tabstat(PgStat_MsgTabstat* msg)
 {
     PgStat_StatDBEntry* dbentry = NULL;
-    PgStat_StatTabEntry* tabentry = NULL;
-    int i;
-    bool found = false;
 
     dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
 
@@ -6135,195 +6239,18 @@ static void pgstat_recv_tabstat(PgStat_MsgTabstat* msg)
     dbentry->n_block_write_time += msg->m_block_write_time;
 
     /*
-     * Process all table entries in the message.
+     * Add the sums of the per-table stats, too.
      */
-    for (i = 0; i < msg->m_nentries; i++) {
-        PgStat_TableEntry* tabmsg = &(msg->m_entry[i]);
-        PgStat_StatTabKey tabkey;
-
-        tabkey.statFlag = tabmsg->t_statFlag;
-        tabkey.tableid = tabmsg->t_id;
-
-        tabentry = (PgStat_StatTabEntry*)hash_search(dbentry->tables, (void*)(&tabkey), HASH_ENTER, &found);
-
-        if (!found) {
-            /*
-             * If it's a new table entry, initialize counters to the values we
-             * just got.
-             */
-            tabentry->numscans = tabmsg->t_counts.t_numscans;
-            tabentry->tuples_returned = tabmsg->t_counts.t_tuples_returned;
-            tabentry->tuples_fetched = tabmsg->t_counts.t_tuples_fetched;
-            tabentry->tuples_inserted = tabmsg->t_counts.t_tuples_inserted;
-            tabentry->tuples_updated = tabmsg->t_counts.t_tuples_updated;
-            tabentry->tuples_deleted = tabmsg->t_counts.t_tuples_deleted;
-            tabentry->tuples_hot_updated = tabmsg->t_counts.t_tuples_hot_updated;
-            tabentry->n_live_tuples = tabmsg->t_counts.t_delta_live_tuples;
-            tabentry->n_dead_tuples = tabmsg->t_counts.t_delta_dead_tuples;
-            tabentry->changes_since_analyze = tabmsg->t_counts.t_changed_tuples;
-            tabentry->blocks_fetched = tabmsg->t_counts.t_blocks_fetched;
-            tabentry->blocks_hit = tabmsg->t_counts.t_blocks_hit;
-            tabentry->cu_mem_hit = tabmsg->t_counts.t_cu_mem_hit;
-            tabentry->cu_hdd_sync = tabmsg->t_counts.t_cu_hdd_sync;
-            tabentry->cu_hdd_asyn = tabmsg->t_counts.t_cu_hdd_asyn;
-
-            tabentry->vacuum_timestamp = 0;
-            tabentry->vacuum_count = 0;
-            tabentry->autovac_vacuum_timestamp = 0;
-            tabentry->autovac_vacuum_count = 0;
-            tabentry->analyze_timestamp = 0;
-            tabentry->analyze_count = 0;
-            tabentry->autovac_analyze_timestamp = 0;
-            tabentry->autovac_analyze_count = 0;
-            tabentry->autovac_status = 0;
-            tabentry->data_changed_timestamp = 0;
-        } else {
-            /*
-             * Otherwise add the values to the existing entry.
-             */
-            tabentry->numscans += tabmsg->t_counts.t_numscans;
-            tabentry->tuples_returned += tabmsg->t_counts.t_tuples_returned;
-            tabentry->tuples_fetched += tabmsg->t_counts.t_tuples_fetched;
-            tabentry->tuples_inserted += tabmsg->t_counts.t_tuples_inserted;
-            tabentry->tuples_updated += tabmsg->t_counts.t_tuples_updated;
-            tabentry->tuples_deleted += tabmsg->t_counts.t_tuples_deleted;
-            tabentry->tuples_hot_updated += tabmsg->t_counts.t_tuples_hot_updated;
-            tabentry->n_live_tuples += tabmsg->t_counts.t_delta_live_tuples;
-            tabentry->n_dead_tuples += tabmsg->t_counts.t_delta_dead_tuples;
-            tabentry->changes_since_analyze += tabmsg->t_counts.t_changed_tuples;
-            tabentry->blocks_fetched += tabmsg->t_counts.t_blocks_fetched;
-            tabentry->blocks_hit += tabmsg->t_counts.t_blocks_hit;
-            tabentry->cu_mem_hit += tabmsg->t_counts.t_cu_mem_hit;
-            tabentry->cu_hdd_sync += tabmsg->t_counts.t_cu_hdd_sync;
-            tabentry->cu_hdd_asyn += tabmsg->t_counts.t_cu_hdd_asyn;
-        }
-
-        /* Clamp n_live_tuples in case of negative delta_live_tuples */
-        tabentry->n_live_tuples = Max(tabentry->n_live_tuples, 0);
-        /* Likewise for n_dead_tuples */
-        tabentry->n_dead_tuples = Max(tabentry->n_dead_tuples, 0);
-
-        /*
-         * Add per-table stats to the per-database entry, too.
-         */
-        dbentry->n_tuples_returned += tabmsg->t_counts.t_tuples_returned;
-        dbentry->n_tuples_fetched += tabmsg->t_counts.t_tuples_fetched;
-        dbentry->n_tuples_inserted += tabmsg->t_counts.t_tuples_inserted;
-        dbentry->n_tuples_updated += tabmsg->t_counts.t_tuples_updated;
-        dbentry->n_tuples_deleted += tabmsg->t_counts.t_tuples_deleted;
-        dbentry->n_blocks_fetched += tabmsg->t_counts.t_blocks_fetched;
-        dbentry->n_blocks_hit += tabmsg->t_counts.t_blocks_hit;
-        dbentry->n_cu_mem_hit += tabmsg->t_counts.t_cu_mem_hit;
-        dbentry->n_cu_hdd_sync += tabmsg->t_counts.t_cu_hdd_sync;
-        dbentry->n_cu_hdd_asyn += tabmsg->t_counts.t_cu_hdd_asyn;
-
-        /* partitioned table alse should record UDI info */
-        if (pg_stat_relation(tabkey.statFlag))
-            continue;
-
-        tabkey.tableid = tabmsg->t_statFlag;
-        tabkey.statFlag = InvalidOid;
-
-        tabentry = (PgStat_StatTabEntry*)hash_search(dbentry->tables, (void*)(&tabkey), HASH_ENTER, &found);
-
-        if (!found) {
-            /*
-             * If it's a new table entry, initialize counters to the values we
-             * just got.
-             */
-            tabentry->numscans = tabmsg->t_counts.t_numscans;
-            tabentry->tuples_returned = tabmsg->t_counts.t_tuples_returned;
-            tabentry->tuples_fetched = tabmsg->t_counts.t_tuples_fetched;
-            tabentry->tuples_inserted = tabmsg->t_counts.t_tuples_inserted;
-            tabentry->tuples_updated = tabmsg->t_counts.t_tuples_updated;
-            tabentry->tuples_deleted = tabmsg->t_counts.t_tuples_deleted;
-            tabentry->tuples_hot_updated = tabmsg->t_counts.t_tuples_hot_updated;
-            tabentry->n_live_tuples = tabmsg->t_counts.t_delta_live_tuples;
-            tabentry->n_dead_tuples = tabmsg->t_counts.t_delta_dead_tuples;
-            tabentry->changes_since_analyze = tabmsg->t_counts.t_changed_tuples;
-            tabentry->blocks_fetched = tabmsg->t_counts.t_blocks_fetched;
-            tabentry->blocks_hit = tabmsg->t_counts.t_blocks_hit;
-            tabentry->cu_mem_hit = tabmsg->t_counts.t_cu_mem_hit;
-            tabentry->cu_hdd_sync = tabmsg->t_counts.t_cu_hdd_sync;
-            tabentry->cu_hdd_asyn = tabmsg->t_counts.t_cu_hdd_asyn;
-
-            tabentry->vacuum_timestamp = 0;
-            tabentry->vacuum_count = 0;
-            tabentry->autovac_vacuum_timestamp = 0;
-            tabentry->autovac_vacuum_count = 0;
-            tabentry->analyze_timestamp = 0;
-            tabentry->analyze_count = 0;
-            tabentry->autovac_analyze_timestamp = 0;
-            tabentry->autovac_analyze_count = 0;
-            tabentry->autovac_status = 0;
-            tabentry->data_changed_timestamp = 0;
-        } else {
-            /*
-             * Otherwise add the values to the existing entry.
-             */
-            tabentry->numscans += tabmsg->t_counts.t_numscans;
-            tabentry->tuples_returned += tabmsg->t_counts.t_tuples_returned;
-            tabentry->tuples_fetched += tabmsg->t_counts.t_tuples_fetched;
-            tabentry->tuples_inserted += tabmsg->t_counts.t_tuples_inserted;
-            tabentry->tuples_updated += tabmsg->t_counts.t_tuples_updated;
-            tabentry->tuples_deleted += tabmsg->t_counts.t_tuples_deleted;
-            tabentry->tuples_hot_updated += tabmsg->t_counts.t_tuples_hot_updated;
-            tabentry->n_live_tuples += tabmsg->t_counts.t_delta_live_tuples;
-            tabentry->n_dead_tuples += tabmsg->t_counts.t_delta_dead_tuples;
-            tabentry->changes_since_analyze += tabmsg->t_counts.t_changed_tuples;
-            tabentry->blocks_fetched += tabmsg->t_counts.t_blocks_fetched;
-            tabentry->blocks_hit += tabmsg->t_counts.t_blocks_hit;
-            tabentry->cu_mem_hit += tabmsg->t_counts.t_cu_mem_hit;
-            tabentry->cu_hdd_sync += tabmsg->t_counts.t_cu_hdd_sync;
-            tabentry->cu_hdd_asyn += tabmsg->t_counts.t_cu_hdd_asyn;
-        }
-    }
-}
-
-/* ----------
- * pgstat_recv_tabpurge() -
- *
- *	Arrange for dead table removal.
- * ----------
- */
-static void pgstat_recv_tabpurge(PgStat_MsgTabpurge* msg)
-{
-    PgStat_StatDBEntry* dbentry = NULL;
-    PgStat_StatTabKey tabkey;
-    PgStat_StatTabEntry* tabentry = NULL;
-    PgStat_StatTabKey parentkey;
-    PgStat_StatTabEntry* parententry = NULL;
-    int i;
-
-    dbentry = pgstat_get_db_entry(msg->m_databaseid, false);
-    /*
-     * No need to purge if we don't even know the database.
-     */
-    if ((dbentry == NULL) || (dbentry->tables == NULL))
-        return;
-
-    /*
-     * Process all table entries in the message.
-     */
-    for (i = 0; i < msg->m_nentries; i++) {
-        tabkey.statFlag = msg->m_entry[i].m_statFlag;
-        tabkey.tableid = msg->m_entry[i].m_tableid;
-        tabentry = (PgStat_StatTabEntry*)hash_search(dbentry->tables, (void*)(&tabkey), HASH_FIND, NULL);
-        /* modify parent table's stat info if it is a patition */
-        if ((tabentry != NULL) && tabkey.statFlag) {
-            parentkey.tableid = tabkey.statFlag;
-            parentkey.statFlag = InvalidOid;
-            parententry = (PgStat_StatTabEntry*)hash_search(dbentry->tables, (void*)(&parentkey), HASH_FIND, NULL);
-            if (parententry != NULL) {
-                parententry->n_dead_tuples = Max(0, parententry->n_dead_tuples - tabentry->n_dead_tuples);
-                parententry->n_live_tuples = Max(0, parententry->n_live_tuples - tabentry->n_live_tuples);
-                parententry->changes_since_analyze += tabentry->changes_since_analyze;
-            }
-        }
-
-        /* Remove from hashtable if present; we don't care if it's not. */
-        (void*)hash_search(dbentry->tables, (void*)(&tabkey), HASH_REMOVE, NULL);
-    }
+    dbentry->n_tuples_returned += msg->m_counts.t_tuples_returned;
+    dbentry->n_tuples_fetched += msg->m_counts.t_tuples_fetched;
+    dbentry->n_tuples_inserted += msg->m_counts.t_tuples_inserted;
+    dbentry->n_tuples_updated += msg->m_counts.t_tuples_updated;
+    dbentry->n_tuples_deleted += msg->m_counts.t_tuples_deleted;
+    dbentry->n_blocks_fetched += msg->m_counts.t_blocks_fetched;
+    dbentry->n_blocks_hit += msg->m_counts.t_blocks_hit;
+    dbentry->n_cu_mem_hit += msg->m_counts.t_cu_mem_hit;
+    dbentry->n_cu_hdd_sync += msg->m_counts.t_cu_hdd_sync;
+    dbentry->n_cu_hdd_asyn += msg->m_counts.t_cu_hdd_asyn;
 }
 
 /* ----------
@@ -6344,10 +6271,6 @@ static void pgstat_recv_dropdb(PgStat_MsgDropdb* msg)
      * If found, remove it.
      */
     if (dbentry != NULL) {
-        if (dbentry->tables != NULL)
-            hash_destroy(dbentry->tables);
-        if (dbentry->functions != NULL)
-            hash_destroy(dbentry->functions);
         if (hash_search(u_sess->stat_cxt.pgStatDBHash, (void*)&(dbentry->databaseid), HASH_REMOVE, NULL) == NULL)
             ereport(ERROR,
                 (errcode(ERRCODE_DATA_CORRUPTED),
@@ -6364,9 +6287,7 @@ static void pgstat_recv_dropdb(PgStat_MsgDropdb* msg)
  */
 static void pgstat_recv_resetcounter(PgStat_MsgResetcounter* msg)
 {
-    HASHCTL hash_ctl;
     PgStat_StatDBEntry* dbentry = NULL;
-    errno_t rc = EOK;
 
     /*
      * Lookup the database in the hashtable.  Nothing to do if not there.
@@ -6376,17 +6297,9 @@ static void pgstat_recv_resetcounter(PgStat_MsgResetcounter* msg)
         return;
 
     /*
-     * We simply throw away all the database's table entries by recreating a
-     * new hash table for them.
+     * The database's table and function entries have already been removed
+     * from shared memory by the sender.
      */
-    if (dbentry->tables != NULL)
-        hash_destroy(dbentry->tables);
-    if (dbentry->functions != NULL)
-        hash_destroy(dbentry->functions);
-
-    dbentry->tables = NULL;
-    dbentry->functions = NULL;
-
     gs_lock_test_and_set_64(&g_instance.stat_cxt.NodeStatResetTime, GetCurrentTimestamp());
 
     /*
@@ -6414,18 +6327,6 @@ static void pgstat_recv_resetcounter(PgStat_MsgResetcounter* msg)
     dbentry->n_mem_mbytes_reserved = 0;
 
     dbentry->stat_reset_timestamp = GetCurrentTimestamp();
-
-    rc = memset_s(&hash_ctl, sizeof(hash_ctl), 0, sizeof(hash_ctl));
-    securec_check(rc, "\0", "\0");
-    hash_ctl.keysize = sizeof(PgStat_StatTabKey);
-    hash_ctl.entrysize = sizeof(PgStat_StatTabEntry);
-    hash_ctl.hash = tag_hash;
-    dbentry->tables = hash_create("Per-database table", PGSTAT_TAB_HASH_SIZE, &hash_ctl, HASH_ELEM | HASH_FUNCTION);
-
-    hash_ctl.keysize = sizeof(Oid);
-    hash_ctl.entrysize = sizeof(PgStat_StatFuncEntry);
-    hash_ctl.hash = oid_hash;
-    dbentry->functions = hash_create("Per-database function", 512, &hash_ctl, HASH_ELEM | HASH_FUNCTION);
 }
 
 /* ----------
@@ -6455,7 +6356,8 @@ static void pgstat_recv_resetsharedcounter(PgStat_MsgResetsharedcounter* msg)
 /* ----------
  * pgstat_recv_resetsinglecounter() -
  *
- *	Reset a statistics for a single object
+ *	Reset a statistics for a single object.  The object itself has already
+ *	been removed from shared memory by the sender.
  * ----------
  */
 static void pgstat_recv_resetsinglecounter(PgStat_MsgResetsinglecounter* msg)
@@ -6469,18 +6371,6 @@ static void pgstat_recv_resetsinglecounter(PgStat_MsgResetsinglecounter* msg)
     /* Set the reset timestamp for the whole database */
     dbentry->stat_reset_timestamp = GetCurrentTimestamp();
     gs_lock_test_and_set_64(&g_instance.stat_cxt.NodeStatResetTime, GetCurrentTimestamp());
-
-    /* Remove object if it exists, ignore it if not */
-    if (msg->m_resettype == RESET_TABLE) {
-        PgStat_StatTabKey tabkey;
-
-        tabkey.statFlag = msg->p_objectid;
-        tabkey.tableid = msg->m_objectid;
-
-        (void)hash_search(dbentry->tables, (void*)&(tabkey), HASH_REMOVE, NULL);
-    } else if (msg->m_resettype == RESET_FUNCTION) {
-        (void)hash_search(dbentry->functions, (void*)&(msg->m_objectid), HASH_REMOVE, NULL);
-    }
 }
 
 /* ----------
@@ -6501,154 +6391,6 @@ static void pgstat_recv_autovac(PgStat_MsgAutovacStart* msg)
     dbentry->last_autovac_time = msg->m_start_time;
 }
 
-/* ----------
- * pgstat_recv_vacuum() -
- *
- *	Process a VACUUM message.
- * ----------
- */
-static void pgstat_recv_vacuum(PgStat_MsgVacuum* msg)
-{
-    PgStat_StatDBEntry* dbentry = NULL;
-    PgStat_StatTabEntry* tabentry = NULL;
-
-    /*
-     * Store the data in the table's hashtable entry.
-     */
-    dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
-    tabentry = pgstat_get_tab_entry(dbentry, msg->m_tableoid, true, msg->m_statFlag);
-
-    /* Resetting dead_tuples ... use negtive number to verify Cstore */
-    if (msg->m_tuples < 0)
-        tabentry->n_dead_tuples = 0;
-    else
-        tabentry->n_dead_tuples = Max(0, tabentry->n_dead_tuples - msg->m_tuples);
-
-    if (msg->m_autovacuum) {
-        tabentry->autovac_vacuum_timestamp = msg->m_vacuumtime;
-        tabentry->autovac_vacuum_count++;
-        tabentry->vacuum_timestamp = msg->m_vacuumtime;
-        tabentry->vacuum_count++;
-    } else {
-        tabentry->vacuum_timestamp = msg->m_vacuumtime;
-        tabentry->vacuum_count++;
-    }
-}
-
-/* ----------
- * pgstat_recv_data_changed() -
- *
- *   Process a insert/delete/update/copy/[exchange/truncate/drop] partition message.
- * ----------
- */
-static void pgstat_recv_data_changed(PgStat_MsgDataChanged* msg)
-{
-    PgStat_StatDBEntry* dbentry = NULL;
-    PgStat_StatTabEntry* tabentry = NULL;
-
-    /*
-     * Store the data in the table's hashtable entry.
-     */
-    dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
-    tabentry = pgstat_get_tab_entry(dbentry, msg->m_tableoid, true, msg->m_statFlag);
-
-    /* store start time of insert/delete/update operation */
-    tabentry->data_changed_timestamp = msg->m_changed_time;
-}
-
-/* ----------
- * pgstat_recv_autovac_stat() -
- *
- *	Process a autovac stat message.
- * ----------
- */
-static void pgstat_recv_autovac_stat(PgStat_MsgAutovacStat* msg)
-{
-    PgStat_StatDBEntry* dbentry = NULL;
-    PgStat_StatTabEntry* tabentry = NULL;
-
-    /*
-     * Store the data in the table's hashtable entry.
-     */
-    dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
-    tabentry = pgstat_get_tab_entry(dbentry, msg->m_tableoid, true, msg->m_statFlag);
-    if (tabentry && AV_TIMEOUT == msg->m_autovacStat) {
-        increase_continued_timeout(tabentry->autovac_status);
-        increase_toatl_timeout(tabentry->autovac_status);
-    }
-}
-
-/* ----------
- * pgstat_recv_truncate() -
- *
- *	Process a TRUNCATE message.
- * ----------
- */
-static void pgstat_recv_truncate(PgStat_MsgTruncate* msg)
-{
-    PgStat_StatDBEntry* dbentry = NULL;
-    PgStat_StatTabEntry* tabentry = NULL;
-    PgStat_StatTabEntry* parent_entry = NULL;
-
-    /*
-     * Store the data in the table's hashtable entry.
-     */
-    dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
-    tabentry = pgstat_get_tab_entry(dbentry, msg->m_tableoid, true, msg->m_statFlag);
-
-    /* modify parent table's stat info(dead_tuple, live_tuple, changes_since_analyze) if it is a patition */
-    if (msg->m_statFlag) {
-        parent_entry = pgstat_get_tab_entry(dbentry, msg->m_statFlag, true, InvalidOid);
-        if (NULL != parent_entry) {
-            parent_entry->n_dead_tuples = Max(0, parent_entry->n_dead_tuples - tabentry->n_dead_tuples);
-            parent_entry->n_live_tuples = Max(0, parent_entry->n_live_tuples - tabentry->n_live_tuples);
-            parent_entry->changes_since_analyze += tabentry->changes_since_analyze;
-        }
-    }
-
-    /* After truncate reset dead_tuple and live_tuple */
-    tabentry->n_dead_tuples = 0;
-    tabentry->n_live_tuples = 0;
-}
-
-/* ----------
- * pgstat_recv_analyze() -
- *
- *	Process an ANALYZE message.
- * ----------
- */
-static void pgstat_recv_analyze(PgStat_MsgAnalyze* msg)
-{
-    PgStat_StatDBEntry* dbentry = NULL;
-    PgStat_StatTabEntry* tabentry = NULL;
-
-    /*
-     * Store the data in the table's hashtable entry.
-     */
-    dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
-    tabentry = pgstat_get_tab_entry(dbentry, msg->m_tableoid, true, msg->m_statFlag);
-
-    tabentry->n_live_tuples = msg->m_live_tuples;
-    tabentry->n_dead_tuples = msg->m_dead_tuples;
-
-    /*
-     * We reset changes_since_analyze to zero, forgetting any changes that
-     * occurred while the ANALYZE was in progress.
-     */
-    tabentry->changes_since_analyze = 0;
-
-    if (msg->m_autovacuum) {
-        tabentry->autovac_analyze_timestamp = msg->m_analyzetime;
-        tabentry->autovac_analyze_count++;
-        tabentry->analyze_timestamp = msg->m_analyzetime;
-        tabentry->analyze_count++;
-        reset_continued_timeout(tabentry->autovac_status);
-    } else {
-        tabentry->analyze_timestamp = msg->m_analyzetime;
-        tabentry->analyze_count++;
-    }
-}
-
 /* ----------
  * pgstat_recv_bgwriter() -
  *
@@ -6961,75 +6703,6 @@ static void pgstat_recv_memReserved(PgStat_MsgMemReserved* msg)
         dbentry->n_mem_mbytes_reserved = 0;
 }
 
-/* ----------
- * pgstat_recv_funcstat() -
- *
- *	Count what the backend has done.
- * ----------
- */
-static void pgstat_recv_funcstat(PgStat_MsgFuncstat* msg)
-{
-    PgStat_FunctionEntry* funcmsg = &(msg->m_entry[0]);
-    PgStat_StatDBEntry* dbentry = NULL;
-    PgStat_StatFuncEntry* funcentry = NULL;
-    int i;
-    bool found = false;
-
-    dbentry = pgstat_get_db_entry(msg->m_databaseid, true);
-
-    /*
-     * Process all function entries in the message.
-     */
-    for (i = 0; i < msg->m_nentries; i++, funcmsg++) {
-        funcentry = (PgStat_StatFuncEntry*)hash_search(dbentry->functions, (void*)&(funcmsg->f_id), HASH_ENTER, &found);
-
-        if (!found) {
-            /*
-             * If it's a new function entry, initialize counters to the values
-             * we just got.
-             */
-            funcentry->f_numcalls = funcmsg->f_numcalls;
-            funcentry->f_total_time = funcmsg->f_total_time;
-            funcentry->f_self_time = funcmsg->f_self_time;
-        } else {
-            /*
-             * Otherwise add the values to the existing entry.
-             */
-            funcentry->f_numcalls += funcmsg->f_numcalls;
-            funcentry->f_total_time += funcmsg->f_total_time;
-            funcentry->f_self_time += funcmsg->f_self_time;
-        }
-    }
-}
-
-/* ----------
- * pgstat_recv_funcpurge() -
- *
- *	Arrange for dead function removal.
- * ----------
- */
-static void pgstat_recv_funcpurge(PgStat_MsgFuncpurge* msg)
-{
-    PgStat_StatDBEntry* dbentry = NULL;
-    int i;
-
-    dbentry = pgstat_get_db_entry(msg->m_databaseid, false);
-
-    /*
-     * No need to purge if we don't even know the database.
-     */
-    if ((dbentry == NULL) || (dbentry->functions == NULL))
-        return;
-
-    /*
-     * Process all function entries in the message.
-     */
-    for (i = 0; i < msg->m_nentries; i++) {
-        /* Remove from hashtable if present; we don't care if it's not. */
-        (void)hash_search(dbentry->functions, (void*)&(msg->m_functionid[i]), HASH_REMOVE, NULL);
-    }
-}
-
 void pgstat_initstats_partition(Partition part)
 {
     Oid part_id = part->pd_id;
@@ -80,6 +80,7 @@
 #endif
 
 #include "access/cbmparsexlog.h"
+#include "access/nbtree.h"
 #include "access/obs/obs_am.h"
 #include "access/transam.h"
 #include "access/xlog.h"
@@ -208,6 +209,7 @@ int bbox_handler_exit = 0;
 #include "utils/distribute_test.h"
 
 #include "commands/user.h"
+#include "commands/vacuum.h"
 
 extern int S3_init();
 extern void TermMOT();
@@ -9960,6 +9962,37 @@ int GaussDbThreadMain(knl_thread_arg* arg)
             proc_exit(0);
         } break;
 #endif
+
+        case PARALLEL_DECODE: {
+            InitShmemAccess(UsedShmemSegAddr);
+
+            t_thrd.proc_cxt.MyPMChildSlot = AssignPostmasterChildSlot();
+            InitProcess();
+            CreateSharedMemoryAndSemaphores(false, 0);
+            ParallelDecodeWorkerMain(arg->payload);
+            proc_exit(0);
+        } break;
+
+        case PARALLEL_BTBUILD: {
+            InitShmemAccess(UsedShmemSegAddr);
+
+            t_thrd.proc_cxt.MyPMChildSlot = AssignPostmasterChildSlot();
+            InitProcess();
+            CreateSharedMemoryAndSemaphores(false, 0);
+            BTParallelBuildWorkerMain(arg->payload);
+            proc_exit(0);
+        } break;
+
+        case PARALLEL_VACUUM: {
+            InitShmemAccess(UsedShmemSegAddr);
+
+            t_thrd.proc_cxt.MyPMChildSlot = AssignPostmasterChildSlot();
+            InitProcess();
+            CreateSharedMemoryAndSemaphores(false, 0);
+            LazyVacuumWorkerMain(arg->payload);
+            proc_exit(0);
+        } break;
+
         default:
             ereport(PANIC, (errmsg("unsupport thread role type %d", arg->role)));
             break;
@@ -10011,7 +10044,10 @@ static GaussdbThreadEntry GaussdbThreadEntryGate[] = {GaussDbThreadMain<MASTER>,
     GaussDbThreadMain<COMM_RECEIVERFLOWER>,
     GaussDbThreadMain<COMM_RECEIVER>,
     GaussDbThreadMain<COMM_AUXILIARY>,
-    GaussDbThreadMain<COMM_POOLER_CLEAN>};
+    GaussDbThreadMain<COMM_POOLER_CLEAN>,
+    GaussDbThreadMain<PARALLEL_DECODE>,
+    GaussDbThreadMain<PARALLEL_BTBUILD>,
+    GaussDbThreadMain<PARALLEL_VACUUM>};
 
 const char* GaussdbThreadName[] = {"main",
     "worker",
@@ -10055,7 +10091,10 @@ const char* GaussdbThreadName[] = {"main",
     "communicator receiver flower",
     "communicator receiver loop",
     "communicator auxiliary",
-    "communicator pooler auto cleaner"};
+    "communicator pooler auto cleaner",
+    "parallel decoder",
+    "parallel btree builder",
+    "parallel index vacuum"};
 
 GaussdbThreadEntry GetThreadEntry(knl_thread_role role)
 {
@@ -1993,7 +1993,7 @@ static void exec_simple_query(const char* query_string, MessageType messageType,
     if (HYBRID_MESSAGE == messageType) {
         parsetree_list = pg_parse_query(sql_query_string);
     } else {
-        parsetree_list = pg_parse_query(query_string, &query_string_locationlist);
+        parsetree_list = AutoParameterizeQuery(query_string, &query_string_locationlist);
     }
 
     /* Log immediately if dictated by log_statement */
@@ -2966,6 +2966,8 @@ static void exec_parse_message(const char* query_string, /* string to execute */
      */
     is_named = (stmt_name[0] != '\0');
     if (is_named) {
+        CheckPreparedStatementName(stmt_name);
+
         if (ENABLE_DN_GPC) {
             GPCEnv *env = GPC->PlanFetch(query_string, strlen(query_string), numParams);
 
@@ -248,6 +248,9 @@ static void knl_g_stat_init(knl_g_stat_context* stat_cxt)
 
     stat_cxt->UniqueSQLHashtbl = NULL;
     stat_cxt->InstrUserHTAB = NULL;
+    stat_cxt->PgStatSharedContext = NULL;
+    stat_cxt->PgStatTabHash = NULL;
+    stat_cxt->PgStatFuncHash = NULL;
     stat_cxt->calculate_on_other_cn = false;
     stat_cxt->force_process = false;
     stat_cxt->RTPERCENTILE[0] = 0;
@@ -373,6 +373,9 @@ static void knl_u_plancache_init(knl_u_plancache_context* pcache_cxt)
     pcache_cxt->prepared_queries = NULL;
     pcache_cxt->datanode_queries = NULL;
     pcache_cxt->unnamed_stmt_psrc = NULL;
+    pcache_cxt->auto_param_rejects = NULL;
+    pcache_cxt->auto_param_stmts = NULL;
+    DLInitList(&pcache_cxt->auto_param_lru);
 
     pcache_cxt->gpc_in_ddl = false;
     pcache_cxt->gpc_remote_msg = false;
@@ -667,6 +670,8 @@ static void knl_u_stat_init(knl_u_stat_context* stat_cxt)
     stat_cxt->pgstat_stat_tmpname = NULL;
     stat_cxt->pgStatDBHash = NULL;
     stat_cxt->pgStatTabList = NULL;
+    stat_cxt->pgStatTabSnapshot = NULL;
+    stat_cxt->pgStatFuncSnapshot = NULL;
 
     stat_cxt->BgWriterStats = (PgStat_MsgBgWriter*)palloc0(sizeof(PgStat_MsgBgWriter));
     stat_cxt->globalStats = (PgStat_GlobalStats*)palloc0(sizeof(PgStat_GlobalStats));
@@ -1012,6 +1017,8 @@ void knl_session_init(knl_session_context* sess_cxt)
 {
     sess_cxt->status = KNL_SESS_UNINIT;
     DLInitElem(&sess_cxt->elem, sess_cxt);
+    sess_cxt->tpool_group = NULL;
+    sess_cxt->tpool_steal_count = 0;
 
     sess_cxt->top_transaction_mem_cxt = NULL;
     sess_cxt->self_mem_cxt = NULL;
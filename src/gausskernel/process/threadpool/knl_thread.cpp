@@ -376,6 +376,10 @@ static void knl_t_mem_init(knl_t_mem_context* mem_cxt)
     mem_cxt->mem_track_mem_cxt = NULL;
     mem_cxt->batch_encode_numeric_mem_cxt = NULL;
     mem_cxt->pgAuditLocalContext = NULL;
+    errno_t rc = memset_s(mem_cxt->shared_chunk_cache, sizeof(mem_cxt->shared_chunk_cache), 0,
+        sizeof(mem_cxt->shared_chunk_cache));
+    securec_check(rc, "\0", "\0");
+    mem_cxt->shared_chunk_cache_closed = false;
 }
 
 static void knl_t_xlog_init(knl_t_xlog_context* xlog_cxt)
@@ -700,6 +704,8 @@ static void knl_t_datareceiver_init(knl_t_datareceiver_context* datareceiver_cxt
     datareceiver_cxt->dataStreamingConn = NULL;
     datareceiver_cxt->AmDataReceiverForDummyStandby = false;
     datareceiver_cxt->recvBuf = NULL;
+    datareceiver_cxt->decompressBuf = NULL;
+    datareceiver_cxt->decompressBufSize = 0;
     datareceiver_cxt->DataRcv = NULL;
     datareceiver_cxt->DataRcvImmediateInterruptOK = false;
 }
@@ -711,6 +717,7 @@ static void knl_t_datasender_init(knl_t_datasender_context* datasender_cxt)
     datasender_cxt->am_datasender = false;
     datasender_cxt->reply_message = (StringInfoData*)palloc0(sizeof(StringInfoData));
     datasender_cxt->output_message = NULL;
+    datasender_cxt->compress_message = NULL;
     datasender_cxt->dummy_data_read_file_num = 1;
     datasender_cxt->dummy_data_read_file_fd = NULL;
     datasender_cxt->ping_sent = false;
@@ -1112,6 +1119,8 @@ static void knl_t_walreceiver_init(knl_t_walreceiver_context* walreceiver_cxt)
     walreceiver_cxt->AmWalReceiverForFailover = false;
     walreceiver_cxt->AmWalReceiverForStandby = false;
     walreceiver_cxt->control_file_writed = 0;
+    walreceiver_cxt->decompressBuf = NULL;
+    walreceiver_cxt->decompressBufSize = 0;
 }
 
 static void knl_t_storage_init(knl_t_storage_context* storage_cxt)
@@ -1273,6 +1282,7 @@ static void knl_t_walsender_init(knl_t_walsender_context* walsender_cxt)
     walsender_cxt->sentPtr = 0;
     walsender_cxt->catchup_threshold = 0;
     walsender_cxt->output_xlog_msg_prefix_len = 0;
+    walsender_cxt->compress_xlog_message = NULL;
     walsender_cxt->output_data_msg_cur_len = 0;
     walsender_cxt->output_data_msg_start_xlog = InvalidXLogRecPtr;
     walsender_cxt->output_data_msg_end_xlog = InvalidXLogRecPtr;
@@ -148,10 +148,73 @@ void ThreadPoolControler::Init(bool enableNumaDistribute)
     }
 #endif
 
+    InitStealVictims();
+
     m_scheduler = New(CurrentMemoryContext) ThreadPoolScheduler(m_groupNum, m_groups);
     m_scheduler->StartUp();
 }
 
+int ThreadPoolControler::GetNumaDistance(int numaA, int numaB) const
+{
+    int distance = THREAD_STEAL_LOCAL_DISTANCE;
+
+#ifdef __USE_NUMA
+    if (numaA >= 0 && numaB >= 0 && numa_available() >= 0) {
+        distance = numa_distance(numaA, numaB);
+    }
+#endif
+    /* numa_distance returns 0 if the distance can not be read */
+    return (distance < THREAD_STEAL_LOCAL_DISTANCE) ? THREAD_STEAL_LOCAL_DISTANCE : distance;
+}
+
+/*
+ * Give every group the list of groups it may steal ready sessions from,
+ * ordered by NUMA distance. The farther the victim, the more sessions must
+ * be waiting there before running one of them remotely pays off.
+ */
+void ThreadPoolControler::InitStealVictims()
+{
+    int stealThreshold = g_instance.attr.attr_common.thread_pool_steal_threshold;
+
+    /* without victims no session is stolen, and so none is migrated */
+    if (m_groupNum <= 1 || stealThreshold == 0) {
+        return;
+    }
+
+    for (int i = 0; i < m_groupNum; i++) {
+        ThreadPoolGroup** victims = (ThreadPoolGroup**)palloc(sizeof(ThreadPoolGroup*) * (m_groupNum - 1));
+        int* distances = (int*)palloc(sizeof(int) * (m_groupNum - 1));
+        int* thresholds = (int*)palloc(sizeof(int) * (m_groupNum - 1));
+        int num = 0;
+
+        for (int j = 0; j < m_groupNum; j++) {
+            if (j == i) {
+                continue;
+            }
+
+            int distance = GetNumaDistance(m_groups[i]->GetNumaId(), m_groups[j]->GetNumaId());
+            int pos = num;
+
+            /* insertion sort, the group number is at most the NUMA node number */
+            while (pos > 0 && distances[pos - 1] > distance) {
+                victims[pos] = victims[pos - 1];
+                distances[pos] = distances[pos - 1];
+                pos--;
+            }
+            victims[pos] = m_groups[j];
+            distances[pos] = distance;
+            num++;
+        }
+
+        for (int k = 0; k < num; k++) {
+            thresholds[k] = stealThreshold * distances[k] / THREAD_STEAL_LOCAL_DISTANCE;
+        }
+        pfree(distances);
+
+        m_groups[i]->SetStealVictims(victims, thresholds, num);
+    }
+}
+
 void ThreadPoolControler::SetThreadPoolInfo()
 {
     InitCpuInfo();
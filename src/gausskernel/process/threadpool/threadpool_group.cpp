@@ -68,10 +68,15 @@ ThreadPoolGroup::ThreadPoolGroup(int maxWorkerNum, int expectWorkerNum,
       m_sessionCount(0),
       m_waitServeSessionCount(0),
       m_processTaskCount(0),
+      m_stealCount(0),
+      m_migrateCount(0),
       m_groupId(groupId),
       m_numaId(numaId),
       m_groupCpuNum(cpuNum),
       m_groupCpuArr(cpuArr),
+      m_stealVictims(NULL),
+      m_stealThresholds(NULL),
+      m_stealVictimNum(0),
       m_workers(NULL),
       m_enableNumaDistribute(false)
 {
@@ -189,9 +194,9 @@ void ThreadPoolGroup::GetThreadPoolGroupStat(ThreadPoolStat* stat)
     int idle_session_num = m_sessionCount - m_waitServeSessionCount - run_session_num;
     idle_session_num = (idle_session_num < 0) ? 0 : idle_session_num;
     rc = sprintf_s(stat->sessionInfo, STATUS_INFO_SIZE,
-        "total: %d waiting: %d running:%d idle: %d",
+        "total: %d waiting: %d running:%d idle: %d stolen: %u migrated: %u",
         m_sessionCount, m_waitServeSessionCount,
-        run_session_num, idle_session_num);
+        run_session_num, idle_session_num, m_stealCount, m_migrateCount);
     securec_check_ss(rc, "\0", "\0");
 }
 
@@ -328,6 +333,61 @@ bool ThreadPoolGroup::IsGroupHang()
     return is_hang;
 }
 
+void ThreadPoolGroup::SetStealVictims(ThreadPoolGroup** victims, int* thresholds, int victimNum)
+{
+    m_stealVictims = victims;
+    m_stealThresholds = thresholds;
+    m_stealVictimNum = victimNum;
+}
+
+/*
+ * Take a ready session from the nearest group whose waiting queue exceeds its
+ * stealing threshold. The session stays registered at its own listener, the
+ * worker serving it returns it there when the request is done.
+ */
+knl_session_context* ThreadPoolGroup::StealSession()
+{
+    knl_session_context* session = NULL;
+
+    for (int i = 0; i < m_stealVictimNum; i++) {
+        ThreadPoolGroup* victim = m_stealVictims[i];
+        if (victim->m_waitServeSessionCount < m_stealThresholds[i]) {
+            continue;
+        }
+
+        session = victim->m_listener->StealReadySession();
+        if (session != NULL) {
+            pg_atomic_fetch_add_u32((volatile uint32*)&m_stealCount, 1);
+            return session;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Hand sessions waiting in overloaded groups to the sleeping workers of this
+ * group. Running workers steal by themselves when they run out of work, this
+ * only wakes up a group that went idle entirely.
+ */
+void ThreadPoolGroup::StealForIdleWorkers()
+{
+    knl_session_context* session = NULL;
+    int idleWorkerNum = m_idleWorkerNum;
+
+    for (int i = 0; i < idleWorkerNum; i++) {
+        session = StealSession();
+        if (session == NULL) {
+            break;
+        }
+        m_listener->FeedSession(session);
+    }
+}
+
+void ThreadPoolGroup::CountMigration()
+{
+    pg_atomic_fetch_add_u32((volatile uint32*)&m_migrateCount, 1);
+}
+
 void ThreadPoolGroup::AttachThreadToCPU(ThreadId thread, int cpu)
 {
     cpu_set_t cpu_set;
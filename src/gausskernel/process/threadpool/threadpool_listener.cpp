@@ -173,6 +173,14 @@ bool ThreadPoolListener::TryFeedWorker(ThreadPoolWorker* worker)
         pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_waitServeSessionCount, 1);
         pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_processTaskCount, 1);
         return true;
+    }
+
+    /* Nothing to do in our group, help an overloaded group before going idle. */
+    knl_session_context* session = m_group->StealSession();
+    if (session != NULL) {
+        worker->SetSession(session);
+        pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_processTaskCount, 1);
+        return true;
     } else {
         m_freeWorkerList->AddTail(&worker->m_elem);
         pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_idleWorkerNum, 1);
@@ -180,8 +188,48 @@ bool ThreadPoolListener::TryFeedWorker(ThreadPoolWorker* worker)
     }
 }
 
+knl_session_context* ThreadPoolListener::StealReadySession()
+{
+    Dlelem* sc = m_readySessionList->RemoveHead();
+    if (sc == NULL) {
+        return NULL;
+    }
+
+    pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_waitServeSessionCount, 1);
+    return (knl_session_context*)DLE_VAL(sc);
+}
+
+/*
+ * Move a session to this listener, the connection is no longer watched by
+ * the epoll of its old listener. If the connection can not be added to the
+ * epoll of this listener, nothing is changed and false is returned.
+ */
+bool ThreadPoolListener::MigrateSession(knl_session_context* session)
+{
+    struct epoll_event ev = {0};
+    ThreadPoolGroup* owner = session->tpool_group;
+
+    session->tpool_group = m_group;
+    m_idleSessionList->AddTail(&session->elem);
+    (void)pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_sessionCount, 1);
+
+    ev.events = EPOLLRDHUP | EPOLLIN | EPOLLET | EPOLLONESHOT;
+    ev.data.ptr = (void*)session;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, session->proc_cxt.MyProcPort->sock, &ev) != 0) {
+        ereport(LOG, (errmsg("could not add session %lu to listener epoll: %m", session->session_id)));
+        m_idleSessionList->Remove(&session->elem);
+        (void)pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_sessionCount, 1);
+        session->tpool_group = owner;
+        return false;
+    }
+
+    session->tpool_steal_count = 0;
+    return true;
+}
+
 void ThreadPoolListener::AddNewSession(knl_session_context* session)
 {
+    session->tpool_group = m_group;
     AddEpoll(session);
     (void)pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_sessionCount, 1);
 }
@@ -286,6 +334,11 @@ knl_session_context* ThreadPoolListener::GetSessionBaseOnEvent(struct epoll_even
 void ThreadPoolListener::DispatchSession(knl_session_context* session)
 {
     m_idleSessionList->Remove(&session->elem);
+    FeedSession(session);
+}
+
+void ThreadPoolListener::FeedSession(knl_session_context* session)
+{
     while (true) {
         Dlelem* sc = m_freeWorkerList->RemoveHead();
         if (sc != NULL) {
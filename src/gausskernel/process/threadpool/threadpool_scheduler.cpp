@@ -89,6 +89,9 @@ void ThreadPoolScheduler::DynamicAdjustThreadPool()
                 m_freeTestCount[i]++;
                 ReduceWorkerIfNecessary(i);
             }
+
+            /* Let a group with sleeping workers help the overloaded groups. */
+            group->StealForIdleWorkers();
         }
     }
 }
@@ -449,11 +449,44 @@ void ThreadPoolWorker::DetachSessionFromThread()
     m_currentSession->attachPid = (ThreadId)-1;
 
     /* should restore the data before return to listener. */
-    m_group->GetListener()->AddEpoll(m_currentSession);
+    ReturnSessionToListener();
     m_currentSession = NULL;
     u_sess = NULL;
 }
 
+/*
+ * Give the session back to the listener watching its connection. A session
+ * served outside its own group several times in a row is moved to the
+ * listener of this group, so its requests stop queueing in the busy group.
+ */
+void ThreadPoolWorker::ReturnSessionToListener()
+{
+    ThreadPoolGroup* owner = m_currentSession->tpool_group;
+
+    if (owner == m_group) {
+        m_currentSession->tpool_steal_count = 0;
+        owner->GetListener()->AddEpoll(m_currentSession);
+        return;
+    }
+
+    if (++m_currentSession->tpool_steal_count < THREAD_MIGRATE_STEAL_TIMES) {
+        owner->GetListener()->AddEpoll(m_currentSession);
+        return;
+    }
+
+    owner->GetListener()->DelSessionFromEpoll(m_currentSession);
+    if (m_group->GetListener()->MigrateSession(m_currentSession)) {
+        m_group->CountMigration();
+        return;
+    }
+
+    /* keep the session in its group, nobody would serve it out of an epoll */
+    if (!owner->GetListener()->MigrateSession(m_currentSession)) {
+        ereport(PANIC, (errmsg("could not return session %lu to the thread pool listener",
+            m_currentSession->session_id)));
+    }
+}
+
 bool ThreadPoolWorker::AttachSessionToThread()
 {
     Assert(m_currentSession != NULL);
@@ -561,7 +594,7 @@ void ThreadPoolWorker::CleanUpSession(bool threadexit)
         }
 
         /* Close Session. */
-        m_group->GetListener()->DelSessionFromEpoll(m_currentSession);
+        m_currentSession->tpool_group->GetListener()->DelSessionFromEpoll(m_currentSession);
 
         /*
          * Record this state in case we reenter this function because
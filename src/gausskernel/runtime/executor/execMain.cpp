@@ -1983,6 +1983,10 @@ static void ExecutePlan(EState *estate, PlanState *planstate, CmdType operation,
                 uint64_t tp_processed = 0;
                 int rc = JitExec::JitExecQuery(mot_jit_context, estate->es_param_list_info,
                         slot, &tp_processed, &scan_ended);
+                if (operation != CMD_SELECT) {
+                    // the jitted code modifies the rows itself, ModifyTable does not get to count them
+                    estate->es_processed += tp_processed;
+                }
                 if (scan_ended || (tp_processed == 0) || (rc != 0)) {
                     // raise flag so that next round we will bail out (current tuple still must be reported to user)
                     mm_finished_execution = true;
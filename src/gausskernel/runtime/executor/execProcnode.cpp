@@ -543,6 +543,13 @@ PlanState* ExecInitNode(Plan* node, EState* e_state, int e_flags)
                     "VectorSonicHashJoin",
                     plan_dop,
                     plan_rows);
+            } else if (nodeTag(node) == T_VecWindowAgg && ((WindowAgg*)node)->is_sonicwindow) {
+                ExplainCreateDNodeInfoOnDN(&qid,
+                    result->instrument,
+                    node->exec_type == EXEC_ON_DATANODES,
+                    "VectorSonicWindowAgg",
+                    plan_dop,
+                    plan_rows);
             } else {
                 ExplainCreateDNodeInfoOnDN(&qid,
                     result->instrument,
@@ -881,6 +888,8 @@ void ExplainNodeFinish(PlanState* result_plan, PlannedStmt *pstmt, TimestampTz c
                 plan_name = "VectorSonicHashAgg";
             } else if (nodeTag(node) == T_VecHashJoin && ((HashJoin*)node)->isSonicHash) {
                 plan_name = "VectorSonicHashJoin";
+            } else if (nodeTag(node) == T_VecWindowAgg && ((WindowAgg*)node)->is_sonicwindow) {
+                plan_name = "VectorSonicWindowAgg";
             } else {
                 plan_name = nodeTagToString(nodeTag(node));
             }
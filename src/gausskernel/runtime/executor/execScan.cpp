@@ -22,6 +22,7 @@
 
 #include "executor/executor.h"
 #include "miscadmin.h"
+#include "utils/bloom_filter.h"
 #include "utils/memutils.h"
 
 /*
@@ -74,6 +75,97 @@ static TupleTableSlot* ExecScanFetch(ScanState* node, ExecScanAccessMtd access_m
     return (*access_mtd)(node);
 }
 
+/*
+ * ExecScanRuntimeFilterRange -- check a value against the min/max of a
+ * runtime join filter, return false if it is out of range.
+ */
+static bool ExecScanRuntimeFilterRange(const filter::BloomFilter* bf, Oid type, Datum value)
+{
+    switch (type) {
+        case INT2OID:
+            return DatumGetInt16(value) >= DatumGetInt16(bf->getMin()) &&
+                   DatumGetInt16(value) <= DatumGetInt16(bf->getMax());
+        case INT4OID:
+            return DatumGetInt32(value) >= DatumGetInt32(bf->getMin()) &&
+                   DatumGetInt32(value) <= DatumGetInt32(bf->getMax());
+        case INT8OID:
+            return DatumGetInt64(value) >= DatumGetInt64(bf->getMin()) &&
+                   DatumGetInt64(value) <= DatumGetInt64(bf->getMax());
+        default:
+            return true;
+    }
+}
+
+/*
+ * ExecScanRuntimeFilter -- check the scan tuple against the runtime join
+ * filters pushed down by hash joins, return false if it can not be joined.
+ *
+ * A filter is only present after its hash join has built the hash table, the
+ * tuples scanned before that are passed through.
+ */
+static bool ExecScanRuntimeFilter(ScanState* node, TupleTableSlot* slot)
+{
+    BloomFilterRuntime* bf_runtime = &node->ss_runtimeFilter;
+    Instrumentation* instr = node->ps.instrument;
+    ListCell* lc1 = NULL;
+    ListCell* lc2 = NULL;
+
+    forboth(lc1, bf_runtime->bf_var_list, lc2, bf_runtime->bf_filter_index) {
+        Var* var = (Var*)lfirst(lc1);
+        filter::BloomFilter* bf = bf_runtime->bf_array[lfirst_int(lc2)];
+        bool isnull = false;
+        Datum value;
+
+        /* the filter must be built on the same type, or datums can not be compared */
+        if (bf == NULL || bf->getDataType() != var->vartype) {
+            continue;
+        }
+
+        /* null keys never match the hash join */
+        value = slot_getattr(slot, var->varattno, &isnull);
+        if (isnull) {
+            if (instr != NULL) {
+                instr->bloomFilterRows++;
+            }
+            return false;
+        }
+
+        if (bf->hasMinMax() && !ExecScanRuntimeFilterRange(bf, var->vartype, value)) {
+            if (instr != NULL) {
+                instr->minmaxFilterRows++;
+            }
+            return false;
+        }
+
+        if (!bf->includeDatum(value)) {
+            if (instr != NULL) {
+                instr->bloomFilterRows++;
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * ExecScanInitRuntimeFilter
+ *		Set up the runtime join filters a hash join pushes into this scan.
+ */
+void ExecScanInitRuntimeFilter(ScanState* node)
+{
+    Plan* plan = node->ps.plan;
+    EState* estate = node->ps.state;
+
+    if (plan->var_list == NIL || estate->es_bloom_filter.bfarray == NULL) {
+        return;
+    }
+
+    node->ss_runtimeFilter.bf_var_list = plan->var_list;
+    node->ss_runtimeFilter.bf_filter_index = plan->filterIndexList;
+    node->ss_runtimeFilter.bf_array = estate->es_bloom_filter.bfarray;
+}
+
 /* ----------------------------------------------------------------
  *		ExecScan
  *
@@ -119,7 +211,7 @@ TupleTableSlot* ExecScan(ScanState* node, ExecScanAccessMtd access_mtd, /* funct
      * If we have neither a qual to check nor a projection to do, just skip
      * all the overhead and return the raw scan tuple.
      */
-    if (qual == NULL && proj_info == NULL) {
+    if (qual == NULL && proj_info == NULL && node->ss_runtimeFilter.bf_var_list == NIL) {
         ResetExprContext(e_context);
         return ExecScanFetch(node, access_mtd, recheck_mtd);
     }
@@ -179,6 +271,14 @@ TupleTableSlot* ExecScan(ScanState* node, ExecScanAccessMtd access_mtd, /* funct
                 return slot;
         }
 
+        /*
+         * drop the tuple early if the runtime join filters tell it can not
+         * be joined, before the qual and the projection
+         */
+        if (node->ss_runtimeFilter.bf_var_list != NIL && !ExecScanRuntimeFilter(node, slot)) {
+            continue;
+        }
+
         /*
          * place the current tuple into the expr context
          */
@@ -386,6 +386,14 @@ BitmapIndexScanState* ExecInitBitmapIndexScan(BitmapIndexScan* node, EState* est
             indexstate->biss_RelationDesc, estate->es_snapshot, indexstate->biss_NumScanKeys, (ScanState*)indexstate);
     }
 
+    /* Let the AM skip over the leading column if the planner chose a skip scan */
+    indexstate->biss_NumSkips = 0;
+    if (PointerIsValid(indexstate->biss_ScanDesc)) {
+        IndexScanDesc index_scan = GetIndexScanDesc(indexstate->biss_ScanDesc);
+        index_scan->xs_skip_scan = node->indexskipscan;
+        index_scan->xs_nskips = &indexstate->biss_NumSkips;
+    }
+
     /*
      * If no run-time keys to calculate, go ahead and pass the scankeys to the
      * index AM.
@@ -446,6 +454,8 @@ static void ExecInitNextPartitionForBitmapIndexScan(BitmapIndexScanState* node)
         node->biss_CurrentIndexPartition, node->ss.ps.state->es_snapshot, node->biss_NumScanKeys, (ScanState*)node);
 
     Assert(PointerIsValid(node->biss_ScanDesc));
+    GetIndexScanDesc(node->biss_ScanDesc)->xs_skip_scan = plan->indexskipscan;
+    GetIndexScanDesc(node->biss_ScanDesc)->xs_nskips = &node->biss_NumSkips;
 }
 
 /*
@@ -37,6 +37,7 @@
 #include "pgstat.h"
 #include "pgxc/pgxc.h"
 #include "utils/anls_opt.h"
+#include "utils/bloom_filter.h"
 #include "utils/dynahash.h"
 #include "utils/lsyscache.h"
 #include "utils/memprot.h"
@@ -55,6 +56,10 @@ static void ExecHashRemoveNextSkewBucket(HashJoinTable hashtable);
 static void ExecHashIncreaseBuckets(HashJoinTable hashtable);
 
 static void* dense_alloc(HashJoinTable hashtable, Size size);
+static void ExecHashRuntimeFilterInit(HashState* node);
+static void ExecHashRuntimeFilterAdd(HashState* node, TupleTableSlot* slot, double ntuples);
+static void ExecHashRuntimeFilterFree(HashState* node);
+static void ExecHashRuntimeFilterPublish(HashState* node);
 /* ----------------------------------------------------------------
  *		ExecHash
  *
@@ -90,6 +95,8 @@ Node* MultiExecHash(HashState* node)
     if (node->ps.instrument) {
         InstrStartNode(node->ps.instrument);
         node->hashtable->spill_size = &node->ps.instrument->sorthashinfo.spill_size;
+        node->hashtable->spill_rawSize = &node->ps.instrument->sorthashinfo.spill_rawSize;
+        node->hashtable->spill_compressSize = &node->ps.instrument->sorthashinfo.spill_compressSize;
     } else {
         node->hashtable->spill_size = &node->spill_size;
     }
@@ -106,6 +113,9 @@ Node* MultiExecHash(HashState* node)
     hashkeys = node->hashkeys;
     econtext = node->ps.ps_ExprContext;
 
+    /* runtime join filters pushed into the outer side are filled on the fly */
+    ExecHashRuntimeFilterInit(node);
+
     /*
      * get all inner tuples and insert into the hash table (or temp files)
      */
@@ -133,10 +143,16 @@ Node* MultiExecHash(HashState* node)
                     node->ps.instrument);
             }
             hashtable->totalTuples += 1;
+
+            if (node->bf_build != NULL) {
+                ExecHashRuntimeFilterAdd(node, slot, hashtable->totalTuples);
+            }
         }
     }
     (void)pgstat_report_waitstatus(oldStatus);
 
+    ExecHashRuntimeFilterPublish(node);
+
     /* analysis hash table information created in memory */
     if (anls_opt_is_on(ANLS_HASH_CONFLICT))
         ExecHashTableStats(hashtable, node->ps.plan->plan_node_id);
@@ -167,6 +183,145 @@ Node* MultiExecHash(HashState* node)
     return NULL;
 }
 
+/*
+ * ExecHashRuntimeFilterInit
+ *
+ *		Create the runtime join filters of the parent hash join, one for each
+ *		inner join key pushed into the outer side.  Null keys are not inserted
+ *		into the hash table, so the filters are skipped when nulls are kept.
+ */
+static void ExecHashRuntimeFilterInit(HashState* node)
+{
+    BloomFilterRuntime* bf_runtime = &node->bf_runtime;
+    int nfilters = list_length(bf_runtime->bf_var_list);
+    MemoryContext oldcxt;
+    ListCell* lc = NULL;
+    int i = 0;
+
+    if (nfilters == 0 || bf_runtime->bf_array == NULL || node->hashtable->keepNulls) {
+        return;
+    }
+
+    oldcxt = MemoryContextSwitchTo(node->ps.state->es_query_cxt);
+    node->bf_build = (filter::BloomFilter**)palloc0(nfilters * sizeof(filter::BloomFilter*));
+    foreach (lc, bf_runtime->bf_var_list) {
+        Var* var = (Var*)lfirst(lc);
+
+        if (SATISFY_BLOOM_FILTER(var->vartype)) {
+            node->bf_build[i] = filter::createBloomFilter(var->vartype,
+                var->vartypmod,
+                var->varcollid,
+                HASHJOIN_BLOOM_FILTER,
+                RUNTIME_JOIN_FILTER_MAX_ROWS,
+                true);
+        }
+        i++;
+    }
+    (void)MemoryContextSwitchTo(oldcxt);
+}
+
+/*
+ * ExecHashRuntimeFilterAdd
+ *
+ *		Add the join keys of an inner tuple into the runtime join filters.
+ *		Give them up when the inner side is too large for a useful filter.
+ */
+static void ExecHashRuntimeFilterAdd(HashState* node, TupleTableSlot* slot, double ntuples)
+{
+    ListCell* lc = NULL;
+    int i = 0;
+
+    if (ntuples > RUNTIME_JOIN_FILTER_MAX_ROWS) {
+        ExecHashRuntimeFilterFree(node);
+        return;
+    }
+
+    foreach (lc, node->bf_runtime.bf_var_list) {
+        Var* var = (Var*)lfirst(lc);
+        filter::BloomFilter* bf = node->bf_build[i++];
+        bool isnull = false;
+        Datum value;
+
+        if (bf == NULL) {
+            continue;
+        }
+
+        value = slot_getattr(slot, var->varattno, &isnull);
+        if (!isnull) {
+            bf->addDatum(value);
+        }
+    }
+}
+
+/*
+ * ExecHashRuntimeFilterFree
+ *
+ *		Release the runtime join filters which are still being built.
+ */
+static void ExecHashRuntimeFilterFree(HashState* node)
+{
+    int nfilters = list_length(node->bf_runtime.bf_var_list);
+
+    if (node->bf_build == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < nfilters; i++) {
+        if (node->bf_build[i] != NULL) {
+            delete node->bf_build[i];
+        }
+    }
+    pfree_ext(node->bf_build);
+}
+
+/*
+ * ExecHashRuntimeFilterPublish
+ *
+ *		Hand the runtime join filters over to the outer side scans once the
+ *		build is done.
+ */
+static void ExecHashRuntimeFilterPublish(HashState* node)
+{
+    BloomFilterRuntime* bf_runtime = &node->bf_runtime;
+    ListCell* lc = NULL;
+    int i = 0;
+
+    if (node->bf_build == NULL) {
+        return;
+    }
+
+    ExecHashResetRuntimeFilter(node);
+    foreach (lc, bf_runtime->bf_filter_index) {
+        bf_runtime->bf_array[lfirst_int(lc)] = node->bf_build[i++];
+    }
+    pfree_ext(node->bf_build);
+}
+
+/*
+ * ExecHashResetRuntimeFilter
+ *
+ *		Withdraw the runtime join filters before the hash table is rebuilt,
+ *		the outer side must not see the filters of the old inner side.
+ */
+void ExecHashResetRuntimeFilter(HashState* node)
+{
+    BloomFilterRuntime* bf_runtime = &node->bf_runtime;
+    ListCell* lc = NULL;
+
+    if (bf_runtime->bf_array == NULL) {
+        return;
+    }
+
+    foreach (lc, bf_runtime->bf_filter_index) {
+        int idx = lfirst_int(lc);
+
+        if (bf_runtime->bf_array[idx] != NULL) {
+            delete bf_runtime->bf_array[idx];
+            bf_runtime->bf_array[idx] = NULL;
+        }
+    }
+}
+
 /* ----------------------------------------------------------------
  *		ExecInitHash
  *
@@ -336,6 +491,8 @@ HashJoinTable ExecHashTableCreate(Hash* node, List* hashOperators, bool keepNull
     /* should we allow auto mem spread in query mem mode? */
     hashtable->maxMem = max_mem * 1024L;
     hashtable->spreadNum = 0;
+    hashtable->spill_rawSize = NULL;
+    hashtable->spill_compressSize = NULL;
 
     /*
      * Get info about the hash functions to be used for each hash key. Also
@@ -872,8 +1029,8 @@ static void ExecHashIncreaseNumBatches(HashJoinTable hashtable)
             } else {
                 /* dump it out */
                 Assert(batchno > curbatch);
-                ExecHashJoinSaveTuple(
-                    HJTUPLE_MINTUPLE(hashTuple), hashTuple->hashvalue, &hashtable->innerBatchFile[batchno]);
+                ExecHashJoinSaveTuple(HJTUPLE_MINTUPLE(hashTuple), hashTuple->hashvalue,
+                    &hashtable->innerBatchFile[batchno], hashtable);
 
                 hashtable->spaceUsed -= hashTupleSize;
                 nfreed++;
@@ -1033,7 +1190,7 @@ void ExecHashTableInsert(
          * put the tuple into a temp file for later batches
          */
         Assert(batchno > hashtable->curbatch);
-        ExecHashJoinSaveTuple(tuple, hashvalue, &hashtable->innerBatchFile[batchno]);
+        ExecHashJoinSaveTuple(tuple, hashvalue, &hashtable->innerBatchFile[batchno], hashtable);
 
         *hashtable->spill_size += sizeof(uint32) + tuple->t_len;
         pgstat_increase_session_spill_size(sizeof(uint32) + tuple->t_len);
@@ -1673,7 +1830,7 @@ static void ExecHashRemoveNextSkewBucket(HashJoinTable hashtable)
         } else {
             /* Put the tuple into a temp file for later batches */
             Assert(batchno > hashtable->curbatch);
-            ExecHashJoinSaveTuple(tuple, hashvalue, &hashtable->innerBatchFile[batchno]);
+            ExecHashJoinSaveTuple(tuple, hashvalue, &hashtable->innerBatchFile[batchno], hashtable);
             pfree_ext(hashTuple);
             hashtable->spaceUsed -= tupleSize;
             hashtable->spaceUsedSkew -= tupleSize;
@@ -267,7 +267,7 @@ TupleTableSlot* ExecHashJoin(HashJoinState* node)
                      */
                     Assert(batchno > hashtable->curbatch);
                     MinimalTuple tuple = ExecFetchSlotMinimalTuple(outerTupleSlot);
-                    ExecHashJoinSaveTuple(tuple, hashvalue, &hashtable->outerBatchFile[batchno]);
+                    ExecHashJoinSaveTuple(tuple, hashvalue, &hashtable->outerBatchFile[batchno], hashtable);
                     *hashtable->spill_size += sizeof(uint32) + tuple->t_len;
                     pgstat_increase_session_spill_size(sizeof(uint32) + tuple->t_len);
 
@@ -512,6 +512,15 @@ HashJoinState* ExecInitHashJoin(HashJoin* node, EState* estate, int eflags)
     outerPlanState(hjstate) = ExecInitNode(outerNode, estate, eflags);
     innerPlanState(hjstate) = ExecInitNode((Plan*)hashNode, estate, eflags);
 
+    /* the hash node fills the runtime join filters pushed into the outer side */
+    if (node->join.plan.var_list != NIL) {
+        HashState* hashstate = (HashState*)innerPlanState(hjstate);
+
+        hashstate->bf_runtime.bf_var_list = node->join.plan.var_list;
+        hashstate->bf_runtime.bf_filter_index = node->join.plan.filterIndexList;
+        hashstate->bf_runtime.bf_array = estate->es_bloom_filter.bfarray;
+    }
+
     /*
      * tuple table initialization
      */
@@ -860,20 +869,25 @@ static bool ExecHashJoinNewBatch(HashJoinState* hjstate)
  *		save a tuple to a batch file.
  *
  * The data recorded in the file for each tuple is its hash value,
- * then the tuple in MinimalTuple format.
+ * then the tuple in MinimalTuple format.  Batch files are compressed when
+ * enable_compress_spill is on.
  *
  * Note: it is important always to call this in the regular executor
  * context, not in a shorter-lived context; else the temp file buffers
  * will get messed up.
  */
-void ExecHashJoinSaveTuple(MinimalTuple tuple, uint32 hashvalue, BufFile** fileptr)
+void ExecHashJoinSaveTuple(MinimalTuple tuple, uint32 hashvalue, BufFile** fileptr, HashJoinTable hashtable)
 {
     BufFile* file = *fileptr;
     size_t written;
 
     if (file == NULL) {
         /* First write to this batch file, so open it. */
-        file = BufFileCreateTemp(false);
+        if (u_sess->attr.attr_sql.enable_compress_spill) {
+            file = BufFileCreateTempCompress(false, hashtable->spill_rawSize, hashtable->spill_compressSize);
+        } else {
+            file = BufFileCreateTemp(false);
+        }
         *fileptr = file;
     }
 
@@ -1006,6 +1020,7 @@ void ExecReScanHashJoin(HashJoinState* node)
             ExecHashTableDestroy(node->hj_HashTable);
             node->hj_HashTable = NULL;
             node->hj_JoinState = HJ_BUILD_HASHTABLE;
+            ExecHashResetRuntimeFilter((HashState*)innerPlanState(node));
 
             /*
              * if chgParam of subnode is not null then plan will be re-scanned
@@ -1020,6 +1035,7 @@ void ExecReScanHashJoin(HashJoinState* node)
             // no need to destroy hash table, just build it.
             node->hj_HashTable = NULL;
             node->hj_JoinState = HJ_BUILD_HASHTABLE;
+            ExecHashResetRuntimeFilter((HashState*)innerPlanState(node));
 
             // swtich to next partition, in the right tree
             if (node->js.ps.righttree->chgParam == NULL) {
@@ -1109,6 +1125,7 @@ void ExecReSetHashJoin(HashJoinState* node)
         ExecHashTableDestroy(node->hj_HashTable);
         node->hj_HashTable = NULL;
         node->hj_JoinState = HJ_BUILD_HASHTABLE;
+        ExecHashResetRuntimeFilter((HashState*)innerPlanState(node));
     }
     ExecReSetRecursivePlanTree(node->js.ps.righttree);
 
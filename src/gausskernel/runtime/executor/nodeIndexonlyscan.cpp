@@ -610,9 +610,13 @@ IndexOnlyScanState* ExecInitIndexOnlyScan(IndexOnlyScan* node, EState* estate, i
     /*
      * If is Partition table, if ( 0 == node->scan.itrs), scan_desc is NULL.
      */
+    indexstate->ioss_NumSkips = 0;
     if (PointerIsValid(indexstate->ioss_ScanDesc)) {
         /* Set it up for index-only scan */
-        GetIndexScanDesc(indexstate->ioss_ScanDesc)->xs_want_itup = true;
+        IndexScanDesc index_scan = GetIndexScanDesc(indexstate->ioss_ScanDesc);
+        index_scan->xs_want_itup = true;
+        index_scan->xs_skip_scan = node->indexskipscan;
+        index_scan->xs_nskips = &indexstate->ioss_NumSkips;
         indexstate->ioss_VMBuffer = InvalidBuffer;
 
         /*
@@ -694,6 +698,8 @@ static void ExecInitNextIndexPartitionForIndexScanOnly(IndexOnlyScanState* node)
         node->ioss_NumOrderByKeys,
         (ScanState*)node);
     GetIndexScanDesc(node->ioss_ScanDesc)->xs_want_itup = true;
+    GetIndexScanDesc(node->ioss_ScanDesc)->xs_skip_scan = ((IndexOnlyScan*)node->ss.ps.plan)->indexskipscan;
+    GetIndexScanDesc(node->ioss_ScanDesc)->xs_nskips = &node->ioss_NumSkips;
     abs_idx_rescan_local(node->ioss_ScanDesc,
         node->ioss_ScanKeys,
         node->ioss_NumScanKeys,
@@ -572,6 +572,9 @@ IndexScanState* ExecInitIndexScan(IndexScan* node, EState* estate, int eflags)
     ExecAssignResultTypeFromTL(&index_state->ss.ps);
     ExecAssignScanProjectionInfo(&index_state->ss);
 
+    /* runtime join filters pushed down by hash joins */
+    ExecScanInitRuntimeFilter(&index_state->ss);
+
     /*
      * If we are just doing EXPLAIN (ie, aren't going to run the plan), stop
      * here.  This allows an index-advisor plugin to EXPLAIN a plan containing
@@ -689,6 +692,14 @@ IndexScanState* ExecInitIndexScan(IndexScan* node, EState* estate, int eflags)
             (ScanState*)index_state);
     }
 
+    /* Let the AM skip over the leading column if the planner chose a skip scan */
+    index_state->iss_NumSkips = 0;
+    if (index_state->iss_ScanDesc != NULL) {
+        IndexScanDesc index_scan = GetIndexScanDesc(index_state->iss_ScanDesc);
+        index_scan->xs_skip_scan = node->indexskipscan;
+        index_scan->xs_nskips = &index_state->iss_NumSkips;
+    }
+
     /*
      * If no run-time keys to calculate, go ahead and pass the scankeys to the
      * index AM.
@@ -1255,6 +1266,8 @@ static void ExecInitNextPartitionForIndexScan(IndexScanState* node)
         node->iss_NumScanKeys,
         node->iss_NumOrderByKeys,
         (ScanState*)node);
+    GetIndexScanDesc(node->iss_ScanDesc)->xs_skip_scan = ((IndexScan*)node->ss.ps.plan)->indexskipscan;
+    GetIndexScanDesc(node->iss_ScanDesc)->xs_nskips = &node->iss_NumSkips;
 
     abs_idx_rescan_local(
         node->iss_ScanDesc, node->iss_ScanKeys, node->iss_NumScanKeys, node->iss_OrderByKeys, node->iss_NumOrderByKeys);
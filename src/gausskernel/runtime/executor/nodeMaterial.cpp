@@ -116,6 +116,10 @@ static TupleTableSlot* ExecMaterialAll(MaterialState* node) /* result tuple from
         node->ss.ps.instrument->sysBusy = tuplestore_get_busy_status(node->tuplestorestate);
         node->ss.ps.instrument->spreadNum = tuplestore_get_spread_num(node->tuplestorestate);
     }
+    if (node->ss.ps.instrument != NULL && node->tuplestorestate != NULL) {
+        tuplestore_get_spill_stats(node->tuplestorestate, &node->ss.ps.instrument->sorthashinfo.spill_rawSize,
+            &node->ss.ps.instrument->sorthashinfo.spill_compressSize);
+    }
     /*
      * If we are done filling tuplestore, start fetching tuples from it.
      */
@@ -228,6 +232,10 @@ static TupleTableSlot* ExecMaterialOne(MaterialState* node) /* result tuple from
                 node->ss.ps.instrument->sysBusy = tuplestore_get_busy_status(node->tuplestorestate);
                 node->ss.ps.instrument->spreadNum = tuplestore_get_spread_num(node->tuplestorestate);
             }
+            if (node->ss.ps.instrument != NULL && node->tuplestorestate != NULL) {
+                tuplestore_get_spill_stats(node->tuplestorestate, &node->ss.ps.instrument->sorthashinfo.spill_rawSize,
+                    &node->ss.ps.instrument->sorthashinfo.spill_compressSize);
+            }
             return NULL;
         }
 
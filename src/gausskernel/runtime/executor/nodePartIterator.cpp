@@ -16,6 +16,12 @@
  *  nodePartIterator.cpp
  *        data partition: routines to support Partition Wise Join
  *
+ *  The partitions left by pruning at plan time are pruned again at run time
+ *  with the quals of the scan that compare the partition key with Params
+ *  (PartIterator->pruningQuals). Quals of bound parameters only are pruned
+ *  with once, at executor start; quals of the outer values of a nestloop are
+ *  pruned with again on each rescan. Pruned partitions are not scanned.
+ *
  * IDENTIFICATION
  *        src/gausskernel/runtime/executor/nodePartIterator.cpp
  *
@@ -25,13 +31,30 @@
 #include "knl/knl_variable.h"
 
 #include "executor/execdebug.h"
+#include "executor/executor.h"
 #include "executor/nodePartIterator.h"
 #include "executor/tuptable.h"
+#include "nodes/makefuncs.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "optimizer/pruning.h"
+#include "optimizer/var.h"
+#include "parser/parsetree.h"
+#include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "nodes/execnodes.h"
 #include "nodes/plannodes.h"
 #include "vecexecutor/vecnodes.h"
 
+static void init_partition_pruning(PartIteratorState* node, PartIterator* pi_node);
+static bool collect_pruning_exprs_walker(Node* node, List** exprs);
+static Node* replace_pruning_exprs_mutator(Node* node, PartIteratorState* node_state);
+static int prune_partitions(PartIteratorState* node);
+
+/* number of partitions to iterate, after run-time pruning */
+#define PartIteratorNumItrs(node, pi_node) \
+    ((node)->selectedItrs != NULL ? (node)->nSelectedItrs : (pi_node)->itrs)
+
 /*
  * @@GaussDB@@
  * Target		: data partition
@@ -55,10 +78,150 @@ PartIteratorState* ExecInitPartIterator(PartIterator* node, EState* estate, int
     state->ps.ps_TupFromTlist = false;
     state->ps.ps_ProjInfo = NULL;
     state->currentItr = -1;
+    state->prunedAtStart = -1;
+
+    if (node->pruningQuals != NIL && IsA(node, PartIterator) && node->itrs > 1)
+        init_partition_pruning(state, node);
 
     return state;
 }
 
+/*
+ * Prepare the run-time pruning of the partitions. The Var-free subexpressions
+ * of the quals are evaluated at each pruning and the quals are handed to the
+ * planner's pruning with their values in place.
+ */
+static void init_partition_pruning(PartIteratorState* node, PartIterator* pi_node)
+{
+    ScanState* scan = (ScanState*)node->ps.lefttree;
+    Relation rel = scan->ss_currentRelation;
+    List* exprs = NIL;
+    ListCell* lc = NULL;
+
+    if (rel == NULL || !RELATION_IS_PARTITIONED(rel) || rel->partMap == NULL || rel->partMap->type != PART_TYPE_RANGE)
+        return;
+
+    (void)collect_pruning_exprs_walker((Node*)pi_node->pruningQuals, &exprs);
+    if (exprs == NIL)
+        return;
+
+    ExecAssignExprContext(node->ps.state, &node->ps);
+    foreach (lc, exprs) {
+        Expr* expr = (Expr*)lfirst(lc);
+
+        node->pruningExprStates = lappend(node->pruningExprStates, ExecInitExpr(expr, &node->ps));
+        if (check_param_clause((Node*)expr))
+            node->pruningOnRescan = true;
+    }
+    node->pruningExprs = exprs;
+    node->pruningCxt = AllocSetContextCreate(CurrentMemoryContext,
+        "PartIteratorPruning",
+        ALLOCSET_SMALL_MINSIZE,
+        ALLOCSET_SMALL_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE);
+    node->selectedItrs = (int*)palloc(pi_node->itrs * sizeof(int));
+
+    /* the values of bound parameters are known already */
+    if (node->pruningOnRescan) {
+        node->pruningPending = true;
+    } else {
+        node->prunedAtStart = prune_partitions(node);
+    }
+}
+
+/*
+ * Collect the largest subexpressions of the quals that hold a Param but no
+ * Var, these are what is not constant at plan time.
+ */
+static bool collect_pruning_exprs_walker(Node* node, List** exprs)
+{
+    if (node == NULL)
+        return false;
+
+    if (!IsA(node, List) && !contain_var_clause(node)) {
+        if (check_param_expr(node))
+            *exprs = lappend(*exprs, node);
+        return false;
+    }
+
+    return expression_tree_walker(node, (bool (*)())collect_pruning_exprs_walker, (void*)exprs);
+}
+
+/*
+ * Replace each collected subexpression with a Const of its current value.
+ */
+static Node* replace_pruning_exprs_mutator(Node* node, PartIteratorState* node_state)
+{
+    ListCell* lc1 = NULL;
+    ListCell* lc2 = NULL;
+
+    if (node == NULL)
+        return NULL;
+
+    forboth(lc1, node_state->pruningExprs, lc2, node_state->pruningExprStates)
+    {
+        if (lfirst(lc1) == (void*)node) {
+            ExprState* exprstate = (ExprState*)lfirst(lc2);
+            Oid typid = exprType(node);
+            int16 typlen;
+            bool typbyval = false;
+            bool isnull = false;
+            Datum value;
+
+            value = ExecEvalExpr(exprstate, node_state->ps.ps_ExprContext, &isnull, NULL);
+            get_typlenbyval(typid, &typlen, &typbyval);
+            if (!isnull && !typbyval)
+                value = datumCopy(value, typbyval, typlen);
+
+            return (Node*)makeConst(typid, exprTypmod(node), exprCollation(node), typlen, value, isnull, typbyval);
+        }
+    }
+
+    return expression_tree_mutator(node, (Node* (*)(Node*, void*))replace_pruning_exprs_mutator, (void*)node_state);
+}
+
+/*
+ * Prune the partitions with the current values of the params, and keep the
+ * iterations of the partitions left. Returns the number of pruned ones.
+ */
+static int prune_partitions(PartIteratorState* node)
+{
+    PartIterator* pi_node = (PartIterator*)node->ps.plan;
+    Scan* scan_plan = (Scan*)pi_node->plan.lefttree;
+    ScanState* scan = (ScanState*)node->ps.lefttree;
+    EState* estate = node->ps.state;
+    MemoryContext oldcxt;
+    List* quals = NIL;
+    Expr* expr = NULL;
+    PruningResult* result = NULL;
+    ListCell* lc = NULL;
+    int itr = 0;
+
+    MemoryContextReset(node->pruningCxt);
+    ResetExprContext(node->ps.ps_ExprContext);
+    oldcxt = MemoryContextSwitchTo(node->pruningCxt);
+
+    quals = (List*)replace_pruning_exprs_mutator((Node*)pi_node->pruningQuals, node);
+    expr = (list_length(quals) == 1) ? (Expr*)linitial(quals) : makeBoolExpr(AND_EXPR, quals, -1);
+    result = partitionPruningForExpr(
+        NULL, rt_fetch(scan_plan->scanrelid, estate->es_range_table), scan->ss_currentRelation, expr);
+
+    node->nSelectedItrs = 0;
+    foreach (lc, scan_plan->pruningInfo->ls_rangeSelectedPartitions) {
+        int partSeq = lfirst_int(lc);
+
+        if (PruningResultIsFull(result) ||
+            (!PruningResultIsEmpty(result) && bms_is_member(partSeq, result->bm_rangeSelectedPartitions)))
+            node->selectedItrs[node->nSelectedItrs++] = itr;
+        itr++;
+    }
+
+    (void)MemoryContextSwitchTo(oldcxt);
+    node->pruningPending = false;
+
+    return pi_node->itrs - node->nSelectedItrs;
+}
+
 static void init_scan_partition(PartIteratorState* node)
 {
     int paramno;
@@ -72,7 +235,9 @@ static void init_scan_partition(PartIteratorState* node)
     node->currentItr++;
     itr_idx = node->currentItr;
     if (BackwardScanDirection == pi_node->direction)
-        itr_idx = pi_node->itrs - itr_idx - 1;
+        itr_idx = PartIteratorNumItrs(node, pi_node) - itr_idx - 1;
+    if (node->selectedItrs != NULL)
+        itr_idx = node->selectedItrs[itr_idx];
 
     paramno = pi_node->param->paramno;
     param = &(node->ps.state->es_param_exec_vals[paramno]);
@@ -105,6 +270,18 @@ TupleTableSlot* ExecPartIterator(PartIteratorState* node)
         return NULL;
     }
 
+    if (node->pruningPending) {
+        int pruned = prune_partitions(node);
+
+        node->numPrunings++;
+        node->numPruned += pruned;
+    }
+
+    if (PartIteratorNumItrs(node, pi_node) == 0) {
+        /* all the partitions are pruned */
+        return NULL;
+    }
+
     /* init first scanned partition */
     if (node->currentItr == -1)
         init_scan_partition(node);
@@ -119,7 +296,7 @@ TupleTableSlot* ExecPartIterator(PartIteratorState* node)
 
     /* switch to next partition until we get a unempty tuple */
     for (;;) {
-        if (node->currentItr + 1 >= pi_node->itrs) /* have scanned all partitions */
+        if (node->currentItr + 1 >= PartIteratorNumItrs(node, pi_node)) /* have scanned all partitions */
             return NULL;
 
         /* switch to next partiiton */
@@ -147,6 +324,11 @@ void ExecEndPartIterator(PartIteratorState* node)
 {
     /* close down subplans */
     ExecEndNode(node->ps.lefttree);
+
+    if (node->pruningCxt != NULL) {
+        MemoryContextDelete(node->pruningCxt);
+        node->pruningCxt = NULL;
+    }
 }
 
 /*
@@ -172,6 +354,10 @@ void ExecReScanPartIterator(PartIteratorState* node)
 
     node->currentItr = -1;
 
+    /* the outer values may have changed, so may the partitions to scan */
+    if (node->pruningOnRescan)
+        node->pruningPending = true;
+
     pi_node = (PartIterator*)node->ps.plan;
     paramno = pi_node->param->paramno;
     param = &(node->ps.state->es_param_exec_vals[paramno]);
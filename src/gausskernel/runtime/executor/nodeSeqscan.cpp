@@ -518,6 +518,9 @@ SeqScanState* ExecInitSeqScan(SeqScan* node, EState* estate, int eflags)
     ExecAssignResultTypeFromTL(&scanstate->ps);
     ExecAssignScanProjectionInfo(scanstate);
 
+    /* runtime join filters pushed down by hash joins */
+    ExecScanInitRuntimeFilter(scanstate);
+
     return scanstate;
 }
 
@@ -157,6 +157,10 @@ TupleTableSlot* ExecSort(SortState* node)
             tuplesort_get_stats(tuple_sortstate, &(plan_state->instrument->sorthashinfo.sortMethodId),
                 &(plan_state->instrument->sorthashinfo.spaceTypeId), &(plan_state->instrument->sorthashinfo.spaceUsed));
         }
+        if (plan_state->instrument != NULL) {
+            tuplesort_get_spill_stats(tuple_sortstate, &(plan_state->instrument->sorthashinfo.spill_rawSize),
+                &(plan_state->instrument->sorthashinfo.spill_compressSize));
+        }
         SO1_printf("ExecSort: %s\n", "sorting done");
         (void)pgstat_report_waitstatus(old_status);
     }
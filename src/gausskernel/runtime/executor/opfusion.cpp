@@ -28,6 +28,7 @@
 
 #include "access/printtup.h"
 #include "access/transam.h"
+#include "catalog/heap.h"
 #include "catalog/pg_aggregate.h"
 #include "commands/copy.h"
 #include "executor/nodeIndexscan.h"
@@ -36,6 +37,7 @@
 #include "libpq/pqformat.h"
 #include "mb/pg_wchar.h"
 #include "nodes/makefuncs.h"
+#include "opfusion/opfusion_scan.h"
 #include "optimizer/clauses.h"
 #include "parser/parsetree.h"
 #include "utils/lsyscache.h"
@@ -1087,6 +1089,8 @@ bool InsertFusion::execute(long max_rows, char* completionTag)
     Relation rel = heap_open(m_reloid, RowExclusiveLock);
     Relation bucket_rel = NULL;
     int2 bucketid = InvalidBktId;
+    Relation part_rel = NULL;
+    Partition partition = NULL;
 
     ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
     InitResultRelInfo(result_rel_info, rel, 1, 0);
@@ -1122,12 +1126,24 @@ bool InsertFusion::execute(long max_rows, char* completionTag)
         ExecConstraints(result_rel_info, m_reslot, m_estate);
     }
 
-    (void)heap_insert(bucket_rel == NULL ? rel : bucket_rel, tuple, mycid, 0, NULL);
+    if (RELATION_IS_PARTITIONED(rel)) {
+        /* get the partition to insert the tuple */
+        searchFakeReationForPartitionOid(m_estate->esfRelations,
+            m_estate->es_query_cxt,
+            rel,
+            heapTupleGetPartitionId(rel, tuple),
+            part_rel,
+            partition,
+            RowExclusiveLock);
+        (void)heap_insert(part_rel, tuple, mycid, 0, NULL);
+    } else {
+        (void)heap_insert(bucket_rel == NULL ? rel : bucket_rel, tuple, mycid, 0, NULL);
+    }
 
     /* insert index entries for tuple */
     List* recheck_indexes = NIL;
     if (result_rel_info->ri_NumIndices > 0) {
-        recheck_indexes = ExecInsertIndexTuples(m_reslot, &(tuple->t_self), m_estate, NULL, NULL, bucketid);
+        recheck_indexes = ExecInsertIndexTuples(m_reslot, &(tuple->t_self), m_estate, part_rel, partition, bucketid);
     }
     list_free_ext(recheck_indexes);
 
@@ -1299,9 +1315,9 @@ UpdateFusion::UpdateFusion(MemoryContext context, CachedPlanSource* psrc, List*
 
     heap_close(rel, AccessShareLock);
 
-    IndexScan* indexscan = (IndexScan*)linitial(node->plans);
-    if (m_is_bucket_rel) {
-        // ctid + tablebucketid
+    IndexScan* indexscan = (IndexScan*)skipPartIterator((Node*)linitial(node->plans));
+    if (m_is_bucket_rel || indexscan->scan.isPartTbl) {
+        // ctid + tablebucketid, or ctid + tableoid
         Assert(RelationGetDescr(rel)->natts + 2 == list_length(indexscan->scan.plan.targetlist));
     } else {
         // ctid
@@ -1325,7 +1341,7 @@ UpdateFusion::UpdateFusion(MemoryContext context, CachedPlanSource* psrc, List*
     FuncExpr* func = NULL;
     Expr* expr = NULL;
     foreach (lc, indexscan->scan.plan.targetlist) {
-        // ignore ctid + tablebucketid or ctid at last
+        // ignore ctid + tablebucketid, ctid + tableoid or ctid at last
         if (i >= RelationGetDescr(rel)->natts) {
             break;
         }
@@ -1420,6 +1436,8 @@ bool UpdateFusion::execute(long max_rows, char* completionTag)
     Relation rel = m_scan->m_rel;
     Relation bucket_rel = NULL;
     int2 bucketid = InvalidBktId;
+    /* the partition holding the scanned tuples of a partitioned table */
+    Relation heap_rel = m_scan->m_partRel == NULL ? rel : m_scan->m_partRel;
 
     ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
     InitResultRelInfo(result_rel_info, rel, 1, 0);
@@ -1464,8 +1482,8 @@ bool UpdateFusion::execute(long max_rows, char* completionTag)
         if (rel->rd_att->constr)
             ExecConstraints(result_rel_info, m_reslot, m_estate);
 
-        result = heap_update(bucket_rel == NULL ? rel : bucket_rel,
-            bucket_rel == NULL ? NULL : rel,
+        result = heap_update(bucket_rel == NULL ? heap_rel : bucket_rel,
+            heap_rel == rel && bucket_rel == NULL ? NULL : rel,
             &oldtup->t_self,
             tup,
             &update_ctid,
@@ -1482,7 +1500,8 @@ bool UpdateFusion::execute(long max_rows, char* completionTag)
                 /* done successfully */
                 nprocessed++;
                 if (result_rel_info->ri_NumIndices > 0 && !HeapTupleIsHeapOnly(tup)) {
-                    recheck_indexes = ExecInsertIndexTuples(m_reslot, &(tup->t_self), m_estate, NULL, NULL, bucketid);
+                    recheck_indexes = ExecInsertIndexTuples(
+                        m_reslot, &(tup->t_self), m_estate, m_scan->m_partRel, m_scan->m_partition, bucketid);
                     list_free_ext(recheck_indexes);
                 }
                 break;
@@ -1498,7 +1517,7 @@ bool UpdateFusion::execute(long max_rows, char* completionTag)
                     Datum* valuesfornew = NULL;
                     HeapTuple copyTuple;
                     copyTuple = EvalPlanQualFetch(m_estate,
-                                                  bucket_rel == NULL ? rel : bucket_rel,
+                                                  bucket_rel == NULL ? heap_rel : bucket_rel,
                                                   LockTupleExclusive,
                                                   &update_ctid,
                                                   update_xmax);
@@ -1606,6 +1625,8 @@ bool DeleteFusion::execute(long max_rows, char* completionTag)
     Relation rel = m_scan->m_rel;
     Relation bucket_rel = NULL;
     int2 bucketid = InvalidBktId;
+    /* the partition holding the scanned tuples of a partitioned table */
+    Relation heap_rel = m_scan->m_partRel == NULL ? rel : m_scan->m_partRel;
 
     ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
     InitResultRelInfo(result_rel_info, rel, 1, 0);
@@ -1640,7 +1661,7 @@ bool DeleteFusion::execute(long max_rows, char* completionTag)
         }
 
     ldelete:
-        result = heap_delete(bucket_rel == NULL ? rel : bucket_rel,
+        result = heap_delete(bucket_rel == NULL ? heap_rel : bucket_rel,
                              &oldtup->t_self,
                              &update_ctid,
                              &update_xmax,
@@ -1669,7 +1690,7 @@ bool DeleteFusion::execute(long max_rows, char* completionTag)
                     HeapTuple copyTuple;
 
                     copyTuple = EvalPlanQualFetch(m_estate,
-                                                  bucket_rel == NULL ? rel : bucket_rel,
+                                                  bucket_rel == NULL ? heap_rel : bucket_rel,
                                                   LockTupleExclusive,
                                                   &update_ctid,
                                                   update_xmax);
@@ -1732,7 +1753,7 @@ SelectForUpdateFusion::SelectForUpdateFusion(
     /* get limit num */
     if (IsA(m_planstmt->planTree, Limit)) {
         Limit* limit = (Limit*)m_planstmt->planTree;
-        node = (IndexScan*)m_planstmt->planTree->lefttree->lefttree;
+        node = (IndexScan*)skipPartIterator((Node*)m_planstmt->planTree->lefttree->lefttree);
         if (limit->limitOffset != NULL && IsA(limit->limitOffset, Const) &&
             !((Const*)limit->limitOffset)->constisnull) {
             m_limitOffset = DatumGetInt64(((Const*)limit->limitOffset)->constvalue);
@@ -1741,7 +1762,7 @@ SelectForUpdateFusion::SelectForUpdateFusion(
             m_limitCount = DatumGetInt64(((Const*)limit->limitCount)->constvalue);
         }
     } else {
-        node = (IndexScan*)m_planstmt->planTree->lefttree;
+        node = (IndexScan*)skipPartIterator((Node*)m_planstmt->planTree->lefttree);
     }
 
     List* targetList = node->scan.plan.targetlist;
@@ -1799,9 +1820,9 @@ bool SelectForUpdateFusion::execute(long max_rows, char* completionTag)
      *******************/
     IndexScan* node = NULL;
     if (m_limitCount >= 0 || m_limitOffset >= 0) {
-        node = (IndexScan*)m_planstmt->planTree->lefttree->lefttree;
+        node = (IndexScan*)skipPartIterator((Node*)m_planstmt->planTree->lefttree->lefttree);
     } else {
-        node = (IndexScan*)m_planstmt->planTree->lefttree;
+        node = (IndexScan*)skipPartIterator((Node*)m_planstmt->planTree->lefttree);
     }
 
     start_row = m_limitOffset >= 0 ? m_limitOffset : start_row;
@@ -1813,6 +1834,8 @@ bool SelectForUpdateFusion::execute(long max_rows, char* completionTag)
     Relation rel = m_scan->m_rel;
     Relation bucket_rel = NULL;
     int2 bucketid = InvalidBktId;
+    /* the partition holding the scanned tuples of a partitioned table */
+    Relation heap_rel = m_scan->m_partRel == NULL ? rel : m_scan->m_partRel;
 
     ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
     InitResultRelInfo(result_rel_info, rel, 1, 0);
@@ -1874,7 +1897,7 @@ bool SelectForUpdateFusion::execute(long max_rows, char* completionTag)
 
             slot_getsomeattrs(m_reslot, m_tupDesc->natts);
 
-            result = heap_lock_tuple(bucket_rel == NULL ? rel : bucket_rel,
+            result = heap_lock_tuple(bucket_rel == NULL ? heap_rel : bucket_rel,
                                      tuple,
                                      &buffer,
                                      &update_ctid,
@@ -1910,7 +1933,7 @@ bool SelectForUpdateFusion::execute(long max_rows, char* completionTag)
                         Datum* valuesfornew = NULL;
                         HeapTuple copyTuple;
                         copyTuple = EvalPlanQualFetch(m_estate,
-                                                      bucket_rel == NULL ? rel : bucket_rel,
+                                                      bucket_rel == NULL ? heap_rel : bucket_rel,
                                                       LockTupleExclusive,
                                                       &update_ctid,
                                                       update_xmax);
@@ -23,14 +23,93 @@
  */
 #include "opfusion/opfusion_scan.h"
 
+#include "access/nbtree.h"
 #include "access/visibilitymap.h"
+#include "catalog/pg_partition_fn.h"
 #include "executor/nodeIndexscan.h"
+#include "nodes/nodeFuncs.h"
 #include "optimizer/clauses.h"
 #include "parser/parsetree.h"
 #include "utils/lsyscache.h"
+#include "utils/partitionmap_gs.h"
 #include "utils/snapmgr.h"
 #include "access/tableam.h"
 
+/*
+ * A partitioned table is scanned by the index scan under a partition iterator,
+ * the bypass executor scans the partition below directly.
+ */
+Node* skipPartIterator(Node* node)
+{
+    if (node != NULL && IsA(node, PartIterator)) {
+        return (Node*)((Plan*)node)->lefttree;
+    }
+    return node;
+}
+
+/*
+ * Find the equality condition of the index qual binding each partition key
+ * column of rel, and save its position in partKeyScanKeys. Returns false if
+ * some column is not bound, or the comparison value is not of the column type.
+ */
+bool getPartKeyScanKeys(Relation rel, Relation index, List* indexqual, int* partKeyScanKeys)
+{
+    int2vector* partKey = ((RangePartitionMap*)rel->partMap)->partitionKey;
+
+    if (index->rd_rel->relam != BTREE_AM_OID) {
+        return false;
+    }
+
+    for (int i = 0; i < partKey->dim1; i++) {
+        AttrNumber attno = partKey->values[i];
+        ListCell* lc = NULL;
+        int keyIdx = 0;
+
+        partKeyScanKeys[i] = -1;
+        foreach (lc, indexqual) {
+            OpExpr* opexpr = (OpExpr*)lfirst(lc);
+            Expr* leftop = NULL;
+            Expr* rightop = NULL;
+            AttrNumber indexcol;
+            Oid opfamily;
+
+            if (!IsA(opexpr, OpExpr) || list_length(opexpr->args) != 2) {
+                keyIdx++;
+                continue;
+            }
+            leftop = (Expr*)linitial(opexpr->args);
+            if (IsA(leftop, RelabelType)) {
+                leftop = ((RelabelType*)leftop)->arg;
+            }
+            rightop = (Expr*)lsecond(opexpr->args);
+            if (IsA(rightop, RelabelType)) {
+                rightop = ((RelabelType*)rightop)->arg;
+            }
+
+            if (!IsA(leftop, Var) || (!IsA(rightop, Param) && !IsA(rightop, Const))) {
+                keyIdx++;
+                continue;
+            }
+
+            indexcol = ((Var*)leftop)->varattno;
+            opfamily = index->rd_opfamily[indexcol - 1];
+            if (index->rd_index->indkey.values[indexcol - 1] == attno &&
+                get_op_opfamily_strategy(opexpr->opno, opfamily) == BTEqualStrategyNumber &&
+                exprType((Node*)rightop) == rel->rd_att->attrs[attno - 1]->atttypid) {
+                partKeyScanKeys[i] = keyIdx;
+                break;
+            }
+            keyIdx++;
+        }
+
+        if (partKeyScanKeys[i] < 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 ScanFusion::ScanFusion(ParamListInfo params, PlannedStmt* planstmt)
 {
     m_params = params;
@@ -39,12 +118,15 @@ ScanFusion::ScanFusion(ParamListInfo params, PlannedStmt* planstmt)
     m_tupDesc = NULL;
     m_reslot = NULL;    
     m_direction = NULL;
+    m_partition = NULL;
+    m_partRel = NULL;
 };
 
 ScanFusion* ScanFusion::getScanFusion(Node* node, PlannedStmt* planstmt, ParamListInfo params)
 {
     ScanFusion* scan = NULL;
 
+    node = skipPartIterator(node);
     switch (nodeTag(node)) {
         case T_IndexScan:
             scan = New(CurrentMemoryContext) IndexScanFusion((IndexScan*)node, planstmt, params);
@@ -88,6 +170,126 @@ IndexFusion::IndexFusion(ParamListInfo params, PlannedStmt* planstmt) : ScanFusi
     m_scanKeys = NULL;
     m_index = NULL;
     m_keyInit = false;
+    m_isPartTbl = false;
+    m_partLockMode = AccessShareLock;
+    m_pruningInfo = NULL;
+    m_partKeyNum = 0;
+    m_partKeyScanKeys = NULL;
+    m_partNum = 0;
+    m_partIndexOids = NULL;
+    m_indexPartition = NULL;
+    m_partIndex = NULL;
+}
+
+/*
+ * Prepare the partition routing of a scan on a partitioned table, called from
+ * the constructors with the index of the scan to decide the partition key
+ * scan keys.
+ */
+void IndexFusion::InitPartitionInfo(Scan* scan)
+{
+    m_isPartTbl = scan->isPartTbl;
+    if (!m_isPartTbl) {
+        return;
+    }
+
+    m_partLockMode = list_member_int(m_planstmt->resultRelations, scan->scanrelid) ? RowExclusiveLock
+                                                                                     : AccessShareLock;
+    m_pruningInfo = scan->pruningInfo;
+
+    Relation rel = heap_open(m_reloid, AccessShareLock);
+    Relation index = index_open(IsA(scan, IndexScan) ? ((IndexScan*)scan)->indexid : ((IndexOnlyScan*)scan)->indexid,
+        AccessShareLock);
+    List* indexqual = IsA(scan, IndexScan) ? ((IndexScan*)scan)->indexqual : ((IndexOnlyScan*)scan)->indexqual;
+
+    m_partKeyNum = ((RangePartitionMap*)rel->partMap)->partitionKey->dim1;
+    m_partKeyScanKeys = (int*)palloc(m_partKeyNum * sizeof(int));
+    if (!getPartKeyScanKeys(rel, index, indexqual, m_partKeyScanKeys)) {
+        ereport(ERROR,
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                errmsg("partition key of \"%s\" is not bound for bypass", RelationGetRelationName(rel))));
+    }
+
+    m_partNum = getNumberOfRangePartitions(rel);
+    m_partIndexOids = (Oid*)palloc0(m_partNum * sizeof(Oid));
+
+    index_close(index, AccessShareLock);
+    heap_close(rel, AccessShareLock);
+}
+
+/*
+ * Route the values of the partition key scan keys to the partition holding
+ * them, and open it with its index partition. Returns false if there is no
+ * such partition, so nothing can be found.
+ */
+bool IndexFusion::OpenPartition()
+{
+    Const consts[RANGE_PARTKEYMAXNUM];
+    Const* values[RANGE_PARTKEYMAXNUM];
+    PartitionIdentifier partId;
+    Relation rel = m_rel;
+    int2vector* partKey = ((RangePartitionMap*)rel->partMap)->partitionKey;
+
+    for (int i = 0; i < m_partKeyNum; i++) {
+        ScanKey key = &m_scanKeys[m_partKeyScanKeys[i]];
+
+        /* "key = NULL" is never true */
+        if (key->sk_flags & SK_ISNULL) {
+            return false;
+        }
+        values[i] = transformDatum2Const(rel->rd_att, partKey->values[i], key->sk_argument, false, &consts[i]);
+    }
+
+    partitionRoutingForValue(rel, values, m_partKeyNum, true, true, &partId);
+    if (!OidIsValid(partId.partitionId) || partId.partSeq < 0 || partId.partSeq >= m_partNum) {
+        return false;
+    }
+
+    /* partitions pruned by the planner hold no matching row */
+    if (m_pruningInfo == NULL || m_pruningInfo->state == PRUNING_RESULT_EMPTY ||
+        (m_pruningInfo->state == PRUNING_RESULT_SUBSET &&
+            !bms_is_member(partId.partSeq, m_pruningInfo->bm_rangeSelectedPartitions))) {
+        return false;
+    }
+
+    m_partition = partitionOpen(rel, partId.partitionId, m_partLockMode);
+    m_partRel = partitionGetRelation(rel, m_partition);
+
+    if (!OidIsValid(m_partIndexOids[partId.partSeq])) {
+        List* partIndexOids = PartitionGetPartIndexList(m_partition);
+        if (!PointerIsValid(partIndexOids)) {
+            ereport(ERROR,
+                (errcode(ERRCODE_WRONG_OBJECT_TYPE),
+                    errmsg("no local indexes found for partition %s", PartitionGetPartitionName(m_partition))));
+        }
+        m_partIndexOids[partId.partSeq] = searchPartitionIndexOid(RelationGetRelid(m_index), partIndexOids);
+        list_free_ext(partIndexOids);
+    }
+
+    m_indexPartition = partitionOpen(m_index, m_partIndexOids[partId.partSeq], m_partLockMode);
+    if (!m_indexPartition->pd_part->indisusable) {
+        ereport(ERROR,
+            (errcode(ERRCODE_INDEX_CORRUPTED),
+                errmsg("can't initialize index scans using unusable local index \"%s\"",
+                    PartitionGetPartitionName(m_indexPartition))));
+    }
+    m_partIndex = partitionGetRelation(m_index, m_indexPartition);
+
+    return true;
+}
+
+void IndexFusion::ClosePartition()
+{
+    if (m_partIndex != NULL) {
+        releaseDummyRelation(&m_partIndex);
+        partitionClose(m_index, m_indexPartition, NoLock);
+        m_indexPartition = NULL;
+    }
+    if (m_partRel != NULL) {
+        releaseDummyRelation(&m_partRel);
+        partitionClose(m_rel, m_partition, NoLock);
+        m_partition = NULL;
+    }
 }
 
 void IndexFusion::refreshParameterIfNecessary()
@@ -375,6 +577,7 @@ IndexScanFusion::IndexScanFusion(IndexScan* node, PlannedStmt* planstmt, ParamLi
     m_tmpisnull = (bool*)palloc(m_tupDesc->natts * sizeof(bool));
     setAttrNo();
     heap_close(m_rel, AccessShareLock);
+    InitPartitionInfo(&node->scan);
 }
 
 void IndexScanFusion::Init(long max_rows)
@@ -400,17 +603,26 @@ void IndexScanFusion::Init(long max_rows)
     }
 
     m_rel = heap_open(m_reloid, AccessShareLock);
+    m_epq_indexqual = m_node->indexqualorig;
+    m_reslot = MakeSingleTupleTableSlot(m_tupDesc);
+    m_scandesc = NULL;
+    if (m_isPartTbl && !OpenPartition()) {
+        return;
+    }
+
     ScanState* scanstate = makeNode(ScanState); // need release
     scanstate->ps.plan =  (Plan *)m_node;
-    m_scandesc = (AbsIdxScanDesc)abs_idx_beginscan(m_rel, m_index, GetActiveSnapshot(), m_keyNum, 0, scanstate); // add scanstate pointer ?
+    m_scandesc = (AbsIdxScanDesc)abs_idx_beginscan(m_isPartTbl ? m_partRel : m_rel,
+        m_isPartTbl ? m_partIndex : m_index, GetActiveSnapshot(), m_keyNum, 0, scanstate); // add scanstate pointer ?
     
     abs_idx_rescan_local(m_scandesc, m_keyNum > 0 ? m_scanKeys : NULL, m_keyNum, NULL, 0);
-    m_epq_indexqual = m_node->indexqualorig;
-    m_reslot = MakeSingleTupleTableSlot(m_tupDesc);
 }
 
 HeapTuple IndexScanFusion::getTuple()
 {
+    if (m_scandesc == NULL) {
+        return NULL;
+    }
     return abs_idx_getnext(m_scandesc, *m_direction);
 }
 
@@ -460,7 +672,9 @@ void IndexScanFusion::End(bool isCompleted)
     }
     if (m_scandesc != NULL) {
         abs_idx_endscan(m_scandesc);
+        m_scandesc = NULL;
     }
+    ClosePartition();
     if (m_index != NULL) {
         index_close(m_index, NoLock);
     }
@@ -535,6 +749,7 @@ IndexOnlyScanFusion::IndexOnlyScanFusion(IndexOnlyScan* node, PlannedStmt* plans
     m_tmpisnull = (bool*)palloc(m_tupDesc->natts * sizeof(bool));
     setAttrNo();
     index_close(m_index, AccessShareLock);
+    InitPartitionInfo(&node->scan);
 }
 
 void IndexOnlyScanFusion::Init(long max_rows)
@@ -560,10 +775,17 @@ void IndexOnlyScanFusion::Init(long max_rows)
     }
 
     m_rel = heap_open(m_reloid, AccessShareLock);
+    m_epq_indexqual = m_node->indexqual;
+    m_scandesc = NULL;
+    if (m_isPartTbl && !OpenPartition()) {
+        return;
+    }
+
     ScanState* scanstate = makeNode(ScanState); // need release
     scanstate->ps.plan =  (Plan *)m_node;
 
-    m_scandesc = (AbsIdxScanDesc)abs_idx_beginscan(m_rel, m_index, GetActiveSnapshot(), m_keyNum, 0, scanstate); // add scanstate pointer ?
+    m_scandesc = (AbsIdxScanDesc)abs_idx_beginscan(m_isPartTbl ? m_partRel : m_rel,
+        m_isPartTbl ? m_partIndex : m_index, GetActiveSnapshot(), m_keyNum, 0, scanstate); // add scanstate pointer ?
 
     if (PointerIsValid(m_scandesc)) {
         if (m_VMBuffer != InvalidBuffer) {
@@ -575,8 +797,6 @@ void IndexOnlyScanFusion::Init(long max_rows)
     }
 
     abs_idx_rescan_local(m_scandesc, m_keyNum > 0 ? m_scanKeys : NULL, m_keyNum, NULL, 0);
-
-    m_epq_indexqual = m_node->indexqual;
 }
 
 HeapTuple IndexOnlyScanFusion::getTuple()
@@ -594,6 +814,9 @@ TupleTableSlot* IndexOnlyScanFusion::getTupleSlot()
 {
     ItemPointer tid;
     Relation rel = m_index;
+    if (m_scandesc == NULL) {
+        return NULL;
+    }
     while ((tid = abs_idx_getnext_tid(m_scandesc, *m_direction)) != NULL) {
         HeapTuple tuple = NULL;
         IndexScanDesc indexdesc = GetIndexScanDesc(m_scandesc);
@@ -645,7 +868,9 @@ void IndexOnlyScanFusion::End(bool isCompleted)
         return;
     if (m_scandesc != NULL) {
         abs_idx_endscan(m_scandesc);
+        m_scandesc = NULL;
     }
+    ClosePartition();
     if (m_index != NULL) {
         index_close(m_index, AccessShareLock);
     }
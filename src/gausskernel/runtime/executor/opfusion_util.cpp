@@ -33,10 +33,12 @@
 #include "libpq/pqformat.h"
 #include "mb/pg_wchar.h"
 #include "nodes/makefuncs.h"
+#include "opfusion/opfusion_scan.h"
 #include "optimizer/clauses.h"
 #include "parser/parsetree.h"
 #include "utils/dynahash.h"
 #include "utils/lsyscache.h"
+#include "utils/partitionmap.h"
 #include "utils/snapmgr.h"
 #include "parser/parse_coerce.h"
 
@@ -208,6 +210,11 @@ const char *getBypassReason(FusionType result)
             break;
         }
 
+        case NOBYPASS_PARTITION_NOT_SUPPORT: {
+            return "Bypass not executed because the partition to scan can't be decided by the index conditions";
+            break;
+        }
+
         default: {
             Assert(0);
             ereport(ERROR,
@@ -543,6 +550,46 @@ template <bool is_dml, bool isonlyindex> FusionType checkFusionIndexScan(Node *n
     return BYPASS_OK;
 }
 
+/*
+ * Partitioned tables bypass only if the range partition map is fixed, and
+ * every partition key column is bound by an equality index condition, so the
+ * partition is routed from the scan keys at execute time.
+ */
+static bool isFusionPartitionedRelation(Relation rel)
+{
+    return RelationIsPartitioned(rel) && !RELATION_HAS_BUCKET(rel) && rel->partMap != NULL &&
+           PartitionMapIsRange(rel->partMap);
+}
+
+static FusionType checkFusionPartitionScan(Plan *plan, PlannedStmt *plannedstmt)
+{
+    Scan *scan = (Scan *)plan;
+    Oid indexid = IsA(plan, IndexScan) ? ((IndexScan *)plan)->indexid : ((IndexOnlyScan *)plan)->indexid;
+    List *indexqual = IsA(plan, IndexScan) ? ((IndexScan *)plan)->indexqual : ((IndexOnlyScan *)plan)->indexqual;
+    FusionType ftype = BYPASS_OK;
+
+    if (scan->itrs <= 0 || scan->pruningInfo == NULL) {
+        return NOBYPASS_PARTITION_NOT_SUPPORT;
+    }
+
+    Relation rel = heap_open(getrelid(scan->scanrelid, plannedstmt->rtable), AccessShareLock);
+    if (!isFusionPartitionedRelation(rel)) {
+        heap_close(rel, AccessShareLock);
+        return NOBYPASS_PARTITION_NOT_SUPPORT;
+    }
+
+    Relation index = index_open(indexid, AccessShareLock);
+    int *partKeyScanKeys = (int *)palloc(((RangePartitionMap *)rel->partMap)->partitionKey->dim1 * sizeof(int));
+    if (!getPartKeyScanKeys(rel, index, indexqual, partKeyScanKeys)) {
+        ftype = NOBYPASS_PARTITION_NOT_SUPPORT;
+    }
+    pfree_ext(partKeyScanKeys);
+    index_close(index, AccessShareLock);
+    heap_close(rel, AccessShareLock);
+
+    return ftype;
+}
+
 FusionType checkFusionNestLoop(NestLoop *node, ParamListInfo params)
 {
     Join     *joinNode = &node->join;
@@ -690,6 +737,7 @@ FusionType getSelectFusionType(List *stmt_list, ParamListInfo params)
 #endif
 
     /* check for indexscan or indexonlyscan */
+    top_plan = (Plan *)skipPartIterator((Node *)top_plan);
     if ((IsA(top_plan, IndexScan) || IsA(top_plan, IndexOnlyScan)) && top_plan->lefttree == NULL) {
         FusionType ttype;
         if (IsA(top_plan, IndexScan)) {
@@ -701,6 +749,14 @@ FusionType getSelectFusionType(List *stmt_list, ParamListInfo params)
         if (ttype > BYPASS_OK) {
             return ttype;
         }
+
+        /* check partitioned table */
+        if (((Scan *)top_plan)->isPartTbl) {
+            ttype = checkFusionPartitionScan(top_plan, (PlannedStmt *)linitial(stmt_list));
+            if (ttype > BYPASS_OK) {
+                return ttype;
+            }
+        }
     } else {
         return NOBYPASS_NO_INDEXSCAN;
     }
@@ -724,8 +780,9 @@ FusionType checkTargetlist(List *targetList, FusionType ftype)
 bool checkDMLRelation(Relation rel, PlannedStmt *plannedstmt)
 {
     if (rel->rd_rel->relkind != RELKIND_RELATION || rel->rd_rel->relhasrules || rel->rd_rel->relhastriggers ||
-        rel->rd_rel->relhasoids || rel->rd_rel->relhassubclass || RelationIsPartitioned(rel) ||
-        RelationIsColStore(rel) || RelationInRedistribute(rel) || plannedstmt->hasReturning) {
+        rel->rd_rel->relhasoids || rel->rd_rel->relhassubclass ||
+        (RelationIsPartitioned(rel) && !isFusionPartitionedRelation(rel)) || RelationIsColStore(rel) ||
+        RelationInRedistribute(rel) || plannedstmt->hasReturning) {
         return true;
     }
     return false;
@@ -822,12 +879,13 @@ FusionType getUpdateFusionType(List *stmt_list, ParamListInfo params)
         return NOBYPASS_NO_SIMPLE_PLAN;
     }
 
-    if (!IsA(linitial(node->plans), IndexScan)) {
+    Node *scan = skipPartIterator((Node *)linitial(node->plans));
+    if (!IsA(scan, IndexScan)) {
         return NOBYPASS_NO_INDEXSCAN;
     }
 
     /* check index scan */
-    FusionType ttype = checkFusionIndexScan<true, false>((Node *)linitial(node->plans), params);
+    FusionType ttype = checkFusionIndexScan<true, false>(scan, params);
     /* check failed */
     if (ttype > BYPASS_OK) {
         return ttype;
@@ -841,11 +899,29 @@ FusionType getUpdateFusionType(List *stmt_list, ParamListInfo params)
         heap_close(rel, AccessShareLock);
         return NOBYPASS_DML_RELATION_NOT_SUPPORT;
     }
+
+    IndexScan *indexscan = (IndexScan *)scan;
+    List *targetlist = indexscan->scan.plan.targetlist;
+    if (RelationIsPartitioned(rel)) {
+        ttype = checkFusionPartitionScan((Plan *)indexscan, plannedstmt);
+        if (ttype > BYPASS_OK) {
+            heap_close(rel, AccessShareLock);
+            return ttype;
+        }
+
+        /* the new tuple must stay in the partition of the old one */
+        int2vector *partKey = ((RangePartitionMap *)rel->partMap)->partitionKey;
+        for (int i = 0; i < partKey->dim1; i++) {
+            TargetEntry *tle = (TargetEntry *)list_nth(targetlist, partKey->values[i] - 1);
+            if (!IsA(tle->expr, Var) || ((Var *)tle->expr)->varattno != partKey->values[i]) {
+                heap_close(rel, AccessShareLock);
+                return NOBYPASS_PARTITION_NOT_SUPPORT;
+            }
+        }
+    }
     heap_close(rel, AccessShareLock);
 
     /* check target list */
-    IndexScan *indexscan = (IndexScan *)linitial(node->plans);
-    List *targetlist = indexscan->scan.plan.targetlist;
     return checkTargetlist(targetlist, ftype);
 }
 
@@ -870,11 +946,12 @@ FusionType getDeleteFusionType(List *stmt_list, ParamListInfo params)
         return NOBYPASS_NO_SIMPLE_PLAN;
     }
 
-    if (!IsA(linitial(node->plans), IndexScan)) {
+    Node *scan = skipPartIterator((Node *)linitial(node->plans));
+    if (!IsA(scan, IndexScan)) {
         return NOBYPASS_NO_INDEXSCAN;
     }
     /* check index scan */
-    FusionType ttype = checkFusionIndexScan<true, false>((Node *)linitial(node->plans), params);
+    FusionType ttype = checkFusionIndexScan<true, false>(scan, params);
     /* check failed */
     if (ttype > BYPASS_OK) {
         return ttype;
@@ -888,6 +965,13 @@ FusionType getDeleteFusionType(List *stmt_list, ParamListInfo params)
         heap_close(rel, AccessShareLock);
         return NOBYPASS_DML_RELATION_NOT_SUPPORT;
     }
+    if (RelationIsPartitioned(rel)) {
+        ttype = checkFusionPartitionScan((Plan *)scan, plannedstmt);
+        if (ttype > BYPASS_OK) {
+            heap_close(rel, AccessShareLock);
+            return ttype;
+        }
+    }
     heap_close(rel, AccessShareLock);
 
     return ftype;
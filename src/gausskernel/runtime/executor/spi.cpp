@@ -25,8 +25,10 @@
 #include "executor/executor.h"
 #include "executor/spi_priv.h"
 #include "miscadmin.h"
+#include "parser/analyze.h"
 #include "parser/parser.h"
 #include "pgxc/pgxc.h"
+#include "storage/mot/jit_exec.h"
 #include "tcop/pquery.h"
 #include "tcop/utility.h"
 #include "utils/builtins.h"
@@ -60,6 +62,8 @@ static ParamListInfo _SPI_convert_params(int nargs, Oid *argtypes, Datum *Values
     Cursor_Data *cursor_data = NULL);
 
 static int _SPI_pquery(QueryDesc *queryDesc, bool fire_triggers, long tcount, bool from_lock = false);
+static void _SPI_prepare_mot_jit(CachedPlanSource *plansource);
+static void _SPI_fetch_mot_jit_params(ParamListInfo paramLI);
 
 static void _SPI_error_callback(void *arg);
 
@@ -616,6 +620,7 @@ int SPI_keepplan(SPIPlanPtr plan)
         CachedPlanSource *plansource = (CachedPlanSource *)lfirst(lc);
 
         SaveCachedPlan(plansource);
+        _SPI_prepare_mot_jit(plansource);
     }
 
     return 0;
@@ -1951,9 +1956,16 @@ static int _SPI_execute_plan(SPIPlanPtr plan, ParamListInfo paramLI, Snapshot sn
          * Replan if needed, and increment plan refcount.  If it's a saved
          * plan, the refcount must be backed by the CurrentResourceOwner.
          */
+        bool hadMotJit = (plansource->mot_jit_context != NULL);
         cplan = GetCachedPlan(plansource, paramLI, plan->saved);
         stmt_list = cplan->stmt_list;
 
+        /* revalidation throws away the MOT jitted code, generate it again for the new query tree */
+        if (hadMotJit && plansource->mot_jit_context == NULL) {
+            _SPI_prepare_mot_jit(plansource);
+            cplan->mot_jit_context = plansource->mot_jit_context;
+        }
+
         /*
          * In the default non-read-only case, get a new snapshot, replacing
          * any that we pushed in a previous cycle.
@@ -2021,8 +2033,21 @@ static int _SPI_execute_plan(SPIPlanPtr plan, ParamListInfo paramLI, Snapshot sn
                     snap = InvalidSnapshot;
                 }
 
+                /*
+                 * A jitted MOT statement still goes through executor startup,
+                 * so permissions, triggers and the result counts are handled
+                 * as usual, but ExecutePlan runs the jitted code instead of
+                 * the plan.
+                 */
+                JitExec::JitContext *motJitContext = NULL;
+                if (cplan->mot_jit_context != NULL && list_length(stmt_list) == 1 && JitExec::IsMotCodegenEnabled()) {
+                    motJitContext = cplan->mot_jit_context;
+                    _SPI_fetch_mot_jit_params(paramLI);
+                }
+
                 qdesc = CreateQueryDesc((PlannedStmt *)stmt, plansource->query_string, snap, crosscheck_snapshot, dest,
                     paramLI, 0);
+                qdesc->mot_jit_context = motJitContext;
                 res = _SPI_pquery(qdesc, fire_triggers, canSetTag ? tcount : 0, from_lock);
                 FreeQueryDesc(qdesc);
             } else {
@@ -2352,6 +2377,65 @@ static int _SPI_pquery(QueryDesc *queryDesc, bool fire_triggers, long tcount, bo
     return res;
 }
 
+/*
+ * _SPI_prepare_mot_jit: generate MOT jitted code for a saved plan
+ *
+ * Only single queries accessing MOT tables alone are jitted, the same as for
+ * prepared statements. The JIT context lives as long as the plan source.
+ */
+static void _SPI_prepare_mot_jit(CachedPlanSource *plansource)
+{
+    if (IS_PGXC_COORDINATOR || !JitExec::IsMotCodegenEnabled() || !JitExec::IsMotProcedureCodegenEnabled()) {
+        return;
+    }
+
+    if (plansource->mot_jit_context != NULL || list_length(plansource->query_list) != 1) {
+        return;
+    }
+
+    Query *query = (Query *)linitial(plansource->query_list);
+    if (query->commandType == CMD_UTILITY || query->returningList != NIL) {
+        return;
+    }
+
+    StorageEngineType storageEngineType = SE_TYPE_UNSPECIFIED;
+    CheckTablesStorageEngine(query, &storageEngineType);
+    if (storageEngineType != SE_TYPE_MM) {
+        return;
+    }
+
+    if (JitExec::IsMotCodegenPrintEnabled()) {
+        elog(LOG, "Attempting to generate MOT jitted code for procedure query: %s\n", plansource->query_string);
+    }
+
+    JitExec::JitPlan *jitPlan = JitExec::IsJittable(query, plansource->query_string);
+    if (jitPlan != NULL) {
+        plansource->mot_jit_context = JitExec::JitCodegenQuery(query, plansource->query_string, jitPlan);
+        if ((plansource->mot_jit_context == NULL) && JitExec::IsMotCodegenPrintEnabled()) {
+            elog(LOG, "Failed to generate jitted MOT function for procedure query %s\n", plansource->query_string);
+        }
+    }
+}
+
+/*
+ * _SPI_fetch_mot_jit_params: instantiate the parameters fetched on demand
+ *
+ * The jitted code reads the parameter array directly, it does not go through
+ * the paramFetch hook the way the executor does.
+ */
+static void _SPI_fetch_mot_jit_params(ParamListInfo paramLI)
+{
+    if (paramLI == NULL || paramLI->paramFetch == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < paramLI->numParams; i++) {
+        if (!OidIsValid(paramLI->params[i].ptype)) {
+            (*paramLI->paramFetch)(paramLI, i + 1);
+        }
+    }
+}
+
 /*
  * _SPI_error_callback
  *
@@ -38,6 +38,7 @@
 #include "executor/nodeAppend.h"
 #include "vecexecutor/vecwindowagg.h"
 #include "vecexecutor/vecexecutor.h"
+#include "vectorsonic/vsonicwindowagg.h"
 #include "catalog/pg_aggregate.h"
 #include "catalog/pg_proc.h"
 #include "catalog/pg_type.h"
@@ -306,8 +307,17 @@ VecWindowAggState* ExecInitVecWindowAgg(VecWindowAgg* node, EState* estate, int
  */
 const VectorBatch* ExecVecWindowAgg(VecWindowAggState* node)
 {
-    if (node->VecWinAggRuntime == NULL)
-        node->VecWinAggRuntime = New(CurrentMemoryContext) VecWinAggRuntime(node);
+    bool is_sonic = ((WindowAgg*)node->ss.ps.plan)->is_sonicwindow;
+
+    if (node->VecWinAggRuntime == NULL) {
+        if (is_sonic)
+            node->VecWinAggRuntime = New(CurrentMemoryContext) SonicWindowAgg(node);
+        else
+            node->VecWinAggRuntime = New(CurrentMemoryContext) VecWinAggRuntime(node);
+    }
+
+    if (is_sonic)
+        return ((SonicWindowAgg*)node->VecWinAggRuntime)->getBatch();
 
     return ((VecWinAggRuntime*)node->VecWinAggRuntime)->getBatch();
 }
@@ -324,6 +334,14 @@ void ExecEndVecWindowAgg(VecWindowAggState* node)
     // Nothing special to handle, so reuse append code
     PlanState* outer_plan = NULL;
 
+    if (((WindowAgg*)node->ss.ps.plan)->is_sonicwindow) {
+        SonicWindowAgg* sonicwindowrun = (SonicWindowAgg*)node->VecWinAggRuntime;
+        if (sonicwindowrun != NULL) {
+            sonicwindowrun->freeResources();
+            node->VecWinAggRuntime = NULL;
+        }
+    }
+
     VecWinAggRuntime* vecwindowrun = (VecWinAggRuntime*)node->VecWinAggRuntime;
     /*
      * clear batchstore tuple.
@@ -414,10 +432,15 @@ void VecWinAggRuntime::ResetNecessary()
  */
 void ExecReScanVecWindowAgg(VecWindowAggState* node)
 {
-    VecWinAggRuntime* tb = (VecWinAggRuntime*)node->VecWinAggRuntime;
-
-    if (tb != NULL) {
-        tb->ResetNecessary();
+    if (((WindowAgg*)node->ss.ps.plan)->is_sonicwindow) {
+        SonicWindowAgg* sonicwindowrun = (SonicWindowAgg*)node->VecWinAggRuntime;
+        if (sonicwindowrun != NULL)
+            sonicwindowrun->ResetNecessary();
+    } else {
+        VecWinAggRuntime* tb = (VecWinAggRuntime*)node->VecWinAggRuntime;
+        if (tb != NULL) {
+            tb->ResetNecessary();
+        }
     }
 
     /*
@@ -0,0 +1,1036 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * vsonicwindowagg.cpp
+ *     Routines to handle vector sonic window agg nodes.
+ *
+ * Sonic window agg works on the sorted output of its child batch by batch.
+ * Partition and peer group boundaries are marked for the whole batch at once,
+ * ranking functions and aggregates over ROWS frames are row-final, and the
+ * ROWS n PRECEDING frame removes the leaving row instead of recomputing the
+ * frame. Aggregates over the default RANGE frame are only known at the end of
+ * the peer group, so the rows of the unfinished peer group are kept in sonic
+ * datum arrays, and spilled through SonicHashFilePartition when they exceed
+ * the work memory.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/runtime/vecexecutor/vectorsonic/vsonicwindowagg.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "catalog/pg_aggregate.h"
+#include "catalog/pg_proc.h"
+#include "catalog/pg_type.h"
+#include "executor/executor.h"
+#include "nodes/nodeFuncs.h"
+#include "pgstat.h"
+#include "utils/date.h"
+#include "utils/memutils.h"
+#include "utils/nabstime.h"
+#include "utils/timestamp.h"
+#include "vecexecutor/vecexecutor.h"
+#include "vecexecutor/vecexpression.h"
+#include "vectorsonic/vsonicint.h"
+#include "vectorsonic/vsonicencodingchar.h"
+#include "vectorsonic/vsonicwindowagg.h"
+
+static bool sonic_window_func_walker(Node* node, void* context);
+static void replace_window_eqfunc(FmgrInfo* eqfunctions, int nkeys, const int* keyIdx, VectorBatch* batch);
+
+/*
+ * @Description	: Check whether the frame can be evaluated by sonic window agg.
+ *				  Only the frames ending at the current row are supported: the default
+ *				  RANGE UNBOUNDED PRECEDING frame, ROWS UNBOUNDED PRECEDING and ROWS n
+ *				  PRECEDING with a constant n.
+ * @in frameOptions	: frame options of the window clause.
+ * @in startOffset	: start offset expression of the frame.
+ * @return		: true if supported.
+ */
+bool isSonicWindowFrameSupported(int frameOptions, Node* startOffset)
+{
+    int options = frameOptions & ~(FRAMEOPTION_NONDEFAULT | FRAMEOPTION_BETWEEN);
+
+    if (options == (FRAMEOPTION_RANGE | FRAMEOPTION_START_UNBOUNDED_PRECEDING | FRAMEOPTION_END_CURRENT_ROW))
+        return true;
+
+    if (options == (FRAMEOPTION_ROWS | FRAMEOPTION_START_UNBOUNDED_PRECEDING | FRAMEOPTION_END_CURRENT_ROW))
+        return true;
+
+    if (options == (FRAMEOPTION_ROWS | FRAMEOPTION_START_VALUE_PRECEDING | FRAMEOPTION_END_CURRENT_ROW)) {
+        /* the removable frame ring is sized at init time, so the offset must be a constant */
+        if (startOffset == NULL || !IsA(startOffset, Const))
+            return false;
+
+        Const* offset = (Const*)startOffset;
+        if (offset->constisnull || offset->consttype != INT8OID)
+            return false;
+
+        int64 rows = DatumGetInt64(offset->constvalue);
+        return rows >= 0 && rows < SONIC_WIN_MAX_FRAME_ROWS;
+    }
+
+    return false;
+}
+
+/*
+ * @Description	: Check whether the window agg can be done by sonic window agg.
+ * @in node		: the window agg plan node.
+ * @return		: true if all window functions and the frame are supported.
+ */
+bool isSonicWindowAggEnable(WindowAgg* node)
+{
+    if (!u_sess->attr.attr_sql.enable_sonic_windowagg)
+        return false;
+
+    if (!isSonicWindowFrameSupported(node->frameOptions, node->startOffset))
+        return false;
+
+    return !sonic_window_func_walker((Node*)node->plan.targetlist, NULL);
+}
+
+/*
+ * @Description	: Return true if there is a window function not supported by sonic window agg.
+ */
+static bool sonic_window_func_walker(Node* node, void* context)
+{
+    if (node == NULL)
+        return false;
+
+    if (IsA(node, WindowFunc)) {
+        WindowFunc* wfunc = (WindowFunc*)node;
+
+        switch (wfunc->winfnoid) {
+            case ROWNUMBERFUNCOID:
+            case RANKFUNCOID:
+            case DENSERANKFUNCOID:
+            case ANYCOUNTOID:
+            case COUNTOID:
+            case INT2SUMFUNCOID:
+            case INT4SUMFUNCOID:
+            case INT8SUMFUNCOID:
+                /* window functions can not be nested, so no need to check the arguments */
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    return expression_tree_walker(node, (bool (*)())sonic_window_func_walker, context);
+}
+
+/*
+ * @Description	: Replace equal functions of the key columns whose values are stored with header.
+ */
+static void replace_window_eqfunc(FmgrInfo* eqfunctions, int nkeys, const int* keyIdx, VectorBatch* batch)
+{
+    for (int i = 0; i < nkeys; i++) {
+        switch (batch->m_arr[keyIdx[i]].m_desc.typeId) {
+            case TIMETZOID:
+                eqfunctions[i].fn_addr = timetz_eq_withhead;
+                break;
+            case TINTERVALOID:
+                eqfunctions[i].fn_addr = tintervaleq_withhead;
+                break;
+            case INTERVALOID:
+                eqfunctions[i].fn_addr = interval_eq_withhead;
+                break;
+            case NAMEOID:
+                eqfunctions[i].fn_addr = nameeq_withhead;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/*
+ * @Description	: Constructed function of sonic window agg.
+ * @in runtime	: Vector window agg state.
+ */
+SonicWindowAgg::SonicWindowAgg(VecWindowAggState* runtime) : SonicHash(INIT_DATUM_ARRAY_SIZE), m_runtime(runtime)
+{
+    WindowAgg* node = (WindowAgg*)runtime->ss.ps.plan;
+    TupleDesc outDesc = outerPlanState(m_runtime)->ps_ResultTupleSlot->tts_tupleDescriptor;
+
+    m_status = SONIC_WIN_FETCH;
+    m_funcNum = runtime->numfuncs;
+    m_inCols = outDesc->natts;
+    m_curBatch = NULL;
+    m_headStart = 0;
+    m_groupStart = 0;
+    m_partRows = 0;
+    m_rank = 0;
+    m_denseRank = 0;
+    m_pendRows = 0;
+    m_pendReadRows = 0;
+    m_pendComplete = false;
+    m_pendFile = NULL;
+    m_pendRowNumber = 0;
+    m_pendRank = 0;
+    m_pendDenseRank = 0;
+    m_spillFileNum = 0;
+
+    m_rowsFrame = (node->frameOptions & FRAMEOPTION_ROWS) != 0;
+    m_frameRows = -1;
+    if (node->frameOptions & FRAMEOPTION_START_VALUE_PRECEDING)
+        m_frameRows = DatumGetInt64(((Const*)node->startOffset)->constvalue);
+
+    m_lastRow = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, outDesc);
+    m_outBatch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, outDesc);
+    m_pendBatch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, outDesc);
+
+    m_partKeyNum = node->partNumCols;
+    m_partKeyIdx = NULL;
+    m_simplePartKey = true;
+    if (m_partKeyNum > 0) {
+        m_partKeyIdx = (int*)palloc(sizeof(int) * m_partKeyNum);
+        for (int i = 0; i < m_partKeyNum; i++) {
+            m_partKeyIdx[i] = node->partColIdx[i] - 1;
+            if (m_lastRow->m_arr[m_partKeyIdx[i]].m_desc.encoded)
+                m_simplePartKey = false;
+        }
+        replace_window_eqfunc(runtime->partEqfunctions, m_partKeyNum, m_partKeyIdx, m_lastRow);
+    }
+
+    m_ordKeyNum = node->ordNumCols;
+    m_ordKeyIdx = NULL;
+    m_simpleOrdKey = true;
+    if (m_ordKeyNum > 0) {
+        m_ordKeyIdx = (int*)palloc(sizeof(int) * m_ordKeyNum);
+        for (int i = 0; i < m_ordKeyNum; i++) {
+            m_ordKeyIdx[i] = node->ordColIdx[i] - 1;
+            if (m_lastRow->m_arr[m_ordKeyIdx[i]].m_desc.encoded)
+                m_simpleOrdKey = false;
+        }
+        replace_window_eqfunc(runtime->ordEqfunctions, m_ordKeyNum, m_ordKeyIdx, m_lastRow);
+    }
+
+    initFuncState();
+
+    initMemoryControl();
+
+    m_memControl.hashContext = AllocSetContextCreate(CurrentMemoryContext,
+        "SonicWindowAggContext",
+        ALLOCSET_DEFAULT_MINSIZE,
+        ALLOCSET_DEFAULT_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE);
+
+    AddControlMemoryContext(runtime->ss.ps.instrument, m_memControl.hashContext);
+
+    initPendStore();
+}
+
+/*
+ * @Description	: Bind every window function to its native implementation, and
+ *				  allocate the per-row result batch.
+ */
+void SonicWindowAgg::initFuncState()
+{
+    ScalarDesc* resDesc = (ScalarDesc*)palloc(sizeof(ScalarDesc) * m_funcNum);
+    ScalarDesc unknownDesc;
+
+    m_funcs = (SonicWinFuncState*)palloc0(sizeof(SonicWinFuncState) * m_funcNum);
+    m_hasGroupFunc = false;
+
+    for (int i = 0; i < m_funcNum; i++) {
+        WindowStatePerFunc perfuncstate = &m_runtime->perfunc[i];
+        WindowFunc* wfunc = perfuncstate->wfunc;
+        SonicWinFuncState* fstate = &m_funcs[i];
+
+        fstate->wfuncstate = perfuncstate->wfuncstate;
+        fstate->argType = InvalidOid;
+        fstate->argVector = NULL;
+
+        switch (wfunc->winfnoid) {
+            case ROWNUMBERFUNCOID:
+                fstate->type = SONIC_WIN_ROWNUMBER;
+                break;
+            case RANKFUNCOID:
+                fstate->type = SONIC_WIN_RANK;
+                break;
+            case DENSERANKFUNCOID:
+                fstate->type = SONIC_WIN_DENSERANK;
+                break;
+            case ANYCOUNTOID:
+            case COUNTOID:
+                fstate->type = SONIC_WIN_COUNT;
+                break;
+            case INT2SUMFUNCOID:
+            case INT4SUMFUNCOID:
+                fstate->type = SONIC_WIN_SUM_INT;
+                break;
+            case INT8SUMFUNCOID:
+                fstate->type = SONIC_WIN_SUM_INT8;
+                break;
+            default:
+                ereport(ERROR,
+                    (errmodule(MOD_VEC_EXECUTOR),
+                        errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                        errmsg("[SonicWindowAgg(%d)]: Unsupported window function %u.",
+                            m_runtime->ss.ps.plan->plan_node_id,
+                            wfunc->winfnoid)));
+                break;
+        }
+
+        if (wfunc->winagg) {
+            /* aggregates over the RANGE frame need the whole peer group */
+            if (!m_rowsFrame)
+                m_hasGroupFunc = true;
+
+            if (wfunc->args != NIL) {
+                fstate->argType = exprType((Node*)linitial(wfunc->args));
+                fstate->argVector = New(CurrentMemoryContext) ScalarVector();
+                fstate->argVector->init(CurrentMemoryContext, unknownDesc);
+            }
+
+            if (m_frameRows >= 0) {
+                fstate->ringVals = (int64*)palloc(sizeof(int64) * (m_frameRows + 1));
+                fstate->ringFlags = (uint8*)palloc(sizeof(uint8) * (m_frameRows + 1));
+            }
+        }
+
+        resDesc[i].typeId = wfunc->wintype;
+        resDesc[i].typeMod = -1;
+        resDesc[i].encoded = COL_IS_ENCODE(wfunc->wintype);
+    }
+
+    m_resBatch = New(CurrentMemoryContext) VectorBatch(CurrentMemoryContext, resDesc, m_funcNum);
+}
+
+/*
+ * @Description	: Initialize the memory control information.
+ */
+void SonicWindowAgg::initMemoryControl()
+{
+    WindowAgg* node = (WindowAgg*)m_runtime->ss.ps.plan;
+
+    m_memControl.totalMem = SET_NODEMEM(node->plan.operatorMemKB[0], node->plan.dop) * 1024L;
+    m_memControl.availMem = m_memControl.totalMem;
+    if (node->plan.operatorMaxMem > node->plan.operatorMemKB[0])
+        m_memControl.maxMem = SET_NODEMEM(node->plan.operatorMaxMem, node->plan.dop) * 1024L;
+
+    MEMCTL_LOG(DEBUG2,
+        "[SonicWindowAgg(%d)]: Initial total memory: %lu, max memory: %lu.",
+        m_runtime->ss.ps.plan->plan_node_id,
+        m_memControl.totalMem,
+        m_memControl.maxMem);
+
+    m_memControl.sysBusy = false;
+    m_memControl.spillToDisk = false;
+    m_memControl.spillNum = 0;
+    m_memControl.spreadNum = 0;
+}
+
+/*
+ * @Description	: Initialize the sonic datum arrays of the pending store, one array per input column.
+ */
+void SonicWindowAgg::initPendStore()
+{
+    if (!m_hasGroupFunc)
+        return;
+
+    AutoContextSwitch memSwitch(m_memControl.hashContext);
+    TupleDesc outDesc = outerPlanState(m_runtime)->ps_ResultTupleSlot->tts_tupleDescriptor;
+    DatumDesc desc;
+
+    m_data = (SonicDatumArray**)palloc(sizeof(SonicDatumArray*) * m_inCols);
+    for (int i = 0; i < m_inCols; i++) {
+        Form_pg_attribute attr = outDesc->attrs[i];
+        getDataDesc(&desc, 0, attr, true);
+
+        if (!COL_IS_ENCODE(attr->atttypid)) {
+            m_data[i] = AllocateIntArray(m_memControl.hashContext, m_memControl.hashContext, m_atomSize, true, &desc);
+        } else {
+            m_data[i] = New(m_memControl.hashContext)
+                SonicStackEncodingDatumArray(m_memControl.hashContext, m_atomSize, true, &desc);
+
+            /* to make sure data type is ENCODE_VAR_TYPE */
+            m_data[i]->m_desc.dataType = SONIC_VAR_TYPE;
+            m_data[i]->m_atomTypeSize = m_data[i]->m_desc.typeSize = sizeof(Datum);
+        }
+    }
+}
+
+/*
+ * @Description	: Mark the rows starting a new group according to the keys.
+ *				  The first row is compared with the last row of the previous batch.
+ * @in batch		: current batch.
+ * @in nkeys		: number of keys.
+ * @in keyIdx		: key column indexes.
+ * @in eqfuncs		: equal functions of the keys.
+ * @out result		: result[i] is 1 if row i is not equal to row i - 1.
+ */
+template <bool simple>
+void SonicWindowAgg::markBoundary(VectorBatch* batch, int nkeys, const int* keyIdx, FmgrInfo* eqfuncs, uint8* result)
+{
+    int nrows = batch->m_rows;
+    FunctionCallInfoData fcinfo;
+    Datum args[2];
+    fcinfo.arg = &args[0];
+    errno_t rc;
+
+    rc = memset_s(result, sizeof(uint8) * BatchMaxSize, 0, sizeof(uint8) * nrows);
+    securec_check(rc, "\0", "\0");
+
+    /* the very first row always starts a new group */
+    if (m_lastRow->m_rows == 0)
+        result[0] = 1;
+
+    for (int i = 0; i < nkeys; i++) {
+        ScalarVector* vector = &batch->m_arr[keyIdx[i]];
+        ScalarVector* lastVector = &m_lastRow->m_arr[keyIdx[i]];
+        ScalarValue* vals = vector->m_vals;
+        uint8* flags = vector->m_flag;
+        PGFunction eqfunc = eqfuncs[i].fn_addr;
+        bool encoded = !simple && vector->m_desc.encoded;
+
+        for (int j = 0; j < nrows; j++) {
+            ScalarValue key1;
+            uint8 flag1;
+
+            /* already a new group, no need to compare */
+            if (result[j])
+                continue;
+
+            if (j == 0) {
+                key1 = lastVector->m_vals[0];
+                flag1 = lastVector->m_flag[0];
+            } else {
+                key1 = vals[j - 1];
+                flag1 = flags[j - 1];
+            }
+
+            if (BOTH_NOT_NULL(flag1, flags[j])) {
+                if (!encoded) {
+                    result[j] = (key1 == vals[j]) ? 0 : 1;
+                } else {
+                    fcinfo.arg[0] = ScalarVector::Decode(key1);
+                    fcinfo.arg[1] = ScalarVector::Decode(vals[j]);
+                    result[j] = DatumGetBool(eqfunc(&fcinfo)) ? 0 : 1;
+                }
+            } else if (!BOTH_NULL(flag1, flags[j])) {
+                /* null is only equal to null */
+                result[j] = 1;
+            }
+        }
+    }
+}
+
+/*
+ * @Description	: Mark partition and peer group boundaries of the whole batch.
+ */
+void SonicWindowAgg::markBatchBoundary(VectorBatch* batch)
+{
+    if (m_simplePartKey)
+        markBoundary<true>(batch, m_partKeyNum, m_partKeyIdx, m_runtime->partEqfunctions, m_newPart);
+    else
+        markBoundary<false>(batch, m_partKeyNum, m_partKeyIdx, m_runtime->partEqfunctions, m_newPart);
+
+    if (m_simpleOrdKey)
+        markBoundary<true>(batch, m_ordKeyNum, m_ordKeyIdx, m_runtime->ordEqfunctions, m_newPeer);
+    else
+        markBoundary<false>(batch, m_ordKeyNum, m_ordKeyIdx, m_runtime->ordEqfunctions, m_newPeer);
+
+    /* a new partition is also a new peer group */
+    for (int i = 0; i < batch->m_rows; i++)
+        m_newPeer[i] |= m_newPart[i];
+}
+
+/*
+ * @Description	: Evaluate the argument of every aggregate over the whole batch.
+ */
+void SonicWindowAgg::evalAggArgs(VectorBatch* batch)
+{
+    ExprContext* econtext = m_runtime->tmpcontext;
+
+    for (int i = 0; i < m_funcNum; i++) {
+        SonicWinFuncState* fstate = &m_funcs[i];
+        if (fstate->argVector == NULL)
+            continue;
+
+        ExprState* argstate = (ExprState*)linitial(fstate->wfuncstate->args);
+        econtext->ecxt_outerbatch = batch;
+        econtext->align_rows = batch->m_rows;
+        ScalarVector* pVector =
+            VectorExprEngine(argstate, econtext, econtext->ecxt_outerbatch->m_sel, fstate->argVector, NULL);
+        if (pVector != fstate->argVector)
+            fstate->argVector->copy(pVector);
+
+        ResetExprContext(econtext);
+    }
+}
+
+/*
+ * @Description	: Reset all the states at the start of a partition.
+ */
+void SonicWindowAgg::resetPartition()
+{
+    m_partRows = 0;
+    m_rank = 0;
+    m_denseRank = 0;
+
+    for (int i = 0; i < m_funcNum; i++) {
+        SonicWinFuncState* fstate = &m_funcs[i];
+        fstate->count = 0;
+        fstate->sum = 0;
+        fstate->ringHead = 0;
+        fstate->ringRows = 0;
+    }
+}
+
+/*
+ * @Description	: Move the frame of the aggregate forward to the given row.
+ *				  For ROWS n PRECEDING, the row leaving the frame is removed from
+ *				  the running state, so every row costs O(1).
+ * @in fstate	: window function state.
+ * @in row		: row index in the current batch.
+ */
+void SonicWindowAgg::advanceFrame(SonicWinFuncState* fstate, int row)
+{
+    int64 val = 0;
+    uint8 flag = 0;
+
+    if (fstate->argVector != NULL) {
+        flag = fstate->argVector->m_flag[row];
+        if (NOT_NULL(flag)) {
+            switch (fstate->argType) {
+                case INT2OID:
+                    val = DatumGetInt16(fstate->argVector->m_vals[row]);
+                    break;
+                case INT4OID:
+                    val = DatumGetInt32(fstate->argVector->m_vals[row]);
+                    break;
+                default:
+                    val = DatumGetInt64(fstate->argVector->m_vals[row]);
+                    break;
+            }
+        }
+    }
+
+    if (m_frameRows >= 0) {
+        int capacity = (int)m_frameRows + 1;
+        int pos;
+
+        if (fstate->ringRows == capacity) {
+            /* the oldest row leaves the frame */
+            pos = fstate->ringHead;
+            if (NOT_NULL(fstate->ringFlags[pos])) {
+                fstate->count--;
+                fstate->sum -= (int128)fstate->ringVals[pos];
+            }
+            fstate->ringHead = (fstate->ringHead + 1) % capacity;
+        } else {
+            pos = (fstate->ringHead + fstate->ringRows) % capacity;
+            fstate->ringRows++;
+        }
+
+        fstate->ringVals[pos] = val;
+        fstate->ringFlags[pos] = flag;
+    }
+
+    /* widen before adding, sum(int8) must not wrap where the row engine returns numeric */
+    if (NOT_NULL(flag)) {
+        fstate->count++;
+        fstate->sum += (int128)val;
+    }
+}
+
+/*
+ * @Description	: Set the result of the window function for the given row by the current state.
+ */
+void SonicWindowAgg::setFuncResult(SonicWinFuncState* fstate, ScalarVector* result, int row)
+{
+    switch (fstate->type) {
+        case SONIC_WIN_ROWNUMBER:
+            result->m_vals[row] = Int64GetDatum(m_partRows);
+            SET_NOTNULL(result->m_flag[row]);
+            break;
+        case SONIC_WIN_RANK:
+            result->m_vals[row] = Int64GetDatum(m_rank);
+            SET_NOTNULL(result->m_flag[row]);
+            break;
+        case SONIC_WIN_DENSERANK:
+            result->m_vals[row] = Int64GetDatum(m_denseRank);
+            SET_NOTNULL(result->m_flag[row]);
+            break;
+        case SONIC_WIN_COUNT:
+            result->m_vals[row] = Int64GetDatum(fstate->count);
+            SET_NOTNULL(result->m_flag[row]);
+            break;
+        case SONIC_WIN_SUM_INT:
+        case SONIC_WIN_SUM_INT8:
+            if (fstate->count == 0) {
+                SET_NULL(result->m_flag[row]);
+            } else {
+                if (fstate->type == SONIC_WIN_SUM_INT)
+                    result->m_vals[row] = Int64GetDatum((int64)fstate->sum);
+                else
+                    result->AddBigNumericWithoutHeader(fstate->sum, 0, row);
+                SET_NOTNULL(result->m_flag[row]);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * @Description	: The peer group [start, end) of the current batch is complete, set the
+ *				  results of the aggregates over the RANGE frame. start is -1 if the
+ *				  group starts in the pending store.
+ */
+void SonicWindowAgg::finishPeerGroup(int start, int end)
+{
+    if (!m_hasGroupFunc)
+        return;
+
+    if (start < 0) {
+        /* snapshot the group result, the pending rows are emitted later */
+        int64 groupRows = m_pendRows + end;
+
+        m_pendRowNumber = m_partRows - groupRows + 1;
+        m_pendRank = m_rank;
+        m_pendDenseRank = m_denseRank;
+        for (int i = 0; i < m_funcNum; i++) {
+            m_funcs[i].pendCount = m_funcs[i].count;
+            m_funcs[i].pendSum = m_funcs[i].sum;
+        }
+
+        m_pendComplete = true;
+        m_headStart = end;
+        return;
+    }
+
+    for (int i = 0; i < m_funcNum; i++) {
+        SonicWinFuncState* fstate = &m_funcs[i];
+        if (!SONIC_WIN_IS_AGG(fstate->type))
+            continue;
+
+        ScalarVector* result = &m_resBatch->m_arr[i];
+        for (int row = start; row < end; row++)
+            setFuncResult(fstate, result, row);
+    }
+}
+
+/*
+ * @Description	: Compute the window functions over the whole batch.
+ */
+void SonicWindowAgg::processBatch(VectorBatch* batch)
+{
+    int nrows = batch->m_rows;
+    int groupStart = (m_pendRows > 0) ? -1 : 0;
+
+    markBatchBoundary(batch);
+    evalAggArgs(batch);
+
+    m_resBatch->Reset();
+    m_curBatch = batch;
+    m_headStart = 0;
+    m_pendComplete = false;
+
+    for (int i = 0; i < nrows; i++) {
+        if (m_newPeer[i]) {
+            if (i > 0 || m_pendRows > 0)
+                finishPeerGroup(groupStart, i);
+
+            if (m_newPart[i])
+                resetPartition();
+
+            groupStart = i;
+            m_rank = m_partRows + 1;
+            m_denseRank++;
+        }
+
+        m_partRows++;
+
+        for (int j = 0; j < m_funcNum; j++) {
+            SonicWinFuncState* fstate = &m_funcs[j];
+
+            if (SONIC_WIN_IS_AGG(fstate->type)) {
+                advanceFrame(fstate, i);
+                /* aggregates over the RANGE frame are set when the peer group is complete */
+                if (m_hasGroupFunc)
+                    continue;
+            }
+
+            setFuncResult(fstate, &m_resBatch->m_arr[j], i);
+        }
+    }
+
+    for (int j = 0; j < m_funcNum; j++)
+        m_resBatch->m_arr[j].m_rows = nrows;
+    m_resBatch->m_rows = nrows;
+
+    /* the last peer group may continue in the next batch */
+    m_groupStart = m_hasGroupFunc ? groupStart : nrows;
+
+    /* keep the last row for the boundary of the next batch */
+    m_lastRow->Reset();
+    m_lastRow->Copy<true, false>(batch, nrows - 1, nrows);
+}
+
+/*
+ * @Description	: Append rows [start, end) of the batch to the pending store.
+ */
+void SonicWindowAgg::appendPending(VectorBatch* batch, int start, int end)
+{
+    int rows = end - start;
+    if (rows <= 0)
+        return;
+
+    if (m_pendFile != NULL) {
+        bool optspill = u_sess->attr.attr_sql.enable_sonic_optspill;
+        for (int row = start; row < end; row++) {
+            for (int col = 0; col < m_inCols; col++) {
+                ScalarVector* pVector = &batch->m_arr[col];
+                if (optspill)
+                    m_pendFile->putVal<true>(&pVector->m_vals[row], &pVector->m_flag[row], col);
+                else
+                    m_pendFile->putVal<false>(&pVector->m_vals[row], &pVector->m_flag[row], col);
+            }
+            m_pendFile->m_rows += 1;
+        }
+        m_pendRows += rows;
+        return;
+    }
+
+    {
+        AutoContextSwitch memSwitch(m_memControl.hashContext);
+        for (int col = 0; col < m_inCols; col++) {
+            ScalarVector* pVector = &batch->m_arr[col];
+            m_data[col]->putArray(&pVector->m_vals[start], &pVector->m_flag[start], rows);
+        }
+    }
+    m_pendRows += rows;
+
+    int64 usedSize = 0;
+    CalculateContextSize(m_memControl.hashContext, &usedSize);
+    if ((uint64)usedSize > m_memControl.totalMem)
+        spillPending();
+}
+
+/*
+ * @Description	: The pending peer group is too large, move it to temp files.
+ */
+void SonicWindowAgg::spillPending()
+{
+    bool optspill = u_sess->attr.attr_sql.enable_sonic_optspill;
+    ScalarValue val;
+    uint8 flag;
+
+    m_pendFile = New(CurrentMemoryContext)
+        SonicHashFilePartition((char*)"SonicWindowAggPendFile", m_pendBatch, m_memControl.totalMem);
+    {
+        AutoContextSwitch memSwitch(m_pendFile->m_context);
+        for (int col = 0; col < m_inCols; col++)
+            m_pendFile->init(col, &m_data[col]->m_desc);
+    }
+
+    for (int64 row = 0; row < m_pendRows; row++) {
+        for (int col = 0; col < m_inCols; col++) {
+            m_data[col]->getNthDatumFlag(row + 1, &val, &flag);
+            if (optspill)
+                m_pendFile->putVal<true>(&val, &flag, col);
+            else
+                m_pendFile->putVal<false>(&val, &flag, col);
+        }
+        m_pendFile->m_rows += 1;
+    }
+
+    /* the rows are all in the temp files now */
+    MemoryContextResetAndDeleteChildren(m_memControl.hashContext);
+    m_data = NULL;
+
+    m_memControl.spillToDisk = true;
+    m_memControl.spillNum++;
+    m_spillFileNum += m_pendFile->m_fileNum;
+    pgstat_increase_session_spill();
+
+    if (m_runtime->ss.ps.instrument) {
+        m_runtime->ss.ps.instrument->sorthashinfo.hash_writefile = true;
+        m_runtime->ss.ps.instrument->sorthashinfo.hash_FileNum = m_spillFileNum;
+        m_runtime->ss.ps.instrument->sorthashinfo.hash_spillNum = m_memControl.spillNum;
+    }
+
+    ereport(DEBUG2,
+        (errmodule(MOD_VEC_EXECUTOR),
+            errmsg("[SonicWindowAgg(%d)]: peer group of %ld rows spilled to disk.",
+                m_runtime->ss.ps.plan->plan_node_id,
+                m_pendRows)));
+}
+
+/*
+ * @Description	: Load the next pending rows into m_pendBatch.
+ * @return		: false if all the pending rows are read.
+ */
+bool SonicWindowAgg::fetchPending()
+{
+    if (m_pendReadRows >= m_pendRows)
+        return false;
+
+    if (m_pendFile != NULL) {
+        if (m_pendReadRows == 0)
+            m_pendFile->rewindFiles();
+
+        return m_pendFile->getBatch() != NULL;
+    }
+
+    int rows = (int)Min((int64)BatchMaxSize, m_pendRows - m_pendReadRows);
+
+    m_pendBatch->Reset();
+    for (int col = 0; col < m_inCols; col++) {
+        ScalarVector* pVector = &m_pendBatch->m_arr[col];
+        for (int row = 0; row < rows; row++)
+            m_data[col]->getNthDatumFlag(m_pendReadRows + row + 1, &pVector->m_vals[row], &pVector->m_flag[row]);
+    }
+    m_pendBatch->FixRowCount(rows);
+
+    return true;
+}
+
+/*
+ * @Description	: Release the pending store after all its rows are emitted.
+ */
+void SonicWindowAgg::releasePending()
+{
+    if (m_pendFile != NULL) {
+        if (m_runtime->ss.ps.instrument)
+            m_runtime->ss.ps.instrument->sorthashinfo.spill_size += m_pendFile->m_size;
+
+        m_pendFile->freeResources();
+        m_pendFile = NULL;
+    }
+
+    MemoryContextResetAndDeleteChildren(m_memControl.hashContext);
+    m_pendRows = 0;
+    m_pendReadRows = 0;
+    m_pendComplete = false;
+    initPendStore();
+}
+
+/*
+ * @Description	: Emit the rows of the completed pending peer group. Aggregates
+ *				  share the group result, row_number grows from the first row.
+ * @return		: the projected batch, NULL if all the pending rows are emitted.
+ */
+const VectorBatch* SonicWindowAgg::emitPending()
+{
+    if (!fetchPending())
+        return NULL;
+
+    int rows = m_pendBatch->m_rows;
+
+    for (int i = 0; i < m_funcNum; i++) {
+        SonicWinFuncState* fstate = &m_funcs[i];
+        ScalarVector* result = fstate->wfuncstate->m_resultVector;
+
+        result->m_buf->Reset();
+        for (int row = 0; row < rows; row++) {
+            ScalarValue val = 0;
+            bool isNull = false;
+
+            switch (fstate->type) {
+                case SONIC_WIN_ROWNUMBER:
+                    val = Int64GetDatum(m_pendRowNumber + m_pendReadRows + row);
+                    break;
+                case SONIC_WIN_RANK:
+                    val = Int64GetDatum(m_pendRank);
+                    break;
+                case SONIC_WIN_DENSERANK:
+                    val = Int64GetDatum(m_pendDenseRank);
+                    break;
+                case SONIC_WIN_COUNT:
+                    val = Int64GetDatum(fstate->pendCount);
+                    break;
+                case SONIC_WIN_SUM_INT:
+                    isNull = (fstate->pendCount == 0);
+                    val = Int64GetDatum((int64)fstate->pendSum);
+                    break;
+                case SONIC_WIN_SUM_INT8:
+                    isNull = (fstate->pendCount == 0);
+                    if (!isNull)
+                        val = result->AddBigNumericWithoutHeader(fstate->pendSum, 0, row);
+                    break;
+                default:
+                    break;
+            }
+
+            result->m_vals[row] = val;
+            result->m_flag[row] = 0;
+            if (isNull)
+                SET_NULL(result->m_flag[row]);
+        }
+        result->m_rows = rows;
+    }
+
+    m_pendReadRows += rows;
+
+    return projectOutBatch(m_pendBatch);
+}
+
+/*
+ * @Description	: Emit the final rows [m_headStart, m_groupStart) of the current batch.
+ * @return		: the projected batch, NULL if there is no such row.
+ */
+const VectorBatch* SonicWindowAgg::emitBatchHead()
+{
+    VectorBatch* batch = m_curBatch;
+    int start = m_headStart;
+    int end = m_groupStart < 0 ? start : m_groupStart;
+
+    if (end <= start)
+        return NULL;
+
+    if (start > 0 || end < batch->m_rows) {
+        m_outBatch->Copy<false, false>(batch, start, end);
+        batch = m_outBatch;
+    }
+
+    for (int i = 0; i < m_funcNum; i++) {
+        ScalarVector* result = m_funcs[i].wfuncstate->m_resultVector;
+        result->m_rows = 0;
+        result->copy(&m_resBatch->m_arr[i], start, end);
+    }
+
+    return projectOutBatch(batch);
+}
+
+/*
+ * @Description	: Do the projection of the window agg node on the batch.
+ */
+const VectorBatch* SonicWindowAgg::projectOutBatch(VectorBatch* batch)
+{
+    ExprContext* econtext = m_runtime->ss.ps.ps_ExprContext;
+
+    ResetExprContext(econtext);
+    econtext->ecxt_outerbatch = batch;
+
+    return ExecVecProject(m_runtime->ss.ps.ps_ProjInfo);
+}
+
+/*
+ * @Description	: Return the next result batch.
+ */
+const VectorBatch* SonicWindowAgg::getBatch()
+{
+    PlanState* outerNode = outerPlanState(m_runtime);
+    const VectorBatch* resBatch = NULL;
+
+    while (true) {
+        switch (m_status) {
+            case SONIC_WIN_FETCH: {
+                VectorBatch* batch = VectorEngine(outerNode);
+                if (BatchIsNull(batch)) {
+                    m_curBatch = NULL;
+                    if (m_pendRows > 0) {
+                        /* the input is done, so is the pending peer group */
+                        finishPeerGroup(-1, 0);
+                        m_status = SONIC_WIN_EMIT_PENDING;
+                    } else {
+                        m_status = SONIC_WIN_END;
+                    }
+                    break;
+                }
+
+                processBatch(batch);
+
+                if (m_pendComplete) {
+                    /* the leading rows of the batch close the pending peer group */
+                    appendPending(batch, 0, m_headStart);
+                    m_status = SONIC_WIN_EMIT_PENDING;
+                } else if (m_groupStart < 0) {
+                    /* the whole batch belongs to the pending peer group */
+                    appendPending(batch, 0, batch->m_rows);
+                } else {
+                    m_status = SONIC_WIN_EMIT_BATCH;
+                }
+            } break;
+
+            case SONIC_WIN_EMIT_PENDING: {
+                resBatch = emitPending();
+                if (resBatch != NULL)
+                    return resBatch;
+
+                /* the emitted pending rows are consumed, it is safe to release them now */
+                releasePending();
+                m_status = (m_curBatch != NULL) ? SONIC_WIN_EMIT_BATCH : SONIC_WIN_END;
+            } break;
+
+            case SONIC_WIN_EMIT_BATCH: {
+                m_status = SONIC_WIN_APPEND_TAIL;
+                resBatch = emitBatchHead();
+                if (resBatch != NULL)
+                    return resBatch;
+            } break;
+
+            case SONIC_WIN_APPEND_TAIL: {
+                if (m_groupStart >= 0 && m_groupStart < m_curBatch->m_rows)
+                    appendPending(m_curBatch, m_groupStart, m_curBatch->m_rows);
+                m_status = SONIC_WIN_FETCH;
+            } break;
+
+            case SONIC_WIN_END:
+                return NULL;
+
+            default:
+                break;
+        }
+    }
+}
+
+/*
+ * @Description	: Reset sonic window agg for rescan.
+ */
+void SonicWindowAgg::ResetNecessary()
+{
+    if (m_pendFile != NULL) {
+        m_pendFile->freeResources();
+        m_pendFile = NULL;
+    }
+
+    MemoryContextResetAndDeleteChildren(m_memControl.hashContext);
+    initPendStore();
+
+    m_status = SONIC_WIN_FETCH;
+    m_curBatch = NULL;
+    m_headStart = 0;
+    m_groupStart = 0;
+    m_pendRows = 0;
+    m_pendReadRows = 0;
+    m_pendComplete = false;
+    m_memControl.spillToDisk = false;
+
+    resetPartition();
+    m_lastRow->Reset(true);
+    m_outBatch->Reset(true);
+    m_resBatch->Reset(true);
+}
+
+/*
+ * @Description	: Release the memory and close the temp files.
+ */
+void SonicWindowAgg::freeResources()
+{
+    if (m_pendFile != NULL) {
+        m_pendFile->freeResources();
+        m_pendFile = NULL;
+    }
+
+    freeMemoryContext();
+}
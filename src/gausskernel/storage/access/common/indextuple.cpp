@@ -387,3 +387,31 @@ IndexTuple CopyIndexTuple(IndexTuple source)
     securec_check(rc, "\0", "\0");
     return result;
 }
+
+/*
+ * Create a palloc'd copy of an index tuple that keeps only its first
+ * leavenatts attributes.  The item pointer is copied too.
+ *
+ * This is used to drop the included columns of a btree index from the
+ * pivot tuples, which only need the key columns to guide the descent.
+ */
+IndexTuple index_truncate_tuple(TupleDesc sourceDescriptor, IndexTuple source, int leavenatts)
+{
+    struct tupleDesc truncdesc;
+    Datum values[INDEX_MAX_KEYS];
+    bool isnull[INDEX_MAX_KEYS];
+    IndexTuple truncated;
+
+    Assert(leavenatts > 0 && leavenatts < sourceDescriptor->natts);
+
+    /* the leading attributes are laid out the same way in both tuples */
+    truncdesc = *sourceDescriptor;
+    truncdesc.natts = leavenatts;
+
+    index_deform_tuple(source, &truncdesc, values, isnull);
+    truncated = index_form_tuple(&truncdesc, values, isnull);
+    truncated->t_tid = source->t_tid;
+    Assert(IndexTupleSize(truncated) <= IndexTupleSize(source));
+
+    return truncated;
+}
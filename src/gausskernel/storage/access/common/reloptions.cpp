@@ -25,6 +25,7 @@
 #include "catalog/pg_type.h"
 #include "commands/defrem.h"
 #include "commands/tablespace.h"
+#include "commands/vacuum.h"
 #include "nodes/makefuncs.h"
 #include "pgxc/redistrib.h"
 #include "tsearch/ts_public.h"
@@ -71,6 +72,7 @@ static relopt_bool boolRelOpts[] = {
         "Declare a table as an additional catalog table, e.g. for the purpose of logical replication",
         RELOPT_KIND_HEAP}, false},
     {{"fastupdate", "Enables \"fast update\" feature for this GIN index", RELOPT_KIND_GIN}, true},
+    {{"deduplicate_items", "Enables \"deduplicate items\" feature for this btree index", RELOPT_KIND_BTREE}, true},
     {{"security_barrier", "View acts as a row security barrier", RELOPT_KIND_VIEW}, false},
     {{"enable_rowsecurity", "Enable row level security or not", RELOPT_KIND_HEAP}, false},
     {{"force_rowsecurity", "Row security forced for owners or not", RELOPT_KIND_HEAP}, false},
@@ -132,6 +134,12 @@ static relopt_int intRelOpts[] = {{{"fillfactor", "Packs table pages only to thi
         -1,
         1,
         10000},
+    {{"parallel_vacuum_workers",
+         "Number of worker threads vacuuming the indexes of this table",
+         RELOPT_KIND_HEAP},
+        -1,
+        0,
+        MAX_PARALLEL_VACUUM_WORKERS},
     {{"max_batchrow", "the upmost rows at each batch inserting", RELOPT_KIND_HEAP | RELOPT_KIND_PSORT},
         RelDefaultFullCuSize,
         10 * BatchMaxSize,
@@ -1373,7 +1381,8 @@ void ForbidToSetOptionsForColTbl(List* options)
         "autovacuum_freeze_max_age",
         "autovacuum_freeze_table_age",
         "autovacuum_vacuum_scale_factor",
-        "security_barrier"};
+        "security_barrier",
+        "parallel_vacuum_workers"};
 
     ForbidUserToSetUnsupportedOptions(options, unsupported, lengthof(unsupported), "column/timeseries relation");
 }
@@ -1395,6 +1404,7 @@ void forbid_to_set_options_for_timeseries_tbl(List* options)
 		"autovacuum_freeze_table_age",
 		"autovacuum_vacuum_scale_factor",
 		"security_barrier",
+		"parallel_vacuum_workers",
 		"max_batchrow",
 		"deltarow_threshold",
 		"partial_cluster_rows",
@@ -1426,6 +1436,7 @@ void ForbidToSetOptionsForPSort(List* options)
         "autovacuum_vacuum_scale_factor",
         "autovacuum_analyze_scale_factor",
         "security_barrier",
+        "parallel_vacuum_workers",
         "compression"};
 
     ForbidUserToSetUnsupportedOptions(options, unsupported, lengthof(unsupported), "psort index");
@@ -1469,6 +1480,8 @@ bytea* default_reloptions(Datum reloptions, bool validate, relopt_kind kind)
         {"autovacuum_analyze_scale_factor",
             RELOPT_TYPE_REAL,
             offsetof(StdRdOptions, autovacuum) + offsetof(AutoVacOpts, analyze_scale_factor)},
+        {"parallel_vacuum_workers", RELOPT_TYPE_INT, offsetof(StdRdOptions, parallel_vacuum_workers)},
+        {"deduplicate_items", RELOPT_TYPE_BOOL, offsetof(StdRdOptions, deduplicate_items)},
         {"security_barrier", RELOPT_TYPE_BOOL, offsetof(StdRdOptions, security_barrier)},
         {"enable_rowsecurity", RELOPT_TYPE_BOOL, offsetof(StdRdOptions, enable_rowsecurity)},
         {"force_rowsecurity", RELOPT_TYPE_BOOL, offsetof(StdRdOptions, force_rowsecurity)},
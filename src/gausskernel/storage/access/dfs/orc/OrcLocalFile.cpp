@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * OrcLocalFile.cpp
+ *
+ *
+ * IDENTIFICATION
+ *         src/gausskernel/storage/access/dfs/orc/OrcLocalFile.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+#include <string>
+#include <memory>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* Becareful: liborc header file must before  postgres header file */
+#include "orc_rw.h"
+#include "orc/Adaptor.hh"
+#include "orc/Exceptions.hh"
+#include "OrcLocalFile.h"
+#include "storage/fd.h"
+#include "utils/plog.h"
+
+/* Becareful: using throw exception instead of ereport ERROR in this file */
+namespace dfs {
+/*
+ * The descriptor of an opened local file. The readers copy the input stream
+ * once for every column, all the copies share the same descriptor which is
+ * closed with the last of them.
+ */
+class LocalFileDescriptor {
+public:
+    explicit LocalFileDescriptor(int fd) : m_fd(fd)
+    {
+    }
+
+    ~LocalFileDescriptor()
+    {
+        if (m_fd >= 0) {
+            (void)close(m_fd);
+        }
+    }
+
+    int get() const
+    {
+        return m_fd;
+    }
+
+private:
+    int m_fd;
+};
+
+class LocalFileInputStream : public GSInputStream {
+public:
+    explicit LocalFileInputStream(dfs::reader::ReaderState *_readerState)
+        : m_filename(""), m_totalLength(0), m_readCalls(0), readerState(_readerState)
+    {
+    }
+
+    ~LocalFileInputStream()
+    {
+    }
+
+    /*
+     * @Description: copy local file input stream
+     * @Return: copy of this object, the file descriptor is shared with the copy
+     * @See also: LocalFileInputStream(const LocalFileInputStream& other)
+     */
+    DFS_UNIQUE_PTR<GSInputStream> copy()
+    {
+        return DFS_UNIQUE_PTR<GSInputStream>(new LocalFileInputStream(*this));
+    }
+
+    /*
+     * @Description: init local file input stream
+     * @IN path: absolute file path
+     * @IN fileSize: file size
+     * @See also:
+     */
+    void init(const std::string &path, int64_t fileSize)
+    {
+        m_filename = path;
+
+        Assert(fileSize >= 0);
+        if (fileSize == 0) {
+            StringInfo err_msg = makeStringInfo();
+            appendStringInfo(err_msg, "file size is 0, path = %s", path.c_str());
+
+            orc::orclog(orc::ORC_ERROR, orc::PARSEERROR, err_msg->data);
+        }
+        m_totalLength = fileSize;
+
+        /* BasicOpenFile releases the cached VFDs when running out of descriptors */
+        int fd = BasicOpenFile((FileName)path.c_str(), O_RDONLY | PG_BINARY, 0);
+        if (fd < 0) {
+            StringInfo err_msg = makeStringInfo();
+            appendStringInfo(err_msg, "could not open file \"%s\": %s", path.c_str(), strerror(errno));
+
+            orc::orclog(orc::ORC_ERROR, orc::PARSEERROR, err_msg->data);
+        }
+        m_file = std::make_shared<LocalFileDescriptor>(fd);
+
+        ereport(DEBUG1, (errmodule(MOD_DFS),
+                         errmsg("initialize local ORC InputStream, file is %s, size is %lu", path.c_str(),
+                                m_totalLength)));
+    }
+
+    /*
+     * @Description:  get file size
+     * @Return: file size
+     * @See also:
+     */
+    uint64_t getLength() const
+    {
+        return m_totalLength;
+    }
+
+    /*
+     * @Description: get natural read size
+     * @Return: natural read size
+     * @See also:
+     */
+    uint64_t getNaturalReadSize() const override
+    {
+        return NATURAL_READ_SIZE;
+    }
+
+    /*
+     * @Description: read file to buffer, interrupted or partial reads are continued
+     * @IN buf: dest buffer
+     * @IN length: read length
+     * @IN offset: read offset
+     * @See also:
+     */
+    void read(void *buf, uint64_t length, uint64_t offset) override
+    {
+        char *dest = static_cast<char *>(buf);
+        uint64_t readSize = 0;
+
+        PROFILING_MDIO_START();
+        while (readSize < length) {
+            ssize_t nbytes = pread(m_file->get(), dest + readSize, length - readSize, (off_t)(offset + readSize));
+            if (nbytes < 0 && errno == EINTR) {
+                continue;
+            }
+            if (nbytes <= 0) {
+                break;
+            }
+            readSize += (uint64_t)nbytes;
+        }
+        PROFILING_MDIO_END_READ(length, readSize);
+
+        ++m_readCalls;
+
+        if (readSize < length) {
+            StringInfo err_msg = makeStringInfo();
+            appendStringInfo(err_msg, "read file \"%s\" failed, offset = %lu request = %lu, actual = %lu",
+                             m_filename.c_str(), offset, length, readSize);
+
+            orc::orclog(orc::ORC_ERROR, orc::PARSEERROR, err_msg->data);
+        }
+
+        readerState->orcDataLoadBlockCount++;
+        readerState->orcDataLoadBlockSize += length;
+    }
+
+    /*
+     * @Description: get file name
+     * @Return: file name
+     * @See also:
+     */
+    const std::string &getName() const override
+    {
+        return m_filename;
+    }
+
+    /*
+     * @Description:  get read stat info, all the reads are local
+     * @IN localBlock:local block
+     * @IN remoteBlock:remote block
+     * @IN nnCalls:namenode call
+     * @IN dnCalls:datanode call
+     * @See also:
+     */
+    void getStat(uint64_t *localBlock, uint64_t *remoteBlock, uint64_t *nnCalls, uint64_t *dnCalls)
+    {
+        *localBlock = m_readCalls;
+        *remoteBlock = 0;
+    }
+
+    void getLocalRemoteReadCnt(uint64_t *localReadCnt, uint64_t *remoteReadCnt)
+    {
+        *localReadCnt = m_readCalls;
+        *remoteReadCnt = 0;
+    }
+
+protected:
+    LocalFileInputStream(const LocalFileInputStream &other) : GSInputStream(other)
+    {
+        m_filename = other.m_filename;
+        m_totalLength = other.m_totalLength;
+        m_file = other.m_file;
+        readerState = other.readerState;
+
+        /* performance counter set to zero */
+        m_readCalls = 0;
+    }
+
+private:
+    std::string m_filename;
+    uint64_t m_totalLength;
+    std::shared_ptr<LocalFileDescriptor> m_file;
+    const static uint64_t NATURAL_READ_SIZE = 1024 * 1024;
+
+    /* performance counter */
+    uint64_t m_readCalls;
+    dfs::reader::ReaderState *readerState;
+};
+
+DFS_UNIQUE_PTR<GSInputStream> readLocalFile(const std::string &path, dfs::reader::ReaderState *readerState)
+{
+    LocalFileInputStream *inputstream = new LocalFileInputStream(readerState);
+    DFS_UNIQUE_PTR<GSInputStream> result(inputstream);
+    inputstream->init(path, readerState->currentFileSize);
+    return result;
+}
+}  // namespace dfs
@@ -138,6 +138,8 @@ void hbkt_idx_rescan(AbsIdxScanDesc scan, ScanKey keys, int nkeys,
     Assert(scan->type == T_ScanDesc_HBucketIndex);
 
     Snapshot snapshot = hp_scan->currBktIdxScan->xs_snapshot;
+    bool skip_scan = hp_scan->currBktIdxScan->xs_skip_scan;
+    long* nskips = hp_scan->currBktIdxScan->xs_nskips;
     free_hbucket_idxscan(hp_scan->currBktIdxScan, hp_scan->currBktHeapRel, hp_scan->currBktIdxRel);
 
     hp_scan->curr_slot = 0;
@@ -151,6 +153,8 @@ void hbkt_idx_rescan(AbsIdxScanDesc scan, ScanKey keys, int nkeys,
 	                                         nkeys, 
 	                                         norderbys);
     hp_scan->currBktIdxScan->xs_want_itup = true;
+    hp_scan->currBktIdxScan->xs_skip_scan = skip_scan;
+    hp_scan->currBktIdxScan->xs_nskips = nskips;
     index_rescan(hp_scan->currBktIdxScan, keys, nkeys, orderbys, norderbys);
 }
 
@@ -162,6 +166,8 @@ void hbkt_idx_rescan_bitmap(AbsIdxScanDesc scan, ScanKey keys, int nkeys,
     Assert(scan->type == T_ScanDesc_HBucketIndex);
 
     Snapshot snapshot = hp_scan->currBktIdxScan->xs_snapshot;
+    bool skip_scan = hp_scan->currBktIdxScan->xs_skip_scan;
+    long* nskips = hp_scan->currBktIdxScan->xs_nskips;
     free_hbucket_idxscan(hp_scan->currBktIdxScan, hp_scan->currBktHeapRel, hp_scan->currBktIdxRel);
 
     hp_scan->curr_slot = 0;
@@ -172,6 +178,8 @@ void hbkt_idx_rescan_bitmap(AbsIdxScanDesc scan, ScanKey keys, int nkeys,
         snapshot, nkeys);
 
     hp_scan->currBktIdxScan->xs_want_itup = true;
+    hp_scan->currBktIdxScan->xs_skip_scan = skip_scan;
+    hp_scan->currBktIdxScan->xs_nskips = nskips;
     index_rescan(hp_scan->currBktIdxScan, keys, nkeys, orderbys, norderbys);
 }
 
@@ -230,6 +238,8 @@ static ItemPointer switch_and_scan_next_idx_hbkt(HBktIdxScanDesc hp_scan, ScanDi
 
         /* Step 4. pass the scankeys to the nextPartScan */
         next_part_scan->xs_want_itup = true;
+        next_part_scan->xs_skip_scan = curr_part_scan->xs_skip_scan;
+        next_part_scan->xs_nskips = curr_part_scan->xs_nskips;
         index_rescan(next_part_scan, curr_part_scan->keyData, curr_part_scan->numberOfKeys,
             curr_part_scan->orderByData, curr_part_scan->numberOfOrderBys);
 
@@ -391,6 +401,8 @@ bool hbkt_idx_bitmapscan_switch_bucket(AbsIdxScanDesc scan, int target_slot)
     /* Step 3. Build a indexBitmapScan */
     part_scan = index_beginscan_bitmap(idx_rel,
         hp_scan->currBktIdxScan->xs_snapshot, index_state->biss_NumScanKeys);
+    part_scan->xs_skip_scan = hp_scan->currBktIdxScan->xs_skip_scan;
+    part_scan->xs_nskips = hp_scan->currBktIdxScan->xs_nskips;
 
     index_rescan(part_scan, hp_scan->currBktIdxScan->keyData, hp_scan->currBktIdxScan->numberOfKeys, NULL, 0);
 
@@ -95,6 +95,8 @@ IndexScanDesc RelationGetIndexScan(Relation index_relation, int nkeys, int norde
         scan->orderByData = NULL;
 
     scan->xs_want_itup = false; /* may be set later */
+    scan->xs_skip_scan = false; /* ditto */
+    scan->xs_nskips = NULL;
 
     /*
      * During recovery we ignore killed tuples and don't bother to kill them
@@ -148,7 +150,7 @@ void IndexScanEnd(IndexScanDesc scan)
 /*
  * BuildIndexValueDescription
  *
- * Construct a string describing the contents of an index entry, in the
+ * Construct a string describing the key columns of an index entry, in the
  * form "(key_name, ...)=(key_value, ...)".  This is currently used
  * for building unique-constraint and exclusion-constraint error messages.
  *
@@ -166,7 +168,7 @@ char* BuildIndexValueDescription(Relation index_relation, Datum* values, const b
     StringInfoData buf;
     Form_pg_index idxrec;
     HeapTuple ht_idx;
-    int natts = index_relation->rd_rel->relnatts;
+    int natts = IndexRelationGetNumberOfKeyAttributes(index_relation);
     int i;
     int keyno;
     Oid indexrelid;
@@ -204,7 +206,7 @@ char* BuildIndexValueDescription(Relation index_relation, Datum* values, const b
          * No table-level access, so step through the columns in the
          * index and make sure the user has SELECT rights on all of them.
          */
-        for (keyno = 0; keyno < idxrec->indnatts; keyno++) {
+        for (keyno = 0; keyno < natts; keyno++) {
             AttrNumber attnum = idxrec->indkey.values[keyno];
             aclresult = pg_attribute_aclcheck(indrelid, attnum, GetUserId(), ACL_SELECT);
             if (aclresult != ACLCHECK_OK) {
@@ -0,0 +1,340 @@
+/* -------------------------------------------------------------------------
+ *
+ * nbtdedup.cpp
+ *	  Deduplicate items in Postgres btrees.
+ *
+ * Leaf tuples whose keys are equal are merged into a single posting list
+ * tuple, which keeps the key once followed by the heap TIDs of all of them.
+ * Only tuples whose key bytes are identical are merged, so no knowledge of
+ * the opclass is needed: equal images are certainly equal keys, and keys
+ * that are equal with different images (numeric scales and the like) are
+ * simply left alone.  See nbtree/README.
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ * Portions Copyright (c) 1996-2012, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/gausskernel/storage/access/nbtree/nbtdedup.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+#include "access/nbtree.h"
+#include "access/xlog.h"
+#include "access/xloginsert.h"
+#include "miscadmin.h"
+#include "storage/proc.h"
+#include "utils/rel.h"
+
+static Size _bt_dedup_keysize(IndexTuple itup);
+static int _bt_dedup_nhtids(IndexTuple itup);
+static int _bt_dedup_tid_cmp(const void* a, const void* b);
+static void _bt_dedup_addtup(Page page, IndexTuple itup, OffsetNumber itup_off);
+static void _bt_rewrite_leaf_page(Relation rel, Buffer buf, Page newpage);
+
+/*
+ * _bt_dedup_enabled() -- may equal keys of the index be merged?
+ *
+ * A unique index holds duplicates only until the old versions are vacuumed
+ * away, and _bt_check_unique wants to see every heap TID on its own, so
+ * deduplication is only done for non-unique indexes.
+ *
+ * A binary older than BTREE_DEDUP_VERSION_NUM can neither read posting lists
+ * nor replay XLOG_BTREE_DEDUP, so none are formed until the upgrade is
+ * committed. Posting lists formed earlier are still read and vacuumed.
+ */
+bool _bt_dedup_enabled(Relation rel)
+{
+    if (t_thrd.proc == NULL || t_thrd.proc->workingVersionNum < BTREE_DEDUP_VERSION_NUM)
+        return false;
+
+    return RelationGetDeduplicateItems(rel) && !rel->rd_index->indisunique;
+}
+
+/*
+ * _bt_dedup_equal() -- are the keys of two leaf tuples binary equal?
+ *
+ * Either tuple may be a posting list tuple, only the part before the heap
+ * TIDs is compared.
+ */
+bool _bt_dedup_equal(IndexTuple itup1, IndexTuple itup2)
+{
+    Size keysize = _bt_dedup_keysize(itup1);
+
+    if (keysize != _bt_dedup_keysize(itup2))
+        return false;
+    if ((itup1->t_info & (INDEX_NULL_MASK | INDEX_VAR_MASK)) != (itup2->t_info & (INDEX_NULL_MASK | INDEX_VAR_MASK)))
+        return false;
+
+    return memcmp((char*)itup1 + sizeof(IndexTupleData),
+               (char*)itup2 + sizeof(IndexTupleData),
+               keysize - sizeof(IndexTupleData)) == 0;
+}
+
+/*
+ * _bt_posting_size() -- size of the tuple holding the key of base and nhtids
+ * heap TIDs.
+ */
+Size _bt_posting_size(IndexTuple base, int nhtids)
+{
+    Size keysize = _bt_dedup_keysize(base);
+
+    Assert(nhtids > 0);
+    if (nhtids == 1)
+        return keysize;
+    return MAXALIGN(keysize + nhtids * sizeof(ItemPointerData));
+}
+
+/*
+ * _bt_form_posting() -- form a tuple with the key of base and the given heap
+ * TIDs, which must be sorted.
+ *
+ * A single TID gives a plain tuple.  The result is palloc'd.
+ */
+IndexTuple _bt_form_posting(IndexTuple base, ItemPointer htids, int nhtids)
+{
+    Size keysize = _bt_dedup_keysize(base);
+    Size newsize = _bt_posting_size(base, nhtids);
+    IndexTuple itup;
+    errno_t rc;
+
+    Assert(newsize <= INDEX_SIZE_MASK);
+
+    itup = (IndexTuple)palloc0(newsize);
+    rc = memcpy_s(itup, newsize, base, keysize);
+    securec_check(rc, "\0", "\0");
+    itup->t_info &= ~(INDEX_SIZE_MASK | INDEX_ALT_TID_MASK);
+    itup->t_info |= newsize;
+
+    if (nhtids == 1) {
+        itup->t_tid = htids[0];
+    } else {
+        BTreeTupleSetPosting(itup, nhtids, keysize);
+        rc = memcpy_s(BTreeTupleGetPosting(itup), newsize - keysize, htids, nhtids * sizeof(ItemPointerData));
+        securec_check(rc, "\0", "\0");
+    }
+
+    return itup;
+}
+
+/*
+ * _bt_dedup_one_page() -- merge the runs of equal keys of a leaf page.
+ *
+ * Called by _bt_findinsertloc when the page has no room left for the new
+ * item, as a cheaper alternative to splitting it.  The caller holds an
+ * exclusive lock on buf.  Items marked LP_DEAD are left alone; the caller
+ * has had the chance to remove them already.
+ *
+ * Returns true if the page was rewritten, in which case any offset the
+ * caller remembered on it is stale.
+ */
+bool _bt_dedup_one_page(Relation rel, Buffer buf)
+{
+    Page page = BufferGetPage(buf);
+    BTPageOpaqueInternal opaque = (BTPageOpaqueInternal)PageGetSpecialPointer(page);
+    OffsetNumber minoff = P_FIRSTDATAKEY(opaque);
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+    Size maxpostingsize = BTMaxPostingSize(page);
+    OffsetNumber offnum;
+    OffsetNumber newoff = minoff;
+    IndexTuple base = NULL;
+    ItemPointer htids = NULL;
+    int nhtids = 0;
+    int ngroup = 0;
+    bool merged = false;
+    Page newpage;
+
+    Assert(P_ISLEAF(opaque));
+
+    if (maxoff <= minoff)
+        return false;
+
+    newpage = PageGetTempPageCopySpecial(page, true);
+    PageSetLSN(newpage, PageGetLSN(page));
+
+    if (!P_RIGHTMOST(opaque)) {
+        ItemId hitemid = PageGetItemId(page, P_HIKEY);
+
+        _bt_dedup_addtup(newpage, (IndexTuple)PageGetItem(page, hitemid), P_HIKEY);
+    }
+
+    htids = (ItemPointer)palloc(MaxTIDsPerBTreePage * sizeof(ItemPointerData));
+
+    for (offnum = minoff; offnum <= maxoff + 1; offnum = OffsetNumberNext(offnum)) {
+        ItemId itemid = NULL;
+        IndexTuple itup = NULL;
+        int itupnhtids = 0;
+
+        if (offnum <= maxoff) {
+            itemid = PageGetItemId(page, offnum);
+            itup = (IndexTuple)PageGetItem(page, itemid);
+            itupnhtids = _bt_dedup_nhtids(itup);
+
+            /* extend the current group when the key is the same and it still fits */
+            if (base != NULL && !ItemIdIsDead(itemid) && _bt_dedup_equal(base, itup) &&
+                _bt_posting_size(base, nhtids + itupnhtids) <= maxpostingsize) {
+                if (BTreeTupleIsPosting(itup)) {
+                    errno_t rc = memcpy_s(htids + nhtids, (MaxTIDsPerBTreePage - nhtids) * sizeof(ItemPointerData),
+                        BTreeTupleGetPosting(itup), itupnhtids * sizeof(ItemPointerData));
+                    securec_check(rc, "\0", "\0");
+                } else {
+                    htids[nhtids] = itup->t_tid;
+                }
+                nhtids += itupnhtids;
+                ngroup++;
+                continue;
+            }
+        }
+
+        /* the current group is complete, put it on the new page */
+        if (base != NULL) {
+            if (ngroup == 1) {
+                _bt_dedup_addtup(newpage, base, newoff);
+            } else {
+                IndexTuple posting;
+
+                qsort(htids, nhtids, sizeof(ItemPointerData), _bt_dedup_tid_cmp);
+                posting = _bt_form_posting(base, htids, nhtids);
+                _bt_dedup_addtup(newpage, posting, newoff);
+                pfree(posting);
+                merged = true;
+            }
+            newoff = OffsetNumberNext(newoff);
+            base = NULL;
+        }
+
+        if (itup == NULL)
+            break;
+
+        if (ItemIdIsDead(itemid) || _bt_posting_size(itup, itupnhtids + 1) > maxpostingsize) {
+            /* cannot take any duplicates, copy it as it is */
+            _bt_dedup_addtup(newpage, itup, newoff);
+            newoff = OffsetNumberNext(newoff);
+            continue;
+        }
+
+        /* start a new group */
+        base = itup;
+        ngroup = 1;
+        if (BTreeTupleIsPosting(itup)) {
+            errno_t rc = memcpy_s(htids, MaxTIDsPerBTreePage * sizeof(ItemPointerData),
+                BTreeTupleGetPosting(itup), itupnhtids * sizeof(ItemPointerData));
+            securec_check(rc, "\0", "\0");
+        } else {
+            htids[0] = itup->t_tid;
+        }
+        nhtids = itupnhtids;
+    }
+
+    pfree(htids);
+
+    if (!merged) {
+        pfree(newpage);
+        return false;
+    }
+
+    _bt_rewrite_leaf_page(rel, buf, newpage);
+    return true;
+}
+
+/*
+ * _bt_update_posting_items() -- replace posting list tuples of a leaf page.
+ *
+ * Used by VACUUM when only some of the heap TIDs of a posting list tuple are
+ * dead; newitems[i] replaces the item at updatable[i].  Every item keeps its
+ * offset, so that the caller can go on to delete other items by offset.  The
+ * caller holds a cleanup lock on buf.
+ */
+void _bt_update_posting_items(
+    Relation rel, Buffer buf, const OffsetNumber* updatable, IndexTuple* newitems, int nupdatable)
+{
+    Page page = BufferGetPage(buf);
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+    OffsetNumber offnum;
+    Page newpage;
+    int i = 0;
+
+    Assert(nupdatable > 0);
+
+    newpage = PageGetTempPageCopySpecial(page, true);
+    PageSetLSN(newpage, PageGetLSN(page));
+
+    for (offnum = FirstOffsetNumber; offnum <= maxoff; offnum = OffsetNumberNext(offnum)) {
+        if (i < nupdatable && updatable[i] == offnum) {
+            _bt_dedup_addtup(newpage, newitems[i], offnum);
+            i++;
+        } else {
+            _bt_dedup_addtup(newpage, (IndexTuple)PageGetItem(page, PageGetItemId(page, offnum)), offnum);
+        }
+    }
+    Assert(i == nupdatable);
+
+    _bt_rewrite_leaf_page(rel, buf, newpage);
+}
+
+/*
+ * Size of the part of a tuple that comes before its posting list, which is
+ * the whole tuple for a plain one.
+ */
+static Size _bt_dedup_keysize(IndexTuple itup)
+{
+    if (BTreeTupleIsPosting(itup))
+        return BTreeTupleGetPostingOffset(itup);
+    return IndexTupleSize(itup);
+}
+
+static int _bt_dedup_nhtids(IndexTuple itup)
+{
+    if (BTreeTupleIsPosting(itup))
+        return BTreeTupleGetNPosting(itup);
+    return 1;
+}
+
+static int _bt_dedup_tid_cmp(const void* a, const void* b)
+{
+    return ItemPointerCompare((ItemPointer)a, (ItemPointer)b);
+}
+
+static void _bt_dedup_addtup(Page page, IndexTuple itup, OffsetNumber itup_off)
+{
+    Size itemsz = MAXALIGN(IndexTupleSize(itup));
+
+    if (PageAddItem(page, (Item)itup, itemsz, itup_off, false, false) == InvalidOffsetNumber)
+        ereport(ERROR,
+            (errcode(ERRCODE_INDEX_CORRUPTED), errmsg("failed to add item to the deduplicated index page")));
+}
+
+/*
+ * Copy the rebuilt newpage over the leaf page in buf and WAL-log it.  The
+ * record carries the tuples of the page the way _bt_split logs the right
+ * half of a split, so that redo rebuilds the same page.
+ */
+static void _bt_rewrite_leaf_page(Relation rel, Buffer buf, Page newpage)
+{
+    Page page = BufferGetPage(buf);
+
+    /* No ereport(ERROR) until changes are logged */
+    START_CRIT_SECTION();
+
+    PageRestoreTempPage(newpage, page);
+    MarkBufferDirty(buf);
+
+    /* XLOG stuff */
+    if (RelationNeedsWAL(rel)) {
+        XLogRecPtr recptr;
+
+        XLogBeginInsert();
+        XLogRegisterBuffer(0, buf, REGBUF_STANDARD);
+        XLogRegisterBufData(0, (char*)page + ((PageHeader)page)->pd_upper,
+            ((PageHeader)page)->pd_special - ((PageHeader)page)->pd_upper);
+
+        recptr = XLogInsert(RM_BTREE_ID, XLOG_BTREE_DEDUP);
+
+        PageSetLSN(page, recptr);
+    }
+
+    END_CRIT_SECTION();
+}
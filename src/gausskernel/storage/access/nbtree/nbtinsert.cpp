@@ -88,7 +88,7 @@ static void _bt_insert_parent(Relation rel, Buffer buf, Buffer rbuf, BTStack sta
 bool _bt_doinsert(Relation rel, IndexTuple itup, IndexUniqueCheck checkUnique, Relation heapRel)
 {
     bool is_unique = false;
-    int natts = rel->rd_rel->relnatts;
+    int natts = IndexRelationGetNumberOfKeyAttributes(rel);
     ScanKey itup_scankey;
     BTStack stack;
     Buffer buf;
@@ -197,7 +197,7 @@ static TransactionId _bt_check_unique(Relation rel, IndexTuple itup, Relation he
     ScanKey itup_scankey, IndexUniqueCheck checkUnique, bool* is_unique)
 {
     TupleDesc itupdesc = RelationGetDescr(rel);
-    int natts = rel->rd_rel->relnatts;
+    int natts = IndexRelationGetNumberOfKeyAttributes(rel);
     SnapshotData SnapshotDirty;
     OffsetNumber maxoff;
     Page page;
@@ -581,6 +581,16 @@ static void _bt_findinsertloc(Relation rel, Buffer* bufptr, OffsetNumber* offset
         vacuumed = false;
     }
 
+    /*
+     * If there is still not enough room, merge the duplicates of the page
+     * into posting lists before resorting to a split.  That moves tuples
+     * around too, so the hint is invalid afterwards.
+     */
+    if (PageGetFreeSpace(page) < itemsz && P_ISLEAF(lpageop) && _bt_dedup_enabled(rel)) {
+        if (_bt_dedup_one_page(rel, buf))
+            vacuumed = true;
+    }
+
     /*
      * Now we are on the right page, so find the insert position. If we moved
      * right at all, we know we should insert at the start of the page. If we
@@ -836,6 +846,7 @@ static Buffer _bt_split(Relation rel, Buffer buf, Buffer cbuf, OffsetNumber firs
     Size itemsz;
     ItemId itemid;
     IndexTuple item;
+    IndexTuple lefthikey;
     OffsetNumber leftoff, rightoff;
     OffsetNumber maxoff;
     OffsetNumber i;
@@ -937,7 +948,20 @@ static Buffer _bt_split(Relation rel, Buffer buf, Buffer cbuf, OffsetNumber firs
         itemsz = ItemIdGetLength(itemid);
         item = (IndexTuple)PageGetItem(origpage, itemid);
     }
-    if (PageAddItem(leftpage, (Item)item, itemsz, leftoff, false, false) == InvalidOffsetNumber) {
+
+    /*
+     * A leaf high key only has to separate the key columns, so the included
+     * columns and any posting list are cut off.  The downlink to the right
+     * page is copied from it, hence the parent levels never store them either.
+     */
+    if (isleaf && (IndexRelationGetNumberOfKeyAttributes(rel) < IndexRelationGetNumberOfAttributes(rel) ||
+                      BTreeTupleIsPosting(item))) {
+        lefthikey = _bt_pivot_tuple(rel, item);
+        itemsz = MAXALIGN(IndexTupleSize(lefthikey));
+    } else {
+        lefthikey = item;
+    }
+    if (PageAddItem(leftpage, (Item)lefthikey, itemsz, leftoff, false, false) == InvalidOffsetNumber) {
         rc = memset_s(rightpage, BLCKSZ, 0, BufferGetPageSize(rbuf));
         securec_check(rc, "", "");
         ereport(ERROR,
@@ -947,6 +971,8 @@ static Buffer _bt_split(Relation rel, Buffer buf, Buffer cbuf, OffsetNumber firs
                     RelationGetRelationName(rel))));
     }
     leftoff = OffsetNumberNext(leftoff);
+    if (lefthikey != item)
+        pfree(lefthikey);
 
     /*
      * Now transfer all the data items to the appropriate page.
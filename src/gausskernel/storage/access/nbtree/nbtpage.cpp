@@ -973,7 +973,7 @@ int _bt_pagedel(Relation rel, Buffer buf, BTStack stack)
             /* we need an insertion scan key to do our search, so build one */
             itup_scankey = _bt_mkscankey(rel, targetkey);
             /* find the leftmost leaf page containing this key */
-            stack = _bt_search(rel, rel->rd_rel->relnatts, itup_scankey, false, &lbuf, BT_READ);
+            stack = _bt_search(rel, IndexRelationGetNumberOfKeyAttributes(rel), itup_scankey, false, &lbuf, BT_READ);
             /* don't need a pin on that either */
             _bt_relbuf(rel, lbuf);
 
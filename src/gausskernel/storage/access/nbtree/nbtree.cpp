@@ -48,8 +48,6 @@ typedef struct {
     MemoryContext pagedelcontext;
 } BTVacState;
 
-static void btbuildCallback(
-    Relation index, HeapTuple htup, Datum* values, const bool* isnull, bool tupleIsAlive, void* state);
 static void btvacuumscan(IndexVacuumInfo* info, IndexBulkDeleteResult* stats, IndexBulkDeleteCallback callback,
     void* callback_state, BTCycleId cycleid);
 static void btvacuumpage(BTVacState* vstate, BlockNumber blkno, BlockNumber orig_blkno);
@@ -66,6 +64,7 @@ Datum btbuild(PG_FUNCTION_ARGS)
     IndexBuildResult* result = NULL;
     double reltuples;
     BTBuildState buildstate;
+    int nworkers;
 
     buildstate.isUnique = indexInfo->ii_Unique;
     buildstate.haveDead = false;
@@ -88,33 +87,39 @@ Datum btbuild(PG_FUNCTION_ARGS)
                 errmsg("index \"%s\" already contains data", RelationGetRelationName(index))));
     }
 
-    // If building a unique index, put dead tuples in a second spool to keep
-    // them out of the uniqueness check.
-    if (indexInfo->ii_Unique) {
-        buildstate.spool2 = _bt_spoolinit(index, false, true, &indexInfo->ii_desc);
-    }
+    /* let worker threads scan and sort parts of a large heap */
+    nworkers = _bt_parallel_build_workers(heap, index, indexInfo);
+    if (nworkers > 0) {
+        reltuples = _bt_parallel_build(heap, index, indexInfo, nworkers, &buildstate);
+    } else {
+        // If building a unique index, put dead tuples in a second spool to keep
+        // them out of the uniqueness check.
+        if (indexInfo->ii_Unique) {
+            buildstate.spool2 = _bt_spoolinit(index, false, true, &indexInfo->ii_desc);
+        }
 
-    buildstate.spool = _bt_spoolinit(index, indexInfo->ii_Unique, false, &indexInfo->ii_desc);
+        buildstate.spool = _bt_spoolinit(index, indexInfo->ii_Unique, false, &indexInfo->ii_desc);
 
-    /* do the heap scan */
-    reltuples = IndexBuildHeapScan(heap, index, indexInfo, true, btbuildCallback, (void*)&buildstate);
+        /* do the heap scan */
+        reltuples = IndexBuildHeapScan(heap, index, indexInfo, true, btbuildCallback, (void*)&buildstate);
 
-    /* okay, all heap tuples are indexed */
-    if (buildstate.spool2 && !buildstate.haveDead) {
-        /* spool2 turns out to be unnecessary */
-        _bt_spooldestroy(buildstate.spool2);
-        buildstate.spool2 = NULL;
-    }
+        /* okay, all heap tuples are indexed */
+        if (buildstate.spool2 && !buildstate.haveDead) {
+            /* spool2 turns out to be unnecessary */
+            _bt_spooldestroy(buildstate.spool2);
+            buildstate.spool2 = NULL;
+        }
 
-    /*
-     * Finish the build by (1) completing the sort of the spool file, (2)
-     * inserting the sorted tuples into btree pages and (3) building the upper
-     * levels.
-     */
-    _bt_leafbuild(buildstate.spool, buildstate.spool2);
-    _bt_spooldestroy(buildstate.spool);
-    if (buildstate.spool2) {
-        _bt_spooldestroy(buildstate.spool2);
+        /*
+         * Finish the build by (1) completing the sort of the spool file, (2)
+         * inserting the sorted tuples into btree pages and (3) building the upper
+         * levels.
+         */
+        _bt_leafbuild(buildstate.spool, buildstate.spool2);
+        _bt_spooldestroy(buildstate.spool);
+        if (buildstate.spool2) {
+            _bt_spooldestroy(buildstate.spool2);
+        }
     }
 
 #ifdef BTREE_BUILD_STATS
@@ -136,7 +141,11 @@ Datum btbuild(PG_FUNCTION_ARGS)
 /*
  * Per-tuple callback from IndexBuildHeapScan
  */
-static void btbuildCallback(
+/*
+ * Per-tuple callback from IndexBuildHeapScan, also used by the participants
+ * of a parallel build.
+ */
+void btbuildCallback(
     Relation index, HeapTuple htup, Datum* values, const bool* isnull, bool tupleIsAlive, void* state)
 {
     BTBuildState* buildstate = (BTBuildState*)state;
@@ -268,15 +277,14 @@ Datum btgetbitmap(PG_FUNCTION_ARGS)
     ItemPointer heapTid;
 
     /*
-     * If we have any array keys, initialize them.
+     * If we have any array keys or skip over the leading column, initialize
+     * them.
      */
-    if (so->numArrayKeys) {
-        /* punt if we have any unsatisfiable array keys */
-        if (so->numArrayKeys < 0) {
+    if (so->numArrayKeys || so->skipScan) {
+        /* punt if we have any unsatisfiable array keys, or an empty index */
+        if (so->numArrayKeys < 0 || !_bt_start_array_keys(scan, ForwardScanDirection)) {
             PG_RETURN_INT64(ntids);
         }
-
-        _bt_start_array_keys(scan, ForwardScanDirection);
     }
 
     /* This loop handles advancing to the next array elements, if any */
@@ -307,7 +315,7 @@ Datum btgetbitmap(PG_FUNCTION_ARGS)
             }
         }
         /* Now see if we have more array keys to deal with */
-    } while (so->numArrayKeys && _bt_advance_array_keys(scan, ForwardScanDirection));
+    } while ((so->numArrayKeys || so->skipScan) && _bt_advance_array_keys(scan, ForwardScanDirection));
 
     PG_RETURN_INT64(ntids);
 }
@@ -394,7 +402,8 @@ Datum btbeginscan(PG_FUNCTION_ARGS)
     so = (BTScanOpaque)palloc(sizeof(BTScanOpaqueData));
     so->currPos.buf = so->markPos.buf = InvalidBuffer;
     if (scan->numberOfKeys > 0) {
-        so->keyData = (ScanKey)palloc(scan->numberOfKeys * sizeof(ScanKeyData));
+        /* one extra slot for the leading column key of a skip scan */
+        so->keyData = (ScanKey)palloc((scan->numberOfKeys + 1) * sizeof(ScanKeyData));
     } else {
         so->keyData = NULL;
     }
@@ -403,6 +412,9 @@ Datum btbeginscan(PG_FUNCTION_ARGS)
     so->numArrayKeys = 0;
     so->arrayKeys = NULL;
     so->arrayContext = NULL;
+    so->skipScan = false;
+    so->skipHaveValue = false;
+    so->markSkipValid = false;
     so->killedItems = NULL; /* until needed */
     so->numKilled = 0;
 
@@ -552,7 +564,7 @@ Datum btmarkpos(PG_FUNCTION_ARGS)
     }
 
     /* Also record the current positions of any array keys */
-    if (so->numArrayKeys) {
+    if (so->numArrayKeys || so->skipScan) {
         _bt_mark_array_keys(scan);
     }
 
@@ -568,7 +580,7 @@ Datum btrestrpos(PG_FUNCTION_ARGS)
     BTScanOpaque so = (BTScanOpaque)scan->opaque;
 
     /* Restore the marked positions of any array keys */
-    if (so->numArrayKeys) {
+    if (so->numArrayKeys || so->skipScan) {
         _bt_restore_array_keys(scan);
     }
 
@@ -881,6 +893,10 @@ restart:
     } else if (P_ISLEAF(opaque)) {
         OffsetNumber deletable[MaxOffsetNumber];
         int ndeletable;
+        OffsetNumber updatable[MaxOffsetNumber];
+        IndexTuple* updated = NULL;
+        int nupdatable;
+        double ntidsremoved;
         OffsetNumber offnum, minoff, maxoff;
 
         /*
@@ -917,12 +933,13 @@ restart:
          * callback function.
          */
         ndeletable = 0;
+        nupdatable = 0;
+        ntidsremoved = 0;
         minoff = P_FIRSTDATAKEY(opaque);
         maxoff = PageGetMaxOffsetNumber(page);
         if (callback) {
             for (offnum = minoff; offnum <= maxoff; offnum = OffsetNumberNext(offnum)) {
                 IndexTuple itup = (IndexTuple)PageGetItem(page, PageGetItemId(page, offnum));
-                ItemPointer htup = &(itup->t_tid);
 
                 /*
                  * During Hot Standby we currently assume that
@@ -945,17 +962,61 @@ restart:
                  * applies to *any* type of index that marks index tuples as
                  * killed.
                  */
-                if (callback(htup, callback_state)) {
-                    deletable[ndeletable++] = offnum;
+                if (!BTreeTupleIsPosting(itup)) {
+                    if (callback(&itup->t_tid, callback_state)) {
+                        deletable[ndeletable++] = offnum;
+                        ntidsremoved++;
+                    }
+                } else {
+                    /*
+                     * A posting list goes away once all of its heap TIDs are
+                     * dead, and is replaced by one of the live ones if only
+                     * some of them are.
+                     */
+                    ItemPointerData livetids[MaxTIDsPerBTreePage];
+                    int nposting = BTreeTupleGetNPosting(itup);
+                    int nlive = 0;
+
+                    for (int i = 0; i < nposting; i++) {
+                        ItemPointer htup = BTreeTupleGetPostingN(itup, i);
+
+                        if (!callback(htup, callback_state))
+                            livetids[nlive++] = *htup;
+                    }
+
+                    if (nlive == 0) {
+                        deletable[ndeletable++] = offnum;
+                    } else if (nlive < nposting) {
+                        if (updated == NULL)
+                            updated = (IndexTuple*)palloc(MaxOffsetNumber * sizeof(IndexTuple));
+                        updatable[nupdatable] = offnum;
+                        updated[nupdatable++] = _bt_form_posting(itup, livetids, nlive);
+                    }
+                    ntidsremoved += nposting - nlive;
                 }
             }
         }
 
+        /*
+         * Posting lists that lost some of their heap TIDs are rewritten in
+         * place first; the offsets of the deletable items stay valid.
+         */
+        if (nupdatable > 0) {
+            _bt_update_posting_items(rel, buf, updatable, updated, nupdatable);
+            opaque = (BTPageOpaqueInternal)PageGetSpecialPointer(page);
+            for (int i = 0; i < nupdatable; i++)
+                pfree(updated[i]);
+        }
+        if (updated != NULL)
+            pfree(updated);
+
         /*
          * Apply any needed deletes.  We issue just one _bt_delitems_vacuum()
-         * call per page, so as to minimize WAL traffic.
+         * call per page, so as to minimize WAL traffic.  It is issued after
+         * posting list updates even if nothing is left to delete, so that
+         * replay takes the cleanup lock the updates need.
          */
-        if (ndeletable > 0) {
+        if (ndeletable > 0 || nupdatable > 0) {
             /*
              * Notice that the issued XLOG_BTREE_VACUUM WAL record includes an
              * instruction to the replay code to get cleanup lock on all pages
@@ -977,7 +1038,7 @@ restart:
                 vstate->lastBlockVacuumed = blkno;
             }
 
-            stats->tuples_removed += ndeletable;
+            stats->tuples_removed += ntidsremoved;
             /* must recompute maxoff */
             maxoff = PageGetMaxOffsetNumber(page);
         } else {
@@ -1004,7 +1065,11 @@ restart:
         if (minoff > maxoff) {
             delete_now = (blkno == orig_blkno);
         } else {
-            stats->num_index_tuples += maxoff - minoff + 1;
+            for (offnum = minoff; offnum <= maxoff; offnum = OffsetNumberNext(offnum)) {
+                IndexTuple itup = (IndexTuple)PageGetItem(page, PageGetItemId(page, offnum));
+
+                stats->num_index_tuples += BTreeTupleIsPosting(itup) ? BTreeTupleGetNPosting(itup) : 1;
+            }
         }
     }
 
@@ -1067,7 +1132,7 @@ Datum btmerge(PG_FUNCTION_ARGS)
     IndexScanDesc srcIdxRelScan = NULL;
     BTOrderedIndexListElement* ele = NULL;
     TupleDesc tupdes = RelationGetDescr(dstIdxRel);
-    int keysz = RelationGetNumberOfAttributes(dstIdxRel);
+    int keysz = IndexRelationGetNumberOfKeyAttributes(dstIdxRel);
     ScanKey indexScanKey = _bt_mkscankey_nodata(dstIdxRel);
     BTWriteState wstate;
     BTPageState* state = NULL;
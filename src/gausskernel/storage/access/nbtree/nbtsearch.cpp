@@ -31,6 +31,10 @@
 
 static bool _bt_readpage(IndexScanDesc scan, ScanDirection dir, OffsetNumber offnum);
 static void _bt_saveitem(BTScanOpaque so, int itemIndex, OffsetNumber offnum, IndexTuple itup);
+static int _bt_setuppostingitems(
+    BTScanOpaque so, int itemIndex, OffsetNumber offnum, ItemPointer heapTid, IndexTuple itup);
+static void _bt_savepostingitem(
+    BTScanOpaque so, int itemIndex, OffsetNumber offnum, ItemPointer heapTid, int tupleOffset);
 static bool _bt_steppage(IndexScanDesc scan, ScanDirection dir);
 static Buffer _bt_walk_left(Relation rel, Buffer buf);
 static bool _bt_endpoint(IndexScanDesc scan, ScanDirection dir);
@@ -940,8 +944,11 @@ bool _bt_first(IndexScanDesc scan, ScanDirection dir)
     /* OK, itemIndex says what to return */
     currItem = &so->currPos.items[so->currPos.itemIndex];
     scan->xs_ctup.t_self = currItem->heapTid;
-    if (scan->xs_want_itup)
+    if (scan->xs_want_itup) {
         scan->xs_itup = (IndexTuple)(so->currTuples + currItem->tupleOffset);
+        /* the items of a posting list share one copy of the tuple */
+        scan->xs_itup->t_tid = currItem->heapTid;
+    }
 
     return true;
 }
@@ -994,8 +1001,11 @@ bool _bt_next(IndexScanDesc scan, ScanDirection dir)
     /* OK, itemIndex says what to return */
     currItem = &so->currPos.items[so->currPos.itemIndex];
     scan->xs_ctup.t_self = currItem->heapTid;
-    if (scan->xs_want_itup)
+    if (scan->xs_want_itup) {
         scan->xs_itup = (IndexTuple)(so->currTuples + currItem->tupleOffset);
+        /* the items of a posting list share one copy of the tuple */
+        scan->xs_itup->t_tid = currItem->heapTid;
+    }
 
     return true;
 }
@@ -1056,10 +1066,20 @@ static bool _bt_readpage(IndexScanDesc scan, ScanDirection dir, OffsetNumber off
 
         while (offnum <= maxoff) {
             itup = _bt_checkkeys(scan, page, offnum, dir, &continuescan);
-            if (itup != NULL) {
+            if (itup != NULL && !BTreeTupleIsPosting(itup)) {
                 /* tuple passes all scan key conditions, so remember it */
                 _bt_saveitem(so, itemIndex, offnum, itup);
                 itemIndex++;
+            } else if (itup != NULL) {
+                /* remember every heap TID of a posting list, in order */
+                int nposting = BTreeTupleGetNPosting(itup);
+                int tupleOffset = _bt_setuppostingitems(so, itemIndex, offnum, BTreeTupleGetPosting(itup), itup);
+
+                itemIndex++;
+                for (int i = 1; i < nposting; i++) {
+                    _bt_savepostingitem(so, itemIndex, offnum, BTreeTupleGetPostingN(itup, i), tupleOffset);
+                    itemIndex++;
+                }
             }
             if (!continuescan) {
                 /* there can't be any more matches, so stop */
@@ -1070,22 +1090,34 @@ static bool _bt_readpage(IndexScanDesc scan, ScanDirection dir, OffsetNumber off
             offnum = OffsetNumberNext(offnum);
         }
 
-        Assert(itemIndex <= MaxIndexTuplesPerPage);
+        Assert(itemIndex <= MaxTIDsPerBTreePage);
         so->currPos.firstItem = 0;
         so->currPos.lastItem = itemIndex - 1;
         so->currPos.itemIndex = 0;
     } else {
         /* load items[] in descending order */
-        itemIndex = MaxIndexTuplesPerPage;
+        itemIndex = MaxTIDsPerBTreePage;
 
         offnum = Min(offnum, maxoff);
 
         while (offnum >= minoff) {
             itup = _bt_checkkeys(scan, page, offnum, dir, &continuescan);
-            if (itup != NULL) {
+            if (itup != NULL && !BTreeTupleIsPosting(itup)) {
                 /* tuple passes all scan key conditions, so remember it */
                 itemIndex--;
                 _bt_saveitem(so, itemIndex, offnum, itup);
+            } else if (itup != NULL) {
+                /* the items[] stay in ascending TID order within a posting list */
+                int nposting = BTreeTupleGetNPosting(itup);
+                int tupleOffset;
+
+                itemIndex--;
+                tupleOffset = _bt_setuppostingitems(
+                    so, itemIndex, offnum, BTreeTupleGetPostingN(itup, nposting - 1), itup);
+                for (int i = nposting - 2; i >= 0; i--) {
+                    itemIndex--;
+                    _bt_savepostingitem(so, itemIndex, offnum, BTreeTupleGetPostingN(itup, i), tupleOffset);
+                }
             }
             if (!continuescan) {
                 /* there can't be any more matches, so stop */
@@ -1098,8 +1130,8 @@ static bool _bt_readpage(IndexScanDesc scan, ScanDirection dir, OffsetNumber off
 
         Assert(itemIndex >= 0);
         so->currPos.firstItem = itemIndex;
-        so->currPos.lastItem = MaxIndexTuplesPerPage - 1;
-        so->currPos.itemIndex = MaxIndexTuplesPerPage - 1;
+        so->currPos.lastItem = MaxTIDsPerBTreePage - 1;
+        so->currPos.itemIndex = MaxTIDsPerBTreePage - 1;
     }
 
     gstrace_exit(GS_TRC_ID__bt_readpage);
@@ -1123,6 +1155,48 @@ static void _bt_saveitem(BTScanOpaque so, int itemIndex, OffsetNumber offnum, co
     }
 }
 
+/*
+ * Save the first heap TID of a posting list tuple into
+ * so->currPos.items[itemIndex], along with a copy of the tuple without its
+ * posting list, which the items of the other heap TIDs share.  Returns the
+ * offset of that copy in the workspace.
+ */
+static int _bt_setuppostingitems(
+    BTScanOpaque so, int itemIndex, OffsetNumber offnum, ItemPointer heapTid, IndexTuple itup)
+{
+    BTScanPosItem* currItem = &so->currPos.items[itemIndex];
+
+    currItem->heapTid = *heapTid;
+    currItem->indexOffset = offnum;
+    if (so->currTuples) {
+        Size itupsz = BTreeTupleGetPostingOffset(itup);
+        IndexTuple base = (IndexTuple)(so->currTuples + so->currPos.nextTupleOffset);
+
+        currItem->tupleOffset = (uint16)so->currPos.nextTupleOffset;
+        errno_t rc = memcpy_s(base, itupsz, itup, itupsz);
+        securec_check(rc, "", "");
+        base->t_info &= ~(INDEX_SIZE_MASK | INDEX_ALT_TID_MASK);
+        base->t_info |= itupsz;
+        base->t_tid = *heapTid;
+        so->currPos.nextTupleOffset += MAXALIGN(itupsz);
+        return currItem->tupleOffset;
+    }
+
+    return 0;
+}
+
+/* Save another heap TID of a posting list tuple into so->currPos.items[itemIndex] */
+static void _bt_savepostingitem(
+    BTScanOpaque so, int itemIndex, OffsetNumber offnum, ItemPointer heapTid, int tupleOffset)
+{
+    BTScanPosItem* currItem = &so->currPos.items[itemIndex];
+
+    currItem->heapTid = *heapTid;
+    currItem->indexOffset = offnum;
+    if (so->currTuples)
+        currItem->tupleOffset = (uint16)tupleOffset;
+}
+
 /*
  *	_bt_steppage() -- Step to next page containing valid data for scan
  *
@@ -1441,6 +1515,110 @@ Buffer _bt_get_endpoint(Relation rel, uint32 level, bool rightmost)
     return buf;
 }
 
+/*
+ *	_bt_skip_advance() -- Move a skip scan to the next leading column value
+ *
+ * Descends the tree to the first index entry whose leading column is beyond
+ * the skip key's current value in the scan direction (or to the first entry
+ * of the index, if the skip key has no value yet), and makes that entry's
+ * leading column value the new skip key value.  This costs one descent per
+ * distinct leading value, which beats reading every entry in between when
+ * the leading column has few distinct values.
+ *
+ * Returns false if there is no further value in the given direction.
+ */
+bool _bt_skip_advance(IndexScanDesc scan, ScanDirection dir)
+{
+    Relation rel = scan->indexRelation;
+    BTScanOpaque so = (BTScanOpaque)scan->opaque;
+    ScanKey skey = &so->arrayKeyData[0];
+    Buffer buf;
+    Page page;
+    BTPageOpaqueInternal opaque;
+    OffsetNumber offnum;
+    IndexTuple itup;
+    Datum value;
+    bool isnull = false;
+
+    Assert(so->skipScan);
+
+    if (!so->skipHaveValue) {
+        buf = _bt_get_endpoint(rel, 0, ScanDirectionIsBackward(dir));
+        if (!BufferIsValid(buf)) {
+            /* the index is completely empty */
+            PredicateLockRelation(rel, scan->xs_snapshot);
+            return false;
+        }
+        page = BufferGetPage(buf);
+        opaque = (BTPageOpaqueInternal)PageGetSpecialPointer(page);
+        offnum = ScanDirectionIsForward(dir) ? P_FIRSTDATAKEY(opaque) : PageGetMaxOffsetNumber(page);
+    } else {
+        ScanKeyData probe;
+        int flags = (uint16)(rel->rd_indoption[0]) << SK_BT_INDOPTION_SHIFT;
+
+        if (skey->sk_flags & SK_ISNULL) {
+            flags |= SK_ISNULL;
+        }
+        ScanKeyEntryInitializeWithInfo(&probe,
+            flags,
+            1,
+            InvalidStrategy,
+            InvalidOid,
+            rel->rd_indcollation[0],
+            index_getprocinfo(rel, 1, BTORDER_PROC),
+            skey->sk_argument);
+
+        /*
+         * Going forward we want the first entry > the current value; going
+         * backward, the entry just before the first one >= it.
+         */
+        (void)_bt_search(rel, 1, &probe, ScanDirectionIsForward(dir), &buf, BT_READ, false);
+        if (!BufferIsValid(buf)) {
+            PredicateLockRelation(rel, scan->xs_snapshot);
+            return false;
+        }
+        offnum = _bt_binsrch(rel, buf, 1, &probe, ScanDirectionIsForward(dir));
+        if (ScanDirectionIsBackward(dir)) {
+            offnum = OffsetNumberPrev(offnum);
+        }
+    }
+
+    /* Step over page boundaries and dead or empty pages as needed */
+    for (;;) {
+        page = BufferGetPage(buf);
+        opaque = (BTPageOpaqueInternal)PageGetSpecialPointer(page);
+        if (!P_IGNORE(opaque) && offnum >= P_FIRSTDATAKEY(opaque) && offnum <= PageGetMaxOffsetNumber(page)) {
+            break;
+        }
+
+        if (ScanDirectionIsForward(dir)) {
+            if (P_RIGHTMOST(opaque)) {
+                _bt_relbuf(rel, buf);
+                return false;
+            }
+            buf = _bt_relandgetbuf(rel, buf, opaque->btpo_next, BT_READ);
+            offnum = P_FIRSTDATAKEY((BTPageOpaqueInternal)PageGetSpecialPointer(BufferGetPage(buf)));
+        } else {
+            buf = _bt_walk_left(rel, buf);
+            if (!BufferIsValid(buf)) {
+                return false;
+            }
+            offnum = PageGetMaxOffsetNumber(BufferGetPage(buf));
+        }
+    }
+
+    PredicateLockPage(rel, BufferGetBlockNumber(buf), scan->xs_snapshot);
+    itup = (IndexTuple)PageGetItem(page, PageGetItemId(page, offnum));
+    value = index_getattr(itup, 1, RelationGetDescr(rel), &isnull);
+    if (so->skipHaveValue && scan->xs_nskips != NULL) {
+        (*scan->xs_nskips)++;
+    }
+    _bt_set_skip_key(scan, value, isnull);
+    _bt_relbuf(rel, buf);
+
+    return true;
+}
+
 /*
  *	_bt_endpoint() -- Find the first or last page in the index, and scan
  * from there to the first key satisfying all the quals.
@@ -1525,8 +1703,11 @@ static bool _bt_endpoint(IndexScanDesc scan, ScanDirection dir)
     /* OK, itemIndex says what to return */
     currItem = &so->currPos.items[so->currPos.itemIndex];
     scan->xs_ctup.t_self = currItem->heapTid;
-    if (scan->xs_want_itup)
+    if (scan->xs_want_itup) {
         scan->xs_itup = (IndexTuple)(so->currTuples + currItem->tupleOffset);
+        /* the items of a posting list share one copy of the tuple */
+        scan->xs_itup->t_tid = currItem->heapTid;
+    }
 
     return true;
 }
@@ -1540,17 +1721,20 @@ bool _bt_gettuple_internal(IndexScanDesc scan, ScanDirection dir)
     scan->xs_recheck = false;
 
     /*
-     * If we have any array keys, initialize them during first call for a
-     * scan.  We can't do this in btrescan because we don't know the scan
-     * direction at that time.
+     * If we have any array keys or skip over the leading column, initialize
+     * them during first call for a scan.  We can't do this in btrescan
+     * because we don't know the scan direction at that time.
      */
-    if (so->numArrayKeys && !BTScanPosIsValid(so->currPos)) {
+    if ((so->numArrayKeys || so->skipScan) && !BTScanPosIsValid(so->currPos)) {
         /* punt if we have any unsatisfiable array keys */
         if (so->numArrayKeys < 0) {
             return false;
         }
 
-        _bt_start_array_keys(scan, dir);
+        /* ... or if a skip scan finds the index empty */
+        if (!_bt_start_array_keys(scan, dir)) {
+            return false;
+        }
     }
 
     /* This loop handles advancing to the next array elements, if any */
@@ -1577,8 +1761,8 @@ bool _bt_gettuple_internal(IndexScanDesc scan, ScanDirection dir)
                  * just forget any excess entries.
                  */
                 if (so->killedItems == NULL)
-                    so->killedItems = (int*)palloc(MaxIndexTuplesPerPage * sizeof(int));
-                if (so->numKilled < MaxIndexTuplesPerPage)
+                    so->killedItems = (int*)palloc(MaxTIDsPerBTreePage * sizeof(int));
+                if (so->numKilled < MaxTIDsPerBTreePage)
                     so->killedItems[so->numKilled++] = so->currPos.itemIndex;
             }
 
@@ -1592,7 +1776,7 @@ bool _bt_gettuple_internal(IndexScanDesc scan, ScanDirection dir)
         if (res)
             break;
         /* ... otherwise see if we have more array keys to deal with */
-    } while (so->numArrayKeys && _bt_advance_array_keys(scan, dir));
+    } while ((so->numArrayKeys || so->skipScan) && _bt_advance_array_keys(scan, dir));
 
     return res;
 }
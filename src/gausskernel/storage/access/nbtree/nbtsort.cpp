@@ -67,16 +67,37 @@
 #include "postgres.h"
 #include "knl/knl_variable.h"
 
+#include "access/heapam.h"
 #include "access/nbtree.h"
+#include "access/relscan.h"
+#include "access/xact.h"
 #include "access/xlog.h"
 #include "access/xloginsert.h"
+#include "catalog/catalog.h"
+#include "catalog/index.h"
+#include "gssignal/gs_signal.h"
+#include "lib/binaryheap.h"
+#include "libpq/pqsignal.h"
 #include "miscadmin.h"
+#include "postmaster/postmaster.h"
+#include "storage/barrier.h"
+#include "storage/ipc.h"
+#include "storage/lock.h"
+#include "storage/proc.h"
+#include "storage/procarray.h"
+#include "storage/procsignal.h"
 #include "storage/smgr.h"
 #include "tcop/tcopprot.h"
 #include "utils/aiomem.h"
+#include "utils/combocid.h"
+#include "utils/memutils.h"
+#include "utils/postinit.h"
+#include "utils/ps_status.h"
 #include "utils/rel.h"
 #include "utils/rel_gs.h"
+#include "utils/snapmgr.h"
 #include "utils/tuplesort.h"
+#include "gstrace/gstrace_infra.h"
 #include "commands/tablespace.h"
 #include "access/transam.h"
 #include "utils/builtins.h"
@@ -92,10 +113,27 @@ struct BTSpool {
     bool isunique;
 };
 
+/*
+ * Run of equal keys being merged into a posting list tuple while the leaf
+ * level is built.  The sorted input has the heap TIDs of equal keys in
+ * ascending order already.
+ */
+typedef struct BTDedupBuild {
+    IndexTuple base;   /* copy of the first tuple of the run, NULL if none */
+    ItemPointer htids; /* heap TIDs of the run */
+    int nhtids;
+} BTDedupBuild;
+
 static Page _bt_blnewpage(uint32 level);
 static void _bt_slideleft(Page page);
 static void _bt_sortaddtup(Page page, Size itemsize, IndexTuple itup, OffsetNumber itup_off);
+static void _bt_init_wstate(BTWriteState* wstate, Relation index);
 static void _bt_load(BTWriteState* wstate, BTSpool* btspool, BTSpool* btspool2);
+static void _bt_load_finish(BTWriteState* wstate, BTPageState* state);
+static int _bt_keycmp(TupleDesc tupdes, ScanKey indexScanKey, int keysz, IndexTuple itup, IndexTuple itup2);
+static void _bt_dedup_buildinit(BTDedupBuild* dedup);
+static void _bt_dedup_buildadd(BTWriteState* wstate, BTPageState* state, BTDedupBuild* dedup, IndexTuple itup);
+static void _bt_dedup_buildfinish(BTWriteState* wstate, BTPageState* state, BTDedupBuild* dedup);
 
 /*
  * Interface routines
@@ -171,20 +209,24 @@ void _bt_leafbuild(BTSpool* btspool, BTSpool* btspool2)
     if (btspool2 != NULL)
         tuplesort_performsort(btspool2->sortstate);
 
-    wstate.index = btspool->index;
+    _bt_init_wstate(&wstate, btspool->index);
+    _bt_load(&wstate, btspool, btspool2);
+}
+
+static void _bt_init_wstate(BTWriteState* wstate, Relation index)
+{
+    wstate->index = index;
 
     /*
      * We need to log index creation in WAL iff WAL archiving/streaming is
      * enabled UNLESS the index isn't WAL-logged anyway.
      */
-    wstate.btws_use_wal = XLogIsNeeded() && RelationNeedsWAL(wstate.index);
+    wstate->btws_use_wal = XLogIsNeeded() && RelationNeedsWAL(wstate->index);
 
     /* reserve the metapage */
-    wstate.btws_pages_alloced = BTREE_METAPAGE + 1;
-    wstate.btws_pages_written = 0;
-    wstate.btws_zeropage = NULL; /* until needed */
-
-    _bt_load(&wstate, btspool, btspool2);
+    wstate->btws_pages_alloced = BTREE_METAPAGE + 1;
+    wstate->btws_pages_written = 0;
+    wstate->btws_zeropage = NULL; /* until needed */
 }
 
 /*
@@ -533,6 +575,26 @@ void _bt_buildadd(BTWriteState* wstate, BTPageState* state, IndexTuple itup)
         ItemIdSetUnused(ii); /* redundant */
         ((PageHeader)opage)->pd_lower -= sizeof(ItemIdData);
 
+        /*
+         * A leaf high key only separates the key columns, so the included
+         * columns and any posting list are cut off.  The minimum key of the
+         * new page is copied from it below, so the parent levels never store
+         * them either.
+         */
+        if (state->btps_level == 0 && (IndexRelationGetNumberOfKeyAttributes(wstate->index) <
+                                              IndexRelationGetNumberOfAttributes(wstate->index) ||
+                                          BTreeTupleIsPosting(oitup))) {
+            IndexTuple truncated = _bt_pivot_tuple(wstate->index, oitup);
+
+            PageIndexTupleDelete(opage, P_HIKEY);
+            _bt_sortaddtup(opage, MAXALIGN(IndexTupleSize(truncated)), truncated, P_HIKEY);
+            pfree(truncated);
+
+            /* oitup must still point at the high key of opage */
+            hii = PageGetItemId(opage, P_HIKEY);
+            oitup = (IndexTuple)PageGetItem(opage, hii);
+        }
+
         /*
          * Link the old page into its parent, using its minimum key. If we
          * don't have a parent, we have to create one; this adds a new btree
@@ -586,7 +648,12 @@ void _bt_buildadd(BTWriteState* wstate, BTPageState* state, IndexTuple itup)
      */
     if (last_off == P_HIKEY) {
         Assert(state->btps_minkey == NULL);
-        state->btps_minkey = CopyIndexTuple(itup);
+        if (state->btps_level == 0 &&
+            (IndexRelationGetNumberOfKeyAttributes(wstate->index) < IndexRelationGetNumberOfAttributes(wstate->index) ||
+                BTreeTupleIsPosting(itup)))
+            state->btps_minkey = _bt_pivot_tuple(wstate->index, itup);
+        else
+            state->btps_minkey = CopyIndexTuple(itup);
     }
 
     /*
@@ -683,7 +750,7 @@ static void _bt_load(BTWriteState* wstate, BTSpool* btspool, BTSpool* btspool2)
     bool should_free2 = false;
     bool load1 = false;
     TupleDesc tupdes = RelationGetDescr(wstate->index);
-    int keysz = RelationGetNumberOfAttributes(wstate->index);
+    int keysz = IndexRelationGetNumberOfKeyAttributes(wstate->index);
     ScanKey indexScanKey = NULL;
 
     if (merge) {
@@ -726,19 +793,93 @@ static void _bt_load(BTWriteState* wstate, BTSpool* btspool, BTSpool* btspool2)
         _bt_freeskey(indexScanKey);
     } else {
         /* merge is unnecessary */
+        bool deduplicate = _bt_dedup_enabled(wstate->index);
+        BTDedupBuild dedup;
+
+        if (deduplicate)
+            _bt_dedup_buildinit(&dedup);
+
         while ((itup = tuplesort_getindextuple(btspool->sortstate, true, &should_free)) != NULL) {
             /* When we see first tuple, create first index page */
             if (state == NULL)
                 state = _bt_pagestate(wstate, 0);
 
-            _bt_buildadd(wstate, state, itup);
+            if (deduplicate)
+                _bt_dedup_buildadd(wstate, state, &dedup, itup);
+            else
+                _bt_buildadd(wstate, state, itup);
             if (should_free) {
                 pfree(itup);
                 itup = NULL;
             }
         }
+
+        if (deduplicate)
+            _bt_dedup_buildfinish(wstate, state, &dedup);
+    }
+
+    _bt_load_finish(wstate, state);
+}
+
+static void _bt_dedup_buildinit(BTDedupBuild* dedup)
+{
+    dedup->base = NULL;
+    dedup->htids = (ItemPointer)palloc(MaxTIDsPerBTreePage * sizeof(ItemPointerData));
+    dedup->nhtids = 0;
+}
+
+/* Add the pending run of equal keys to the leaf level */
+static void _bt_dedup_buildflush(BTWriteState* wstate, BTPageState* state, BTDedupBuild* dedup)
+{
+    if (dedup->nhtids == 1) {
+        _bt_buildadd(wstate, state, dedup->base);
+    } else {
+        IndexTuple posting = _bt_form_posting(dedup->base, dedup->htids, dedup->nhtids);
+
+        _bt_buildadd(wstate, state, posting);
+        pfree(posting);
+    }
+    pfree(dedup->base);
+    dedup->base = NULL;
+    dedup->nhtids = 0;
+}
+
+/*
+ * Add a tuple of the sorted input to the leaf level, merging it with the
+ * tuples before it that have the same key.
+ */
+static void _bt_dedup_buildadd(BTWriteState* wstate, BTPageState* state, BTDedupBuild* dedup, IndexTuple itup)
+{
+    Size maxpostingsize = BTMaxPostingSize(state->btps_page);
+
+    if (dedup->base != NULL) {
+        if (_bt_dedup_equal(dedup->base, itup) && _bt_posting_size(dedup->base, dedup->nhtids + 1) <= maxpostingsize) {
+            dedup->htids[dedup->nhtids++] = itup->t_tid;
+            return;
+        }
+        _bt_dedup_buildflush(wstate, state, dedup);
     }
 
+    /* a key too large to take any duplicate goes in as it is */
+    if (_bt_posting_size(itup, 2) > maxpostingsize) {
+        _bt_buildadd(wstate, state, itup);
+        return;
+    }
+
+    dedup->base = CopyIndexTuple(itup);
+    dedup->htids[0] = itup->t_tid;
+    dedup->nhtids = 1;
+}
+
+static void _bt_dedup_buildfinish(BTWriteState* wstate, BTPageState* state, BTDedupBuild* dedup)
+{
+    if (dedup->base != NULL)
+        _bt_dedup_buildflush(wstate, state, dedup);
+    pfree(dedup->htids);
+}
+
+static void _bt_load_finish(BTWriteState* wstate, BTPageState* state)
+{
     /* Close down final pages and write the metapage */
     _bt_uppershutdown(wstate, state);
 
@@ -771,9 +912,6 @@ static void _bt_load(BTWriteState* wstate, BTSpool* btspool, BTSpool* btspool2)
 bool _index_tuple_compare(TupleDesc tupdes, ScanKey indexScanKey, int keysz, IndexTuple itup, IndexTuple itup2)
 {
     /* defaultly load itup, including the itup != NULL && itup2 == NULL case. */
-    bool result = true;
-    int i;
-
     if (itup == NULL && itup2 != NULL) {
         return false;
     }
@@ -781,12 +919,22 @@ bool _index_tuple_compare(TupleDesc tupdes, ScanKey indexScanKey, int keysz, Ind
         return true;
     }
     Assert(itup != NULL && itup2 != NULL);
+    return _bt_keycmp(tupdes, indexScanKey, keysz, itup, itup2) <= 0;
+}
+
+/*
+ * compare the keys of two index tuples in index order, return <0, 0 or >0
+ */
+static int _bt_keycmp(TupleDesc tupdes, ScanKey indexScanKey, int keysz, IndexTuple itup, IndexTuple itup2)
+{
+    int32 compare = 0;
+    int i;
+
     for (i = 1; i <= keysz; i++) {
         ScanKey entry;
         Datum attrDatum1, attrDatum2;
         bool isNull1 = false;
         bool isNull2 = false;
-        int32 compare;
 
         entry = indexScanKey + i - 1;
         attrDatum1 = index_getattr(itup, i, tupdes, &isNull1);
@@ -811,13 +959,10 @@ bool _index_tuple_compare(TupleDesc tupdes, ScanKey indexScanKey, int keysz, Ind
         }
 
         // check compare value, if 0 continue, else break.
-        if (compare > 0) {
-            result = false;
-            break;
-        } else if (compare < 0)
+        if (compare != 0)
             break;
     }
-    return result;
+    return compare;
 }
 
 List* insert_ordered_index(List* list, TupleDesc tupdes, ScanKey indexScanKey, int keysz, IndexTuple itup,
@@ -875,3 +1020,878 @@ List* insert_ordered_index(List* list, TupleDesc tupdes, ScanKey indexScanKey, i
     return list;
 }
 
+
+/*
+ * Parallel btree build
+ *
+ * With max_parallel_maintenance_workers set, btbuild hands parts of the heap
+ * scan and of the sort to worker threads.  The heap is divided into stripes of
+ * PARALLEL_SCAN_GAP blocks the way an SMP sequential scan divides it, and every
+ * participant (the leader is participant 0) sorts the tuples of its stripes
+ * into its own runs: one for live tuples and, for a unique index, one for dead
+ * tuples.  The workers stream their sorted runs to the leader through small
+ * chunk queues in a shared memory context, and the leader merges all runs
+ * straight into the leaf pages, so the btree itself is still written by a
+ * single thread exactly as in a serial build.
+ *
+ * A worker borrows the leader's transaction the way a stream thread does: its
+ * xid, command id, combo cids and snapshot.  This lets it see the catalog
+ * entries of an index created by the leader and treat the leader's own tuples
+ * as such.  The worker takes no relation locks, those of the leader cover it.
+ * Uniqueness is checked inside each run by tuplesort and across runs by the
+ * leader while merging.
+ */
+#define BTBUILD_QUEUE_CHUNKS 4
+#define BTBUILD_CHUNK_SIZE (64 * 1024)
+#define BTBUILD_WAIT_INTERVAL 1000 /* ms */
+
+typedef struct BTBuildChunk {
+    Size used;
+    char data[BTBUILD_CHUNK_SIZE]; /* MAXALIGN'ed index tuples */
+} BTBuildChunk;
+
+/* one sorted run of a worker, passed to the leader a chunk at a time */
+typedef struct BTBuildQueue {
+    BTBuildChunk* chunks[BTBUILD_QUEUE_CHUNKS];
+    pg_atomic_uint32 head; /* next chunk to merge, advanced by the leader */
+    pg_atomic_uint32 tail; /* next chunk to fill, advanced by the worker */
+    volatile bool done;    /* all tuples of the run are queued */
+} BTBuildQueue;
+
+typedef enum { BTBUILD_WORKER_STARTING = 0, BTBUILD_WORKER_EXITED } BTBuildWorkerState;
+
+struct BTParallelBuild;
+
+typedef struct BTBuildWorker {
+    int id; /* participant number, the leader is 0 */
+    ThreadId tid;
+    PGPROC* volatile proc;
+    volatile BTBuildWorkerState state;
+    struct BTParallelBuild* shared;
+    bool xactBorrowed; /* the leader's transaction is in use, worker only */
+
+    /* results of the worker's share of the scan, valid once finished */
+    double reltuples;
+    double indtuples;
+    bool brokenHotChain;
+    volatile bool finished;
+
+    ErrorData* volatile error; /* the error that stopped the worker */
+
+    BTBuildQueue runs[2]; /* live tuples, and dead tuples of a unique index */
+} BTBuildWorker;
+
+typedef struct BTParallelBuild {
+    MemoryContext context; /* shared context holding all of this */
+    Oid dbid;
+    Oid heapid;
+    Oid indexid;
+    bool isunique;
+    bool concurrent;
+    int workMem; /* sort memory of each participant, in kB */
+    TransactionId OldestXmin;
+    StreamTxnContext txnCxt; /* the leader's transaction */
+    Latch* leaderLatch;
+    volatile int dop; /* number of participants, 0 until all workers are started */
+    volatile bool shutdown;
+    int nworkers;
+    BTBuildWorker* workers[MAX_PARALLEL_BTBUILD_WORKERS];
+} BTParallelBuild;
+
+/* one sorted run being merged by the leader */
+typedef struct BTMergeInput {
+    Tuplesortstate* sortstate; /* a run of the leader, or */
+    BTBuildWorker* worker;     /* the worker streaming the run */
+    BTBuildQueue* queue;
+    BTBuildChunk* chunk; /* chunk being merged */
+    Size offset;
+    bool isdead;
+    IndexTuple itup; /* current tuple of the run */
+    bool should_free;
+} BTMergeInput;
+
+typedef struct BTMergeState {
+    BTMergeInput* inputs;
+    TupleDesc tupdes;
+    ScanKey indexScanKey;
+    int keysz;
+} BTMergeState;
+
+static THR_LOCAL BTParallelBuild* MyBTParallelBuild = NULL;
+static THR_LOCAL BTBuildWorker* MyBTBuildWorker = NULL;
+
+static int _bt_parallel_sort_mem(IndexInfo* indexInfo);
+static BTSpool* _bt_spoolinit_parallel(Relation index, bool isunique, bool isdead, int workMem);
+static BTParallelBuild* _bt_parallel_begin(
+    Relation heap, Relation index, IndexInfo* indexInfo, int nworkers, Snapshot snapshot);
+static void _bt_parallel_end(BTParallelBuild* shared);
+static void _bt_parallel_leader_exit(int code, Datum arg);
+static void _bt_parallel_check_workers(BTParallelBuild* shared);
+static void _bt_parallel_wait(BTParallelBuild* shared);
+static void _bt_parallel_merge(BTParallelBuild* shared, Relation index, BTBuildState* buildstate);
+static IndexTuple _bt_merge_next(BTParallelBuild* shared, BTMergeInput* input);
+static int _bt_merge_compare(Datum a, Datum b, void* arg);
+static void _bt_parallel_scan_and_sort(BTBuildWorker* worker);
+static void _bt_parallel_build_callback(
+    Relation index, HeapTuple htup, Datum* values, const bool* isnull, bool tupleIsAlive, void* state);
+static void _bt_parallel_send(BTBuildWorker* worker, BTBuildQueue* queue, BTSpool* btspool);
+static void _bt_parallel_worker_detach(int code, Datum arg);
+static void _bt_parallel_worker_exit(int code, Datum arg);
+
+/*
+ * Number of workers to build the btree index with, 0 for a serial build.
+ */
+int _bt_parallel_build_workers(Relation heap, Relation index, IndexInfo* indexInfo)
+{
+    int nworkers = u_sess->attr.attr_storage.max_parallel_maintenance_workers;
+    BlockNumber nblocks;
+    LOCKTAG tag;
+
+    if (nworkers <= 0)
+        return 0;
+
+    /*
+     * Workers are separate threads with their own relcache and no local
+     * buffers.  Leave out temp tables, catalogs (whose relation map is only
+     * known to the leader while being rewritten), partitions and buckets that
+     * are only open as fake relations, and expressions or predicates that
+     * could run arbitrary functions.
+     */
+    if (IsBootstrapProcessingMode() || !IsUnderPostmaster || StreamThreadAmI() || IsSystemRelation(heap) ||
+        heap->rd_rel->relkind != RELKIND_RELATION || RelationUsesLocalBuffers(heap) || RelationIsPartition(heap) ||
+        RELATION_IS_PARTITIONED(heap) || RelationIsBucket(heap) || RELATION_OWN_BUCKET(heap) ||
+        !RelationIsRowFormat(heap) || RelationIsBucket(index) || indexInfo->ii_Expressions != NIL ||
+        indexInfo->ii_Predicate != NIL)
+        return 0;
+
+    /*
+     * A worker detoasting values would wait forever for a toast table the
+     * leader holds exclusively, as when a rewritten heap is reindexed.
+     */
+    SET_LOCKTAG_RELATION(tag, u_sess->proc_cxt.MyDatabaseId, RelationGetRelid(heap));
+    if (LockHeldByMe(&tag, AccessExclusiveLock))
+        return 0;
+
+    /* every participant gets whole stripes of the heap and 32MB of sort memory */
+    nblocks = RelationGetNumberOfBlocks(heap);
+    nworkers = Min(nworkers, (int)(nblocks / PARALLEL_SCAN_GAP) - 1);
+    nworkers = Min(nworkers, _bt_parallel_sort_mem(indexInfo) / SIMPLE_THRESHOLD - 1);
+
+    return Max(nworkers, 0);
+}
+
+/*
+ * Build the btree index with nworkers worker threads, return the number of
+ * heap tuples scanned.  The leader scans and sorts its own share of the heap
+ * while the workers do theirs, then merges all sorted runs into the index.
+ */
+double _bt_parallel_build(Relation heap, Relation index, IndexInfo* indexInfo, int nworkers, BTBuildState* buildstate)
+{
+    BTParallelBuild* shared = NULL;
+    Snapshot snapshot = RegisterSnapshot(GetTransactionSnapshot());
+    int saveSmpId = u_sess->stream_cxt.smp_id;
+    double reltuples = 0;
+    int i;
+
+    shared = _bt_parallel_begin(heap, index, indexInfo, nworkers, snapshot);
+
+    PG_TRY();
+    {
+        if (shared->isunique)
+            buildstate->spool2 = _bt_spoolinit_parallel(index, false, true, shared->workMem);
+        buildstate->spool = _bt_spoolinit_parallel(index, shared->isunique, false, shared->workMem);
+
+        u_sess->stream_cxt.smp_id = 0;
+        reltuples = IndexBuildHeapScanParallel(heap,
+            index,
+            indexInfo,
+            btbuildCallback,
+            (void*)buildstate,
+            shared->concurrent ? snapshot : InvalidSnapshot,
+            shared->OldestXmin,
+            shared->dop);
+        u_sess->stream_cxt.smp_id = saveSmpId;
+
+        tuplesort_performsort(buildstate->spool->sortstate);
+        if (buildstate->spool2 != NULL)
+            tuplesort_performsort(buildstate->spool2->sortstate);
+
+        _bt_parallel_merge(shared, index, buildstate);
+
+        /* all runs are merged, so every worker has reported */
+        pg_read_barrier();
+        for (i = 0; i < shared->nworkers; i++) {
+            BTBuildWorker* worker = shared->workers[i];
+
+            reltuples += worker->reltuples;
+            buildstate->indtuples += worker->indtuples;
+            if (worker->brokenHotChain)
+                indexInfo->ii_BrokenHotChain = true;
+        }
+    }
+    PG_CATCH();
+    {
+        u_sess->stream_cxt.smp_id = saveSmpId;
+        _bt_parallel_end(shared);
+        PG_RE_THROW();
+    }
+    PG_END_TRY();
+
+    _bt_parallel_end(shared);
+
+    _bt_spooldestroy(buildstate->spool);
+    buildstate->spool = NULL;
+    if (buildstate->spool2 != NULL) {
+        _bt_spooldestroy(buildstate->spool2);
+        buildstate->spool2 = NULL;
+    }
+    UnregisterSnapshot(snapshot);
+
+    return reltuples;
+}
+
+static int _bt_parallel_sort_mem(IndexInfo* indexInfo)
+{
+    if (indexInfo->ii_desc.query_mem[0] > 0)
+        return indexInfo->ii_desc.query_mem[0];
+    return u_sess->attr.attr_memory.maintenance_work_mem;
+}
+
+/*
+ * create a spool of one participant, with workMem kB for the sort of live
+ * tuples.  Dead tuples of a unique index are expected to be few, as in a
+ * serial build.
+ */
+static BTSpool* _bt_spoolinit_parallel(Relation index, bool isunique, bool isdead, int workMem)
+{
+    BTSpool* btspool = (BTSpool*)palloc0(sizeof(BTSpool));
+    int btKbytes = isdead ? Min(u_sess->attr.attr_memory.work_mem, workMem) : workMem;
+
+    btspool->index = index;
+    btspool->isunique = isunique;
+    btspool->sortstate = tuplesort_begin_index_btree(index, isunique, btKbytes, false, 0);
+
+    return btspool;
+}
+
+/*
+ * Set up the state shared with the workers and start them.  The number of
+ * participants is fixed once the workers are started, a worker that can not
+ * be started just leaves its share of the heap to the others.
+ */
+static BTParallelBuild* _bt_parallel_begin(
+    Relation heap, Relation index, IndexInfo* indexInfo, int nworkers, Snapshot snapshot)
+{
+    MemoryContext context = NULL;
+    BTParallelBuild* shared = NULL;
+    int i;
+    int j;
+    int k;
+
+    Assert(nworkers > 0 && nworkers <= MAX_PARALLEL_BTBUILD_WORKERS);
+    Assert(MyBTParallelBuild == NULL);
+
+    context = AllocSetContextCreate(g_instance.instance_context,
+        "BtreeParallelBuildContext",
+        ALLOCSET_DEFAULT_MINSIZE,
+        ALLOCSET_DEFAULT_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE,
+        SHARED_CONTEXT);
+
+    shared = (BTParallelBuild*)MemoryContextAllocZero(context, sizeof(BTParallelBuild));
+    shared->context = context;
+    shared->dbid = u_sess->proc_cxt.MyDatabaseId;
+    shared->heapid = RelationGetRelid(heap);
+    shared->indexid = RelationGetRelid(index);
+    shared->isunique = indexInfo->ii_Unique;
+    shared->concurrent = indexInfo->ii_Concurrent;
+    shared->workMem = _bt_parallel_sort_mem(indexInfo) / (nworkers + 1);
+    shared->OldestXmin = indexInfo->ii_Concurrent ? InvalidTransactionId : GetOldestXmin(heap);
+    shared->leaderLatch = &t_thrd.proc->procLatch;
+
+    /* what a worker needs to take part in our transaction */
+    shared->txnCxt.txnId = GetCurrentTransactionIdIfAny();
+    shared->txnCxt.snapshot = snapshot;
+    StreamTxnContextSaveXact(&shared->txnCxt);
+    StreamTxnContextSaveSnapmgr(&shared->txnCxt);
+    StreamTxnContextSaveComboCid(&shared->txnCxt);
+
+    for (i = 0; i < nworkers; i++) {
+        BTBuildWorker* worker = (BTBuildWorker*)MemoryContextAllocZero(context, sizeof(BTBuildWorker));
+
+        worker->id = i + 1;
+        worker->state = BTBUILD_WORKER_STARTING;
+        worker->shared = shared;
+        for (j = 0; j < 2; j++) {
+            /* there are no dead tuples to keep apart in a non-unique index */
+            if (j == 1 && !shared->isunique) {
+                worker->runs[j].done = true;
+                continue;
+            }
+            for (k = 0; k < BTBUILD_QUEUE_CHUNKS; k++)
+                worker->runs[j].chunks[k] = (BTBuildChunk*)MemoryContextAlloc(context, sizeof(BTBuildChunk));
+        }
+        shared->workers[i] = worker;
+    }
+
+    MyBTParallelBuild = shared;
+    on_shmem_exit(_bt_parallel_leader_exit, 0);
+
+    for (i = 0; i < nworkers; i++) {
+        BTBuildWorker* worker = shared->workers[i];
+
+        worker->tid = initialize_util_thread(PARALLEL_BTBUILD, worker);
+        if (worker->tid == 0) {
+            ereport(LOG, (errmsg("could not start parallel btree build worker %d", worker->id)));
+            break;
+        }
+        shared->nworkers++;
+    }
+
+    /* let the workers start scanning */
+    pg_write_barrier();
+    shared->dop = shared->nworkers + 1;
+    for (i = 0; i < shared->nworkers; i++) {
+        PGPROC* proc = shared->workers[i]->proc;
+
+        if (proc != NULL)
+            SetLatch(&proc->procLatch);
+    }
+
+    ereport(DEBUG1,
+        (errmsg("building index with %d parallel workers and %d kB of sort memory each",
+            shared->nworkers,
+            shared->workMem)));
+
+    return shared;
+}
+
+/*
+ * Stop the workers and wait until they are gone, they may still use our
+ * transaction and the shared context.
+ */
+static void _bt_parallel_end(BTParallelBuild* shared)
+{
+    bool exited = false;
+    int i;
+
+    shared->shutdown = true;
+    pg_memory_barrier();
+
+    while (!exited) {
+        exited = true;
+        for (i = 0; i < shared->nworkers; i++) {
+            BTBuildWorker* worker = shared->workers[i];
+            PGPROC* proc = worker->proc;
+
+            if (worker->state != BTBUILD_WORKER_EXITED) {
+                exited = false;
+                if (proc != NULL)
+                    SetLatch(&proc->procLatch);
+            }
+        }
+        if (exited)
+            break;
+
+        (void)WaitLatch(shared->leaderLatch, WL_LATCH_SET | WL_TIMEOUT, BTBUILD_WAIT_INTERVAL);
+        ResetLatch(shared->leaderLatch);
+    }
+
+    MyBTParallelBuild = NULL;
+    cancel_shmem_exit(_bt_parallel_leader_exit, 0);
+    MemoryContextDelete(shared->context);
+}
+
+/* stop the workers when the leader exits while they are running */
+static void _bt_parallel_leader_exit(int code, Datum arg)
+{
+    BTParallelBuild* shared = MyBTParallelBuild;
+
+    if (shared != NULL)
+        _bt_parallel_end(shared);
+}
+
+/* raise the error of a failed worker in the leader */
+static void _bt_parallel_check_workers(BTParallelBuild* shared)
+{
+    int i;
+
+    for (i = 0; i < shared->nworkers; i++) {
+        BTBuildWorker* worker = shared->workers[i];
+        ErrorData* edata = worker->error;
+
+        if (edata != NULL) {
+            pg_read_barrier();
+            ereport(ERROR,
+                (errcode(edata->sqlerrcode),
+                    errmsg_internal("%s", edata->message),
+                    edata->detail ? errdetail_internal("%s", edata->detail) : 0,
+                    edata->hint ? errhint("%s", edata->hint) : 0));
+        }
+        if (worker->state == BTBUILD_WORKER_EXITED && !worker->finished)
+            ereport(ERROR,
+                (errcode(ERRCODE_INTERNAL_ERROR),
+                    errmsg("parallel btree build worker %d exited unexpectedly", worker->id),
+                    errhint("See the server log of the worker for details.")));
+    }
+}
+
+static void _bt_parallel_wait(BTParallelBuild* shared)
+{
+    CHECK_FOR_INTERRUPTS();
+    _bt_parallel_check_workers(shared);
+
+    (void)WaitLatch(shared->leaderLatch, WL_LATCH_SET | WL_TIMEOUT, BTBUILD_WAIT_INTERVAL);
+    ResetLatch(shared->leaderLatch);
+}
+
+/*
+ * Merge the sorted runs of all participants into the leaf pages, checking
+ * uniqueness across runs the way tuplesort does inside a run.
+ */
+static void _bt_parallel_merge(BTParallelBuild* shared, Relation index, BTBuildState* buildstate)
+{
+    BTWriteState wstate;
+    BTPageState* state = NULL;
+    BTMergeState merge;
+    BTMergeInput* inputs = NULL;
+    binaryheap* heap = NULL;
+    IndexTuple lastAlive = NULL;
+    bool haveLastAlive = false;
+    int ninputs = 0;
+    int i;
+    int j;
+    bool deduplicate = _bt_dedup_enabled(index);
+    BTDedupBuild dedup;
+
+    _bt_init_wstate(&wstate, index);
+
+    inputs = (BTMergeInput*)palloc0(sizeof(BTMergeInput) * (2 * (shared->nworkers + 1)));
+    inputs[ninputs].sortstate = buildstate->spool->sortstate;
+    ninputs++;
+    if (buildstate->spool2 != NULL) {
+        inputs[ninputs].sortstate = buildstate->spool2->sortstate;
+        inputs[ninputs].isdead = true;
+        ninputs++;
+    }
+    for (i = 0; i < shared->nworkers; i++) {
+        for (j = 0; j < 2; j++) {
+            inputs[ninputs].worker = shared->workers[i];
+            inputs[ninputs].queue = &shared->workers[i]->runs[j];
+            inputs[ninputs].isdead = (j == 1);
+            ninputs++;
+        }
+    }
+
+    merge.inputs = inputs;
+    merge.tupdes = RelationGetDescr(index);
+    merge.indexScanKey = _bt_mkscankey_nodata(index);
+    merge.keysz = IndexRelationGetNumberOfKeyAttributes(index);
+
+    heap = binaryheap_allocate(ninputs, _bt_merge_compare, &merge);
+    for (i = 0; i < ninputs; i++) {
+        inputs[i].itup = _bt_merge_next(shared, &inputs[i]);
+        if (inputs[i].itup != NULL)
+            binaryheap_add_unordered(heap, Int32GetDatum(i));
+    }
+    binaryheap_build(heap);
+
+    if (shared->isunique)
+        lastAlive = (IndexTuple)palloc(BLCKSZ);
+    if (deduplicate)
+        _bt_dedup_buildinit(&dedup);
+
+    while (!binaryheap_empty(heap)) {
+        BTMergeInput* input = &inputs[DatumGetInt32(binaryheap_first(heap))];
+        IndexTuple itup = input->itup;
+
+        if (shared->isunique && !input->isdead) {
+            if (haveLastAlive && !IndexTupleHasNulls(itup) &&
+                _bt_keycmp(merge.tupdes, merge.indexScanKey, merge.keysz, lastAlive, itup) == 0) {
+                Datum values[INDEX_MAX_KEYS];
+                bool isnull[INDEX_MAX_KEYS];
+                char* key_desc = NULL;
+
+                index_deform_tuple(itup, merge.tupdes, values, isnull);
+                key_desc = BuildIndexValueDescription(index, values, isnull);
+                ereport(ERROR,
+                    (errcode(ERRCODE_UNIQUE_VIOLATION),
+                        errmsg("could not create unique index \"%s\"", RelationGetRelationName(index)),
+                        key_desc ? errdetail("Key %s is duplicated.", key_desc) : errdetail("Duplicate keys exist.")));
+            }
+        }
+
+        /* When we see first tuple, create first index page */
+        if (state == NULL)
+            state = _bt_pagestate(&wstate, 0);
+
+        if (deduplicate)
+            _bt_dedup_buildadd(&wstate, state, &dedup, itup);
+        else
+            _bt_buildadd(&wstate, state, itup);
+
+        if (shared->isunique && !input->isdead) {
+            errno_t rc = memcpy_s(lastAlive, BLCKSZ, itup, IndexTupleSize(itup));
+            securec_check(rc, "\0", "\0");
+            haveLastAlive = true;
+        }
+
+        if (input->should_free)
+            pfree(itup);
+        input->itup = _bt_merge_next(shared, input);
+        if (input->itup != NULL)
+            binaryheap_replace_first(heap, binaryheap_first(heap));
+        else
+            (void)binaryheap_remove_first(heap);
+    }
+
+    if (deduplicate)
+        _bt_dedup_buildfinish(&wstate, state, &dedup);
+    _bt_freeskey(merge.indexScanKey);
+    binaryheap_free(heap);
+    if (lastAlive != NULL)
+        pfree(lastAlive);
+    pfree(inputs);
+
+    _bt_load_finish(&wstate, state);
+}
+
+/*
+ * Next tuple of a sorted run, NULL at its end.  A tuple of a worker's run
+ * stays valid until the next call for the same run.
+ */
+static IndexTuple _bt_merge_next(BTParallelBuild* shared, BTMergeInput* input)
+{
+    BTBuildQueue* queue = input->queue;
+
+    if (input->sortstate != NULL)
+        return tuplesort_getindextuple(input->sortstate, true, &input->should_free);
+
+    for (;;) {
+        uint32 head;
+
+        if (input->chunk != NULL) {
+            if (input->offset < input->chunk->used) {
+                IndexTuple itup = (IndexTuple)(input->chunk->data + input->offset);
+
+                input->offset += MAXALIGN(IndexTupleSize(itup));
+                return itup;
+            }
+
+            /* hand the merged chunk back to the worker */
+            pg_memory_barrier();
+            pg_atomic_write_u32(&queue->head, pg_atomic_read_u32(&queue->head) + 1);
+            if (input->worker->proc != NULL)
+                SetLatch(&input->worker->proc->procLatch);
+            input->chunk = NULL;
+        }
+
+        head = pg_atomic_read_u32(&queue->head);
+        if (head != pg_atomic_read_u32(&queue->tail)) {
+            pg_read_barrier();
+            input->chunk = queue->chunks[head % BTBUILD_QUEUE_CHUNKS];
+            input->offset = 0;
+            continue;
+        }
+        if (queue->done) {
+            pg_read_barrier();
+            if (head == pg_atomic_read_u32(&queue->tail))
+                return NULL;
+            continue;
+        }
+
+        _bt_parallel_wait(shared);
+    }
+}
+
+/* binary heap ordering of the runs, the smallest current tuple comes first */
+static int _bt_merge_compare(Datum a, Datum b, void* arg)
+{
+    BTMergeState* merge = (BTMergeState*)arg;
+    IndexTuple itup = merge->inputs[DatumGetInt32(a)].itup;
+    IndexTuple itup2 = merge->inputs[DatumGetInt32(b)].itup;
+    int compare = _bt_keycmp(merge->tupdes, merge->indexScanKey, merge->keysz, itup, itup2);
+
+    /* equal keys are kept in heap order, as tuplesort does */
+    if (compare == 0)
+        compare = ItemPointerCompare(&itup->t_tid, &itup2->t_tid);
+
+    return -compare;
+}
+
+/*
+ * Main entry point of a parallel btree build worker, arg is its BTBuildWorker.
+ */
+void BTParallelBuildWorkerMain(void* arg)
+{
+    BTBuildWorker* worker = (BTBuildWorker*)arg;
+    BTParallelBuild* shared = worker->shared;
+    sigjmp_buf local_sigjmp_buf;
+
+    /* we are a postmaster subprocess now */
+    IsUnderPostmaster = true;
+    t_thrd.role = PARALLEL_BTBUILD;
+
+    /* reset t_thrd.proc_cxt.MyProcPid */
+    t_thrd.proc_cxt.MyProcPid = gs_thread_self();
+
+    /* record Start Time for logging */
+    t_thrd.proc_cxt.MyStartTime = time(NULL);
+
+    t_thrd.proc_cxt.MyProgName = "BtreeBuilder";
+
+    /* Identify myself via ps */
+    init_ps_display("parallel btree build worker process", "", "", "");
+
+    SetProcessingMode(InitProcessing);
+
+    (void)gspqsignal(SIGINT, StatementCancelHandler);
+    (void)gspqsignal(SIGTERM, die);
+    (void)gspqsignal(SIGQUIT, quickdie);
+    (void)gspqsignal(SIGALRM, handle_sig_alarm);
+
+    (void)gspqsignal(SIGPIPE, SIG_IGN);
+    (void)gspqsignal(SIGUSR1, procsignal_sigusr1_handler);
+    (void)gspqsignal(SIGUSR2, SIG_IGN);
+    (void)gspqsignal(SIGFPE, FloatExceptionHandler);
+    (void)gspqsignal(SIGCHLD, SIG_DFL);
+    (void)gspqsignal(SIGHUP, SIG_IGN);
+
+    /* Early initialization */
+    BaseInit();
+
+#ifndef EXEC_BACKEND
+    InitProcess();
+#endif
+
+    /* tell the leader when we are gone, whatever the reason */
+    on_shmem_exit(_bt_parallel_worker_exit, PointerGetDatum(worker));
+
+    /*
+     * If an exception is encountered, processing resumes here.  The error is
+     * handed to the leader, which raises it again in the user's session.
+     */
+    int curTryCounter;
+    int* oldTryCounter = NULL;
+    if (sigsetjmp(local_sigjmp_buf, 1) != 0) {
+        gstrace_tryblock_exit(true, oldTryCounter);
+        /* Prevents interrupts while cleaning up */
+        HOLD_INTERRUPTS();
+
+        if (worker->error == NULL) {
+            MemoryContext oldcontext = MemoryContextSwitchTo(shared->context);
+            ErrorData* edata = CopyErrorData();
+
+            (void)MemoryContextSwitchTo(oldcontext);
+            pg_write_barrier();
+            worker->error = edata;
+        }
+
+        /* Report the error to the server log */
+        EmitErrorReport();
+
+        proc_exit(1);
+    }
+    oldTryCounter = gstrace_tryblock_entry(&curTryCounter);
+
+    /* We can now handle ereport(ERROR) */
+    t_thrd.log_cxt.PG_exception_stack = &local_sigjmp_buf;
+
+    gs_signal_setmask(&t_thrd.libpq_cxt.UnBlockSig, NULL);
+    (void)gs_signal_unblock_sigusr2();
+
+    t_thrd.proc_cxt.PostInit->SetDatabaseAndUser(NULL, shared->dbid, NULL);
+    t_thrd.proc_cxt.PostInit->InitBtreeBuildWorker();
+
+    SetProcessingMode(NormalProcessing);
+
+    worker->proc = t_thrd.proc;
+    pg_memory_barrier();
+
+    /* wait until the leader has started all workers */
+    while (shared->dop == 0) {
+        if (shared->shutdown)
+            proc_exit(0);
+        (void)WaitLatch(&t_thrd.proc->procLatch, WL_LATCH_SET | WL_TIMEOUT, BTBUILD_WAIT_INTERVAL);
+        ResetLatch(&t_thrd.proc->procLatch);
+        CHECK_FOR_INTERRUPTS();
+    }
+    pg_read_barrier();
+
+    MyBTBuildWorker = worker;
+    _bt_parallel_scan_and_sort(worker);
+}
+
+/*
+ * The work of a worker: scan its share of the heap inside the leader's
+ * transaction, sort it and stream the sorted runs to the leader.
+ */
+static void _bt_parallel_scan_and_sort(BTBuildWorker* worker)
+{
+    BTParallelBuild* shared = worker->shared;
+    Relation heap = NULL;
+    Relation index = NULL;
+    IndexInfo* indexInfo = NULL;
+    Snapshot snapshot = InvalidSnapshot;
+    BTBuildState buildstate;
+    double reltuples;
+
+    StartTransactionCommand();
+    (void)GetTransactionSnapshot();
+
+    /* take part in the leader's transaction, see StreamTxnContext */
+    StreamTxnContextSetTransactionState(&shared->txnCxt);
+    StreamTxnContextRestoreXact(&shared->txnCxt);
+    StreamTxnContextRestoreComboCid(&shared->txnCxt);
+    StreamTxnContextRestoreSnapmgr(&shared->txnCxt);
+    StreamTxnContextSetSnapShot(shared->txnCxt.snapshot);
+    StreamTxnContextSetMyPgXactXmin(shared->txnCxt.TransactionXmin);
+    worker->xactBorrowed = true;
+    on_shmem_exit(_bt_parallel_worker_detach, PointerGetDatum(worker));
+
+    if (shared->concurrent) {
+        snapshot = (Snapshot)palloc(sizeof(SnapshotData));
+        *snapshot = *u_sess->utils_cxt.CurrentSnapshot;
+    }
+
+    /* the leader's locks cover us */
+    heap = heap_open(shared->heapid, NoLock);
+    index = index_open(shared->indexid, NoLock);
+    indexInfo = BuildIndexInfo(index);
+    indexInfo->ii_Concurrent = shared->concurrent;
+
+    buildstate.isUnique = shared->isunique;
+    buildstate.haveDead = false;
+    buildstate.heapRel = heap;
+    buildstate.spool2 = shared->isunique ? _bt_spoolinit_parallel(index, false, true, shared->workMem) : NULL;
+    buildstate.spool = _bt_spoolinit_parallel(index, shared->isunique, false, shared->workMem);
+    buildstate.indtuples = 0;
+
+    u_sess->stream_cxt.smp_id = worker->id;
+    reltuples = IndexBuildHeapScanParallel(heap,
+        index,
+        indexInfo,
+        _bt_parallel_build_callback,
+        (void*)&buildstate,
+        snapshot,
+        shared->OldestXmin,
+        shared->dop);
+
+    worker->reltuples = reltuples;
+    worker->indtuples = buildstate.indtuples;
+    worker->brokenHotChain = indexInfo->ii_BrokenHotChain;
+
+    tuplesort_performsort(buildstate.spool->sortstate);
+    _bt_parallel_send(worker, &worker->runs[0], buildstate.spool);
+    if (buildstate.spool2 != NULL) {
+        tuplesort_performsort(buildstate.spool2->sortstate);
+        _bt_parallel_send(worker, &worker->runs[1], buildstate.spool2);
+    }
+
+    _bt_spooldestroy(buildstate.spool);
+    if (buildstate.spool2 != NULL)
+        _bt_spooldestroy(buildstate.spool2);
+    index_close(index, NoLock);
+    heap_close(heap, NoLock);
+
+    /* end our own transaction only, the leader commits the build */
+    StreamTxnContextResetTransactionState();
+    worker->xactBorrowed = false;
+    CommitTransactionCommand();
+
+    pg_write_barrier();
+    worker->finished = true;
+}
+
+static void _bt_parallel_build_callback(
+    Relation index, HeapTuple htup, Datum* values, const bool* isnull, bool tupleIsAlive, void* state)
+{
+    if (MyBTBuildWorker->shared->shutdown)
+        ereport(ERROR, (errcode(ERRCODE_QUERY_CANCELED), errmsg("parallel btree build is canceled")));
+
+    btbuildCallback(index, htup, values, isnull, tupleIsAlive, state);
+}
+
+/*
+ * Stream a sorted run to the leader, filling the free chunks of its queue.
+ */
+static void _bt_parallel_send(BTBuildWorker* worker, BTBuildQueue* queue, BTSpool* btspool)
+{
+    BTParallelBuild* shared = worker->shared;
+    BTBuildChunk* chunk = NULL;
+    IndexTuple itup = NULL;
+    bool should_free = false;
+
+    for (;;) {
+        Size itemsz = 0;
+
+        itup = tuplesort_getindextuple(btspool->sortstate, true, &should_free);
+        if (itup != NULL)
+            itemsz = MAXALIGN(IndexTupleSize(itup));
+
+        /* publish the chunk when it is full or the run is over */
+        if (chunk != NULL && (itup == NULL || chunk->used + itemsz > BTBUILD_CHUNK_SIZE)) {
+            pg_write_barrier();
+            pg_atomic_write_u32(&queue->tail, pg_atomic_read_u32(&queue->tail) + 1);
+            SetLatch(shared->leaderLatch);
+            chunk = NULL;
+        }
+        if (itup == NULL)
+            break;
+
+        /* wait for a chunk merged by the leader */
+        while (chunk == NULL) {
+            uint32 tail = pg_atomic_read_u32(&queue->tail);
+
+            if (tail - pg_atomic_read_u32(&queue->head) < BTBUILD_QUEUE_CHUNKS) {
+                pg_memory_barrier();
+                chunk = queue->chunks[tail % BTBUILD_QUEUE_CHUNKS];
+                chunk->used = 0;
+                break;
+            }
+            if (shared->shutdown)
+                ereport(ERROR, (errcode(ERRCODE_QUERY_CANCELED), errmsg("parallel btree build is canceled")));
+
+            (void)WaitLatch(&t_thrd.proc->procLatch, WL_LATCH_SET | WL_TIMEOUT, BTBUILD_WAIT_INTERVAL);
+            ResetLatch(&t_thrd.proc->procLatch);
+            CHECK_FOR_INTERRUPTS();
+        }
+
+        errno_t rc = memcpy_s(chunk->data + chunk->used, BTBUILD_CHUNK_SIZE - chunk->used, itup, IndexTupleSize(itup));
+        securec_check(rc, "\0", "\0");
+        chunk->used += itemsz;
+
+        if (should_free)
+            pfree(itup);
+    }
+
+    pg_write_barrier();
+    queue->done = true;
+    SetLatch(shared->leaderLatch);
+}
+
+/*
+ * Give back the leader's transaction before ShutdownPostgres aborts ours,
+ * registered after it so that it runs first.
+ */
+static void _bt_parallel_worker_detach(int code, Datum arg)
+{
+    BTBuildWorker* worker = (BTBuildWorker*)DatumGetPointer(arg);
+
+    if (worker->xactBorrowed) {
+        StreamTxnContextResetTransactionState();
+        worker->xactBorrowed = false;
+    }
+}
+
+static void _bt_parallel_worker_exit(int code, Datum arg)
+{
+    BTBuildWorker* worker = (BTBuildWorker*)DatumGetPointer(arg);
+    Latch* latch = worker->shared->leaderLatch;
+
+    MyBTBuildWorker = NULL;
+    worker->proc = NULL;
+    pg_write_barrier();
+    worker->state = BTBUILD_WORKER_EXITED;
+    SetLatch(latch);
+}
@@ -21,6 +21,7 @@
 #include "access/relscan.h"
 #include "miscadmin.h"
 #include "utils/array.h"
+#include "utils/datum.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
@@ -35,9 +36,12 @@ typedef struct BTSortArrayContext {
 static Datum _bt_find_extreme_element(IndexScanDesc scan, ScanKey skey, StrategyNumber strat, const Datum* elems, int nelems);
 static int _bt_sort_array_elements(IndexScanDesc scan, ScanKey skey, bool reverse, Datum* elems, int nelems);
 static int _bt_compare_array_elements(const void* a, const void* b, void* arg);
+static RegProcedure _bt_skip_scan_eqproc(IndexScanDesc scan);
 static bool _bt_compare_scankey_args(IndexScanDesc scan, ScanKey op, ScanKey leftarg, ScanKey rightarg, bool* result);
 static bool _bt_fix_scankey_strategy(ScanKey skey, const int16* indoption);
 static void _bt_mark_scankey_required(ScanKey skey);
+static int _bt_compare_tids(const void* a, const void* b);
+static bool _bt_posting_all_killed(BTScanOpaque so, IndexTuple ituple, ItemPointer* killedTids);
 static bool _bt_check_rowcompare(
     ScanKey skey, IndexTuple tuple, TupleDesc tupdesc, ScanDirection dir, bool* continuescan);
 
@@ -57,7 +61,8 @@ ScanKey _bt_mkscankey(Relation rel, IndexTuple itup)
     int i;
 
     itupdesc = RelationGetDescr(rel);
-    natts = RelationGetNumberOfAttributes(rel);
+    /* the included columns are not compared */
+    natts = IndexRelationGetNumberOfKeyAttributes(rel);
     indoption = rel->rd_indoption;
 
     skey = (ScanKey)palloc(natts * sizeof(ScanKeyData));
@@ -99,7 +104,7 @@ ScanKey _bt_mkscankey_nodata(Relation rel)
     int16* indoption = NULL;
     int i;
 
-    natts = RelationGetNumberOfAttributes(rel);
+    natts = IndexRelationGetNumberOfKeyAttributes(rel);
     indoption = rel->rd_indoption;
 
     skey = (ScanKey)palloc(natts * sizeof(ScanKeyData));
@@ -136,6 +141,45 @@ void _bt_freeskey(ScanKey skey)
     skey = NULL;
 }
 
+/*
+ * _bt_nonkey_truncate() -- remove the included columns from a tuple.
+ *
+ * The high keys of leaf pages and the downlinks above them only guide the
+ * descent, which compares the key columns alone, so they are stored without
+ * the included columns.  Returns a palloc'd tuple with the same item pointer.
+ */
+IndexTuple _bt_nonkey_truncate(Relation rel, IndexTuple itup)
+{
+    int nkeyattrs = IndexRelationGetNumberOfKeyAttributes(rel);
+
+    Assert(nkeyattrs < IndexRelationGetNumberOfAttributes(rel));
+    return index_truncate_tuple(RelationGetDescr(rel), itup, nkeyattrs);
+}
+
+/*
+ * _bt_pivot_tuple() -- make a leaf tuple into a high key.
+ *
+ * Besides the included columns, a posting list tuple loses its posting list;
+ * its first heap TID becomes the item pointer, like that of a plain tuple.
+ * Returns a palloc'd tuple.
+ */
+IndexTuple _bt_pivot_tuple(Relation rel, IndexTuple itup)
+{
+    IndexTuple pivot;
+
+    if (IndexRelationGetNumberOfKeyAttributes(rel) < IndexRelationGetNumberOfAttributes(rel)) {
+        pivot = _bt_nonkey_truncate(rel, itup);
+        if (BTreeTupleIsPosting(itup))
+            pivot->t_tid = *BTreeTupleGetPosting(itup);
+    } else if (BTreeTupleIsPosting(itup)) {
+        pivot = _bt_form_posting(itup, BTreeTupleGetPosting(itup), 1);
+    } else {
+        pivot = CopyIndexTuple(itup);
+    }
+
+    return pivot;
+}
+
 /*
  * free a retracement stack made by _bt_search.
  */
@@ -161,6 +205,12 @@ void _bt_freestack(BTStack stack)
  * array keys, it's sufficient to find the extreme element value and replace
  * the whole array with that scalar value.
  *
+ * If the caller allows a skip scan and there are no keys on the leading index
+ * column, we also put an equality key on that column in front of the
+ * caller's keys.  It works like an array key that is more significant than
+ * all the others, except that its values are found by probing the index
+ * (see _bt_skip_advance) instead of coming from an array.
+ *
  * Note: the reason we need so->arrayKeyData, rather than just scribbling
  * on scan->keyData, is that callers are permitted to call btrescan without
  * supplying a new set of scankey data.
@@ -175,6 +225,12 @@ void _bt_preprocess_array_keys(IndexScanDesc scan)
     int i;
     MemoryContext oldContext;
     errno_t rc;
+    RegProcedure skipEqProc = _bt_skip_scan_eqproc(scan);
+    int keyOffset = RegProcedureIsValid(skipEqProc) ? 1 : 0;
+
+    so->skipScan = false;
+    so->skipHaveValue = false;
+    so->markSkipValid = false;
 
     /* Quick check to see if there are any array keys */
     numArrayKeys = 0;
@@ -193,7 +249,7 @@ void _bt_preprocess_array_keys(IndexScanDesc scan)
     }
 
     /* Quit if nothing to do. */
-    if (numArrayKeys == 0) {
+    if (numArrayKeys == 0 && keyOffset == 0) {
         so->numArrayKeys = 0;
         so->arrayKeyData = NULL;
         return;
@@ -213,13 +269,29 @@ void _bt_preprocess_array_keys(IndexScanDesc scan)
     oldContext = MemoryContextSwitchTo(so->arrayContext);
 
     /* Create modifiable copy of scan->keyData in the workspace context */
-    so->arrayKeyData = (ScanKey)palloc(scan->numberOfKeys * sizeof(ScanKeyData));
-    rc = memcpy_s(so->arrayKeyData,
+    so->arrayKeyData = (ScanKey)palloc((scan->numberOfKeys + keyOffset) * sizeof(ScanKeyData));
+    rc = memcpy_s(so->arrayKeyData + keyOffset,
         scan->numberOfKeys * sizeof(ScanKeyData),
         scan->keyData,
         scan->numberOfKeys * sizeof(ScanKeyData));
     securec_check(rc, "", "");
 
+    /*
+     * Set up the leading column key of a skip scan.  Its value is filled in
+     * by _bt_skip_advance once we know the scan direction; until then it
+     * reads as "IS NULL".
+     */
+    if (keyOffset > 0) {
+        ScanKeyEntryInitialize(&so->arrayKeyData[0],
+            SK_ISNULL | SK_SEARCHNULL,
+            1,
+            InvalidStrategy,
+            InvalidOid,
+            InvalidOid,
+            skipEqProc,
+            (Datum)0);
+    }
+
     /* Allocate space for per-array data in the workspace context */
     so->arrayKeys = (BTArrayKeyInfo*)palloc0(numArrayKeys * sizeof(BTArrayKeyInfo));
 
@@ -236,7 +308,7 @@ void _bt_preprocess_array_keys(IndexScanDesc scan)
         int num_nonnulls;
         int j;
 
-        cur = &so->arrayKeyData[i];
+        cur = &so->arrayKeyData[i + keyOffset];
         if (!(cur->sk_flags & SK_SEARCHARRAY)) {
             continue;
         }
@@ -307,17 +379,55 @@ void _bt_preprocess_array_keys(IndexScanDesc scan)
         /*
          * And set up the BTArrayKeyInfo data.
          */
-        so->arrayKeys[numArrayKeys].scan_key = i;
+        so->arrayKeys[numArrayKeys].scan_key = i + keyOffset;
         so->arrayKeys[numArrayKeys].num_elems = num_elems;
         so->arrayKeys[numArrayKeys].elem_values = elem_values;
         numArrayKeys++;
     }
 
     so->numArrayKeys = numArrayKeys;
+    so->skipScan = (keyOffset > 0);
 
     MemoryContextSwitchTo(oldContext);
 }
 
+/*
+ * _bt_skip_scan_eqproc() -- can this scan skip over the leading column?
+ *
+ * A skip scan is only worthwhile when the caller asked for it, the leading
+ * column has no keys of its own, and the second column has some that can
+ * bound each primitive scan.  Returns the leading column's equality
+ * function, or InvalidOid if we shouldn't skip.
+ */
+static RegProcedure _bt_skip_scan_eqproc(IndexScanDesc scan)
+{
+    Relation rel = scan->indexRelation;
+    bool haveSecond = false;
+    Oid eqOpr;
+
+    if (!scan->xs_skip_scan || IndexRelationGetNumberOfKeyAttributes(rel) < 2) {
+        return InvalidOid;
+    }
+
+    for (int i = 0; i < scan->numberOfKeys; i++) {
+        if (scan->keyData[i].sk_attno == 1) {
+            return InvalidOid;
+        }
+        if (scan->keyData[i].sk_attno == 2) {
+            haveSecond = true;
+        }
+    }
+    if (!haveSecond) {
+        return InvalidOid;
+    }
+
+    eqOpr = get_opfamily_member(rel->rd_opfamily[0], rel->rd_opcintype[0], rel->rd_opcintype[0], BTEqualStrategyNumber);
+    if (!OidIsValid(eqOpr)) {
+        return InvalidOid;
+    }
+    return get_opcode(eqOpr);
+}
+
 /*
  * _bt_find_extreme_element() -- get least or greatest array element
  *
@@ -473,8 +583,10 @@ static int _bt_compare_array_elements(const void* a, const void* b, void* arg)
  *
  * Set up the cur_elem counters and fill in the first sk_argument value for
  * each array scankey.	We can't do this until we know the scan direction.
+ * A skip scan also looks up its first leading column value here; we return
+ * FALSE if there is none, that is if the index is empty.
  */
-void _bt_start_array_keys(IndexScanDesc scan, ScanDirection dir)
+bool _bt_start_array_keys(IndexScanDesc scan, ScanDirection dir)
 {
     BTScanOpaque so = (BTScanOpaque)scan->opaque;
     for (int i = 0; i < so->numArrayKeys; i++) {
@@ -489,6 +601,12 @@ void _bt_start_array_keys(IndexScanDesc scan, ScanDirection dir)
         }
         skey->sk_argument = curArrayKey->elem_values[curArrayKey->cur_elem];
     }
+
+    if (so->skipScan) {
+        so->skipHaveValue = false;
+        return _bt_skip_advance(scan, dir);
+    }
+    return true;
 }
 
 /*
@@ -538,6 +656,11 @@ bool _bt_advance_array_keys(IndexScanDesc scan, ScanDirection dir)
         }
     }
 
+    /* Once all the arrays have wrapped around, move on to the next leading value */
+    if (!found && so->skipScan) {
+        found = _bt_skip_advance(scan, dir);
+    }
+
     return found;
 }
 
@@ -555,6 +678,24 @@ void _bt_mark_array_keys(IndexScanDesc scan)
         BTArrayKeyInfo* curArrayKey = &so->arrayKeys[i];
         curArrayKey->mark_elem = curArrayKey->cur_elem;
     }
+
+    /* The skip key's value is only kept in the key itself, so copy it */
+    if (so->skipScan) {
+        ScanKey skey = &so->arrayKeyData[0];
+        Form_pg_attribute attr = RelationGetDescr(scan->indexRelation)->attrs[0];
+
+        if (so->markSkipValid && !so->markSkipIsNull && !attr->attbyval) {
+            pfree(DatumGetPointer(so->markSkipValue));
+        }
+        so->markSkipValid = so->skipHaveValue;
+        so->markSkipIsNull = (skey->sk_flags & SK_ISNULL) != 0;
+        so->markSkipValue = (Datum)0;
+        if (so->markSkipValid && !so->markSkipIsNull) {
+            MemoryContext oldContext = MemoryContextSwitchTo(so->arrayContext);
+            so->markSkipValue = datumCopy(skey->sk_argument, attr->attbyval, attr->attlen);
+            MemoryContextSwitchTo(oldContext);
+        }
+    }
 }
 
 /*
@@ -580,6 +721,11 @@ void _bt_restore_array_keys(IndexScanDesc scan)
         }
     }
 
+    if (so->skipScan && so->markSkipValid) {
+        _bt_set_skip_key(scan, so->markSkipValue, so->markSkipIsNull);
+        changed = true;
+    }
+
     /*
      * If we changed any keys, we must redo _bt_preprocess_keys.  That might
      * sound like overkill, but in cases with multiple keys per index column
@@ -592,6 +738,41 @@ void _bt_restore_array_keys(IndexScanDesc scan)
     }
 }
 
+/*
+ * _bt_set_skip_key() -- Set the leading column value of a skip scan
+ *
+ * The value is copied into the array context, replacing the previous one.
+ * A NULL value turns the key into an "IS NULL" search.
+ */
+void _bt_set_skip_key(IndexScanDesc scan, Datum value, bool isnull)
+{
+    BTScanOpaque so = (BTScanOpaque)scan->opaque;
+    Relation rel = scan->indexRelation;
+    Form_pg_attribute attr = RelationGetDescr(rel)->attrs[0];
+    ScanKey skey = &so->arrayKeyData[0];
+
+    Assert(so->skipScan);
+    if (so->skipHaveValue && !(skey->sk_flags & SK_ISNULL) && !attr->attbyval) {
+        pfree(DatumGetPointer(skey->sk_argument));
+    }
+
+    if (isnull) {
+        /* _bt_fix_scankey_strategy fills in the strategy */
+        skey->sk_flags = SK_ISNULL | SK_SEARCHNULL;
+        skey->sk_argument = (Datum)0;
+    } else {
+        MemoryContext oldContext = MemoryContextSwitchTo(so->arrayContext);
+
+        skey->sk_flags = 0;
+        skey->sk_strategy = BTEqualStrategyNumber;
+        skey->sk_subtype = rel->rd_opcintype[0];
+        skey->sk_collation = rel->rd_indcollation[0];
+        skey->sk_argument = datumCopy(value, attr->attbyval, attr->attlen);
+        MemoryContextSwitchTo(oldContext);
+    }
+    so->skipHaveValue = true;
+}
+
 /* use to reduce the number of memset operations */
 #define RESET_STRATEGY_KEYS(xform)  \
 do {                              \
@@ -607,8 +788,9 @@ do {                              \
  *
  * The given search-type keys (in scan->keyData[] or so->arrayKeyData[])
  * are copied to so->keyData[] with possible transformation.
- * scan->numberOfKeys is the number of input keys, so->numberOfKeys gets
- * the number of output keys (possibly less, never greater).
+ * scan->numberOfKeys is the number of input keys (plus one for the leading
+ * column key of a skip scan), so->numberOfKeys gets the number of output
+ * keys (possibly less, never greater).
  *
  * The output keys are marked with additional sk_flag bits beyond the
  * system-standard bits supplied by the caller.  The DESC and NULLS_FIRST
@@ -689,7 +871,8 @@ do {                              \
 void _bt_preprocess_keys(IndexScanDesc scan)
 {
     BTScanOpaque so = (BTScanOpaque)scan->opaque;
-    int numberOfKeys = scan->numberOfKeys;
+    /* a skip scan has its leading column key in front of the caller's keys */
+    int numberOfKeys = so->skipScan ? scan->numberOfKeys + 1 : scan->numberOfKeys;
     int16* indoption = scan->indexRelation->rd_indoption;
     int new_numberOfKeys;
     int numberOfEqualCols;
@@ -1577,6 +1760,7 @@ void _bt_killitems(IndexScanDesc scan, bool haveLock)
     OffsetNumber maxoff;
     int i;
     bool killedsomething = false;
+    ItemPointer killedTids = NULL;
 
     Assert(BufferIsValid(so->currPos.buf));
 
@@ -1601,7 +1785,17 @@ void _bt_killitems(IndexScanDesc scan, bool haveLock)
         while (offnum <= maxoff) {
             ItemId iid = PageGetItemId(page, offnum);
             IndexTuple ituple = (IndexTuple)PageGetItem(page, iid);
-            if (ItemPointerEquals(&ituple->t_tid, &kitem->heapTid)) {
+            if (BTreeTupleIsPosting(ituple)) {
+                if (bsearch(&kitem->heapTid, BTreeTupleGetPosting(ituple), BTreeTupleGetNPosting(ituple),
+                    sizeof(ItemPointerData), _bt_compare_tids) != NULL) {
+                    /* found the posting list, it is dead only if all of its heap TIDs are */
+                    if (_bt_posting_all_killed(so, ituple, &killedTids)) {
+                        ItemIdMarkDead(iid);
+                        killedsomething = true;
+                    }
+                    break; /* out of inner search loop */
+                }
+            } else if (ItemPointerEquals(&ituple->t_tid, &kitem->heapTid)) {
                 /* found the item */
                 ItemIdMarkDead(iid);
                 killedsomething = true;
@@ -1611,6 +1805,9 @@ void _bt_killitems(IndexScanDesc scan, bool haveLock)
         }
     }
 
+    if (killedTids != NULL)
+        pfree(killedTids);
+
     /*
      * Since this can be redone later if needed, it's treated the same as a
      * commit-hint-bit status update for heap tuples: we mark the buffer dirty
@@ -1635,6 +1832,40 @@ void _bt_killitems(IndexScanDesc scan, bool haveLock)
     so->numKilled = 0;
 }
 
+static int _bt_compare_tids(const void* a, const void* b)
+{
+    return ItemPointerCompare((ItemPointer)a, (ItemPointer)b);
+}
+
+/*
+ * Are all the heap TIDs of a posting list tuple among the killed items of the
+ * scan?  The sorted TIDs of the killed items are built in *killedTids on the
+ * first call.
+ */
+static bool _bt_posting_all_killed(BTScanOpaque so, IndexTuple ituple, ItemPointer* killedTids)
+{
+    int nposting = BTreeTupleGetNPosting(ituple);
+    int i;
+
+    if (nposting > so->numKilled)
+        return false;
+
+    if (*killedTids == NULL) {
+        *killedTids = (ItemPointer)palloc(so->numKilled * sizeof(ItemPointerData));
+        for (i = 0; i < so->numKilled; i++)
+            (*killedTids)[i] = so->currPos.items[so->killedItems[i]].heapTid;
+        qsort(*killedTids, so->numKilled, sizeof(ItemPointerData), _bt_compare_tids);
+    }
+
+    for (i = 0; i < nposting; i++) {
+        if (bsearch(BTreeTupleGetPostingN(ituple, i), *killedTids, so->numKilled, sizeof(ItemPointerData),
+            _bt_compare_tids) == NULL)
+            return false;
+    }
+
+    return true;
+}
+
 /*
  * The following routines manage a shared-memory area in which we track
  * assignment of "vacuum cycle IDs" to currently-active btree vacuuming
@@ -66,6 +66,10 @@ enum {
     BTREE_NEWROOT_META_BLOCK_NUM
 };
 
+enum {
+    BTREE_DEDUP_ORIG_BLOCK_NUM = 0,
+};
+
 /*
  * We must keep track of expected insertions due to page splits, and apply
  * them manually if they are not seen in the WAL log during replay.  This
@@ -385,6 +389,27 @@ static void btree_xlog_vacuum(XLogReaderState* record)
         UnlockReleaseBuffer(redobuf.buf);
 }
 
+static void btree_xlog_dedup(XLogReaderState* record)
+{
+    RedoBufferInfo redobuf;
+
+    /*
+     * VACUUM logs the removal of heap TIDs from posting lists with this
+     * record, so take a cleanup lock like btree_xlog_vacuum does.
+     */
+    if (XLogReadBufferForRedoExtended(record, BTREE_DEDUP_ORIG_BLOCK_NUM, RBM_NORMAL, true, &redobuf) ==
+        BLK_NEEDS_REDO) {
+        char* ptr = NULL;
+        Size len;
+
+        ptr = XLogRecGetBlockData(record, BTREE_DEDUP_ORIG_BLOCK_NUM, &len);
+        btree_xlog_dedup_operator_page(&redobuf, (void*)ptr, len);
+        MarkBufferDirty(redobuf.buf);
+    }
+    if (BufferIsValid(redobuf.buf))
+        UnlockReleaseBuffer(redobuf.buf);
+}
+
 static void btree_xlog_delete(XLogReaderState* record)
 {
     RedoBufferInfo buffer;
@@ -589,6 +614,9 @@ void btree_redo(XLogReaderState* record)
         case XLOG_BTREE_REUSE_PAGE:
             btree_xlog_reuse_page(record);
             break;
+        case XLOG_BTREE_DEDUP:
+            btree_xlog_dedup(record);
+            break;
         default:
             ereport(PANIC, (errmsg("btree_redo: unknown op code %hhu", info)));
     }
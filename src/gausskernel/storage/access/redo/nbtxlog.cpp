@@ -77,6 +77,10 @@ enum {
     BTREE_NEWROOT_META_BLOCK_NUM,
 };
 
+enum {
+    BTREE_DEDUP_ORIG_BLOCK_NUM = 0,
+};
+
 /*
  * _bt_restore_page -- re-enter all the index tuples on a page
  *
@@ -468,6 +472,22 @@ void btree_xlog_newroot_operator_page(
     PageSetLSN(page, buffer->lsn);
 }
 
+void btree_xlog_dedup_operator_page(RedoBufferInfo* buffer, void* blkdata, Size len)
+{
+    Page page = buffer->pageinfo.page;
+    Page newpage;
+
+    /* the record holds every tuple of the page, rebuild it from scratch */
+    START_CRIT_SECTION();
+    newpage = PageGetTempPageCopySpecial(page, true);
+    END_CRIT_SECTION();
+
+    _bt_restore_page(newpage, (char*)blkdata, (int)len);
+    PageRestoreTempPage(newpage, page);
+
+    PageSetLSN(page, buffer->lsn);
+}
+
 void btree_xlog_clear_incomplete_split(RedoBufferInfo* buffer)
 {
     Page page = buffer->pageinfo.page;
@@ -732,6 +752,20 @@ static XLogRecParseState* btree_xlog_reuse_page_parse_block(XLogReaderState* rec
     return recordstatehead;
 }
 
+static XLogRecParseState* btree_xlog_dedup_parse_block(XLogReaderState* record, uint32* blocknum)
+{
+    XLogRecParseState* recordstatehead = NULL;
+
+    *blocknum = 1;
+    XLogParseBufferAllocListFunc(record, &recordstatehead, NULL);
+    if (recordstatehead == NULL) {
+        return NULL;
+    }
+
+    XLogRecSetBlockDataState(record, BTREE_DEDUP_ORIG_BLOCK_NUM, recordstatehead);
+    return recordstatehead;
+}
+
 XLogRecParseState* btree_redo_parse_to_block(XLogReaderState* record, uint32* blocknum)
 {
     uint8 info = XLogRecGetInfo(record) & ~XLR_INFO_MASK;
@@ -767,6 +801,9 @@ XLogRecParseState* btree_redo_parse_to_block(XLogReaderState* record, uint32* bl
         case XLOG_BTREE_REUSE_PAGE:
             recordblockstate = btree_xlog_reuse_page_parse_block(record, blocknum);
             break;
+        case XLOG_BTREE_DEDUP:
+            recordblockstate = btree_xlog_dedup_parse_block(record, blocknum);
+            break;
         default:
             ereport(PANIC, (errmsg("btree_redo_parse_to_block: unknown op code %u", info)));
     }
@@ -950,6 +987,24 @@ static void btree_xlog_newroot_block(
     MakeRedoBufferDirty(bufferinfo);
 }
 
+static void btree_xlog_dedup_block(
+    XLogBlockHead* blockhead, XLogBlockDataParse* blockdatarec, RedoBufferInfo* bufferinfo)
+{
+    XLogBlockDataParse* datadecode = blockdatarec;
+    XLogRedoAction action;
+    action = XLogCheckBlockDataRedoAction(datadecode, bufferinfo);
+    if (action == BLK_NEEDS_REDO) {
+        Size blkdatalen = 0;
+        char* blkdata = NULL;
+
+        blkdata = XLogBlockDataGetBlockData(datadecode, &blkdatalen);
+        Assert(blkdata != NULL);
+
+        btree_xlog_dedup_operator_page(bufferinfo, (void*)blkdata, blkdatalen);
+        MakeRedoBufferDirty(bufferinfo);
+    }
+}
+
 void btree_redo_data_block(XLogBlockHead* blockhead, XLogBlockDataParse* blockdatarec, RedoBufferInfo* bufferinfo)
 {
     uint8 info = XLogBlockHeadGetInfo(blockhead) & ~XLR_INFO_MASK;
@@ -980,6 +1035,9 @@ void btree_redo_data_block(XLogBlockHead* blockhead, XLogBlockDataParse* blockda
         case XLOG_BTREE_NEWROOT:
             btree_xlog_newroot_block(blockhead, blockdatarec, bufferinfo);
             break;
+        case XLOG_BTREE_DEDUP:
+            btree_xlog_dedup_block(blockhead, blockdatarec, bufferinfo);
+            break;
         default:
             ereport(PANIC, (errmsg("btree_redo_block: unknown op code %u", info)));
     }
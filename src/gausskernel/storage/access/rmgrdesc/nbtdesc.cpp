@@ -166,6 +166,9 @@ void btree_desc(StringInfo buf, XLogReaderState* record)
             }
             break;
         }
+        case XLOG_BTREE_DEDUP:
+            appendStringInfo(buf, "dedup");
+            break;
         default:
             appendStringInfo(buf, "UNKNOWN");
             break;
@@ -155,7 +155,7 @@ static const RmgrDispatchData g_dispatchTable[RM_MAX_ID + 1] = {
     {DispatchStandbyRecord, RmgrRecordInfoValid, RM_STANDBY_ID, XLOG_STANDBY_LOCK, XLOG_STANDBY_CSN},
     {DispatchHeap2Record, RmgrRecordInfoValid, RM_HEAP2_ID, XLOG_HEAP2_FREEZE, XLOG_HEAP2_LOGICAL_NEWPAGE},
     {DispatchHeapRecord, RmgrRecordInfoValid, RM_HEAP_ID, XLOG_HEAP_INSERT, XLOG_HEAP_INPLACE},
-    {DispatchBtreeRecord, RmgrRecordInfoValid, RM_BTREE_ID, XLOG_BTREE_INSERT_LEAF, XLOG_BTREE_REUSE_PAGE},
+    {DispatchBtreeRecord, RmgrRecordInfoValid, RM_BTREE_ID, XLOG_BTREE_INSERT_LEAF, XLOG_BTREE_DEDUP},
     {DispatchHashRecord, NULL, RM_HASH_ID, 0, 0},
     {DispatchGinRecord, RmgrRecordInfoValid, RM_GIN_ID, XLOG_GIN_CREATE_INDEX, XLOG_GIN_VACUUM_DATA_LEAF_PAGE},
     /* XLOG_GIST_PAGE_DELETE is not used and info isn't continus  */
@@ -727,6 +727,11 @@ static bool DispatchBarrierRecord(XLogReaderState* record, List* expectedTLIs, T
 }
 #endif
 
+/*
+ * MOT records are decoded in order by the transaction worker, which hands the
+ * committed transactions to the MOT redo replay workers by table hash (see
+ * redo_recovery_workers in mot.conf).
+ */
 static bool DispatchMotRecord(XLogReaderState* record, List* expectedTLIs, TimestampTz recordXTime)
 {
     DispatchTxnRecord(record, expectedTLIs, recordXTime, false);
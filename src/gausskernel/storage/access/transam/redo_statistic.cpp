@@ -32,6 +32,7 @@
 #include "access/parallel_recovery/dispatcher.h"
 #include "instruments/instr_waitevent.h"
 #include "access/parallel_recovery/spsc_blocking_queue.h"
+#include "storage/mot/mot_xlog.h"
 
 extern char redo_stats_file[MAXPGPATH];
 static const uint32 MAX_REALPATH_LEN = 4096;
@@ -189,6 +190,38 @@ char* redo_get_name_by_wait_type(uint32 type)
     }
 }
 
+/* the MOT redo replay workers, lag is the WAL distance from their last dispatched transaction */
+static void redo_get_mot_worker_info_text(char* info, uint32 max_info_len)
+{
+    MOTRedoWorkerStats worker[MOT_MAX_REDO_WORKERS];
+    uint32 worker_num = MOTGetRedoWorkerStats(worker, MOT_MAX_REDO_WORKERS);
+    errno_t errorno = EOK;
+
+    if (worker_num == 0) {
+        return;
+    }
+    errorno = snprintf_s(info + strlen(info),
+        max_info_len - strlen(info),
+        max_info_len - strlen(info) - 1,
+        "\n%-4s%-8s%-21s%-21s",
+        "mot",
+        "q_use",
+        "rep_cnt",
+        "lag");
+    securec_check_ss(errorno, "\0", "\0");
+    for (uint32 i = 0; i < worker_num; ++i) {
+        errorno = snprintf_s(info + strlen(info),
+            max_info_len - strlen(info),
+            max_info_len - strlen(info) - 1,
+            "\n%-4u%-8lu%-21lu%-21lu",
+            worker[i].id,
+            worker[i].queued,
+            worker[i].replayed,
+            (uint64)(worker[i].dispatched_lsn - worker[i].replayed_lsn));
+        securec_check_ss(errorno, "\0", "\0");
+    }
+}
+
 void redo_get_worker_info_text(char* info, uint32 max_info_len)
 {
     RedoWorkerStatsData worker[MAX_RECOVERY_THREAD_NUM] = {0};
@@ -199,6 +232,7 @@ void redo_get_worker_info_text(char* info, uint32 max_info_len)
     if (worker_num == 0) {
         errorno = snprintf_s(info, max_info_len, max_info_len - 1, "%-16s", "no redo worker");
         securec_check_ss(errorno, "\0", "\0");
+        redo_get_mot_worker_info_text(info, max_info_len);
         return;
     }
     errorno =
@@ -215,6 +249,7 @@ void redo_get_worker_info_text(char* info, uint32 max_info_len)
             worker[i].redo_rec_count);
         securec_check_ss(errorno, "\0", "\0");
     }
+    redo_get_mot_worker_info_text(info, max_info_len);
 }
 
 Datum redo_get_worker_info()
@@ -829,8 +829,13 @@ static void AssignTransactionId(TransactionState s)
 
         /*
          * ensure this test matches similar one in RecoverPreparedTransactions()
+         *
+         * With logical decoding the assignment is logged at once, so the
+         * changes of a subtransaction are known to belong to its toplevel
+         * transaction when that is streamed before its commit.
          */
-        if (t_thrd.xact_cxt.nUnreportedXids >= PGPROC_MAX_CACHED_SUBXIDS || log_unknown_top) {
+        if (t_thrd.xact_cxt.nUnreportedXids >= PGPROC_MAX_CACHED_SUBXIDS || log_unknown_top ||
+            XLogLogicalInfoActive()) {
             xl_xact_assignment xlrec;
 
             /*
@@ -7174,6 +7179,27 @@ void StreamTxnContextSetTransactionState(StreamTxnContext* stc)
     s->name = srcTranState->name;
 }
 
+/*
+ * Forget the transaction state borrowed by StreamTxnContextSetTransactionState,
+ * so that the thread can end its own transaction without touching the xid and
+ * subtransactions of the owner.
+ */
+void StreamTxnContextResetTransactionState(void)
+{
+    TransactionState s = CurrentTransactionState;
+
+    s->transactionId = InvalidTransactionId;
+    s->subTransactionId = TopSubTransactionId;
+    s->nestingLevel = 1;
+    s->childXids = NULL;
+    s->nChildXids = 0;
+    s->maxChildXids = 0;
+    s->parent = NULL;
+    s->name = NULL;
+    s->blockState = TBLOCK_STARTED;
+    t_thrd.xact_cxt.currentSubTransactionId = TopSubTransactionId;
+}
+
 /*
  * To check if we are currently a running subtransaction in a transaction block.
  */
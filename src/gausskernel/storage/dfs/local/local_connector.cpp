@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ *  local_connector.cpp
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/dfs/local/local_connector.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include <sys/stat.h>
+
+#include "access/dfs/dfs_query.h"
+
+#include "local_connector.h"
+#include "storage/fd.h"
+#include "utils/memutils.h"
+
+#define LOCAL_NOT_IMPLEMENT \
+    ereport(ERROR,          \
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED), errmodule(MOD_DFS), errmsg("%s not implemented", __FUNCTION__)));
+
+namespace dfs {
+LocalConnector::LocalConnector(MemoryContext ctx) : m_memcontext(ctx)
+{
+}
+
+LocalConnector::~LocalConnector()
+{
+}
+
+bool LocalConnector::isDfsFile(const char *filePath)
+{
+    return this->isDfsFile(filePath, true);
+}
+
+/*
+ * @Description: is file
+ * @IN filePath: file path
+ * @IN throw_error: report error when the path does not exist
+ * @Return: true for regular file, false for directory or others
+ * @See also:
+ */
+bool LocalConnector::isDfsFile(const char *filePath, bool throw_error)
+{
+    Assert(filePath);
+
+    struct stat st;
+    if (stat(filePath, &st) != 0) {
+        if (throw_error) {
+            ereport(ERROR, (errcode_for_file_access(), errmodule(MOD_DFS),
+                            errmsg("could not stat file \"%s\": %m", filePath)));
+        }
+        return false;
+    }
+
+    return S_ISREG(st.st_mode);
+}
+
+bool LocalConnector::isDfsEmptyFile(const char *filePath)
+{
+    Assert(filePath);
+
+    struct stat st;
+    if (stat(filePath, &st) != 0) {
+        ereport(ERROR, (errcode_for_file_access(), errmodule(MOD_DFS),
+                        errmsg("could not stat file \"%s\": %m", filePath)));
+    }
+
+    return S_ISREG(st.st_mode) && st.st_size == 0;
+}
+
+int64_t LocalConnector::getFileSize(const char *filePath)
+{
+    Assert(filePath);
+
+    struct stat st;
+    if (stat(filePath, &st) != 0) {
+        return -1;
+    }
+
+    return (int64_t)st.st_size;
+}
+
+void *LocalConnector::getHandler() const
+{
+    return NULL;
+}
+
+List *LocalConnector::listDirectory(char *folderPath)
+{
+    return this->listDirectory(folderPath, true);
+}
+
+/*
+ * @Description: list directory
+ * @IN folderPath: directory path
+ * @IN throw_error: report error when the directory can not be opened
+ * @Return: full paths of the entries of the directory
+ * @See also:
+ */
+List *LocalConnector::listDirectory(char *folderPath, bool throw_error)
+{
+    Assert(folderPath);
+
+    List *entryList = NIL;
+    struct dirent *de = NULL;
+    const char *separator = (folderPath[strlen(folderPath) - 1] == '/') ? "" : "/";
+
+    AutoContextSwitch memGuard(m_memcontext);
+
+    DIR *dir = AllocateDir(folderPath);
+    if (dir == NULL && !throw_error) {
+        return NIL;
+    }
+
+    /* ReadDir reports the error of a NULL dir */
+    while ((de = ReadDir(dir, folderPath)) != NULL) {
+        if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) {
+            continue;
+        }
+
+        StringInfoData entry;
+        initStringInfo(&entry);
+        appendStringInfo(&entry, "%s%s%s", folderPath, separator, de->d_name);
+        entryList = lappend(entryList, entry.data);
+    }
+    FreeDir(dir);
+
+    return entryList;
+}
+
+/*
+ * @Description: collect the splits of the files under path into fileList.
+ * The names of a directory are read before descending into it, so only one
+ * directory is open at any time whatever the depth of the partitions.
+ * @IN path: file or directory path
+ * @IN slashNum: slashes of the primitive prefix
+ * @OUT fileList: the splits found
+ * @See also:
+ */
+void LocalConnector::listFiles(const char *path, int slashNum, List **fileList)
+{
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        ereport(ERROR, (errcode_for_file_access(), errmodule(MOD_DFS), errmsg("could not stat file \"%s\": %m", path)));
+    }
+
+    if (S_ISREG(st.st_mode)) {
+        /* empty files have neither rows nor a footer to read */
+        if (st.st_size == 0) {
+            ereport(DEBUG1, (errmodule(MOD_DFS), errmsg("list file, skipped empty file %s", path)));
+            return;
+        }
+
+        SplitInfo *split = InitFileSplit(pstrdup(path), NIL, (int64)st.st_size);
+        split->prefixSlashNum = slashNum;
+        *fileList = lappend(*fileList, split);
+        return;
+    }
+
+    if (!S_ISDIR(st.st_mode)) {
+        return;
+    }
+
+    List *entryList = listDirectory((char *)path, true);
+    ListCell *cell = NULL;
+    foreach (cell, entryList) {
+        char *entry = (char *)lfirst(cell);
+        char *entryName = strrchr(entry, '/') + 1;
+
+        /* the same names are skipped as for the objects of obs */
+        if (checkFileShouldSkip(entryName)) {
+            ereport(DEBUG1, (errmodule(MOD_DFS), errmsg("list file, skipped, path is %s", entry)));
+            continue;
+        }
+
+        listFiles(entry, slashNum, fileList);
+    }
+    list_free_deep(entryList);
+}
+
+/*
+ * @Description: list the files under a path
+ * @IN searchPath: file or directory path
+ * @IN primitivePrefix: the folder of the foreign table, the partition directories follow its slashes
+ * @Return: split list of the files
+ * @See also:
+ */
+List *LocalConnector::listObjectsStat(char *searchPath, const char *primitivePrefix)
+{
+    Assert(searchPath != NULL);
+
+    List *fileList = NIL;
+    const char *prefix = (primitivePrefix != NULL) ? primitivePrefix : searchPath;
+    int slashNum = getSpecialCharCnt(prefix, '/');
+
+    AutoContextSwitch memGuard(m_memcontext);
+
+    /* "/data/ft" and "/data/ft/" both end with the slash before the first partition directory */
+    if (prefix[strlen(prefix) - 1] != '/' && !isDfsFile(prefix, false)) {
+        slashNum++;
+    }
+
+    listFiles(searchPath, slashNum, &fileList);
+
+    ereport(LOG, (errmodule(MOD_DFS),
+                  errmsg("listObjectsStat \"%s\", objectListSize = %d", searchPath, list_length(fileList))));
+
+    return fileList;
+}
+
+DFSBlockInfo *LocalConnector::getBlockLocations(char *filePath)
+{
+    LOCAL_NOT_IMPLEMENT;
+    return NULL;
+}
+
+int LocalConnector::dropDirectory(const char *path, int recursive)
+{
+    LOCAL_NOT_IMPLEMENT;
+    return 0;
+}
+
+int LocalConnector::createDirectory(const char *path)
+{
+    LOCAL_NOT_IMPLEMENT;
+    return 0;
+}
+
+int LocalConnector::openFile(const char *path, int flag)
+{
+    LOCAL_NOT_IMPLEMENT;
+    return 0;
+}
+
+int LocalConnector::deleteFile(const char *path, int recursive)
+{
+    LOCAL_NOT_IMPLEMENT;
+    return 0;
+}
+
+bool LocalConnector::pathExists(const char *filePath)
+{
+    Assert(filePath);
+
+    struct stat st;
+    return stat(filePath, &st) == 0;
+}
+
+bool LocalConnector::existsFile(const char *path)
+{
+    return this->isDfsFile(path, false);
+}
+
+bool LocalConnector::hasValidFile() const
+{
+    return false;
+}
+
+int LocalConnector::writeCurrentFile(const char *buffer, int length)
+{
+    LOCAL_NOT_IMPLEMENT;
+    return 0;
+}
+
+int LocalConnector::readCurrentFileFully(char *buffer, int length, int64 offset)
+{
+    LOCAL_NOT_IMPLEMENT;
+    return 0;
+}
+
+int LocalConnector::flushCurrentFile()
+{
+    return 0;
+}
+
+void LocalConnector::closeCurrentFile()
+{
+}
+
+int LocalConnector::chmod(const char *filePath, short mode)
+{
+    LOCAL_NOT_IMPLEMENT;
+    return 0;
+}
+
+int LocalConnector::setLabelExpression(const char *filePath, const char *expression)
+{
+    LOCAL_NOT_IMPLEMENT;
+    return 0;
+}
+
+int64 LocalConnector::getLastModifyTime(const char *filePath)
+{
+    Assert(filePath);
+
+    struct stat st;
+    if (stat(filePath, &st) != 0) {
+        ereport(ERROR, (errcode_for_file_access(), errmodule(MOD_DFS),
+                        errmsg("could not stat file \"%s\": %m", filePath)));
+    }
+
+    return (int64)st.st_mtime;
+}
+
+const char *LocalConnector::getValue(const char *key, const char *defValue) const
+{
+    return defValue;
+}
+
+int LocalConnector::getType()
+{
+    return (int)LOCAL_CONNECTOR;
+}
+}  // namespace dfs
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * local_connector.h
+ *
+ * The connector of the local server type, which reads orc and parquet files
+ * from the file system of the datanode itself. It is read only, the files are
+ * read through the input stream of the dfs stream factory.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/dfs/local/local_connector.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#ifndef LOCAL_CONNECTOR_H
+#define LOCAL_CONNECTOR_H
+
+#include "storage/dfs/dfs_connector.h"
+
+namespace dfs {
+class LocalConnector : public DFSConnector {
+public:
+    explicit LocalConnector(MemoryContext ctx);
+    virtual ~LocalConnector();
+
+private:
+    /* Check if the path is a regular file, log error if the path does not exist and throw_error is set. */
+    virtual bool isDfsFile(const char *filePath);
+    virtual bool isDfsFile(const char *filePath, bool throw_error);
+
+    /* Check if the path is a empty file. */
+    virtual bool isDfsEmptyFile(const char *filePath);
+
+    /* Get the file size of the path. Return -1 if the path does not exist. */
+    virtual int64_t getFileSize(const char *filePath);
+
+    /* There is no handler for the local file system, return NULL. */
+    virtual void *getHandler() const;
+
+    /* Get list of the full paths of the entries in the given directory. */
+    virtual List *listDirectory(char *folderPath);
+    virtual List *listDirectory(char *folderPath, bool throw_error);
+
+    /*
+     * Get the splits of all the files under searchPath, searching its sub
+     * directories too. primitivePrefix is the folder defined for the foreign
+     * table, whose slashes mark where the partition directories start.
+     */
+    virtual List *listObjectsStat(char *searchPath, const char *primitivePrefix = NULL);
+
+    virtual DFSBlockInfo *getBlockLocations(char *filePath);
+    virtual int dropDirectory(const char *path, int recursive);
+    virtual int createDirectory(const char *path);
+    virtual int openFile(const char *path, int flag);
+    virtual int deleteFile(const char *path, int recursive);
+    virtual bool pathExists(const char *filePath);
+    virtual bool existsFile(const char *path);
+    virtual bool hasValidFile() const;
+    virtual int writeCurrentFile(const char *buffer, int length);
+    virtual int readCurrentFileFully(char *buffer, int length, int64 offset);
+    virtual int flushCurrentFile();
+    virtual void closeCurrentFile();
+    virtual int chmod(const char *filePath, short mode);
+    virtual int setLabelExpression(const char *filePath, const char *expression);
+    virtual int64 getLastModifyTime(const char *filePath);
+    virtual const char *getValue(const char *key, const char *defValue) const;
+    virtual int getType();
+
+    void listFiles(const char *path, int slashNum, List **fileList);
+
+private:
+    MemoryContext m_memcontext;
+};
+}  // namespace dfs
+#endif
@@ -32,6 +32,12 @@
  * BufFile also supports temporary files that exceed the OS file size limit
  * (by opening multiple fd.c temporary files).	This is an essential feature
  * for sorts and hashjoins on large amounts of data.
+ *
+ * A compressed temp BufFile compresses every logical BLCKSZ block with LZ4
+ * on its own and appends it to the physical files.  A block map keeps the
+ * physical place of each logical block, so that seeks and block rewrites
+ * (as done by logtape.c) work just like on a plain BufFile.  The buffer of
+ * a compressed BufFile always holds one whole logical block.
  * -------------------------------------------------------------------------
  */
 #include "postgres.h"
@@ -43,6 +49,7 @@
 #include "storage/buffile.h"
 #include "storage/buf_internals.h"
 #include "utils/aiomem.h"
+#include "lz4.h"
 #include "utils/resowner.h"
 
 /*
@@ -53,6 +60,21 @@
 #define MAX_PHYSICAL_FILESIZE 0x40000000
 #define BUFFILE_SEG_SIZE (MAX_PHYSICAL_FILESIZE / BLCKSZ)
 
+/* initial number of entries of the block map of a compressed BufFile */
+#define BUFFILE_INIT_MAP_SIZE 64
+
+/*
+ * Physical place of one logical block of a compressed BufFile.  A block is
+ * stored as is when LZ4 can not make it smaller, that is when storedLen is
+ * equal to rawLen.  A block never crosses a physical file boundary.
+ */
+typedef struct BufFileBlock {
+    off_t physPos;   /* position over all physical files, 0 if never written */
+    uint16 slotLen;  /* space reserved at physPos, reused by rewrites */
+    uint16 storedLen; /* bytes stored at physPos */
+    uint16 rawLen;   /* valid bytes of the logical block */
+} BufFileBlock;
+
 /*
  * This data structure represents a buffered file that consists of one or
  * more physical files (each accessed through a virtual file descriptor
@@ -89,6 +111,16 @@ struct BufFile {
     int nbytes;      /* total # of valid bytes in buffer */
     char* buffer;    /* adio need pointer align */
 
+    /* compressed temp file, see notes at the top */
+    bool compress;
+    BufFileBlock* blockMap; /* logical block number -> physical place */
+    long mapBlocks;         /* # of logical blocks in blockMap */
+    long mapSize;           /* # of allocated entries of blockMap */
+    off_t physEnd;          /* append position over all physical files */
+    char* compressBuf;      /* LZ4 work buffer */
+    int64* rawSize;         /* if not NULL, add up bytes before compression */
+    int64* compressSize;    /* if not NULL, add up bytes written to disk */
+
     char pad; /* extra 1 byte, just a workaround for the memory issue of pread */
 };
 
@@ -97,6 +129,12 @@ static void extendBufFile(BufFile* file);
 static void BufFileLoadBuffer(BufFile* file);
 static void BufFileDumpBuffer(BufFile* file);
 static int BufFileFlush(BufFile* file);
+static void BufFileLoadBlock(BufFile* file);
+static void BufFileDumpBlock(BufFile* file);
+static void BufFileNextBlock(BufFile* file);
+static size_t BufFileReadCompressed(BufFile* file, void* ptr, size_t size);
+static size_t BufFileWriteCompressed(BufFile* file, void* ptr, size_t size);
+static int BufFileSeekCompressed(BufFile* file, int fileno, off_t offset, int whence);
 
 /*
  * Create a BufFile given the first underlying physical file.
@@ -136,6 +174,14 @@ static BufFile* makeBufFile(File firstfile)
     file->curOffset = 0L;
     file->pos = 0;
     file->nbytes = 0;
+    file->compress = false;
+    file->blockMap = NULL;
+    file->mapBlocks = 0;
+    file->mapSize = 0;
+    file->physEnd = 0L;
+    file->compressBuf = NULL;
+    file->rawSize = NULL;
+    file->compressSize = NULL;
     file->pad = '\0';
 
     return file;
@@ -200,6 +246,25 @@ BufFile* BufFileCreateTemp(bool inter_xact)
     return main_buf_file;
 }
 
+/*
+ * Create a BufFile for a new temporary file whose blocks are compressed with
+ * LZ4.  If raw_size and compress_size are not NULL, the bytes of every block
+ * written out before and after compression are added up there.
+ */
+BufFile* BufFileCreateTempCompress(bool inter_xact, int64* raw_size, int64* compress_size)
+{
+    BufFile* file = CreateTempBufFile(inter_xact);
+
+    file->compress = true;
+    file->mapSize = BUFFILE_INIT_MAP_SIZE;
+    file->blockMap = (BufFileBlock*)palloc0(file->mapSize * sizeof(BufFileBlock));
+    file->compressBuf = (char*)palloc(LZ4_COMPRESSBOUND(BLCKSZ));
+    file->rawSize = raw_size;
+    file->compressSize = compress_size;
+
+    return file;
+}
+
 #ifdef NOT_USED
 /*
  * Create a BufFile and attach it to an already-opened virtual File.
@@ -232,6 +297,10 @@ static void CloseTempBufFile(BufFile* file)
     /* release the buffer space */
     pfree(file->files);
     pfree(file->offsets);
+    if (file->compress) {
+        pfree(file->blockMap);
+        pfree(file->compressBuf);
+    }
     pfree(file);
 }
 
@@ -387,6 +456,10 @@ size_t BufFileRead(BufFile* file, void* ptr, size_t size)
     size_t nread = 0;
     size_t nthistime;
 
+    if (file->compress) {
+        return BufFileReadCompressed(file, ptr, size);
+    }
+
     if (file->dirty) {
         if (BufFileFlush(file) != 0) {
             return (size_t)EOF; /* could not flush... */
@@ -434,6 +507,11 @@ size_t BufFileWrite(BufFile* file, void* ptr, size_t size)
     size_t nwritten = 0;
     size_t nthistime;
     errno_t rc = EOK;
+
+    if (file->compress) {
+        return BufFileWriteCompressed(file, ptr, size);
+    }
+
     while (size > 0) {
         if (file->pos >= BLCKSZ) {
             /* Buffer full, dump it out */
@@ -485,7 +563,11 @@ size_t BufFileWrite(BufFile* file, void* ptr, size_t size)
 static int BufFileFlush(BufFile* file)
 {
     if (file->dirty) {
-        BufFileDumpBuffer(file);
+        if (file->compress) {
+            BufFileDumpBlock(file);
+        } else {
+            BufFileDumpBuffer(file);
+        }
         if (file->dirty) {
             return EOF;
         }
@@ -509,6 +591,10 @@ int BufFileSeek(BufFile* file, int fileno, off_t offset, int whence)
     int new_file;
     off_t new_offset;
 
+    if (file->compress) {
+        return BufFileSeekCompressed(file, fileno, offset, whence);
+    }
+
     switch (whence) {
         case SEEK_SET:
             if (fileno < 0) {
@@ -609,6 +695,263 @@ int BufFileSeekBlock(BufFile* file, long blknum)
     return BufFileSeek(file, (int)(blknum / BUFFILE_SEG_SIZE), (off_t)(blknum % BUFFILE_SEG_SIZE) * BLCKSZ, SEEK_SET);
 }
 
+/*
+ * BufFileLoadBlock
+ *
+ * Load the logical block at curOffset of a compressed BufFile into the
+ * buffer.  On exit, nbytes is the number of valid bytes of the block, 0 if
+ * it was never written.
+ */
+static void BufFileLoadBlock(BufFile* file)
+{
+    long blknum = file->curFile * BUFFILE_SEG_SIZE + file->curOffset / BLCKSZ;
+    BufFileBlock* block = NULL;
+    char* dest = NULL;
+    File thisfile;
+
+    Assert(file->curOffset % BLCKSZ == 0);
+
+    file->dirty = false;
+    file->nbytes = 0;
+    if (blknum >= file->mapBlocks || file->blockMap[blknum].rawLen == 0) {
+        return;
+    }
+
+    block = &file->blockMap[blknum];
+    dest = (block->storedLen == block->rawLen) ? file->buffer : file->compressBuf;
+    thisfile = file->files[block->physPos / MAX_PHYSICAL_FILESIZE];
+    if (FilePRead(thisfile, dest, block->storedLen, block->physPos % MAX_PHYSICAL_FILESIZE,
+        WAIT_EVENT_BUFFILE_READ) != block->storedLen) {
+        ereport(ERROR, (errcode_for_file_access(), errmsg("could not read from temporary file: %m")));
+    }
+
+    if (dest == file->compressBuf &&
+        LZ4_decompress_safe(file->compressBuf, file->buffer, block->storedLen, BLCKSZ) != block->rawLen) {
+        ereport(ERROR,
+            (errcode(ERRCODE_DATA_CORRUPTED),
+                errmsg("could not decompress block %ld of temporary file", blknum)));
+    }
+
+    file->nbytes = block->rawLen;
+    u_sess->instr_cxt.pg_buffer_usage->temp_blks_read++;
+}
+
+/*
+ * BufFileDumpBlock
+ *
+ * Compress the buffer of a compressed BufFile and write it out as the
+ * logical block at curOffset.  A rewritten block goes back to its old place
+ * if it still fits there, otherwise it is appended.  On exit, dirty is
+ * cleared if successful write, the buffer and the position are kept.
+ */
+static void BufFileDumpBlock(BufFile* file)
+{
+    long blknum = file->curFile * BUFFILE_SEG_SIZE + file->curOffset / BLCKSZ;
+    BufFileBlock* block = NULL;
+    char* src = file->compressBuf;
+    int outsize;
+
+    Assert(file->curOffset % BLCKSZ == 0 && file->nbytes > 0);
+
+    outsize = LZ4_compress_default(file->buffer, file->compressBuf, file->nbytes, LZ4_COMPRESSBOUND(BLCKSZ));
+    if (outsize <= 0 || outsize >= file->nbytes) {
+        /* not compressible, store it as is */
+        src = file->buffer;
+        outsize = file->nbytes;
+    }
+
+    if (blknum >= file->mapSize) {
+        long newsize = Max(file->mapSize * 2, blknum + 1);
+
+        file->blockMap = (BufFileBlock*)repalloc(file->blockMap, newsize * sizeof(BufFileBlock));
+        errno_t rc = memset_s(file->blockMap + file->mapSize, (newsize - file->mapSize) * sizeof(BufFileBlock), 0,
+            (newsize - file->mapSize) * sizeof(BufFileBlock));
+        securec_check(rc, "\0", "\0");
+        file->mapSize = newsize;
+    }
+    if (blknum >= file->mapBlocks) {
+        file->mapBlocks = blknum + 1;
+    }
+
+    block = &file->blockMap[blknum];
+    if (outsize > block->slotLen) {
+        /* append a new slot, never across a physical file boundary */
+        if (file->physEnd % MAX_PHYSICAL_FILESIZE + outsize > MAX_PHYSICAL_FILESIZE) {
+            file->physEnd = (file->physEnd / MAX_PHYSICAL_FILESIZE + 1) * MAX_PHYSICAL_FILESIZE;
+        }
+        while (file->physEnd / MAX_PHYSICAL_FILESIZE >= file->numFiles) {
+            extendBufFile(file);
+        }
+        block->physPos = file->physEnd;
+        block->slotLen = (uint16)outsize;
+        file->physEnd += outsize;
+    }
+
+    if (FilePWrite(file->files[block->physPos / MAX_PHYSICAL_FILESIZE], src, outsize,
+        block->physPos % MAX_PHYSICAL_FILESIZE, WAIT_EVENT_BUFFILE_WRITE) != outsize) {
+        return; /* failed to write */
+    }
+
+    block->storedLen = (uint16)outsize;
+    block->rawLen = (uint16)file->nbytes;
+    file->dirty = false;
+
+    if (file->rawSize != NULL) {
+        *file->rawSize += file->nbytes;
+    }
+    if (file->compressSize != NULL) {
+        *file->compressSize += outsize;
+    }
+    u_sess->instr_cxt.pg_buffer_usage->temp_blks_written++;
+}
+
+/*
+ * BufFileNextBlock
+ *
+ * Move a compressed BufFile to the start of the next logical block, the
+ * current block must have been written out.
+ */
+static void BufFileNextBlock(BufFile* file)
+{
+    Assert(!file->dirty);
+
+    file->curOffset += BLCKSZ;
+    if (file->curOffset >= MAX_PHYSICAL_FILESIZE) {
+        file->curFile++;
+        file->curOffset = 0L;
+    }
+    file->pos = 0;
+    BufFileLoadBlock(file);
+}
+
+/*
+ * BufFileReadCompressed
+ *
+ * BufFileRead for a compressed BufFile.  A dirty buffer holds the whole
+ * block, so it can be read without being written out first.
+ */
+static size_t BufFileReadCompressed(BufFile* file, void* ptr, size_t size)
+{
+    size_t nread = 0;
+    size_t nthistime;
+
+    while (size > 0) {
+        if (file->pos >= file->nbytes) {
+            /* a partial block is the last one */
+            if (file->nbytes < BLCKSZ) {
+                break;
+            }
+            if (BufFileFlush(file) != 0) {
+                return (size_t)EOF;
+            }
+            BufFileNextBlock(file);
+            if (file->nbytes <= 0) {
+                break; /* no more data available */
+            }
+        }
+
+        nthistime = file->nbytes - file->pos;
+        if (nthistime > size) {
+            nthistime = size;
+        }
+
+        errno_t rc = memcpy_s(ptr, nthistime, file->buffer + file->pos, nthistime);
+        securec_check(rc, "\0", "\0");
+
+        file->pos += nthistime;
+        ptr = (void*)((char*)ptr + nthistime);
+        size -= nthistime;
+        nread += nthistime;
+    }
+
+    return nread;
+}
+
+/*
+ * BufFileWriteCompressed
+ *
+ * BufFileWrite for a compressed BufFile.
+ */
+static size_t BufFileWriteCompressed(BufFile* file, void* ptr, size_t size)
+{
+    size_t nwritten = 0;
+    size_t nthistime;
+
+    while (size > 0) {
+        if (file->pos >= BLCKSZ) {
+            /* Block full, dump it out and go on with the next one */
+            if (BufFileFlush(file) != 0) {
+                break; /* I/O error */
+            }
+            BufFileNextBlock(file);
+        }
+
+        nthistime = BLCKSZ - file->pos;
+        if (nthistime > size) {
+            nthistime = size;
+        }
+
+        errno_t rc = memcpy_s(file->buffer + file->pos, nthistime, ptr, nthistime);
+        securec_check(rc, "", "");
+
+        file->dirty = true;
+        file->pos += nthistime;
+        if (file->nbytes < file->pos) {
+            file->nbytes = file->pos;
+        }
+        ptr = (void*)((char*)ptr + nthistime);
+        size -= nthistime;
+        nwritten += nthistime;
+    }
+
+    return nwritten;
+}
+
+/*
+ * BufFileSeekCompressed
+ *
+ * BufFileSeek for a compressed BufFile.  The logical position keeps the
+ * (fileno, offset) form of a plain BufFile, with segments of
+ * MAX_PHYSICAL_FILESIZE logical bytes.
+ */
+static int BufFileSeekCompressed(BufFile* file, int fileno, off_t offset, int whence)
+{
+    off_t newpos;
+    long blknum;
+
+    switch (whence) {
+        case SEEK_SET:
+            if (fileno < 0) {
+                return EOF;
+            }
+            newpos = (off_t)fileno * MAX_PHYSICAL_FILESIZE + offset;
+            break;
+        case SEEK_CUR:
+            newpos = (off_t)file->curFile * MAX_PHYSICAL_FILESIZE + file->curOffset + file->pos + offset;
+            break;
+        default:
+            ereport(ERROR, (errcode(ERRCODE_UNDEFINED_PARAMETER), errmsg("invalid whence: %d", whence)));
+            return EOF;
+    }
+    if (newpos < 0) {
+        return EOF;
+    }
+
+    blknum = (long)(newpos / BLCKSZ);
+    if (blknum != file->curFile * BUFFILE_SEG_SIZE + file->curOffset / BLCKSZ) {
+        /* must switch to another block, so flush any dirty data */
+        if (BufFileFlush(file) != 0) {
+            return EOF;
+        }
+        file->curFile = (int)(blknum / BUFFILE_SEG_SIZE);
+        file->curOffset = (off_t)(blknum % BUFFILE_SEG_SIZE) * BLCKSZ;
+        BufFileLoadBlock(file);
+    }
+    file->pos = (int)(newpos % BLCKSZ);
+
+    return 0;
+}
+
 #ifdef NOT_USED
 /*
  * BufFileTellBlock --- block-oriented tell
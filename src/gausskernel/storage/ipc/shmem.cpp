@@ -457,7 +457,7 @@ HTAB* HeapMemInitHash(const char* name, /* table string name for shmem index */
 /* clean up (reset) this hash table in heap memory. */
 void HeapMemResetHash(HTAB* hashtbl, const char* tabname)
 {
-    HASH_SEQ_STATUS seq_scan = {NULL, 0, NULL};
+    HASH_SEQ_STATUS seq_scan = {NULL, 0, NULL, 1};
     void* hentry = NULL;
 
     hash_seq_init(&seq_scan, hashtbl);
@@ -450,6 +450,24 @@ static inline uint32 ProcLockHashCode(const PROCLOCKTAG *proclocktag, uint32 has
     return lockhash;
 }
 
+/*
+ * LockHeldByMe -- test whether the current thread holds the given lock in
+ *		the given mode, through its local lock table only.
+ */
+bool LockHeldByMe(const LOCKTAG *locktag, LOCKMODE lockmode)
+{
+    LOCALLOCKTAG localtag;
+    LOCALLOCK *locallock = NULL;
+
+    MemSet(&localtag, 0, sizeof(localtag)); /* must clear padding */
+    localtag.lock = *locktag;
+    localtag.mode = lockmode;
+
+    locallock = (LOCALLOCK *)hash_search(t_thrd.storage_cxt.LockMethodLocalHash, (void *)&localtag, HASH_FIND, NULL);
+
+    return (locallock != NULL && locallock->nLocks > 0);
+}
+
 /*
  * LockHasWaiters -- look up 'locktag' and check if releasing this
  *		lock would wake up other processes waiting for it.
@@ -137,6 +137,7 @@ static const char *BuiltinTrancheNames[] = {
     "InstrUserLockId",
     "GPCMappingLock",
     "GPCPrepareMappingLock",
+    "PgStatMappingLock",
     "BufferIOLock",
     "BufferContentLock",
     "DataCacheLock",
@@ -514,6 +515,10 @@ static void InitializeLWLocks(int numLocks)
         LWLockInitialize(&lock->lock, LWTRANCHE_GPC_PREPARE_MAPPING);
     }
 
+    for (id = 0; id < NUM_PGSTAT_PARTITIONS; id++, lock++) {
+        LWLockInitialize(&lock->lock, LWTRANCHE_PGSTAT_MAPPING);
+    }
+
     Assert((lock - t_thrd.shemem_ptr_cxt.mainLWLockArray) == NumFixedLWLocks);
 
     for (id = NumFixedLWLocks; id < numLocks; id++, lock++) {
@@ -509,7 +509,9 @@ void InitProcess(void)
          */
         if (IsUnderPostmaster &&
             (t_thrd.role == WLM_WORKER || t_thrd.role == WLM_MONITOR || t_thrd.role == WLM_ARBITER ||
-             t_thrd.role == WLM_CPMONITOR || IsJobPercentileProcess() || IsJobSnapshotProcess()))
+             t_thrd.role == WLM_CPMONITOR || IsJobPercentileProcess() || IsJobSnapshotProcess() ||
+             t_thrd.role == PARALLEL_DECODE || t_thrd.role == PARALLEL_BTBUILD ||
+             t_thrd.role == PARALLEL_VACUUM))
             (void)ReleasePostmasterChildSlot(t_thrd.proc_cxt.MyPMChildSlot);
 
         int active_count = pgstat_get_current_active_numbackends();
@@ -1078,7 +1080,9 @@ static void ProcKill(int code, Datum arg)
     if (IsUnderPostmaster &&
         ((t_thrd.role == WLM_WORKER || t_thrd.role == WLM_MONITOR || t_thrd.role == WLM_ARBITER ||
           t_thrd.role == WLM_CPMONITOR) ||
-         IsJobSnapshotProcess() || t_thrd.postmaster_cxt.IsRPCWorkerThread || IsJobPercentileProcess()))
+         IsJobSnapshotProcess() || t_thrd.postmaster_cxt.IsRPCWorkerThread || IsJobPercentileProcess() ||
+         t_thrd.role == PARALLEL_DECODE || t_thrd.role == PARALLEL_BTBUILD ||
+         t_thrd.role == PARALLEL_VACUUM))
         (void)ReleasePostmasterChildSlot(t_thrd.proc_cxt.MyPMChildSlot);
 
     /* wake autovac launcher if needed -- see comments in FreeWorkerInfo */
@@ -302,9 +302,13 @@ RC OccTransactionManager::ValidateOcc(TxnManager* txMan)
         rc = RC_ABORT;
         goto final;
     }
+    if (!PrepareRowCopies(txMan)) {
+        rc = RC_MEMORY_ALLOCATION_ERROR;
+        goto final;
+    }
 
 final:
-    if (__builtin_expect(rc == RC_ABORT, 0)) {
+    if (__builtin_expect(rc != RC_OK, 0)) {
         ReleaseHeaderLocks(txMan, numSentinelLock);
         m_abortsCounter++;
     } else {
@@ -332,7 +336,10 @@ bool OccTransactionManager::WriteChanges(TxnManager* txMan)
     // Update CSN with all relevant information on global rows
     // For deletes invalidate sentinels - rows still locked!
     for (const auto& raPair : orderedSet) {
-        const Access* access = raPair.second;
+        Access* access = raPair.second;
+        if (access->m_rowCopy != nullptr && access->m_type == WR) {
+            ResizeRow(txMan, access);
+        }
         access->GetRowFromHeader()->m_rowHeader.WriteChangesToRow(access, txMan->GetCommitSequenceNumber());
     }
 
@@ -347,6 +354,7 @@ bool OccTransactionManager::WriteChanges(TxnManager* txMan)
             if (access->m_params.IsUpgradeInsert() == false) {
                 if (access->m_params.IsPrimarySentinel()) {
                     MOT_ASSERT(access->m_origSentinel->IsDirty() == true);
+                    access->m_localInsertRow = CompactRow(txMan, access, access->m_localInsertRow);
                     // Connect row and sentinel, row is set to absent and locked
                     access->m_origSentinel->SetNextPtr(access->GetRowFromHeader());
                     // Current state: row is set to absent,sentinel is locked and not dirty
@@ -368,13 +376,14 @@ bool OccTransactionManager::WriteChanges(TxnManager* txMan)
                      */
                     Row* row = access->GetRowFromHeader();
                     access->m_localInsertRow = row;
+                    access->m_auxRow = CompactRow(txMan, access, access->m_auxRow);
                     access->m_origSentinel->SetNextPtr(access->m_auxRow);
                     // Add row to GC!
                     txMan->GetGcSession()->GcRecordObject(row->GetTable()->GetPrimaryIndex()->GetIndexId(),
                         row,
                         nullptr,
                         row->RowDtor,
-                        ROW_SIZE_FROM_POOL(row->GetTable()));
+                        ROW_SIZE_FROM_POOL(row));
                 } else {
                     // Set Sentinel for
                     access->m_origSentinel->SetNextPtr(access->m_auxRow->GetPrimarySentinel());
@@ -417,6 +426,87 @@ bool OccTransactionManager::WriteChanges(TxnManager* txMan)
     return true;
 }
 
+bool OccTransactionManager::PrepareRowCopies(TxnManager* txMan)
+{
+    // The copies are allocated before the redo record is written, so that the write phase cannot run out of memory
+    TxnOrderedSet_t& orderedSet = txMan->m_accessMgr->GetOrderedRowSet();
+    for (const auto& raPair : orderedSet) {
+        Access* access = raPair.second;
+        Row* row = nullptr;
+        if (access->m_type == WR) {
+            row = access->GetRowFromHeader();
+        } else if (access->m_type == INS && access->m_params.IsPrimarySentinel()) {
+            row = access->m_params.IsUpgradeInsert() ? access->m_auxRow : access->m_localInsertRow;
+        } else {
+            continue;
+        }
+        Table* table = row->GetTable();
+        if (!table->HasCompactRows()) {
+            continue;
+        }
+
+        uint32_t dataSize;
+        if (access->m_type == WR) {
+            // an update moves when the new data does not fit in the row or would fit in half of it
+            dataSize = table->GetRowPoolSize(table->GetRowUsedSize(access->m_localRow->GetData()));
+            if (dataSize <= row->GetTupleSize() && dataSize > row->GetTupleSize() / 2) {
+                continue;
+            }
+        } else {
+            // a new row moves to the smallest row pool fitting its data
+            dataSize = table->GetRowPoolSize(table->GetRowUsedSize(row->GetData()));
+            if (dataSize >= row->GetTupleSize()) {
+                continue;
+            }
+        }
+
+        access->m_rowCopy = table->CreateRowCopy(row, dataSize);
+        if (access->m_rowCopy == nullptr && dataSize > row->GetTupleSize()) {
+            MOT_REPORT_ERROR(MOT_ERROR_OOM,
+                "Validate OCC",
+                "Failed to allocate a row of %u bytes for an update in table %s",
+                dataSize,
+                table->GetLongTableName().c_str());
+            return false;
+        }
+        // otherwise the row stays where it is, it only holds more than it needs
+    }
+    return true;
+}
+
+void OccTransactionManager::ResizeRow(TxnManager* txMan, Access* access)
+{
+    Row* row = access->GetRowFromHeader();
+    Row* newRow = PublishRowCopy(access, row);
+
+    // The new row is locked like the old one, concurrent readers of the old row find it deleted and abort
+    access->m_origSentinel->SetNextPtr(newRow);
+    row->m_rowHeader.SetDeleted();
+    row->m_rowHeader.Release();
+    txMan->GetGcSession()->GcRecordObject(
+        row->GetTable()->GetPrimaryIndex()->GetIndexId(), row, nullptr, row->RowDtor, ROW_SIZE_FROM_POOL(row));
+}
+
+Row* OccTransactionManager::CompactRow(TxnManager* txMan, Access* access, Row* row)
+{
+    if (access->m_rowCopy == nullptr) {
+        return row;
+    }
+
+    Row* newRow = PublishRowCopy(access, row);
+    txMan->GetGcSession()->GcRecordObject(
+        row->GetTable()->GetPrimaryIndex()->GetIndexId(), row, nullptr, row->RowDtor, ROW_SIZE_FROM_POOL(row));
+    return newRow;
+}
+
+Row* OccTransactionManager::PublishRowCopy(Access* access, const Row* row)
+{
+    // the row may have changed since validation (the csn and lock of an insert), so it is copied again
+    Row* newRow = row->GetTable()->InitRowCopy(access->m_rowCopy, row);
+    access->m_rowCopy = nullptr;
+    return newRow;
+}
+
 void OccTransactionManager::CleanRowsFromIndexes(TxnManager* txMan)
 {
     if (m_deleteSetSize == 0) {
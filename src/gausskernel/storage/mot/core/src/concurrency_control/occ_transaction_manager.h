@@ -30,6 +30,7 @@
 namespace MOT {
 // forward declaration
 class Access;
+class Row;
 
 constexpr uint64_t LOCK_TIME_OUT = 1 << 16;
 /**
@@ -169,6 +170,25 @@ private:
     bool ValidateReadSet(TxnManager* txMan);
     /** @brief validate the write set   */
     bool ValidateWriteSet(TxnManager* txMan);
+    /**
+     * @brief Allocates the copies of the global rows the write phase moves to another row pool: an update whose
+     * new data does not fit in its row or would fit in half of it, and a new row fitting a smaller row pool.
+     * @return False if a larger row is needed for an update and cannot be allocated.
+     */
+    bool PrepareRowCopies(TxnManager* txMan);
+    /**
+     * @brief Moves the locked global row of an update to the row copy prepared by validation. The replaced row is
+     * retired to the GC.
+     */
+    void ResizeRow(TxnManager* txMan, Access* access);
+    /**
+     * @brief Moves a new row to the row copy prepared by validation, if any. The original row is retired to the
+     * GC, as the secondary index accesses still refer to it.
+     * @return The row to publish, the original row if it is not moved.
+     */
+    Row* CompactRow(TxnManager* txMan, Access* access, Row* row);
+    /** @brief Copies a row into the row copy prepared by validation and hands the copy over. */
+    Row* PublishRowCopy(Access* access, const Row* row);
 
     // Configuration of OCC behavior
     /** @var transaction counter   */
@@ -395,7 +395,8 @@ void Index::Compact(Table* table, uint32_t pid)
             while (it->IsValid()) {
                 Sentinel* ps = it->GetPrimarySentinel();
                 Row* row = ps->GetData();
-                if (row != nullptr) {
+                // only the pool of full rows is compacted, compact rows stay in place
+                if (row != nullptr && row->GetTupleSize() == table->GetTupleSize()) {
                     Row* newRow = chRow.CompactObj<Row>(row);
                     if (newRow != nullptr) {
                         ps->SetNextPtr(newRow);
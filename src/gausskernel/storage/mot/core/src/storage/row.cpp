@@ -31,19 +31,27 @@
 namespace MOT {
 IMPLEMENT_CLASS_LOGGER(Row, Storage);
 
-Row::Row(Table* hostTable) : m_rowHeader(), m_table(hostTable), m_rowId(0), m_keyType(KeyType::EMPTY_KEY)
+Row::Row(Table* hostTable) : Row(hostTable, hostTable->GetTupleSize())
 {}
 
-Row::Row(const Row& src)
+Row::Row(Table* hostTable, uint32_t dataSize)
+    : m_rowHeader(), m_table(hostTable), m_rowId(0), m_keyType(KeyType::EMPTY_KEY), m_dataSize(dataSize)
+{}
+
+Row::Row(const Row& src) : Row(src, src.m_dataSize)
+{}
+
+Row::Row(const Row& src, uint32_t dataSize)
     : m_rowHeader(src.m_rowHeader),
       m_table(src.m_table),
       m_surrogateKey(src.m_surrogateKey),
       m_pSentinel(src.m_pSentinel),
       m_rowId(src.m_rowId),
       m_keyType(src.m_keyType),
-      m_twoPhaseRecoverMode(src.m_twoPhaseRecoverMode)
+      m_twoPhaseRecoverMode(src.m_twoPhaseRecoverMode),
+      m_dataSize(dataSize)
 {
-    errno_t erc = memcpy_s(this->m_data, this->GetTupleSize(), src.m_data, src.GetTupleSize());
+    errno_t erc = memcpy_s(this->m_data, this->GetTupleSize(), src.m_data, std::min(dataSize, src.GetTupleSize()));
     securec_check(erc, "\0", "\0");
 }
 
@@ -25,6 +25,7 @@
 #ifndef MOT_ROW_H
 #define MOT_ROW_H
 
+#include <algorithm>
 #include <string.h>
 #include <iosfwd>
 #include <string>
@@ -56,8 +57,22 @@ public:
      */
     explicit Row(Table* hostTable);
 
+    /**
+     * @brief Constructs a row holding fewer data bytes than the tuple size of its table.
+     * @param hostTable The table to which the row belongs.
+     * @param dataSize The number of data bytes the row holds.
+     */
+    Row(Table* hostTable, uint32_t dataSize);
+
     Row(const Row& src);
 
+    /**
+     * @brief Constructs a copy of a row holding a different number of data bytes.
+     * @param src The row to copy.
+     * @param dataSize The number of data bytes the row holds, the data beyond it is not copied.
+     */
+    Row(const Row& src, uint32_t dataSize);
+
     /**
      * @brief Destructor.
      */
@@ -151,12 +166,14 @@ public:
     }
 
     /**
-     * @brief Copies the raw data of this Row object from another Row object.
+     * @brief Copies the raw data of this Row object from another Row object. When one of the rows is compact
+     * only the data bytes both rows hold are copied, which must include all the data in use in the source row.
      * @param src The source row from which to copy the raw data.
      */
     inline void Copy(const Row* src)
     {
-        CopyData(src->GetData(), src->GetTupleSize());
+        MOT_ASSERT(src->m_table->GetRowUsedSize(src->GetData()) <= GetTupleSize());
+        CopyData(src->GetData(), std::min(src->GetTupleSize(), GetTupleSize()));
         m_table = src->m_table;
     }
 
@@ -177,12 +194,13 @@ public:
     }
 
     /**
-     * @brief Retrieves the size in bytes of the raw data of the row.
+     * @brief Retrieves the size in bytes of the raw data of the row. This is the tuple size of the table, unless
+     * the row is compact and holds only the used part of the last variable length column.
      * @return The row data size in bytes.
      */
     inline uint32_t GetTupleSize() const
     {
-        return m_table->GetTupleSize();
+        return m_dataSize;
     };
 
     /**
@@ -496,7 +514,7 @@ public:
         MOT_ASSERT(r != nullptr);
         Table* t = r->GetTable();
         MOT_ASSERT(t != nullptr);
-        size += t->GetRowSizeFromPool();
+        size += t->GetRowSizeFromPool(r);
         t->DestroyRow(r);
         return size;
     }
@@ -569,6 +587,9 @@ protected:
     /** @var A flag to identify if row is in recover mode state. */
     bool m_twoPhaseRecoverMode = false;
 
+    /** @var The number of bytes in the raw buffer. */
+    uint32_t m_dataSize;
+
     /** @var The raw buffer holding the row data. Starts at the end of the class
      * Must be last member */
     uint8_t m_data[0];
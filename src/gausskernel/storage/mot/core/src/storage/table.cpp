@@ -38,6 +38,23 @@ IMPLEMENT_CLASS_LOGGER(Table, Storage);
 
 std::atomic<uint32_t> Table::tableCounter(0);
 
+// The row layout recorded in the table metadata, in the byte of the former fixed length flag. Tables recorded
+// before the variable length columns were laid out last read as one of the first two.
+static constexpr uint8_t ROW_LAYOUT_VAR_LENGTH = 0;
+static constexpr uint8_t ROW_LAYOUT_FIXED_LENGTH = 1;
+static constexpr uint8_t ROW_LAYOUT_VAR_COLUMNS_LAST = 2;
+
+static inline bool IsVarLengthColumn(const Column* column)
+{
+    return (column->m_type == MOT_CATALOG_FIELD_TYPES::MOT_TYPE_VARCHAR ||
+            column->m_type == MOT_CATALOG_FIELD_TYPES::MOT_TYPE_BLOB);
+}
+
+static inline bool IsLaidOutBefore(const Column* column, const Column* other)
+{
+    return (column->m_size < other->m_size || (column->m_size == other->m_size && column->m_id < other->m_id));
+}
+
 Table::~Table()
 {
     if (m_numIndexes > 0) {
@@ -64,9 +81,7 @@ Table::~Table()
         free(m_indexes);
     }
 
-    if (m_rowPool) {
-        ObjAllocInterface::FreeObjPool(&m_rowPool);
-    }
+    FreeRowPools();
 }
 
 bool Table::Init(const char* tableName, const char* longName, unsigned int fieldCnt, uint64_t tableExId)
@@ -103,14 +118,100 @@ bool Table::Init(const char* tableName, const char* longName, unsigned int field
 
 bool Table::InitRowPool(bool local)
 {
-    bool result = true;
+    m_numCompactRowPools = 0;
+    if (m_varColumnsLast) {
+        LayoutVarColumnsLast();
+    }
+
+    if (m_lastVarColumnOffset > 0) {
+        // the compact rows keep a prefix of the last column, doubling in size, as long as it saves half of it
+        uint32_t usedSize = m_lastVarColumnOffset + sizeof(uint32_t);
+        uint32_t tailSize = m_tupleSize - usedSize;
+        uint32_t step = MIN_COMPACT_ROW_TAIL;
+        while ((step << (MAX_COMPACT_ROW_POOLS - 1)) < tailSize) {
+            step <<= 1;
+        }
+        for (; (step << 1) <= tailSize && m_numCompactRowPools < MAX_COMPACT_ROW_POOLS; step <<= 1) {
+            m_compactRowSizes[m_numCompactRowPools++] = usedSize + step;
+        }
+    }
+
+    return CreateRowPools(local);
+}
+
+void Table::LayoutVarColumnsLast()
+{
+    // the fixed size columns first, in their order
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < m_fieldCnt; i++) {
+        if (!IsVarLengthColumn(m_columns[i])) {
+            m_columns[i]->m_offset = offset;
+            offset += m_columns[i]->m_size;
+        }
+    }
+
+    // then the variable length ones by increasing size, the first declared first among equal sizes
+    Column* last = nullptr;
+    for (;;) {
+        Column* next = nullptr;
+        for (uint32_t i = 0; i < m_fieldCnt; i++) {
+            Column* column = m_columns[i];
+            if (IsVarLengthColumn(column) && (last == nullptr || IsLaidOutBefore(last, column)) &&
+                (next == nullptr || IsLaidOutBefore(column, next))) {
+                next = column;
+            }
+        }
+        if (next == nullptr) {
+            break;
+        }
+        next->m_offset = offset;
+        offset += next->m_size;
+        last = next;
+    }
+
+    MOT_ASSERT(offset == m_tupleSize);
+    m_lastVarColumnOffset = (last != nullptr) ? (uint32_t)last->m_offset : 0;
+}
+
+bool Table::CreateRowPools(bool local)
+{
     m_rowPool = ObjAllocInterface::GetObjPool(sizeof(Row) + m_tupleSize, local);
     if (!m_rowPool) {
         MOT_REPORT_ERROR(
             MOT_ERROR_OOM, "Initialize Table", "Failed to allocate row pool for table %s", m_longTableName.c_str());
-        result = false;
+        return false;
+    }
+
+    for (uint32_t i = 0; i < m_numCompactRowPools; i++) {
+        m_compactRowPools[i] = ObjAllocInterface::GetObjPool(sizeof(Row) + m_compactRowSizes[i], local);
+        if (!m_compactRowPools[i]) {
+            MOT_REPORT_ERROR(MOT_ERROR_OOM,
+                "Initialize Table",
+                "Failed to allocate compact row pool of %u bytes for table %s",
+                m_compactRowSizes[i],
+                m_longTableName.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+void Table::FreeRowPools()
+{
+    if (m_rowPool) {
+        ObjAllocInterface::FreeObjPool(&m_rowPool);
+    }
+
+    for (uint32_t i = 0; i < m_numCompactRowPools; i++) {
+        if (m_compactRowPools[i]) {
+            ObjAllocInterface::FreeObjPool(&m_compactRowPools[i]);
+        }
     }
-    return result;
+}
+
+uint32_t Table::GetRowSizeFromPool(const Row* row) const
+{
+    return GetRowPool(row->GetTupleSize())->m_size;
 }
 
 void Table::ClearThreadMemoryCache()
@@ -122,6 +223,12 @@ void Table::ClearThreadMemoryCache()
     if (m_rowPool != nullptr) {
         m_rowPool->ClearThreadCache();
     }
+
+    for (uint32_t i = 0; i < m_numCompactRowPools; i++) {
+        if (m_compactRowPools[i] != nullptr) {
+            m_compactRowPools[i]->ClearThreadCache();
+        }
+    }
 }
 
 void Table::IncIndexColumnUsage(Index* index)
@@ -448,7 +555,7 @@ Row* Table::RemoveRow(Row* row, uint64_t tid, GcManager* gc)
                     currSentinel = ix->IndexRemove(&key, tid);
                     if (likely(gc != nullptr)) {
                         gc->GcRecordObject(ix->GetIndexId(), currSentinel, nullptr, ix->SentinelDtor, SENTINEL_SIZE);
-                        gc->GcRecordObject(ix->GetIndexId(), row, nullptr, row->RowDtor, ROW_SIZE_FROM_POOL(this));
+                        gc->GcRecordObject(ix->GetIndexId(), row, nullptr, row->RowDtor, ROW_SIZE_FROM_POOL(row));
                     } else {
                         if (!MOTEngine::GetInstance()->IsRecovering()) {
                             MOT_LOG_ERROR("RemoveRow called without GC when not recovering");
@@ -508,7 +615,8 @@ Row* Table::RemoveKeyFromIndex(Row* row, Sentinel* sentinel, uint64_t tid, GcMan
             if (ix->GetIndexOrder() == IndexOrder::INDEX_ORDER_PRIMARY) {
                 OutputRow = currSentinel->GetData();
                 gc->GcRecordObject(ix->GetIndexId(), currSentinel, nullptr, ix->SentinelDtor, SENTINEL_SIZE);
-                gc->GcRecordObject(ix->GetIndexId(), OutputRow, nullptr, OutputRow->RowDtor, ROW_SIZE_FROM_POOL(this));
+                gc->GcRecordObject(
+                    ix->GetIndexId(), OutputRow, nullptr, OutputRow->RowDtor, ROW_SIZE_FROM_POOL(OutputRow));
             } else {
                 gc->GcRecordObject(ix->GetIndexId(), currSentinel, nullptr, ix->SentinelDtor, SENTINEL_SIZE);
             }
@@ -522,13 +630,27 @@ Row* Table::CreateNewRow()
     Row* row = m_rowPool->Alloc<Row>(this);
     if (row == nullptr) {
         MOT_REPORT_ERROR(MOT_ERROR_OOM, "Create Row", "Failed to create new row in table %s", m_longTableName.c_str());
+    } else if (m_numCompactRowPools > 0) {
+        // an unset last column must not count as used
+        *(uint32_t*)(row->m_data + m_lastVarColumnOffset) = 0;
     }
     return row;
 }
 
+Row* Table::CreateRowCopy(const Row* row, uint32_t dataSize)
+{
+    return GetRowPool(dataSize)->Alloc<Row>(*row, dataSize);
+}
+
+Row* Table::InitRowCopy(Row* rowCopy, const Row* row)
+{
+    // the object stays in its row pool, only the row is constructed again
+    return new (rowCopy) Row(*row, rowCopy->GetTupleSize());
+}
+
 void Table::DestroyRow(Row* row)
 {
-    m_rowPool->Release<Row>(row);
+    GetRowPool(row->GetTupleSize())->Release<Row>(row);
 }
 
 bool Table::CreateMultipleRows(size_t numRows, Row* rows[])
@@ -687,9 +809,8 @@ void Table::Truncate(TxnManager* txn)
     // destroy primary index data and row data
     GcManager::ClearIndexElements(m_indexes[0]->GetIndexId());
     m_indexes[0]->Truncate(false);
-    ObjAllocInterface::FreeObjPool(&m_rowPool);
-    m_rowPool = ObjAllocInterface::GetObjPool(sizeof(Row) + m_tupleSize, false);
-    if (!m_rowPool) {
+    FreeRowPools();
+    if (!CreateRowPools(false)) {
         MOT_REPORT_ERROR(MOT_ERROR_OOM,
             "Truncate Table",
             "Failed to allocate row pool after truncate in table %s",
@@ -723,6 +844,16 @@ uint64_t Table::GetTableSize()
     uint64_t res = stats.m_poolCount * stats.m_poolGrossSize;
     uint64_t netto = (stats.m_totalObjCount - stats.m_freeObjCount) * stats.m_objSize;
 
+    for (uint32_t i = 0; i < m_numCompactRowPools; i++) {
+        erc = memset_s(&stats, sizeof(PoolStatsSt), 0, sizeof(PoolStatsSt));
+        securec_check(erc, "\0", "\0");
+        stats.m_type = PoolStatsT::POOL_STATS_ALL;
+
+        m_compactRowPools[i]->GetStats(stats);
+        res += stats.m_poolCount * stats.m_poolGrossSize;
+        netto += (stats.m_totalObjCount - stats.m_freeObjCount) * stats.m_objSize;
+    }
+
     erc = memset_s(&stats, sizeof(PoolStatsSt), 0, sizeof(PoolStatsSt));
     securec_check(erc, "\0", "\0");
     stats.m_type = PoolStatsT::POOL_STATS_ALL;
@@ -929,7 +1060,7 @@ size_t Table::SerializeSize()
         SerializableSTR::SerializeSize(m_tableName) + SerializableSTR::SerializeSize(m_longTableName) +
         SerializablePOD<uint16_t>::SerializeSize(m_numIndexes) + SerializablePOD<uint32_t>::SerializeSize(m_tableId) +
         SerializablePOD<uint64_t>::SerializeSize(m_tableExId) +
-        SerializablePOD<bool>::SerializeSize(m_fixedLengthRows) + SerializablePOD<uint32_t>::SerializeSize(m_fieldCnt) +
+        SerializablePOD<uint8_t>::SerializeSize(ROW_LAYOUT_VAR_LENGTH) + SerializablePOD<uint32_t>::SerializeSize(m_fieldCnt) +
         SerializablePOD<uint32_t>::SerializeSize(m_tupleSize) + SerializablePOD<uint32_t>::SerializeSize(m_maxFields) +
         colsSize + idxsSize;
     return ret;
@@ -943,7 +1074,9 @@ void Table::Serialize(char* dataOut)
     dataOut = SerializablePOD<uint16_t>::Serialize(dataOut, m_numIndexes);
     dataOut = SerializablePOD<uint32_t>::Serialize(dataOut, m_tableId);
     dataOut = SerializablePOD<uint64_t>::Serialize(dataOut, m_tableExId);
-    dataOut = SerializablePOD<bool>::Serialize(dataOut, m_fixedLengthRows);
+    uint8_t rowLayout = m_fixedLengthRows ? ROW_LAYOUT_FIXED_LENGTH
+                                          : (m_varColumnsLast ? ROW_LAYOUT_VAR_COLUMNS_LAST : ROW_LAYOUT_VAR_LENGTH);
+    dataOut = SerializablePOD<uint8_t>::Serialize(dataOut, rowLayout);
     dataOut = SerializablePOD<uint32_t>::Serialize(dataOut, m_fieldCnt);
     dataOut = SerializablePOD<uint32_t>::Serialize(dataOut, m_tupleSize);
     dataOut = SerializablePOD<uint32_t>::Serialize(dataOut, m_maxFields);
@@ -975,7 +1108,10 @@ void Table::Deserialize(const char* in)
     dataIn = SerializablePOD<uint16_t>::Deserialize(dataIn, m_numIndexes);
     dataIn = SerializablePOD<uint32_t>::Deserialize(dataIn, m_tableId);
     dataIn = SerializablePOD<uint64_t>::Deserialize(dataIn, m_tableExId);
-    dataIn = SerializablePOD<bool>::Deserialize(dataIn, m_fixedLengthRows);
+    uint8_t rowLayout = ROW_LAYOUT_VAR_LENGTH;
+    dataIn = SerializablePOD<uint8_t>::Deserialize(dataIn, rowLayout);
+    m_fixedLengthRows = (rowLayout == ROW_LAYOUT_FIXED_LENGTH);
+    m_varColumnsLast = (rowLayout == ROW_LAYOUT_VAR_COLUMNS_LAST);
     dataIn = SerializablePOD<uint32_t>::Deserialize(dataIn, m_fieldCnt);
     dataIn = SerializablePOD<uint32_t>::Deserialize(dataIn, m_tupleSize);
     dataIn = SerializablePOD<uint32_t>::Deserialize(dataIn, m_maxFields);
@@ -25,6 +25,7 @@
 #ifndef MOT_TABLE_H
 #define MOT_TABLE_H
 
+#include <algorithm>
 #include <atomic>
 #include <map>
 #include <string>
@@ -114,14 +115,56 @@ public:
     bool Init(const char* tableName, const char* longName, unsigned int fieldCnt, uint64_t tableExId = 0);
 
     /**
-     * @brief Initializes row_pool object pool
+     * @brief Initializes row_pool object pool. When the variable length columns are laid out last, this also fixes
+     * the column offsets and creates the compact row pools.
      * @return True if initialization succeeded, otherwise false.
      */
     bool InitRowPool(bool local = false);
 
-    inline uint32_t GetRowSizeFromPool() const
+    /**
+     * @brief Retrieves the size of the row pool object holding a row.
+     * @param row The row.
+     * @return The object size in bytes.
+     */
+    uint32_t GetRowSizeFromPool(const Row* row) const;
+
+    /**
+     * @brief Queries whether rows of the table can be kept in compact row pools.
+     * @return Boolean value denoting whether the table has compact row pools.
+     */
+    inline bool HasCompactRows() const
+    {
+        return (m_numCompactRowPools > 0);
+    }
+
+    /**
+     * @brief Retrieves the number of data bytes in use in a row. All the columns are used in full, except the
+     * variable length column laid out last, of which only the length and the value are used.
+     * @param data The raw data of the row.
+     * @return The number of bytes in use.
+     */
+    inline uint32_t GetRowUsedSize(const uint8_t* data) const
     {
-        return m_rowPool->m_size;
+        if (m_numCompactRowPools == 0) {
+            return m_tupleSize;
+        }
+        uint32_t usedSize = m_lastVarColumnOffset + sizeof(uint32_t);
+        return usedSize + std::min(*(const uint32_t*)(data + m_lastVarColumnOffset), m_tupleSize - usedSize);
+    }
+
+    /**
+     * @brief Retrieves the data size of the smallest row pool fitting a number of data bytes.
+     * @param usedSize The number of data bytes to hold.
+     * @return The data size of the rows in the pool.
+     */
+    inline uint32_t GetRowPoolSize(uint32_t usedSize) const
+    {
+        for (uint32_t i = 0; i < m_numCompactRowPools; i++) {
+            if (usedSize <= m_compactRowSizes[i]) {
+                return m_compactRowSizes[i];
+            }
+        }
+        return m_tupleSize;
     }
 
     /**
@@ -230,6 +273,9 @@ public:
     void ClearRowCache()
     {
         m_rowPool->ClearFreeCache();
+        for (uint32_t i = 0; i < m_numCompactRowPools; i++) {
+            m_compactRowPools[i]->ClearFreeCache();
+        }
         for (int i = 0; i < m_numIndexes; i++) {
             m_indexes[i]->ClearFreeCache();
         }
@@ -420,13 +466,15 @@ public:
     }
 
     /**
-     * @brief Sets the fixed length row property for the table.
+     * @brief Sets the fixed length row property for the table. The variable length columns of a new table are
+     * laid out at the end of the row, ordered by size.
      * @param fixedLength Boolean value denoting whether the rows of the table have a fixed length
      * or not.
      */
     inline void SetFixedLengthRow(bool fixedLength)
     {
         m_fixedLengthRows = fixedLength;
+        m_varColumnsLast = !fixedLength;
     }
 
     /**
@@ -518,6 +566,22 @@ public:
      */
     Row* CreateNewRow();
 
+    /**
+     * @brief Creates a copy of a row in the row pool of the given data size.
+     * @param row The row to copy.
+     * @param dataSize The data size of the new row, as returned by GetRowPoolSize().
+     * @return The new row, or null if out of memory (no error is reported).
+     */
+    Row* CreateRowCopy(const Row* row, uint32_t dataSize);
+
+    /**
+     * @brief Copies a row again into a row created by CreateRowCopy(), keeping its data size.
+     * @param rowCopy The row created by CreateRowCopy().
+     * @param row The row to copy.
+     * @return The row copy.
+     */
+    Row* InitRowCopy(Row* rowCopy, const Row* row);
+
     /**
      * @brief Releases a row's memory.
      * @param row. row to be deleted
@@ -741,12 +805,55 @@ public:
     Row* RemoveKeyFromIndex(Row* row, Sentinel* sentinel, uint64_t tid, GcManager* gc);
 
 private:
+    /**
+     * @brief Lays out the variable length columns after all the others, ordered by size, so that the largest
+     * one ends the row and the compact rows may leave out its unused part.
+     */
+    void LayoutVarColumnsLast();
+
+    /**
+     * @brief Creates the row pools, the one of full rows and the compact ones.
+     * @param local Specifies whether the pools are local to the thread.
+     * @return True if all the pools were created, otherwise false.
+     */
+    bool CreateRowPools(bool local);
+
+    /** @brief Frees all the row pools. */
+    void FreeRowPools();
+
+    /**
+     * @brief Retrieves the row pool of the given data size.
+     * @param dataSize The data size of the rows in the pool.
+     * @return The row pool.
+     */
+    inline ObjAllocInterface* GetRowPool(uint32_t dataSize) const
+    {
+        for (uint32_t i = 0; i < m_numCompactRowPools; i++) {
+            if (dataSize == m_compactRowSizes[i]) {
+                return m_compactRowPools[i];
+            }
+        }
+        return m_rowPool;
+    }
+
     /** @var Global atomic table identifier. */
     static std::atomic<uint32_t> tableCounter;
 
     /** @var row_pool personal row allocator object pool */
     ObjAllocInterface* m_rowPool;
 
+    /** @var Pools of rows holding only a part of the last variable length column, by increasing size. */
+    ObjAllocInterface* m_compactRowPools[MAX_COMPACT_ROW_POOLS] = {nullptr};
+
+    /** @var The data size of the rows in each compact row pool. */
+    uint32_t m_compactRowSizes[MAX_COMPACT_ROW_POOLS] = {0};
+
+    /** @var Number of compact row pools, zero when all the rows hold the full tuple. */
+    uint32_t m_numCompactRowPools = 0;
+
+    /** @var Offset of the variable length column that ends the row, when there are compact row pools. */
+    uint32_t m_lastVarColumnOffset = 0;
+
     // we have only index-organized-tables (IOT) so this is the pointer to the index
     // representing the table
     /** @var The primary index holding all rows. */
@@ -795,6 +902,9 @@ private:
     /** @var Specifies whether rows have fixed length. */
     bool m_fixedLengthRows = true;
 
+    /** @var Specifies whether the variable length columns are laid out at the end of the row. */
+    bool m_varColumnsLast = false;
+
     bool m_deserialized;
 
     /** @var Holds number of rows in the table. The information may not be accurate.
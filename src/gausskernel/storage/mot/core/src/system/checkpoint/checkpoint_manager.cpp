@@ -93,6 +93,11 @@ bool CheckpointManager::CreateSnapShot()
 
     MOT::MOTEngine* engine = MOT::MOTEngine::GetInstance();
 
+    // transactions committed before the snapshot may still be queued at the redo replay workers
+    if (engine->IsRecovering()) {
+        GetRecoveryManager()->WaitRedoReplayWorkers();
+    }
+
     engine->LockDDLForCheckpoint();
     ResetFlags();
 
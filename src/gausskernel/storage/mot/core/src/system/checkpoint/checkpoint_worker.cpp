@@ -138,6 +138,8 @@ int CheckpointWorkerPool::Checkpoint(Buffer* buffer, Sentinel* sentinel, int fd,
             }
             sentinel->Lock(tid);
         }
+        // an update may have moved the row to another row pool before the lock
+        mainRow = sentinel->GetData();
     }
 
     Row* stableRow = sentinel->GetStable();
@@ -264,7 +264,7 @@ enum AccessType : uint8_t {
 #define SENTINEL_SIZE (sizeof(Sentinel) + 8)
 #define KEY_SIZE_FROM_POOL(x) x->getKeyPoolSize()
 #define S_SENTINEL_SIZE(x) x->getKeyPoolSize() + SENTINEL_SIZE
-#define ROW_SIZE_FROM_POOL(t) t->GetRowSizeFromPool()
+#define ROW_SIZE_FROM_POOL(r) r->GetTable()->GetRowSizeFromPool(r)
 #define ONE_MB 1048576
 
 // prefetch instruction
@@ -294,6 +294,8 @@ inline void Prefetch(const void* ptr)
 #define MAX_NUM_INDEXES (10U)
 #define MAX_KEY_COLUMNS (10U)
 #define MAX_TUPLE_SIZE 16384  // in bytes
+#define MAX_COMPACT_ROW_POOLS (7U)
+#define MIN_COMPACT_ROW_TAIL (32U)  // in bytes
 
 // Do not change this. Masstree assumes 15 for optimization purposes
 #define BTREE_ORDER 15
@@ -53,6 +53,8 @@ constexpr uint32_t MOTConfiguration::DEFAULT_CHECKPOINT_WORKERS;
 constexpr bool MOTConfiguration::DEFAULT_VALIDATE_CHECKPOINT;
 // recovery configuration members
 constexpr uint32_t MOTConfiguration::DEFAULT_CHECKPOINT_RECOVERY_WORKERS;
+constexpr uint32_t MOTConfiguration::DEFAULT_REDO_RECOVERY_WORKERS;
+constexpr uint32_t MOTConfiguration::MAX_REDO_RECOVERY_WORKERS;
 constexpr bool MOTConfiguration::DEFAULT_ENABLE_LOG_RECOVERY_STATS;
 // machine configuration members
 constexpr uint16_t MOTConfiguration::DEFAULT_NUMA_NODES;
@@ -118,6 +120,7 @@ constexpr bool MOTConfiguration::DEFAULT_ENABLE_MOT_CODEGEN;
 constexpr bool MOTConfiguration::DEFAULT_FORCE_MOT_PSEUDO_CODEGEN;
 constexpr bool MOTConfiguration::DEFAULT_ENABLE_MOT_CODEGEN_PRINT;
 constexpr uint32_t MOTConfiguration::DEFAULT_MOT_CODEGEN_LIMIT;
+constexpr bool MOTConfiguration::DEFAULT_ENABLE_MOT_PROCEDURE_CODEGEN;
 // storage configuration
 constexpr bool MOTConfiguration::DEFAULT_ALLOW_INDEX_ON_NULLABLE_COLUMN;
 constexpr IndexTreeFlavor MOTConfiguration::DEFAULT_INDEX_TREE_FLAVOR;
@@ -392,6 +395,7 @@ MOTConfiguration::MOTConfiguration()
       m_checkpointWorkers(DEFAULT_CHECKPOINT_WORKERS),
       m_validateCheckpoint(DEFAULT_VALIDATE_CHECKPOINT),
       m_checkpointRecoveryWorkers(DEFAULT_CHECKPOINT_RECOVERY_WORKERS),
+      m_redoRecoveryWorkers(DEFAULT_REDO_RECOVERY_WORKERS),
       m_abortBufferEnable(true),
       m_preAbort(true),
       m_validationLock(TxnValidation::TXN_VALIDATION_NO_WAIT),
@@ -442,6 +446,7 @@ MOTConfiguration::MOTConfiguration()
       m_forcePseudoCodegen(DEFAULT_FORCE_MOT_PSEUDO_CODEGEN),
       m_enableCodegenPrint(DEFAULT_ENABLE_MOT_CODEGEN_PRINT),
       m_codegenLimit(DEFAULT_MOT_CODEGEN_LIMIT),
+      m_enableProcedureCodegen(DEFAULT_ENABLE_MOT_PROCEDURE_CODEGEN),
       m_allowIndexOnNullableColumn(DEFAULT_ALLOW_INDEX_ON_NULLABLE_COLUMN),
       m_indexTreeFlavor(DEFAULT_INDEX_TREE_FLAVOR),
       m_configMonitorPeriodSeconds(DEFAULT_CFG_MONITOR_PERIOD_SECONDS),
@@ -487,6 +492,7 @@ bool MOTConfiguration::SetFlag(const std::string& name, const std::string& value
     } else if (ParseUint32(name, "checkpoint_workers", value, &m_checkpointWorkers)) {
     } else if (ParseBool(name, "validate_checkpoint", value, &m_validateCheckpoint)) {
     } else if (ParseUint32(name, "checkpoint_recovery_workers", value, &m_checkpointRecoveryWorkers)) {
+    } else if (ParseUint32(name, "redo_recovery_workers", value, &m_redoRecoveryWorkers)) {
     } else if (ParseBool(name, "abort_buffer_enable", value, &m_abortBufferEnable)) {
     } else if (ParseBool(name, "pre_abort", value, &m_preAbort)) {
     } else if (ParseValidation(name, "validation_lock", value, &m_validationLock)) {
@@ -531,6 +537,7 @@ bool MOTConfiguration::SetFlag(const std::string& name, const std::string& value
     } else if (ParseBool(name, "force_mot_pseudo_codegen", value, &m_forcePseudoCodegen)) {
     } else if (ParseBool(name, "enable_mot_codegen_print", value, &m_enableCodegenPrint)) {
     } else if (ParseUint32(name, "mot_codegen_limit", value, &m_codegenLimit)) {
+    } else if (ParseBool(name, "enable_mot_procedure_codegen", value, &m_enableProcedureCodegen)) {
     } else if (ParseBool(name, "allow_index_on_nullable_column", value, &m_allowIndexOnNullableColumn)) {
     } else if (ParseIndexTreeFlavor(name, "index_tree_flavor", value, &m_indexTreeFlavor)) {
     } else if (ParseUint64(name, "config_monitor_period_seconds", value, &m_configMonitorPeriodSeconds)) {
@@ -651,6 +658,13 @@ void MOTConfiguration::LoadConfig()
 
     // Recovery configuration
     UPDATE_INT_CFG(m_checkpointRecoveryWorkers, "checkpoint_recovery_workers", DEFAULT_CHECKPOINT_RECOVERY_WORKERS);
+    UPDATE_INT_CFG(m_redoRecoveryWorkers, "redo_recovery_workers", DEFAULT_REDO_RECOVERY_WORKERS);
+    if (m_redoRecoveryWorkers < 1 || m_redoRecoveryWorkers > MAX_REDO_RECOVERY_WORKERS) {
+        MOT_LOG_WARN("Invalid redo_recovery_workers %u, using %u instead",
+            m_redoRecoveryWorkers,
+            DEFAULT_REDO_RECOVERY_WORKERS);
+        m_redoRecoveryWorkers = DEFAULT_REDO_RECOVERY_WORKERS;
+    }
 
     // Tx configuration - not configurable yet
     UPDATE_CFG(m_abortBufferEnable, "tx_abort_buffers_enable", true);
@@ -721,6 +735,7 @@ void MOTConfiguration::LoadConfig()
     UPDATE_CFG(m_forcePseudoCodegen, "force_mot_pseudo_codegen", DEFAULT_FORCE_MOT_PSEUDO_CODEGEN);
     UPDATE_CFG(m_enableCodegenPrint, "enable_mot_codegen_print", DEFAULT_ENABLE_MOT_CODEGEN_PRINT);
     UPDATE_INT_CFG(m_codegenLimit, "mot_codegen_limit", DEFAULT_MOT_CODEGEN_LIMIT);
+    UPDATE_CFG(m_enableProcedureCodegen, "enable_mot_procedure_codegen", DEFAULT_ENABLE_MOT_PROCEDURE_CODEGEN);
 
     // storage configuration
     UPDATE_CFG(m_allowIndexOnNullableColumn, "allow_index_on_nullable_column", DEFAULT_ALLOW_INDEX_ON_NULLABLE_COLUMN);
@@ -163,6 +163,9 @@ public:
     /** @var Specifies the number of workers used to recover from checkpoint. */
     uint32_t m_checkpointRecoveryWorkers;
 
+    /** @var Specifies the number of workers used to replay committed transactions from the redo log. */
+    uint32_t m_redoRecoveryWorkers;
+
     /**********************************************************************/
     // Transaction management variables (not configurable)
     /**********************************************************************/
@@ -330,6 +333,9 @@ public:
     /** @var Limits the amount of JIT queries allowed per user session. */
     uint32_t m_codegenLimit;
 
+    /** @var Enable/disable JIT compilation and execution for the queries of stored procedures. */
+    bool m_enableProcedureCodegen;
+
     /**********************************************************************/
     // Storage configuration
     /**********************************************************************/
@@ -437,6 +443,12 @@ private:
     /** @var Default number of workers used in recovery from checkpoint. */
     static constexpr uint32_t DEFAULT_CHECKPOINT_RECOVERY_WORKERS = 3;
 
+    /** @var Default number of workers used in redo log replay (one means the redo thread replays by itself). */
+    static constexpr uint32_t DEFAULT_REDO_RECOVERY_WORKERS = 1;
+
+    /** @var Maximum number of workers used in redo log replay. */
+    static constexpr uint32_t MAX_REDO_RECOVERY_WORKERS = 32;
+
     /** @var Default enable log recovery statistics. */
     static constexpr bool DEFAULT_ENABLE_LOG_RECOVERY_STATS = false;
 
@@ -595,6 +607,9 @@ private:
     /** @vart Default limit for the amount of JIT queries allowed per user session. */
     static constexpr uint32_t DEFAULT_MOT_CODEGEN_LIMIT = 100;
 
+    /** @var Default enable JIT compilation and execution for the queries of stored procedures. */
+    static constexpr bool DEFAULT_ENABLE_MOT_PROCEDURE_CODEGEN = false;
+
     // default storage configuration
     /** @var The default allow index on null-able column. */
     static constexpr bool DEFAULT_ALLOW_INDEX_ON_NULLABLE_COLUMN = true;
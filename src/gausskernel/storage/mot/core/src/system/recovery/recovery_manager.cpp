@@ -522,11 +522,17 @@ bool RecoveryManager::RecoverDbStart()
     if (!RecoverFromCheckpoint()) {
         return false;
     }
+    if (m_numReplayWorkers > 1 && !StartRedoReplayWorkers()) {
+        return false;
+    }
     return true;
 }
 
 bool RecoveryManager::RecoverDbEnd()
 {
+    // the workers add their surrogate state to the list as they end
+    StopRedoReplayWorkers();
+
     if (ApplyInProcessTransactions() != RC_OK) {
         MOT_LOG_ERROR("applyInProcessTransactions failed!");
         return false;
@@ -565,6 +571,8 @@ void RecoveryManager::CleanUp()
         return;
     }
 
+    StopRedoReplayWorkers();
+
     if (m_logStats != nullptr) {
         delete m_logStats;
         m_logStats = nullptr;
@@ -594,6 +602,7 @@ bool RecoveryManager::ApplyLogSegmentFromData(uint64_t redoLsn, char* data, size
     }
 
     MOTEngine::GetInstance()->GetCheckpointManager()->SetLastReplayLsn(redoLsn);
+    m_lastRedoLsn = redoLsn;
     return ApplyLogSegmentFromData(data, len);
 }
 
@@ -696,7 +705,6 @@ bool RecoveryManager::CommitRecoveredTransaction(uint64_t externalTransactionId)
 bool RecoveryManager::OperateOnRecoveredTransaction(
     uint64_t internalTransactionId, uint64_t externalTransactionId, RecoveryOpState rState)
 {
-    RC status = RC_OK;
     std::lock_guard<std::mutex> lock(m_inProcessTxLock);
     map<uint64_t, RedoTransactionSegments*>::iterator it = m_inProcessTransactionMap.find(internalTransactionId);
     if (it != m_inProcessTransactionMap.end()) {
@@ -704,16 +712,13 @@ bool RecoveryManager::OperateOnRecoveredTransaction(
         RedoTransactionSegments* segments = it->second;
         m_inProcessTransactionMap.erase(it);
         if (rState != RecoveryOpState::ABORT) {
-            LogSegment* segment = segments->GetSegment(segments->GetCount() - 1);
-            uint64_t csn = segment->m_controlBlock.m_csn;
-            for (uint32_t i = 0; i < segments->GetCount(); i++) {
-                segment = segments->GetSegment(i);
-                status = RedoSegment(segment, csn, internalTransactionId, rState);
-                if (status != RC_OK) {
-                    OnError(RecoveryManager::ErrCodes::XLOG_RECOVERY,
-                        "RecoveryManager::commitRecoveredTransaction: wal recovery failed");
-                    return false;
-                }
+            // a worker replaying the transaction owns the segments from now on
+            if (!m_replayWorkers.empty() && MOTEngine::GetInstance()->IsRecovering() &&
+                DispatchRedoTransaction(segments, internalTransactionId)) {
+                return true;
+            }
+            if (!RedoTransaction(segments, internalTransactionId, rState)) {
+                return false;
             }
         }
         delete segments;
@@ -726,33 +731,55 @@ bool RecoveryManager::OperateOnRecoveredTransaction(
     return true;
 }
 
-RC RecoveryManager::RedoSegment(LogSegment* segment, uint64_t csn, uint64_t transactionId, RecoveryOpState rState)
+bool RecoveryManager::RedoTransaction(
+    RedoTransactionSegments* segments, uint64_t transactionId, RecoveryOpState rState, RedoReplayWorker* worker)
+{
+    LogSegment* segment = segments->GetSegment(segments->GetCount() - 1);
+    uint64_t csn = segment->m_controlBlock.m_csn;
+    for (uint32_t i = 0; i < segments->GetCount(); i++) {
+        segment = segments->GetSegment(i);
+        RC status = RedoSegment(segment, csn, transactionId, rState, worker);
+        if (status != RC_OK) {
+            OnError(RecoveryManager::ErrCodes::XLOG_RECOVERY,
+                "RecoveryManager::commitRecoveredTransaction: wal recovery failed");
+            return false;
+        }
+    }
+    return true;
+}
+
+RC RecoveryManager::RedoSegment(
+    LogSegment* segment, uint64_t csn, uint64_t transactionId, RecoveryOpState rState, RedoReplayWorker* worker)
 {
     RC status = RC_OK;
     bool is2pcRecovery = !MOTEngine::GetInstance()->IsRecovering();
     uint8_t* endPosition = (uint8_t*)(segment->m_data + segment->m_len);
     uint8_t* operationData = (uint8_t*)(segment->m_data);
+    uint32_t numThreads = m_replayWorkers.empty() ? NUM_REDO_RECOVERY_THREADS : (uint32_t)m_replayWorkers.size();
+
+    // a redo replay worker keeps its own replay state, the other callers share the one of the manager
+    SurrogateState& sState = (worker != nullptr) ? worker->m_sState : m_sState;
+    uint32_t& numRedoOps = (worker != nullptr) ? worker->m_numRedoOps : m_numRedoOps;
 
     while (operationData < endPosition) {
-        // redolog recovery - single threaded
-        if (IsRecoveryMemoryLimitReached(NUM_REDO_RECOVERY_THREADS)) {
+        if (IsRecoveryMemoryLimitReached(numThreads)) {
             status = RC_ERROR;
             MOT_LOG_ERROR("Memory hard limit reached. Cannot recover datanode");
             break;
         }
 
         if (!is2pcRecovery) {
-            operationData += RecoverLogOperation(operationData, csn, transactionId, MOTCurrThreadId, m_sState, status);
+            operationData += RecoverLogOperation(operationData, csn, transactionId, MOTCurrThreadId, sState, status);
             GcManager* gc = MOT_GET_CURRENT_SESSION_CONTEXT()->GetTxnManager()->GetGcSession();
-            if (m_numRedoOps == 0 && gc != nullptr) {
+            if (numRedoOps == 0 && gc != nullptr) {
                 gc->GcStartTxn();
             }
-            if (++m_numRedoOps > NUM_DELETE_THRESHOLD) {
-                ClearTableCache();
+            if (++numRedoOps > NUM_DELETE_THRESHOLD) {
+                ClearTableCache((worker != nullptr) ? worker->m_tableDeletesStat : m_tableDeletesStat);
                 if (gc != nullptr) {
                     gc->GcEndTxn();
                 }
-                m_numRedoOps = 0;
+                numRedoOps = 0;
             }
         } else {
             operationData +=
@@ -763,9 +790,9 @@ RC RecoveryManager::RedoSegment(LogSegment* segment, uint64_t csn, uint64_t tran
         }
     }
 
-    // single threaded, no need for locking or CAS
-    if (!is2pcRecovery && csn > m_maxRecoveredCsn) {
-        m_maxRecoveredCsn = csn;
+    // the redo replay workers may race here
+    if (!is2pcRecovery) {
+        SetCsnIfGreater(csn);
     }
     if (status != RC_OK) {
         MOT_LOG_ERROR("RecoveryManager::redoSegment: got error %d on tid %lu", status, transactionId);
@@ -1332,15 +1359,20 @@ bool RecoveryManager::IsRecoveryMemoryLimitReached(uint32_t numThreads)
 
 void RecoveryManager::ClearTableCache()
 {
-    auto it = m_tableDeletesStat.begin();
-    while (it != m_tableDeletesStat.end()) {
+    ClearTableCache(m_tableDeletesStat);
+}
+
+void RecoveryManager::ClearTableCache(std::unordered_map<Table*, uint32_t>& tableDeletesStat)
+{
+    auto it = tableDeletesStat.begin();
+    while (it != tableDeletesStat.end()) {
         auto table = *it;
         if (table.second > NUM_DELETE_MAX_INC) {
             MOT_LOG_INFO("RecoveryManager::ClearTableCache: Table = %s items = %lu\n",
                 table.first->GetTableName().c_str(),
                 table.second);
             table.first->ClearRowCache();
-            it = m_tableDeletesStat.erase(it);
+            it = tableDeletesStat.erase(it);
         } else {
             it++;
         }
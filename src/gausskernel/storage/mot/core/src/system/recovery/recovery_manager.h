@@ -27,6 +27,11 @@
 
 #include <set>
 #include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
 #include "checkpoint_ctrlfile.h"
 #include "redo_log_global.h"
 #include "transaction_buffer_iterator.h"
@@ -183,7 +188,9 @@ public:
           m_clogCallback(nullptr),
           m_threadId(AllocThreadId()),
           m_maxConnections(GetGlobalConfiguration().m_maxConnections),
-          m_numRedoOps(0)
+          m_numRedoOps(0),
+          m_numReplayWorkers(GetGlobalConfiguration().m_redoRecoveryWorkers),
+          m_lastRedoLsn(0)
     {}
 
     ~RecoveryManager()
@@ -270,6 +277,26 @@ private:
     };
 
 public:
+    /**
+     * @struct RedoReplayWorkerStats
+     * @brief Replay progress of one redo replay worker
+     */
+    struct RedoReplayWorkerStats {
+        uint32_t m_id;
+
+        /** @var Transactions handed to the worker and not replayed yet. */
+        uint64_t m_queued;
+
+        /** @var Transactions replayed by the worker. */
+        uint64_t m_replayed;
+
+        /** @var Redo LSN of the last transaction handed to the worker. */
+        uint64_t m_dispatchedLsn;
+
+        /** @var Redo LSN of the last transaction replayed by the worker. */
+        uint64_t m_replayedLsn;
+    };
+
     /**
      * @struct TableInfo
      * @brief  Describes a table by its id and the transaction
@@ -604,11 +631,29 @@ public:
 
     inline void IncreaseTableDeletesStat(Table* t)
     {
-        m_tableDeletesStat[t]++;
+        GetTableDeletesStat(t)[t]++;
+    }
+
+    inline void ForgetTableDeletesStat(Table* t)
+    {
+        (void)GetTableDeletesStat(t).erase(t);
     }
 
     void ClearTableCache();
 
+    /**
+     * @brief Waits until the redo replay workers replayed every transaction handed to them so far.
+     */
+    void WaitRedoReplayWorkers();
+
+    /**
+     * @brief Reports the replay progress of the redo replay workers.
+     * @param stats The array to fill.
+     * @param maxWorkers The size of the array.
+     * @return The number of workers reported.
+     */
+    uint32_t GetRedoReplayWorkerStats(RedoReplayWorkerStats* stats, uint32_t maxWorkers);
+
     LogStats* m_logStats;
 
     std::map<uint64_t, TableInfo*> m_preCommitedTables;
@@ -618,6 +663,66 @@ public:
 private:
     static constexpr uint32_t NUM_REDO_RECOVERY_THREADS = 1;
 
+    /**
+     * @struct RedoReplayTask
+     * @brief A committed transaction handed to a redo replay worker
+     */
+    struct RedoReplayTask {
+        RedoTransactionSegments* m_segments;
+
+        uint64_t m_transactionId;
+
+        uint64_t m_lsn;
+    };
+
+    /**
+     * @class RedoReplayWorker
+     * @brief A thread replaying the committed transactions of the tables hashed to it, in commit order
+     */
+    class RedoReplayWorker {
+    public:
+        explicit RedoReplayWorker(uint32_t id)
+            : m_id(id),
+              m_stop(false),
+              m_dispatched(0),
+              m_replayed(0),
+              m_dispatchedLsn(0),
+              m_replayedLsn(0),
+              m_numRedoOps(0)
+        {}
+
+        ~RedoReplayWorker()
+        {}
+
+        uint32_t m_id;
+
+        std::thread m_thread;
+
+        /** @var Protects the queue and the counters, m_cond is signaled on both ends of the queue. */
+        std::mutex m_lock;
+
+        std::condition_variable m_cond;
+
+        std::deque<RedoReplayTask> m_queue;
+
+        bool m_stop;
+
+        uint64_t m_dispatched;
+
+        uint64_t m_replayed;
+
+        uint64_t m_dispatchedLsn;
+
+        uint64_t m_replayedLsn;
+
+        /** @var The replay state below belongs to the worker thread. */
+        SurrogateState m_sState;
+
+        uint32_t m_numRedoOps;
+
+        std::unordered_map<Table*, uint32_t> m_tableDeletesStat;
+    };
+
     /**
      * @brief performs a redo on a segment, which is either a recovery op
      * or a segment that belongs to a 2pc recovered transaction.
@@ -625,9 +730,82 @@ private:
      * @param csn the segment's csn
      * @param transactionId the transaction id of the segment
      * @param rState the operation to perform on the segment.
+     * @param worker the redo replay worker performing the redo, if any.
      * @return RC value denoting the operation's status
      */
-    RC RedoSegment(LogSegment* segment, uint64_t csn, uint64_t transactionId, RecoveryOpState rState);
+    RC RedoSegment(LogSegment* segment, uint64_t csn, uint64_t transactionId, RecoveryOpState rState,
+        RedoReplayWorker* worker = nullptr);
+
+    /**
+     * @brief performs a redo on all the segments of a transaction.
+     * @param segments the segments of the transaction.
+     * @param transactionId the internal transaction id.
+     * @param rState the operation to perform on the segments.
+     * @param worker the redo replay worker performing the redo, if any.
+     * @return Boolean value denoting success or failure.
+     */
+    bool RedoTransaction(RedoTransactionSegments* segments, uint64_t transactionId, RecoveryOpState rState,
+        RedoReplayWorker* worker = nullptr);
+
+    /**
+     * @brief starts the redo replay workers.
+     * @return Boolean value denoting success or failure.
+     */
+    bool StartRedoReplayWorkers();
+
+    /**
+     * @brief stops the redo replay workers once they replayed their queued transactions.
+     */
+    void StopRedoReplayWorkers();
+
+    /**
+     * @brief the main loop of a redo replay worker.
+     * @param worker the worker.
+     */
+    void RedoReplayWorkerFunc(RedoReplayWorker* worker);
+
+    /**
+     * @brief hands a committed transaction to the redo replay worker of its tables.
+     * @param segments the segments of the transaction.
+     * @param transactionId the internal transaction id.
+     * @return True if a worker owns the transaction, false if the caller must
+     * replay it (the workers it conflicts with are done by then).
+     */
+    bool DispatchRedoTransaction(RedoTransactionSegments* segments, uint64_t transactionId);
+
+    /**
+     * @brief finds the redo replay workers of the tables of a transaction.
+     * @param segments the segments of the transaction.
+     * @param workerMask returns the bitmap of the workers.
+     * @return False if the transaction must wait for every worker.
+     */
+    bool GetRedoReplayWorkers(RedoTransactionSegments* segments, uint64_t& workerMask);
+
+    /**
+     * @brief waits until the given redo replay workers replayed every transaction handed to them so far.
+     * @param workerMask the bitmap of the workers.
+     */
+    void WaitRedoReplayWorkers(uint64_t workerMask);
+
+    /**
+     * @brief finds the table of a redo operation without applying it.
+     * @param data the operation.
+     * @param tableId returns the table id of a row operation.
+     * @param hasTable returns whether the operation is a row operation.
+     * @return The length of the operation, zero for a schema change.
+     */
+    static uint32_t GetLogOperationTable(uint8_t* data, uint64_t& tableId, bool& hasTable);
+
+    std::unordered_map<Table*, uint32_t>& GetTableDeletesStat(Table* t)
+    {
+        // while the workers run, a table is only replayed by the worker it is hashed to
+        if (!m_replayWorkers.empty()) {
+            return m_replayWorkers[t->GetTableId() % m_replayWorkers.size()]->m_tableDeletesStat;
+        }
+        return m_tableDeletesStat;
+    }
+
+    void ClearTableCache(std::unordered_map<Table*, uint32_t>& tableDeletesStat);
 
     /**
      * @brief inserts a segment in to the in-process transactions map
@@ -1061,6 +1239,16 @@ private:
     uint16_t m_maxConnections;
 
     uint32_t m_numRedoOps;
+
+    /** @var Number of redo replay workers, one means no workers. */
+    uint32_t m_numReplayWorkers;
+
+    std::vector<RedoReplayWorker*> m_replayWorkers;
+
+    /** @var Serializes starting and stopping the workers with the callers from other threads. */
+    std::mutex m_replayWorkersLock;
+
+    uint64_t m_lastRedoLsn;
 };
 }  // namespace MOT
 
@@ -68,6 +68,66 @@ uint32_t RecoveryManager::RecoverLogOperation(
     }
 }
 
+uint32_t RecoveryManager::GetLogOperationTable(uint8_t* data, uint64_t& tableId, bool& hasTable)
+{
+    uint8_t* start = data;
+    uint64_t exId, rowLength;
+    uint16_t keyLength;
+    OperationCode opCode = *static_cast<OperationCode*>((void*)data);
+
+    hasTable = false;
+    switch (opCode) {
+        case CREATE_ROW:
+        case OVERWRITE_ROW:
+        case REMOVE_ROW:
+        case UPDATE_ROW:
+            data += sizeof(OperationCode);
+            Extract(data, tableId);
+            Extract(data, exId);
+            if (opCode == CREATE_ROW) {
+                data += sizeof(uint64_t);  // row id
+            }
+            Extract(data, keyLength);
+            data += keyLength;
+            if (opCode == CREATE_ROW || opCode == OVERWRITE_ROW) {
+                Extract(data, rowLength);
+                data += rowLength;
+            }
+            break;
+        case COMMIT_TX:
+        case COMMIT_PREPARED_TX:
+        case PARTIAL_REDO_TX:
+        case PREPARE_TX:
+            return sizeof(EndSegmentBlock);
+        default:
+            // schema changes replay in order with everything else
+            return 0;
+    }
+
+    if (opCode == UPDATE_ROW) {
+        // the length of the changed columns comes from the table definition
+        Table* table = GetTableManager()->GetTable(tableId);
+        if (table == nullptr) {
+            return 0;
+        }
+        uint16_t num_columns = table->GetFieldCount() - 1;
+        BitmapSet updated_columns(ExtractPtr(data, BitmapSet::GetLength(num_columns)), num_columns);
+        BitmapSet valid_columns(ExtractPtr(data, BitmapSet::GetLength(num_columns)), num_columns);
+        BitmapSet::BitmapSetIterator updated_columns_it(updated_columns);
+        BitmapSet::BitmapSetIterator valid_columns_it(valid_columns);
+        while (!updated_columns_it.End()) {
+            if (updated_columns_it.IsSet() && valid_columns_it.IsSet()) {
+                data += table->GetField(updated_columns_it.GetPosition() + 1)->m_size;
+            }
+            valid_columns_it.Next();
+            updated_columns_it.Next();
+        }
+    }
+
+    hasTable = true;
+    return (uint32_t)(data - start);
+}
+
 uint32_t RecoveryManager::RecoverLogOperationCreateTable(
     uint8_t* data, RC& status, RecoveryOpState state, uint64_t transactionId)
 {
@@ -702,7 +762,7 @@ void RecoveryManager::DropTable(char* data, RC& status)
             tableId);
         status = RC_ERROR;
     } else {
-        MOT::GetRecoveryManager()->m_tableDeletesStat.erase(table);
+        MOT::GetRecoveryManager()->ForgetTableDeletesStat(table);
     }
     MOT_LOG_DEBUG("RecoveryManager::DropTable: table %s [%lu] dropped", tableName.c_str(), tableId);
 }
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * recovery_replay.cpp
+ *    Parallel replay of the committed transactions of the redo log.
+ *
+ *    The redo thread decodes the log segments of a transaction once, as they
+ *    arrive. When the transaction commits, it is handed to the replay worker
+ *    its tables are hashed to, and each worker replays its transactions in
+ *    commit order. A transaction whose tables are hashed to several workers
+ *    waits for these workers only, a schema change waits for all of them, and
+ *    both replay in the redo thread.
+ *
+ * IDENTIFICATION
+ *    src/gausskernel/storage/mot/core/src/system/recovery/recovery_replay.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mot_engine.h"
+#include "recovery_manager.h"
+
+namespace MOT {
+DECLARE_LOGGER(RecoveryReplay, Recovery);
+
+// committed transactions a worker may have waiting, the redo thread waits beyond that
+constexpr uint32_t REDO_REPLAY_QUEUE_SIZE = 1024;
+
+constexpr uint64_t ALL_REDO_REPLAY_WORKERS = ~(uint64_t)0;
+
+bool RecoveryManager::StartRedoReplayWorkers()
+{
+    std::lock_guard<std::mutex> lock(m_replayWorkersLock);
+
+    // all the workers exist before any of them runs, they all read the worker array
+    for (uint32_t i = 0; i < m_numReplayWorkers; ++i) {
+        RedoReplayWorker* worker = new (std::nothrow) RedoReplayWorker(i);
+        if (worker == nullptr || !worker->m_sState.IsValid()) {
+            MOT_REPORT_ERROR(MOT_ERROR_OOM, "Recovery Manager Initialization", "Failed to allocate redo replay worker");
+            OnError(RecoveryManager::ErrCodes::XLOG_SETUP, "RecoveryManager:: failed to allocate redo replay workers");
+            if (worker != nullptr) {
+                delete worker;
+            }
+            for (auto it = m_replayWorkers.begin(); it != m_replayWorkers.end(); ++it) {
+                delete *it;
+            }
+            m_replayWorkers.clear();
+            return false;
+        }
+        m_replayWorkers.push_back(worker);
+    }
+
+    for (auto it = m_replayWorkers.begin(); it != m_replayWorkers.end(); ++it) {
+        (*it)->m_thread = std::thread(&RecoveryManager::RedoReplayWorkerFunc, this, *it);
+    }
+
+    MOT_LOG_INFO("RecoveryManager:: started %u redo replay workers", m_numReplayWorkers);
+    return true;
+}
+
+void RecoveryManager::StopRedoReplayWorkers()
+{
+    std::lock_guard<std::mutex> lock(m_replayWorkersLock);
+    if (m_replayWorkers.empty()) {
+        return;
+    }
+
+    // the workers replay what is queued before they end
+    for (auto it = m_replayWorkers.begin(); it != m_replayWorkers.end(); ++it) {
+        RedoReplayWorker* worker = *it;
+        {
+            std::lock_guard<std::mutex> workerLock(worker->m_lock);
+            worker->m_stop = true;
+        }
+        worker->m_cond.notify_all();
+    }
+
+    for (auto it = m_replayWorkers.begin(); it != m_replayWorkers.end(); ++it) {
+        if ((*it)->m_thread.joinable()) {
+            (*it)->m_thread.join();
+        }
+    }
+
+    for (auto it = m_replayWorkers.begin(); it != m_replayWorkers.end(); ++it) {
+        delete *it;
+    }
+    m_replayWorkers.clear();
+    MOT_LOG_INFO("RecoveryManager:: redo replay workers stopped");
+}
+
+void RecoveryManager::RedoReplayWorkerFunc(RedoReplayWorker* worker)
+{
+    // since this is a non-kernel thread we must set-up our own u_sess struct for the current thread
+    MOT_DECLARE_NON_KERNEL_THREAD();
+
+    MOT::MOTEngine* engine = MOT::MOTEngine::GetInstance();
+    SessionContext* sessionContext = GetSessionManager()->CreateSessionContext();
+    if (sessionContext == nullptr) {
+        MOT_LOG_ERROR("RecoveryManager::redoReplayWorkerFunc: failed to create session context");
+        OnError(RecoveryManager::ErrCodes::XLOG_SETUP,
+            "RecoveryManager::redoReplayWorkerFunc: failed to create session context");
+    } else if (!GetTaskAffinity().SetAffinity(MOTCurrThreadId)) {
+        // in a thread-pooled envelope the affinity could be disabled, so we use task affinity here
+        MOT_LOG_WARN("Failed to set affinity of redo replay worker, redo recovery performance may be affected");
+    }
+    MOT_LOG_DEBUG("RecoveryManager::redoReplayWorkerFunc start [%u] worker %u", (unsigned)MOTCurrThreadId, worker->m_id);
+
+    for (;;) {
+        RedoReplayTask task;
+        {
+            std::unique_lock<std::mutex> lock(worker->m_lock);
+            worker->m_cond.wait(lock, [worker]() { return worker->m_stop || !worker->m_queue.empty(); });
+            if (worker->m_queue.empty()) {
+                break;
+            }
+            task = worker->m_queue.front();
+        }
+
+        // after an error the transactions are only released, the redo thread reports the error
+        if (sessionContext != nullptr && !m_errorSet) {
+            (void)RedoTransaction(task.m_segments, task.m_transactionId, RecoveryOpState::COMMIT, worker);
+        }
+        delete task.m_segments;
+
+        {
+            std::lock_guard<std::mutex> lock(worker->m_lock);
+            worker->m_queue.pop_front();
+            worker->m_replayed++;
+            worker->m_replayedLsn = task.m_lsn;
+        }
+        worker->m_cond.notify_all();
+    }
+
+    if (sessionContext != nullptr) {
+        if (worker->m_numRedoOps != 0) {
+            ClearTableCache(worker->m_tableDeletesStat);
+            GcManager* gc = sessionContext->GetTxnManager()->GetGcSession();
+            if (gc != nullptr) {
+                gc->GcEndTxn();
+            }
+        }
+        if (worker->m_sState.IsEmpty() == false) {
+            AddSurrogateArrayToList(worker->m_sState);
+        }
+        GetSessionManager()->DestroySessionContext(sessionContext);
+    }
+    engine->OnCurrentThreadEnding();
+    MOT_LOG_DEBUG("RecoveryManager::redoReplayWorkerFunc end [%u] worker %u", (unsigned)MOTCurrThreadId, worker->m_id);
+}
+
+bool RecoveryManager::DispatchRedoTransaction(RedoTransactionSegments* segments, uint64_t transactionId)
+{
+    uint64_t workerMask = 0;
+
+    if (!GetRedoReplayWorkers(segments, workerMask)) {
+        WaitRedoReplayWorkers(ALL_REDO_REPLAY_WORKERS);
+        return false;
+    }
+
+    // without rows, or with rows of several workers, the redo thread replays the transaction in order
+    if (workerMask == 0 || (workerMask & (workerMask - 1)) != 0) {
+        WaitRedoReplayWorkers(workerMask);
+        return false;
+    }
+
+    uint32_t id = 0;
+    while ((workerMask & ((uint64_t)1 << id)) == 0) {
+        id++;
+    }
+
+    RedoReplayWorker* worker = m_replayWorkers[id];
+    {
+        std::unique_lock<std::mutex> lock(worker->m_lock);
+        worker->m_cond.wait(lock, [worker]() { return worker->m_queue.size() < REDO_REPLAY_QUEUE_SIZE; });
+        RedoReplayTask task = {segments, transactionId, m_lastRedoLsn};
+        worker->m_queue.push_back(task);
+        worker->m_dispatched++;
+        worker->m_dispatchedLsn = m_lastRedoLsn;
+    }
+    worker->m_cond.notify_all();
+    return true;
+}
+
+bool RecoveryManager::GetRedoReplayWorkers(RedoTransactionSegments* segments, uint64_t& workerMask)
+{
+    workerMask = 0;
+    for (uint32_t i = 0; i < segments->GetCount(); i++) {
+        LogSegment* segment = segments->GetSegment(i);
+        uint8_t* endPosition = (uint8_t*)(segment->m_data + segment->m_len);
+        uint8_t* operationData = (uint8_t*)(segment->m_data);
+        while (operationData < endPosition) {
+            uint64_t tableId = 0;
+            bool hasTable = false;
+            uint32_t length = GetLogOperationTable(operationData, tableId, hasTable);
+            if (length == 0) {
+                return false;
+            }
+            if (hasTable) {
+                workerMask |= (uint64_t)1 << (tableId % m_replayWorkers.size());
+            }
+            operationData += length;
+        }
+    }
+    return true;
+}
+
+void RecoveryManager::WaitRedoReplayWorkers(uint64_t workerMask)
+{
+    for (uint32_t i = 0; i < m_replayWorkers.size(); i++) {
+        if ((workerMask & ((uint64_t)1 << i)) == 0) {
+            continue;
+        }
+
+        // only what is queued now, the redo thread may keep queueing meanwhile
+        RedoReplayWorker* worker = m_replayWorkers[i];
+        std::unique_lock<std::mutex> lock(worker->m_lock);
+        uint64_t target = worker->m_dispatched;
+        worker->m_cond.wait(lock, [worker, target]() { return worker->m_replayed >= target; });
+    }
+}
+
+void RecoveryManager::WaitRedoReplayWorkers()
+{
+    std::lock_guard<std::mutex> lock(m_replayWorkersLock);
+    WaitRedoReplayWorkers(ALL_REDO_REPLAY_WORKERS);
+}
+
+uint32_t RecoveryManager::GetRedoReplayWorkerStats(RedoReplayWorkerStats* stats, uint32_t maxWorkers)
+{
+    std::lock_guard<std::mutex> lock(m_replayWorkersLock);
+    uint32_t count = 0;
+    while (count < m_replayWorkers.size() && count < maxWorkers) {
+        RedoReplayWorker* worker = m_replayWorkers[count];
+        std::lock_guard<std::mutex> workerLock(worker->m_lock);
+        stats[count].m_id = worker->m_id;
+        stats[count].m_queued = worker->m_dispatched - worker->m_replayed;
+        stats[count].m_replayed = worker->m_replayed;
+        stats[count].m_dispatchedLsn = worker->m_dispatchedLsn;
+        stats[count].m_replayedLsn = worker->m_replayedLsn;
+        count++;
+    }
+    return count;
+}
+}  // namespace MOT
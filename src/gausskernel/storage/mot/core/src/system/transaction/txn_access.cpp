@@ -203,6 +203,11 @@ void TxnAccess::DestroyAccess(Access* access)
         m_dummyTable.DestroyRow(row, access);
         access->m_localRow = nullptr;
     }
+    // a row copy is left over when the transaction aborts after validation
+    if (access->m_rowCopy != nullptr) {
+        access->m_rowCopy->GetTable()->DestroyRow(access->m_rowCopy);
+        access->m_rowCopy = nullptr;
+    }
     if (access->m_modifiedColumns.IsInitialized()) {
         m_dummyTable.DestroyBitMapBuffer(access->m_modifiedColumns.GetData(), access->m_modifiedColumns.GetSize());
         access->m_modifiedColumns.Reset();
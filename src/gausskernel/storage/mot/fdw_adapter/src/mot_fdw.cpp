@@ -132,6 +132,7 @@ static ForeignScan* MOTGetForeignPlan(PlannerInfo* root, RelOptInfo* baserel, Oi
 static void MOTExplainForeignScan(ForeignScanState* node, ExplainState* es);
 static void MOTBeginForeignScan(ForeignScanState* node, int eflags);
 static TupleTableSlot* MOTIterateForeignScan(ForeignScanState* node);
+static VectorBatch* MOTVecIterateForeignScan(VecForeignScanState* node);
 static void MOTReScanForeignScan(ForeignScanState* node);
 static void MOTEndForeignScan(ForeignScanState* node);
 static void MOTAddForeignUpdateTargets(Query* parsetree, RangeTblEntry* targetRte, Relation targetRelation);
@@ -333,6 +334,7 @@ Datum mot_fdw_handler(PG_FUNCTION_ARGS)
     fdwroutine->ExplainForeignScan = MOTExplainForeignScan;
     fdwroutine->BeginForeignScan = MOTBeginForeignScan;
     fdwroutine->IterateForeignScan = MOTIterateForeignScan;
+    fdwroutine->VecIterateForeignScan = MOTVecIterateForeignScan;
     fdwroutine->ReScanForeignScan = MOTReScanForeignScan;
     fdwroutine->EndForeignScan = MOTEndForeignScan;
     fdwroutine->AnalyzeForeignTable = MOTAnalyzeForeignTable;
@@ -810,8 +812,14 @@ static ForeignScan* MOTGetForeignPlan(
     if (tmpLocal != nullptr)
         list_free(tmpLocal);
 
+    // plain reads can feed the vector engine batch by batch, a unique key lookup returns one row anyway
+    bool pointLookup = (planstate->m_bestIx != nullptr &&
+                        planstate->m_bestIx->m_ixOpers[0] == KEY_OPER::READ_KEY_EXACT &&
+                        planstate->m_bestIx->m_ix->GetUnique());
+    bool vecOutput = (root->parse->commandType == CMD_SELECT && root->parse->rowMarks == nullptr && !pointLookup);
+
     List* quals = planstate->m_localConds;
-    return make_foreignscan(tlist,
+    ForeignScan* fscan = make_foreignscan(tlist,
         quals,
         scanRelid,
         remote, /* no expressions to evaluate */
@@ -823,6 +831,10 @@ static ForeignScan* MOTGetForeignPlan(
         nullptr
 #endif
     );
+
+    // the local quals are kept in the plan, the vector engine evaluates them on each batch
+    ((Plan*)fscan)->vec_output = vecOutput;
+    return fscan;
 }
 
 /*
@@ -1108,6 +1120,114 @@ static TupleTableSlot* MOTIterateForeignScan(ForeignScanState* node)
     }
 }
 
+static void MOTReportLookupError(MOTFdwStateSt* festate, MOT::RC rc)
+{
+    if (MOT_IS_SEVERE()) {
+        MOT_REPORT_ERROR(MOT_ERROR_INTERNAL, "MOTVecIterateForeignScan", "Failed to lookup row");
+        MOT_LOG_ERROR_STACK("Failed to lookup row");
+    }
+
+    CleanQueryStatesOnError(festate->m_currTxn);
+    report_pg_error(rc,
+        festate->m_currTxn,
+        (void*)(festate->m_currTxn->m_errIx != nullptr ? festate->m_currTxn->m_errIx->GetName().c_str() : "unknown"),
+        (void*)festate->m_currTxn->m_errMsgBuf);
+}
+
+/*
+ * Vectorized scan: fills the scan batch with up to BatchMaxSize rows straight from the row data. The range of
+ * the index is applied by the cursors, the other quals are evaluated on the batch by the vector engine.
+ */
+static VectorBatch* MOTVecIterateForeignScan(VecForeignScanState* node)
+{
+    MOT::RC rc = MOT::RC_OK;
+    MOTFdwStateSt* festate = (MOTFdwStateSt*)node->fdw_state;
+    VectorBatch* batch = node->m_pScanBatch;
+    bool stopAtFirst = (festate->m_bestIx && festate->m_bestIx->m_ixOpers[0] == KEY_OPER::READ_KEY_EXACT &&
+                        festate->m_bestIx->m_ix->GetUnique() == true);
+
+    batch->Reset(true);
+    if (node->ss.is_scan_end) {
+        return batch;
+    }
+
+    if (stopAtFirst) {
+        ForeignScan* fscan = (ForeignScan*)node->ss.ps.plan;
+        festate->m_execExprs = (List*)ExecInitExpr((Expr*)fscan->fdw_exprs, (PlanState*)node);
+        festate->m_econtext = node->ss.ps.ps_ExprContext;
+        MOTAdaptor::CreateKeyBuffer(node->ss.ss_currentRelation, festate, 0);
+        MOT::Sentinel* Sentinel =
+            festate->m_bestIx->m_ix->IndexReadSentinel(&festate->m_stateKey[0], festate->m_currTxn->GetThdId());
+        festate->m_currRow = festate->m_currTxn->RowLookup(festate->m_internalCmdOper, Sentinel, rc);
+        node->ss.is_scan_end = true;
+
+        if (festate->m_currRow != nullptr) {
+            MOTAdaptor::UnpackRowToBatch(
+                batch, 0, festate->m_table, festate->m_attrsUsed, const_cast<uint8_t*>(festate->m_currRow->GetData()));
+            batch->m_rows = 1;
+            festate->m_rowsFound++;
+        } else if (rc != MOT::RC_OK) {
+            MOTReportLookupError(festate, rc);
+        }
+        return batch;
+    }
+
+    if (!festate->m_cursorOpened) {
+        ForeignScan* fscan = (ForeignScan*)node->ss.ps.plan;
+        festate->m_execExprs = (List*)ExecInitExpr((Expr*)fscan->fdw_exprs, (PlanState*)node);
+        festate->m_econtext = node->ss.ps.ps_ExprContext;
+        CleanCursors(festate);
+        MOTAdaptor::OpenCursor(node->ss.ss_currentRelation, festate);
+
+        festate->m_cursorOpened = true;
+    }
+
+    // festate->cursor[1] might be NULL (in case it is not in use)
+    if (festate->m_cursor[0] == nullptr || !festate->m_cursor[0]->IsValid() ||
+        (festate->m_cursor[1] != nullptr && !festate->m_cursor[1]->IsValid())) {
+        node->ss.is_scan_end = true;
+        return batch;
+    }
+
+    while (batch->m_rows < BatchMaxSize) {
+        if (!festate->m_cursor[0]->IsValid()) {
+            node->ss.is_scan_end = true;
+            break;
+        }
+
+        MOT::Sentinel* Sentinel = festate->m_cursor[0]->GetPrimarySentinel();
+        festate->m_currRow = festate->m_currTxn->RowLookup(festate->m_internalCmdOper, Sentinel, rc);
+        if (festate->m_currRow == nullptr) {
+            if (rc != MOT::RC_OK) {
+                MOTReportLookupError(festate, rc);
+                batch->Reset(true);
+                return batch;
+            }
+            festate->m_cursor[0]->Next();
+            continue;
+        }
+
+        // check end condition for range search
+        if (MOTAdaptor::IsScanEnd(festate)) {
+            festate->m_cursor[0]->Invalidate();
+            node->ss.is_scan_end = true;
+            break;
+        }
+
+        MOTAdaptor::UnpackRowToBatch(batch,
+            batch->m_rows,
+            festate->m_table,
+            festate->m_attrsUsed,
+            const_cast<uint8_t*>(festate->m_currRow->GetData()));
+        batch->m_rows++;
+        festate->m_rowsFound++;
+
+        festate->m_cursor[0]->Next();
+    }
+
+    return batch;
+}
+
 /*
  *
  */
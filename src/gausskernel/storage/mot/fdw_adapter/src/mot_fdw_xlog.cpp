@@ -29,6 +29,7 @@
 #include "global.h"
 #include "postgres.h"
 #include "access/xlog.h"
+#include "storage/mot/mot_xlog.h"
 #include "mot_fdw_xlog.h"
 #include "mot_engine.h"
 #include "recovery_manager.h"
@@ -80,6 +81,26 @@ void MOTRedo(XLogReaderState* record)
     }
 }
 
+uint32 MOTGetRedoWorkerStats(MOTRedoWorkerStats* stats, uint32 maxWorkers)
+{
+    MOT::RecoveryManager::RedoReplayWorkerStats workers[MOT_MAX_REDO_WORKERS];
+    MOT::MOTEngine* engine = MOT::MOTEngine::GetInstance();
+    if (engine == nullptr || engine->GetRecoveryManager() == nullptr) {
+        return 0;
+    }
+
+    uint32 count =
+        engine->GetRecoveryManager()->GetRedoReplayWorkerStats(workers, Min(maxWorkers, MOT_MAX_REDO_WORKERS));
+    for (uint32 i = 0; i < count; i++) {
+        stats[i].id = workers[i].m_id;
+        stats[i].queued = workers[i].m_queued;
+        stats[i].replayed = workers[i].m_replayed;
+        stats[i].dispatched_lsn = workers[i].m_dispatchedLsn;
+        stats[i].replayed_lsn = workers[i].m_replayedLsn;
+    }
+    return count;
+}
+
 uint64_t XLOGLogger::AddToLog(uint8_t* data, uint32_t size)
 {
     XLogBeginInsert();
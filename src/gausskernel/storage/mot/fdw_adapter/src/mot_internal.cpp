@@ -2275,6 +2275,59 @@ void MOTAdaptor::UnpackRow(TupleTableSlot* slot, MOT::Table* table, const uint8_
     }
 }
 
+// the values are copied from the row into the batch, no datum is built on the way
+void MOTAdaptor::UnpackRowToBatch(
+    VectorBatch* batch, int row, MOT::Table* table, const uint8_t* attrs_used, uint8_t* srcRow)
+{
+    EnsureSafeThreadAccessInline();
+    size_t len = 0;
+
+    // column count includes null bits field
+    uint64_t cols = table->GetFieldCount() - 1;
+
+    for (uint64_t i = 0; i < cols; i++) {
+        ScalarVector* vec = &(batch->m_arr[i]);
+        vec->m_rows++;
+        if (!BITMAP_GET(attrs_used, i) || !BITMAP_GET(srcRow, i)) {
+            vec->SetNull(row);
+            continue;
+        }
+
+        MOT::Column* col = table->GetField(i + 1);
+        SET_NOTNULL(vec->m_flag[row]);
+        switch (vec->m_desc.typeId) {
+            case VARCHAROID:
+            case BPCHAROID:
+            case TEXTOID:
+            case CLOBOID:
+            case BYTEAOID: {
+                uintptr_t tmp;
+                col->Unpack(srcRow, &tmp, len);
+                (void)vec->AddVarCharWithoutHeader((const char*)tmp, (int)len, row);
+                break;
+            }
+            case NUMERICOID: {
+                MOT::DecimalSt* d;
+                col->Unpack(srcRow, (uintptr_t*)&d, len);
+                Numeric n = MOTNumericToPG(d);
+                (void)vec->AddVar(NumericGetDatum(n), row);
+                pfree(n);
+                break;
+            }
+            default: {
+                Datum value;
+                col->Unpack(srcRow, &value, len);
+                if (vec->m_desc.encoded) {
+                    (void)vec->AddVar(value, row);
+                } else {
+                    vec->m_vals[row] = value;
+                }
+                break;
+            }
+        }
+    }
+}
+
 // useful functions for data conversion: utils/fmgr/gmgr.cpp
 void MOTAdaptor::MOTToDatum(MOT::Table* table, const Form_pg_attribute attr, uint8_t* data, Datum* value, bool* is_null)
 {
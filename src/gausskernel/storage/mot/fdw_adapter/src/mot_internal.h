@@ -389,6 +389,8 @@ public:
     static void PackRow(TupleTableSlot* slot, MOT::Table* table, uint8_t* attrs_used, uint8_t* destRow);
     static void PackUpdateRow(TupleTableSlot* slot, MOT::Table* table, const uint8_t* attrs_used, uint8_t* destRow);
     static void UnpackRow(TupleTableSlot* slot, MOT::Table* table, const uint8_t* attrs_used, uint8_t* srcRow);
+    static void UnpackRowToBatch(
+        VectorBatch* batch, int row, MOT::Table* table, const uint8_t* attrs_used, uint8_t* srcRow);
 
     // scan helpers
     static void OpenCursor(Relation rel, MOTFdwStateSt* festate);
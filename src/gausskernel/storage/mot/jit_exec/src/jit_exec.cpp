@@ -542,6 +542,11 @@ extern bool IsMotCodegenPrintEnabled()
     return MOT::GetGlobalConfiguration().m_enableCodegenPrint;
 }
 
+extern bool IsMotProcedureCodegenEnabled()
+{
+    return MOT::GetGlobalConfiguration().m_enableProcedureCodegen;
+}
+
 extern uint32_t GetMotCodegenLimit()
 {
     return MOT::GetGlobalConfiguration().m_codegenLimit;
@@ -73,6 +73,7 @@
 #include "storage/ipc.h"
 #include "storage/latch.h"
 #include "storage/pmsignal.h"
+#include "storage/proc.h"
 #include "storage/procarray.h"
 #include "storage/smgr.h"
 #include "utils/guc.h"
@@ -80,6 +81,7 @@
 #include "utils/ps_status.h"
 #include "utils/resowner.h"
 #include "utils/timestamp.h"
+#include "lz4.h"
 
 /* max sleep time between cycles (1ms) */
 #define NAPTIME_PER_CYCLE 1
@@ -120,6 +122,8 @@ static void SetDataRcvConninfo(ReplConnTarget conn_target);
 static void ShutDownDataRcvWriter(void);
 
 /* Message */
+static char* DataRcvDecompress(const char* buf, Size len, uint32 rawLen);
+static void DataRcvProcessPage(DataPageMessageHeader* msghdr, char* buf, Size len);
 static void DataRcvProcessMsg(unsigned char type, char* buf, Size len);
 static void DataRcvReceive(char* buf, Size nbytes);
 
@@ -1002,6 +1006,52 @@ static int ParseDataHeader(HTAB* relFileNodeTab, char* bufPtr, uint32 nbytes)
 /*
  * Accept the message from replication stream, and process it.
  */
+/*
+ * Decompress the data of a compressed data page message, the result lives in
+ * a buffer of the datareceiver reused by the next message.
+ */
+static char* DataRcvDecompress(const char* buf, Size len, uint32 rawLen)
+{
+    int ret;
+
+    if (rawLen > t_thrd.datareceiver_cxt.decompressBufSize) {
+        if (t_thrd.datareceiver_cxt.decompressBuf != NULL)
+            pfree(t_thrd.datareceiver_cxt.decompressBuf);
+        t_thrd.datareceiver_cxt.decompressBuf = (char*)MemoryContextAlloc(t_thrd.top_mem_cxt, rawLen);
+        t_thrd.datareceiver_cxt.decompressBufSize = rawLen;
+    }
+
+    ret = LZ4_decompress_safe(buf, t_thrd.datareceiver_cxt.decompressBuf, (int)len, (int)rawLen);
+    if (ret < 0 || (uint32)ret != rawLen)
+        ereport(ERROR,
+            (errcode(ERRCODE_PROTOCOL_VIOLATION),
+                errmsg_internal("could not decompress data page message received from primary: "
+                                "got %d bytes, expected %u", ret, rawLen)));
+
+    return t_thrd.datareceiver_cxt.decompressBuf;
+}
+
+/*
+ * Check the data page of a data message against its header and receive it.
+ */
+static void DataRcvProcessPage(DataPageMessageHeader* msghdr, char* buf, Size len)
+{
+    volatile DataRcvData* datarcv = t_thrd.datareceiver_cxt.DataRcv;
+
+    if (datarcv->conn_target != REPCONNTARGET_DUMMYSTANDBY) {
+        DQByteAdvance(msghdr->dataStart, len);
+        if (!DQByteEQ(msghdr->dataStart, msghdr->dataEnd))
+            ereport(PANIC,
+                (errcode(ERRCODE_PROTOCOL_VIOLATION),
+                    errmsg("invalid message header, maybe the parameter of"
+                           " \"data_replicate_buffer_size\" on the master has been changed"),
+                    errhint("You might need to restart the instance.")));
+    } else if (unlikely(!DataQueuePtrIsInvalid(msghdr->dataEnd))) {
+        ereport(PANIC, (errcode(ERRCODE_PROTOCOL_VIOLATION), errmsg("invalid message end")));
+    }
+    DataRcvReceive(buf, len);
+}
+
 static void DataRcvProcessMsg(unsigned char type, char* buf, Size len)
 {
     errno_t errorno = EOK;
@@ -1027,23 +1077,29 @@ static void DataRcvProcessMsg(unsigned char type, char* buf, Size len)
             securec_check(errorno, "", "");
             ProcessDataHeaderMessage(&msghdr);
 
-            buf += sizeof(DataPageMessageHeader);
-            len -= sizeof(DataPageMessageHeader);
-
-            volatile DataRcvData* datarcv = t_thrd.datareceiver_cxt.DataRcv;
-
-            if (datarcv->conn_target != REPCONNTARGET_DUMMYSTANDBY) {
-                DQByteAdvance(msghdr.dataStart, len);
-                if (!DQByteEQ(msghdr.dataStart, msghdr.dataEnd))
-                    ereport(PANIC,
-                        (errcode(ERRCODE_PROTOCOL_VIOLATION),
-                            errmsg("invalid message header, maybe the parameter of"
-                                   " \"data_replicate_buffer_size\" on the master has been changed"),
-                            errhint("You might need to restart the instance.")));
-            } else if (unlikely(!DataQueuePtrIsInvalid(msghdr.dataEnd))) {
-                ereport(PANIC, (errcode(ERRCODE_PROTOCOL_VIOLATION), errmsg("invalid message end")));
-            }
-            DataRcvReceive(buf, len);
+            DataRcvProcessPage(&msghdr, buf + sizeof(DataPageMessageHeader), len - sizeof(DataPageMessageHeader));
+            break;
+        }
+
+        case 'c': /* compressed data page */
+        {
+            DataPageCompressedMessageHeader zhdr;
+
+            if (len < sizeof(DataPageCompressedMessageHeader))
+                ereport(ERROR,
+                    (errcode(ERRCODE_PROTOCOL_VIOLATION),
+                        errmsg_internal("invalid compressed data page message received from primary")));
+            /* memcpy is required here for alignment reasons */
+            errorno = memcpy_s(
+                &zhdr, sizeof(DataPageCompressedMessageHeader), buf, sizeof(DataPageCompressedMessageHeader));
+            securec_check(errorno, "", "");
+            ProcessDataHeaderMessage(&zhdr.header);
+
+            DataRcvProcessPage(&zhdr.header,
+                DataRcvDecompress(buf + sizeof(DataPageCompressedMessageHeader),
+                    len - sizeof(DataPageCompressedMessageHeader),
+                    zhdr.rawLen),
+                zhdr.rawLen);
             break;
         }
 
@@ -1432,6 +1488,7 @@ static void DataRcvStreamConnect(char* conninfo)
     TimeLineID standby_tli;
     PGresult* res = NULL;
     ServerMode primary_mode;
+    bool compress = false;
     int rc = EOK;
 
     /*
@@ -1568,9 +1625,13 @@ static void DataRcvStreamConnect(char* conninfo)
         t_thrd.xlog_cxt.ThisTimeLineID = primary_tli;
     }
     /*
-     * Start data replication.
+     * Start data replication. A compressed stream is only asked for once the
+     * primary can't run an older version anymore.
      */
-    res = PQexec(t_thrd.datareceiver_cxt.dataStreamingConn, "START_REPLICATION DATA");
+    compress = u_sess->attr.attr_storage.enable_stream_compression && t_thrd.proc &&
+               t_thrd.proc->workingVersionNum >= STREAM_COMPRESSION_VERSION_NUM;
+    res = PQexec(t_thrd.datareceiver_cxt.dataStreamingConn,
+        compress ? "START_REPLICATION DATA COMPRESSION " REPL_COMPRESSION_LZ4 : "START_REPLICATION DATA");
     if (PQresultStatus(res) != PGRES_COPY_BOTH) {
         PQclear(res);
         ereport(ERROR,
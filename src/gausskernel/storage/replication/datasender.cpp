@@ -82,6 +82,7 @@
 #include "utils/resowner.h"
 #include "utils/timestamp.h"
 #include "gssignal/gs_signal.h"
+#include "lz4.h"
 
 /* Flag indicates dummy are searching bcm files now */
 static bool dummySearching;
@@ -108,6 +109,7 @@ static void DataSndHandshake(void);
 static void DataSndKill(int code, Datum arg);
 static void DataSndShutdown(void) __attribute__((noreturn));
 static void DataSend(bool* caughtup);
+static void DataSendCompressed(const DataPageMessageHeader* msghdr, uint32 sendsize);
 
 static void IdentifySystem(void);
 static void StartDataReplication(StartDataReplicationCmd* cmd);
@@ -384,6 +386,19 @@ static void StartDataReplication(StartDataReplicationCmd* cmd)
 {
     StringInfoData buf;
 
+    /* The standby asks for a compressed data stream, see DataSendCompressed */
+    if (cmd->compression != NULL) {
+        if (strcmp(cmd->compression, REPL_COMPRESSION_LZ4) != 0)
+            ereport(ERROR,
+                (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                    errmsg("unsupported replication compression method \"%s\"", cmd->compression)));
+
+        if (t_thrd.datasender_cxt.compress_message == NULL)
+            t_thrd.datasender_cxt.compress_message = (char*)MemoryContextAlloc(t_thrd.top_mem_cxt,
+                1 + sizeof(DataPageCompressedMessageHeader) +
+                    LZ4_COMPRESSBOUND(g_instance.attr.attr_storage.MaxSendSize * 1024));
+    }
+
     /*
      * When we first start replication the standby will be behind the primary.
      * For some applications, for example, synchronous replication, it is
@@ -1163,6 +1178,35 @@ static void DataSndShutdown(void)
     abort(); /* keep the compiler quiet */
 }
 
+/*
+ * Send the data page prepared in output_message as a compressed data message
+ * ('c'), or as a plain 'd' message when the data does not shrink.
+ */
+static void DataSendCompressed(const DataPageMessageHeader* msghdr, uint32 sendsize)
+{
+    char* msg = t_thrd.datasender_cxt.compress_message;
+    DataPageCompressedMessageHeader zhdr;
+    int zlen;
+    errno_t rc = 0;
+
+    zlen = LZ4_compress_default(t_thrd.datasender_cxt.output_message + 1 + sizeof(DataPageMessageHeader),
+        msg + 1 + sizeof(DataPageCompressedMessageHeader),
+        (int)sendsize,
+        LZ4_COMPRESSBOUND(g_instance.attr.attr_storage.MaxSendSize * 1024));
+    if (zlen <= 0 || (uint32)zlen >= sendsize) {
+        pq_putmessage_noblock(
+            'd', t_thrd.datasender_cxt.output_message, 1 + sizeof(DataPageMessageHeader) + sendsize);
+        return;
+    }
+
+    msg[0] = 'c';
+    zhdr.header = *msghdr;
+    zhdr.rawLen = sendsize;
+    rc = memcpy_s(msg + 1, sizeof(DataPageCompressedMessageHeader), &zhdr, sizeof(DataPageCompressedMessageHeader));
+    securec_check(rc, "", "");
+    pq_putmessage_noblock('d', msg, 1 + sizeof(DataPageCompressedMessageHeader) + zlen);
+}
+
 static void DataSend(bool* caughtup)
 {
     /* use volatile pointer to prevent code rearrangement */
@@ -1229,7 +1273,11 @@ static void DataSend(bool* caughtup)
         sizeof(DataPageMessageHeader));
     securec_check(rc, "", "");
 
-    pq_putmessage_noblock('d', t_thrd.datasender_cxt.output_message, 1 + sizeof(DataPageMessageHeader) + sendsize);
+    if (t_thrd.datasender_cxt.compress_message != NULL)
+        DataSendCompressed(&msghdr, sendsize);
+    else
+        pq_putmessage_noblock(
+            'd', t_thrd.datasender_cxt.output_message, 1 + sizeof(DataPageMessageHeader) + sendsize);
 
     SpinLockAcquire(&datasnd->mutex);
     datasnd->sendPosition.queueid = endptr.queueid;
@@ -820,6 +820,13 @@ retry:
             (uint32)(*startpoint));
     securec_check_ss(nRet, "", "");
 
+    /* ask the primary for a compressed WAL stream, once it can't run an older version anymore */
+    if (u_sess->attr.attr_storage.enable_stream_compression && t_thrd.proc &&
+        t_thrd.proc->workingVersionNum >= STREAM_COMPRESSION_VERSION_NUM) {
+        nRet = strcat_s(cmd, sizeof(cmd), " COMPRESSION " REPL_COMPRESSION_LZ4);
+        securec_check(nRet, "", "");
+    }
+
     res = libpqrcv_PQexec(cmd);
     if (PQresultStatus(res) != PGRES_COPY_BOTH) {
         PQclear(res);
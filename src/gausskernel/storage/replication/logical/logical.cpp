@@ -63,6 +63,12 @@ static void begin_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn);
 static void commit_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 static void change_cb_wrapper(
     ReorderBuffer* cache, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change);
+static void stream_start_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn);
+static void stream_stop_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn);
+static void stream_change_cb_wrapper(
+    ReorderBuffer* cache, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change);
+static void stream_abort_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+static void stream_commit_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 static void LoadOutputPlugin(OutputPluginCallbacks* callbacks, const char* plugin);
 
 /*
@@ -156,6 +162,20 @@ static LogicalDecodingContext* StartupDecodingContext(List* output_plugin_option
     ctx->reorder->apply_change = change_cb_wrapper;
     ctx->reorder->commit = commit_cb_wrapper;
 
+    /*
+     * Large in-progress transactions are streamed only if the output plugin
+     * provides all the stream callbacks; it may still turn streaming off in
+     * its startup callback.
+     */
+    ctx->streaming = !fast_forward && ctx->callbacks.stream_start_cb != NULL &&
+                     ctx->callbacks.stream_stop_cb != NULL && ctx->callbacks.stream_change_cb != NULL &&
+                     ctx->callbacks.stream_abort_cb != NULL && ctx->callbacks.stream_commit_cb != NULL;
+    ctx->reorder->stream_start = stream_start_cb_wrapper;
+    ctx->reorder->stream_stop = stream_stop_cb_wrapper;
+    ctx->reorder->stream_change = stream_change_cb_wrapper;
+    ctx->reorder->stream_abort = stream_abort_cb_wrapper;
+    ctx->reorder->stream_commit = stream_commit_cb_wrapper;
+
     ctx->out = makeStringInfo();
     ctx->prepare_write = prepare_write;
     ctx->write = do_write;
@@ -421,6 +441,61 @@ LogicalDecodingContext* CreateDecodingContext(XLogRecPtr start_lsn, List* output
     return ctx;
 }
 
+/*
+ * Create a decoding context for a parallel decoding worker of the walsender
+ * owning slot.  The worker decodes committed transactions handed over by the
+ * walsender through its own reorder buffer, so there is neither a WAL reader
+ * nor a snapshot builder.
+ */
+LogicalDecodingContext* CreateParallelDecodingContext(ReplicationSlot* slot, List* output_plugin_options,
+    LogicalOutputPluginWriterPrepareWrite prepare_write, LogicalOutputPluginWriterWrite do_write)
+{
+    MemoryContext context, old_context;
+    LogicalDecodingContext* ctx = NULL;
+
+    context = AllocSetContextCreate(CurrentMemoryContext,
+        "Parallel Decoding Context",
+        ALLOCSET_DEFAULT_MINSIZE,
+        ALLOCSET_DEFAULT_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE);
+    old_context = MemoryContextSwitchTo(context);
+    ctx = (LogicalDecodingContext*)palloc0(sizeof(LogicalDecodingContext));
+
+    ctx->context = context;
+
+    LoadOutputPlugin(&ctx->callbacks, NameStr(slot->data.plugin));
+
+    /* like the walsender, our xmin is enforced via the replication slot */
+    (void)LWLockAcquire(ProcArrayLock, LW_EXCLUSIVE);
+    t_thrd.pgxact->vacuumFlags |= PROC_IN_LOGICAL_DECODING;
+    LWLockRelease(ProcArrayLock);
+
+    ctx->slot = slot;
+
+    ctx->reorder = ReorderBufferAllocate();
+    ctx->reorder->private_data = ctx;
+    ctx->reorder->begin = begin_cb_wrapper;
+    ctx->reorder->apply_change = change_cb_wrapper;
+    ctx->reorder->commit = commit_cb_wrapper;
+
+    ctx->out = makeStringInfo();
+    ctx->prepare_write = prepare_write;
+    ctx->write = do_write;
+
+    ctx->output_plugin_options = output_plugin_options;
+    ctx->fast_forward = false;
+
+    if (ctx->callbacks.startup_cb != NULL)
+        startup_cb_wrapper(ctx, &ctx->options, false);
+
+    /* transactions arrive here complete, streaming is up to the walsender */
+    ctx->streaming = false;
+
+    (void)MemoryContextSwitchTo(old_context);
+
+    return ctx;
+}
+
 /*
  * Returns true if an consistent initial decoding snapshot has been built.
  */
@@ -485,8 +560,10 @@ void FreeDecodingContext(LogicalDecodingContext* ctx)
         shutdown_cb_wrapper(ctx);
 
     ReorderBufferFree(ctx->reorder);
-    FreeSnapshotBuilder(ctx->snapshot_builder);
-    XLogReaderFree(ctx->reader);
+    if (ctx->snapshot_builder != NULL)
+        FreeSnapshotBuilder(ctx->snapshot_builder);
+    if (ctx->reader != NULL)
+        XLogReaderFree(ctx->reader);
     MemoryContextDelete(ctx->context);
 }
 
@@ -712,6 +789,156 @@ static void change_cb_wrapper(
     t_thrd.log_cxt.error_context_stack = errcallback.previous;
 }
 
+static void stream_start_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+    Assert(ctx->streaming);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_start";
+    state.report_location = txn->first_lsn;
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = txn->first_lsn;
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_start_cb(ctx, txn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
+static void stream_stop_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+    Assert(ctx->streaming);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_stop";
+    state.report_location = txn->first_lsn;
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = txn->first_lsn;
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_stop_cb(ctx, txn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
+static void stream_change_cb_wrapper(
+    ReorderBuffer* cache, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+    Assert(ctx->streaming);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_change";
+    state.report_location = change->lsn;
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state, see change_cb_wrapper */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = change->lsn;
+
+    ctx->callbacks.stream_change_cb(ctx, txn, relation, change);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
+static void stream_abort_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr abort_lsn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+    Assert(ctx->streaming);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_abort";
+    state.report_location = abort_lsn;
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = abort_lsn;
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_abort_cb(ctx, txn, abort_lsn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
+static void stream_commit_cb_wrapper(ReorderBuffer* cache, ReorderBufferTXN* txn, XLogRecPtr commit_lsn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)cache->private_data;
+    LogicalErrorCallbackState state;
+    ErrorContextCallback errcallback;
+
+    Assert(!ctx->fast_forward);
+    Assert(ctx->streaming);
+
+    /* Push callback + info on the error context stack */
+    state.ctx = ctx;
+    state.callback_name = "stream_commit";
+    state.report_location = txn->final_lsn; /* beginning of commit record */
+    errcallback.callback = output_plugin_error_callback;
+    errcallback.arg = (void*)&state;
+    errcallback.previous = t_thrd.log_cxt.error_context_stack;
+    t_thrd.log_cxt.error_context_stack = &errcallback;
+
+    /* set output state */
+    ctx->accept_writes = true;
+    ctx->write_xid = txn->xid;
+    ctx->write_location = txn->end_lsn; /* points to the end of the record */
+
+    /* do the actual work: call callback */
+    ctx->callbacks.stream_commit_cb(ctx, txn, commit_lsn);
+
+    /* Pop the error context stack */
+    t_thrd.log_cxt.error_context_stack = errcallback.previous;
+}
+
 bool filter_by_origin_cb_wrapper(LogicalDecodingContext* ctx, RepOriginId origin_id)
 {
     LogicalErrorCallbackState state;
@@ -0,0 +1,816 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * parallel_decode.cpp
+ *        Parallel decoding workers of a logical walsender.
+ *
+ * A logical walsender reads the WAL and assembles transactions in its reorder
+ * buffer as usual.  When logical_decoding_parallel_workers is set, committed
+ * transactions that need no catalog change to be decoded are flattened and
+ * handed to one of the decoding workers of the walsender, which runs the
+ * output plugin on it in its own decoding context and keeps the output.  The
+ * walsender sends the output of the handed over transactions in commit order;
+ * a transaction it has to decode by itself waits until everything handed over
+ * before it is sent, so the client sees the same stream as from a serial
+ * walsender.
+ *
+ * Workers are private to their walsender and exit with it.  Transactions
+ * changing the catalog bump the invalidation epoch of the reorder buffer, a
+ * worker resets its caches before decoding a transaction of a newer epoch.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/replication/logical/parallel_decode.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+
+#include "access/xlog.h"
+#include "gssignal/gs_signal.h"
+#include "libpq/pqsignal.h"
+#include "nodes/pg_list.h"
+#include "postmaster/postmaster.h"
+#include "replication/logical.h"
+#include "replication/parallel_decode.h"
+#include "replication/reorderbuffer.h"
+#include "replication/slot.h"
+#include "replication/walsender.h"
+#include "replication/walsender_private.h"
+#include "storage/barrier.h"
+#include "storage/ipc.h"
+#include "storage/proc.h"
+#include "storage/procsignal.h"
+#include "tcop/tcopprot.h"
+#include "utils/builtins.h"
+#include "utils/inval.h"
+#include "utils/memutils.h"
+#include "utils/postinit.h"
+#include "utils/ps_status.h"
+#include "utils/resowner.h"
+#include "utils/timestamp.h"
+#include "gstrace/gstrace_infra.h"
+
+/* how long the walsender sleeps at most while waiting for its workers, in ms */
+#define PARALLEL_DECODE_WAIT_INTERVAL 1000
+
+/* how long the walsender waits for its workers to start or to exit, in seconds */
+#define PARALLEL_DECODE_STARTUP_TIMEOUT 60
+#define PARALLEL_DECODE_SHUTDOWN_TIMEOUT 60
+
+typedef enum {
+    DECODE_WORKER_STARTING = 0,
+    DECODE_WORKER_READY,
+    DECODE_WORKER_EXITED
+} ParallelDecodeWorkerState;
+
+/* a committed transaction handed to a decoding worker */
+typedef struct ParallelDecodeTask {
+    TransactionId xid;
+    XLogRecPtr first_lsn;
+    XLogRecPtr commit_lsn;
+    XLogRecPtr end_lsn;
+    RepOriginId origin_id;
+    CommitSeqNo csn;
+    TimestampTz commit_time;
+    uint64 invalidation_epoch;
+
+    StringInfoData changes; /* flattened by ReorderBufferSerializeCommittedTXN */
+    StringInfoData output;  /* ParallelDecodeMsgHeader and data of each message */
+
+    volatile bool done;
+    struct ParallelDecodeTask* next; /* in commit order, walsender only */
+} ParallelDecodeTask;
+
+/* header of a message written by the output plugin in a decoding worker */
+typedef struct ParallelDecodeMsgHeader {
+    XLogRecPtr lsn;
+    TransactionId xid;
+    bool last_write;
+    int len;
+} ParallelDecodeMsgHeader;
+
+typedef struct ParallelDecodeWorker {
+    int id;
+    volatile ParallelDecodeWorkerState state;
+    ThreadId tid;
+    PGPROC* volatile proc;
+
+    /* set by the walsender before starting the worker */
+    Latch* sender_latch;
+    ReplicationSlot* slot;
+    Oid dbid;
+    List* options;
+    ParallelDecodeStageStats* stats;
+
+    /* single producer single consumer ring of tasks */
+    ParallelDecodeTask* queue[PARALLEL_DECODE_QUEUE_SIZE];
+    pg_atomic_uint32 head; /* next task to decode, advanced by the worker */
+    pg_atomic_uint32 tail; /* next free entry, advanced by the walsender */
+
+    volatile bool shutdown;
+
+    /* worker private */
+    ParallelDecodeTask* current;
+    uint64 invalidation_epoch;
+} ParallelDecodeWorker;
+
+typedef struct ParallelDecodeCtl {
+    MemoryContext context; /* shared with the workers, holds workers and tasks */
+    int nworkers;
+    ParallelDecodeWorker* workers[MAX_PARALLEL_DECODE_WORKERS];
+
+    /* tasks handed over and not sent yet, in commit order */
+    ParallelDecodeTask* head;
+    ParallelDecodeTask* tail;
+    int ntasks;
+
+    Latch* latch;
+    ParallelDecodeStats* stats;
+    bool emitting;
+} ParallelDecodeCtl;
+
+/* the workers of this walsender, stopped when it exits */
+static THR_LOCAL ParallelDecodeCtl* MyParallelDecodeCtl = NULL;
+
+static bool ParallelDecodeDispatch(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
+static void ParallelDecodeDrain(ReorderBuffer* rb);
+static void ParallelDecodeWait(ParallelDecodeCtl* ctl);
+static void ParallelDecodeCheckWorkers(ParallelDecodeCtl* ctl);
+static void ParallelDecodeShutdownWorkers(ParallelDecodeCtl* ctl);
+static void ParallelDecodeSenderExit(int code, Datum arg);
+static void ParallelDecodeWorkerExit(int code, Datum arg);
+static void ParallelDecodeProcessTask(LogicalDecodingContext* ctx, ParallelDecodeWorker* worker,
+    ParallelDecodeTask* task);
+static void ParallelDecodePrepareWrite(LogicalDecodingContext* ctx, XLogRecPtr lsn, TransactionId xid,
+    bool last_write);
+static void ParallelDecodeWrite(LogicalDecodingContext* ctx, XLogRecPtr lsn, TransactionId xid, bool last_write);
+
+static inline uint32 ParallelDecodeQueueDepth(ParallelDecodeWorker* worker)
+{
+    return pg_atomic_read_u32(&worker->tail) - pg_atomic_read_u32(&worker->head);
+}
+
+/*
+ * Start nworkers decoding workers for the decoding context of this walsender.
+ * The walsender latch is set by the workers whenever output is ready.
+ */
+void ParallelDecodeStart(LogicalDecodingContext* ctx, int nworkers, Latch* latch, ParallelDecodeStats* stats)
+{
+    ParallelDecodeCtl* ctl = NULL;
+    MemoryContext oldcontext = NULL;
+    TimestampTz start_time;
+    int i;
+
+    Assert(ctx->parallel == NULL && MyParallelDecodeCtl == NULL);
+    Assert(nworkers > 0 && nworkers <= MAX_PARALLEL_DECODE_WORKERS);
+
+    ctl = (ParallelDecodeCtl*)palloc0(sizeof(ParallelDecodeCtl));
+    ctl->context = AllocSetContextCreate(g_instance.instance_context,
+        "ParallelDecodeContext",
+        ALLOCSET_DEFAULT_MINSIZE,
+        ALLOCSET_DEFAULT_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE,
+        SHARED_CONTEXT);
+    ctl->latch = latch;
+    ctl->stats = stats;
+
+    MyParallelDecodeCtl = ctl;
+    on_shmem_exit(ParallelDecodeSenderExit, 0);
+
+    oldcontext = MemoryContextSwitchTo(ctl->context);
+    for (i = 0; i < nworkers; i++) {
+        ParallelDecodeWorker* worker = (ParallelDecodeWorker*)palloc0(sizeof(ParallelDecodeWorker));
+
+        worker->id = i;
+        worker->state = DECODE_WORKER_STARTING;
+        worker->sender_latch = latch;
+        worker->slot = t_thrd.slot_cxt.MyReplicationSlot;
+        worker->dbid = u_sess->proc_cxt.MyDatabaseId;
+        worker->options = (List*)copyObject(ctx->output_plugin_options);
+        worker->stats = &stats->decoders[i];
+        ctl->workers[i] = worker;
+    }
+    (void)MemoryContextSwitchTo(oldcontext);
+
+    for (i = 0; i < nworkers; i++) {
+        ParallelDecodeWorker* worker = ctl->workers[i];
+
+        worker->tid = initialize_util_thread(PARALLEL_DECODE, worker);
+        if (worker->tid == 0)
+            ereport(ERROR,
+                (errcode(ERRCODE_INSUFFICIENT_RESOURCES), errmsg("could not start parallel decoding worker %d", i)));
+        ctl->nworkers++;
+    }
+
+    /* wait until all workers are attached to the database */
+    start_time = GetCurrentTimestamp();
+    for (;;) {
+        bool ready = true;
+
+        for (i = 0; i < ctl->nworkers; i++) {
+            if (ctl->workers[i]->state == DECODE_WORKER_EXITED)
+                ereport(ERROR,
+                    (errcode(ERRCODE_LOGICAL_DECODE_ERROR),
+                        errmsg("parallel decoding worker %d exited during startup", i)));
+            if (ctl->workers[i]->state != DECODE_WORKER_READY)
+                ready = false;
+        }
+        if (ready)
+            break;
+
+        if (TimestampDifferenceExceeds(start_time, GetCurrentTimestamp(), PARALLEL_DECODE_STARTUP_TIMEOUT * 1000))
+            ereport(ERROR,
+                (errcode(ERRCODE_LOGICAL_DECODE_ERROR), errmsg("timeout waiting for parallel decoding workers")));
+
+        ParallelDecodeWait(ctl);
+    }
+
+    ctx->parallel = ctl;
+    ctx->reorder->dispatch = ParallelDecodeDispatch;
+    ctx->reorder->drain = ParallelDecodeDrain;
+    stats->nworkers = ctl->nworkers;
+
+    ereport(LOG,
+        (errmsg("started %d parallel decoding workers for replication slot \"%s\"",
+            ctl->nworkers,
+            NameStr(t_thrd.slot_cxt.MyReplicationSlot->data.name))));
+}
+
+/*
+ * Send what the workers have decoded and stop them.  Transactions still being
+ * decoded are dropped, they are decoded again after a restart as they are
+ * after the confirmed position of the slot.
+ */
+void ParallelDecodeStop(LogicalDecodingContext* ctx)
+{
+    ParallelDecodeCtl* ctl = ctx->parallel;
+
+    if (ctl == NULL)
+        return;
+
+    ParallelDecodeEmit(ctx, false);
+
+    ctx->reorder->dispatch = NULL;
+    ctx->reorder->drain = NULL;
+    ctx->parallel = NULL;
+
+    ParallelDecodeShutdownWorkers(ctl);
+    cancel_shmem_exit(ParallelDecodeSenderExit, 0);
+    MyParallelDecodeCtl = NULL;
+    pfree(ctl);
+}
+
+/*
+ * Send the output of the handed over transactions decoded so far, in commit
+ * order.  With wait, return only when everything handed over has been sent.
+ */
+void ParallelDecodeEmit(LogicalDecodingContext* ctx, bool wait)
+{
+    ParallelDecodeCtl* ctl = (ctx != NULL) ? ctx->parallel : NULL;
+
+    /* a write of the walsender can land here again */
+    if (ctl == NULL || ctl->emitting)
+        return;
+
+    ctl->emitting = true;
+    PG_TRY();
+    {
+        while (ctl->head != NULL) {
+            ParallelDecodeTask* task = ctl->head;
+            int off = 0;
+
+            if (!task->done) {
+                ParallelDecodeCheckWorkers(ctl);
+                if (!wait)
+                    break;
+                ParallelDecodeWait(ctl);
+                continue;
+            }
+            pg_read_barrier();
+
+            while (off < task->output.len) {
+                ParallelDecodeMsgHeader hdr;
+                errno_t rc = memcpy_s(&hdr, sizeof(hdr), task->output.data + off, sizeof(hdr));
+                securec_check(rc, "", "");
+                off += sizeof(hdr);
+
+                ctx->prepare_write(ctx, hdr.lsn, hdr.xid, hdr.last_write);
+                appendBinaryStringInfo(ctx->out, task->output.data + off, hdr.len);
+                ctx->write(ctx, hdr.lsn, hdr.xid, hdr.last_write);
+                off += hdr.len;
+            }
+
+            ctl->head = task->next;
+            if (ctl->head == NULL)
+                ctl->tail = NULL;
+            ctl->ntasks--;
+            ctl->stats->committer.queue_depth = ctl->ntasks;
+
+            pfree_ext(task->output.data);
+            pfree(task);
+        }
+    }
+    PG_CATCH();
+    {
+        ctl->emitting = false;
+        PG_RE_THROW();
+    }
+    PG_END_TRY();
+    ctl->emitting = false;
+}
+
+/*
+ * Commit lsn of the oldest transaction handed over and not sent yet, the
+ * walsender must not report anything later as sent.
+ */
+XLogRecPtr ParallelDecodeOldestPendingLSN(LogicalDecodingContext* ctx)
+{
+    ParallelDecodeCtl* ctl = ctx->parallel;
+
+    if (ctl == NULL || ctl->head == NULL)
+        return InvalidXLogRecPtr;
+
+    return ctl->head->commit_lsn;
+}
+
+/*
+ * ReorderBuffer dispatch callback: hand a committed transaction to the least
+ * busy worker.
+ */
+static bool ParallelDecodeDispatch(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)rb->private_data;
+    ParallelDecodeCtl* ctl = ctx->parallel;
+    ParallelDecodeWorker* worker = NULL;
+    ParallelDecodeTask* task = NULL;
+    MemoryContext oldcontext = NULL;
+    PGPROC* proc = NULL;
+    uint32 tail;
+
+    for (;;) {
+        uint32 depth = PARALLEL_DECODE_QUEUE_SIZE;
+        int i;
+
+        for (i = 0; i < ctl->nworkers; i++) {
+            uint32 cur = ParallelDecodeQueueDepth(ctl->workers[i]);
+
+            if (cur < depth) {
+                depth = cur;
+                worker = ctl->workers[i];
+            }
+        }
+        if (worker != NULL)
+            break;
+
+        /* all queues are full, send what is ready meanwhile */
+        ParallelDecodeEmit(ctx, false);
+        ParallelDecodeWait(ctl);
+    }
+
+    oldcontext = MemoryContextSwitchTo(ctl->context);
+    task = (ParallelDecodeTask*)palloc0(sizeof(ParallelDecodeTask));
+    task->xid = txn->xid;
+    task->first_lsn = txn->first_lsn;
+    task->commit_lsn = commit_lsn;
+    task->end_lsn = txn->end_lsn;
+    task->origin_id = txn->origin_id;
+    task->csn = txn->csn;
+    task->commit_time = txn->commit_time;
+    task->invalidation_epoch = rb->invalidation_epoch;
+    initStringInfo(&task->changes);
+    initStringInfo(&task->output);
+    (void)MemoryContextSwitchTo(oldcontext);
+
+    PG_TRY();
+    {
+        ReorderBufferSerializeCommittedTXN(rb, txn, &task->changes);
+    }
+    PG_CATCH();
+    {
+        pfree_ext(task->changes.data);
+        pfree_ext(task->output.data);
+        pfree(task);
+        PG_RE_THROW();
+    }
+    PG_END_TRY();
+
+    /* publish the task, the worker only looks at entries before tail */
+    tail = pg_atomic_read_u32(&worker->tail);
+    worker->queue[tail % PARALLEL_DECODE_QUEUE_SIZE] = task;
+    pg_write_barrier();
+    pg_atomic_write_u32(&worker->tail, tail + 1);
+
+    proc = worker->proc;
+    if (proc != NULL)
+        SetLatch(&proc->procLatch);
+
+    if (ctl->tail != NULL)
+        ctl->tail->next = task;
+    else
+        ctl->head = task;
+    ctl->tail = task;
+    ctl->ntasks++;
+    ctl->stats->committer.queue_depth = ctl->ntasks;
+
+    return true;
+}
+
+/* ReorderBuffer drain callback */
+static void ParallelDecodeDrain(ReorderBuffer* rb)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)rb->private_data;
+
+    ParallelDecodeEmit(ctx, true);
+}
+
+/*
+ * Sleep until a worker sets the walsender latch.  The latch is set again
+ * afterwards, so that the main loop of the walsender doesn't miss a wakeup
+ * consumed here.
+ */
+static void ParallelDecodeWait(ParallelDecodeCtl* ctl)
+{
+    int rc;
+
+    CHECK_FOR_INTERRUPTS();
+
+    rc = WaitLatch(ctl->latch, WL_LATCH_SET | WL_TIMEOUT | WL_POSTMASTER_DEATH, PARALLEL_DECODE_WAIT_INTERVAL);
+    if (((unsigned int)rc) & WL_POSTMASTER_DEATH)
+        gs_thread_exit(1);
+    ResetLatch(ctl->latch);
+
+    CHECK_FOR_INTERRUPTS();
+    SetLatch(ctl->latch);
+}
+
+/* a worker only exits on its own because of an error */
+static void ParallelDecodeCheckWorkers(ParallelDecodeCtl* ctl)
+{
+    int i;
+
+    for (i = 0; i < ctl->nworkers; i++) {
+        if (ctl->workers[i]->state == DECODE_WORKER_EXITED)
+            ereport(ERROR,
+                (errcode(ERRCODE_LOGICAL_DECODE_ERROR),
+                    errmsg("parallel decoding worker %d exited unexpectedly", i),
+                    errhint("See the server log of the worker for details.")));
+    }
+}
+
+static void ParallelDecodeShutdownWorkers(ParallelDecodeCtl* ctl)
+{
+    TimestampTz start_time = GetCurrentTimestamp();
+    bool exited = false;
+    int i;
+
+    for (i = 0; i < ctl->nworkers; i++) {
+        PGPROC* proc = ctl->workers[i]->proc;
+
+        ctl->workers[i]->shutdown = true;
+        if (proc != NULL)
+            SetLatch(&proc->procLatch);
+    }
+
+    while (!exited) {
+        exited = true;
+        for (i = 0; i < ctl->nworkers; i++) {
+            if (ctl->workers[i]->state != DECODE_WORKER_EXITED)
+                exited = false;
+        }
+        if (exited)
+            break;
+
+        if (TimestampDifferenceExceeds(start_time, GetCurrentTimestamp(), PARALLEL_DECODE_SHUTDOWN_TIMEOUT * 1000)) {
+            /* a worker may still use the shared context, leave it alone */
+            ereport(WARNING, (errmsg("timeout waiting for parallel decoding workers to exit")));
+            ctl->stats->nworkers = 0;
+            return;
+        }
+
+        (void)WaitLatch(ctl->latch, WL_LATCH_SET | WL_TIMEOUT, PARALLEL_DECODE_WAIT_INTERVAL);
+        ResetLatch(ctl->latch);
+    }
+
+    ctl->stats->nworkers = 0;
+    MemoryContextDelete(ctl->context);
+}
+
+/* stop the workers when the walsender exits while they are running */
+static void ParallelDecodeSenderExit(int code, Datum arg)
+{
+    ParallelDecodeCtl* ctl = MyParallelDecodeCtl;
+
+    if (ctl == NULL)
+        return;
+
+    MyParallelDecodeCtl = NULL;
+    ParallelDecodeShutdownWorkers(ctl);
+}
+
+static void ParallelDecodeWorkerExit(int code, Datum arg)
+{
+    ParallelDecodeWorker* worker = (ParallelDecodeWorker*)DatumGetPointer(arg);
+    Latch* latch = worker->sender_latch;
+
+    worker->proc = NULL;
+    pg_write_barrier();
+    worker->state = DECODE_WORKER_EXITED;
+    SetLatch(latch);
+}
+
+/*
+ * Main entry point of a decoding worker, arg is its ParallelDecodeWorker.
+ */
+void ParallelDecodeWorkerMain(void* arg)
+{
+    ParallelDecodeWorker* worker = (ParallelDecodeWorker*)arg;
+    LogicalDecodingContext* ctx = NULL;
+    sigjmp_buf local_sigjmp_buf;
+
+    /* we are a postmaster subprocess now */
+    IsUnderPostmaster = true;
+    t_thrd.role = PARALLEL_DECODE;
+
+    /* reset t_thrd.proc_cxt.MyProcPid */
+    t_thrd.proc_cxt.MyProcPid = gs_thread_self();
+
+    /* record Start Time for logging */
+    t_thrd.proc_cxt.MyStartTime = time(NULL);
+
+    t_thrd.proc_cxt.MyProgName = "ParallelDecoder";
+
+    /* Identify myself via ps */
+    init_ps_display("parallel decoding worker process", "", "", "");
+
+    SetProcessingMode(InitProcessing);
+
+    /*
+     * SIGTERM means abort and exit cleanly, the walsender asks us to exit by
+     * setting shutdown.
+     */
+    (void)gspqsignal(SIGINT, StatementCancelHandler);
+    (void)gspqsignal(SIGTERM, die);
+    (void)gspqsignal(SIGQUIT, quickdie);
+    (void)gspqsignal(SIGALRM, handle_sig_alarm);
+
+    (void)gspqsignal(SIGPIPE, SIG_IGN);
+    (void)gspqsignal(SIGUSR1, procsignal_sigusr1_handler);
+    (void)gspqsignal(SIGUSR2, SIG_IGN);
+    (void)gspqsignal(SIGFPE, FloatExceptionHandler);
+    (void)gspqsignal(SIGCHLD, SIG_DFL);
+    (void)gspqsignal(SIGHUP, SIG_IGN);
+
+    /* Early initialization */
+    BaseInit();
+
+#ifndef EXEC_BACKEND
+    InitProcess();
+#endif
+
+    /* tell the walsender when we are gone, whatever the reason */
+    on_shmem_exit(ParallelDecodeWorkerExit, PointerGetDatum(worker));
+
+    /*
+     * If an exception is encountered, processing resumes here.  The
+     * walsender notices we are gone and reports the failure.
+     */
+    int curTryCounter;
+    int* oldTryCounter = NULL;
+    if (sigsetjmp(local_sigjmp_buf, 1) != 0) {
+        gstrace_tryblock_exit(true, oldTryCounter);
+        /* Prevents interrupts while cleaning up */
+        HOLD_INTERRUPTS();
+
+        /* Report the error to the server log */
+        EmitErrorReport();
+
+        proc_exit(1);
+    }
+    oldTryCounter = gstrace_tryblock_entry(&curTryCounter);
+
+    /* We can now handle ereport(ERROR) */
+    t_thrd.log_cxt.PG_exception_stack = &local_sigjmp_buf;
+
+    gs_signal_setmask(&t_thrd.libpq_cxt.UnBlockSig, NULL);
+    (void)gs_signal_unblock_sigusr2();
+
+    t_thrd.proc_cxt.PostInit->SetDatabaseAndUser(NULL, worker->dbid, NULL);
+    t_thrd.proc_cxt.PostInit->InitParallelDecodeWorker();
+
+    SetProcessingMode(NormalProcessing);
+
+    t_thrd.utils_cxt.CurrentResourceOwner = ResourceOwnerCreate(NULL, "parallel decoding worker");
+
+    ctx = CreateParallelDecodingContext(
+        worker->slot, worker->options, ParallelDecodePrepareWrite, ParallelDecodeWrite);
+    ctx->output_writer_private = worker;
+    worker->invalidation_epoch = 0;
+
+    worker->proc = t_thrd.proc;
+    pg_write_barrier();
+    worker->state = DECODE_WORKER_READY;
+    SetLatch(worker->sender_latch);
+
+    for (;;) {
+        uint32 head;
+        int rc;
+
+        ResetLatch(&t_thrd.proc->procLatch);
+
+        CHECK_FOR_INTERRUPTS();
+
+        if (worker->shutdown)
+            break;
+
+        head = pg_atomic_read_u32(&worker->head);
+        if (head == pg_atomic_read_u32(&worker->tail)) {
+            rc = WaitLatch(&t_thrd.proc->procLatch,
+                WL_LATCH_SET | WL_TIMEOUT | WL_POSTMASTER_DEATH,
+                (long)PARALLEL_DECODE_WAIT_INTERVAL);
+
+            /*
+             * Emergency bailout if postmaster has died.  This is to avoid the
+             * necessity for manual cleanup of all postmaster children.
+             */
+            if (((unsigned int)rc) & WL_POSTMASTER_DEATH)
+                gs_thread_exit(1);
+            continue;
+        }
+        pg_read_barrier();
+
+        ParallelDecodeProcessTask(ctx, worker, worker->queue[head % PARALLEL_DECODE_QUEUE_SIZE]);
+        pg_atomic_write_u32(&worker->head, head + 1);
+        worker->stats->queue_depth = ParallelDecodeQueueDepth(worker);
+
+        SetLatch(worker->sender_latch);
+    }
+
+    FreeDecodingContext(ctx);
+
+    proc_exit(0);
+}
+
+static void ParallelDecodeProcessTask(LogicalDecodingContext* ctx, ParallelDecodeWorker* worker,
+    ParallelDecodeTask* task)
+{
+    /* the catalog has changed since our caches were built */
+    if (task->invalidation_epoch != worker->invalidation_epoch) {
+        InvalidateSystemCaches();
+        worker->invalidation_epoch = task->invalidation_epoch;
+    }
+
+    worker->current = task;
+    ReorderBufferCommitSerializedTXN(ctx->reorder,
+        task->xid,
+        task->first_lsn,
+        task->commit_lsn,
+        task->end_lsn,
+        task->origin_id,
+        task->csn,
+        task->commit_time,
+        task->changes.data,
+        task->changes.len);
+    worker->current = NULL;
+
+    worker->stats->processed++;
+    worker->stats->processed_bytes += task->changes.len;
+    worker->stats->lsn = task->commit_lsn;
+    pfree_ext(task->changes.data);
+
+    /* the output must be visible before done */
+    pg_write_barrier();
+    task->done = true;
+}
+
+/* prepare_write callback of a decoding worker, the header is added on write */
+static void ParallelDecodePrepareWrite(LogicalDecodingContext* ctx, XLogRecPtr lsn, TransactionId xid,
+    bool last_write)
+{
+    resetStringInfo(ctx->out);
+}
+
+/* write callback of a decoding worker, keep the message for the walsender */
+static void ParallelDecodeWrite(LogicalDecodingContext* ctx, XLogRecPtr lsn, TransactionId xid, bool last_write)
+{
+    ParallelDecodeWorker* worker = (ParallelDecodeWorker*)ctx->output_writer_private;
+    ParallelDecodeTask* task = worker->current;
+    ParallelDecodeMsgHeader hdr;
+
+    Assert(task != NULL);
+
+    hdr.lsn = lsn;
+    hdr.xid = xid;
+    hdr.last_write = last_write;
+    hdr.len = ctx->out->len;
+
+    appendBinaryStringInfo(&task->output, (const char*)&hdr, sizeof(hdr));
+    appendBinaryStringInfo(&task->output, ctx->out->data, ctx->out->len);
+}
+
+static void ParallelDecodeStatValues(Datum* values, bool* nulls, ThreadId pid, const char* slot_name,
+    const char* stage, int worker_id, volatile ParallelDecodeStageStats* stage_stats, XLogRecPtr current)
+{
+    char location[MAXFNAMELEN];
+    XLogRecPtr lsn = stage_stats->lsn;
+    int j = 0;
+    errno_t rc;
+
+    rc = memset_s(nulls, sizeof(bool) * 9, 0, sizeof(bool) * 9);
+    securec_check(rc, "", "");
+
+    values[j++] = Int64GetDatum(pid);
+    values[j++] = CStringGetTextDatum(slot_name);
+    values[j++] = CStringGetTextDatum(stage);
+    if (worker_id >= 0) {
+        values[j++] = Int32GetDatum(worker_id);
+    } else {
+        nulls[j++] = true;
+    }
+    values[j++] = Int64GetDatum((int64)stage_stats->queue_depth);
+    values[j++] = Int64GetDatum((int64)stage_stats->processed);
+    values[j++] = Int64GetDatum((int64)stage_stats->processed_bytes);
+    if (XLogRecPtrIsInvalid(lsn)) {
+        nulls[j++] = true;
+        nulls[j++] = true;
+    } else {
+        rc = snprintf_s(location, sizeof(location), sizeof(location) - 1, "%X/%X", (uint32)(lsn >> 32), (uint32)lsn);
+        securec_check_ss(rc, "\0", "\0");
+        values[j++] = CStringGetTextDatum(location);
+        values[j++] = Int64GetDatum((current > lsn) ? (int64)(current - lsn) : 0);
+    }
+}
+
+/*
+ * Returns the progress of each stage of the logical walsenders: the WAL
+ * reader, the decoders and the committer sending the output.
+ */
+Datum pg_stat_get_parallel_decode(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_PARALLEL_DECODE_COLS 9
+    TupleDesc tupdesc;
+    Tuplestorestate* tupstore = NULL;
+    XLogRecPtr current;
+    int i;
+
+    if (t_thrd.proc->workingVersionNum < PARALLEL_DECODE_VERSION_NUM)
+        ereport(ERROR,
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                errmsg("pg_stat_get_parallel_decode is not supported in current version!")));
+
+    tupstore = BuildTupleResult(fcinfo, &tupdesc);
+
+    current = RecoveryInProgress() ? GetXLogReplayRecPtr(NULL) : GetFlushRecPtr();
+
+    for (i = 0; i < g_instance.attr.attr_storage.max_wal_senders; i++) {
+        /* use volatile pointer to prevent code rearrangement */
+        volatile WalSnd* walsnd = &t_thrd.walsender_cxt.WalSndCtl->walsnds[i];
+        volatile ParallelDecodeStats* stats = &walsnd->decode_stats;
+        Datum values[PG_STAT_GET_PARALLEL_DECODE_COLS];
+        bool nulls[PG_STAT_GET_PARALLEL_DECODE_COLS];
+        char slot_name[NAMEDATALEN];
+        ThreadId pid = walsnd->pid;
+        int nworkers;
+        int j;
+        errno_t rc;
+
+        if (pid == 0 || !stats->active)
+            continue;
+
+        rc = strncpy_s(slot_name, NAMEDATALEN, (const char*)NameStr(stats->slot_name), NAMEDATALEN - 1);
+        securec_check(rc, "", "");
+        nworkers = Min(stats->nworkers, MAX_PARALLEL_DECODE_WORKERS);
+
+        ParallelDecodeStatValues(values, nulls, pid, slot_name, "reader", -1, &stats->reader, current);
+        tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+
+        for (j = 0; j < nworkers; j++) {
+            ParallelDecodeStatValues(values, nulls, pid, slot_name, "decoder", j, &stats->decoders[j], current);
+            tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+        }
+
+        ParallelDecodeStatValues(values, nulls, pid, slot_name, "committer", -1, &stats->committer, current);
+        tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+    }
+
+    /* clean up and return the tuplestore */
+    tuplestore_donestoring(tupstore);
+
+    return (Datum)0;
+}
@@ -37,6 +37,13 @@
  *	contents of individual (sub-)transactions will be read from disk in
  *	chunks.
  *
+ *	The memory used by the changes kept in memory is accounted per
+ *	(sub)transaction and for the whole buffer. Once it exceeds
+ *	logical_decoding_work_mem, the largest transaction is evicted: when the
+ *	output plugin supports streaming and the transaction can be decoded
+ *	before its commit, its changes are sent downstream as a streamed block
+ *	(c.f. ReorderBufferStreamTXN()), otherwise they are spilled to disk.
+ *
  *	This module also has to deal with reassembling toast records from the
  *	individual chunks stored in WAL. When a new (or initial) version of a
  *	tuple is stored in WAL it will always be preceded by the toast chunks
@@ -135,15 +142,6 @@ typedef struct ReorderBufferDiskChange {
     /* data follows */
 } ReorderBufferDiskChange;
 
-/*
- * We use a very simple form of a slab allocator for frequently allocated
- * objects, simply keeping a fixed number in a linked list when unused,
- * instead pfree()ing them. Without that in many workloads aset.c becomes a
- * major bottleneck, especially when spilling to disk while decoding batch
- * workloads.
- */
-static const Size g_max_cached_transactions = 512;
-
 /* ---------------------------------------
  * primary reorderbuffer support routines
  * ---------------------------------------
@@ -174,9 +172,10 @@ static void ReorderBufferExecuteInvalidations(ReorderBuffer* rb, ReorderBufferTX
  * Disk serialization support functions
  * ---------------------------------------
  */
-static void ReorderBufferCheckSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static void ReorderBufferCheckMemoryLimit(ReorderBuffer* rb);
 static void ReorderBufferSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
 static void ReorderBufferSerializeChange(ReorderBuffer* rb, ReorderBufferTXN* txn, int fd, ReorderBufferChange* change);
+static void ReorderBufferFlattenChange(ReorderBuffer* rb, ReorderBufferChange* change);
 static Size ReorderBufferRestoreChanges(ReorderBuffer* rb, ReorderBufferTXN* txn, int* fd, XLogSegNo* segno);
 static void ReorderBufferRestoreChange(ReorderBuffer* rb, ReorderBufferTXN* txn, char* change);
 static void ReorderBufferRestoreCleanup(ReorderBuffer* rb, ReorderBufferTXN* txn);
@@ -184,6 +183,24 @@ static void ReorderBufferRestoreCleanup(ReorderBuffer* rb, ReorderBufferTXN* txn
 static void ReorderBufferFreeSnap(ReorderBuffer* rb, Snapshot snap);
 static Snapshot ReorderBufferCopySnap(ReorderBuffer* rb, Snapshot orig_snap, ReorderBufferTXN* txn, CommandId cid);
 
+/* ---------------------------------------
+ * memory accounting and streaming of in-progress transactions
+ * ---------------------------------------
+ */
+static Size ReorderBufferChangeSize(ReorderBufferChange* change);
+static void ReorderBufferChangeMemoryUpdate(ReorderBuffer* rb, ReorderBufferChange* change, bool addition);
+static void ReorderBufferProcessTXN(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn, bool streaming);
+static void ReorderBufferTruncateTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static bool ReorderBufferCanStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static void ReorderBufferStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
+
+/* ---------------------------------------
+ * parallel decoding support
+ * ---------------------------------------
+ */
+static bool ReorderBufferCanDispatchTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static void ReorderBufferDrainDispatched(ReorderBuffer* rb);
+
 /* ---------------------------------------
  * toast reassembly support
  * ---------------------------------------
@@ -218,6 +235,10 @@ ReorderBuffer* ReorderBufferAllocate(void)
 
     buffer->context = new_ctx;
 
+    buffer->change_context = SlabContextCreate(new_ctx, "Change", SLAB_DEFAULT_BLOCK_SIZE, sizeof(ReorderBufferChange));
+    buffer->txn_context = SlabContextCreate(new_ctx, "TXN", SLAB_DEFAULT_BLOCK_SIZE, sizeof(ReorderBufferTXN));
+    buffer->tup_context = GenerationContextCreate(new_ctx, "Tuples", SLAB_LARGE_BLOCK_SIZE, SLAB_LARGE_BLOCK_SIZE);
+
     hash_ctl.keysize = sizeof(TransactionId);
     hash_ctl.entrysize = sizeof(ReorderBufferTXNByIdEnt);
     hash_ctl.hash = tag_hash;
@@ -228,20 +249,24 @@ ReorderBuffer* ReorderBufferAllocate(void)
     buffer->by_txn_last_xid = InvalidTransactionId;
     buffer->by_txn_last_txn = NULL;
 
-    buffer->nr_cached_transactions = 0;
-    buffer->nr_cached_changes = 0;
-    buffer->nr_cached_tuplebufs = 0;
-
     buffer->outbuf = NULL;
     buffer->outbufsize = 0;
+    buffer->size = 0;
+
+    buffer->stream_start = NULL;
+    buffer->stream_stop = NULL;
+    buffer->stream_change = NULL;
+    buffer->stream_abort = NULL;
+    buffer->stream_commit = NULL;
+
+    buffer->dispatch = NULL;
+    buffer->drain = NULL;
+    buffer->invalidation_epoch = 0;
 
     buffer->current_restart_decoding_lsn = InvalidXLogRecPtr;
 
     dlist_init(&buffer->toplevel_by_lsn);
     dlist_init(&buffer->txns_by_base_snapshot_lsn);
-    dlist_init(&buffer->cached_transactions);
-    dlist_init(&buffer->cached_changes);
-    slist_init(&buffer->cached_tuplebufs);
 
     return buffer;
 }
@@ -261,19 +286,14 @@ void ReorderBufferFree(ReorderBuffer* rb)
 }
 
 /*
- * Get a unused, possibly preallocated, ReorderBufferTXN.
+ * Get an unused ReorderBufferTXN.
  */
 static ReorderBufferTXN* ReorderBufferGetTXN(ReorderBuffer* rb)
 {
     ReorderBufferTXN* txn = NULL;
     int rc = 0;
-    /* check the slab cache */
-    if (rb->nr_cached_transactions > 0) {
-        rb->nr_cached_transactions--;
-        txn = (ReorderBufferTXN*)dlist_container(ReorderBufferTXN, node, dlist_pop_head_node(&rb->cached_transactions));
-    } else {
-        txn = (ReorderBufferTXN*)MemoryContextAlloc(rb->context, sizeof(ReorderBufferTXN));
-    }
+
+    txn = (ReorderBufferTXN*)MemoryContextAlloc(rb->txn_context, sizeof(ReorderBufferTXN));
 
     rc = memset_s(txn, sizeof(ReorderBufferTXN), 0, sizeof(ReorderBufferTXN));
     securec_check(rc, "", "");
@@ -287,9 +307,6 @@ static ReorderBufferTXN* ReorderBufferGetTXN(ReorderBuffer* rb)
 
 /*
  * Free a ReorderBufferTXN.
- *
- * Deallocation might be delayed for efficiency purposes, for details check
- * the comments above max_cached_changes's definition.
  */
 void ReorderBufferReturnTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
 {
@@ -310,31 +327,19 @@ void ReorderBufferReturnTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
         txn->invalidations = NULL;
     }
 
-    /* check whether to put into the slab cache */
-    if (rb->nr_cached_transactions < g_max_cached_transactions) {
-        rb->nr_cached_transactions++;
-        dlist_push_head(&rb->cached_transactions, &txn->node);
-    } else {
-        pfree(txn);
-        txn = NULL;
-    }
+    pfree(txn);
+    txn = NULL;
 }
 
 /*
- * Get a unused, possibly preallocated, ReorderBufferChange.
+ * Get an unused ReorderBufferChange.
  */
 ReorderBufferChange* ReorderBufferGetChange(ReorderBuffer* rb)
 {
     ReorderBufferChange* change = NULL;
     int rc = 0;
-    /* check the slab cache */
-    if (rb->nr_cached_changes) {
-        rb->nr_cached_changes--;
-        change =
-            (ReorderBufferChange*)dlist_container(ReorderBufferChange, node, dlist_pop_head_node(&rb->cached_changes));
-    } else {
-        change = (ReorderBufferChange*)MemoryContextAlloc(rb->context, sizeof(ReorderBufferChange));
-    }
+
+    change = (ReorderBufferChange*)MemoryContextAlloc(rb->change_context, sizeof(ReorderBufferChange));
 
     rc = memset_s(change, sizeof(ReorderBufferChange), 0, sizeof(ReorderBufferChange));
     securec_check(rc, "", "");
@@ -344,12 +349,13 @@ ReorderBufferChange* ReorderBufferGetChange(ReorderBuffer* rb)
 
 /*
  * Free an ReorderBufferChange.
- *
- * Deallocation might be delayed for efficiency purposes, for details check
- * the comments above max_cached_changes's definition.
  */
 void ReorderBufferReturnChange(ReorderBuffer* rb, ReorderBufferChange* change)
 {
+    /* changes queued into a transaction are accounted, release them first */
+    if (change->txn != NULL)
+        ReorderBufferChangeMemoryUpdate(rb, change, false);
+
     /* free contained data */
     switch (change->action) {
         case REORDER_BUFFER_CHANGE_INSERT:
@@ -382,63 +388,28 @@ void ReorderBufferReturnChange(ReorderBuffer* rb, ReorderBufferChange* change)
 }
 
 /*
- * Get an unused, possibly preallocated, ReorderBufferTupleBuf fitting at
- * least a tuple of size tuple_len (excluding header overhead).
+ * Get an unused ReorderBufferTupleBuf fitting at least a tuple of size
+ * tuple_len (excluding header overhead).
  */
 ReorderBufferTupleBuf* ReorderBufferGetTupleBuf(ReorderBuffer* rb, Size tuple_len)
 {
     ReorderBufferTupleBuf* tuple = NULL;
     Size alloc_len = tuple_len + SizeofHeapTupleHeader;
-    /*
-     * Most tuples are below MaxHeapTupleSize, so we use a slab allocator for
-     * those. Thus always allocate at least MaxHeapTupleSize. Note that tuples
-     * tuples generated for oldtuples can be bigger, as they don't have
-     * out-of-line toast columns.
-     */
-    if (alloc_len < MaxHeapTupleSize)
-        alloc_len = MaxHeapTupleSize;
-
-    /* if small enough, check the slab cache */
-    if (alloc_len <= MaxHeapTupleSize && rb->nr_cached_tuplebufs) {
-        rb->nr_cached_tuplebufs--;
-        tuple = slist_container(ReorderBufferTupleBuf, node, slist_pop_head_node(&rb->cached_tuplebufs));
-#ifdef USE_ASSERT_CHECKING
-        int rc = memset_s(&tuple->tuple, sizeof(HeapTupleData), 0xa9, sizeof(HeapTupleData));
-        securec_check(rc, "", "");
-
-#endif
-        tuple->tuple.t_data = ReorderBufferTupleBufData(tuple);
-#ifdef USE_ASSERT_CHECKING
-        int ret = memset_s(tuple->tuple.t_data, tuple->alloc_tuple_size, 0xa8, tuple->alloc_tuple_size);
-        securec_check(ret, "", "");
 
-#endif
-    } else {
-        tuple = (ReorderBufferTupleBuf*)MemoryContextAlloc(rb->context, sizeof(ReorderBufferTupleBuf) + alloc_len);
-        tuple->alloc_tuple_size = alloc_len;
-        tuple->tuple.t_data = ReorderBufferTupleBufData(tuple);
-    }
+    tuple = (ReorderBufferTupleBuf*)MemoryContextAlloc(rb->tup_context, sizeof(ReorderBufferTupleBuf) + alloc_len);
+    tuple->alloc_tuple_size = alloc_len;
+    tuple->tuple.t_data = ReorderBufferTupleBufData(tuple);
 
     return tuple;
 }
 
 /*
  * Free an ReorderBufferTupleBuf.
- *
- * Deallocation might be delayed for efficiency purposes, for details check
- * the comments above max_cached_changes's definition.
  */
 void ReorderBufferReturnTupleBuf(ReorderBuffer* rb, ReorderBufferTupleBuf* tuple)
 {
-    /* check whether to put into the slab cache, oversized tuples never are */
-    if (tuple->alloc_tuple_size == MaxHeapTupleSize &&
-        rb->nr_cached_tuplebufs < (unsigned)g_instance.attr.attr_common.max_cached_tuplebufs) {
-        rb->nr_cached_tuplebufs++;
-        slist_push_head(&rb->cached_tuplebufs, &tuple->node);
-    } else {
-        pfree(tuple);
-        tuple = NULL;
-    }
+    pfree(tuple);
+    tuple = NULL;
 }
 
 /*
@@ -529,12 +500,17 @@ void ReorderBufferQueueChange(ReorderBuffer* rb, TransactionId xid, XLogRecPtr l
     txn = ReorderBufferTXNByXid(rb, xid, true, NULL, lsn, true);
 
     change->lsn = lsn;
+    change->txn = txn;
     Assert(!XLByteEQ(InvalidXLogRecPtr, lsn));
     dlist_push_tail(&txn->changes, &change->node);
     txn->nentries++;
     txn->nentries_mem++;
 
-    ReorderBufferCheckSerializeTXN(rb, txn);
+    /* update memory accounting information */
+    ReorderBufferChangeMemoryUpdate(rb, change, true);
+
+    /* check the memory limits and evict something if needed */
+    ReorderBufferCheckMemoryLimit(rb);
 }
 
 /*
@@ -1056,6 +1032,11 @@ static void ReorderBufferCleanupTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
         Assert(change->action == REORDER_BUFFER_CHANGE_INTERNAL_TUPLECID);
         ReorderBufferReturnChange(rb, change);
     }
+
+    /* toast chunks still waiting for their row after the last streamed block */
+    if (txn->toast_hash != NULL)
+        ReorderBufferToastReset(rb, txn);
+
     /*
      * Cleanup the base snapshot, if set.
      */
@@ -1064,6 +1045,12 @@ static void ReorderBufferCleanupTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
         dlist_delete(&txn->base_snapshot_node);
     }
 
+    /* and the snapshot the last streamed block ended with */
+    if (txn->stream_snapshot != NULL) {
+        ReorderBufferFreeSnap(rb, txn->stream_snapshot);
+        txn->stream_snapshot = NULL;
+    }
+
     /*
      * Remove TXN from its containing list.
      *
@@ -1226,22 +1213,16 @@ static void ReorderBufferFreeSnap(ReorderBuffer* rb, Snapshot snap)
 }
 
 /*
- * Perform the replay of a transaction and its non-aborted subtransactions.
+ * Replay the changes of a transaction and its subtransactions to the output
+ * plugin, in lsn order.
  *
- * Subtransactions previously have to be processed by
- * ReorderBufferCommitChild(), even if previously assigned to the toplevel
- * transaction with ReorderBufferAssignChild.
- *
- * We currently can only decode a transaction's contents when its commit
- * record is read because that's the only place where we know about cache
- * invalidations. Thus, once a toplevel commit is read, we iterate over the top
- * and subtransactions (using a k-way merge) and replay the changes in lsn
- * order.
+ * With streaming the transaction is still in progress: its changes are sent
+ * as one streamed block and released afterwards, the transaction itself is
+ * kept around for the changes still to come. Otherwise the transaction has
+ * committed at commit_lsn and is cleaned up once replayed.
  */
-void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit_lsn, XLogRecPtr end_lsn,
-    RepOriginId origin_id, CommitSeqNo csn, TimestampTz commit_time)
+static void ReorderBufferProcessTXN(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn, bool streaming)
 {
-    ReorderBufferTXN* txn = NULL;
     ReorderBufferIterTXNState* volatile iterstate = NULL;
     ReorderBufferChange* change = NULL;
 
@@ -1250,31 +1231,18 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
     volatile bool txn_started = false;
     volatile bool subtxn_started = false;
 
-    txn = ReorderBufferTXNByXid(rb, xid, false, NULL, InvalidXLogRecPtr, false);
-    /* unknown transaction, nothing to replay */
-    if (txn == NULL)
-        return;
-
-    txn->final_lsn = commit_lsn;
-    txn->end_lsn = end_lsn;
-    txn->origin_id = origin_id;
-    txn->csn = csn;
-    txn->commit_time = commit_time;
+    /* everything handed to the parallel decoders goes out first */
+    ReorderBufferDrainDispatched(rb);
 
-    /*
-     * If this transaction has no snapshot, it didn't make any changes to the
-     * database, so there's nothing to decode.  Note that
-     * ReorderBufferCommitChild will have transferred any snapshots from
-     * subtransactions if there were any.
-     */
-    if (txn->base_snapshot == NULL) {
-        Assert(txn->ninvalidations == 0);
-        ReorderBufferCleanupTXN(rb, txn);
-        return;
+    /* continue where the previous streamed block ended, if any */
+    if (txn->stream_snapshot != NULL) {
+        snapshot_now = txn->stream_snapshot;
+        command_id = txn->stream_command_id;
+        txn->stream_snapshot = NULL;
+    } else {
+        snapshot_now = txn->base_snapshot;
     }
 
-    snapshot_now = txn->base_snapshot;
-
     /* build data to be able to lookup the CommandIds of catalog tuples */
     ReorderBufferBuildTupleCidHash(rb, txn);
 
@@ -1303,7 +1271,10 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
             txn_started = true;
         }
 
-        rb->begin(rb, txn);
+        if (streaming)
+            rb->stream_start(rb, txn);
+        else
+            rb->begin(rb, txn);
 
         iterstate = ReorderBufferIterTXNInit(rb, txn);
         while ((change = ReorderBufferIterTXNNext(rb, iterstate))) {
@@ -1363,7 +1334,10 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
                         if (relation->rd_rel->relkind == RELKIND_SEQUENCE) {
                         } else if (!IsToastRelation(relation)) { /* user-triggered change */
                             ReorderBufferToastReplace(rb, txn, relation, change, partitionReltoastrelid);
-                            rb->apply_change(rb, txn, relation, change);
+                            if (streaming)
+                                rb->stream_change(rb, txn, relation, change);
+                            else
+                                rb->apply_change(rb, txn, relation, change);
                             /*
                              * Only clear reassembled toast chunks if we're
                              * sure they're not required anymore. The creator
@@ -1382,6 +1356,15 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
                              * disk.
                              */
                             dlist_delete(&change->node);
+
+                            /*
+                             * The chunk now belongs to the toast hash of the
+                             * toplevel transaction, which may keep it across
+                             * streamed blocks; account it there.
+                             */
+                            ReorderBufferChangeMemoryUpdate(rb, change, false);
+                            change->txn = txn;
+                            ReorderBufferChangeMemoryUpdate(rb, change, true);
                             ReorderBufferToastAppendChunk(rb, txn, relation, change);
                         }
                     }
@@ -1444,8 +1427,11 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
         ReorderBufferIterTXNFinish(rb, iterstate);
         iterstate = NULL;
 
-        /* call commit callback */
-        rb->commit(rb, txn, commit_lsn);
+        /* call commit callback, or close the streamed block */
+        if (streaming)
+            rb->stream_stop(rb, txn);
+        else
+            rb->commit(rb, txn, commit_lsn);
 
         /* this is just a sanity check against bad output plugin behaviour */
         if (GetCurrentTransactionIdIfAny() != InvalidTransactionId)
@@ -1470,11 +1456,27 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
         else if (txn_started)
             AbortCurrentTransaction();
 
-        if (snapshot_now->copied)
-            ReorderBufferFreeSnap(rb, snapshot_now);
+        if (streaming) {
+            /*
+             * Remember where this block ended, the next one continues with
+             * the same snapshot and command id. Snapshots owned by a change
+             * are freed with it below, so keep a copy of those.
+             */
+            if (snapshot_now->copied)
+                txn->stream_snapshot = snapshot_now;
+            else if (snapshot_now != txn->base_snapshot)
+                txn->stream_snapshot = ReorderBufferCopySnap(rb, snapshot_now, txn, command_id);
+            txn->stream_command_id = command_id;
+
+            /* the changes have been sent, release them */
+            ReorderBufferTruncateTXN(rb, txn);
+        } else {
+            if (snapshot_now->copied)
+                ReorderBufferFreeSnap(rb, snapshot_now);
 
-        /* remove potential on-disk data, and deallocate */
-        ReorderBufferCleanupTXN(rb, txn);
+            /* remove potential on-disk data, and deallocate */
+            ReorderBufferCleanupTXN(rb, txn);
+        }
     }
     PG_CATCH();
     {
@@ -1506,6 +1508,364 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
     PG_END_TRY();
 }
 
+/*
+ * Perform the replay of a transaction and its non-aborted subtransactions.
+ *
+ * Subtransactions previously have to be processed by
+ * ReorderBufferCommitChild(), even if previously assigned to the toplevel
+ * transaction with ReorderBufferAssignChild.
+ *
+ * We currently can only decode a transaction's contents when its commit
+ * record is read because that's the only place where we know about cache
+ * invalidations. Thus, once a toplevel commit is read, we iterate over the top
+ * and subtransactions (using a k-way merge) and replay the changes in lsn
+ * order. Transactions without catalog changes may have been streamed before,
+ * then only the remaining changes are sent, followed by the stream commit.
+ */
+void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit_lsn, XLogRecPtr end_lsn,
+    RepOriginId origin_id, CommitSeqNo csn, TimestampTz commit_time)
+{
+    ReorderBufferTXN* txn = NULL;
+
+    txn = ReorderBufferTXNByXid(rb, xid, false, NULL, InvalidXLogRecPtr, false);
+    /* unknown transaction, nothing to replay */
+    if (txn == NULL)
+        return;
+
+    txn->final_lsn = commit_lsn;
+    txn->end_lsn = end_lsn;
+    txn->origin_id = origin_id;
+    txn->csn = csn;
+    txn->commit_time = commit_time;
+
+    /*
+     * If this transaction has no snapshot, it didn't make any changes to the
+     * database, so there's nothing to decode.  Note that
+     * ReorderBufferCommitChild will have transferred any snapshots from
+     * subtransactions if there were any.
+     */
+    if (txn->base_snapshot == NULL) {
+        Assert(txn->ninvalidations == 0);
+        ReorderBufferCleanupTXN(rb, txn);
+        return;
+    }
+
+    if (txn->streamed) {
+        dlist_iter iter;
+        bool has_changes = (txn->nentries > 0 || txn->ninvalidations > 0);
+
+        dlist_foreach(iter, &txn->subtxns)
+        {
+            ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+            if (subtxn->nentries > 0)
+                has_changes = true;
+        }
+
+        /* send what has been decoded since the last streamed block */
+        if (has_changes)
+            ReorderBufferProcessTXN(rb, txn, commit_lsn, true);
+
+        ReorderBufferDrainDispatched(rb);
+        rb->stream_commit(rb, txn, commit_lsn);
+        ReorderBufferCleanupTXN(rb, txn);
+        return;
+    }
+
+    /* no catalog access needed to decode it, a parallel decoder can take it */
+    if (ReorderBufferCanDispatchTXN(rb, txn) && rb->dispatch(rb, txn, commit_lsn)) {
+        ReorderBufferCleanupTXN(rb, txn);
+        return;
+    }
+
+    ReorderBufferProcessTXN(rb, txn, commit_lsn, false);
+}
+
+/*
+ * Memory used by a change, including the tuples and snapshot it carries.
+ */
+static Size ReorderBufferChangeSize(ReorderBufferChange* change)
+{
+    Size sz = sizeof(ReorderBufferChange);
+
+    switch (change->action) {
+        case REORDER_BUFFER_CHANGE_INSERT:
+        case REORDER_BUFFER_CHANGE_UPDATE:
+        case REORDER_BUFFER_CHANGE_DELETE:
+            if (change->data.tp.oldtuple != NULL)
+                sz += sizeof(ReorderBufferTupleBuf) + change->data.tp.oldtuple->alloc_tuple_size;
+            if (change->data.tp.newtuple != NULL)
+                sz += sizeof(ReorderBufferTupleBuf) + change->data.tp.newtuple->alloc_tuple_size;
+            break;
+        case REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT: {
+            Snapshot snap = change->data.snapshot;
+
+            sz += sizeof(SnapshotData) + sizeof(TransactionId) * (snap->xcnt + snap->subxcnt);
+            break;
+        }
+        case REORDER_BUFFER_CHANGE_INTERNAL_COMMAND_ID:
+        case REORDER_BUFFER_CHANGE_INTERNAL_TUPLECID:
+            break;
+    }
+
+    return sz;
+}
+
+/*
+ * Account a change added to or removed from the memory of its transaction.
+ */
+static void ReorderBufferChangeMemoryUpdate(ReorderBuffer* rb, ReorderBufferChange* change, bool addition)
+{
+    ReorderBufferTXN* txn = change->txn;
+    Size sz = ReorderBufferChangeSize(change);
+
+    if (addition) {
+        txn->size += sz;
+        rb->size += sz;
+    } else {
+        Assert(txn->size >= sz && rb->size >= sz);
+        txn->size -= sz;
+        rb->size -= sz;
+    }
+}
+
+/*
+ * Release the changes of a transaction and its subtransactions after they
+ * have been streamed, in memory and on disk. The transactions stay known so
+ * the changes still to come, the commit or the abort find them.
+ */
+static void ReorderBufferTruncateTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    dlist_mutable_iter iter;
+
+    dlist_foreach_modify(iter, &txn->subtxns)
+    {
+        ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+        ReorderBufferTruncateTXN(rb, subtxn);
+    }
+
+    dlist_foreach_modify(iter, &txn->changes)
+    {
+        ReorderBufferChange* change = dlist_container(ReorderBufferChange, node, iter.cur);
+
+        dlist_delete(&change->node);
+        ReorderBufferReturnChange(rb, change);
+    }
+
+    if (txn->serialized) {
+        ReorderBufferRestoreCleanup(rb, txn);
+        txn->serialized = false;
+    }
+
+    txn->nentries = 0;
+    txn->nentries_mem = 0;
+    txn->streamed = true;
+}
+
+/*
+ * Can the changes of this toplevel transaction be sent before its commit?
+ *
+ * The snapshot builder must be consistent and the transaction not be skipped,
+ * as on commit. Transactions changing the catalog are only decoded on commit
+ * since their invalidations are only known then.
+ */
+static bool ReorderBufferCanStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)rb->private_data;
+    dlist_iter iter;
+
+    if (!ctx->streaming || ctx->fast_forward)
+        return false;
+
+    if (SnapBuildCurrentState(ctx->snapshot_builder) != SNAPBUILD_CONSISTENT)
+        return false;
+
+    if (txn->base_snapshot == NULL || txn->has_catalog_changes)
+        return false;
+
+    if (SnapBuildXactNeedsSkip(ctx->snapshot_builder, txn->first_lsn))
+        return false;
+
+    dlist_foreach(iter, &txn->subtxns)
+    {
+        ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+        if (subtxn->has_catalog_changes)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Send the changes of an in-progress toplevel transaction decoded so far to
+ * the output plugin as a streamed block, and release their memory.
+ */
+static void ReorderBufferStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    Assert(!txn->is_known_as_subxact);
+    Assert(txn->base_snapshot != NULL);
+
+    if (!RecoveryInProgress())
+        ereport(DEBUG2, (errmsg("stream %lu bytes of changes in tx %lu", (uint64)txn->size, txn->xid)));
+
+    ReorderBufferProcessTXN(rb, txn, InvalidXLogRecPtr, true);
+}
+
+/*
+ * Can a committed transaction be decoded by a parallel decoder?  A decoder
+ * only gets the base snapshot and the changes, so the transaction must not
+ * have modified the catalog itself.
+ */
+static bool ReorderBufferCanDispatchTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    dlist_iter iter;
+
+    if (rb->dispatch == NULL || txn->streamed || txn->has_catalog_changes || txn->ninvalidations > 0)
+        return false;
+
+    /* the prepared array of a snapshot is not copied along */
+    if (GTM_LITE_MODE)
+        return false;
+
+    dlist_foreach(iter, &txn->subtxns)
+    {
+        ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+        if (subtxn->has_catalog_changes)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Wait for the output of the transactions handed to the parallel decoders,
+ * before output is created here.
+ */
+static void ReorderBufferDrainDispatched(ReorderBuffer* rb)
+{
+    if (rb->drain != NULL)
+        rb->drain(rb);
+}
+
+/*
+ * Append the change in rb->outbuf to buf, MAXALIGN'ed so that the next one
+ * can be read in place.
+ */
+static void ReorderBufferAppendFlattened(ReorderBuffer* rb, StringInfo buf)
+{
+    ReorderBufferDiskChange* ondisk = (ReorderBufferDiskChange*)rb->outbuf;
+    int padding = (int)(MAXALIGN(ondisk->size) - ondisk->size);
+
+    appendBinaryStringInfo(buf, rb->outbuf, (int)ondisk->size);
+    if (padding > 0) {
+        enlargeStringInfo(buf, padding);
+        errno_t rc = memset_s(buf->data + buf->len, padding, 0, padding);
+        securec_check(rc, "", "");
+        buf->len += padding;
+        buf->data[buf->len] = '\0';
+    }
+}
+
+/*
+ * Flatten a committed transaction for a parallel decoder: its base snapshot,
+ * then the changes of the transaction and its subtransactions in lsn order,
+ * all in the on-disk format.
+ */
+void ReorderBufferSerializeCommittedTXN(ReorderBuffer* rb, ReorderBufferTXN* txn, StringInfo buf)
+{
+    ReorderBufferIterTXNState* volatile iterstate = NULL;
+    ReorderBufferChange* change = NULL;
+    ReorderBufferChange snapchange;
+    errno_t rc;
+
+    Assert(txn->base_snapshot != NULL);
+
+    rc = memset_s(&snapchange, sizeof(ReorderBufferChange), 0, sizeof(ReorderBufferChange));
+    securec_check(rc, "", "");
+    snapchange.action = REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT;
+    snapchange.lsn = txn->base_snapshot_lsn;
+    snapchange.data.snapshot = txn->base_snapshot;
+    ReorderBufferFlattenChange(rb, &snapchange);
+    ReorderBufferAppendFlattened(rb, buf);
+
+    PG_TRY();
+    {
+        iterstate = ReorderBufferIterTXNInit(rb, txn);
+        while ((change = ReorderBufferIterTXNNext(rb, iterstate)) != NULL) {
+            ReorderBufferFlattenChange(rb, change);
+            ReorderBufferAppendFlattened(rb, buf);
+        }
+        ReorderBufferIterTXNFinish(rb, iterstate);
+        iterstate = NULL;
+    }
+    PG_CATCH();
+    {
+        if (iterstate != NULL)
+            ReorderBufferIterTXNFinish(rb, iterstate);
+        PG_RE_THROW();
+    }
+    PG_END_TRY();
+}
+
+/*
+ * Decode a transaction flattened by ReorderBufferSerializeCommittedTXN, as if
+ * its commit record had just been read.
+ */
+void ReorderBufferCommitSerializedTXN(ReorderBuffer* rb, TransactionId xid, XLogRecPtr first_lsn, XLogRecPtr commit_lsn,
+    XLogRecPtr end_lsn, RepOriginId origin_id, CommitSeqNo csn, TimestampTz commit_time, const char* data, Size len)
+{
+    ReorderBufferTXN* txn = NULL;
+    ReorderBufferChange* change = NULL;
+    Snapshot snap = NULL;
+    bool is_new = false;
+    Size off = 0;
+
+    txn = ReorderBufferTXNByXid(rb, xid, true, &is_new, first_lsn, true);
+    if (!is_new)
+        ereport(ERROR,
+            (errcode(ERRCODE_LOGICAL_DECODE_ERROR), errmsg("transaction %lu is already being decoded", xid)));
+
+    while (off < len) {
+        ReorderBufferDiskChange* ondisk = (ReorderBufferDiskChange*)(data + off);
+
+        ReorderBufferRestoreChange(rb, txn, (char*)ondisk);
+        off += MAXALIGN(ondisk->size);
+    }
+    txn->nentries = txn->nentries_mem;
+
+    /* the first change carries the base snapshot */
+    if (dlist_is_empty(&txn->changes))
+        ereport(ERROR, (errcode(ERRCODE_LOGICAL_DECODE_ERROR), errmsg("transaction %lu has no base snapshot", xid)));
+    change = dlist_container(ReorderBufferChange, node, dlist_pop_head_node(&txn->changes));
+    if (change->action != REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT)
+        ereport(ERROR, (errcode(ERRCODE_LOGICAL_DECODE_ERROR), errmsg("transaction %lu has no base snapshot", xid)));
+    txn->nentries--;
+    txn->nentries_mem--;
+
+    ReorderBufferChangeMemoryUpdate(rb, change, false);
+    snap = change->data.snapshot;
+    change->txn = NULL;
+    change->data.snapshot = NULL;
+    ReorderBufferReturnChange(rb, change);
+
+    /* owned by the transaction from now on, like a snapshot of the builder */
+    snap->copied = false;
+    snap->active_count = 1;
+    snap->regd_count = 0;
+    ReorderBufferSetBaseSnapshot(rb, xid, first_lsn, snap);
+
+    txn->final_lsn = commit_lsn;
+    txn->end_lsn = end_lsn;
+    txn->origin_id = origin_id;
+    txn->csn = csn;
+    txn->commit_time = commit_time;
+
+    ReorderBufferProcessTXN(rb, txn, commit_lsn, false);
+}
+
 /*
  * Abort a transaction that possibly has previous changes. Needs to be first
  * called for subtransactions and then for the toplevel xid.
@@ -1530,6 +1890,12 @@ void ReorderBufferAbort(ReorderBuffer* rb, TransactionId xid, XLogRecPtr lsn)
     /* cosmetic... */
     txn->final_lsn = lsn;
 
+    /* tell the downstream to throw away what has been streamed */
+    if (txn->streamed) {
+        ReorderBufferDrainDispatched(rb);
+        rb->stream_abort(rb, txn, lsn);
+    }
+
     /* remove potential on-disk data, and deallocate */
     ReorderBufferCleanupTXN(rb, txn);
 }
@@ -1561,6 +1927,12 @@ void ReorderBufferAbortOld(ReorderBuffer* rb, TransactionId oldestRunningXid)
             if (!RecoveryInProgress())
                 ereport(DEBUG2, (errmsg("aborting old transaction %lu", txn->xid)));
 
+            /* the transaction died with the crash, as far as the downstream knows */
+            if (txn->streamed) {
+                ReorderBufferDrainDispatched(rb);
+                rb->stream_abort(rb, txn, InvalidXLogRecPtr);
+            }
+
             /* remove potential on-disk data, and deallocate this tx */
             ReorderBufferCleanupTXN(rb, txn);
         } else
@@ -1616,6 +1988,12 @@ void ReorderBufferForget(ReorderBuffer* rb, TransactionId xid, XLogRecPtr lsn)
     } else
         Assert(txn->ninvalidations == 0);
 
+    /* changes streamed before the commit was read must not be applied */
+    if (txn->streamed) {
+        ReorderBufferDrainDispatched(rb);
+        rb->stream_abort(rb, txn, lsn);
+    }
+
     /* remove potential on-disk data, and deallocate */
     ReorderBufferCleanupTXN(rb, txn);
 }
@@ -1760,6 +2138,9 @@ static void ReorderBufferExecuteInvalidations(ReorderBuffer* rb, ReorderBufferTX
 
     for (i = 0; i < txn->ninvalidations; i++)
         LocalExecuteInvalidationMessage(&txn->invalidations[i]);
+
+    if (txn->ninvalidations > 0)
+        rb->invalidation_epoch++;
 }
 
 /*
@@ -1830,17 +2211,86 @@ static void ReorderBufferSerializeReserve(ReorderBuffer* rb, Size sz)
 }
 
 /*
- * Check whether the transaction tx should spill its data to disk.
+ * Find the largest transaction (toplevel or subxact) to evict by spilling it
+ * to disk.
  */
-static void ReorderBufferCheckSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+static ReorderBufferTXN* ReorderBufferLargestTXN(ReorderBuffer* rb)
 {
-    /*
-     * description: improve accounting so we cheaply can take subtransactions into
-     * account here.
-     */
-    if (txn->nentries_mem >= (unsigned)g_instance.attr.attr_common.max_changes_in_memory) {
+    HASH_SEQ_STATUS hash_seq;
+    ReorderBufferTXNByIdEnt* ent = NULL;
+    ReorderBufferTXN* largest = NULL;
+
+    hash_seq_init(&hash_seq, rb->by_txn);
+    while ((ent = (ReorderBufferTXNByIdEnt*)hash_seq_search(&hash_seq)) != NULL) {
+        ReorderBufferTXN* txn = ent->txn;
+
+        if (largest == NULL || txn->size > largest->size)
+            largest = txn;
+    }
+
+    return largest;
+}
+
+/*
+ * Find the largest toplevel transaction, counting its subtransactions, that
+ * can be streamed to the output plugin.
+ */
+static ReorderBufferTXN* ReorderBufferLargestStreamableTXN(ReorderBuffer* rb)
+{
+    dlist_iter iter;
+    ReorderBufferTXN* largest = NULL;
+    Size largest_size = 0;
+
+    dlist_foreach(iter, &rb->toplevel_by_lsn)
+    {
+        ReorderBufferTXN* txn = dlist_container(ReorderBufferTXN, node, iter.cur);
+        Size size = txn->size;
+        dlist_iter sub_iter;
+
+        dlist_foreach(sub_iter, &txn->subtxns)
+        {
+            ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, sub_iter.cur);
+
+            size += subtxn->size;
+        }
+
+        if (size > largest_size && ReorderBufferCanStreamTXN(rb, txn)) {
+            largest = txn;
+            largest_size = size;
+        }
+    }
+
+    return largest;
+}
+
+/*
+ * Check whether the changes kept in memory exceed logical_decoding_work_mem,
+ * and evict the largest transactions until they don't. A transaction is
+ * streamed to the output plugin if possible, else spilled to disk.
+ */
+static void ReorderBufferCheckMemoryLimit(ReorderBuffer* rb)
+{
+    Size limit = (Size)u_sess->attr.attr_storage.logical_decoding_work_mem * 1024L;
+
+    while (rb->size >= limit) {
+        Size before = rb->size;
+        ReorderBufferTXN* txn = ReorderBufferLargestStreamableTXN(rb);
+
+        if (txn != NULL) {
+            ReorderBufferStreamTXN(rb, txn);
+            if (rb->size < before)
+                continue;
+        }
+
+        txn = ReorderBufferLargestTXN(rb);
+        if (txn == NULL || txn->size == 0)
+            break;
+
         ReorderBufferSerializeTXN(rb, txn);
-        Assert(txn->nentries_mem == 0);
+
+        /* only toast chunks waiting for their row are left, nothing to evict */
+        if (rb->size >= before)
+            break;
     }
 }
 
@@ -1914,6 +2364,14 @@ static void ReorderBufferSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
         }
 
         ReorderBufferSerializeChange(rb, txn, fd, change);
+
+        /*
+         * Keep final_lsn covering every spilled change, the files are found
+         * by it on restore and cleanup even before the commit has been read.
+         */
+        if (XLByteLT(txn->final_lsn, change->lsn))
+            txn->final_lsn = change->lsn;
+
         dlist_delete(&change->node);
         ReorderBufferReturnChange(rb, change);
 
@@ -1934,6 +2392,25 @@ static void ReorderBufferSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
  * Serialize individual change to disk.
  */
 static void ReorderBufferSerializeChange(ReorderBuffer* rb, ReorderBufferTXN* txn, int fd, ReorderBufferChange* change)
+{
+    ReorderBufferDiskChange* ondisk = NULL;
+
+    ReorderBufferFlattenChange(rb, change);
+    ondisk = (ReorderBufferDiskChange*)rb->outbuf;
+
+    if ((Size)(write(fd, rb->outbuf, ondisk->size)) != ondisk->size) {
+        (void)CloseTransientFile(fd);
+        ereport(ERROR, (errcode_for_file_access(), errmsg("could not write to xid %lu's data file: %m", txn->xid)));
+    }
+
+    Assert(ondisk->change.action == change->action);
+}
+
+/*
+ * Convert a change into its on-disk format in rb->outbuf, ondisk->size is
+ * the length of the result.
+ */
+static void ReorderBufferFlattenChange(ReorderBuffer* rb, ReorderBufferChange* change)
 {
     ReorderBufferDiskChange* ondisk = NULL;
     Size sz = sizeof(ReorderBufferDiskChange);
@@ -2039,13 +2516,6 @@ static void ReorderBufferSerializeChange(ReorderBuffer* rb, ReorderBufferTXN* tx
     }
 
     ondisk->size = sz;
-
-    if ((Size)(write(fd, rb->outbuf, ondisk->size)) != ondisk->size) {
-        (void)CloseTransientFile(fd);
-        ereport(ERROR, (errcode_for_file_access(), errmsg("could not write to xid %lu's data file: %m", txn->xid)));
-    }
-
-    Assert(ondisk->change.action == change->action);
 }
 
 /*
@@ -2254,6 +2724,10 @@ static void ReorderBufferRestoreChange(ReorderBuffer* rb, ReorderBufferTXN* txn,
 
     dlist_push_tail(&txn->changes, &change->node);
     txn->nentries_mem++;
+
+    /* the on-disk copy points to the transaction of a previous run, fix it up */
+    change->txn = txn;
+    ReorderBufferChangeMemoryUpdate(rb, change, true);
 }
 
 /*
@@ -2599,6 +3073,21 @@ static void ReorderBufferToastReplace(ReorderBuffer* rb, ReorderBufferTXN* txn,
     Assert(newtup->tuple.t_len <= MaxHeapTupleSize);
     Assert(ReorderBufferTupleBufData(newtup) == newtup->tuple.t_data);
 
+    /* the buffer is only as large as the decoded tuple, which may be too small */
+    if (tmphtup->t_len > newtup->alloc_tuple_size) {
+        ReorderBufferTupleBuf* oldtup = newtup;
+
+        if (change->txn != NULL)
+            ReorderBufferChangeMemoryUpdate(rb, change, false);
+        newtup = ReorderBufferGetTupleBuf(rb, tmphtup->t_len - SizeofHeapTupleHeader);
+        newtup->tuple = oldtup->tuple;
+        newtup->tuple.t_data = ReorderBufferTupleBufData(newtup);
+        ReorderBufferReturnTupleBuf(rb, oldtup);
+        change->data.tp.newtuple = newtup;
+        if (change->txn != NULL)
+            ReorderBufferChangeMemoryUpdate(rb, change, true);
+    }
+
     rc = memcpy_s(newtup->tuple.t_data, newtup->alloc_tuple_size, tmphtup->t_data, tmphtup->t_len);
     securec_check(rc, "", "");
     newtup->tuple.t_len = tmphtup->t_len;
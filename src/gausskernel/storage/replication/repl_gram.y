@@ -94,6 +94,7 @@
 %token K_PHYSICAL
 %token K_LOGICAL
 %token K_SLOT
+%token K_COMPRESSION
 
 %type <node>	command
 %type <node>	base_backup start_replication start_data_replication fetch_mot_checkpoint start_logical_replication identify_system identify_version identify_mode identify_consistence create_replication_slot drop_replication_slot identify_maxlsn identify_channel
@@ -102,7 +103,7 @@
 %type <list>    plugin_options plugin_opt_list
 %type <defelt>  plugin_opt_elem
 %type <node>    plugin_opt_arg
-%type <str>		opt_slot
+%type <str>		opt_slot opt_compression
 %%
 
 firstcmd: command opt_semicolon
@@ -246,10 +247,10 @@ base_backup_opt:
 
 /*
  * START_REPLICATION %X/%X
- * START_REPLICATION [SLOT slot] [PHYSICAL] %X/%X
+ * START_REPLICATION [SLOT slot] [PHYSICAL] %X/%X [COMPRESSION method]
  */
 start_replication:
-			K_START_REPLICATION opt_slot opt_physical RECPTR
+			K_START_REPLICATION opt_slot opt_physical RECPTR opt_compression
 				{
 					StartReplicationCmd *cmd;
 
@@ -257,18 +258,23 @@ start_replication:
 					cmd->kind = REPLICATION_KIND_PHYSICAL;
  					cmd->slotname = $2;
  					cmd->startpoint = $4;
+					cmd->compression = $5;
 
 					$$ = (Node *) cmd;
 				}
 			;
 			
 /*
- * START_REPLICATION DATA
+ * START_REPLICATION DATA [COMPRESSION method]
  */
 start_data_replication:
-			K_START_REPLICATION K_DATA
+			K_START_REPLICATION K_DATA opt_compression
 				{
-					$$ = (Node *) makeNode(StartDataReplicationCmd);
+					StartDataReplicationCmd *cmd;
+
+					cmd = makeNode(StartDataReplicationCmd);
+					cmd->compression = $3;
+					$$ = (Node *) cmd;
 				}
 			;
 
@@ -340,6 +346,14 @@ opt_slot :	K_SLOT IDENT
  					$$ = $2;
  				}
  				| /* nothing */			{ $$ = NULL; }		
+			;
+
+opt_compression :	K_COMPRESSION IDENT
+				{
+					$$ = $2;
+				}
+				| /* nothing */			{ $$ = NULL; }
+			;
 
 plugin_options:
 			'(' plugin_opt_list ')'         { $$ = $2; }
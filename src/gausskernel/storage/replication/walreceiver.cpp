@@ -76,6 +76,7 @@
 #include "postmaster/postmaster.h"
 #include "hotpatch/hotpatch.h"
 #include "utils/distribute_test.h"
+#include "lz4.h"
 
 bool wal_catchup = false;
 
@@ -127,6 +128,7 @@ static void WalRcvDie(int code, Datum arg);
 static void XLogWalRcvProcessMsg(unsigned char type, char* buf, Size len);
 static void XLogWalRcvReceive(char* buf, Size nbytes, XLogRecPtr recptr);
 static void XLogWalRcvReceiveInBuf(char* buf, Size nbytes, XLogRecPtr recptr);
+static char* XLogWalRcvDecompress(const char* buf, Size len, uint32 rawLen);
 static void XLogWalRcvSendHSFeedback(void);
 static void XLogWalRcvSendSwitchRequest(void);
 static void WalDataRcvReceive(char* buf, Size nbytes, XLogRecPtr recptr);
@@ -856,6 +858,31 @@ static void XLogWalRcvProcessMsg(unsigned char type, char* buf, Size len)
             }
             break;
         }
+        case 'z': /* compressed WAL records */
+        {
+            WalCompressedDataMessageHeader zhdr;
+            char* data = NULL;
+
+            if (len < sizeof(WalCompressedDataMessageHeader))
+                ereport(ERROR,
+                    (errcode(ERRCODE_PROTOCOL_VIOLATION),
+                        errmsg_internal("invalid compressed WAL message received from primary")));
+            /* memcpy is required here for alignment reasons */
+            errorno = memcpy_s(&zhdr, sizeof(WalCompressedDataMessageHeader), buf,
+                sizeof(WalCompressedDataMessageHeader));
+            securec_check(errorno, "\0", "\0");
+
+            ProcessWalHeaderMessage(&zhdr.header);
+
+            data = XLogWalRcvDecompress(buf + sizeof(WalCompressedDataMessageHeader),
+                len - sizeof(WalCompressedDataMessageHeader), zhdr.rawLen);
+            if (IsExtremeRedo()) {
+                XLogWalRcvReceiveInBuf(data, zhdr.rawLen, zhdr.header.dataStart);
+            } else {
+                XLogWalRcvReceive(data, zhdr.rawLen, zhdr.header.dataStart);
+            }
+            break;
+        }
         case 'd': /* Data page replication for the logical xlog */
         {
             WalDataPageMessageHeader msghdr;
@@ -1113,6 +1140,31 @@ static void WalDataRcvReceive(char* buf, Size nbytes, XLogRecPtr recptr)
     wakeupWalRcvWriter();
 }
 
+/*
+ * Decompress the WAL data of a compressed WAL message, the result lives in a
+ * buffer of the walreceiver reused by the next message.
+ */
+static char* XLogWalRcvDecompress(const char* buf, Size len, uint32 rawLen)
+{
+    int ret;
+
+    if (rawLen > t_thrd.walreceiver_cxt.decompressBufSize) {
+        if (t_thrd.walreceiver_cxt.decompressBuf != NULL)
+            pfree(t_thrd.walreceiver_cxt.decompressBuf);
+        t_thrd.walreceiver_cxt.decompressBuf = (char*)MemoryContextAlloc(t_thrd.top_mem_cxt, rawLen);
+        t_thrd.walreceiver_cxt.decompressBufSize = rawLen;
+    }
+
+    ret = LZ4_decompress_safe(buf, t_thrd.walreceiver_cxt.decompressBuf, (int)len, (int)rawLen);
+    if (ret < 0 || (uint32)ret != rawLen)
+        ereport(ERROR,
+            (errcode(ERRCODE_PROTOCOL_VIOLATION),
+                errmsg_internal("could not decompress WAL message received from primary: "
+                                "got %d bytes, expected %u", ret, rawLen)));
+
+    return t_thrd.walreceiver_cxt.decompressBuf;
+}
+
 /*
  * Receive XLOG data into receiver buffer.
  */
@@ -64,6 +64,7 @@
 #include "miscadmin.h"
 #include "nodes/replnodes.h"
 #include "pgstat.h"
+#include "portability/instr_time.h"
 #include "replication/basebackup.h"
 #include "replication/catchup.h"
 #include "replication/decode.h"
@@ -97,6 +98,7 @@
 #include "postmaster/postmaster.h"
 #include "alarm/alarm.h"
 #include "utils/distribute_test.h"
+#include "lz4.h"
 
 #define CRC_LEN 11
 
@@ -149,6 +151,7 @@ static void InitWalSnd(void);
 static void WalSndHandshake(void);
 static void WalSndKill(int code, Datum arg);
 static void XLogSendPhysical(void);
+static void XLogSendCompressed(const WalDataMessageHeader* msghdr, Size nbytes);
 static void XLogSendLogical(void);
 static void IdentifySystem(void);
 static void IdentifyVersion(void);
@@ -989,6 +992,23 @@ static void StartReplication(StartReplicationCmd* cmd)
                     (errmsg("cannot use a logical replication slot for physical replication"))));
     }
 
+    /* The standby asks for a compressed WAL stream, see XLogSendCompressed */
+    if (cmd->compression != NULL) {
+        volatile WalSnd* walsnd = t_thrd.walsender_cxt.MyWalSnd;
+
+        if (strcmp(cmd->compression, REPL_COMPRESSION_LZ4) != 0)
+            ereport(ERROR,
+                (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                    errmsg("unsupported replication compression method \"%s\"", cmd->compression)));
+
+        SpinLockAcquire(&walsnd->mutex);
+        walsnd->compression = true;
+        walsnd->raw_bytes = 0;
+        walsnd->compressed_bytes = 0;
+        walsnd->compress_time = 0;
+        SpinLockRelease(&walsnd->mutex);
+    }
+
     /*
      * When we first start replication the standby will be behind the primary.
      * For some applications, for example, synchronous replication, it is
@@ -1309,6 +1329,25 @@ static void StartLogicalReplication(StartReplicationCmd* cmd)
     t_thrd.walsender_cxt.logical_decoding_ctx = CreateDecodingContext(
         cmd->startpoint, cmd->options, false, logical_read_xlog_page, WalSndPrepareWrite, WalSndWriteData);
 
+    /* report decoding progress, and hand transactions to the decoding workers if any */
+    {
+        WalSnd* walsnd = t_thrd.walsender_cxt.MyWalSnd;
+        errno_t rc = memset_s(&walsnd->decode_stats, sizeof(ParallelDecodeStats), 0, sizeof(ParallelDecodeStats));
+        securec_check(rc, "\0", "\0");
+        rc = strncpy_s(NameStr(walsnd->decode_stats.slot_name), NAMEDATALEN,
+            NameStr(t_thrd.slot_cxt.MyReplicationSlot->data.name), NAMEDATALEN - 1);
+        securec_check(rc, "\0", "\0");
+        walsnd->decode_stats.active = true;
+
+        /* decode serially while the upgrade to this version can still be rolled back */
+        if (u_sess->attr.attr_storage.logical_decoding_parallel_workers > 0 &&
+            t_thrd.proc->workingVersionNum >= PARALLEL_DECODE_VERSION_NUM)
+            ParallelDecodeStart(t_thrd.walsender_cxt.logical_decoding_ctx,
+                u_sess->attr.attr_storage.logical_decoding_parallel_workers,
+                &walsnd->latch,
+                &walsnd->decode_stats);
+    }
+
     /* Start reading WAL from the oldest required WAL. */
     t_thrd.walsender_cxt.logical_startptr = t_thrd.slot_cxt.MyReplicationSlot->data.restart_lsn;
 
@@ -1335,7 +1374,10 @@ static void StartLogicalReplication(StartReplicationCmd* cmd)
     /* Main loop of walsender */
     WalSndLoop(XLogSendLogical);
 
+    ParallelDecodeStop(t_thrd.walsender_cxt.logical_decoding_ctx);
+    t_thrd.walsender_cxt.MyWalSnd->decode_stats.active = false;
     FreeDecodingContext(t_thrd.walsender_cxt.logical_decoding_ctx);
+    t_thrd.walsender_cxt.logical_decoding_ctx = NULL;
     ReplicationSlotRelease();
 
     replication_active = false;
@@ -1387,6 +1429,15 @@ static void WalSndWriteData(LogicalDecodingContext* ctx, XLogRecPtr lsn, Transac
     /* output previously gathered data in a CopyData packet */
     pq_putmessage_noblock('d', ctx->out->data, ctx->out->len);
 
+    {
+        volatile ParallelDecodeStageStats* committer = &t_thrd.walsender_cxt.MyWalSnd->decode_stats.committer;
+
+        committer->processed++;
+        committer->processed_bytes += ctx->out->len;
+        if (last_write)
+            committer->lsn = lsn;
+    }
+
     /*
      * Fill the send timestamp last, so that it is taken as late as
      * possible. This is somewhat ugly, but the protocol's set as it's already
@@ -1505,6 +1556,9 @@ static XLogRecPtr WalSndWaitForWal(XLogRecPtr loc)
         /* Clear any already-pending wakeups */
         ResetLatch(&t_thrd.walsender_cxt.MyWalSnd->latch);
 
+        /* send the transactions the decoding workers are done with */
+        ParallelDecodeEmit(t_thrd.walsender_cxt.logical_decoding_ctx, false);
+
         /* Update our idea of the currently flushed position. */
         if (!RecoveryInProgress())
             RecentFlushPtr = GetFlushRecPtr();
@@ -1520,8 +1574,10 @@ static XLogRecPtr WalSndWaitForWal(XLogRecPtr loc)
          * RecentFlushPtr, so we can send all remaining data before shutting
          * down.
          */
-        if (t_thrd.walsender_cxt.walsender_ready_to_stop)
+        if (t_thrd.walsender_cxt.walsender_ready_to_stop) {
+            ParallelDecodeEmit(t_thrd.walsender_cxt.logical_decoding_ctx, true);
             break;
+        }
 
         /*
          * We only send regular messages to the client for full decoded
@@ -2515,6 +2571,10 @@ static void WSDataSendInit()
         t_thrd.walsender_cxt.wsXLogJustSendRegion->end_ptr = InvalidXLogRecPtr;
     }
 
+    if (t_thrd.walsender_cxt.MyWalSnd->compression)
+        t_thrd.walsender_cxt.compress_xlog_message = (char*)palloc(
+            1 + sizeof(WalCompressedDataMessageHeader) + LZ4_COMPRESSBOUND((int)WS_MAX_SEND_SIZE));
+
     return;
 }
 
@@ -3163,6 +3223,12 @@ static void WalSndReset(WalSnd *walsnd)
     walsnd->wal_sender_channel.remoteport = 0;
     walsnd->wal_sender_channel.remoteservice = 0;
     walsnd->channel_get_replc = 0;
+    walsnd->compression = false;
+    walsnd->raw_bytes = 0;
+    walsnd->compressed_bytes = 0;
+    walsnd->compress_time = 0;
+    rc = memset_s(&walsnd->decode_stats, sizeof(ParallelDecodeStats), 0, sizeof(ParallelDecodeStats));
+    securec_check_c(rc, "\0", "\0");
     rc = memset_s(walsnd->wal_sender_channel.localhost, sizeof(walsnd->wal_sender_channel.localhost), 0,
         sizeof(walsnd->wal_sender_channel.localhost));
     securec_check_c(rc, "\0", "\0");
@@ -3420,10 +3486,25 @@ static void XLogSendLogical(void)
                     errm)));
 
     if (record != NULL) {
-        LogicalDecodingProcessRecord(
-            t_thrd.walsender_cxt.logical_decoding_ctx, t_thrd.walsender_cxt.logical_decoding_ctx->reader);
+        LogicalDecodingContext* ctx = t_thrd.walsender_cxt.logical_decoding_ctx;
+        volatile ParallelDecodeStageStats* reader = &t_thrd.walsender_cxt.MyWalSnd->decode_stats.reader;
+        XLogRecPtr pending;
+
+        LogicalDecodingProcessRecord(ctx, ctx->reader);
+
+        reader->processed++;
+        reader->processed_bytes += ctx->reader->EndRecPtr - ctx->reader->ReadRecPtr;
+        reader->lsn = ctx->reader->EndRecPtr;
+        reader->queue_depth = (uint32)hash_get_num_entries(ctx->reorder->by_txn);
 
-        t_thrd.walsender_cxt.sentPtr = t_thrd.walsender_cxt.logical_decoding_ctx->reader->EndRecPtr;
+        /* send what the decoding workers have done meanwhile */
+        ParallelDecodeEmit(ctx, false);
+
+        /* nothing after a transaction still being decoded has been sent */
+        t_thrd.walsender_cxt.sentPtr = ctx->reader->EndRecPtr;
+        pending = ParallelDecodeOldestPendingLSN(ctx);
+        if (!XLogRecPtrIsInvalid(pending) && XLByteLT(pending, t_thrd.walsender_cxt.sentPtr))
+            t_thrd.walsender_cxt.sentPtr = pending;
     } else {
         /*
          * If the record we just wanted read is at or beyond the flushed point,
@@ -3451,6 +3532,50 @@ static void XLogSendLogical(void)
  * If there is no unsent WAL remaining, *caughtup is set to true, otherwise
  * *caughtup is set to false.
  */
+/*
+ * Send the WAL data prepared in output_xlog_message as a compressed WAL data
+ * message ('z').  The data is sent as a plain 'w' message when it does not
+ * shrink, so the standby only pays the decompression when it is worth it.
+ */
+static void XLogSendCompressed(const WalDataMessageHeader* msghdr, Size nbytes)
+{
+    volatile WalSnd* walsnd = t_thrd.walsender_cxt.MyWalSnd;
+    char* msg = t_thrd.walsender_cxt.compress_xlog_message;
+    WalCompressedDataMessageHeader zhdr;
+    instr_time start_time;
+    instr_time duration;
+    int zlen = 0;
+    errno_t errorno = EOK;
+
+    INSTR_TIME_SET_CURRENT(start_time);
+    if (nbytes > 0)
+        zlen = LZ4_compress_default(t_thrd.walsender_cxt.output_xlog_message + 1 + sizeof(WalDataMessageHeader),
+            msg + 1 + sizeof(WalCompressedDataMessageHeader),
+            (int)nbytes,
+            LZ4_COMPRESSBOUND((int)WS_MAX_SEND_SIZE));
+    INSTR_TIME_SET_CURRENT(duration);
+    INSTR_TIME_SUBTRACT(duration, start_time);
+
+    if (zlen <= 0 || (Size)zlen >= nbytes) {
+        (void)pq_putmessage_noblock(
+            'd', t_thrd.walsender_cxt.output_xlog_message, 1 + sizeof(WalDataMessageHeader) + nbytes);
+        zlen = (int)nbytes;
+    } else {
+        msg[0] = 'z';
+        zhdr.header = *msghdr;
+        zhdr.rawLen = (uint32)nbytes;
+        errorno = memcpy_s(msg + 1, sizeof(WalCompressedDataMessageHeader), &zhdr, sizeof(WalCompressedDataMessageHeader));
+        securec_check(errorno, "\0", "\0");
+        (void)pq_putmessage_noblock('d', msg, 1 + sizeof(WalCompressedDataMessageHeader) + zlen);
+    }
+
+    SpinLockAcquire(&walsnd->mutex);
+    walsnd->raw_bytes += nbytes;
+    walsnd->compressed_bytes += (uint64)zlen;
+    walsnd->compress_time += (uint64)INSTR_TIME_GET_MICROSEC(duration);
+    SpinLockRelease(&walsnd->mutex);
+}
+
 static void XLogSendPhysical(void)
 {
     XLogRecPtr SendRqstPtr = InvalidXLogRecPtr;
@@ -3590,8 +3715,11 @@ static void XLogSendPhysical(void)
         &msghdr,
         sizeof(WalDataMessageHeader));
     securec_check(errorno, "\0", "\0");
-    (void)pq_putmessage_noblock(
-        'd', t_thrd.walsender_cxt.output_xlog_message, 1 + sizeof(WalDataMessageHeader) + nbytes);
+    if (t_thrd.walsender_cxt.compress_xlog_message != NULL)
+        XLogSendCompressed(&msghdr, nbytes);
+    else
+        (void)pq_putmessage_noblock(
+            'd', t_thrd.walsender_cxt.output_xlog_message, 1 + sizeof(WalDataMessageHeader) + nbytes);
 
     t_thrd.walsender_cxt.sentPtr = endptr;
 
@@ -4039,7 +4167,7 @@ Tuplestorestate* BuildTupleResult(FunctionCallInfo fcinfo, TupleDesc* tupdesc)
  */
 Datum pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
 {
-#define PG_STAT_GET_WAL_SENDERS_COLS 21
+#define PG_STAT_GET_WAL_SENDERS_COLS 25
 
     TupleDesc tupdesc;
     Tuplestorestate* tupstore = NULL;
@@ -4104,6 +4232,10 @@ Datum pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
         TimestampTz catchup_time[2];
         int localport = 0;
         int remoteport = 0;
+        bool compression = false;
+        uint64 raw_bytes;
+        uint64 compressed_bytes;
+        uint64 compress_time;
         Datum values[PG_STAT_GET_WAL_SENDERS_COLS];
         bool nulls[PG_STAT_GET_WAL_SENDERS_COLS];
         int j = 0;
@@ -4141,6 +4273,10 @@ Datum pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
         syncStart = walsnd->syncPercentCountStart;
         catchup_time[0] = walsnd->catchupTime[0];
         catchup_time[1] = walsnd->catchupTime[1];
+        compression = walsnd->compression;
+        raw_bytes = walsnd->raw_bytes;
+        compressed_bytes = walsnd->compressed_bytes;
+        compress_time = walsnd->compress_time;
         if (IS_DN_MULTI_STANDYS_MODE())
             priority = walsnd->sync_standby_priority;
         SpinLockRelease(&walsnd->mutex);
@@ -4331,6 +4467,23 @@ Datum pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
                 remoteport);
             securec_check_ss(ret, "\0", "\0");
             values[j++] = CStringGetTextDatum(location);
+
+            /*
+             * compression, raw_bytes, compressed_bytes, compress_time. Before
+             * the upgrade has committed the catalog has no such columns, the
+             * tuple is formed without them.
+             */
+            if (compression) {
+                values[j++] = CStringGetTextDatum(REPL_COMPRESSION_LZ4);
+                values[j++] = Int64GetDatum((int64)raw_bytes);
+                values[j++] = Int64GetDatum((int64)compressed_bytes);
+                values[j++] = Int64GetDatum((int64)compress_time);
+            } else {
+                values[j++] = CStringGetTextDatum("off");
+                nulls[j++] = true;
+                nulls[j++] = true;
+                nulls[j++] = true;
+            }
         }
 
         tuplestore_putvalues(tupstore, tupdesc, values, nulls);
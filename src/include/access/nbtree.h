@@ -112,6 +112,9 @@ typedef struct BTMetaPageData {
 #define BTREE_MAGIC 0x053162 /* magic number of btree pages */
 #define BTREE_VERSION 2      /* current version number */
 
+/* Posting list tuples are only formed once the cluster runs this version */
+#define BTREE_DEDUP_VERSION_NUM 92075
+
 /*
  * Maximum size of a btree index entry, including its tuple header.
  *
@@ -130,6 +133,39 @@ typedef struct BTMetaPageData {
  * a rightmost page; when splitting non-rightmost pages we try to
  * divide the data equally.
  */
+/*
+ * Leaf-level tuples with equal keys may be merged into a single "posting
+ * list" tuple, which keeps the key once followed by the sorted array of the
+ * heap TIDs of all the duplicates (see nbtdedup.cpp and nbtree/README).  A
+ * posting list tuple is flagged with INDEX_ALT_TID_MASK in t_info; its t_tid
+ * is then not a heap TID, the block number holds the offset of the TID array
+ * within the tuple and the offset number holds the number of TIDs.  Pivot
+ * tuples (high keys and downlinks) are never posting list tuples.
+ *
+ * A posting list tuple is kept to half of BTMaxItemSize, so that splitting a
+ * page full of them still leaves room for the new item on either half.
+ * MaxTIDsPerBTreePage bounds the number of heap TIDs a leaf page can hold,
+ * which is what a scan has to be able to remember of a single page.
+ */
+#define INDEX_ALT_TID_MASK INDEX_AM_RESERVED_BIT
+
+#define BTreeTupleIsPosting(itup) (((itup)->t_info & INDEX_ALT_TID_MASK) != 0)
+#define BTreeTupleGetNPosting(itup) ItemPointerGetOffsetNumber(&(itup)->t_tid)
+#define BTreeTupleGetPostingOffset(itup) ItemPointerGetBlockNumber(&(itup)->t_tid)
+#define BTreeTupleGetPosting(itup) ((ItemPointer)((char*)(itup) + BTreeTupleGetPostingOffset(itup)))
+#define BTreeTupleGetPostingN(itup, n) (BTreeTupleGetPosting(itup) + (n))
+#define BTreeTupleSetPosting(itup, nhtids, off)                     \
+    do {                                                            \
+        (itup)->t_info |= INDEX_ALT_TID_MASK;                       \
+        ItemPointerSetBlockNumber(&(itup)->t_tid, (off));           \
+        ItemPointerSetOffsetNumber(&(itup)->t_tid, (nhtids));       \
+    } while (0)
+
+#define BTMaxPostingSize(page) MAXALIGN_DOWN(BTMaxItemSize(page) / 2)
+
+#define MaxTIDsPerBTreePage \
+    ((int)((BLCKSZ - SizeOfPageHeaderData - sizeof(BTPageOpaqueData)) / sizeof(ItemPointerData)))
+
 #define BTREE_MIN_FILLFACTOR 10
 #define BTREE_DEFAULT_FILLFACTOR 90
 #define BTREE_NONLEAF_FILLFACTOR 70
@@ -229,6 +265,7 @@ typedef struct BTMetaPageData {
 #define XLOG_BTREE_REUSE_PAGE                   \
     0xD0 /* old page is about to be reused from \
           * FSM */
+#define XLOG_BTREE_DEDUP 0xE0 /* leaf page rewritten with posting lists */
 
 /*
  * All that we need to regenerate the meta-data page
@@ -351,6 +388,15 @@ typedef struct xl_btree_vacuum {
 
 #define SizeOfBtreeVacuum (offsetof(xl_btree_vacuum, lastBlockVacuumed) + sizeof(BlockNumber))
 
+/*
+ * Deduplication of a leaf page, and the update of posting list tuples by
+ * VACUUM, rewrite the items of the page.  The record has no main data; the
+ * data of block 0 is the tuple area of the new page, in the format read by
+ * _bt_restore_page.  The high key, if any, is the first tuple.
+ *
+ * Backup Blk 0: leaf page
+ */
+
 /*
  * This is what we need to know about deletion of a btree page.  The target
  * identifies the tuple removed from the parent page (note that we remove
@@ -506,7 +552,7 @@ typedef struct BTScanPosData {
     int lastItem;  /* last valid index in items[] */
     int itemIndex; /* current index in items[] */
 
-    BTScanPosItem items[MaxIndexTuplesPerPage]; /* MUST BE LAST */
+    BTScanPosItem items[MaxTIDsPerBTreePage]; /* MUST BE LAST */
 } BTScanPosData;
 
 typedef BTScanPosData* BTScanPos;
@@ -535,6 +581,16 @@ typedef struct BTScanOpaqueData {
     BTArrayKeyInfo* arrayKeys;  /* info about each equality-type array key */
     MemoryContext arrayContext; /* scan-lifespan context for array data */
 
+    /*
+     * workspace for skip scans.  The leading column key is arrayKeyData[0],
+     * ahead of the caller's keys; its value lives in arrayContext.
+     */
+    bool skipScan;       /* skipping over distinct leading column values */
+    bool skipHaveValue;  /* skip key holds a leading column value */
+    bool markSkipValid;  /* markSkipValue is valid */
+    bool markSkipIsNull; /* marked leading column value is NULL */
+    Datum markSkipValue; /* leading column value when the mark was set */
+
     /* info about killed items if any (killedItems is NULL if never used) */
     int* killedItems; /* currPos.items indexes of killed items */
     int numKilled;    /* number of currently stored items */
@@ -633,6 +689,8 @@ extern Datum btbulkdelete(PG_FUNCTION_ARGS);
 extern Datum btvacuumcleanup(PG_FUNCTION_ARGS);
 extern Datum btcanreturn(PG_FUNCTION_ARGS);
 extern Datum btoptions(PG_FUNCTION_ARGS);
+extern void btbuildCallback(
+    Relation index, HeapTuple htup, Datum* values, const bool* isnull, bool tupleIsAlive, void* state);
 /* 
  * this is the interface of merge 2 or more index for btree index
  * we also have similar interfaces for other kind of indexes, like hash/gist/gin
@@ -674,6 +732,7 @@ extern int32 _bt_compare(Relation rel, int keysz, ScanKey scankey, Page page, Of
 extern bool _bt_first(IndexScanDesc scan, ScanDirection dir);
 extern bool _bt_next(IndexScanDesc scan, ScanDirection dir);
 extern Buffer _bt_get_endpoint(Relation rel, uint32 level, bool rightmost);
+extern bool _bt_skip_advance(IndexScanDesc scan, ScanDirection dir);
 extern bool _bt_gettuple_internal(IndexScanDesc scan, ScanDirection dir);
 
 /*
@@ -682,12 +741,15 @@ extern bool _bt_gettuple_internal(IndexScanDesc scan, ScanDirection dir);
 extern ScanKey _bt_mkscankey(Relation rel, IndexTuple itup);
 extern ScanKey _bt_mkscankey_nodata(Relation rel);
 extern void _bt_freeskey(ScanKey skey);
+extern IndexTuple _bt_nonkey_truncate(Relation rel, IndexTuple itup);
+extern IndexTuple _bt_pivot_tuple(Relation rel, IndexTuple itup);
 extern void _bt_freestack(BTStack stack);
 extern void _bt_preprocess_array_keys(IndexScanDesc scan);
-extern void _bt_start_array_keys(IndexScanDesc scan, ScanDirection dir);
+extern bool _bt_start_array_keys(IndexScanDesc scan, ScanDirection dir);
 extern bool _bt_advance_array_keys(IndexScanDesc scan, ScanDirection dir);
 extern void _bt_mark_array_keys(IndexScanDesc scan);
 extern void _bt_restore_array_keys(IndexScanDesc scan);
+extern void _bt_set_skip_key(IndexScanDesc scan, Datum value, bool isnull);
 extern void _bt_preprocess_keys(IndexScanDesc scan);
 extern IndexTuple _bt_checkkeys(
     IndexScanDesc scan, Page page, OffsetNumber offnum, ScanDirection dir, bool* continuescan);
@@ -700,6 +762,17 @@ extern Size BTreeShmemSize(void);
 extern void BTreeShmemInit(void);
 extern void _bt_finish_split(Relation rel, Buffer lbuf, BTStack stack);
 
+/*
+ * prototypes for functions in nbtdedup.c
+ */
+extern bool _bt_dedup_enabled(Relation rel);
+extern bool _bt_dedup_equal(IndexTuple itup1, IndexTuple itup2);
+extern Size _bt_posting_size(IndexTuple base, int nhtids);
+extern IndexTuple _bt_form_posting(IndexTuple base, ItemPointer htids, int nhtids);
+extern bool _bt_dedup_one_page(Relation rel, Buffer buf);
+extern void _bt_update_posting_items(
+    Relation rel, Buffer buf, const OffsetNumber* updatable, IndexTuple* newitems, int nupdatable);
+
 /*
  * prototypes for functions in nbtsort.c
  */
@@ -721,10 +794,17 @@ typedef struct {
     double indtuples;
 } BTBuildState;
 
+/* upper limit of max_parallel_maintenance_workers */
+#define MAX_PARALLEL_BTBUILD_WORKERS 32
+
 extern BTSpool* _bt_spoolinit(Relation index, bool isunique, bool isdead, void* meminfo);
 extern void _bt_spooldestroy(BTSpool* btspool);
 extern void _bt_spool(BTSpool* btspool, ItemPointer self, Datum* values, const bool* isnull);
 extern void _bt_leafbuild(BTSpool* btspool, BTSpool* spool2);
+extern int _bt_parallel_build_workers(Relation heap, Relation index, struct IndexInfo* indexInfo);
+extern double _bt_parallel_build(
+    Relation heap, Relation index, struct IndexInfo* indexInfo, int nworkers, BTBuildState* buildstate);
+extern void BTParallelBuildWorkerMain(void* arg);
 /* these 4 functions are move here from nbtsearch.cpp(static functions) */
 extern void _bt_buildadd(BTWriteState* wstate, BTPageState* state, IndexTuple itup);
 extern void _bt_uppershutdown(BTWriteState* wstate, BTPageState* state);
@@ -132,6 +132,8 @@ typedef struct IndexScanDescData {
     ScanKey keyData;        /* array of index qualifier descriptors */
     ScanKey orderByData;    /* array of ordering op descriptors */
     bool xs_want_itup;      /* caller requests index tuples */
+    bool xs_skip_scan;      /* caller allows skipping over the leading column */
+    long* xs_nskips;        /* if not NULL, the AM counts its skips here */
 
     /* signaling to index AM about killing index tuples */
     bool kill_prior_tuple;      /* last-returned tuple is dead */
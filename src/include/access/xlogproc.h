@@ -710,6 +710,8 @@ void btree_xlog_delete_page_operator_currentpage(RedoBufferInfo* buffer, void* r
 
 void btree_xlog_newroot_operator_page(RedoBufferInfo* buffer, void* record, void* blkdata, Size len, BlockNumber* downlink);
 
+void btree_xlog_dedup_operator_page(RedoBufferInfo* buffer, void* blkdata, Size len);
+
 void btree_xlog_clear_incomplete_split(RedoBufferInfo* buffer);
 
 void XLogRecSetBlockCommonState(XLogReaderState* record, XLogBlockParseEnum blockvalid, ForkNumber forknum,
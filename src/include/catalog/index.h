@@ -80,6 +80,9 @@ extern void index_build(Relation heapRelation, Partition heapPartition, Relation
 
 extern double IndexBuildHeapScan(Relation heapRelation, Relation indexRelation, IndexInfo *indexInfo,
                                  bool allow_sync, IndexBuildCallback callback, void *callback_state);
+extern double IndexBuildHeapScanParallel(Relation heapRelation, Relation indexRelation, IndexInfo *indexInfo,
+                                         IndexBuildCallback callback, void *callback_state, Snapshot snapshot,
+                                         TransactionId OldestXmin, int dop);
 
 extern double IndexBuildVectorBatchScan(Relation heapRelation, Relation indexRelation, IndexInfo *indexInfo,
                                         VectorBatch *vecScanBatch, Snapshot snapshot,
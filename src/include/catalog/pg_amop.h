@@ -723,6 +723,14 @@ DATA(insert (	3655   3614 3615 1 s	3636 783 0 ));
 DATA(insert (	3659   3614 3615 1 s	3636 2742 0 ));
 DATA(insert (	3659   3614 3615 2 s	3660 2742 0 ));
 
+/*
+ * GIN jsonb_ops
+ */
+DATA(insert (	3264   3230 3230 7 s 3259 2742 0 ));
+DATA(insert (	3264   3230 25 9 s 3261 2742 0 ));
+DATA(insert (	3264   3230 1009 10 s 3262 2742 0 ));
+DATA(insert (	3264   3230 1009 11 s 3263 2742 0 ));
+
 /*
  * CGIN tsvector_ops
  */
@@ -384,6 +384,11 @@ DATA(insert (	3659   3614 3614 3 3657 ));
 DATA(insert (	3659   3614 3614 4 3658 ));
 DATA(insert (	3659   3614 3614 5 2700 ));
 DATA(insert (	3659   3614 3614 6 3921 ));
+DATA(insert (	3264   3230 3230 1 3268 ));
+DATA(insert (	3264   3230 3230 2 3245 ));
+DATA(insert (	3264   3230 3230 3 3246 ));
+DATA(insert (	3264   3230 3230 4 3247 ));
+DATA(insert (	3264   3230 3230 6 3248 ));
 DATA(insert (	3626   3614 3614 1 3622 ));
 DATA(insert (	3683   3615 3615 1 3668 ));
 DATA(insert (	3901   3831 3831 1 3870 ));
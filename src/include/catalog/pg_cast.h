@@ -320,6 +320,10 @@ DATA(insert (	23	 18   78 e f ));
 DATA(insert (  194	 25    0 i b ));
 DATA(insert (  194	 90    0 i b ));
 
+/* json and jsonb convert both ways, the cast to jsonb parses the document once */
+DATA(insert (  114 3230 3249 a f ));
+DATA(insert ( 3230  114 3251 a f ));
+
 /*
  * Datetime category
  */
@@ -49,15 +49,18 @@ CATALOG(pg_index,2610) BKI_WITHOUT_OIDS BKI_SCHEMA_MACRO
     int2vector  indkey;            /* column numbers of indexed cols, or 0 */
 
 #ifdef CATALOG_VARLEN
-    oidvector   indcollation;    /* collation identifiers */
-    oidvector   indclass;        /* opclass identifiers */
-    int2vector  indoption;      /* per-column flags (AM-specific meanings) */
+    oidvector   indcollation;    /* collation identifiers of key columns */
+    oidvector   indclass;        /* opclass identifiers of key columns */
+    int2vector  indoption;      /* per-key-column flags (AM-specific meanings) */
     pg_node_tree indexprs;        /* expression trees for index attributes that
                                    * are not simple column references; one for
                                    * each zero entry in indkey[] */
     pg_node_tree indpred;         /* expression tree for predicate, if a partial
                                     * index; else NULL */
     bool        indisreplident; /* is this index the identity for replication? */
+    int2        indnkeyatts;    /* number of key columns in index, NULL for
+                                 * all of indnatts; the included columns
+                                 * follow the key columns in indkey */
 #endif
 } FormData_pg_index;
 
@@ -72,7 +75,7 @@ typedef FormData_pg_index *Form_pg_index;
  *        compiler constants for pg_index
  * ----------------
  */
-#define Natts_pg_index                    19
+#define Natts_pg_index                    20
 #define Anum_pg_index_indexrelid          1
 #define Anum_pg_index_indrelid            2
 #define Anum_pg_index_indnatts            3
@@ -92,6 +95,11 @@ typedef FormData_pg_index *Form_pg_index;
 #define Anum_pg_index_indexprs            17
 #define Anum_pg_index_indpred             18
 #define Anum_pg_index_indisreplident      19
+#define Anum_pg_index_indnkeyatts         20
+
+/* Version control for the included columns of an index, see indnkeyatts */
+#define INCLUDE_INDEX_VERSION_NUM 92074
+
 /*
  * Index AMs that support ordered scans must support these two indoption
  * bits.  Otherwise, the content of the per-column indoption fields is
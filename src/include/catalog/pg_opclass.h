@@ -251,6 +251,7 @@ DATA(insert ( 405        enum_ops            PGNSP PGUID 3523  3500 t 0 ));
 DATA(insert ( 403        tsvector_ops        PGNSP PGUID 3626  3614 t 0 ));
 DATA(insert ( 783        tsvector_ops        PGNSP PGUID 3655  3614 t 3642 ));
 DATA(insert ( 2742       tsvector_ops        PGNSP PGUID 3659  3614 t 25 ));
+DATA(insert ( 2742       jsonb_ops           PGNSP PGUID 3264  3230 t 25 ));
 DATA(insert ( 4444       tsvector_ops        PGNSP PGUID 4446  3614 t 25 ));
 DATA(insert ( 403        tsquery_ops         PGNSP PGUID 3683  3615 t 0 ));
 DATA(insert ( 783        tsquery_ops         PGNSP PGUID 3702  3615 t 20 ));
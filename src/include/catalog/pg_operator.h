@@ -1900,6 +1900,26 @@ DATA(insert OID = 3899 ("-"       PGNSP PGUID b f f 3831 3831 3831 0 0 range_min
 DESCR("range difference");
 DATA(insert OID = 3900 ("*"       PGNSP PGUID b f f 3831 3831 3831 3900 0 range_intersect - -));
 DESCR("range intersection");
+
+/* jsonb */
+DATA(insert OID = 3252 ("->"       PGNSP PGUID b f f 3230 25 3230 0 0 jsonb_object_field - -));
+DESCR("get jsonb object field");
+DATA(insert OID = 3253 ("->"       PGNSP PGUID b f f 3230 23 3230 0 0 jsonb_array_element - -));
+DESCR("get jsonb array element");
+DATA(insert OID = 3257 ("->>"    PGNSP PGUID b f f 3230 25 25 0 0 jsonb_object_field_text - -));
+DESCR("get jsonb object field as text");
+DATA(insert OID = 3258 ("->>"    PGNSP PGUID b f f 3230 23 25 0 0 jsonb_array_element_text - -));
+DESCR("get jsonb array element as text");
+DATA(insert OID = 3259 ("@>"       PGNSP PGUID b f f 3230 3230 16 3260 0 jsonb_contains contsel contjoinsel));
+DESCR("contains");
+DATA(insert OID = 3260 ("<@"       PGNSP PGUID b f f 3230 3230 16 3259 0 jsonb_contained contsel contjoinsel));
+DESCR("is contained by");
+DATA(insert OID = 3261 ("?"       PGNSP PGUID b f f 3230 25 16 0 0 jsonb_exists contsel contjoinsel));
+DESCR("key exists");
+DATA(insert OID = 3262 ("?|"       PGNSP PGUID b f f 3230 1009 16 0 0 jsonb_exists_any contsel contjoinsel));
+DESCR("any key exists");
+DATA(insert OID = 3263 ("?&"       PGNSP PGUID b f f 3230 1009 16 0 0 jsonb_exists_all contsel contjoinsel));
+DESCR("all keys exist");
 DATA(insert OID = 5550 ("="       PGNSP PGUID b t t 9003 9003     16 5550 5551 smalldatetime_eq eqsel eqjoinsel));
 DESCR("equal");
 DATA(insert OID = 5551 ("<>"       PGNSP PGUID b f f 9003 9003     16 5551 5550 smalldatetime_ne neqsel neqjoinsel));
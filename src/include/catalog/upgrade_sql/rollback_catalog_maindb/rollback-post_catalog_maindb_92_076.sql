@@ -0,0 +1,3 @@
+-- pg_stat_get_parallel_decode and the pg_stat_parallel_decoding view
+DROP VIEW IF EXISTS pg_catalog.pg_stat_parallel_decoding CASCADE;
+DROP FUNCTION IF EXISTS pg_catalog.pg_stat_get_parallel_decode() CASCADE;
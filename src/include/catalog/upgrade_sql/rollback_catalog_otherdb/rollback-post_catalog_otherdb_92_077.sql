@@ -0,0 +1,62 @@
+-- pg_stat_get_wal_senders and the views on it, with the compression of the replication stream
+DROP VIEW IF EXISTS pg_catalog.pg_stat_replication CASCADE;
+DROP VIEW IF EXISTS pg_catalog.pg_get_senders_catchup_time CASCADE;
+DROP FUNCTION IF EXISTS pg_catalog.pg_stat_get_wal_senders() CASCADE;
+
+SET LOCAL inplace_upgrade_next_system_object_oids = IUO_PROC, 3099;
+CREATE FUNCTION pg_catalog.pg_stat_get_wal_senders(
+    OUT pid bigint, OUT sender_pid integer, OUT local_role text, OUT peer_role text, OUT peer_state text,
+    OUT state text, OUT catchup_start timestamp with time zone, OUT catchup_end timestamp with time zone,
+    OUT sender_sent_location text, OUT sender_write_location text, OUT sender_flush_location text,
+    OUT sender_replay_location text, OUT receiver_received_location text, OUT receiver_write_location text,
+    OUT receiver_flush_location text, OUT receiver_replay_location text, OUT sync_percent text,
+    OUT sync_state text, OUT sync_priority integer, OUT sync_most_available text, OUT channel text)
+RETURNS SETOF record LANGUAGE INTERNAL STABLE NOT FENCED AS 'pg_stat_get_wal_senders';
+
+CREATE VIEW pg_catalog.pg_stat_replication AS
+    SELECT
+            S.pid,
+            S.usesysid,
+            U.rolname AS usename,
+            S.application_name,
+            S.client_addr,
+            S.client_hostname,
+            S.client_port,
+            S.backend_start,
+            W.state,
+            W.sender_sent_location,
+            W.receiver_write_location,
+            W.receiver_flush_location,
+            W.receiver_replay_location,
+            W.sync_priority,
+            W.sync_state
+    FROM pg_catalog.pg_stat_get_activity(NULL) AS S, pg_catalog.pg_authid U,
+            pg_catalog.pg_stat_get_wal_senders() AS W
+    WHERE S.usesysid = U.oid AND
+            S.pid = W.sender_pid;
+
+CREATE VIEW pg_catalog.pg_get_senders_catchup_time AS
+    SELECT
+            W.pid,
+            W.sender_pid AS lwpid,
+            W.local_role,
+            W.peer_role,
+            W.state,
+            'Wal' AS type,
+            W.catchup_start,
+            W.catchup_end
+    FROM pg_catalog.pg_stat_get_wal_senders() AS W
+    UNION ALL
+    SELECT
+            D.pid,
+            D.sender_pid AS lwpid,
+            D.local_role,
+            D.peer_role,
+            D.state,
+            'Data' AS type,
+            D.catchup_start,
+            D.catchup_end
+    FROM pg_catalog.pg_stat_get_data_senders() AS D;
+
+GRANT SELECT ON pg_catalog.pg_stat_replication TO PUBLIC;
+GRANT SELECT ON pg_catalog.pg_get_senders_catchup_time TO PUBLIC;
@@ -0,0 +1,24 @@
+-- pg_stat_get_parallel_decode and the pg_stat_parallel_decoding view
+DROP VIEW IF EXISTS pg_catalog.pg_stat_parallel_decoding CASCADE;
+DROP FUNCTION IF EXISTS pg_catalog.pg_stat_get_parallel_decode() CASCADE;
+
+SET LOCAL inplace_upgrade_next_system_object_oids = IUO_PROC, 3229;
+CREATE FUNCTION pg_catalog.pg_stat_get_parallel_decode(
+    OUT pid bigint, OUT slot_name text, OUT stage text, OUT worker_id integer, OUT queue_depth bigint,
+    OUT processed bigint, OUT processed_bytes bigint, OUT location text, OUT lag_bytes bigint)
+RETURNS SETOF record LANGUAGE INTERNAL STABLE NOT FENCED AS 'pg_stat_get_parallel_decode';
+
+CREATE VIEW pg_catalog.pg_stat_parallel_decoding AS
+    SELECT
+            P.pid,
+            P.slot_name,
+            P.stage,
+            P.worker_id,
+            P.queue_depth,
+            P.processed,
+            P.processed_bytes,
+            P.location,
+            P.lag_bytes
+    FROM pg_catalog.pg_stat_get_parallel_decode() AS P;
+
+GRANT SELECT ON pg_catalog.pg_stat_parallel_decoding TO PUBLIC;
@@ -17,6 +17,11 @@
 #include "utils/globalplancache.h"
 #include "utils/plancache.h"
 
+/* prefix of the names of the statements made by auto-parameterization */
+#define AUTO_PARAM_STMT_PREFIX "gs_autoparam_"
+#define IsAutoParamStatementName(name) \
+    (strncmp((name), AUTO_PARAM_STMT_PREFIX, sizeof(AUTO_PARAM_STMT_PREFIX) - 1) == 0)
+
 #ifdef PGXC
 typedef struct DatanodeStatement {
     /* dynahash.c requires key to be first field */
@@ -32,10 +37,12 @@ extern void PrepareQuery(PrepareStmt* stmt, const char* queryString);
 extern void ExecuteQuery(ExecuteStmt* stmt, IntoClause* intoClause, const char* queryString, ParamListInfo params,
     DestReceiver* dest, char* completionTag);
 extern void DeallocateQuery(const DeallocateStmt* stmt);
+extern List* AutoParameterizeQuery(const char* query_string, List** query_string_locationlist);
 extern void ExplainExecuteQuery(
     ExecuteStmt* execstmt, IntoClause* into, ExplainState* es, const char* queryString, ParamListInfo params);
 
 /* Low-level access to stored prepared statements */
+extern void CheckPreparedStatementName(const char* stmt_name);
 extern void StorePreparedStatement(const char* stmt_name, CachedPlanSource* plansource, bool from_sql);
 extern PreparedStatement* FetchPreparedStatement(const char* stmt_name, bool throwError);
 extern void DropPreparedStatement(const char* stmt_name, bool showError);
@@ -254,6 +254,9 @@ typedef struct {
 
 #define hdfsVcuumAction(flag) (((flag)&VACOPT_HDFSDIRECTORY) || ((flag)&VACOPT_COMPACT) || ((flag)&VACOPT_MERGE))
 
+/* upper limit of the parallel_vacuum_workers reloption */
+#define MAX_PARALLEL_VACUUM_WORKERS 32
+
 /* We need estimate total rows on datanode only sample rate is -1. */
 #define NEED_EST_TOTAL_ROWS_DN(vacstmt) \
     (IS_PGXC_DATANODE && IsConnFromCoord() && (vacstmt)->pstGlobalStatEx[(vacstmt)->tableidx].sampleRate < 0)
@@ -354,6 +357,7 @@ extern void vacuum_delay_point(void);
 
 /* in commands/vacuumlazy.c */
 extern void lazy_vacuum_rel(Relation onerel, VacuumStmt* vacstmt, BufferAccessStrategy bstrategy);
+extern void LazyVacuumWorkerMain(void* arg);
 
 /* in commands/analyze.c */
 extern void analyze_rel(Oid relid, VacuumStmt* vacstmt, BufferAccessStrategy bstrategy);
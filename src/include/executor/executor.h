@@ -267,6 +267,7 @@ extern TupleTableSlot* ExecProject(ProjectionInfo* projInfo, ExprDoneCond* isDon
 
 extern TupleTableSlot* ExecScan(ScanState* node, ExecScanAccessMtd accessMtd, ExecScanRecheckMtd recheckMtd);
 extern void ExecAssignScanProjectionInfo(ScanState* node);
+extern void ExecScanInitRuntimeFilter(ScanState* node);
 extern void ExecScanReScan(ScanState* node);
 
 /*
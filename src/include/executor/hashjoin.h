@@ -179,6 +179,8 @@ typedef struct HashJoinTableData {
     int64 maxMem;           /* batch auto spread mem */
     int spreadNum;          /* auto spread times */
     int64* spill_size;
+    int64* spill_rawSize;      /* batch file bytes before compression, may be NULL */
+    int64* spill_compressSize; /* batch file bytes after compression, may be NULL */
 } HashJoinTableData;
 
 #endif /* HASHJOIN_H */
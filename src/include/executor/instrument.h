@@ -123,6 +123,8 @@ typedef struct SortHashInfo {
     int spill_innerPartNum; /* number of inner partitions that are spilt to disk */
     int spill_outerPartNum; /* number of outer partitions that are spilt to disk */
     int hash_partNum;       /* partition number of either build or probe side */
+    int64 spill_rawSize;      /* bytes of compressed spill files before compression */
+    int64 spill_compressSize; /* bytes of compressed spill files written to disk */
 } SortHashInfo;
 
 typedef struct StreamTime {
@@ -25,6 +25,7 @@ extern TupleTableSlot* ExecHash(void);
 extern Node* MultiExecHash(HashState* node);
 extern void ExecEndHash(HashState* node);
 extern void ExecReScanHash(HashState* node);
+extern void ExecHashResetRuntimeFilter(HashState* node);
 
 extern HashJoinTable ExecHashTableCreate(Hash* node, List* hashOperators, bool keepNulls);
 extern void ExecHashTableDestroy(HashJoinTable hashtable);
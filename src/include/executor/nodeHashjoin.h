@@ -21,7 +21,7 @@ extern HashJoinState* ExecInitHashJoin(HashJoin* node, EState* estate, int eflag
 extern TupleTableSlot* ExecHashJoin(HashJoinState* node);
 extern void ExecEndHashJoin(HashJoinState* node);
 extern void ExecReScanHashJoin(HashJoinState* node);
-extern void ExecHashJoinSaveTuple(MinimalTuple tuple, uint32 hashvalue, BufFile** fileptr);
+extern void ExecHashJoinSaveTuple(MinimalTuple tuple, uint32 hashvalue, BufFile** fileptr, HashJoinTable hashtable);
 extern void ExecEarlyFreeHashJoin(HashJoinState* node);
 extern void ExecReSetHashJoin(HashJoinState* node);
 
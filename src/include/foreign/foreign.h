@@ -23,6 +23,9 @@
 #ifndef HDFS_SERVER
 #define HDFS_SERVER "hdfs"
 #endif
+#ifndef LOCAL_SERVER
+#define LOCAL_SERVER "local"
+#endif
 
 #define OBS_BUCKET_URL_FORMAT_FLAG ".obs."
 #define OBS_PREFIX "obs://"
@@ -137,7 +140,8 @@ typedef enum ServerTypeOption {
     T_MOT_SERVER,
     T_DUMMY_SERVER,
     T_TXT_CSV_OBS_SERVER, /* mark the txt/csv foramt OBS foreign server. the fdw is dist_fdw. */
-    T_PGFDW_SERVER
+    T_PGFDW_SERVER,
+    T_LOCAL_SERVER /* orc/parquet files on the local file system of the datanode. */
 } ServerTypeOption;
 
 /*
@@ -270,14 +274,16 @@ HdfsOptions* setHdfsSrvOptions(ForeignOptions* fOptions);
 
 bool isWriteOnlyFt(Oid relid);
 
-#define isObsOrHdfsTableFormTblOid(relId) \
-    (isSpecifiedSrvTypeFromRelId(relId, HDFS) || isSpecifiedSrvTypeFromRelId(relId, OBS))
+#define isObsOrHdfsTableFormTblOid(relId)                                                  \
+    (isSpecifiedSrvTypeFromRelId(relId, HDFS) || isSpecifiedSrvTypeFromRelId(relId, OBS) || \
+        isSpecifiedSrvTypeFromRelId(relId, LOCAL_SERVER))
 
 #define isMOTFromTblOid(relId) \
     (IsSpecifiedFDWFromRelid(relId, MOT_FDW))
 
-#define isObsOrHdfsTableFormSrvName(srvName) \
-    (isSpecifiedSrvTypeFromSrvName(srvName, HDFS) || isSpecifiedSrvTypeFromSrvName(srvName, OBS))
+#define isObsOrHdfsTableFormSrvName(srvName)                                                       \
+    (isSpecifiedSrvTypeFromSrvName(srvName, HDFS) || isSpecifiedSrvTypeFromSrvName(srvName, OBS) || \
+        isSpecifiedSrvTypeFromSrvName(srvName, LOCAL_SERVER))
 
 #define isMOTTableFromSrvName(srvName) \
     (IsSpecifiedFDW(srvName, MOT_FDW))
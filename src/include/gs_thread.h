@@ -97,6 +97,9 @@ typedef enum knl_thread_role {
     COMM_RECEIVER,
     COMM_AUXILIARY,
     COMM_POOLER_CLEAN,
+    PARALLEL_DECODE,
+    PARALLEL_BTBUILD,
+    PARALLEL_VACUUM,
     // should be last valid thread.
     THREAD_ENTRY_BOUND,
 
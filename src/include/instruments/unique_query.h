@@ -29,7 +29,18 @@
 #include "nodes/parsenodes.h"
 #include "c.h"
 
+/* a literal token of a query text replaced by a parameter symbol */
+typedef struct AutoParamLiteral {
+    int location;      /* offset of the literal token in the query text */
+    int sign_location; /* offset of the '-' right before it, or -1 */
+    NodeTag valtype;   /* T_Integer, T_Float or T_String, as made by the parser */
+    char* value;       /* value of the literal, unquoted for strings */
+    Oid type;          /* type of the parameter */
+} AutoParamLiteral;
+
 extern uint32 generate_unique_queryid(Query* query, const char* query_string);
 extern bool normalized_unique_querystring(Query* query, const char* query_string, char* unique_string, int len);
+extern char* auto_parameterize_query_string(const char* query_string, AutoParamLiteral** literals, int* nliterals);
+extern bool auto_parameterize_check_query(Query* query, AutoParamLiteral* literals, int nliterals);
 
 #endif
@@ -52,10 +52,12 @@ typedef struct knl_instance_attr_common {
 	bool enable_global_plancache;
     int max_files_per_process;
     int pgstat_track_activity_query_size;
+    int pgstat_track_tables;
+    int thread_pool_steal_threshold;
     int GtmHostPortArray[MAX_GTM_HOST_NUM];
     int MaxDataNodes;
     int max_changes_in_memory;
-    int max_cached_tuplebufs;
+    int max_cached_tuplebufs; /* deprecated, no longer used */
 #ifdef USE_BONJOUR
     char* bonjour_name;
 #endif
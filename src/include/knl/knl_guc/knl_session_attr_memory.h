@@ -46,6 +46,7 @@ typedef struct knl_session_attr_memory {
     bool disable_memory_protect;
     int work_mem;
     int maintenance_work_mem;
+    int vacuum_dead_tuples_mem;
     char* memory_detail_tracking;
     char* uncontrolled_memory_context;
     int memory_tracking_mode;
@@ -48,16 +48,20 @@ typedef struct knl_session_attr_sql {
     bool enable_valuepartition_pruning;
     bool enable_constraint_optimization;
     bool enable_bloom_filter;
+    bool enable_runtime_join_filter;
+    bool enable_auto_parameterization;
     bool enable_codegen;
     bool enable_codegen_print;
     bool enable_sonic_optspill;
     bool enable_sonic_hashjoin;
     bool enable_sonic_hashagg;
+    bool enable_sonic_windowagg;
     bool enable_csqual_pushdown;
     bool enable_change_hjcost;
     bool enable_seqscan;
     bool enable_indexscan;
     bool enable_indexonlyscan;
+    bool enable_indexskipscan;
     bool enable_bitmapscan;
     bool force_bitmapand;
     bool enable_parallel_ddl;
@@ -190,6 +194,7 @@ typedef struct knl_session_attr_sql {
     bool enable_stream_recursive;
     bool enable_save_datachanged_timestamp;
     int max_recursive_times;
+    int auto_param_max_statements;
     /* Table skewness warning rows, range from 0 to INT_MAX*/
     int table_skewness_warning_rows;
     /* Table skewness warning threshold, range from 0 to 1, 0 indicates feature disabled*/
@@ -66,6 +66,7 @@ typedef struct knl_session_attr_storage {
     bool HaModuleDebug;
     bool hot_standby_feedback;
     bool enable_stream_replication;
+    bool enable_stream_compression;
     bool EnforceTwoPhaseCommit;
     bool enable_show_any_tuples;
     bool enable_debug_vacuum;
@@ -114,6 +115,9 @@ typedef struct knl_session_attr_storage {
     int CheckPointWaitTimeOut;
     int WalWriterDelay;
     int wal_sender_timeout;
+    int logical_decoding_work_mem;
+    int logical_decoding_parallel_workers;
+    int max_parallel_maintenance_workers;
     int CommitDelay;
     int partition_lock_upgrade_timeout;
     int CommitSiblings;
@@ -176,6 +176,11 @@ typedef struct knl_g_stat_context {
     MemoryContext InstrUserContext;
     HTAB* InstrUserHTAB;
 
+    /* shared table and function statistics */
+    MemoryContext PgStatSharedContext;
+    HTAB* PgStatTabHash;
+    HTAB* PgStatFuncHash;
+
     /* workload trx stat */
     HTAB* workload_info_hashtbl;
 
@@ -699,6 +699,19 @@ typedef struct knl_u_plancache_context {
     HTAB* datanode_queries;
 #endif
 
+    /*
+     * Hashes of the parameterized texts of simple queries found unsuitable
+     * for auto-parameterization, so they are not analyzed again.
+     */
+    HTAB* auto_param_rejects;
+
+    /*
+     * The statements made by auto-parameterization, by the hash of their
+     * text, and the same ones from the most to the least recently used.
+     */
+    HTAB* auto_param_stmts;
+    Dllist auto_param_lru;
+
     bool gpc_in_ddl;
     bool gpc_remote_msg;
     bool gpc_first_send;
@@ -1222,6 +1235,10 @@ typedef struct knl_u_stat_context {
     struct HTAB* pgStatDBHash;
     struct TabStatusArray* pgStatTabList;
 
+    /* entries of the shared table/function stats hashes read in this transaction */
+    struct HTAB* pgStatTabSnapshot;
+    struct HTAB* pgStatFuncSnapshot;
+
     /*
      * BgWriter global statistics counters (unused in other processes).
      * Stored directly in a stats message structure so it can be sent
@@ -2002,6 +2019,11 @@ typedef struct knl_session_context {
 
     ThreadId attachPid;
 
+    /* thread pool group whose listener watches the connection */
+    class ThreadPoolGroup* tpool_group;
+    /* times in a row the session was served by a worker of another group */
+    int tpool_steal_count;
+
     MemoryContext top_mem_cxt;
     MemoryContext cache_mem_cxt;
     MemoryContext top_transaction_mem_cxt;
@@ -96,6 +96,20 @@ typedef struct knl_t_relopt_context {
     int max_custom_options;
 } knl_t_relopt_context;
 
+/*
+ * A thread's cache of the free chunks of a shared memory context, one list
+ * per freelist of the context, see aset.cpp.
+ */
+#define SHARED_CHUNK_CACHE_SLOTS 8
+#define SHARED_CHUNK_CACHE_CLASSES 11 /* ALLOCSET_NUM_FREELISTS */
+
+typedef struct SharedChunkCacheSlot {
+    void* set;    /* the shared AllocSet, NULL if the slot is free */
+    uint64 setId; /* its cacheId when the slot was filled */
+    void* chunks[SHARED_CHUNK_CACHE_CLASSES];
+    int nchunks[SHARED_CHUNK_CACHE_CLASSES];
+} SharedChunkCacheSlot;
+
 typedef struct knl_t_mem_context {
     MemoryContext postmaster_mem_cxt;
 
@@ -138,6 +152,10 @@ typedef struct knl_t_mem_context {
      * system auditor memory context.
      */
     MemoryContext pgAuditLocalContext;
+
+    /* free chunks of the shared contexts used last, kept off their locks */
+    SharedChunkCacheSlot shared_chunk_cache[SHARED_CHUNK_CACHE_SLOTS];
+    bool shared_chunk_cache_closed; /* set at thread exit, chunks go back directly */
 } knl_t_mem_context;
 
 #ifdef HAVE_INT64_TIMESTAMP
@@ -1951,6 +1969,10 @@ typedef struct knl_t_datareceiver_context {
     /* Buffer for currently read data */
     char* recvBuf;
 
+    /* Buffer for the decompressed data of 'c' messages */
+    char* decompressBuf;
+    uint32 decompressBufSize;
+
     struct DataRcvData* DataRcv;
 
     /*
@@ -1993,6 +2015,12 @@ typedef struct knl_t_datasender_context {
      */
     char* output_message;
 
+    /*
+     * Buffer for constructing compressed data messages ('c'), NULL if the
+     * standby did not ask for a compressed stream.
+     */
+    char* compress_message;
+
     /*
      * dummy standby read data file num and offset.
      */
@@ -2039,6 +2067,10 @@ typedef struct knl_t_walreceiver_context {
     bool AmWalReceiverForFailover;
     bool AmWalReceiverForStandby;
     int control_file_writed;
+
+    /* Buffer for the decompressed WAL data of 'z' messages */
+    char* decompressBuf;
+    uint32 decompressBufSize;
 } knl_t_walreceiver_context;
 
 typedef struct knl_t_walsender_context {
@@ -2092,6 +2124,11 @@ typedef struct knl_t_walsender_context {
      */
     char* output_xlog_message;
     Size output_xlog_msg_prefix_len;
+    /*
+     * Buffer for constructing compressed WAL data messages ('z'), NULL if
+     * the standby did not ask for a compressed stream.
+     */
+    char* compress_xlog_message;
     /*
      * Buffer for constructing outgoing messages
      * (sizeof(DataElementHeaderData) + MAX_SEND_SIZE bytes)
@@ -51,7 +51,9 @@ typedef struct UtilityDesc {
  *		entries for a particular index.  Used for both index_build and
  *		retail creation of index entries.
  *
- *		NumIndexAttrs		number of columns in this index
+ *		NumIndexAttrs		total number of columns in this index
+ *		NumIndexKeyAttrs	number of key columns in index, the included
+ *							columns follow them
  *		KeyAttrNumbers		underlying-rel attribute numbers used as keys
  *							(zeroes indicate expressions)
  *		Expressions			expr trees for expression entries, or NIL if none
@@ -73,6 +75,7 @@ typedef struct UtilityDesc {
 typedef struct IndexInfo {
     NodeTag type;
     int ii_NumIndexAttrs;
+    int ii_NumIndexKeyAttrs;
     AttrNumber ii_KeyAttrNumbers[INDEX_MAX_KEYS];
     List* ii_Expressions;       /* list of Expr */
     List* ii_ExpressionsState;  /* list of ExprState */
@@ -442,6 +445,13 @@ typedef struct BloomFilterControl {
     int array_size;                /* bloom filter array size. */
 } BloomFilterControl;
 
+/* runtime bloomfilter */
+typedef struct BloomFilterRuntime {
+    List* bf_var_list;              /* bloomfilter var list. */
+    List* bf_filter_index;          /* bloomfilter array index. */
+    filter::BloomFilter** bf_array; /* bloomfilter array. */
+} BloomFilterRuntime;
+
 #define InvalidBktId  (-1)    /* invalid hash-bucket id */
 
 /* ----------------
@@ -1520,6 +1530,7 @@ typedef struct ScanState {
     bool isSampleScan;               /* identify is it table sample scan or not. */
     SampleScanParams sampleScanInfo; /* TABLESAMPLE params include type/seed/repeatable. */
     ExecScanAccessMtd ScanNextMtd;
+    BloomFilterRuntime ss_runtimeFilter; /* runtime join filters pushed down by hash joins */
 } ScanState;
 
 /*
@@ -1562,6 +1573,7 @@ typedef struct {
  *		RuntimeContext	   expr context for evaling runtime Skeys
  *		RelationDesc	   index relation descriptor
  *		ScanDesc		   index scan descriptor
+ *		NumSkips		   number of leading-column skips done by a skip scan
  * ----------------
  */
 typedef struct IndexScanState {
@@ -1580,6 +1592,7 @@ typedef struct IndexScanState {
     List* iss_IndexPartitionList;
     LOCKMODE lockMode;
     Relation iss_CurrentIndexPartition;
+    long iss_NumSkips;
 } IndexScanState;
 
 /* ----------------
@@ -1598,6 +1611,7 @@ typedef struct IndexScanState {
  *		ScanDesc		   index scan descriptor
  *		VMBuffer		   buffer in use for visibility map testing, if any
  *		HeapFetches		   number of tuples we were forced to fetch from heap
+ *		NumSkips		   number of leading-column skips done by a skip scan
  * ----------------
  */
 typedef struct IndexOnlyScanState {
@@ -1618,6 +1632,7 @@ typedef struct IndexOnlyScanState {
     List* ioss_IndexPartitionList;
     LOCKMODE lockMode;
     Relation ioss_CurrentIndexPartition;
+    long ioss_NumSkips;
 } IndexOnlyScanState;
 
 /* ----------------
@@ -1634,6 +1649,7 @@ typedef struct IndexOnlyScanState {
  *		RuntimeContext	   expr context for evaling runtime Skeys
  *		RelationDesc	   index relation descriptor
  *		ScanDesc		   index scan descriptor
+ *		NumSkips		   number of leading-column skips done by a skip scan
  * ----------------
  */
 typedef struct BitmapIndexScanState {
@@ -1652,6 +1668,7 @@ typedef struct BitmapIndexScanState {
     List* biss_IndexPartitionList;
     LOCKMODE lockMode;
     Relation biss_CurrentIndexPartition;
+    long biss_NumSkips;
 } BitmapIndexScanState;
 
 /* ----------------
@@ -2268,6 +2285,10 @@ typedef struct HashState {
     int32 local_work_mem;    /* work_mem local for this hash join */
     int64 spill_size;
 
+    /* runtime join filters filled while building, pushed into the outer side */
+    BloomFilterRuntime bf_runtime;
+    filter::BloomFilter** bf_build; /* filters being built, one per bf_var_list entry */
+
     /* hashkeys is same as parent's hj_InnerHashKeys */
 } HashState;
 
@@ -2355,6 +2376,18 @@ typedef struct LimitState {
 typedef struct PartIteratorState {
     PlanState ps;   /* its first field is NodeTag */
     int currentItr; /* the sequence number for processing partition */
+
+    /* run-time pruning, see nodePartIterator.cpp */
+    List* pruningExprs;         /* Var-free subexpressions of the pruning quals */
+    List* pruningExprStates;    /* ExprStates of pruningExprs */
+    MemoryContext pruningCxt;   /* memory of a pruning, reset at the next one */
+    bool pruningPending;        /* prune before the next partition is scanned */
+    bool pruningOnRescan;       /* the quals use exec params, prune on each rescan */
+    int* selectedItrs;          /* iterations kept by the last pruning */
+    int nSelectedItrs;          /* number of them */
+    int prunedAtStart;          /* partitions pruned at executor start, -1 if not */
+    int numPrunings;            /* prunings done on rescan */
+    double numPruned;           /* partitions pruned by them in total */
 } PartIteratorState;
 
 struct VecLimitState : public LimitState {
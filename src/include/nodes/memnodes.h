@@ -142,6 +142,10 @@ typedef struct AllocSetContext {
     Size maxSpaceSize;
 
     MemoryTrack track; /* used to track the memory allocation information */
+
+    /* for the thread chunk caches of a shared context, see aset.cpp */
+    uint64 cacheId;                    /* 0 once the context is being deleted */
+    struct AllocSetContext* cacheNext; /* next set in its registry bucket */
 } AllocSetContext;
 
 typedef AllocSetContext* AllocSet;
@@ -233,6 +237,63 @@ typedef struct StackSetContext {
     MemoryTrack track; /* used to track the memory allocation information */
 } StackSetContext;
 
+/*
+ * SlabContext serves chunks of one fixed size out of equally sized blocks.
+ * The chunks of a block are kept on a free list of the block, and a block
+ * goes back to malloc() as soon as its last chunk is freed, so memory is
+ * returned while a long-lived context is still in use.
+ *
+ * GenerationContext carves chunks of any size out of its current block and
+ * never reuses a freed chunk; instead it counts the chunks still alive in
+ * each block and frees the block when none is. That suits chunks which are
+ * freed roughly in the order they were allocated.
+ *
+ * Both must begin like AllocSetContext, see @StackSetContext.
+ */
+typedef struct SlabBlockData* SlabBlock;
+typedef struct GenerationBlockData* GenerationBlock;
+
+typedef struct SlabContext {
+    MemoryContextData header; /* Standard memory-context fields */
+    SlabBlock blocks;         /* not used, the blocks are kept on freelist */
+    char* reserve[ALLOCSET_NUM_FREELISTS];
+    Size initBlockSize;   /* block size */
+    Size maxBlockSize;    /* block size */
+    Size nextBlockSize;   /* block size */
+    Size allocChunkLimit; /* chunk size requested at creation */
+    SlabBlock keeper;     /* not used */
+    Size totalSpace;      /* all bytes allocated by this context */
+    Size freeSpace;       /* all bytes freed by this context */
+    Size maxSpaceSize;
+    MemoryTrack track; /* used to track the memory allocation information */
+    /* Slab specific fields: */
+    Size chunkSize;     /* MAXALIGN'ed size of the chunks */
+    Size fullChunkSize; /* chunk size including the header */
+    int chunksPerBlock; /* number of chunks in a block */
+    int minFreeChunks;  /* fewest free chunks of a block with any, 0 if none */
+    int nblocks;        /* number of blocks allocated */
+    /* blocks by number of free chunks, chunksPerBlock + 1 lists */
+    SlabBlock* freelist;
+} SlabContext;
+
+typedef struct GenerationContext {
+    MemoryContextData header; /* Standard memory-context fields */
+    GenerationBlock blocks;   /* head of list of blocks in this set */
+    char* reserve[ALLOCSET_NUM_FREELISTS];
+    Size initBlockSize;   /* initial block size */
+    Size maxBlockSize;    /* maximum block size */
+    Size nextBlockSize;   /* next block size to allocate */
+    Size allocChunkLimit; /* larger chunks get a block of their own */
+    GenerationBlock keeper; /* not used */
+    Size totalSpace;      /* all bytes allocated by this context */
+    Size freeSpace;       /* all bytes freed by this context */
+    Size maxSpaceSize;
+    MemoryTrack track; /* used to track the memory allocation information */
+    /* Generation specific fields: */
+    GenerationBlock block;     /* current block to allocate from */
+    GenerationBlock freeblock; /* an emptied block kept for reuse, if any */
+} GenerationContext;
+
 typedef struct MemoryProtectFuncDef {
     void* (*malloc)(Size sz);
     void (*free)(void* ptr, Size sz);
@@ -254,7 +315,8 @@ extern MemoryProtectFuncDef SharedFunctions;
     ((context) != NULL &&                                                                                             \
         (IsA((context), AllocSetContext) || IsA((context), AsanSetContext) || IsA((context), StackAllocSetContext) || \
             IsA((context), SharedAllocSetContext) || IsA((context), MemalignAllocSetContext) ||                       \
-            IsA((context), MemalignSharedAllocSetContext)))
+            IsA((context), MemalignSharedAllocSetContext) || IsA((context), SlabContext) ||                           \
+            IsA((context), GenerationContext)))
 
 #define AllocSetContextUsedSpace(aset) ((aset)->totalSpace - (aset)->freeSpace)
 
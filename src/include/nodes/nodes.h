@@ -313,6 +313,8 @@ typedef enum NodeTag {
     T_SharedAllocSetContext,
     T_MemalignAllocSetContext,
     T_MemalignSharedAllocSetContext,
+    T_SlabContext,
+    T_GenerationContext,
 
     T_MemoryTracking,
 
@@ -2016,7 +2016,8 @@ typedef struct Constraint {
     char* cooked_expr;  /* expr, as nodeToString representation */
 
     /* Fields used for unique constraints (UNIQUE and PRIMARY KEY) or cluster partial key for colstore: */
-    List* keys; /* String nodes naming referenced column(s) */
+    List* keys;      /* String nodes naming referenced column(s) */
+    List* including; /* String nodes naming the included column(s) of UNIQUE and PRIMARY KEY */
 
     /* Fields used for EXCLUSION constraints: */
     List* exclusions; /* list of (IndexElem, operator name) pairs */
@@ -2586,6 +2587,7 @@ typedef struct IndexStmt {
     char* accessMethod;         /* name of access method (eg. btree) */
     char* tableSpace;           /* tablespace, or NULL for default */
     List* indexParams;          /* columns to index: a list of IndexElem */
+    List* indexIncludingParams; /* additional columns to index: a list of IndexElem */
     List* options;              /* WITH clause options: a list of DefElem */
     Node* whereClause;          /* qualification (partial-index predicate) */
     List* excludeOpNames;       /* exclusion operator names, or NIL if none */
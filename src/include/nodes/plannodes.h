@@ -601,6 +601,10 @@ typedef struct TsStoreScan: public Scan {
  *
  * indexorderdir specifies the scan ordering, for indexscans on amcanorder
  * indexes (for other indexes it should be "don't care").
+ *
+ * indexskipscan asks a btree index to skip from one distinct value of the
+ * leading index column to the next, scanning each of them with the quals on
+ * the other columns, because indexqual leaves out the leading column.
  * ----------------
  */
 typedef struct IndexScan {
@@ -619,6 +623,7 @@ typedef struct IndexScan {
     List* cstorequal;            /* quals that can be pushdown to cstore base table */
     List* targetlist;            /* Hack for column store index, target list to be computed at this node */
     bool index_only_scan;
+    bool indexskipscan;          /* skip over the distinct values of the leading column */
 } IndexScan;
 
 /* ----------------
@@ -645,6 +650,7 @@ typedef struct IndexOnlyScan {
     List* indexorderby;          /* list of index ORDER BY exprs */
     List* indextlist;            /* TargetEntry list describing index's cols */
     ScanDirection indexorderdir; /* forward or backward or don't care */
+    bool indexskipscan;          /* skip over the distinct values of the leading column */
 } IndexOnlyScan;
 
 /* ----------------
@@ -670,6 +676,7 @@ typedef struct BitmapIndexScan {
     char* indexname;     /*	name of index to scan */
     List* indexqual;     /* list of index quals (OpExprs) */
     List* indexqualorig; /* the same in original form */
+    bool indexskipscan;  /* skip over the distinct values of the leading column */
 } BitmapIndexScan;
 
 /* ----------------
@@ -1123,6 +1130,7 @@ typedef struct WindowAgg {
     Node* startOffset;      /* expression for starting bound, if any */
     Node* endOffset;        /* expression for ending bound, if any */
     OpMemInfo mem_info;     /* Memory info for window agg with agg func */
+    bool is_sonicwindow;    /* evaluated by sonic window agg in vector engine */
 } WindowAgg;
 
 typedef struct VecWindowAgg : public WindowAgg {
@@ -1316,6 +1324,7 @@ typedef struct PartIterator {
      */
     int startPartitionId;   /* Used in parallel execution to record smp worker starting partition id. */
     int endPartitionId;     /* Used in parallel execution to record smp worker ending partition id.  */
+    List* pruningQuals;     /* quals of the scan with Params, to prune partitions at run time */
 } PartIterator;
 typedef struct GlobalPartIterator {
     int curItrs;
@@ -76,6 +76,10 @@ typedef struct ItstDisKey {
 typedef struct {
     int bloomfilter_index; /* Current bloomfilter Num */
     bool add_index;        /* If bloomfilter_index add 1. To eqClass equal member, it's filter index is alike. */
+    bool row_filter;       /* If row scans can take the runtime join filter. */
+    bool materialized;     /* If the search has passed a node that buffers or reshapes its input. */
+    double build_rows;     /* Estimated rows of the hash join inner side. */
+    double ratio;          /* Estimated ratio of probe rows kept by the current filter. */
 } bloomfilter_context;
 
 typedef struct PlannerContext {
@@ -626,7 +630,9 @@ typedef struct RelOptInfo {
  *		Per-index information for planning/optimization
  *
  *		indexkeys[], indexcollations[], opfamily[], and opcintype[]
- *		each have ncolumns entries.
+ *		each have ncolumns entries.  Only the first nkeycolumns of them
+ *		are key columns; the included columns after them have no opfamily,
+ *		collation nor sort order, and only serve index-only scans.
  *
  *		sortopfamily[], reverse_sort[], and nulls_first[] likewise have
  *		ncolumns entries, if the index is ordered; but if it is unordered,
@@ -662,6 +668,7 @@ typedef struct IndexOptInfo {
 
     /* index descriptor information */
     int ncolumns;         /* number of columns in index */
+    int nkeycolumns;      /* number of key columns in index */
     int* indexkeys;       /* column numbers of index's keys, or 0 */
     Oid* indexcollations; /* OIDs of collations of index columns */
     Oid* opfamily;        /* OIDs of operator families for columns */
@@ -945,6 +952,11 @@ typedef struct Path {
  * we need not recompute them when considering using the same index in a
  * bitmap index/heap scan (see BitmapHeapPath).  The costs of the IndexPath
  * itself represent the costs of an IndexScan or IndexOnlyScan plan type.
+ *
+ * 'indexskipscan' is set by btcostestimate when the indexquals leave out the
+ * leading index column and it found it cheaper to skip over the distinct
+ * values of that column than to scan the whole index.  The costs above are
+ * those of the skip scan then, so the plan built from the path must do one.
  * ----------
  */
 typedef struct IndexPath {
@@ -958,6 +970,7 @@ typedef struct IndexPath {
     ScanDirection indexscandir;
     Cost indextotalcost;
     Selectivity indexselectivity;
+    bool indexskipscan;
 } IndexPath;
 
 typedef struct PartIteratorPath {
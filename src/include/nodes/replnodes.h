@@ -89,6 +89,7 @@ typedef struct StartReplicationCmd {
     char* slotname;
     XLogRecPtr startpoint;
     List* options;
+    char* compression; /* compression of the WAL data messages, NULL if none */
 } StartReplicationCmd;
 
 /* ----------------------
@@ -97,6 +98,7 @@ typedef struct StartReplicationCmd {
  */
 typedef struct StartDataReplicationCmd {
     NodeTag type;
+    char* compression; /* compression of the data page messages, NULL if none */
 } StartDataReplicationCmd;
 
 /* ----------------------
@@ -38,6 +38,9 @@ struct ParamLoc {
     int scanKeyIndx;
 };
 
+extern Node* skipPartIterator(Node* node);
+extern bool getPartKeyScanKeys(Relation rel, Relation index, List* indexqual, int* partKeyScanKeys);
+
 class ScanFusion : public BaseObject {
 public:
     ScanFusion();
@@ -71,6 +74,11 @@ public:
     TupleDesc m_tupDesc;
 
     ScanDirection* m_direction;
+
+    /* the partition being scanned and its fake relation, NULL for a plain table */
+    Partition m_partition;
+
+    Relation m_partRel;
 };
 
 class IndexFusion : public ScanFusion {
@@ -98,6 +106,12 @@ public:
 
     bool EpqCheck(Datum* values, const bool* isnull);
 
+    void InitPartitionInfo(Scan* scan);
+
+    bool OpenPartition();
+
+    void ClosePartition();
+
     Relation m_index; /* index relation */
 
     Oid m_reloid; /* relation oid of range table */
@@ -127,6 +141,28 @@ public:
     List* m_targetList;
 
     int16* m_attrno; /* target attribute number, length is m_tupDesc->natts */
+
+    /*
+     * Partitioned table: the partition key is bound by equality scan keys, the
+     * partition to scan is routed from their values at each execution.
+     */
+    bool m_isPartTbl;
+
+    LOCKMODE m_partLockMode;
+
+    PruningResult* m_pruningInfo;
+
+    int m_partKeyNum;
+
+    int* m_partKeyScanKeys; /* scan key of each partition key column */
+
+    int m_partNum;
+
+    Oid* m_partIndexOids; /* index partition of each table partition, by sequence */
+
+    Partition m_indexPartition;
+
+    Relation m_partIndex; /* fake relation of m_indexPartition */
 };
 
 class IndexScanFusion : public IndexFusion {
@@ -96,7 +96,9 @@ enum FusionType {
     NOBYPASS_JUST_VAR_FOR_AGGARGS,
 
     NOBYPASS_JUST_MERGE_UNSUPPORTED,
-    NOBYPASS_JUST_VAR_ALLOWED_IN_SORT
+    NOBYPASS_JUST_VAR_ALLOWED_IN_SORT,
+
+    NOBYPASS_PARTITION_NOT_SUPPORT
 };
 
 enum FusionDebug {
@@ -114,6 +114,7 @@ extern void cost_windowagg(Path* path, PlannerInfo* root, List* windowFuncs, int
 extern void cost_group(Path* path, PlannerInfo* root, int numGroupCols, double numGroups, Cost input_startup_cost,
     Cost input_total_cost, double input_tuples);
 extern void cost_limit(Plan* plan, Plan* lefttree, int64 offset_est, int64 count_est);
+extern bool cost_runtime_join_filter(Plan* scan, double build_rows, double ratio);
 extern void initial_cost_nestloop(PlannerInfo* root, JoinCostWorkspace* workspace, JoinType jointype, Path* outer_path,
     Path* inner_path, SpecialJoinInfo* sjinfo, SemiAntiJoinFactors* semifactors, int dop);
 extern void final_cost_nestloop(PlannerInfo* root, NestPath* path, JoinCostWorkspace* workspace,
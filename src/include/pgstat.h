@@ -43,24 +43,16 @@ typedef enum StatMsgType {
     PGSTAT_MTYPE_DUMMY,
     PGSTAT_MTYPE_INQUIRY,
     PGSTAT_MTYPE_TABSTAT,
-    PGSTAT_MTYPE_TABPURGE,
     PGSTAT_MTYPE_DROPDB,
     PGSTAT_MTYPE_RESETCOUNTER,
     PGSTAT_MTYPE_RESETSHAREDCOUNTER,
     PGSTAT_MTYPE_RESETSINGLECOUNTER,
     PGSTAT_MTYPE_AUTOVAC_START,
-    PGSTAT_MTYPE_VACUUM,
-    PGSTAT_MTYPE_TRUNCATE,
-    PGSTAT_MTYPE_ANALYZE,
     PGSTAT_MTYPE_BGWRITER,
-    PGSTAT_MTYPE_FUNCSTAT,
-    PGSTAT_MTYPE_FUNCPURGE,
     PGSTAT_MTYPE_RECOVERYCONFLICT,
     PGSTAT_MTYPE_TEMPFILE,
     PGSTAT_MTYPE_DEADLOCK,
-    PGSTAT_MTYPE_AUTOVAC_STAT,
     PGSTAT_MTYPE_FILE,
-    PGSTAT_MTYPE_DATA_CHANGED,
     PGSTAT_MTYPE_MEMRESERVED,
     PGSTAT_MTYPE_BADBLOCK,
     PGSTAT_MTYPE_COLLECTWAITINFO,
@@ -80,7 +72,7 @@ typedef int64 PgStat_Counter;
  * This struct should contain only actual event counters, because we memcmp
  * it against zeroes to detect whether there are any counts to transmit.
  * It is a component of PgStat_TableStatus (within-backend state) and
- * PgStat_TableEntry (the transmitted message format).
+ * PgStat_MsgTabstat, where it carries the sums of a database.
  *
  * Note: for a table, tuples_returned is the number of tuples successfully
  * fetched by heap_getnext, while tuples_fetched is the number of tuples
@@ -211,51 +203,23 @@ typedef struct PgStat_MsgInquiry {
 } PgStat_MsgInquiry;
 
 /* ----------
- * PgStat_TableEntry			Per-table info in a MsgTabstat
+ * PgStat_MsgTabstat			Sent by the backend to report the database-wide
+ *								sums of its table and buffer access statistics.
+ *								The per-table counts themselves go straight to
+ *								the shared table statistics hash.
  * ----------
  */
-typedef struct PgStat_TableEntry {
-    Oid t_id;
-    uint32 t_statFlag;
-    PgStat_TableCounts t_counts;
-} PgStat_TableEntry;
-
-/* ----------
- * PgStat_MsgTabstat			Sent by the backend to report table
- *								and buffer access statistics.
- * ----------
- */
-#define PGSTAT_NUM_TABENTRIES ((PGSTAT_MSG_PAYLOAD - sizeof(Oid) - 3 * sizeof(int)) / sizeof(PgStat_TableEntry))
-
 typedef struct PgStat_MsgTabstat {
     PgStat_MsgHdr m_hdr;
     Oid m_databaseid;
-    int m_nentries;
+    int m_ntables; /* number of tables summed up in m_counts */
     int m_xact_commit;
     int m_xact_rollback;
     PgStat_Counter m_block_read_time; /* times in microseconds */
     PgStat_Counter m_block_write_time;
-    PgStat_TableEntry m_entry[PGSTAT_NUM_TABENTRIES];
+    PgStat_TableCounts m_counts;
 } PgStat_MsgTabstat;
 
-/* ----------
- * PgStat_MsgTabpurge			Sent by the backend to tell the collector
- *								about dead tables.
- * ----------
- */
-typedef struct PgStat_MsgTabEntry {
-    Oid m_tableid;
-    uint32 m_statFlag;
-} PgStat_MsgTabEntry;
-#define PGSTAT_NUM_TABPURGE ((PGSTAT_MSG_PAYLOAD - sizeof(Oid) - sizeof(int)) / sizeof(PgStat_MsgTabEntry))
-
-typedef struct PgStat_MsgTabpurge {
-    PgStat_MsgHdr m_hdr;
-    Oid m_databaseid;
-    int m_nentries;
-    PgStat_MsgTabEntry m_entry[PGSTAT_NUM_TABPURGE];
-} PgStat_MsgTabpurge;
-
 /* ----------
  * PgStat_MsgDropdb				Sent by the backend to tell the collector
  *								about a dropped database
@@ -310,81 +274,11 @@ typedef struct PgStat_MsgAutovacStart {
     TimestampTz m_start_time;
 } PgStat_MsgAutovacStart;
 
-/* ----------
- * PgStat_MsgVacuum				Sent by the backend or autovacuum daemon
- *								after VACUUM
- * ----------
- */
-typedef struct PgStat_MsgVacuum {
-    PgStat_MsgHdr m_hdr;
-    Oid m_databaseid;
-    Oid m_tableoid;
-    uint32 m_statFlag;
-    bool m_autovacuum;
-    TimestampTz m_vacuumtime;
-    PgStat_Counter m_tuples;
-} PgStat_MsgVacuum;
-
-/* ----------
- * PgStat_MsgIUD                             Sent by the insert/delete/update
- * ----------
- */
-typedef struct PgStat_MsgDataChanged {
-    PgStat_MsgHdr m_hdr;
-    Oid m_databaseid;
-    Oid m_tableoid;
-    uint32 m_statFlag;
-    TimestampTz m_changed_time;
-} PgStat_MsgDataChanged;
-
-/* ----------
- * PgStat_MsgAvStat	Sent autovac stat to collector
- *				Reset by
- * ----------
- */
+/* autovac stat of a table */
 #define AV_TIMEOUT (1 << 0) /* autovac have been canceled due to timeout */
 #define AV_ANALYZE (1 << 1) /* is doing auto-analyze */
 #define AV_VACUUM (1 << 2)  /* is doing auto-vacuum */
 
-typedef struct PgStat_MsgAutovacStat {
-    PgStat_MsgHdr m_hdr;
-    Oid m_databaseid;
-    Oid m_tableoid;
-    uint32 m_statFlag;
-    int64 m_autovacStat;
-} PgStat_MsgAutovacStat;
-
-/* ----------
- * PgStat_MsgTruncate				Sent by the truncate
- * ----------
- */
-typedef struct PgStat_MsgTruncate {
-    PgStat_MsgHdr m_hdr;
-    Oid m_databaseid;
-    Oid m_tableoid;
-    /*
-     * if m_tableoid is partition oid, then m_statFlag is the corresponding
-     * partitioned table oid, else it is InvalidOId
-     */
-    uint32 m_statFlag;
-} PgStat_MsgTruncate;
-
-/* ----------
- * PgStat_MsgAnalyze			Sent by the backend or autovacuum daemon
- *								after ANALYZE
- * ----------
- */
-typedef struct PgStat_MsgAnalyze {
-    PgStat_MsgHdr m_hdr;
-    Oid m_databaseid;
-    Oid m_tableoid;
-    uint32 m_statFlag;
-    bool m_autovacuum;
-    TimestampTz m_analyzetime;
-    PgStat_Counter m_live_tuples;
-    PgStat_Counter m_dead_tuples;
-} PgStat_MsgAnalyze;
-
 /* ----------
  * PgStat_MsgBgWriter			Sent by the bgwriter to update statistics.
  * ----------
@@ -444,7 +338,7 @@ typedef struct PgStat_MsgMemReserved {
  * it against zeroes to detect whether there are any counts to transmit.
  *
  * Note that the time counters are in instr_time format here.  We convert to
- * microseconds in PgStat_Counter format when transmitting to the collector.
+ * microseconds in PgStat_Counter format when flushing to shared memory.
  * ----------
  */
 typedef struct PgStat_FunctionCounts {
@@ -462,45 +356,6 @@ typedef struct PgStat_BackendFunctionEntry {
     PgStat_FunctionCounts f_counts;
 } PgStat_BackendFunctionEntry;
 
-/* ----------
- * PgStat_FunctionEntry			Per-function info in a MsgFuncstat
- * ----------
- */
-typedef struct PgStat_FunctionEntry {
-    Oid f_id;
-    PgStat_Counter f_numcalls;
-    PgStat_Counter f_total_time; /* times in microseconds */
-    PgStat_Counter f_self_time;
-} PgStat_FunctionEntry;
-
-/* ----------
- * PgStat_MsgFuncstat			Sent by the backend to report function
- *								usage statistics.
- * ----------
- */
-#define PGSTAT_NUM_FUNCENTRIES ((PGSTAT_MSG_PAYLOAD - sizeof(Oid) - sizeof(int)) / sizeof(PgStat_FunctionEntry))
-
-typedef struct PgStat_MsgFuncstat {
-    PgStat_MsgHdr m_hdr;
-    Oid m_databaseid;
-    int m_nentries;
-    PgStat_FunctionEntry m_entry[PGSTAT_NUM_FUNCENTRIES];
-} PgStat_MsgFuncstat;
-
-/* ----------
- * PgStat_MsgFuncpurge			Sent by the backend to tell the collector
- *								about dead functions.
- * ----------
- */
-#define PGSTAT_NUM_FUNCPURGE ((PGSTAT_MSG_PAYLOAD - sizeof(Oid) - sizeof(int)) / sizeof(Oid))
-
-typedef struct PgStat_MsgFuncpurge {
-    PgStat_MsgHdr m_hdr;
-    Oid m_databaseid;
-    int m_nentries;
-    Oid m_functionid[PGSTAT_NUM_FUNCPURGE];
-} PgStat_MsgFuncpurge;
-
 /* ----------
  * PgStat_MsgDeadlock			Sent by the backend to tell the collector
  *								about a deadlock that occurred.
@@ -587,18 +442,12 @@ typedef union PgStat_Msg {
     PgStat_MsgDummy msg_dummy;
     PgStat_MsgInquiry msg_inquiry;
     PgStat_MsgTabstat msg_tabstat;
-    PgStat_MsgTabpurge msg_tabpurge;
     PgStat_MsgDropdb msg_dropdb;
     PgStat_MsgResetcounter msg_resetcounter;
     PgStat_MsgResetsharedcounter msg_resetsharedcounter;
     PgStat_MsgResetsinglecounter msg_resetsinglecounter;
     PgStat_MsgAutovacStart msg_autovacuum;
-    PgStat_MsgVacuum msg_vacuum;
-    PgStat_MsgTruncate msg_truncate;
-    PgStat_MsgAnalyze msg_analyze;
     PgStat_MsgBgWriter msg_bgwriter;
-    PgStat_MsgFuncstat msg_funcstat;
-    PgStat_MsgFuncpurge msg_funcpurge;
     PgStat_MsgRecoveryConflict msg_recoveryconflict;
     PgStat_MsgDeadlock msg_deadlock;
     PgStat_MsgFile msg_file;
@@ -613,7 +462,7 @@ typedef union PgStat_Msg {
  * data structures change.
  * ------------------------------------------------------------
  */
-#define PGSTAT_FILE_FORMAT_ID 0x01A5BC9B
+#define PGSTAT_FILE_FORMAT_ID 0x01A5BC9C
 
 /* ----------
  * PgStat_StatDBEntry			The collector's data per database
@@ -649,13 +498,6 @@ typedef struct PgStat_StatDBEntry {
     PgStat_Counter n_mem_mbytes_reserved;
 
     TimestampTz stat_reset_timestamp;
-
-    /*
-     * tables and functions must be last in the struct, because we don't write
-     * the pointers out to the stats file.
-     */
-    HTAB* tables;
-    HTAB* functions;
 } PgStat_StatDBEntry;
 
 typedef enum PgStat_StatTabType {
@@ -750,6 +592,36 @@ typedef struct PgStat_StatFuncEntry {
     PgStat_Counter f_self_time;
 } PgStat_StatFuncEntry;
 
+/* ----------
+ * PgStat_SharedTabEntry		Entry of the shared table statistics hash.
+ *								Backends add their counts to it directly;
+ *								databaseid is InvalidOid for shared tables.
+ * ----------
+ */
+typedef struct PgStat_SharedTabKey {
+    Oid databaseid;
+    PgStat_StatTabKey tabkey;
+} PgStat_SharedTabKey;
+
+typedef struct PgStat_SharedTabEntry {
+    PgStat_SharedTabKey key;
+    PgStat_StatTabEntry tabentry;
+} PgStat_SharedTabEntry;
+
+/* ----------
+ * PgStat_SharedFuncEntry		Entry of the shared function statistics hash
+ * ----------
+ */
+typedef struct PgStat_SharedFuncKey {
+    Oid databaseid;
+    Oid functionid;
+} PgStat_SharedFuncKey;
+
+typedef struct PgStat_SharedFuncEntry {
+    PgStat_SharedFuncKey key;
+    PgStat_StatFuncEntry funcentry;
+} PgStat_SharedFuncEntry;
+
 /*
  * Global statistics kept in the stats collector
  */
@@ -1730,6 +1602,8 @@ extern void pgstat_send_bgwriter(void);
  */
 extern PgStat_StatDBEntry* pgstat_fetch_stat_dbentry(Oid dbid);
 extern PgStat_StatTabEntry* pgstat_fetch_stat_tabentry(PgStat_StatTabKey* tabkey);
+extern PgStat_StatTabEntry* pgstat_fetch_stat_tabentry_db(Oid dbid, PgStat_StatTabKey* tabkey);
+extern HTAB* pgstat_fetch_stat_tabhash(Oid dbid);
 extern PgBackendStatus* pgstat_fetch_stat_beentry(int beid);
 extern PgStat_StatFuncEntry* pgstat_fetch_stat_funcentry(Oid funcid);
 extern int pgstat_fetch_stat_numbackends(void);
@@ -72,6 +72,17 @@ typedef struct {
     bool catchup;
 } DataPageMessageHeader;
 
+/*
+ * Header for a compressed data replication message (message type 'c'), sent
+ * instead of 'd' when the standby asked for a compressed stream.  It is
+ * followed by the LZ4 compressed data page, rawLen is the length of the data
+ * once decompressed.
+ */
+typedef struct {
+    DataPageMessageHeader header;
+    uint32 rawLen;
+} DataPageCompressedMessageHeader;
+
 /*
  * Keepalive message from primary (message type 'k'). (lowercase k)
  * This is wrapped within a CopyData message at the FE/BE protocol level.
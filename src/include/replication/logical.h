@@ -43,6 +43,19 @@ typedef struct LogicalDecodingContext {
      */
     bool fast_forward;
 
+    /*
+     * Does the output plugin stream in-progress transactions?  Set when the
+     * plugin has all the stream callbacks, the plugin may clear it in its
+     * startup callback.
+     */
+    bool streaming;
+
+    /*
+     * Parallel decoding workers of a walsender, NULL if all transactions are
+     * decoded by this context.
+     */
+    struct ParallelDecodeCtl* parallel;
+
     OutputPluginCallbacks callbacks;
     OutputPluginOptions options;
 
@@ -96,6 +109,8 @@ extern LogicalDecodingContext* CreateDecodingContext(XLogRecPtr start_lsn, List*
     LogicalOutputPluginWriterWrite do_write);
 extern void DecodingContextFindStartpoint(LogicalDecodingContext* ctx);
 extern bool DecodingContextReady(LogicalDecodingContext* ctx);
+extern LogicalDecodingContext* CreateParallelDecodingContext(ReplicationSlot* slot, List* output_plugin_options,
+    LogicalOutputPluginWriterPrepareWrite prepare_write, LogicalOutputPluginWriterWrite do_write);
 extern void FreeDecodingContext(LogicalDecodingContext* ctx);
 
 extern void LogicalIncreaseXminForSlot(XLogRecPtr lsn, TransactionId xmin);
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * parallel_decode.h
+ *        Parallel decoding workers of a logical walsender.
+ *
+ * IDENTIFICATION
+ *        src/include/replication/parallel_decode.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#ifndef PARALLEL_DECODE_H
+#define PARALLEL_DECODE_H
+
+#include "access/xlogdefs.h"
+#include "fmgr.h"
+#include "storage/latch.h"
+
+/* Version control for parallel decoding, pg_stat_get_parallel_decode comes with this version */
+#define PARALLEL_DECODE_VERSION_NUM 92076
+
+/* upper limit of logical_decoding_parallel_workers */
+#define MAX_PARALLEL_DECODE_WORKERS 20
+
+/* transactions queued per decoding worker */
+#define PARALLEL_DECODE_QUEUE_SIZE 64
+
+/*
+ * Progress of one stage of the decoding pipeline of a logical walsender,
+ * written by the thread running the stage only.
+ *
+ * reader:    WAL records read, WAL bytes read, open transactions
+ * decoder:   transactions decoded, change bytes decoded, queued transactions
+ * committer: messages sent, bytes sent, transactions waiting for their output
+ */
+typedef struct ParallelDecodeStageStats {
+    volatile uint64 processed;
+    volatile uint64 processed_bytes;
+    volatile XLogRecPtr lsn;
+    volatile uint32 queue_depth;
+} ParallelDecodeStageStats;
+
+/* decoding statistics of a logical walsender, kept in its WalSnd */
+typedef struct ParallelDecodeStats {
+    volatile bool active; /* a logical slot is being decoded */
+    NameData slot_name;
+    volatile int nworkers; /* 0 if the walsender decodes by itself */
+    ParallelDecodeStageStats reader;
+    ParallelDecodeStageStats committer;
+    ParallelDecodeStageStats decoders[MAX_PARALLEL_DECODE_WORKERS];
+} ParallelDecodeStats;
+
+struct LogicalDecodingContext;
+
+extern void ParallelDecodeStart(
+    struct LogicalDecodingContext* ctx, int nworkers, Latch* latch, ParallelDecodeStats* stats);
+extern void ParallelDecodeStop(struct LogicalDecodingContext* ctx);
+extern void ParallelDecodeEmit(struct LogicalDecodingContext* ctx, bool wait);
+extern XLogRecPtr ParallelDecodeOldestPendingLSN(struct LogicalDecodingContext* ctx);
+extern void ParallelDecodeWorkerMain(void* arg);
+
+extern Datum pg_stat_get_parallel_decode(PG_FUNCTION_ARGS);
+
+#endif /* PARALLEL_DECODE_H */
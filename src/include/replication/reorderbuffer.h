@@ -14,6 +14,7 @@
 #define REORDERBUFFER_H
 
 #include "lib/ilist.h"
+#include "lib/stringinfo.h"
 
 #include "storage/sinval.h"
 
@@ -24,12 +25,9 @@
 
 /* an individual tuple, stored in one chunk of memory */
 typedef struct ReorderBufferTupleBuf {
-    /* position in preallocated list */
-    slist_node node;
-
     /* tuple header, the interesting bit for users of logical decoding */
     HeapTupleData tuple;
-    /* pre-allocated size of tuple buffer, different from tuple size */
+    /* allocated size of tuple buffer, may be larger than the tuple */
     Size alloc_tuple_size;
 
     /* actual tuple data follows */
@@ -67,6 +65,9 @@ typedef struct ReorderBufferChange {
     /* The type of change. */
     enum ReorderBufferChangeType action;
 
+    /* Transaction this change belongs to, used for memory accounting. */
+    struct ReorderBufferTXN* txn;
+
     RepOriginId origin_id;
 
     /*
@@ -205,6 +206,24 @@ typedef struct ReorderBufferTXN {
      */
     bool serialized;
 
+    /*
+     * Have some changes of this transaction already been streamed to the
+     * output plugin before its commit?  Then its remaining changes go out as
+     * another streamed block at commit, followed by stream_commit, and an
+     * abort is reported by stream_abort.
+     */
+    bool streamed;
+
+    /*
+     * Snapshot and command id the last streamed block ended with, so the next
+     * block continues from there.  NULL if the base snapshot is still valid.
+     */
+    Snapshot stream_snapshot;
+    CommandId stream_command_id;
+
+    /* Memory used by the changes of this (sub)transaction kept in memory. */
+    Size size;
+
     /*
      * List of ReorderBufferChange structs, including new Snapshots and new
      * CommandIds
@@ -267,6 +286,23 @@ typedef void (*ReorderBufferBeginCB)(ReorderBuffer* rb, ReorderBufferTXN* txn);
 /* commit callback signature */
 typedef void (*ReorderBufferCommitCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 
+/* start/stop of a block of streamed changes of an in-progress transaction */
+typedef void (*ReorderBufferStreamStartCB)(ReorderBuffer* rb, ReorderBufferTXN* txn);
+typedef void (*ReorderBufferStreamStopCB)(ReorderBuffer* rb, ReorderBufferTXN* txn);
+
+/* abort and commit of a transaction that has been streamed */
+typedef void (*ReorderBufferStreamAbortCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+typedef void (*ReorderBufferStreamCommitCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
+
+/*
+ * hand a committed transaction over to a parallel decoder, returns false if
+ * it has to be decoded here
+ */
+typedef bool (*ReorderBufferDispatchCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
+
+/* wait until everything handed over to the parallel decoders has been output */
+typedef void (*ReorderBufferDrainCB)(ReorderBuffer* rb);
+
 struct ReorderBuffer {
     /*
      * xid => ReorderBufferTXN lookup table
@@ -302,6 +338,30 @@ struct ReorderBuffer {
     ReorderBufferApplyChangeCB apply_change;
     ReorderBufferCommitCB commit;
 
+    /*
+     * Callbacks to stream the changes of in-progress transactions, used when
+     * the decoding context allows streaming.
+     */
+    ReorderBufferStreamStartCB stream_start;
+    ReorderBufferStreamStopCB stream_stop;
+    ReorderBufferApplyChangeCB stream_change;
+    ReorderBufferStreamAbortCB stream_abort;
+    ReorderBufferStreamCommitCB stream_commit;
+
+    /*
+     * Callbacks of parallel decoding, NULL when all transactions are decoded
+     * by the owner of the reorder buffer.  Output created here is preceded by
+     * a drain, so transactions still go out in commit order.
+     */
+    ReorderBufferDispatchCB dispatch;
+    ReorderBufferDrainCB drain;
+
+    /*
+     * Bumped whenever cache invalidations are executed, the parallel decoders
+     * reset their caches when they see it change.
+     */
+    uint64 invalidation_epoch;
+
     /*
      * Pointer that will be passed untouched to the callbacks.
      */
@@ -313,32 +373,23 @@ struct ReorderBuffer {
     MemoryContext context;
 
     /*
-     * Data structure slab cache.
-     *
-     * We allocate/deallocate some structures very frequently, to avoid bigger
-     * overhead we cache some unused ones here.
-     *
-     * The maximum number of cached entries is controlled by const variables
-     * ontop of reorderbuffer.c
+     * Memory contexts for the structures allocated and freed most often:
+     * slab contexts for the fixed-size changes and transactions, and a
+     * generation context for the tuples, which are mostly freed in the
+     * order they are decoded.
      */
-
-    /* cached ReorderBufferTXNs */
-    dlist_head cached_transactions;
-    Size nr_cached_transactions;
-
-    /* cached ReorderBufferChanges */
-    dlist_head cached_changes;
-    Size nr_cached_changes;
-
-    /* cached ReorderBufferTupleBufs */
-    slist_head cached_tuplebufs;
-    Size nr_cached_tuplebufs;
+    MemoryContext change_context;
+    MemoryContext txn_context;
+    MemoryContext tup_context;
 
     XLogRecPtr current_restart_decoding_lsn;
 
     /* buffer for disk<->memory conversions */
     char* outbuf;
     Size outbufsize;
+
+    /* memory used by the changes kept in memory, see logical_decoding_work_mem */
+    Size size;
 };
 
 ReorderBuffer* ReorderBufferAllocate(void);
@@ -353,6 +404,9 @@ void ReorderBufferQueueChange(ReorderBuffer*, TransactionId, XLogRecPtr lsn, Reo
 void ReorderBufferCommit(ReorderBuffer*, TransactionId, XLogRecPtr commit_lsn, XLogRecPtr end_lsn,
     RepOriginId origin_id, CommitSeqNo csn, TimestampTz commit_time);
 void ReorderBufferAssignChild(ReorderBuffer*, TransactionId, TransactionId, XLogRecPtr commit_lsn);
+void ReorderBufferSerializeCommittedTXN(ReorderBuffer*, ReorderBufferTXN* txn, StringInfo buf);
+void ReorderBufferCommitSerializedTXN(ReorderBuffer*, TransactionId, XLogRecPtr first_lsn, XLogRecPtr commit_lsn,
+    XLogRecPtr end_lsn, RepOriginId origin_id, CommitSeqNo csn, TimestampTz commit_time, const char* data, Size len);
 void ReorderBufferCommitChild(ReorderBuffer*, TransactionId, TransactionId, XLogRecPtr commit_lsn, XLogRecPtr end_lsn);
 void ReorderBufferAbort(ReorderBuffer*, TransactionId, XLogRecPtr lsn);
 void ReorderBufferAbortOld(ReorderBuffer*, TransactionId xid);
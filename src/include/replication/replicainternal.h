@@ -22,6 +22,12 @@
 #define IP_LEN 64
 #define PG_PROTOCOL_VERSION "MPPDB"
 
+/* compression method of the replication streams, see START_REPLICATION */
+#define REPL_COMPRESSION_LZ4 "lz4"
+
+/* Version control for compressed replication streams, older senders reject the option */
+#define STREAM_COMPRESSION_VERSION_NUM 92077
+
 /* Notice: the value is same sa GUC_MAX_REPLNODE_NUM */
 #ifdef ENABLE_MULTIPLE_NODES
 #define MAX_REPLNODE_NUM 8
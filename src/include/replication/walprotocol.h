@@ -109,6 +109,17 @@ typedef struct {
     bool catchup;
 } WalDataMessageHeader;
 
+/*
+ * Header for a compressed WAL data message (message type 'z'), sent instead
+ * of 'w' when the standby asked for a compressed stream.  It is followed by
+ * the LZ4 compressed WAL data, rawLen is the length of the data once
+ * decompressed.
+ */
+typedef struct {
+    WalDataMessageHeader header;
+    uint32 rawLen;
+} WalCompressedDataMessageHeader;
+
 /*
  * Header for a data replication message (message type 'd').  This is wrapped within
  * a CopyData message at the FE/BE protocol level.
@@ -14,6 +14,7 @@
 
 #include "access/xlog.h"
 #include "nodes/nodes.h"
+#include "replication/parallel_decode.h"
 #include "replication/replicainternal.h"
 #include "replication/syncrep.h"
 #include "replication/repl_gramparse.h"
@@ -95,6 +96,15 @@ typedef struct WalSnd {
     ReplConnInfo wal_sender_channel;
     int channel_get_replc;
 
+    /*
+     * Compression of the WAL stream: WAL bytes sent before and after the
+     * compression, and the time spent compressing them in microseconds.
+     */
+    bool compression;
+    uint64 raw_bytes;
+    uint64 compressed_bytes;
+    uint64 compress_time;
+
     /* Protects shared variables shown above. */
     slock_t mutex;
 
@@ -113,6 +123,9 @@ typedef struct WalSnd {
     int index;
 
     LogCtrlData log_ctrl;
+
+    /* progress of logical decoding, see pg_stat_get_parallel_decode */
+    ParallelDecodeStats decode_stats;
 } WalSnd;
 
 extern THR_LOCAL WalSnd* MyWalSnd;
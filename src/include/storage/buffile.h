@@ -35,6 +35,7 @@ typedef struct BufFile BufFile;
  */
 
 extern BufFile* BufFileCreateTemp(bool interXact);
+extern BufFile* BufFileCreateTempCompress(bool interXact, int64* rawSize, int64* compressSize);
 extern void BufFileClose(BufFile* file);
 extern size_t BufFileRead(BufFile* file, void* ptr, size_t size);
 extern size_t BufFileWrite(BufFile* file, void* ptr, size_t size);
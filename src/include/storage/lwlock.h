@@ -73,6 +73,9 @@ extern const char *const MainLWLockNames[];
 /* Number of partions the global plan cache hashtable */
 #define NUM_GPC_PARTITIONS 128
 
+/* Number of partions the shared table and function statistics hashtables */
+#define NUM_PGSTAT_PARTITIONS 64
+
 /*
  * WARNING---Please keep the order of LWLockTrunkOffset and BuiltinTrancheIds consistent!!!
  */
@@ -96,9 +99,11 @@ enum LWLockTrunkOffset {
     /* global plan cache */
     FirstGPCMappingLock = FirstInstrUserLock + NUM_INSTR_USER_PARTITIONS,
     FirstGPCPrepareMappingLock = FirstGPCMappingLock + NUM_GPC_PARTITIONS,
+    /* shared table and function statistics */
+    FirstPgStatMappingLock = FirstGPCPrepareMappingLock + NUM_GPC_PARTITIONS,
 
     /* must be last: */
-    NumFixedLWLocks = FirstGPCPrepareMappingLock + NUM_GPC_PARTITIONS,
+    NumFixedLWLocks = FirstPgStatMappingLock + NUM_PGSTAT_PARTITIONS,
 };
 
 /*
@@ -125,6 +130,7 @@ enum BuiltinTrancheIds {
     LWTRANCHE_INSTR_USER,
     LWTRANCHE_GPC_MAPPING,
     LWTRANCHE_GPC_PREPARE_MAPPING,
+    LWTRANCHE_PGSTAT_MAPPING,
     LWTRANCHE_BUFFER_IO_IN_PROGRESS,
     LWTRANCHE_BUFFER_CONTENT,
     LWTRANCHE_DATA_CACHE,
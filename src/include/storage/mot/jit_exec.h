@@ -54,6 +54,9 @@ extern bool IsMotPseudoCodegenForced();
 /** @brief Queries whether informative printing is enabled for MOT JIT compilation. */
 extern bool IsMotCodegenPrintEnabled();
 
+/** @brief Queries whether MOT JIT compilation and execution is enabled for the queries of stored procedures. */
+extern bool IsMotProcedureCodegenEnabled();
+
 /** @brief Queries for the per-session limit of JIT queries. */
 extern uint32_t GetMotCodegenLimit();
 
@@ -28,7 +28,20 @@
 #include "access/xlogreader.h"
 #include "lib/stringinfo.h"
 
+/* upper limit of the MOT redo_recovery_workers setting */
+#define MOT_MAX_REDO_WORKERS 32
+
+/* replay progress of one MOT redo replay worker, see redo_statistic */
+typedef struct MOTRedoWorkerStats {
+    uint32 id;
+    uint64 queued;   /* committed transactions waiting for the worker */
+    uint64 replayed; /* transactions replayed by the worker */
+    XLogRecPtr dispatched_lsn;
+    XLogRecPtr replayed_lsn;
+} MOTRedoWorkerStats;
+
 extern void MOTRedo(XLogReaderState *record);
 extern void MOTDesc(StringInfo buf, XLogReaderState *record);
+extern uint32 MOTGetRedoWorkerStats(MOTRedoWorkerStats *stats, uint32 maxWorkers);
 
 #endif /* MOT_XLOG_H */
@@ -100,6 +100,8 @@ private:
     void GetInstanceBind();
     bool CheckCpuBind() const;
     void ConstrainThreadNum();
+    int GetNumaDistance(int numaA, int numaB) const;
+    void InitStealVictims();
 
 private:
     MemoryContext m_threadPoolContext;
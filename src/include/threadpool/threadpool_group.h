@@ -33,6 +33,17 @@
 #define NUM_THREADPOOL_STATUS_ELEM 7
 #define STATUS_INFO_SIZE 256
 
+/*
+ * A group only steals ready sessions from a group that has at least
+ * thread_pool_steal_threshold sessions waiting, scaled by the NUMA distance
+ * between the two groups, so the cost of running a session away from its
+ * memory is paid only under real load.
+ */
+#define THREAD_STEAL_LOCAL_DISTANCE 10
+
+/* a session stolen this many times in a row moves to the stealing group */
+#define THREAD_MIGRATE_STEAL_TIMES 4
+
 typedef enum { WORKER_SLOT_UNUSE = 0, WORKER_SLOT_INUSE } WorkerSlotStatus;
 
 typedef struct WorkerStatus {
@@ -76,6 +87,10 @@ public:
     float4 GetSessionPerThread();
     void GetThreadPoolGroupStat(ThreadPoolStat* stat);
     bool IsGroupHang();
+    void SetStealVictims(ThreadPoolGroup** victims, int* thresholds, int victimNum);
+    knl_session_context* StealSession();
+    void StealForIdleWorkers();
+    void CountMigration();
 
     inline ThreadPoolListener* GetListener()
     {
@@ -127,12 +142,19 @@ private:
     volatile int m_sessionCount;           // all session count;
     volatile int m_waitServeSessionCount;  // wait for worker to server
     volatile int m_processTaskCount;
+    volatile uint32 m_stealCount;          // sessions served for other groups
+    volatile uint32 m_migrateCount;        // sessions moved in from other groups
 
     int m_groupId;
     int m_numaId;
     int m_groupCpuNum;
     int* m_groupCpuArr;
 
+    /* groups to steal from, nearest NUMA node first, and their waiting thresholds */
+    ThreadPoolGroup** m_stealVictims;
+    int* m_stealThresholds;
+    int m_stealVictimNum;
+
     ThreadWorkerSentry* m_workers;
     MemoryContext m_context;
     pthread_mutex_t m_mutex;
@@ -47,6 +47,9 @@ public:
     void DelSessionFromEpoll(knl_session_context* session);
     void RemoveWorkerFromList(ThreadPoolWorker* worker);
     void AddEpoll(knl_session_context* session);
+    knl_session_context* StealReadySession();
+    void FeedSession(knl_session_context* session);
+    bool MigrateSession(knl_session_context* session);
     void SendShutDown();
     void ReaperAllSession();
 
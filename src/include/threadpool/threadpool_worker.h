@@ -121,6 +121,7 @@ private:
     void CleanThread();
     bool AttachSessionToThread();
     void DetachSessionFromThread();
+    void ReturnSessionToListener();
     void WaitNextSession();
     bool InitPort(Port* port);
     void FreePort(Port* port);
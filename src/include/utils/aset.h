@@ -208,6 +208,89 @@ private:
     static void AllocSetMethodDefinition(MemoryContextMethods* method);
 };
 
+// an allocator for chunks of one fixed size, see @SlabContext
+class SlabMemoryAllocator {
+public:
+    static MemoryContext SlabContextCreate(_in_ MemoryContext parent, _in_ const char* name, _in_ Size blockSize,
+        _in_ Size chunkSize, _in_ bool isSession);
+
+    template <bool memoryprotect_enable, bool is_tracked>
+    static void* SlabAlloc(
+        _in_ MemoryContext context, _in_ Size align, _in_ Size size, _in_ const char* file, _in_ int line);
+
+    template <bool memoryprotect_enable, bool is_tracked>
+    static void SlabFree(_in_ MemoryContext context, _in_ void* pointer);
+
+    static void* SlabRealloc(_in_ MemoryContext context, _in_ void* pointer, _in_ Size align, _in_ Size size,
+        _in_ const char* file, _in_ int line);
+
+    static void SlabInit(_in_ MemoryContext context);
+
+    template <bool memoryprotect_enable, bool is_tracked>
+    static void SlabReset(_in_ MemoryContext context);
+
+    template <bool memoryprotect_enable, bool is_tracked>
+    static void SlabDelete(_in_ MemoryContext context);
+
+    static Size SlabGetChunkSpace(_in_ MemoryContext context, _in_ void* pointer);
+
+    static bool SlabIsEmpty(_in_ MemoryContext context);
+
+    static void SlabStats(_in_ MemoryContext context, _in_ int level);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+    static void SlabCheck(_in_ MemoryContext context);
+#endif
+
+private:
+    static void SlabContextSetMethods(_in_ unsigned long value, MemoryContextMethods* method);
+
+    template <bool memoryprotect_enable, bool is_tracked>
+    static void SlabMethodDefinition(MemoryContextMethods* method);
+};
+
+// an allocator for chunks freed in about the order they were allocated, see @GenerationContext
+class GenerationMemoryAllocator {
+public:
+    static MemoryContext GenerationContextCreate(_in_ MemoryContext parent, _in_ const char* name,
+        _in_ Size initBlockSize, _in_ Size maxBlockSize, _in_ bool isSession);
+
+    template <bool memoryprotect_enable, bool is_tracked>
+    static void* GenerationAlloc(
+        _in_ MemoryContext context, _in_ Size align, _in_ Size size, _in_ const char* file, _in_ int line);
+
+    template <bool memoryprotect_enable, bool is_tracked>
+    static void GenerationFree(_in_ MemoryContext context, _in_ void* pointer);
+
+    template <bool memoryprotect_enable, bool is_tracked>
+    static void* GenerationRealloc(_in_ MemoryContext context, _in_ void* pointer, _in_ Size align, _in_ Size size,
+        _in_ const char* file, _in_ int line);
+
+    static void GenerationInit(_in_ MemoryContext context);
+
+    template <bool memoryprotect_enable, bool is_tracked>
+    static void GenerationReset(_in_ MemoryContext context);
+
+    template <bool memoryprotect_enable, bool is_tracked>
+    static void GenerationDelete(_in_ MemoryContext context);
+
+    static Size GenerationGetChunkSpace(_in_ MemoryContext context, _in_ void* pointer);
+
+    static bool GenerationIsEmpty(_in_ MemoryContext context);
+
+    static void GenerationStats(_in_ MemoryContext context, _in_ int level);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+    static void GenerationCheck(_in_ MemoryContext context);
+#endif
+
+private:
+    static void GenerationContextSetMethods(_in_ unsigned long value, MemoryContextMethods* method);
+
+    template <bool memoryprotect_enable, bool is_tracked>
+    static void GenerationMethodDefinition(MemoryContextMethods* method);
+};
+
 class MemoryProtectFunctions {
 public:
     template <MemType mem_type>
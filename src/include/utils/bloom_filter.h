@@ -35,6 +35,8 @@
         dataType == FLOAT8OID || dataType == VARCHAROID || dataType == BPCHAROID || dataType == TEXTOID || \
         dataType == CLOBOID)
 #define DEFAULT_ORC_BLOOM_FILTER_ENTRIES 10000
+/* max rows of a hash join inner side that a runtime join filter is built from */
+#define RUNTIME_JOIN_FILTER_MAX_ROWS (DEFAULT_ORC_BLOOM_FILTER_ENTRIES * 5)
 #define MAX_HASH_FUNCTIONS 4
 #define LSB_IDENTIFY 6
 #define DEFAULT_FPP 0.05  // false positive
@@ -114,6 +114,7 @@ typedef struct {
     HTAB* hashp;
     uint32 curBucket;      /* index of current bucket */
     HASHELEMENT* curEntry; /* current entry in bucket */
+    uint32 bucketStep;     /* distance to the next bucket to scan */
 } HASH_SEQ_STATUS;
 
 /*
@@ -129,6 +130,7 @@ extern void* hash_search_with_hash_value(
     HTAB* hashp, const void* keyPtr, uint32 hashvalue, HASHACTION action, bool* foundPtr);
 extern long hash_get_num_entries(HTAB* hashp);
 extern void hash_seq_init(HASH_SEQ_STATUS* status, HTAB* hashp);
+extern void hash_seq_init_partition(HASH_SEQ_STATUS* status, HTAB* hashp, uint32 partition);
 extern void* hash_seq_search(HASH_SEQ_STATUS* status);
 extern void hash_seq_term(HASH_SEQ_STATUS* status);
 extern void hash_freeze(HTAB* hashp);
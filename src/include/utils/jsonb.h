@@ -0,0 +1,195 @@
+/* -------------------------------------------------------------------------
+ *
+ * jsonb.h
+ *	  Declarations for jsonb data type support.
+ *
+ * A jsonb value is the parsed binary form of a json document. Each array or
+ * object is a container: a header with the number of children, followed by
+ * one JEntry per child and then the children's data. A JEntry holds the type
+ * of the child and the end offset of its data, so the n-th child is found
+ * without reading the ones before it. The keys of an object come first,
+ * sorted by length and then bytes, followed by the values in the same order;
+ * a key is looked up by binary search.
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ * Portions Copyright (c) 1996-2014, PostgreSQL Global Development Group
+ *
+ * src/include/utils/jsonb.h
+ *
+ * -------------------------------------------------------------------------
+ */
+#ifndef JSONB_H
+#define JSONB_H
+
+#include "fmgr.h"
+#include "lib/stringinfo.h"
+#include "utils/numeric.h"
+
+/* Version control for jsonb, the catalog rows come with this version */
+#define JSONB_VERSION_NUM 92073
+
+/* Strategy numbers of the GIN operator class */
+#define JsonbContainsStrategyNumber 7
+#define JsonbExistsStrategyNumber 9
+#define JsonbExistsAnyStrategyNumber 10
+#define JsonbExistsAllStrategyNumber 11
+
+/*
+ * Flags of the GIN index entries, the first byte of each entry. Keys, and
+ * strings in arrays, are flagged as keys so that the exists operators find
+ * them; other values are flagged by type. Long strings and numerics are
+ * stored as a hash.
+ */
+#define JGINFLAG_KEY 0x01
+#define JGINFLAG_NULL 0x02
+#define JGINFLAG_BOOL 0x03
+#define JGINFLAG_NUM 0x04
+#define JGINFLAG_STR 0x05
+#define JGINFLAG_HASHED 0x10
+#define JGIN_MAXLENGTH 125
+
+typedef uint32 JEntry;
+
+#define JENTRY_ENDMASK 0x0FFFFFFF
+#define JENTRY_TYPEMASK 0x70000000
+
+#define JENTRY_ISSTRING 0x00000000
+#define JENTRY_ISNUMERIC 0x10000000
+#define JENTRY_ISFALSE 0x20000000
+#define JENTRY_ISTRUE 0x30000000
+#define JENTRY_ISNULL 0x40000000
+#define JENTRY_ISCONTAINER 0x50000000
+
+#define JBE_END(je) ((je) & JENTRY_ENDMASK)
+#define JBE_TYPE(je) ((je) & JENTRY_TYPEMASK)
+
+/* data of the i-th child begins where the one before ends */
+#define JBE_START(children, i) ((i) == 0 ? 0 : JBE_END((children)[(i) - 1]))
+
+typedef struct JsonbContainer {
+    uint32 header;                          /* number of children and flags */
+    JEntry children[FLEXIBLE_ARRAY_MEMBER]; /* 2 per pair for objects */
+    /* the data of the children follows */
+} JsonbContainer;
+
+#define JB_CMASK 0x0FFFFFFF
+#define JB_FSCALAR 0x10000000 /* an array holding the single scalar of the document */
+#define JB_FOBJECT 0x20000000
+#define JB_FARRAY 0x40000000
+
+#define JsonContainerSize(jc) ((jc)->header & JB_CMASK)
+#define JsonContainerIsScalar(jc) (((jc)->header & JB_FSCALAR) != 0)
+#define JsonContainerIsObject(jc) (((jc)->header & JB_FOBJECT) != 0)
+#define JsonContainerIsArray(jc) (((jc)->header & JB_FARRAY) != 0)
+
+/* number of children of a container, the pairs of an object count twice */
+#define JsonContainerNumChildren(jc) \
+    (JsonContainerIsObject(jc) ? JsonContainerSize(jc) * 2 : JsonContainerSize(jc))
+
+/* start of the data of the children */
+#define JsonContainerData(jc) ((char*)&(jc)->children[JsonContainerNumChildren(jc)])
+
+/* the on-disk datum */
+typedef struct {
+    int32 vl_len_; /* varlena header (do not touch directly!) */
+    JsonbContainer root;
+} Jsonb;
+
+#define DatumGetJsonb(d) ((Jsonb*)PG_DETOAST_DATUM(d))
+#define JsonbGetDatum(p) PointerGetDatum(p)
+#define PG_GETARG_JSONB(x) DatumGetJsonb(PG_GETARG_DATUM(x))
+#define PG_RETURN_JSONB(x) PG_RETURN_POINTER(x)
+
+#define JB_ROOT_COUNT(jbp) JsonContainerSize(&(jbp)->root)
+#define JB_ROOT_IS_SCALAR(jbp) JsonContainerIsScalar(&(jbp)->root)
+#define JB_ROOT_IS_OBJECT(jbp) JsonContainerIsObject(&(jbp)->root)
+#define JB_ROOT_IS_ARRAY(jbp) JsonContainerIsArray(&(jbp)->root)
+
+typedef enum {
+    jbvNull = 0x0,
+    jbvString,
+    jbvNumeric,
+    jbvBool,
+    /* composite types */
+    jbvArray = 0x10,
+    jbvObject,
+    /* a container of an existing jsonb */
+    jbvBinary
+} JsonbValueType;
+
+#define IsAJsonbScalar(jsonbval) ((jsonbval)->type >= jbvNull && (jsonbval)->type <= jbvBool)
+
+typedef struct JsonbPair JsonbPair;
+typedef struct JsonbValue JsonbValue;
+
+/*
+ * A jsonb value in memory: what the parser builds before it is serialized,
+ * and what the lookups return out of a serialized jsonb.
+ */
+struct JsonbValue {
+    JsonbValueType type;
+    union {
+        Numeric numeric;
+        bool boolean;
+        struct {
+            int len;
+            char* val; /* not null-terminated */
+        } string;
+        struct {
+            int nElems;
+            JsonbValue* elems;
+            bool rawScalar; /* the document is this single scalar */
+        } array;
+        struct {
+            int nPairs;
+            JsonbPair* pairs;
+        } object;
+        struct {
+            int len;
+            JsonbContainer* data;
+        } binary;
+    } val;
+};
+
+struct JsonbPair {
+    JsonbValue key;   /* always a string */
+    JsonbValue value;
+    uint32 order;     /* position in the input, the last of duplicated keys wins */
+};
+
+/* jsonb.cpp */
+extern Datum jsonb_in(PG_FUNCTION_ARGS);
+extern Datum jsonb_out(PG_FUNCTION_ARGS);
+extern Datum jsonb_recv(PG_FUNCTION_ARGS);
+extern Datum jsonb_send(PG_FUNCTION_ARGS);
+extern Datum json_to_jsonb(PG_FUNCTION_ARGS);
+extern Datum jsonb_to_json(PG_FUNCTION_ARGS);
+extern char* JsonbToCString(StringInfo out, JsonbContainer* in, int estimated_len);
+
+/* jsonb_util.cpp */
+extern Jsonb* JsonbValueToJsonb(JsonbValue* val);
+extern void getJsonbChildValue(JsonbContainer* container, int index, JsonbValue* result);
+extern bool findJsonbObjectKey(JsonbContainer* container, const char* key, int keylen, JsonbValue* result);
+extern bool findJsonbArrayString(JsonbContainer* container, const char* str, int len);
+extern bool equalsJsonbScalarValue(const JsonbValue* a, const JsonbValue* b);
+extern bool JsonbDeepContains(JsonbContainer* val, JsonbContainer* query);
+
+/* jsonb_op.cpp */
+extern Datum jsonb_object_field(PG_FUNCTION_ARGS);
+extern Datum jsonb_object_field_text(PG_FUNCTION_ARGS);
+extern Datum jsonb_array_element(PG_FUNCTION_ARGS);
+extern Datum jsonb_array_element_text(PG_FUNCTION_ARGS);
+extern Datum jsonb_contains(PG_FUNCTION_ARGS);
+extern Datum jsonb_contained(PG_FUNCTION_ARGS);
+extern Datum jsonb_exists(PG_FUNCTION_ARGS);
+extern Datum jsonb_exists_any(PG_FUNCTION_ARGS);
+extern Datum jsonb_exists_all(PG_FUNCTION_ARGS);
+
+/* jsonb_gin.cpp */
+extern Datum gin_compare_jsonb(PG_FUNCTION_ARGS);
+extern Datum gin_extract_jsonb(PG_FUNCTION_ARGS);
+extern Datum gin_extract_jsonb_query(PG_FUNCTION_ARGS);
+extern Datum gin_consistent_jsonb(PG_FUNCTION_ARGS);
+extern Datum gin_triconsistent_jsonb(PG_FUNCTION_ARGS);
+
+#endif /* JSONB_H */
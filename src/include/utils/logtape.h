@@ -35,5 +35,6 @@ extern bool LogicalTapeBackspace(LogicalTapeSet* lts, int tapenum, size_t size);
 extern bool LogicalTapeSeek(LogicalTapeSet* lts, int tapenum, long blocknum, int offset);
 extern void LogicalTapeTell(LogicalTapeSet* lts, int tapenum, long* blocknum, int* offset);
 extern long LogicalTapeSetBlocks(LogicalTapeSet* lts);
+extern void LogicalTapeSetSpillStats(LogicalTapeSet* lts, int64* rawSize, int64* compressSize);
 
 #endif /* LOGTAPE_H */
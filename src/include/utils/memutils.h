@@ -134,6 +134,14 @@ extern MemoryContext MemoryContextCreate(
 extern MemoryContext AllocSetContextCreate(MemoryContext parent, const char* name, Size minContextSize,
     Size initBlockSize, Size maxBlockSize, MemoryContextType type = STANDARD_CONTEXT,
     Size maxSize = DEFAULT_MEMORY_CONTEXT_MAX_SIZE, bool isSession = false);
+extern void AllocSetCloseThreadCache(void);
+
+/* slab.cpp */
+extern MemoryContext SlabContextCreate(MemoryContext parent, const char* name, Size blockSize, Size chunkSize);
+
+/* generation.cpp */
+extern MemoryContext GenerationContextCreate(
+    MemoryContext parent, const char* name, Size initBlockSize, Size maxBlockSize);
 
 /*
  * Recommended default alloc parameters, suitable for "ordinary" contexts
@@ -152,6 +160,13 @@ extern MemoryContext AllocSetContextCreate(MemoryContext parent, const char* nam
 #define ALLOCSET_SMALL_INITSIZE (1 * 1024)
 #define ALLOCSET_SMALL_MAXSIZE (8 * 1024)
 
+/*
+ * Recommended block sizes for slab contexts: the default for chunks of a few
+ * hundred bytes at most, the large one for hot allocations of larger chunks.
+ */
+#define SLAB_DEFAULT_BLOCK_SIZE (8 * 1024)
+#define SLAB_LARGE_BLOCK_SIZE (8 * 1024 * 1024)
+
 /* default grow ratio for sort and materialize when it spreads */
 #define DEFAULT_GROW_RATIO 2.0
 
@@ -74,6 +74,12 @@ public:
 
     void InitCatchupWorker();
 
+    void InitParallelDecodeWorker();
+
+    void InitBtreeBuildWorker();
+
+    void InitIndexVacuumWorker();
+
     void InitStreamWorker();
 
     void InitBackendWorker();
@@ -187,6 +187,7 @@ typedef struct RelationData {
     uint16* rd_exclstrats;     /* exclusion ops' strategy numbers, if any */
     void* rd_amcache;          /* available for use by index AM */
     Oid* rd_indcollation;      /* OIDs of index collations */
+    int16 rd_indnkeyatts;      /* number of key columns, the included columns follow them */
 
     /*
      * foreign-table support
@@ -282,6 +283,8 @@ typedef struct StdRdOptions {
     bool ignore_enable_hadoop_env; /* ignore enable_hadoop_env */
     bool user_catalog_table;       /* use as an additional catalog relation */
     bool hashbucket;        /* enable hash bucket for this relation */
+    int parallel_vacuum_workers; /* workers of a parallel index vacuum, -1 if not set */
+    bool deduplicate_items;      /* merge duplicates into posting lists, btree only */
 
     /* info for redistribution */
     Oid rel_cn_oid;
@@ -319,6 +322,20 @@ typedef struct StdRdOptions {
 #define RelationIsUsedAsCatalogTable(relation) \
     ((relation)->rd_options ? ((StdRdOptions*)(relation)->rd_options)->user_catalog_table : false)
 
+/*
+ * RelationGetParallelVacuumWorkers
+ *		Returns the relation's parallel_vacuum_workers, -1 if not set.
+ */
+#define RelationGetParallelVacuumWorkers(relation) \
+    ((relation)->rd_options ? ((StdRdOptions*)(relation)->rd_options)->parallel_vacuum_workers : -1)
+
+/*
+ * RelationGetDeduplicateItems
+ *		Returns whether equal keys of the btree index may be deduplicated.
+ */
+#define RelationGetDeduplicateItems(relation) \
+    ((relation)->rd_options ? ((StdRdOptions*)(relation)->rd_options)->deduplicate_items : true)
+
 #define RelationIsInternal(relation) (RelationGetInternalMask(relation) != INTERNAL_MASK_DISABLE)
 
 /*
@@ -388,6 +405,18 @@ typedef struct StdRdOptions {
  */
 #define RelationGetNumberOfAttributes(relation) ((relation)->rd_rel->relnatts)
 
+/*
+ * IndexRelationGetNumberOfAttributes
+ *		Returns the number of all the columns of an index, key and included.
+ */
+#define IndexRelationGetNumberOfAttributes(relation) ((relation)->rd_index->indnatts)
+
+/*
+ * IndexRelationGetNumberOfKeyAttributes
+ *		Returns the number of the key columns of an index.
+ */
+#define IndexRelationGetNumberOfKeyAttributes(relation) ((relation)->rd_indnkeyatts)
+
 /*
  * RelationGetDescr
  *		Returns tuple descriptor for a relation.
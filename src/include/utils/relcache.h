@@ -71,6 +71,7 @@ extern void RelationGetExclusionInfo(Relation indexRelation, Oid** operators, Oi
 extern void RelationSetIndexList(Relation relation, List* indexIds, Oid oidIndex);
 
 extern void RelationInitIndexAccessInfo(Relation relation);
+extern int GetIndexKeyAttsByTuple(Relation pgindex, struct HeapTupleData* indexTuple);
 
 /*
  * Routines for backend startup
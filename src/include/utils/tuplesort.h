@@ -94,6 +94,7 @@ extern bool tuplesort_getdatum(Tuplesortstate* state, bool forward, Datum* val,
 extern void tuplesort_end(Tuplesortstate* state);
 
 extern void tuplesort_get_stats(Tuplesortstate* state, int* sortMethodId, int* spaceTypeId, long* spaceUsed);
+extern void tuplesort_get_spill_stats(Tuplesortstate* state, int64* rawSize, int64* compressSize);
 
 extern int tuplesort_merge_order(double allowedMem);
 
@@ -34,13 +34,6 @@
 
 typedef ScalarVector* (*vecqual_func)(ExprContext* econtext);
 
-/* runtime bloomfilter */
-typedef struct BloomFilterRuntime {
-    List* bf_var_list;              /* bloomfilter var list. */
-    List* bf_filter_index;          /* bloomfilter array index. */
-    filter::BloomFilter** bf_array; /* bloomfilter array. */
-} BloomFilterRuntime;
-
 typedef struct VecHashJoinState : public HashJoinState {
     int joinState;
 
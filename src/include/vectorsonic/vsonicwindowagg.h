@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ * vsonicwindowagg.h
+ *     Routines to handle vector sonic window agg nodes.
+ *
+ * IDENTIFICATION
+ *        src/include/vectorsonic/vsonicwindowagg.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+
+#ifndef VSONICWINDOWAGG_H
+#define VSONICWINDOWAGG_H
+
+#include "nodes/plannodes.h"
+#include "vecexecutor/vecwindowagg.h"
+#include "vectorsonic/vsonichash.h"
+#include "vectorsonic/vsonicpartition.h"
+
+/* runtime status of sonic window agg */
+#define SONIC_WIN_FETCH 0
+#define SONIC_WIN_EMIT_PENDING 1
+#define SONIC_WIN_EMIT_BATCH 2
+#define SONIC_WIN_APPEND_TAIL 3
+#define SONIC_WIN_END 4
+
+/* the largest ROWS n PRECEDING frame kept in the removable frame ring */
+#define SONIC_WIN_MAX_FRAME_ROWS (1024 * 1024)
+
+/* window functions evaluated natively by sonic window agg */
+typedef enum {
+    SONIC_WIN_ROWNUMBER = 0,
+    SONIC_WIN_RANK,
+    SONIC_WIN_DENSERANK,
+    SONIC_WIN_COUNT,    /* count(*) and count(any), int8 result */
+    SONIC_WIN_SUM_INT,  /* sum(int2) and sum(int4), int8 result */
+    SONIC_WIN_SUM_INT8  /* sum(int8), numeric result */
+} SonicWinFuncType;
+
+#define SONIC_WIN_IS_AGG(type) ((type) >= SONIC_WIN_COUNT)
+
+/* running state of one window function */
+typedef struct SonicWinFuncState {
+    SonicWinFuncType type;
+    WindowFuncExprState* wfuncstate;
+    Oid argType;
+
+    /*
+     * aggregate state of the current frame, count is the non-null inputs for sum.
+     * sum is int128 so that sum(int8) can not overflow before it becomes numeric.
+     */
+    int64 count;
+    int128 sum;
+
+    /* removable frame ring for ROWS n PRECEDING, holds the last n + 1 inputs */
+    int64* ringVals;
+    uint8* ringFlags;
+    int ringHead;
+    int ringRows;
+
+    /* aggregate state when the pending peer group is complete */
+    int64 pendCount;
+    int128 pendSum;
+
+    /* argument of the aggregate evaluated on the current batch */
+    ScalarVector* argVector;
+} SonicWinFuncState;
+
+class SonicWindowAgg : public SonicHash {
+public:
+    SonicWindowAgg(VecWindowAggState* runtime);
+    ~SonicWindowAgg(){};
+
+    /* return the next result batch */
+    const VectorBatch* getBatch();
+
+    /* reset for rescan */
+    void ResetNecessary();
+
+    /* release memory and temp files */
+    void freeResources();
+
+    /* number of temp files used by the pending peer group */
+    int getFileNum()
+    {
+        return m_spillFileNum;
+    }
+
+private:
+    void initFuncState();
+
+    void initMemoryControl();
+
+    void initPendStore();
+
+    template <bool simple>
+    void markBoundary(VectorBatch* batch, int nkeys, const int* keyIdx, FmgrInfo* eqfuncs, uint8* result);
+
+    void markBatchBoundary(VectorBatch* batch);
+
+    void evalAggArgs(VectorBatch* batch);
+
+    void processBatch(VectorBatch* batch);
+
+    void resetPartition();
+
+    void advanceFrame(SonicWinFuncState* fstate, int row);
+
+    void setFuncResult(SonicWinFuncState* fstate, ScalarVector* result, int row);
+
+    void finishPeerGroup(int start, int end);
+
+    void appendPending(VectorBatch* batch, int start, int end);
+
+    void spillPending();
+
+    bool fetchPending();
+
+    void releasePending();
+
+    const VectorBatch* emitPending();
+
+    const VectorBatch* emitBatchHead();
+
+    const VectorBatch* projectOutBatch(VectorBatch* batch);
+
+private:
+    /* executor state */
+    VecWindowAggState* m_runtime;
+
+    /* runtime status */
+    int m_status;
+
+    /* number of window functions and input columns */
+    int m_funcNum;
+    int m_inCols;
+
+    SonicWinFuncState* m_funcs;
+
+    /* frame of the aggregates: ROWS frames are row-final, RANGE needs the peer group */
+    bool m_rowsFrame;
+    int64 m_frameRows; /* n of ROWS n PRECEDING, -1 means unbounded */
+
+    /* true if there is some aggregate only known at the end of the peer group */
+    bool m_hasGroupFunc;
+
+    /* partition key and order key */
+    int m_partKeyNum;
+    int* m_partKeyIdx;
+    bool m_simplePartKey;
+    int m_ordKeyNum;
+    int* m_ordKeyIdx;
+    bool m_simpleOrdKey;
+
+    /* boundary flags of the current batch */
+    uint8 m_newPart[BatchMaxSize];
+    uint8 m_newPeer[BatchMaxSize];
+
+    /* ranking state of the current partition */
+    int64 m_partRows;
+    int64 m_rank;
+    int64 m_denseRank;
+
+    /* last row of the previous batch, used for the boundary of the first row */
+    VectorBatch* m_lastRow;
+
+    /*
+     * Current input batch: rows [0, m_headStart) close the pending peer group,
+     * rows [m_headStart, m_groupStart) are final, the rest is the unfinished
+     * peer group moved to the pending store.
+     */
+    VectorBatch* m_curBatch;
+    int m_headStart;
+    int m_groupStart;
+
+    /* per-row results of the current batch, one column per window function */
+    VectorBatch* m_resBatch;
+
+    /* output batch assembled for the projection */
+    VectorBatch* m_outBatch;
+
+    /*
+     * Pending store: the rows of the unfinished peer group, kept in sonic datum
+     * arrays (m_data) and spilled to temp files through SonicHashFilePartition
+     * when the memory is not enough.
+     */
+    int64 m_pendRows;
+    int64 m_pendReadRows;
+    bool m_pendComplete;
+    SonicHashFilePartition* m_pendFile;
+    VectorBatch* m_pendBatch;
+
+    /* ranking result of the first pending row */
+    int64 m_pendRowNumber;
+    int64 m_pendRank;
+    int64 m_pendDenseRank;
+
+    /* spill statistics */
+    int m_spillFileNum;
+};
+
+extern bool isSonicWindowFrameSupported(int frameOptions, Node* startOffset);
+extern bool isSonicWindowAggEnable(WindowAgg* node);
+
+#endif /* VSONICWINDOWAGG_H */
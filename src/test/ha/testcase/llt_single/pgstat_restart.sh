@@ -0,0 +1,41 @@
+#!/bin/sh
+# the table statistics kept in shared memory survive a restart of the primary
+
+source ./standby_env.sh
+
+function tuples_inserted()
+{
+gsql -d $db -p $dn1_primary_port -t -A -c "select n_tup_ins from pg_stat_user_tables where relname = '$1';"
+}
+
+function test_1()
+{
+check_instance
+
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists pgstat_restart1; CREATE TABLE pgstat_restart1(id INT);"
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists pgstat_restart2; CREATE TABLE pgstat_restart2(id INT);"
+gsql -d $db -p $dn1_primary_port -c "INSERT INTO pgstat_restart1 SELECT generate_series(1, 1000);"
+gsql -d $db -p $dn1_primary_port -c "INSERT INTO pgstat_restart2 SELECT generate_series(1, 1000);"
+#a reset counter must stay reset after the restart
+gsql -d $db -p $dn1_primary_port -c "select pg_stat_reset_single_table_counters('pgstat_restart2'::regclass);"
+
+#the shared entries are saved to the stats file at shutdown and loaded at startup
+stop_primary
+start_primary
+check_primary_startup
+
+if [ "$(tuples_inserted pgstat_restart1)" = "1000" ] && [ "$(tuples_inserted pgstat_restart2)" = "0" ]; then
+	echo "all of success"
+else
+	echo "$failed_keyword: table statistics were not kept across the restart."
+	exit 1
+fi
+}
+
+function tear_down()
+{
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists pgstat_restart1; DROP TABLE if exists pgstat_restart2;"
+}
+
+test_1
+tear_down
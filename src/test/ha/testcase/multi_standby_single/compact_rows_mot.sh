@@ -0,0 +1,108 @@
+#!/bin/sh
+# MOT rows in the compact row pools of a table with variable length columns, next to a table of fixed size
+# rows: checkpoint and recovery, updates moving rows across the size classes and readers of the moved rows
+
+source ./util.sh
+
+function checksum()
+{
+gsql -d $db -p $1 -m -t -A -c "select (select md5(string_agg(id || ':' || k || ':' || coalesce(s, '-') || ':' || coalesce(v, '-'), ',' order by id)) from compact_var) || '|' ||
+	(select md5(string_agg(id || ':' || a || ':' || b || ':' || c, ',' order by id)) from compact_fixed);"
+}
+
+function check_checksum()
+{
+if [ "$(checksum $dn1_primary_port)" = "$expected" ]; then
+	echo "$1 success on dn1_primary"
+else
+	echo "$1 $failed_keyword on dn1_primary: $(checksum $dn1_primary_port)"
+	exit 1
+fi
+
+sleep 5
+if [ "$(checksum $dn1_standby_port)" = "$expected" ]; then
+	echo "$1 success on dn1_standby"
+else
+	echo "$1 $failed_keyword on dn1_standby: $(checksum $dn1_standby_port)"
+	exit 1
+fi
+}
+
+function test_1()
+{
+set_default
+check_instance_multi_standby
+
+gsql -d $db -p $dn1_primary_port -c "DROP FOREIGN TABLE if exists compact_fixed; CREATE FOREIGN TABLE compact_fixed(id INT PRIMARY KEY, a INT, b BIGINT, c CHAR(20)) SERVER mot_server;"
+gsql -d $db -p $dn1_primary_port -c "DROP FOREIGN TABLE if exists compact_var; CREATE FOREIGN TABLE compact_var(id INT PRIMARY KEY, k INT NOT NULL, s VARCHAR(10), v VARCHAR(2000)) SERVER mot_server;"
+gsql -d $db -p $dn1_primary_port -c "CREATE INDEX compact_var_k ON compact_var(k);"
+gsql -d $db -p $dn1_primary_port -c "INSERT INTO compact_fixed SELECT i, i, i * 10, 'row ' || i FROM generate_series(1, 1000) AS i;"
+gsql -d $db -p $dn1_primary_port -c "INSERT INTO compact_var SELECT i, i % 10, 'r' || i, repeat(chr(97 + i % 26), i % 100 * 20) FROM generate_series(1, 1000) AS i;"
+
+#the checkpoint writes the compact rows as they are, the redo after it has updates across the size classes
+gsql -d $db -p $dn1_primary_port -c "CHECKPOINT;"
+gsql -d $db -p $dn1_primary_port -c "UPDATE compact_var SET v = repeat('g', 1990) WHERE id % 7 = 0;"
+gsql -d $db -p $dn1_primary_port -c "UPDATE compact_var SET v = 'tiny' WHERE id % 11 = 0;"
+gsql -d $db -p $dn1_primary_port -c "UPDATE compact_var SET v = NULL, s = 'null' WHERE id % 13 = 0;"
+gsql -d $db -p $dn1_primary_port -c "START TRANSACTION; DELETE FROM compact_var WHERE id % 17 = 0; INSERT INTO compact_var SELECT i, i % 10, 'again', repeat('n', i) FROM generate_series(17, 1000, 17) AS i; COMMIT;"
+gsql -d $db -p $dn1_primary_port -c "UPDATE compact_fixed SET c = 'updated ' || id, b = b + 1 WHERE id % 10 = 0;"
+
+expected=$(checksum $dn1_primary_port)
+echo "expected=" $expected
+
+#recovery from the checkpoint and the redo
+kill_primary
+start_primary
+check_primary_startup
+check_checksum "checkpoint and redo recovery"
+
+#recovery from the checkpoint alone, then updates of the recovered full rows
+gsql -d $db -p $dn1_primary_port -c "CHECKPOINT;"
+kill_primary
+start_primary
+check_primary_startup
+check_checksum "checkpoint recovery"
+
+gsql -d $db -p $dn1_primary_port -c "UPDATE compact_var SET v = substr(v, 1, 30) WHERE k = 1;"
+gsql -d $db -p $dn1_primary_port -c "UPDATE compact_var SET v = repeat('h', 700) WHERE k = 2;"
+expected=$(checksum $dn1_primary_port)
+check_checksum "update of recovered rows"
+
+#readers of the rows that a writer keeps moving between the smallest and the largest size class
+for j in $(seq 1 200); do
+	echo "SELECT count(1) || '|' || count(v) || '|' || sum(length(s)) FROM compact_var WHERE k = 5;"
+done > ./results/compact_rows_read.sql
+for j in $(seq 1 30); do
+	echo "UPDATE compact_var SET v = repeat('w', $j % 2 * 1980 + 10) WHERE k = 5;"
+done > ./results/compact_rows_write.sql
+gsql -d $db -p $dn1_primary_port -c "UPDATE compact_var SET v = repeat('w', 10) WHERE k = 5;"
+gsql -d $db -p $dn1_primary_port -c "SELECT count(1) || '|' || count(v) || '|' || sum(length(s)) FROM compact_var WHERE k = 5;" -t -A > ./results/compact_rows_expected.out
+gsql -d $db -p $dn1_primary_port -f ./results/compact_rows_write.sql > /dev/null 2>&1 &
+for i in 1 2 3 4; do
+	gsql -d $db -p $dn1_primary_port -t -A -f ./results/compact_rows_read.sql > ./results/compact_rows_read_$i.out 2>&1 &
+done
+wait
+
+for i in 1 2 3 4; do
+	if [ $(grep -v -x -F -f ./results/compact_rows_expected.out ./results/compact_rows_read_$i.out | grep -v "could not serialize" | grep -v "^$" | wc -l) -ne 0 ]; then
+		echo "readers of moved rows $failed_keyword: $(grep -v -x -F -f ./results/compact_rows_expected.out ./results/compact_rows_read_$i.out | head -5)"
+		exit 1
+	fi
+done
+echo "readers of moved rows success"
+
+expected=$(checksum $dn1_primary_port)
+kill_primary
+start_primary
+check_primary_startup
+check_checksum "recovery of moved rows"
+}
+
+function tear_down()
+{
+gsql -d $db -p $dn1_primary_port -c "DROP FOREIGN TABLE if exists compact_fixed; DROP FOREIGN TABLE if exists compact_var;"
+rm -f ./results/compact_rows_*
+}
+
+test_1
+tear_down
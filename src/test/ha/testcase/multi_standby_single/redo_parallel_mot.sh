@@ -0,0 +1,109 @@
+#!/bin/sh
+# MOT redo replayed by several redo_recovery_workers, in crash recovery of the
+# primary and on the standby: transactions spanning the tables of several
+# workers and schema changes must replay in commit order
+
+source ./util.sh
+
+mot_data_dirs="$primary_data_dir $standby_data_dir $standby2_data_dir $standby3_data_dir $standby4_data_dir"
+
+function set_redo_workers()
+{
+kill_cluster
+for dir in $mot_data_dirs; do
+	sed -i '/^#\?redo_recovery_workers = /d' $dir/mot.conf
+	echo "redo_recovery_workers = $1" >> $dir/mot.conf
+done
+start_cluster
+}
+
+function checksum()
+{
+gsql -d $db -p $1 -m -t -A -c "select (select count(1) || ':' || sum(val) from redo_par1) || '|' ||
+	(select count(1) || ':' || sum(val) from redo_par2) || '|' || (select count(1) || ':' || sum(val) from redo_par3) || '|' ||
+	(select count(1) || ':' || sum(val) from redo_par4) || '|' || (select count(1) || ':' || sum(val) from redo_par5);"
+}
+
+function test_1()
+{
+set_default
+set_redo_workers 4
+check_instance_multi_standby
+
+for i in 1 2 3 4; do
+	gsql -d $db -p $dn1_primary_port -c "DROP FOREIGN TABLE if exists redo_par$i; CREATE FOREIGN TABLE redo_par$i(id INT PRIMARY KEY, val INT) SERVER mot_server;"
+done
+gsql -d $db -p $dn1_primary_port -c "DROP FOREIGN TABLE if exists redo_par5;"
+
+#transactions on a single table each, replayed side by side by the workers
+for i in 1 2 3 4; do
+	gsql -d $db -p $dn1_primary_port -c "INSERT INTO redo_par$i SELECT generate_series(1, 2000), $i;" &
+done
+wait
+
+#transactions spanning the tables of several workers, mixed with single table ones
+for j in $(seq 1 20); do
+	gsql -d $db -p $dn1_primary_port -c "START TRANSACTION;
+		INSERT INTO redo_par1 VALUES(2000 + $j, $j);
+		UPDATE redo_par2 SET val = val + 1 WHERE id % 20 = $j % 20;
+		DELETE FROM redo_par3 WHERE id = $j * 10;
+		UPDATE redo_par4 SET val = val * 2 WHERE id = $j;
+		COMMIT;" > /dev/null &
+	gsql -d $db -p $dn1_primary_port -c "UPDATE redo_par3 SET val = val + $j WHERE id > 1000;" > /dev/null &
+	wait
+done
+
+#schema changes in the middle of the stream wait for all the workers
+gsql -d $db -p $dn1_primary_port -c "CREATE FOREIGN TABLE redo_par5(id INT NOT NULL, val INT) SERVER mot_server;"
+gsql -d $db -p $dn1_primary_port -c "CREATE INDEX redo_par5_idx ON redo_par5(id);"
+gsql -d $db -p $dn1_primary_port -c "INSERT INTO redo_par5 SELECT id, val FROM redo_par2 WHERE id <= 500;"
+gsql -d $db -p $dn1_primary_port -c "DROP FOREIGN TABLE redo_par4;"
+gsql -d $db -p $dn1_primary_port -c "CREATE FOREIGN TABLE redo_par4(id INT PRIMARY KEY, val INT) SERVER mot_server;"
+gsql -d $db -p $dn1_primary_port -c "START TRANSACTION; INSERT INTO redo_par4 SELECT generate_series(1, 300), 7; UPDATE redo_par5 SET val = 0 WHERE id <= 100; COMMIT;"
+
+expected=$(checksum $dn1_primary_port)
+echo "expected=" $expected
+
+#crash the primary, its recovery replays the MOT redo with the workers
+kill_primary
+start_primary
+check_primary_startup
+
+if [ "$(checksum $dn1_primary_port)" = "$expected" ]; then
+	echo "parallel redo recovery success on dn1_primary"
+else
+	echo "parallel redo recovery $failed_keyword on dn1_primary: $(checksum $dn1_primary_port)"
+	exit 1
+fi
+
+#the standby replays the stream with the workers as it arrives, and again after a crash
+sleep 5
+if [ "$(checksum $dn1_standby_port)" = "$expected" ]; then
+	echo "parallel redo replay success on dn1_standby"
+else
+	echo "parallel redo replay $failed_keyword on dn1_standby: $(checksum $dn1_standby_port)"
+	exit 1
+fi
+
+kill_standby
+start_standby
+check_standby_startup
+sleep 5
+if [ "$(checksum $dn1_standby_port)" = "$expected" ]; then
+	echo "parallel redo recovery success on dn1_standby"
+else
+	echo "parallel redo recovery $failed_keyword on dn1_standby: $(checksum $dn1_standby_port)"
+	exit 1
+fi
+}
+
+function tear_down()
+{
+for i in 1 2 3 4 5; do
+	gsql -d $db -p $dn1_primary_port -c "DROP FOREIGN TABLE if exists redo_par$i;"
+done
+set_redo_workers 1
+}
+
+test_1
+tear_down
@@ -0,0 +1,30 @@
+--
+-- Scaling of palloc and pfree in shared memory contexts, from 1 to 128
+-- threads. Each thread makes :loops allocations; mops is the total number of
+-- allocations per second, in millions. Compare the runs of two builds.
+--
+-- The first run shares one context between all threads. In the second one
+-- each thread resets a context of its own after every allocation, which
+-- takes the global registry lock of the shared contexts every time.
+--
+-- gsql -d postgres -v regresslib=<build>/src/test/regress/regress.so -f shared_context_scaling.sql
+--
+\set loops 1000000
+
+CREATE OR REPLACE FUNCTION shared_context_bench(int4, int4, bool, OUT threads int4, OUT ms float8)
+    AS :'regresslib', 'shared_context_bench' LANGUAGE C STRICT;
+
+-- threads is the number of threads that ran, a WARNING says so if some could not be started
+SELECT requested, (r).threads, round((r).ms::numeric, 1) AS ms,
+       round((r).threads * :loops / (r).ms::numeric / 1000, 2) AS mops
+    FROM (SELECT 1 << i AS requested, shared_context_bench(1 << i, :loops, false) AS r
+              FROM generate_series(0, 7) i OFFSET 0) t
+    ORDER BY requested;
+
+SELECT requested, (r).threads, round((r).ms::numeric, 1) AS ms,
+       round((r).threads * :loops / (r).ms::numeric / 1000, 2) AS mops
+    FROM (SELECT 1 << i AS requested, shared_context_bench(1 << i, :loops, true) AS r
+              FROM generate_series(0, 7) i OFFSET 0) t
+    ORDER BY requested;
+
+DROP FUNCTION shared_context_bench(int4, int4, bool);
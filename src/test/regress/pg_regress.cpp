@@ -346,6 +346,7 @@ static _stringlist* extra_tests = NULL;
 static char* pcRegConfFile = NULL;
 static char* temp_install = NULL;
 static char* temp_config = NULL;
+static char* temp_mot_config = NULL;
 static char* top_builddir = NULL;
 static bool nolocale = false;
 static bool use_existing = false;
@@ -2104,6 +2105,38 @@ static void initdb_node_config_file(bool standby)
         fputs(buf, pg_conf);
 
         fclose(pg_conf);
+
+        if (temp_mot_config != NULL) {
+            FILE* extra_conf = NULL;
+            char line_buf[1024];
+
+            (void)snprintf(buf, sizeof(buf), "%s/%s/mot.conf", temp_install, data_folder);
+            pg_conf = fopen(buf, "a");
+            if (pg_conf == NULL) {
+                fprintf(stderr,
+                    _("\n%s: could not open \"%s\" for adding extra config: %s\n"),
+                    progname,
+                    buf,
+                    strerror(errno));
+                exit_nicely(2);
+            }
+            fputs("\n# Configuration added by pg_regress\n\n", pg_conf);
+
+            extra_conf = fopen(temp_mot_config, "r");
+            if (extra_conf == NULL) {
+                fprintf(stderr,
+                    _("\n%s: could not open \"%s\" to read extra config: %s\n"),
+                    progname,
+                    temp_mot_config,
+                    strerror(errno));
+                exit_nicely(2);
+            }
+            while (fgets(line_buf, sizeof(line_buf), extra_conf) != NULL) {
+                fputs(line_buf, pg_conf);
+            }
+            fclose(extra_conf);
+            fclose(pg_conf);
+        }
         free(data_folder);
     }
 
@@ -5172,6 +5205,7 @@ static void help(void)
     printf(_("  --top-builddir=DIR        (relative) path to top level build directory\n"));
     printf(_("  --port=PORT               start postmaster on PORT\n"));
     printf(_("  --temp-config=PATH        append contents of PATH to temporary config\n"));
+    printf(_("  --temp-mot-config=PATH    append contents of PATH to temporary MOT config\n"));
     printf(_("  --extra-install=DIR       additional directory to install (e.g., contrib\n"));
     printf(_("  --hdfshostname=IPAddress	  hdfs data IP address\n"));
     printf(_("  --hdfsstoreplus=hdfsstoreplus	  hdfs data store path plus information\n"));
@@ -6075,6 +6109,7 @@ int regression_main(int argc, char* argv[], init_function ifunc, test_function t
         {"platform", required_argument, NULL, 55},
         {"aiehost", required_argument, NULL, 56},
         {"aieport", required_argument, NULL, 57},
+        {"temp-mot-config", required_argument, NULL, 58},
         {NULL, 0, NULL, 0}
     };
 
@@ -6458,6 +6493,13 @@ int regression_main(int argc, char* argv[], init_function ifunc, test_function t
                     exit_nicely(2);
                 }
                 break;
+            case 58:
+                temp_mot_config = strdup(optarg);
+                if (temp_mot_config == NULL) {
+                    fprintf(stderr, "out of memory\n");
+                    exit_nicely(2);
+                }
+                break;
             default:
                 /* getopt_long already emitted a complaint */
                 fprintf(stderr, _("\nTry \"%s -h\" for more information.\n"), progname);
@@ -26,6 +26,8 @@
 #include "commands/trigger.h"
 #include "executor/executor.h"
 #include "executor/spi.h"
+#include "funcapi.h"
+#include "portability/instr_time.h"
 #include "utils/atomic.h"
 #include "utils/builtins.h"
 #include "utils/geo_decls.h"
@@ -73,6 +75,9 @@ extern "C" Datum complex_out(PG_FUNCTION_ARGS);
 extern "C" Datum complex_recv(PG_FUNCTION_ARGS);
 extern "C" Datum complex_send(PG_FUNCTION_ARGS);
 
+/**************shared memory context scaling*****************/
+extern "C" Datum shared_context_bench(PG_FUNCTION_ARGS);
+
 /***************************UDF CREM**************************/
 
 extern "C" {
@@ -2918,3 +2923,137 @@ Datum complex_send(PG_FUNCTION_ARGS)
     pq_sendfloat8(&buf, complex->y);
     PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
 }
+
+/***************shared memory context scaling*****************/
+/*
+ * shared_context_bench(nthreads, loops, resets) measures nthreads threads
+ * making loops pallocs and pfrees each in shared contexts, and returns the
+ * number of threads that ran and the milliseconds they took.
+ * src/test/performance/shared_context_scaling.sql runs it for 1 to 128
+ * threads.
+ *
+ * Without resets, all threads share one context and keep SHARED_BENCH_LIVE
+ * chunks of 16 to 1024 bytes alive, which exercises the per-thread chunk
+ * cache. With resets, each thread has a context of its own and resets it
+ * after every allocation; a reset renews the context's cache id under the
+ * global SharedSetRegistryLock, so this measures what that lock costs.
+ *
+ * The threads are not backend threads: they run with a freshly initialized
+ * t_thrd, without a session (u_sess is NULL) and without a PGPROC, so they
+ * must not ereport, and they do not account memory with memprot. Each
+ * context is created with a keeper block that holds everything a thread
+ * allocates, so no block is malloc'd or freed on their behalf.
+ */
+#define SHARED_BENCH_MAX_THREADS 128
+#define SHARED_BENCH_LIVE 64
+#define SHARED_BENCH_BYTES_PER_THREAD (256 * 1024)
+
+typedef struct SharedBenchArg {
+    MemoryContext context;
+    int loops;
+    bool resets;
+} SharedBenchArg;
+
+static void* shared_context_bench_worker(void* arg)
+{
+    SharedBenchArg* bench = (SharedBenchArg*)arg;
+    void* chunks[SHARED_BENCH_LIVE] = {NULL};
+    int i;
+
+    knl_thread_init(WORKER);
+    u_sess = NULL;
+
+    for (i = 0; i < bench->loops; i++) {
+        int slot = i % SHARED_BENCH_LIVE;
+
+        if (bench->resets) {
+            (void)MemoryContextAlloc(bench->context, (Size)16 << (i % 7));
+            MemoryContextReset(bench->context);
+            continue;
+        }
+        if (chunks[slot] != NULL)
+            pfree(chunks[slot]);
+        chunks[slot] = MemoryContextAlloc(bench->context, (Size)16 << (i % 7));
+    }
+
+    for (i = 0; i < SHARED_BENCH_LIVE; i++) {
+        if (chunks[i] != NULL)
+            pfree(chunks[i]);
+    }
+
+    /* hand the chunks this thread caches back before the context goes away */
+    AllocSetCloseThreadCache();
+    return NULL;
+}
+
+static MemoryContext shared_context_bench_create(int nthreads)
+{
+    return AllocSetContextCreate(g_instance.instance_context,
+        "SharedContextBench",
+        (Size)nthreads * SHARED_BENCH_BYTES_PER_THREAD,
+        ALLOCSET_DEFAULT_INITSIZE,
+        ALLOCSET_DEFAULT_MAXSIZE,
+        SHARED_CONTEXT);
+}
+
+PG_FUNCTION_INFO_V1(shared_context_bench);
+
+Datum shared_context_bench(PG_FUNCTION_ARGS)
+{
+    int nthreads = PG_GETARG_INT32(0);
+    int loops = PG_GETARG_INT32(1);
+    bool resets = PG_GETARG_BOOL(2);
+    pthread_t threads[SHARED_BENCH_MAX_THREADS];
+    SharedBenchArg bench[SHARED_BENCH_MAX_THREADS];
+    TupleDesc tupdesc;
+    Datum values[2];
+    bool nulls[2] = {false, false};
+    instr_time start;
+    instr_time duration;
+    int started = 0;
+    int rc = 0;
+    int i;
+
+    if (nthreads < 1 || nthreads > SHARED_BENCH_MAX_THREADS || loops < 1)
+        ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                errmsg("shared_context_bench needs 1 to %d threads and at least one loop", SHARED_BENCH_MAX_THREADS)));
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+        ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED), errmsg("return type must be a row type")));
+
+    for (i = 0; i < nthreads; i++) {
+        /* with resets every thread gets a context of its own */
+        if (i == 0 || resets)
+            bench[i].context = shared_context_bench_create(resets ? 1 : nthreads);
+        else
+            bench[i].context = bench[0].context;
+        bench[i].loops = loops;
+        bench[i].resets = resets;
+    }
+
+    INSTR_TIME_SET_CURRENT(start);
+    for (i = 0; i < nthreads; i++) {
+        rc = pthread_create(&threads[i], NULL, shared_context_bench_worker, &bench[i]);
+        if (rc != 0)
+            break;
+        started++;
+    }
+    for (i = 0; i < started; i++)
+        (void)pthread_join(threads[i], NULL);
+    INSTR_TIME_SET_CURRENT(duration);
+    INSTR_TIME_SUBTRACT(duration, start);
+
+    for (i = 0; i < nthreads; i++) {
+        if (i == 0 || resets)
+            MemoryContextDelete(bench[i].context);
+    }
+
+    if (started < nthreads)
+        ereport(WARNING,
+            (errcode(ERRCODE_INSUFFICIENT_RESOURCES),
+                errmsg("could only start %d of %d threads: %s", started, nthreads, strerror(rc))));
+
+    values[0] = Int32GetDatum(started);
+    values[1] = Float8GetDatum(INSTR_TIME_GET_MILLISEC(duration));
+    PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(BlessTupleDesc(tupdesc), values, nulls)));
+}
@@ -0,0 +1,40 @@
+--
+-- Auto-parameterization of simple queries
+--
+CREATE TABLE autoparam_t (a int, b text);
+INSERT INTO autoparam_t SELECT i, 'v' || i FROM generate_series(1, 10) i;
+SET enable_auto_parameterization = on;
+
+-- queries differing in their literals share a statement
+SELECT b FROM autoparam_t WHERE a = 1;
+SELECT b FROM autoparam_t WHERE a = 2;
+SELECT a FROM autoparam_t WHERE b = 'v3';
+SELECT a FROM autoparam_t WHERE b = 'v4';
+UPDATE autoparam_t SET b = 'w' WHERE a = 5;
+UPDATE autoparam_t SET b = 'x' WHERE a = 6;
+SELECT a, b FROM autoparam_t WHERE a > 4 AND a < 7 ORDER BY a;
+
+-- they are not the user's prepared statements
+SELECT count(*) FROM pg_prepared_statements;
+PREPARE gs_autoparam_00000000 AS SELECT 1;
+PREPARE autoparam_p AS SELECT b FROM autoparam_t WHERE a = $1;
+SELECT name FROM pg_prepared_statements;
+EXECUTE autoparam_p(3);
+DEALLOCATE autoparam_p;
+
+-- with room for a single statement the shapes evict each other
+SET auto_param_max_statements = 1;
+SELECT b FROM autoparam_t WHERE a = 7;
+SELECT a FROM autoparam_t WHERE b = 'v8';
+SELECT b FROM autoparam_t WHERE a = 9;
+SELECT a FROM autoparam_t WHERE b = 'v10';
+RESET auto_param_max_statements;
+
+-- a statement deallocated by the user is prepared again
+SELECT b FROM autoparam_t WHERE a = 1;
+DEALLOCATE ALL;
+SELECT b FROM autoparam_t WHERE a = 2;
+SELECT b FROM autoparam_t WHERE a = 3;
+
+RESET enable_auto_parameterization;
+DROP TABLE autoparam_t;
@@ -0,0 +1,49 @@
+--
+-- posting lists of btree indexes
+--
+CREATE TABLE btree_dedup (a int, b int);
+INSERT INTO btree_dedup SELECT x % 10, x FROM generate_series(1, 10000) x;
+CREATE TABLE btree_dedup_off (a int, b int);
+INSERT INTO btree_dedup_off SELECT a, b FROM btree_dedup;
+-- an index build merges the duplicates
+CREATE INDEX btree_dedup_idx ON btree_dedup (a);
+CREATE INDEX btree_dedup_off_idx ON btree_dedup_off (a) WITH (deduplicate_items = off);
+SELECT relname, reloptions FROM pg_class WHERE relname IN ('btree_dedup_idx', 'btree_dedup_off_idx') ORDER BY relname;
+SELECT pg_relation_size('btree_dedup_idx') < pg_relation_size('btree_dedup_off_idx') AS smaller;
+CREATE INDEX btree_dedup_bad ON btree_dedup (a) WITH (deduplicate_items = maybe);
+ANALYZE btree_dedup;
+ANALYZE btree_dedup_off;
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+-- every heap TID of a posting list is returned
+EXPLAIN (COSTS OFF) SELECT count(*), sum(b) FROM btree_dedup WHERE a = 3;
+SELECT count(*), sum(b) FROM btree_dedup WHERE a = 3;
+SELECT count(*), sum(b) FROM btree_dedup_off WHERE a = 3;
+-- backward scans walk the posting lists from their last heap TID
+EXPLAIN (COSTS OFF) SELECT a FROM btree_dedup WHERE a <= 3 ORDER BY a DESC LIMIT 2500;
+SELECT a, count(*) FROM (SELECT a FROM btree_dedup WHERE a <= 3 ORDER BY a DESC LIMIT 2500) s GROUP BY a ORDER BY a;
+SELECT a, count(*) FROM (SELECT a FROM btree_dedup_off WHERE a <= 3 ORDER BY a DESC LIMIT 2500) s GROUP BY a ORDER BY a;
+-- VACUUM rewrites the posting lists with dead TIDs and removes the fully dead ones
+DELETE FROM btree_dedup WHERE a = 3 AND b % 3 = 0;
+DELETE FROM btree_dedup WHERE a = 4;
+VACUUM btree_dedup;
+SELECT count(*), sum(b) FROM btree_dedup WHERE a = 3;
+SELECT count(*) FROM btree_dedup WHERE a = 4;
+SELECT a, count(*) FROM (SELECT a FROM btree_dedup WHERE a BETWEEN 3 AND 5 ORDER BY a DESC) s GROUP BY a ORDER BY a;
+-- insertions into full leaf pages merge the duplicates too
+CREATE TABLE btree_dedup_ins (a int, b int);
+CREATE INDEX btree_dedup_ins_idx ON btree_dedup_ins (a);
+CREATE INDEX btree_dedup_ins_off_idx ON btree_dedup_ins (a) WITH (deduplicate_items = off);
+INSERT INTO btree_dedup_ins SELECT x % 10, x FROM generate_series(1, 10000) x;
+SELECT pg_relation_size('btree_dedup_ins_idx') < pg_relation_size('btree_dedup_ins_off_idx') AS smaller;
+DROP INDEX btree_dedup_ins_off_idx;
+SELECT count(*), sum(b) FROM btree_dedup_ins WHERE a = 3;
+-- the option can be turned off, the existing posting lists are still read
+ALTER INDEX btree_dedup_ins_idx SET (deduplicate_items = off);
+INSERT INTO btree_dedup_ins SELECT 3, x FROM generate_series(10001, 10010) x;
+SELECT count(*), sum(b) FROM btree_dedup_ins WHERE a = 3;
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+DROP TABLE btree_dedup;
+DROP TABLE btree_dedup_off;
+DROP TABLE btree_dedup_ins;
@@ -0,0 +1,72 @@
+--
+-- Parallel btree build
+--
+create schema parallel_btbuild;
+set current_schema = parallel_btbuild;
+-- four rows a page, so the stripes of 100 blocks the participants scan in
+-- turn hold the ids 1-400, 401-800 and so on
+create table pbt (id int, a int, pad text) with (autovacuum_enabled = false);
+insert into pbt select i, i % 1000, repeat('x', 1900) from generate_series(1, 4000) i;
+select pg_relation_size('pbt') / 8192 as blocks;
+set maintenance_work_mem = '256MB';
+set max_parallel_maintenance_workers = 3;
+create index pbt_a on pbt (a);
+create unique index pbt_id on pbt (id);
+set enable_seqscan = off;
+set enable_bitmapscan = off;
+select count(*) from pbt where a = 42;
+select a, count(*) from pbt where a between 997 and 999 group by a order by a;
+select count(*), min(id), max(id) from pbt where id between 1000 and 2999;
+select id from pbt where id > 3995 order by id;
+select id from pbt where a = 500 order by id;
+reset enable_bitmapscan;
+reset enable_seqscan;
+select c.relname, c.reltuples from pg_class c, pg_index i
+    where i.indrelid = 'pbt'::regclass and c.oid = i.indexrelid order by 1;
+
+-- REINDEX and CREATE INDEX CONCURRENTLY build in parallel as well
+reindex index pbt_id;
+reindex table pbt;
+create index concurrently pbt_a_id on pbt (a, id);
+create unique index concurrently pbt_id_a on pbt (id, a);
+drop index pbt_a;
+drop index pbt_id;
+set enable_seqscan = off;
+set enable_bitmapscan = off;
+select count(*) from pbt where a = 42;
+select a, count(*) from pbt where a between 997 and 999 group by a order by a;
+select count(*), min(id), max(id) from pbt where id between 1000 and 2999;
+select id from pbt where id > 3995 order by id;
+select id from pbt where a = 500 order by id;
+reset enable_bitmapscan;
+reset enable_seqscan;
+select c.relname, c.reltuples from pg_class c, pg_index i
+    where i.indrelid = 'pbt'::regclass and c.oid = i.indexrelid order by 1;
+
+-- a duplicate in the stripes of two participants is found by the leader
+-- while it merges their runs
+insert into pbt values (10, 10, 'dup');
+create unique index pbt_id on pbt (id);
+delete from pbt where pad = 'dup';
+create unique index pbt_id on pbt (id);
+drop table pbt;
+
+-- a duplicate within a stripe of worker 1 is found by the worker, the
+-- leader raises its error again
+create table pbt_dup (id int, pad text) with (autovacuum_enabled = false);
+insert into pbt_dup select case when i = 502 then 501 else i end, repeat('x', 1900)
+    from generate_series(1, 4000) i;
+create unique index pbt_dup_id on pbt_dup (id);
+select count(*) from pg_class where relname = 'pbt_dup_id';
+create index pbt_dup_id on pbt_dup (id);
+set enable_seqscan = off;
+set enable_bitmapscan = off;
+select count(*) from pbt_dup where id = 501;
+select count(*) from pbt_dup where id = 502;
+reset enable_bitmapscan;
+reset enable_seqscan;
+drop table pbt_dup;
+reset max_parallel_maintenance_workers;
+reset maintenance_work_mem;
+reset current_schema;
+drop schema parallel_btbuild;
@@ -0,0 +1,84 @@
+--
+-- btree skip scans over the leading index column
+--
+CREATE TABLE skip_scan (a int, b int, c int);
+INSERT INTO skip_scan SELECT x / 2500, x % 2500, x FROM generate_series(0, 9999) x;
+CREATE INDEX skip_scan_idx ON skip_scan (a, b) INCLUDE (c);
+VACUUM ANALYZE skip_scan;
+-- one primitive scan per distinct value of a
+EXPLAIN (ANALYZE on, COSTS off, TIMING off) SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a;
+SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a;
+EXPLAIN (COSTS OFF) SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a DESC;
+SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a DESC;
+SELECT a, b, c FROM skip_scan WHERE b BETWEEN 10 AND 12 ORDER BY a, b;
+SELECT a, b, c FROM skip_scan WHERE b BETWEEN 10 AND 12 ORDER BY a DESC, b DESC;
+-- the skip scan returns what a sequential scan does
+EXPLAIN (ANALYZE on, COSTS off, TIMING off) SELECT count(*), sum(c) FROM skip_scan WHERE b BETWEEN 10 AND 400;
+SELECT count(*), sum(c) FROM skip_scan WHERE b BETWEEN 10 AND 400;
+SET enable_indexscan = off;
+SET enable_indexonlyscan = off;
+SET enable_bitmapscan = off;
+EXPLAIN (COSTS OFF) SELECT count(*), sum(c) FROM skip_scan WHERE b BETWEEN 10 AND 400;
+SELECT count(*), sum(c) FROM skip_scan WHERE b BETWEEN 10 AND 400;
+RESET enable_indexscan;
+RESET enable_indexonlyscan;
+RESET enable_bitmapscan;
+-- NULLs in the leading column are skipped to as well, they sort last
+INSERT INTO skip_scan VALUES (NULL, 500, -1), (NULL, 2600, -2);
+VACUUM skip_scan;
+EXPLAIN (ANALYZE on, COSTS off, TIMING off) SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a;
+SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a;
+SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a DESC;
+SELECT a, b, c FROM skip_scan WHERE b = 2600 ORDER BY a;
+SELECT a, b, c FROM skip_scan WHERE b = 2600 ORDER BY a DESC;
+-- a leading column in DESC NULLS FIRST order
+DROP INDEX skip_scan_idx;
+CREATE INDEX skip_scan_desc_idx ON skip_scan (a DESC NULLS FIRST, b) INCLUDE (c);
+EXPLAIN (ANALYZE on, COSTS off, TIMING off) SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a DESC NULLS FIRST;
+SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a DESC NULLS FIRST;
+EXPLAIN (COSTS OFF) SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a;
+SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a;
+SELECT a, b, c FROM skip_scan WHERE b BETWEEN 10 AND 11 ORDER BY a DESC NULLS FIRST, b;
+-- bitmap scans
+SET enable_indexscan = off;
+SET enable_indexonlyscan = off;
+EXPLAIN (ANALYZE on, COSTS off, TIMING off) SELECT count(*), sum(c) FROM skip_scan WHERE b = 500;
+SELECT count(*), sum(c) FROM skip_scan WHERE b = 500;
+RESET enable_indexscan;
+RESET enable_indexonlyscan;
+-- mark and restore as the inner side of a merge join
+DROP INDEX skip_scan_desc_idx;
+CREATE INDEX skip_scan_idx ON skip_scan (a, b) INCLUDE (c);
+CREATE TABLE skip_scan_outer (a int, tag text);
+INSERT INTO skip_scan_outer VALUES (0, 'a'), (1, 'b'), (1, 'c'), (2, 'd'), (3, 'e'), (3, 'f');
+CREATE INDEX skip_scan_outer_a_idx ON skip_scan_outer (a);
+ANALYZE skip_scan_outer;
+SET enable_hashjoin = off;
+SET enable_nestloop = off;
+SET enable_material = off;
+SET enable_seqscan = off;
+EXPLAIN (ANALYZE on, COSTS off, TIMING off) SELECT o.tag, s.a, s.c FROM skip_scan_outer o LEFT JOIN skip_scan s ON s.a = o.a AND s.b = 500;
+SELECT o.tag, s.a, s.c FROM skip_scan_outer o LEFT JOIN skip_scan s ON s.a = o.a AND s.b = 500 ORDER BY o.tag;
+RESET enable_hashjoin;
+RESET enable_nestloop;
+RESET enable_material;
+RESET enable_seqscan;
+-- posting lists hold the duplicates of each (a, b)
+CREATE TABLE skip_scan_dup (a int, b int);
+INSERT INTO skip_scan_dup SELECT x % 3, x % 5 FROM generate_series(0, 29999) x;
+CREATE INDEX skip_scan_dup_idx ON skip_scan_dup (a, b);
+VACUUM ANALYZE skip_scan_dup;
+EXPLAIN (ANALYZE on, COSTS off, TIMING off) SELECT count(*) FROM skip_scan_dup WHERE b = 2;
+SELECT count(*) FROM skip_scan_dup WHERE b = 2;
+SELECT a, count(*) FROM (SELECT a FROM skip_scan_dup WHERE b = 2 ORDER BY a DESC LIMIT 5000) s GROUP BY a ORDER BY a;
+-- enable_indexskipscan turns it off
+SET enable_indexskipscan = off;
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+EXPLAIN (ANALYZE on, COSTS off, TIMING off) SELECT a, b, c FROM skip_scan WHERE b = 500 ORDER BY a;
+RESET enable_indexskipscan;
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+DROP TABLE skip_scan;
+DROP TABLE skip_scan_outer;
+DROP TABLE skip_scan_dup;
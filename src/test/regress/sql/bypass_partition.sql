@@ -0,0 +1,72 @@
+--
+-- bypass of point queries and DML on range partitioned tables
+--
+set enable_opfusion = on;
+set enable_seqscan = off;
+set enable_bitmapscan = off;
+set opfusion_debug_mode = 'log';
+create table bp_part (a int, b int, c text) partition by range (a)
+(
+    partition bp_part_p1 values less than (100),
+    partition bp_part_p2 values less than (200),
+    partition bp_part_p3 values less than (maxvalue)
+);
+create index bp_part_a_idx on bp_part (a) local;
+create index bp_part_b_idx on bp_part (b) local;
+insert into bp_part select i, i * 2, 'v' || i from generate_series(1, 300) i;
+
+-- point queries
+explain (costs off) select b, c from bp_part where a = 150;
+select b, c from bp_part where a = 150;
+select b, c from bp_part where a = 50;
+select b, c from bp_part where a = 250;
+select b, c from bp_part where a = 1000;
+explain (costs off) select b from bp_part where a = 150 for update;
+select b from bp_part where a = 150 for update;
+
+-- DML
+explain (costs off) insert into bp_part values (301, 602, 'v301');
+insert into bp_part values (301, 602, 'v301');
+insert into bp_part values (99, 0, 'dup99');
+select b, c from bp_part where a = 301;
+select c from bp_part where a = 99 order by c;
+explain (costs off) update bp_part set c = 'u150' where a = 150;
+update bp_part set c = 'u150' where a = 150;
+update bp_part set b = -1 where a = 99;
+select a, b, c from bp_part where a = 150 or a = 99 order by a, c;
+explain (costs off) delete from bp_part where a = 150;
+delete from bp_part where a = 150;
+delete from bp_part where a = 99;
+select count(*) from bp_part;
+select b, c from bp_part where a = 150;
+
+-- the index conditions must decide the partition
+explain (costs off) select a from bp_part where b = 10;
+select a from bp_part where b = 10;
+explain (costs off) update bp_part set a = 151 where a = 151;
+
+-- generic plans route the partition from the parameters
+prepare bp_sel(int) as select c from bp_part where a = $1;
+execute bp_sel(10);
+execute bp_sel(110);
+execute bp_sel(210);
+execute bp_sel(20);
+execute bp_sel(120);
+execute bp_sel(220);
+execute bp_sel(150);
+prepare bp_upd(int, text) as update bp_part set c = $2 where a = $1;
+execute bp_upd(30, 'e30');
+execute bp_upd(130, 'e130');
+execute bp_upd(230, 'e230');
+execute bp_upd(40, 'e40');
+execute bp_upd(140, 'e140');
+execute bp_upd(240, 'e240');
+select a, c from bp_part where c like 'e%' order by a;
+deallocate bp_sel;
+deallocate bp_upd;
+
+drop table bp_part;
+reset opfusion_debug_mode;
+reset enable_bitmapscan;
+reset enable_seqscan;
+reset enable_opfusion;
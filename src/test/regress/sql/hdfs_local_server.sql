@@ -0,0 +1,29 @@
+--
+-- foreign tables of an hdfs_fdw server of the local type read files of the datanodes
+--
+CREATE SERVER local_server FOREIGN DATA WRAPPER hdfs_fdw OPTIONS (type 'local');
+CREATE FOREIGN TABLE local_orc (a int, b text) SERVER local_server
+    OPTIONS (format 'orc', foldername '/tmp/local_orc/') DISTRIBUTE BY ROUNDROBIN;
+CREATE FOREIGN TABLE local_parquet (a int, b text) SERVER local_server
+    OPTIONS (format 'parquet', filenames '/tmp/local_parquet/part1,/tmp/local_parquet/part2') DISTRIBUTE BY ROUNDROBIN;
+-- only orc and parquet files are read
+CREATE FOREIGN TABLE local_text (a int, b text) SERVER local_server
+    OPTIONS (format 'text', foldername '/tmp/local_text/') DISTRIBUTE BY ROUNDROBIN;
+-- a user with usage on the server cannot choose which files are read
+CREATE USER local_fdw_user PASSWORD 'Gauss@123';
+GRANT USAGE ON FOREIGN SERVER local_server TO local_fdw_user;
+ALTER FOREIGN TABLE local_orc OWNER TO local_fdw_user;
+SET SESSION AUTHORIZATION local_fdw_user PASSWORD 'Gauss@123';
+CREATE FOREIGN TABLE local_user_orc (a int, b text) SERVER local_server
+    OPTIONS (format 'orc', foldername '/tmp/') DISTRIBUTE BY ROUNDROBIN;
+CREATE FOREIGN TABLE local_user_parquet (a int, b text) SERVER local_server
+    OPTIONS (format 'parquet', filenames '/tmp/local_parquet/part1') DISTRIBUTE BY ROUNDROBIN;
+-- nor change them for a table it owns
+ALTER FOREIGN TABLE local_orc OPTIONS (SET foldername '/tmp/');
+RESET SESSION AUTHORIZATION;
+ALTER FOREIGN TABLE local_orc OPTIONS (SET foldername '/tmp/local_orc2/');
+SELECT relname, ftoptions FROM pg_foreign_table, pg_class WHERE ftrelid = pg_class.oid AND relname IN ('local_orc', 'local_parquet') ORDER BY relname;
+DROP FOREIGN TABLE local_orc;
+DROP FOREIGN TABLE local_parquet;
+DROP SERVER local_server;
+DROP USER local_fdw_user CASCADE;
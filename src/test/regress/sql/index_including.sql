@@ -0,0 +1,51 @@
+--
+-- INCLUDE columns of btree indexes
+--
+CREATE TABLE tbl_include (c1 int, c2 int, c3 int, c4 box);
+INSERT INTO tbl_include SELECT x, 2 * x, 3 * x, box('4,4,4,4') FROM generate_series(1, 10) x;
+-- the included columns need no operator class, box has none for btree
+CREATE INDEX tbl_include_idx ON tbl_include USING btree (c1, c2) INCLUDE (c3, c4);
+SELECT indnatts, indnkeyatts, indclass, indoption FROM pg_index WHERE indexrelid = 'tbl_include_idx'::regclass;
+SELECT pg_get_indexdef('tbl_include_idx'::regclass);
+-- uniqueness is checked on the key columns only
+CREATE UNIQUE INDEX tbl_include_uidx ON tbl_include (c1, c2) INCLUDE (c3);
+INSERT INTO tbl_include VALUES (1, 2, 30, NULL);
+INSERT INTO tbl_include VALUES (1, 3, 3, NULL);
+SELECT pg_get_indexdef('tbl_include_uidx'::regclass);
+\d tbl_include
+-- expressions and ordering options are for key columns only
+CREATE INDEX tbl_include_expr ON tbl_include (c1) INCLUDE ((c2 + 1));
+CREATE INDEX tbl_include_desc ON tbl_include (c1) INCLUDE (c2 DESC);
+-- only btree supports included columns
+CREATE TABLE tbl_include_gin (a int[], b int);
+CREATE INDEX tbl_include_gin_idx ON tbl_include_gin USING gin (a) INCLUDE (b);
+DROP TABLE tbl_include_gin;
+-- PRIMARY KEY, only the key columns are made NOT NULL
+CREATE TABLE tbl_include_pk (c1 int, c2 int, c3 int, c4 int, CONSTRAINT tbl_include_pk_pkey PRIMARY KEY (c1, c2) INCLUDE (c3, c4));
+INSERT INTO tbl_include_pk VALUES (1, 2, 3, 4), (1, 3, NULL, 4), (2, 2, 3, 4);
+INSERT INTO tbl_include_pk VALUES (1, 2, 5, 6);
+INSERT INTO tbl_include_pk VALUES (NULL, 2, 3, 4);
+\d tbl_include_pk
+-- an index-only scan returns the included columns, a qual on them is a filter
+VACUUM tbl_include_pk;
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+EXPLAIN (COSTS OFF) SELECT c1, c2, c3, c4 FROM tbl_include_pk WHERE c1 = 1 ORDER BY c2;
+SELECT c1, c2, c3, c4 FROM tbl_include_pk WHERE c1 = 1 ORDER BY c2;
+EXPLAIN (COSTS OFF) SELECT c1, c2 FROM tbl_include_pk WHERE c1 > 0 AND c3 = 3;
+SELECT c1, c2 FROM tbl_include_pk WHERE c1 > 0 AND c3 = 3 ORDER BY c1, c2;
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+-- UNIQUE constraint added to an existing table
+CREATE TABLE tbl_include_uq (c1 int, c2 int, c3 int, c4 int);
+ALTER TABLE tbl_include_uq ADD CONSTRAINT tbl_include_uq_key UNIQUE (c1, c2) INCLUDE (c3, c4);
+INSERT INTO tbl_include_uq VALUES (1, 2, 3, 4), (NULL, 2, 3, 4), (NULL, 2, 3, 4);
+INSERT INTO tbl_include_uq VALUES (1, 2, 30, 40);
+\d tbl_include_uq
+-- dropping an included column drops the index and its constraint
+ALTER TABLE tbl_include_pk DROP COLUMN c4;
+\d tbl_include_pk
+SELECT count(*) FROM pg_constraint WHERE conrelid = 'tbl_include_pk'::regclass;
+DROP TABLE tbl_include;
+DROP TABLE tbl_include_pk;
+DROP TABLE tbl_include_uq;
@@ -0,0 +1,77 @@
+--
+-- jsonb: input and output, containment and existence, casts, GIN index
+--
+-- keys are sorted by length and then bytes, the last of duplicated keys wins
+SELECT '{"b": 2, "a": 1}'::jsonb;
+SELECT '{"bb": 1, "a": 2, "c": 3}'::jsonb;
+SELECT '[1, "two", null, true, false, 1.50, 1e2]'::jsonb;
+SELECT '  "a\"b\tc"  '::jsonb;
+SELECT '42'::jsonb;
+SELECT '{}'::jsonb;
+SELECT '[]'::jsonb;
+SELECT '{"a": 1, "b": 2, "a": 3}'::jsonb;
+SELECT '{"o": {"zz": 1, "y": {"b": 1, "a": 2, "b": 3}}, "o2": [{"k": 1, "k": 2}]}'::jsonb;
+SELECT '{"a": {"c": [1, {"d": 2}]}, "a": {"x": 1}}'::jsonb;
+SELECT '{"a":1,3}'::jsonb;
+-- field and element access
+SELECT '{"a": {"b": [1, "x"]}}'::jsonb -> 'a' -> 'b', '{"a": {"b": [1, "x"]}}'::jsonb -> 'a' -> 'b' ->> 1;
+-- containment
+SELECT '{"a": 1, "b": {"c": 2, "d": 3}}'::jsonb @> '{"b": {"c": 2}}' AS sub,
+       '{"a": 1, "b": {"c": 2, "d": 3}}'::jsonb @> '{"b": {"c": 3}}' AS wrong_value,
+       '{"a": 1.0}'::jsonb @> '{"a": 1}' AS numeric_scale,
+       '{"a": [1, 2]}'::jsonb @> '{"a": 1}' AS scalar_in_array;
+SELECT '[1, 2, [3, 4]]'::jsonb @> '[[3], 1]' AS nested,
+       '[1, 2]'::jsonb @> '[1, 2, 2]' AS repeated,
+       '[1, 2]'::jsonb @> '{"a": 1}' AS kinds,
+       '{"a": 1}'::jsonb <@ '{"a": 1, "b": 2}' AS contained,
+       '{"a": 1, "b": 2}'::jsonb <@ '{"a": 1}' AS not_contained;
+-- existence of top-level keys and array strings
+SELECT '{"a": 1, "b": {"c": 2}}'::jsonb ? 'a' AS key,
+       '{"a": 1, "b": {"c": 2}}'::jsonb ? 'c' AS nested_key,
+       '["a", "b", 1]'::jsonb ? 'b' AS array_string,
+       '["a", "b", 1]'::jsonb ? '1' AS array_number,
+       '"a"'::jsonb ? 'a' AS scalar;
+SELECT '{"a": 1, "b": 2}'::jsonb ?| ARRAY['x', 'b'] AS any_one,
+       '{"a": 1, "b": 2}'::jsonb ?| ARRAY['x', 'y'] AS any_none,
+       '{"a": 1, "b": 2}'::jsonb ?& ARRAY['a', 'b'] AS all_keys,
+       '{"a": 1, "b": 2}'::jsonb ?& ARRAY['a', 'x'] AS all_missing,
+       '{"a": 1}'::jsonb ?& ARRAY[]::text[] AS all_empty;
+-- casts from and to json
+SELECT '{"b": 1, "a": [1,  2], "b": 3}'::json::jsonb;
+SELECT '{"b":1,"a":{"d":true,"c":null}}'::jsonb::json;
+SELECT '[1,"x"]'::json::jsonb::json;
+-- GIN index, the operators always recheck the heap tuple
+CREATE TABLE jsonb_tbl (id int, j jsonb);
+INSERT INTO jsonb_tbl SELECT i, CASE WHEN i % 100 = 0 THEN NULL
+                                        WHEN i % 3 = 0 THEN ('["t' || i % 10 || '", ' || i || ']')::jsonb
+                                        ELSE ('{"id": ' || i || ', "tag": "t' || i % 10 || '", "arr": [' || i % 7 || ', "s' || i % 5 || '"]}')::jsonb END
+    FROM generate_series(1, 1000) i;
+SELECT count(*) FROM jsonb_tbl WHERE j @> '{"tag": "t3"}';
+SELECT count(*) FROM jsonb_tbl WHERE j @> '{"arr": [4]}';
+SELECT count(*) FROM jsonb_tbl WHERE j @> '{"tag": "t7", "arr": ["s2"]}';
+SELECT count(*) FROM jsonb_tbl WHERE j @> '{"id": 4}';
+SELECT count(*) FROM jsonb_tbl WHERE j @> '[6]';
+SELECT count(*) FROM jsonb_tbl WHERE j ? 'tag';
+SELECT count(*) FROM jsonb_tbl WHERE j ? 't5';
+SELECT count(*) FROM jsonb_tbl WHERE j ?| ARRAY['t1', 't2'];
+SELECT count(*) FROM jsonb_tbl WHERE j ?& ARRAY['id', 'arr'];
+SELECT id, j FROM jsonb_tbl WHERE j @> '{"tag": "t3", "arr": [4]}' ORDER BY id;
+CREATE INDEX jsonb_tbl_j_idx ON jsonb_tbl USING gin (j);
+SET enable_seqscan = off;
+EXPLAIN (COSTS OFF) SELECT count(*) FROM jsonb_tbl WHERE j @> '{"tag": "t3"}';
+EXPLAIN (COSTS OFF) SELECT count(*) FROM jsonb_tbl WHERE j ? 'tag';
+EXPLAIN (COSTS OFF) SELECT count(*) FROM jsonb_tbl WHERE j ?| ARRAY['t1', 't2'];
+EXPLAIN (COSTS OFF) SELECT count(*) FROM jsonb_tbl WHERE j ?& ARRAY['id', 'arr'];
+-- the same results as the sequential scan; for {"id": 4} the index finds every row with an "id" key and a 4, the recheck keeps one
+SELECT count(*) FROM jsonb_tbl WHERE j @> '{"tag": "t3"}';
+SELECT count(*) FROM jsonb_tbl WHERE j @> '{"arr": [4]}';
+SELECT count(*) FROM jsonb_tbl WHERE j @> '{"tag": "t7", "arr": ["s2"]}';
+SELECT count(*) FROM jsonb_tbl WHERE j @> '{"id": 4}';
+SELECT count(*) FROM jsonb_tbl WHERE j @> '[6]';
+SELECT count(*) FROM jsonb_tbl WHERE j ? 'tag';
+SELECT count(*) FROM jsonb_tbl WHERE j ? 't5';
+SELECT count(*) FROM jsonb_tbl WHERE j ?| ARRAY['t1', 't2'];
+SELECT count(*) FROM jsonb_tbl WHERE j ?& ARRAY['id', 'arr'];
+SELECT id, j FROM jsonb_tbl WHERE j @> '{"tag": "t3", "arr": [4]}' ORDER BY id;
+RESET enable_seqscan;
+DROP TABLE jsonb_tbl;
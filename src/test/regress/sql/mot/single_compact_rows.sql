@@ -0,0 +1,53 @@
+--
+-- MOT rows with variable length columns move between row pools as their data grows and shrinks
+--
+CREATE FOREIGN TABLE compact_fixed (id integer primary key, a integer, b bigint, c char(20)) SERVER mot_server;
+CREATE FOREIGN TABLE compact_var (id integer primary key, k integer not null, s varchar(10), v varchar(2000)) SERVER mot_server;
+CREATE INDEX compact_var_k ON compact_var (k);
+INSERT INTO compact_fixed SELECT i, i, i * 10, 'row ' || i FROM generate_series(1, 100) AS i;
+-- new rows of all the size classes
+INSERT INTO compact_var SELECT i, i % 10, 'r' || i, repeat(chr(97 + i % 26), i * 20) FROM generate_series(1, 100) AS i;
+SELECT count(*), sum(length(s)) AS s, sum(length(v)) AS v FROM compact_var;
+-- a row grows through the size classes up to a full row and shrinks back
+UPDATE compact_var SET v = repeat('g', 40) WHERE id = 1;
+UPDATE compact_var SET v = repeat('g', 300) WHERE id = 1;
+UPDATE compact_var SET v = repeat('g', 1999) WHERE id = 1;
+SELECT id, k, s, length(v), substr(v, 1995) FROM compact_var WHERE id = 1;
+UPDATE compact_var SET v = 'tiny' WHERE id = 1;
+SELECT id, k, s, v FROM compact_var WHERE id = 1;
+-- an update of another column keeps the last one, a NULL last column shrinks the row
+UPDATE compact_var SET s = 'short' WHERE id = 100;
+UPDATE compact_var SET v = NULL WHERE id = 50;
+SELECT id, s, length(v), substr(v, 1, 3), v IS NULL AS isnull FROM compact_var WHERE id IN (50, 100) ORDER BY id;
+-- moved rows are found through the secondary index
+UPDATE compact_var SET v = repeat('m', id) WHERE k = 3;
+SELECT count(*), sum(length(v)) FROM compact_var WHERE k = 3;
+SELECT id, length(v) FROM compact_var WHERE k = 3 AND id > 80 ORDER BY id;
+-- several moves of a row in one transaction, and an insert after a delete
+START TRANSACTION;
+UPDATE compact_var SET v = repeat('t', 1500) WHERE id = 2;
+UPDATE compact_var SET v = repeat('t', 10) WHERE id = 2;
+DELETE FROM compact_var WHERE id = 4;
+INSERT INTO compact_var VALUES (4, 4, 'again', repeat('n', 700));
+COMMIT;
+SELECT id, k, s, length(v) FROM compact_var WHERE id IN (2, 4) ORDER BY id;
+-- the row copies of a transaction that does not commit are released
+START TRANSACTION;
+UPDATE compact_var SET v = repeat('r', 1800) WHERE id BETWEEN 5 AND 9;
+ROLLBACK;
+START TRANSACTION;
+UPDATE compact_var SET v = repeat('p', 1900) WHERE id = 10;
+PREPARE TRANSACTION 'compact_rows_1';
+ROLLBACK PREPARED 'compact_rows_1';
+START TRANSACTION;
+UPDATE compact_var SET v = repeat('p', 1900) WHERE id = 11;
+PREPARE TRANSACTION 'compact_rows_2';
+COMMIT PREPARED 'compact_rows_2';
+SELECT id, length(v) FROM compact_var WHERE id BETWEEN 5 AND 11 ORDER BY id;
+-- rows of a table without variable length columns stay in place
+UPDATE compact_fixed SET c = 'updated ' || id, b = b + 1 WHERE id % 10 = 0;
+SELECT count(*), sum(b), sum(CASE WHEN c LIKE 'updated%' THEN 1 ELSE 0 END) AS updated FROM compact_fixed;
+-- the data of all the rows
+SELECT sum(length(v)), count(v) FROM compact_var;
+DROP FOREIGN TABLE compact_fixed;
+DROP FOREIGN TABLE compact_var;
@@ -0,0 +1,81 @@
+--
+-- MOT statements run from PL/pgSQL procedures
+-- fastcheck_single_mot turns enable_mot_procedure_codegen on in mot.conf, so these statements are jitted
+--
+CREATE FOREIGN TABLE proc_jit_tbl (id integer primary key, val integer, note varchar(20)) SERVER mot_server;
+CREATE FUNCTION proc_jit_insert(n integer) RETURNS integer AS $$
+DECLARE
+    cnt integer := 0;
+    rc integer;
+BEGIN
+    FOR i IN 1..n LOOP
+        INSERT INTO proc_jit_tbl VALUES (i, i * 10, 'row ' || i);
+        GET DIAGNOSTICS rc = ROW_COUNT;
+        cnt := cnt + rc;
+    END LOOP;
+    RETURN cnt;
+END;
+$$ LANGUAGE plpgsql;
+CREATE FUNCTION proc_jit_select(k integer) RETURNS integer AS $$
+DECLARE
+    v integer;
+BEGIN
+    SELECT val INTO v FROM proc_jit_tbl WHERE id = k;
+    IF NOT FOUND THEN
+        RETURN -1;
+    END IF;
+    RETURN v;
+END;
+$$ LANGUAGE plpgsql;
+CREATE FUNCTION proc_jit_update(lo integer, hi integer) RETURNS integer AS $$
+DECLARE
+    cnt integer := 0;
+BEGIN
+    FOR k IN lo..hi LOOP
+        UPDATE proc_jit_tbl SET val = val + 1 WHERE id = k;
+        IF FOUND THEN
+            cnt := cnt + 1;
+        END IF;
+    END LOOP;
+    RETURN cnt;
+END;
+$$ LANGUAGE plpgsql;
+CREATE FUNCTION proc_jit_delete(k integer) RETURNS integer AS $$
+DECLARE
+    rc integer;
+BEGIN
+    DELETE FROM proc_jit_tbl WHERE id = k;
+    GET DIAGNOSTICS rc = ROW_COUNT;
+    RETURN rc;
+END;
+$$ LANGUAGE plpgsql;
+-- row counts and FOUND come from the executor whether or not the statement is jitted
+SELECT proc_jit_insert(10);
+SELECT proc_jit_select(3);
+SELECT proc_jit_select(42);
+SELECT proc_jit_update(1, 12);
+SELECT proc_jit_select(3);
+SELECT proc_jit_delete(5);
+SELECT proc_jit_delete(5);
+SELECT count(*), sum(val) FROM proc_jit_tbl;
+-- a search_path change makes the saved plans analyze their queries again
+CREATE SCHEMA proc_jit_schema;
+SET search_path = proc_jit_schema, public;
+SELECT proc_jit_update(1, 3);
+SELECT proc_jit_select(3);
+RESET search_path;
+SELECT id, val, note FROM proc_jit_tbl ORDER BY id;
+-- table privileges are checked for jitted statements too
+CREATE USER proc_jit_user PASSWORD 'jit@12345';
+SET SESSION AUTHORIZATION proc_jit_user PASSWORD 'jit@12345';
+SELECT proc_jit_delete(3);
+SELECT proc_jit_update(1, 3);
+RESET SESSION AUTHORIZATION;
+SELECT proc_jit_select(3);
+DROP USER proc_jit_user;
+DROP SCHEMA proc_jit_schema;
+DROP FUNCTION proc_jit_insert(integer);
+DROP FUNCTION proc_jit_select(integer);
+DROP FUNCTION proc_jit_update(integer, integer);
+DROP FUNCTION proc_jit_delete(integer);
+DROP FOREIGN TABLE proc_jit_tbl;
@@ -0,0 +1,213 @@
+--
+-- Vectorized scan of MOT tables, checked against the row scan
+--
+CREATE FOREIGN TABLE vec_scan_tbl (
+    id integer primary key,
+    i1 tinyint,
+    b boolean,
+    i2 smallint,
+    i8 bigint,
+    f4 float4,
+    f8 float8,
+    n numeric(14,4),
+    vc varchar(30),
+    c char(12),
+    t text,
+    by bytea,
+    ts timestamp,
+    tm time,
+    iv interval
+) SERVER mot_server;
+-- more rows than fit in one batch, with NULLs spread over all nullable columns
+INSERT INTO vec_scan_tbl SELECT i,
+    case when i % 17 = 0 then null else (i % 200)::tinyint end,
+    case when i % 19 = 0 then null else i % 3 = 0 end,
+    case when i % 23 = 0 then null else (i % 1000 - 500)::smallint end,
+    i::bigint * 1000000007,
+    case when i % 31 = 0 then null else i / 4.0 end,
+    i / 8.0,
+    case when i % 13 = 0 then null else i * 1.2345 end,
+    case when i % 11 = 0 then null else 'vc' || i end,
+    'c' || (i % 50),
+    case when i % 7 = 0 then null else 'tx' || repeat('z', i % 5 + 1) || i end,
+    case when i % 29 = 0 then null else decode(lpad(to_hex(i), 8, '0'), 'hex') end,
+    timestamp '2020-01-01 00:00:00' + i * interval '1 minute',
+    case when i % 37 = 0 then null else time '00:00:00' + i * interval '1 second' end,
+    i * interval '1 hour'
+FROM generate_series(1, 3000) AS i;
+CREATE FUNCTION vec_scan_plan(query text) RETURNS text AS $$
+DECLARE
+    r record;
+BEGIN
+    FOR r IN EXECUTE 'EXPLAIN (COSTS OFF) ' || query LOOP
+        IF r."QUERY PLAN" LIKE '%Vector Foreign Scan%' THEN
+            RETURN 'vector';
+        END IF;
+    END LOOP;
+    RETURN 'row';
+END;
+$$ LANGUAGE plpgsql;
+SET enable_vector_engine = on;
+-- all column types and NULLs through a range scan of the primary key
+SELECT vec_scan_plan($q$SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id <= 40 ORDER BY id$q$);
+SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id <= 40 ORDER BY id;
+-- local quals on boolean, varchar and numeric columns are evaluated on the batch
+SELECT vec_scan_plan($q$SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id < 100 AND b AND vc IS NOT NULL AND n > 50 ORDER BY id$q$);
+SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id < 100 AND b AND vc IS NOT NULL AND n > 50 ORDER BY id;
+-- full scan over several batches filtered by a local qual
+SELECT vec_scan_plan($q$SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id % 100 = 0 ORDER BY id$q$);
+SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id % 100 = 0 ORDER BY id;
+-- aggregates over ranges longer than one batch
+SELECT vec_scan_plan($q$SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl$q$);
+SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl;
+SELECT vec_scan_plan($q$SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id BETWEEN 101 AND 2600$q$);
+SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id BETWEEN 101 AND 2600;
+SELECT vec_scan_plan($q$SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id > 1500$q$);
+SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id > 1500;
+SELECT vec_scan_plan($q$SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id < 2100 AND i2 > 0 AND t LIKE '%zzz%'$q$);
+SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id < 2100 AND i2 > 0 AND t LIKE '%zzz%';
+SELECT vec_scan_plan($q$SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE by IS NULL OR tm IS NULL OR f4 IS NULL$q$);
+SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE by IS NULL OR tm IS NULL OR f4 IS NULL;
+-- a unique key lookup keeps the row scan
+SELECT vec_scan_plan($q$SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id = 42$q$);
+SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id = 42;
+-- the same queries through the row scan
+SET enable_vector_engine = off;
+-- all column types and NULLs through a range scan of the primary key
+SELECT vec_scan_plan($q$SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id <= 40 ORDER BY id$q$);
+SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id <= 40 ORDER BY id;
+-- local quals on boolean, varchar and numeric columns are evaluated on the batch
+SELECT vec_scan_plan($q$SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id < 100 AND b AND vc IS NOT NULL AND n > 50 ORDER BY id$q$);
+SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id < 100 AND b AND vc IS NOT NULL AND n > 50 ORDER BY id;
+-- full scan over several batches filtered by a local qual
+SELECT vec_scan_plan($q$SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id % 100 = 0 ORDER BY id$q$);
+SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id % 100 = 0 ORDER BY id;
+-- aggregates over ranges longer than one batch
+SELECT vec_scan_plan($q$SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl$q$);
+SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl;
+SELECT vec_scan_plan($q$SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id BETWEEN 101 AND 2600$q$);
+SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id BETWEEN 101 AND 2600;
+SELECT vec_scan_plan($q$SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id > 1500$q$);
+SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id > 1500;
+SELECT vec_scan_plan($q$SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id < 2100 AND i2 > 0 AND t LIKE '%zzz%'$q$);
+SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE id < 2100 AND i2 > 0 AND t LIKE '%zzz%';
+SELECT vec_scan_plan($q$SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE by IS NULL OR tm IS NULL OR f4 IS NULL$q$);
+SELECT count(*), sum(i1::integer) AS i1, count(b) AS b, sum(i2) AS i2, sum(i8) AS i8,
+    sum(f4::float8) AS f4, sum(f8) AS f8, sum(n) AS n, sum(length(vc)) AS vc, sum(length(c)) AS c,
+    sum(length(t)) AS t, sum(octet_length(by)) AS by, count(ts) AS ts, count(tm) AS tm,
+    sum(extract(epoch FROM iv)) AS iv
+FROM vec_scan_tbl WHERE by IS NULL OR tm IS NULL OR f4 IS NULL;
+-- a unique key lookup keeps the row scan
+SELECT vec_scan_plan($q$SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id = 42$q$);
+SELECT id, i1, b, i2, i8, f4, f8, n, vc, c, t, encode(by, 'hex') AS by,
+    to_char(ts, 'YYYY-MM-DD HH24:MI:SS') AS ts, tm, extract(epoch FROM iv) AS iv
+FROM vec_scan_tbl WHERE id = 42;
+RESET enable_vector_engine;
+DROP FUNCTION vec_scan_plan(text);
+DROP FOREIGN TABLE vec_scan_tbl;
@@ -0,0 +1,11 @@
+--
+-- pg_stat_parallel_decoding: progress of the logical walsenders
+--
+-- no logical walsender runs during the regression tests, the view is empty
+SELECT * FROM pg_stat_parallel_decoding;
+SELECT oid, proname, proretset, provolatile, pg_get_function_result(oid) FROM pg_proc WHERE proname = 'pg_stat_get_parallel_decode';
+-- the workers of each logical walsender
+SHOW logical_decoding_parallel_workers;
+SET logical_decoding_parallel_workers = 20;
+SET logical_decoding_parallel_workers = 21;
+RESET logical_decoding_parallel_workers;
@@ -0,0 +1,56 @@
+--
+-- Partition pruning at run time, with bound parameters and with outer values
+--
+CREATE TABLE rtp (a int, b int)
+PARTITION BY RANGE (a)
+(
+    PARTITION rtp_p1 VALUES LESS THAN (100),
+    PARTITION rtp_p2 VALUES LESS THAN (200),
+    PARTITION rtp_p3 VALUES LESS THAN (300),
+    PARTITION rtp_p4 VALUES LESS THAN (400)
+);
+INSERT INTO rtp SELECT i, i % 7 FROM generate_series(0, 399) i;
+CREATE INDEX rtp_a_idx ON rtp (a) LOCAL;
+CREATE TABLE rtp_outer (x int);
+INSERT INTO rtp_outer VALUES (50), (150), (250), (350), (450);
+ANALYZE rtp;
+ANALYZE rtp_outer;
+-- a generic plan prunes with the bound parameters at executor start
+SET plan_cache_mode = force_generic_plan;
+SET enable_indexscan = off;
+SET enable_bitmapscan = off;
+PREPARE rtp_range(int, int) AS SELECT count(*), min(a), max(a) FROM rtp WHERE a >= $1 AND a < $2;
+EXPLAIN (COSTS OFF) EXECUTE rtp_range(150, 250);
+EXECUTE rtp_range(150, 250);
+EXECUTE rtp_range(0, 50);
+EXECUTE rtp_range(95, 305);
+-- all the partitions pruned
+EXPLAIN (COSTS OFF) EXECUTE rtp_range(400, 500);
+EXECUTE rtp_range(400, 500);
+EXECUTE rtp_range(NULL, 100);
+-- backward scan of the partitions left
+RESET enable_indexscan;
+SET enable_seqscan = off;
+PREPARE rtp_desc(int, int) AS SELECT a, b FROM rtp WHERE a >= $1 AND a < $2 ORDER BY a DESC LIMIT 5;
+EXPLAIN (COSTS OFF) EXECUTE rtp_desc(150, 250);
+EXECUTE rtp_desc(150, 250);
+EXECUTE rtp_desc(95, 202);
+EXECUTE rtp_desc(2, 103);
+EXECUTE rtp_desc(500, 600);
+DEALLOCATE rtp_range;
+DEALLOCATE rtp_desc;
+RESET plan_cache_mode;
+-- the inner side of a nestloop prunes again with each outer value
+SET enable_hashjoin = off;
+SET enable_mergejoin = off;
+EXPLAIN (COSTS OFF)
+SELECT count(*), sum(r.b) FROM rtp_outer o JOIN rtp r ON r.a >= o.x AND r.a < o.x + 60;
+SELECT count(*), sum(r.b) FROM rtp_outer o JOIN rtp r ON r.a >= o.x AND r.a < o.x + 60;
+SELECT x, (SELECT count(*) FROM rtp WHERE a >= o.x AND a < o.x + 60) AS cnt FROM rtp_outer o ORDER BY x;
+SELECT count(*) FROM rtp WHERE a >= (SELECT 150) AND a < (SELECT 250);
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+RESET enable_hashjoin;
+RESET enable_mergejoin;
+DROP TABLE rtp_outer;
+DROP TABLE rtp;
@@ -0,0 +1,63 @@
+--
+-- LZ4 compressed spill files of the row engine
+--
+CREATE TABLE compress_spill_tbl (id int8, grp int8, pad text);
+INSERT INTO compress_spill_tbl SELECT x, x % 100, repeat(md5(x::text), 2) FROM generate_series(1, 20000) x;
+CREATE TABLE compress_spill_dup AS SELECT id, pad FROM compress_spill_tbl WHERE id % 10 = 0;
+INSERT INTO compress_spill_dup SELECT id, pad FROM compress_spill_dup;
+ANALYZE compress_spill_tbl;
+ANALYZE compress_spill_dup;
+SET work_mem = '64kB';
+SET enable_compress_spill = on;
+-- an external sort reports the raw and compressed bytes it spilled
+EXPLAIN (ANALYZE on, COSTS off, TIMING off) SELECT id FROM compress_spill_tbl ORDER BY pad;
+-- sort, hash join batches, merge join mark and restore over sorted tapes, CTE read twice
+SELECT sum(rn * id) FROM (SELECT id, row_number() OVER (ORDER BY pad) rn FROM compress_spill_tbl) s;
+SET enable_mergejoin = off;
+SET enable_nestloop = off;
+SELECT count(*), sum(a.id * b.grp) FROM compress_spill_tbl a JOIN compress_spill_tbl b ON a.pad = b.pad;
+RESET enable_mergejoin;
+SET enable_hashjoin = off;
+SELECT count(*), sum(d1.id + d2.id) FROM compress_spill_dup d1 JOIN compress_spill_dup d2 ON d1.pad = d2.pad;
+RESET enable_hashjoin;
+RESET enable_nestloop;
+WITH c AS (SELECT id, pad FROM compress_spill_tbl) SELECT (SELECT count(*) FROM c WHERE pad > 'f') AS f, (SELECT max(id) FROM c) AS max;
+-- a scrollable cursor reads the sorted tape backward and rewinds it
+BEGIN;
+DECLARE c SCROLL CURSOR FOR SELECT id FROM compress_spill_tbl ORDER BY pad;
+FETCH 3 FROM c;
+FETCH LAST FROM c;
+FETCH BACKWARD 2 FROM c;
+FETCH ABSOLUTE 10000 FROM c;
+FETCH RELATIVE -5000 FROM c;
+FETCH FIRST FROM c;
+FETCH PRIOR FROM c;
+FETCH NEXT FROM c;
+CLOSE c;
+COMMIT;
+-- a holdable cursor keeps its rows in a tuplestore that spills
+BEGIN;
+DECLARE h SCROLL CURSOR WITH HOLD FOR SELECT id FROM compress_spill_tbl ORDER BY id;
+COMMIT;
+FETCH LAST FROM h;
+FETCH ABSOLUTE 12345 FROM h;
+FETCH BACKWARD 2 FROM h;
+FETCH FIRST FROM h;
+CLOSE h;
+-- the same results from uncompressed spill files
+SET enable_compress_spill = off;
+EXPLAIN (ANALYZE on, COSTS off, TIMING off) SELECT id FROM compress_spill_tbl ORDER BY pad;
+SELECT sum(rn * id) FROM (SELECT id, row_number() OVER (ORDER BY pad) rn FROM compress_spill_tbl) s;
+SET enable_mergejoin = off;
+SET enable_nestloop = off;
+SELECT count(*), sum(a.id * b.grp) FROM compress_spill_tbl a JOIN compress_spill_tbl b ON a.pad = b.pad;
+RESET enable_mergejoin;
+SET enable_hashjoin = off;
+SELECT count(*), sum(d1.id + d2.id) FROM compress_spill_dup d1 JOIN compress_spill_dup d2 ON d1.pad = d2.pad;
+RESET enable_hashjoin;
+RESET enable_nestloop;
+WITH c AS (SELECT id, pad FROM compress_spill_tbl) SELECT (SELECT count(*) FROM c WHERE pad > 'f') AS f, (SELECT max(id) FROM c) AS max;
+RESET enable_compress_spill;
+RESET work_mem;
+DROP TABLE compress_spill_tbl;
+DROP TABLE compress_spill_dup;
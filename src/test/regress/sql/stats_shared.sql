@@ -0,0 +1,22 @@
+--
+-- Table statistics kept in shared memory: flush, reset and drop
+--
+SHOW track_stat_tables;
+CREATE TABLE stats_shared(a int);
+INSERT INTO stats_shared SELECT generate_series(1, 100);
+DELETE FROM stats_shared WHERE a <= 10;
+-- a session adds its counts to the shared entries when it goes idle, at most every 500ms
+SELECT pg_sleep(1.0);
+SELECT n_tup_ins, n_tup_del, n_live_tup, n_dead_tup FROM pg_stat_user_tables WHERE relname = 'stats_shared';
+-- a reset removes the shared entry, new counts start from zero
+SELECT pg_stat_reset_single_table_counters('stats_shared'::regclass);
+SELECT n_tup_ins, n_tup_del, n_live_tup, n_dead_tup FROM pg_stat_user_tables WHERE relname = 'stats_shared';
+INSERT INTO stats_shared SELECT generate_series(101, 105);
+SELECT pg_sleep(1.0);
+SELECT n_tup_ins, n_tup_del, n_live_tup, n_dead_tup FROM pg_stat_user_tables WHERE relname = 'stats_shared';
+-- the entry of a dropped table is removed by the next VACUUM
+CREATE TABLE stats_shared_oid AS SELECT 'stats_shared'::regclass::oid AS relid;
+DROP TABLE stats_shared;
+VACUUM stats_shared_oid;
+SELECT pg_stat_get_tuples_inserted(relid), pg_stat_get_live_tuples(relid) FROM stats_shared_oid;
+DROP TABLE stats_shared_oid;
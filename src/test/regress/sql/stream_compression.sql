@@ -0,0 +1,10 @@
+--
+-- compression of the replication streams, as pg_stat_replication reports it
+--
+SELECT pg_get_function_result('pg_stat_get_wal_senders'::regproc);
+SELECT attnum, attname, format_type(atttypid, atttypmod) FROM pg_attribute
+    WHERE attrelid = 'pg_stat_replication'::regclass AND attnum > 15 ORDER BY attnum;
+SELECT compression, raw_bytes, compressed_bytes, compression_ratio, compress_time FROM pg_stat_replication WHERE false;
+-- a standby asks for a compressed stream when it connects
+SHOW enable_stream_compression;
+SET enable_stream_compression = on;
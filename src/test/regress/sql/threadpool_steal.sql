@@ -0,0 +1,13 @@
+--
+-- Sessions run by the thread pool groups of other NUMA nodes
+--
+SHOW thread_pool_steal_threshold;
+SELECT context, min_val, max_val FROM pg_settings WHERE name = 'thread_pool_steal_threshold';
+SET thread_pool_steal_threshold = 0;
+
+-- every group counts the sessions it stole and the ones moved to it
+SELECT count(*) > 0 AS has_groups,
+       bool_and(session_info ~ '^total: \d+ waiting: \d+ running:\d+ idle: \d+ stolen: \d+ migrated: \d+$') AS info_ok
+    FROM DBE_PERF.local_threadpool_status;
+SELECT sum(substring(session_info from 'total: (\d+)')::int) > 0 AS has_sessions
+    FROM DBE_PERF.local_threadpool_status;
@@ -0,0 +1,60 @@
+--
+-- Lazy vacuum with little memory for the dead tuples
+--
+-- four rows a page, the ids of heap block b are 4b + 1 to 4b + 4
+create table vdt (id int, a int, pad text) with (autovacuum_enabled = false);
+insert into vdt select i, i % 100, repeat('x', 1900) from generate_series(1, 4000) i;
+create index vdt_id on vdt (id);
+create index vdt_a on vdt (a);
+select pg_relation_size('vdt') / 8192 as blocks;
+
+-- dead tuples in the blocks on both sides of the chunk boundaries 256, 512
+-- and 768 of the store, and in every ninth block
+delete from vdt where id in (1022, 1026, 2046, 2050, 3070, 3074);
+delete from vdt where ((id - 1) / 4) % 9 = 0 and (id - 1) % 4 = 3;
+-- 1kB holds the dead tuples of about ten pages, so the 118 pages take
+-- many passes over the indexes
+set vacuum_dead_tuples_mem = 1;
+vacuum vdt;
+select c.relname, c.reltuples from pg_class c, pg_index i
+    where i.indrelid = 'vdt'::regclass and c.oid = i.indexrelid order by 1;
+set enable_seqscan = off;
+set enable_bitmapscan = off;
+select count(*) from vdt where id between 1 and 4000;
+select count(*) from vdt where a = 2;
+select id from vdt where id between 1020 and 1028 order by id;
+select id from vdt where id between 3068 and 3076 order by id;
+select count(*) from vdt where id > 4000;
+reset enable_bitmapscan;
+reset enable_seqscan;
+select count(*) from vdt;
+
+-- the freed line pointers are reused, a dead index entry left behind would
+-- now point to one of the new rows
+insert into vdt select i, i % 100, repeat('y', 1900) from generate_series(4001, 4300) i;
+set enable_seqscan = off;
+set enable_bitmapscan = off;
+select count(*) from vdt where id between 1 and 4000;
+select count(*) from vdt where a = 2;
+select id from vdt where id between 1020 and 1028 order by id;
+select id from vdt where id between 3068 and 3076 order by id;
+select count(*) from vdt where id > 4000;
+reset enable_bitmapscan;
+reset enable_seqscan;
+select count(*) from vdt;
+
+-- dense dead tuples in most blocks
+delete from vdt where id % 7 = 0;
+vacuum vdt;
+set enable_seqscan = off;
+set enable_bitmapscan = off;
+select count(*) from vdt where id between 1 and 4000;
+select count(*) from vdt where a = 2;
+select id from vdt where id between 1020 and 1028 order by id;
+select id from vdt where id between 3068 and 3076 order by id;
+select count(*) from vdt where id > 4000;
+reset enable_bitmapscan;
+reset enable_seqscan;
+select count(*) from vdt;
+reset vacuum_dead_tuples_mem;
+drop table vdt;
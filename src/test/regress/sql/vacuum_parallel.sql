@@ -0,0 +1,106 @@
+--
+-- Parallel index vacuum
+--
+create schema parallel_vacuum;
+set current_schema = parallel_vacuum;
+create table pvac_t (id int primary key, a int, b text, c int[])
+    with (parallel_vacuum_workers = 3, autovacuum_enabled = false);
+create index pvac_t_a on pvac_t (a);
+create index pvac_t_b on pvac_t (b);
+create index pvac_t_ab on pvac_t (a, b);
+create index pvac_t_c on pvac_t using gin (c);
+insert into pvac_t select i, i % 100, 'row ' || i, array[i % 10, i % 7] from generate_series(1, 20000) i;
+delete from pvac_t where id % 3 = 0;
+-- the workers vacuum the indexes the leader does not take
+set max_parallel_maintenance_workers = 4;
+vacuum pvac_t;
+set enable_seqscan = off;
+select count(*) from pvac_t where a = 42;
+select count(*) from pvac_t where b like 'row 1%';
+select count(*) from pvac_t where a = 8 and b like 'row 1%';
+select count(*) from pvac_t where id between 1000 and 2999;
+select count(*) from pvac_t where c @> array[3, 4];
+reset enable_seqscan;
+select c.relname, c.reltuples from pg_class c, pg_index i
+    where i.indrelid = 'pvac_t'::regclass and c.oid = i.indexrelid and c.relam = (select oid from pg_am where amname = 'btree')
+    order by 1;
+-- non-HOT updates leave a dead entry in every index
+update pvac_t set a = a + 1, b = b || 'u', c = c || 11 where id % 5 = 0;
+vacuum pvac_t;
+set enable_seqscan = off;
+select count(*) from pvac_t where a = 42;
+select count(*) from pvac_t where b like 'row 1%';
+select count(*) from pvac_t where a = 8 and b like 'row 1%';
+select count(*) from pvac_t where id between 1000 and 2999;
+select count(*) from pvac_t where c @> array[3, 4];
+reset enable_seqscan;
+select c.relname, c.reltuples from pg_class c, pg_index i
+    where i.indrelid = 'pvac_t'::regclass and c.oid = i.indexrelid and c.relam = (select oid from pg_am where amname = 'btree')
+    order by 1;
+select count(*) from pvac_t where c @> array[11];
+-- a zero reloption or GUC keeps the vacuum serial
+alter table pvac_t set (parallel_vacuum_workers = 0);
+delete from pvac_t where id % 3 = 1;
+vacuum pvac_t;
+alter table pvac_t reset (parallel_vacuum_workers);
+set max_parallel_maintenance_workers = 0;
+delete from pvac_t where id % 7 = 0;
+vacuum pvac_t;
+set enable_seqscan = off;
+select count(*) from pvac_t where a = 42;
+select count(*) from pvac_t where b like 'row 1%';
+select count(*) from pvac_t where a = 8 and b like 'row 1%';
+select count(*) from pvac_t where id between 1000 and 2999;
+select count(*) from pvac_t where c @> array[3, 4];
+reset enable_seqscan;
+select c.relname, c.reltuples from pg_class c, pg_index i
+    where i.indrelid = 'pvac_t'::regclass and c.oid = i.indexrelid and c.relam = (select oid from pg_am where amname = 'btree')
+    order by 1;
+alter table pvac_t set (parallel_vacuum_workers = 33);
+-- an error raised in a worker is raised again by the leader; the comparison
+-- function of the opclass errors out in any thread but this session's, and
+-- sleeps here so that the workers get the other indexes
+create table pvac_leader as select pg_backend_pid() as pid;
+create function pvac_cmp(int4, int4) returns int4 as $$
+begin
+    if pg_backend_pid() = (select pid from pvac_leader) then
+        perform pg_sleep(0.2);
+    else
+        raise exception 'compared in a parallel vacuum worker';
+    end if;
+    return btint4cmp($1, $2);
+end
+$$ language plpgsql;
+create operator class pvac_int4_ops for type int4[] using gin as
+    operator 1 &&(anyarray, anyarray),
+    operator 2 @>(anyarray, anyarray),
+    operator 3 <@(anyarray, anyarray),
+    operator 4 =(anyarray, anyarray),
+    function 1 pvac_cmp(int4, int4),
+    function 2 ginarrayextract(anyarray, internal, internal),
+    function 3 ginqueryarrayextract(anyarray, internal, int2, internal, internal, internal, internal),
+    function 4 ginarrayconsistent(internal, int2, anyarray, int4, internal, internal, internal, internal),
+    storage int4;
+create table pvac_err (c1 int4[], c2 int4[], c3 int4[])
+    with (parallel_vacuum_workers = 2, autovacuum_enabled = false);
+-- single element arrays are not compared on insert, the pending lists are
+create index pvac_err_c1 on pvac_err using gin (c1 pvac_int4_ops) with (fastupdate = on);
+create index pvac_err_c2 on pvac_err using gin (c2 pvac_int4_ops) with (fastupdate = on);
+create index pvac_err_c3 on pvac_err using gin (c3 pvac_int4_ops) with (fastupdate = on);
+insert into pvac_err select array[i], array[i], array[i] from generate_series(1, 3) i;
+set max_parallel_maintenance_workers = 2;
+vacuum pvac_err;
+-- the failed vacuum left nothing behind
+set max_parallel_maintenance_workers = 0;
+drop index pvac_err_c1, pvac_err_c2, pvac_err_c3;
+vacuum pvac_err;
+select count(*) from pvac_err;
+reset max_parallel_maintenance_workers;
+drop table pvac_err;
+drop operator class pvac_int4_ops using gin;
+drop operator family pvac_int4_ops using gin;
+drop function pvac_cmp(int4, int4);
+drop table pvac_leader;
+drop table pvac_t;
+reset current_schema;
+drop schema parallel_vacuum;
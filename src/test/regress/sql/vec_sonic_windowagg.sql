@@ -0,0 +1,98 @@
+/*
+ * Sonic window agg must return the same rows as the row engine.  Each case
+ * stores the sonic result and the row engine result and counts the rows in
+ * either one that are missing from the other.
+ */
+create schema sonic_window_agg;
+set current_schema = sonic_window_agg;
+create table sonic_win_t (id int, a int, b int, c bigint, d smallint) with (orientation = column);
+insert into sonic_win_t
+select i, i % 3, i / 50,
+       case when i % 11 = 0 then null else i * 1000003 end,
+       case when i % 13 = 0 then null else i % 100 end
+from generate_series(1, 6000) i;
+set enable_sonic_windowagg = on;
+-- default RANGE frame, peer groups of over a thousand rows span batches, NULL inputs
+explain (costs off) select id, rank() over w r, dense_rank() over w dr, count(*) over w cnt, count(c) over w cntc, sum(c) over w sc, sum(d) over w sd
+from sonic_win_t window w as (partition by a order by b / 100);
+create table sonic_res as select id, rank() over w r, dense_rank() over w dr, count(*) over w cnt, count(c) over w cntc, sum(c) over w sc, sum(d) over w sd
+from sonic_win_t window w as (partition by a order by b / 100);
+set enable_vector_engine = off;
+create table row_res as select id, rank() over w r, dense_rank() over w dr, count(*) over w cnt, count(c) over w cntc, sum(c) over w sc, sum(d) over w sd
+from sonic_win_t window w as (partition by a order by b / 100);
+reset enable_vector_engine;
+select count(*) from (select * from sonic_res except all select * from row_res) s;
+select count(*) from (select * from row_res except all select * from sonic_res) s;
+drop table sonic_res, row_res;
+-- small peer groups that end anywhere in a batch
+create table sonic_res as select id, rank() over w r, dense_rank() over w dr, count(c) over w cntc, sum(c) over w sc, sum(d) over w sd
+from sonic_win_t window w as (partition by a order by b);
+set enable_vector_engine = off;
+create table row_res as select id, rank() over w r, dense_rank() over w dr, count(c) over w cntc, sum(c) over w sc, sum(d) over w sd
+from sonic_win_t window w as (partition by a order by b);
+reset enable_vector_engine;
+select count(*) from (select * from sonic_res except all select * from row_res) s;
+select count(*) from (select * from row_res except all select * from sonic_res) s;
+drop table sonic_res, row_res;
+-- ROWS UNBOUNDED PRECEDING
+create table sonic_res as select id, row_number() over w rn, count(c) over w cntc, sum(c) over w sc, sum(d) over w sd
+from sonic_win_t window w as (partition by a order by b, id rows unbounded preceding);
+set enable_vector_engine = off;
+create table row_res as select id, row_number() over w rn, count(c) over w cntc, sum(c) over w sc, sum(d) over w sd
+from sonic_win_t window w as (partition by a order by b, id rows unbounded preceding);
+reset enable_vector_engine;
+select count(*) from (select * from sonic_res except all select * from row_res) s;
+select count(*) from (select * from row_res except all select * from sonic_res) s;
+drop table sonic_res, row_res;
+-- ROWS n PRECEDING, the frame ring is refilled at each partition
+explain (costs off) select id, count(c) over w cntc, sum(c) over w sc, sum(d) over w sd
+from sonic_win_t window w as (partition by a order by id rows 3 preceding);
+create table sonic_res as select id, count(c) over w cntc, sum(c) over w sc, sum(d) over w sd
+from sonic_win_t window w as (partition by a order by id rows 3 preceding);
+set enable_vector_engine = off;
+create table row_res as select id, count(c) over w cntc, sum(c) over w sc, sum(d) over w sd
+from sonic_win_t window w as (partition by a order by id rows 3 preceding);
+reset enable_vector_engine;
+select count(*) from (select * from sonic_res except all select * from row_res) s;
+select count(*) from (select * from row_res except all select * from sonic_res) s;
+drop table sonic_res, row_res;
+-- ROWS n PRECEDING with a frame longer than a batch
+create table sonic_res as select id, count(*) over w cnt, sum(c) over w sc
+from sonic_win_t window w as (order by id rows 1500 preceding);
+set enable_vector_engine = off;
+create table row_res as select id, count(*) over w cnt, sum(c) over w sc
+from sonic_win_t window w as (order by id rows 1500 preceding);
+reset enable_vector_engine;
+select count(*) from (select * from sonic_res except all select * from row_res) s;
+select count(*) from (select * from row_res except all select * from sonic_res) s;
+drop table sonic_res, row_res;
+-- a peer group larger than work_mem spills
+set work_mem = '64kB';
+-- one partition, peer groups of 5000 and 1000 rows
+create table sonic_res as select id, rank() over w r, count(*) over w cnt, count(c) over w cntc, sum(c) over w sc
+from sonic_win_t window w as (order by b / 100);
+set enable_vector_engine = off;
+create table row_res as select id, rank() over w r, count(*) over w cnt, count(c) over w cntc, sum(c) over w sc
+from sonic_win_t window w as (order by b / 100);
+reset enable_vector_engine;
+select count(*) from (select * from sonic_res except all select * from row_res) s;
+select count(*) from (select * from row_res except all select * from sonic_res) s;
+drop table sonic_res, row_res;
+reset work_mem;
+-- sum(int8) beyond the int8 range is numeric, as in the row engine
+create table sonic_win_big (g int, v bigint) with (orientation = column);
+insert into sonic_win_big values (1, 9223372036854775807), (1, 9223372036854775807), (1, 9223372036854775807),
+    (2, -9223372036854775808), (2, -9223372036854775808), (2, 1);
+select g, v, sum(v) over (partition by g order by v), sum(v) over (partition by g order by v rows 1 preceding)
+from sonic_win_big order by 1, 2, 4;
+-- the same through the row engine
+create table sonic_res as select g, v, sum(v) over (partition by g order by v) from sonic_win_big;
+set enable_vector_engine = off;
+create table row_res as select g, v, sum(v) over (partition by g order by v) from sonic_win_big;
+reset enable_vector_engine;
+select count(*) from (select * from sonic_res except all select * from row_res) s;
+select count(*) from (select * from row_res except all select * from sonic_res) s;
+drop table sonic_res, row_res;
+reset enable_sonic_windowagg;
+reset current_schema;
+drop schema sonic_window_agg cascade;